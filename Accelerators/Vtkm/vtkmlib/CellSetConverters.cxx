@@ -39,7 +39,11 @@ namespace {
 struct ReorderHex : public vtkm::exec::FunctorBase
 {
   ReorderHex(): Data(nullptr) {}
-  ReorderHex(vtkCellArray* fc): Data(fc->GetPointer()) {}
+  ReorderHex(vtkCellArray* fc)
+    : Data(fc->WritePointer(fc->GetNumberOfCells(),
+                            fc->GetNumberOfConnectivityEntries()))
+  {
+  }
 
   void operator()(vtkm::Id index) const
   {
@@ -12,8 +12,8 @@
      PURPOSE.  See the above copyright notice for more information.
 
 =========================================================================*/
-// .NAME vtkSMPThreadLocal - A thread local storage implementation using
-// platform specific facilities.
+// .NAME vtkSMPThreadLocal - A thread local storage implementation shared
+// by all the SMP back-ends.
 // .SECTION Description
 // A thread local object is one that maintains a copy of an object of the
 // template type for each thread that processes data. vtkSMPThreadLocal
@@ -58,7 +58,7 @@ public:
 
   ~vtkSMPThreadLocal()
   {
-    detail::ThreadSpecificStorageIterator it;
+    vtk::detail::smp::ThreadSpecificStorageIterator it;
     it.SetThreadSpecificStorage(Backend);
     for (it.SetToBegin(); !it.GetAtEnd(); it.Forward())
     {
@@ -76,7 +76,7 @@ public:
   // the same object.
   T& Local()
   {
-    detail::StoragePointerType &ptr = this->Backend.GetStorage();
+    vtk::detail::smp::StoragePointerType &ptr = this->Backend.GetStorage();
     T *local = reinterpret_cast<T*>(ptr);
     if (!ptr)
     {
@@ -137,7 +137,7 @@ public:
     }
 
   private:
-    detail::ThreadSpecificStorageIterator Impl;
+    vtk::detail::smp::ThreadSpecificStorageIterator Impl;
 
     friend class vtkSMPThreadLocal<T>;
   };
@@ -165,7 +165,7 @@ public:
   }
 
 private:
-  detail::ThreadSpecific Backend;
+  vtk::detail::smp::ThreadSpecific Backend;
   T Exemplar;
 
   // disable copying
@@ -28,20 +28,27 @@
 // faster lookup next time. The ThreadSpecific::GetStorage() function is thread
 // safe and only blocks when a new array needs to be allocated, which should be
 // rare.
+//
+// Threads are identified through a thread_local variable, so the same storage
+// works for the threads of every back-end and for application threads.
 
 #ifndef vtkSMPThreadLocalImpl_h
 #define vtkSMPThreadLocalImpl_h
 
 #include "vtkCommonCoreModule.h" // For export macro
-#include "vtkAtomic.h"
 #include "vtkConfigure.h"
 #include "vtkSystemIncludes.h"
 
-#include <omp.h>
+#include <atomic> // For std::atomic
+#include <mutex> // For std::mutex
 
 
+namespace vtk
+{
 namespace detail
 {
+namespace smp
+{
 
 typedef void* ThreadIdType;
 typedef vtkTypeUInt32 HashType;
@@ -50,8 +57,8 @@ typedef void* StoragePointerType;
 
 struct Slot
 {
-  vtkAtomic<ThreadIdType> ThreadId;
-  omp_lock_t ModifyLock;
+  std::atomic<ThreadIdType> ThreadId;
+  std::mutex ModifyLock;
   StoragePointerType Storage;
 
   Slot();
@@ -67,7 +74,7 @@ private:
 struct HashTableArray
 {
   size_t Size, SizeLg;
-  vtkAtomic<size_t> NumberOfEntries;
+  std::atomic<size_t> NumberOfEntries;
   Slot *Slots;
   HashTableArray *Prev;
 
@@ -91,8 +98,9 @@ public:
   size_t Size() const;
 
 private:
-  vtkAtomic<HashTableArray*> Root;
-  vtkAtomic<size_t> Count;
+  std::atomic<HashTableArray*> Root;
+  std::atomic<size_t> Count;
+  std::mutex ResizeLock;
 
   friend class ThreadSpecificStorageIterator;
 };
@@ -182,7 +190,9 @@ private:
   size_t CurrentSlot;
 };
 
-} // detail;
+} // namespace smp
+} // namespace detail
+} // namespace vtk
 
 #endif
 // VTK-HeaderTest-Exclude: vtkSMPThreadLocalImpl.h
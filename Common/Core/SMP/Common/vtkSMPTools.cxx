@@ -0,0 +1,299 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPTools.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPTools.h"
+
+#include "vtkSMPToolsImpl.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+using vtk::detail::smp::BackendType;
+using vtk::detail::smp::vtkSMPExecutionSettings;
+
+namespace
+{
+
+//--------------------------------------------------------------------------------
+struct vtkSMPBackendInfo
+{
+  const char* Name;
+  BackendType Type;
+  bool Enabled;
+};
+
+const vtkSMPBackendInfo vtkSMPBackends[] = {
+  { "Sequential", BackendType::Sequential, VTK_SMP_ENABLE_SEQUENTIAL != 0 },
+  { "STDThread", BackendType::STDThread, VTK_SMP_ENABLE_STDTHREAD != 0 },
+  { "OpenMP", BackendType::OpenMP, VTK_SMP_ENABLE_OPENMP != 0 },
+  { "TBB", BackendType::TBB, VTK_SMP_ENABLE_TBB != 0 }
+};
+
+bool vtkSMPGetBackendType(const char* name, BackendType& type)
+{
+  if (!name)
+  {
+    return false;
+  }
+  for (const vtkSMPBackendInfo& backend : vtkSMPBackends)
+  {
+    if (backend.Enabled && !strcmp(backend.Name, name))
+    {
+      type = backend.Type;
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* vtkSMPGetBackendName(BackendType type)
+{
+  return vtkSMPBackends[static_cast<int>(type)].Name;
+}
+
+//--------------------------------------------------------------------------------
+// Process wide settings. The back-end is read from VTK_SMP_BACKEND_IN_USE the
+// first time it is needed and falls back to the configure time default.
+struct vtkSMPGlobalSettings
+{
+  std::atomic<int> Backend;
+  std::atomic<bool> NestedParallelism;
+
+  vtkSMPGlobalSettings()
+    : NestedParallelism(true)
+  {
+    BackendType type = BackendType::Sequential;
+    vtkSMPGetBackendType(VTK_SMP_BACKEND, type);
+    const char* requested = std::getenv("VTK_SMP_BACKEND_IN_USE");
+    if (requested && !vtkSMPGetBackendType(requested, type))
+    {
+      vtkGenericWarningMacro("VTK_SMP_BACKEND_IN_USE is set to \""
+        << requested << "\" which is not an enabled SMP back-end, using "
+        << vtkSMPGetBackendName(type) << " instead.");
+    }
+    this->Backend = static_cast<int>(type);
+  }
+};
+
+vtkSMPGlobalSettings& vtkSMPGetGlobalSettings()
+{
+  static vtkSMPGlobalSettings settings;
+  return settings;
+}
+
+// Settings installed by vtkSMPTools::LocalScope() on an application thread,
+// or the settings of the parallel section a thread is currently executing.
+thread_local const vtkSMPExecutionSettings* vtkSMPLocalSettings = nullptr;
+thread_local int vtkSMPParallelDepth = 0;
+
+//--------------------------------------------------------------------------------
+// A parallel section remembers the settings of the thread that started it so
+// that the threads executing it see the same settings, in particular for the
+// nested For() calls made by the functor.
+struct vtkSMPScopedFunctor
+{
+  vtk::detail::smp::ExecuteFunctorPtrType FunctorExecuter;
+  void* Functor;
+  vtkSMPExecutionSettings Settings;
+};
+
+void vtkSMPExecuteScopedFunctor(void* scoped, vtkIdType from, vtkIdType grain,
+  vtkIdType last)
+{
+  vtkSMPScopedFunctor& sf = *reinterpret_cast<vtkSMPScopedFunctor*>(scoped);
+  const vtkSMPExecutionSettings* previous = vtkSMPLocalSettings;
+  vtkSMPLocalSettings = &sf.Settings;
+  ++vtkSMPParallelDepth;
+  sf.FunctorExecuter(sf.Functor, from, grain, last);
+  --vtkSMPParallelDepth;
+  vtkSMPLocalSettings = previous;
+}
+
+int vtkSMPGetBackendNumberOfThreads(BackendType backend)
+{
+  switch (backend)
+  {
+#if VTK_SMP_ENABLE_STDTHREAD
+    case BackendType::STDThread:
+      return vtk::detail::smp::STDThread::GetNumberOfThreads();
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+    case BackendType::OpenMP:
+      return vtk::detail::smp::OpenMP::GetNumberOfThreads();
+#endif
+#if VTK_SMP_ENABLE_TBB
+    case BackendType::TBB:
+      return vtk::detail::smp::TBB::GetNumberOfThreads();
+#endif
+    default:
+      return 1;
+  }
+}
+
+}
+
+//--------------------------------------------------------------------------------
+vtkSMPExecutionSettings vtk::detail::smp::GetExecutionSettings()
+{
+  if (vtkSMPLocalSettings)
+  {
+    return *vtkSMPLocalSettings;
+  }
+  vtkSMPGlobalSettings& global = vtkSMPGetGlobalSettings();
+  vtkSMPExecutionSettings settings;
+  settings.Backend = static_cast<BackendType>(global.Backend.load());
+  settings.MaxNumberOfThreads = 0;
+  settings.NestedParallelism = global.NestedParallelism;
+  return settings;
+}
+
+//--------------------------------------------------------------------------------
+const vtkSMPExecutionSettings* vtk::detail::smp::SwapLocalExecutionSettings(
+  const vtkSMPExecutionSettings* settings)
+{
+  const vtkSMPExecutionSettings* previous = vtkSMPLocalSettings;
+  vtkSMPLocalSettings = settings;
+  return previous;
+}
+
+//--------------------------------------------------------------------------------
+bool vtk::detail::smp::GetBackendType(const char* name, BackendType& type)
+{
+  return vtkSMPGetBackendType(name, type);
+}
+
+//--------------------------------------------------------------------------------
+bool vtk::detail::smp::IsParallelScope()
+{
+  return vtkSMPParallelDepth > 0;
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::GetNumberOfThreads()
+{
+  vtkSMPExecutionSettings settings = GetExecutionSettings();
+  int numThreads = vtkSMPGetBackendNumberOfThreads(settings.Backend);
+  if (settings.MaxNumberOfThreads > 0 &&
+      settings.MaxNumberOfThreads < numThreads)
+  {
+    numThreads = settings.MaxNumberOfThreads;
+  }
+  return numThreads;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::vtkSMPTools_Impl_For_Dispatch(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor)
+{
+  vtkSMPScopedFunctor sf;
+  sf.FunctorExecuter = functorExecuter;
+  sf.Functor = functor;
+  sf.Settings = GetExecutionSettings();
+
+  const bool serial = sf.Settings.Backend == BackendType::Sequential ||
+    sf.Settings.MaxNumberOfThreads == 1 ||
+    (vtkSMPParallelDepth > 0 && !sf.Settings.NestedParallelism);
+
+  switch (serial ? BackendType::Sequential : sf.Settings.Backend)
+  {
+#if VTK_SMP_ENABLE_STDTHREAD
+    case BackendType::STDThread:
+      STDThread::For(first, last, grain, vtkSMPExecuteScopedFunctor, &sf,
+        sf.Settings.MaxNumberOfThreads);
+      break;
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+    case BackendType::OpenMP:
+      OpenMP::For(first, last, grain, vtkSMPExecuteScopedFunctor, &sf,
+        sf.Settings.MaxNumberOfThreads);
+      break;
+#endif
+#if VTK_SMP_ENABLE_TBB
+    case BackendType::TBB:
+      TBB::For(first, last, grain, vtkSMPExecuteScopedFunctor, &sf,
+        sf.Settings.MaxNumberOfThreads);
+      break;
+#endif
+    default:
+      if (grain <= 0)
+      {
+        grain = last - first;
+      }
+      for (vtkIdType from = first; from < last; from += grain)
+      {
+        vtkSMPExecuteScopedFunctor(&sf, from, grain, last);
+      }
+      break;
+  }
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::Initialize(int numThreads)
+{
+#if VTK_SMP_ENABLE_STDTHREAD
+  vtk::detail::smp::STDThread::Initialize(numThreads);
+#endif
+#if VTK_SMP_ENABLE_OPENMP
+  vtk::detail::smp::OpenMP::Initialize(numThreads);
+#endif
+#if VTK_SMP_ENABLE_TBB
+  vtk::detail::smp::TBB::Initialize(numThreads);
+#endif
+  (void)numThreads;
+}
+
+//--------------------------------------------------------------------------------
+int vtkSMPTools::GetEstimatedNumberOfThreads()
+{
+  return vtk::detail::smp::GetNumberOfThreads();
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::SetBackend(const char* backend)
+{
+  BackendType type;
+  if (!vtkSMPGetBackendType(backend, type))
+  {
+    return false;
+  }
+  vtkSMPGetGlobalSettings().Backend = static_cast<int>(type);
+  return true;
+}
+
+//--------------------------------------------------------------------------------
+const char* vtkSMPTools::GetBackend()
+{
+  return vtkSMPGetBackendName(vtk::detail::smp::GetExecutionSettings().Backend);
+}
+
+//--------------------------------------------------------------------------------
+void vtkSMPTools::SetNestedParallelism(bool isNested)
+{
+  vtkSMPGetGlobalSettings().NestedParallelism = isNested;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::GetNestedParallelism()
+{
+  return vtk::detail::smp::GetExecutionSettings().NestedParallelism;
+}
+
+//--------------------------------------------------------------------------------
+bool vtkSMPTools::IsParallelScope()
+{
+  return vtk::detail::smp::IsParallelScope();
+}
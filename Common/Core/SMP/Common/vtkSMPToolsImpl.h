@@ -0,0 +1,68 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// Entry points of the SMP back-ends, private to vtkCommonCore. Each enabled
+// back-end implements them in SMP/<Backend>/vtkSMPToolsImpl.cxx. For() must
+// call functorExecuter(functor, from, grain, last) on [first, last) using at
+// most maxThreads threads (0 means no limit).
+
+#ifndef vtkSMPToolsImpl_h
+#define vtkSMPToolsImpl_h
+
+#include "vtkSMPToolsInternal.h"
+
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+#if VTK_SMP_ENABLE_STDTHREAD
+namespace STDThread
+{
+void Initialize(int numThreads);
+int GetNumberOfThreads();
+void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+  ExecuteFunctorPtrType functorExecuter, void* functor, int maxThreads);
+}
+#endif
+
+#if VTK_SMP_ENABLE_OPENMP
+namespace OpenMP
+{
+void Initialize(int numThreads);
+int GetNumberOfThreads();
+void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+  ExecuteFunctorPtrType functorExecuter, void* functor, int maxThreads);
+}
+#endif
+
+#if VTK_SMP_ENABLE_TBB
+namespace TBB
+{
+void Initialize(int numThreads);
+int GetNumberOfThreads();
+void For(vtkIdType first, vtkIdType last, vtkIdType grain,
+  ExecuteFunctorPtrType functorExecuter, void* functor, int maxThreads);
+}
+#endif
+
+}//namespace smp
+}//namespace detail
+}//namespace vtk
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPToolsImpl.h
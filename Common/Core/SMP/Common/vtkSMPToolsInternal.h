@@ -0,0 +1,600 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsInternal.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+// All the back-ends enabled at configure time are compiled in and the one in
+// use is picked at run time (see vtkSMPTools::SetBackend()). The templates
+// in this file turn a functor into a plain function pointer so that the
+// back-end specific code lives in the library, out of the public headers.
+
+#ifndef vtkSMPToolsInternal_h
+#define vtkSMPToolsInternal_h
+
+#include "vtkCommonCoreModule.h" // For export macro
+#include "vtkType.h" // For vtkIdType
+
+#include <algorithm> //for std::sort()
+#include <functional> //for std::less
+#include <iterator> //for std::iterator_traits
+#include <vector> //for the partial results of the algorithms
+
+#ifndef __VTK_WRAP__
+namespace vtk
+{
+namespace detail
+{
+namespace smp
+{
+
+enum class BackendType
+{
+  Sequential = 0,
+  STDThread = 1,
+  OpenMP = 2,
+  TBB = 3
+};
+
+// Settings in effect for the calling thread. They are the global settings
+// unless overridden by vtkSMPTools::LocalScope() or inherited from the
+// parallel section being executed.
+struct vtkSMPExecutionSettings
+{
+  BackendType Backend;
+  int MaxNumberOfThreads; // 0 means as many as the back-end provides
+  bool NestedParallelism;
+};
+
+VTKCOMMONCORE_EXPORT vtkSMPExecutionSettings GetExecutionSettings();
+// Install settings for the calling thread, nullptr reverts to the global
+// ones. Returns the previously installed settings.
+VTKCOMMONCORE_EXPORT const vtkSMPExecutionSettings* SwapLocalExecutionSettings(
+  const vtkSMPExecutionSettings* settings);
+// Returns false if name is not an enabled back-end.
+VTKCOMMONCORE_EXPORT bool GetBackendType(const char* name, BackendType& type);
+VTKCOMMONCORE_EXPORT bool IsParallelScope();
+VTKCOMMONCORE_EXPORT int GetNumberOfThreads();
+
+typedef void (*ExecuteFunctorPtrType)(void *, vtkIdType, vtkIdType, vtkIdType);
+
+VTKCOMMONCORE_EXPORT void vtkSMPTools_Impl_For_Dispatch(vtkIdType first,
+  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
+  void *functor);
+
+// The back-ends hand out [from, from + grain) ranges, clamped to last.
+template <typename FunctorInternal>
+void ExecuteFunctor(void *functor, vtkIdType from, vtkIdType grain,
+                    vtkIdType last)
+{
+  vtkIdType to = from + grain;
+  if (to > last)
+  {
+    to = last;
+  }
+
+  FunctorInternal &fi = *reinterpret_cast<FunctorInternal*>(functor);
+  fi.Execute(from, to);
+}
+
+template <typename FunctorInternal>
+void vtkSMPTools_Impl_For(vtkIdType first, vtkIdType last,
+                                 vtkIdType grain, FunctorInternal& fi)
+{
+  vtkIdType n = last - first;
+  if (n <= 0)
+  {
+    return;
+  }
+
+  if (grain >= n)
+  {
+    fi.Execute(first, last);
+  }
+  else
+  {
+    vtkSMPTools_Impl_For_Dispatch(first, last, grain,
+                                  ExecuteFunctor<FunctorInternal>, &fi);
+  }
+}
+
+//--------------------------------------------------------------------------------
+// Parallel sort: the range is cut into one block per thread, the blocks are
+// sorted concurrently, then neighbouring blocks are merged pairwise in
+// log2(numBlocks) parallel passes.
+template<typename RandomAccessIterator, typename Compare>
+class vtkSMPTools_SortBlocks
+{
+public:
+  RandomAccessIterator Begin;
+  vtkIdType Size;
+  vtkIdType BlockSize;
+  vtkIdType Width; // number of blocks already merged together, 0 for sort
+  Compare Comp;
+
+  vtkSMPTools_SortBlocks(RandomAccessIterator begin, vtkIdType size,
+                         vtkIdType blockSize, Compare comp)
+    : Begin(begin), Size(size), BlockSize(blockSize), Width(0), Comp(comp)
+  {
+  }
+
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    for (vtkIdType task = first; task < last; ++task)
+    {
+      if (this->Width == 0)
+      {
+        vtkIdType b = task * this->BlockSize;
+        vtkIdType e = std::min(b + this->BlockSize, this->Size);
+        std::sort(this->Begin + b, this->Begin + e, this->Comp);
+      }
+      else
+      {
+        vtkIdType b = 2 * task * this->Width * this->BlockSize;
+        vtkIdType m = std::min(b + this->Width * this->BlockSize, this->Size);
+        vtkIdType e = std::min(m + this->Width * this->BlockSize, this->Size);
+        std::inplace_merge(this->Begin + b, this->Begin + m, this->Begin + e,
+                           this->Comp);
+      }
+    }
+  }
+};
+
+template<typename RandomAccessIterator, typename Compare>
+void vtkSMPTools_Impl_Sort(RandomAccessIterator begin,
+                                  RandomAccessIterator end,
+                                  Compare comp)
+{
+  const vtkIdType size = static_cast<vtkIdType>(end - begin);
+  const vtkIdType numThreads = GetNumberOfThreads();
+  // Below this size the threading overhead dominates.
+  const vtkIdType minBlockSize = 4096;
+  if (numThreads < 2 || size < 2 * minBlockSize)
+  {
+    std::sort(begin, end, comp);
+    return;
+  }
+
+  vtkIdType numBlocks = std::min(numThreads, size / minBlockSize);
+  vtkIdType blockSize = (size + numBlocks - 1) / numBlocks;
+  numBlocks = (size + blockSize - 1) / blockSize;
+
+  typedef vtkSMPTools_SortBlocks<RandomAccessIterator, Compare> SorterType;
+  SorterType sorter(begin, size, blockSize, comp);
+  vtkSMPTools_Impl_For_Dispatch(0, numBlocks, 1,
+                                ExecuteFunctor<SorterType>, &sorter);
+
+  for (vtkIdType width = 1; width < numBlocks; width *= 2)
+  {
+    sorter.Width = width;
+    vtkIdType numMerges = (numBlocks + 2 * width - 1) / (2 * width);
+    vtkSMPTools_Impl_For_Dispatch(0, numMerges, 1,
+                                  ExecuteFunctor<SorterType>, &sorter);
+  }
+}
+
+//--------------------------------------------------------------------------------
+template<typename RandomAccessIterator>
+void vtkSMPTools_Impl_Sort(RandomAccessIterator begin,
+                                  RandomAccessIterator end)
+{
+  typedef typename std::iterator_traits<RandomAccessIterator>::value_type
+    ValueType;
+  vtkSMPTools_Impl_Sort(begin, end, std::less<ValueType>());
+}
+
+//--------------------------------------------------------------------------------
+// The algorithms below process fixed blocks of the input range. The blocks
+// only depend on the size of the range, not on the number of threads or on
+// the back-end, so reductions and scans of floating point values give the
+// same result whatever the execution settings.
+struct vtkSMPTools_Blocks
+{
+  vtkIdType Size;
+  vtkIdType BlockSize;
+  vtkIdType NumberOfBlocks;
+
+  explicit vtkSMPTools_Blocks(vtkIdType size)
+    : Size(size)
+  {
+    const vtkIdType minBlockSize = 1024;
+    const vtkIdType maxNumberOfBlocks = 256;
+    this->BlockSize = std::max(minBlockSize,
+      (size + maxNumberOfBlocks - 1) / maxNumberOfBlocks);
+    this->NumberOfBlocks = (size + this->BlockSize - 1) / this->BlockSize;
+  }
+
+  vtkIdType Begin(vtkIdType block) const
+  {
+    return block * this->BlockSize;
+  }
+
+  vtkIdType End(vtkIdType block) const
+  {
+    return std::min((block + 1) * this->BlockSize, this->Size);
+  }
+};
+
+//--------------------------------------------------------------------------------
+template <typename InputIt, typename OutputIt, typename UnaryOp>
+struct vtkSMPTools_UnaryTransform
+{
+  InputIt In;
+  OutputIt Out;
+  UnaryOp Op;
+
+  vtkSMPTools_UnaryTransform(InputIt in, OutputIt out, UnaryOp op)
+    : In(in), Out(out), Op(op)
+  {
+  }
+
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    InputIt in = this->In + first;
+    OutputIt out = this->Out + first;
+    for (vtkIdType i = first; i < last; ++i, ++in, ++out)
+    {
+      *out = this->Op(*in);
+    }
+  }
+};
+
+template <typename InputIt1, typename InputIt2, typename OutputIt,
+  typename BinaryOp>
+struct vtkSMPTools_BinaryTransform
+{
+  InputIt1 In1;
+  InputIt2 In2;
+  OutputIt Out;
+  BinaryOp Op;
+
+  vtkSMPTools_BinaryTransform(InputIt1 in1, InputIt2 in2, OutputIt out,
+    BinaryOp op)
+    : In1(in1), In2(in2), Out(out), Op(op)
+  {
+  }
+
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    InputIt1 in1 = this->In1 + first;
+    InputIt2 in2 = this->In2 + first;
+    OutputIt out = this->Out + first;
+    for (vtkIdType i = first; i < last; ++i, ++in1, ++in2, ++out)
+    {
+      *out = this->Op(*in1, *in2);
+    }
+  }
+};
+
+template <typename Iterator, typename T>
+struct vtkSMPTools_Fill
+{
+  Iterator Begin;
+  const T& Value;
+
+  vtkSMPTools_Fill(Iterator begin, const T& value)
+    : Begin(begin), Value(value)
+  {
+  }
+
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    Iterator it = this->Begin + first;
+    for (vtkIdType i = first; i < last; ++i, ++it)
+    {
+      *it = this->Value;
+    }
+  }
+};
+
+template <typename InputIt, typename OutputIt, typename UnaryOp>
+void vtkSMPTools_Impl_Transform(InputIt inBegin, InputIt inEnd,
+  OutputIt outBegin, UnaryOp op)
+{
+  typedef vtkSMPTools_UnaryTransform<InputIt, OutputIt, UnaryOp> FunctorType;
+  FunctorType functor(inBegin, outBegin, op);
+  vtkSMPTools_Impl_For(0, static_cast<vtkIdType>(inEnd - inBegin), 0, functor);
+}
+
+template <typename InputIt1, typename InputIt2, typename OutputIt,
+  typename BinaryOp>
+void vtkSMPTools_Impl_Transform(InputIt1 inBegin1, InputIt1 inEnd1,
+  InputIt2 inBegin2, OutputIt outBegin, BinaryOp op)
+{
+  typedef vtkSMPTools_BinaryTransform<InputIt1, InputIt2, OutputIt, BinaryOp>
+    FunctorType;
+  FunctorType functor(inBegin1, inBegin2, outBegin, op);
+  vtkSMPTools_Impl_For(0, static_cast<vtkIdType>(inEnd1 - inBegin1), 0,
+    functor);
+}
+
+template <typename Iterator, typename T>
+void vtkSMPTools_Impl_Fill(Iterator begin, Iterator end, const T& value)
+{
+  vtkSMPTools_Fill<Iterator, T> functor(begin, value);
+  vtkSMPTools_Impl_For(0, static_cast<vtkIdType>(end - begin), 0, functor);
+}
+
+//--------------------------------------------------------------------------------
+// Reduces each block to a partial result, the partial results are then
+// combined in block order.
+template <typename InputIt, typename T, typename ReduceOp,
+  typename TransformOp>
+struct vtkSMPTools_BlockReduce
+{
+  InputIt Begin;
+  vtkSMPTools_Blocks Blocks;
+  ReduceOp Reduce;
+  TransformOp Transform;
+  std::vector<T> Partials;
+
+  vtkSMPTools_BlockReduce(InputIt begin, const vtkSMPTools_Blocks& blocks,
+    const T& init, ReduceOp reduce, TransformOp transform)
+    : Begin(begin), Blocks(blocks), Reduce(reduce), Transform(transform),
+      Partials(blocks.NumberOfBlocks, init)
+  {
+  }
+
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    for (vtkIdType block = first; block < last; ++block)
+    {
+      InputIt it = this->Begin + this->Blocks.Begin(block);
+      InputIt end = this->Begin + this->Blocks.End(block);
+      T partial = this->Transform(*it);
+      for (++it; it != end; ++it)
+      {
+        partial = this->Reduce(partial, this->Transform(*it));
+      }
+      this->Partials[block] = partial;
+    }
+  }
+};
+
+struct vtkSMPTools_Identity
+{
+  template <typename U>
+  const U& operator()(const U& value) const
+  {
+    return value;
+  }
+};
+
+template <typename InputIt, typename T, typename ReduceOp,
+  typename TransformOp>
+T vtkSMPTools_Impl_TransformReduce(InputIt begin, InputIt end, T init,
+  ReduceOp reduce, TransformOp transform)
+{
+  vtkSMPTools_Blocks blocks(static_cast<vtkIdType>(end - begin));
+  typedef vtkSMPTools_BlockReduce<InputIt, T, ReduceOp, TransformOp>
+    FunctorType;
+  FunctorType functor(begin, blocks, init, reduce, transform);
+  vtkSMPTools_Impl_For(0, blocks.NumberOfBlocks, 1, functor);
+
+  for (const T& partial : functor.Partials)
+  {
+    init = reduce(init, partial);
+  }
+  return init;
+}
+
+//--------------------------------------------------------------------------------
+// Two pass scan: the blocks are reduced in parallel, the block sums are
+// scanned sequentially, and each block is then scanned in parallel starting
+// from its offset. The input is read before the output is written so the
+// scans can be done in place.
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+struct vtkSMPTools_BlockScan
+{
+  InputIt In;
+  OutputIt Out;
+  vtkSMPTools_Blocks Blocks;
+  BinaryOp Op;
+  std::vector<T> Offsets;
+  bool Inclusive;
+
+  vtkSMPTools_BlockScan(InputIt in, OutputIt out,
+    const vtkSMPTools_Blocks& blocks, const std::vector<T>& offsets,
+    BinaryOp op, bool inclusive)
+    : In(in), Out(out), Blocks(blocks), Op(op), Offsets(offsets),
+      Inclusive(inclusive)
+  {
+  }
+
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    for (vtkIdType block = first; block < last; ++block)
+    {
+      vtkIdType begin = this->Blocks.Begin(block);
+      InputIt in = this->In + begin;
+      InputIt end = this->In + this->Blocks.End(block);
+      OutputIt out = this->Out + begin;
+      if (this->Inclusive)
+      {
+        // The first inclusive block has no offset.
+        T acc = block == 0 ? T(*in) : this->Op(this->Offsets[block], *in);
+        *out = acc;
+        for (++in, ++out; in != end; ++in, ++out)
+        {
+          acc = this->Op(acc, *in);
+          *out = acc;
+        }
+      }
+      else
+      {
+        T acc = this->Offsets[block];
+        for (; in != end; ++in, ++out)
+        {
+          T value = *in;
+          *out = acc;
+          acc = this->Op(acc, value);
+        }
+      }
+    }
+  }
+};
+
+template <typename InputIt, typename OutputIt, typename T, typename BinaryOp>
+OutputIt vtkSMPTools_Impl_Scan(InputIt begin, InputIt end, OutputIt outBegin,
+  const T* init, BinaryOp op)
+{
+  const vtkIdType size = static_cast<vtkIdType>(end - begin);
+  if (size <= 0)
+  {
+    return outBegin;
+  }
+
+  vtkSMPTools_Blocks blocks(size);
+  typedef vtkSMPTools_BlockReduce<InputIt, T, BinaryOp,
+    vtkSMPTools_Identity> ReduceType;
+  ReduceType reducer(begin, blocks, T(*begin), op, vtkSMPTools_Identity());
+  // The last block sum is not needed.
+  vtkSMPTools_Impl_For(0, blocks.NumberOfBlocks - 1, 1, reducer);
+
+  std::vector<T> offsets(blocks.NumberOfBlocks, T(*begin));
+  if (init)
+  {
+    offsets[0] = *init;
+  }
+  for (vtkIdType block = 1; block < blocks.NumberOfBlocks; ++block)
+  {
+    offsets[block] = (block == 1 && !init) ? reducer.Partials[0]
+      : op(offsets[block - 1], reducer.Partials[block - 1]);
+  }
+
+  typedef vtkSMPTools_BlockScan<InputIt, OutputIt, T, BinaryOp> ScanType;
+  ScanType scanner(begin, outBegin, blocks, offsets, op, init == nullptr);
+  vtkSMPTools_Impl_For(0, blocks.NumberOfBlocks, 1, scanner);
+  return outBegin + size;
+}
+
+//--------------------------------------------------------------------------------
+// Stable partition: the predicate is evaluated once per value and the
+// number of selected values of each block is counted, then the values are
+// scattered to a temporary buffer at offsets computed from the block
+// counts, and finally copied back.
+template <typename Iterator, typename Predicate>
+struct vtkSMPTools_PartitionCount
+{
+  Iterator Begin;
+  vtkSMPTools_Blocks Blocks;
+  Predicate Pred;
+  std::vector<unsigned char> Selected;
+  std::vector<vtkIdType> Counts;
+
+  vtkSMPTools_PartitionCount(Iterator begin, const vtkSMPTools_Blocks& blocks,
+    Predicate pred)
+    : Begin(begin), Blocks(blocks), Pred(pred), Selected(blocks.Size),
+      Counts(blocks.NumberOfBlocks)
+  {
+  }
+
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    for (vtkIdType block = first; block < last; ++block)
+    {
+      vtkIdType count = 0;
+      Iterator it = this->Begin + this->Blocks.Begin(block);
+      for (vtkIdType i = this->Blocks.Begin(block),
+             end = this->Blocks.End(block); i < end; ++i, ++it)
+      {
+        this->Selected[i] = this->Pred(*it) ? 1 : 0;
+        count += this->Selected[i];
+      }
+      this->Counts[block] = count;
+    }
+  }
+};
+
+template <typename Iterator, typename ValueType>
+struct vtkSMPTools_PartitionScatter
+{
+  Iterator Begin;
+  vtkSMPTools_Blocks Blocks;
+  const std::vector<unsigned char>& Selected;
+  std::vector<vtkIdType> SelectedOffsets;
+  std::vector<vtkIdType> RejectedOffsets;
+  std::vector<ValueType> Buffer;
+
+  vtkSMPTools_PartitionScatter(Iterator begin,
+    const vtkSMPTools_Blocks& blocks,
+    const std::vector<unsigned char>& selected)
+    : Begin(begin), Blocks(blocks), Selected(selected),
+      SelectedOffsets(blocks.NumberOfBlocks),
+      RejectedOffsets(blocks.NumberOfBlocks), Buffer(blocks.Size)
+  {
+  }
+
+  void Execute(vtkIdType first, vtkIdType last)
+  {
+    for (vtkIdType block = first; block < last; ++block)
+    {
+      vtkIdType selectedOffset = this->SelectedOffsets[block];
+      vtkIdType rejectedOffset = this->RejectedOffsets[block];
+      Iterator it = this->Begin + this->Blocks.Begin(block);
+      for (vtkIdType i = this->Blocks.Begin(block),
+             end = this->Blocks.End(block); i < end; ++i, ++it)
+      {
+        this->Buffer[this->Selected[i] ? selectedOffset++ : rejectedOffset++] =
+          *it;
+      }
+    }
+  }
+};
+
+template <typename Iterator, typename Predicate>
+Iterator vtkSMPTools_Impl_StablePartition(Iterator begin, Iterator end,
+  Predicate pred)
+{
+  typedef typename std::iterator_traits<Iterator>::value_type ValueType;
+
+  const vtkIdType size = static_cast<vtkIdType>(end - begin);
+  if (size <= 0)
+  {
+    return begin;
+  }
+
+  vtkSMPTools_Blocks blocks(size);
+  typedef vtkSMPTools_PartitionCount<Iterator, Predicate> CountType;
+  CountType counter(begin, blocks, pred);
+  vtkSMPTools_Impl_For(0, blocks.NumberOfBlocks, 1, counter);
+
+  typedef vtkSMPTools_PartitionScatter<Iterator, ValueType> ScatterType;
+  ScatterType scatter(begin, blocks, counter.Selected);
+  vtkIdType numberOfSelected = 0;
+  for (vtkIdType block = 0; block < blocks.NumberOfBlocks; ++block)
+  {
+    scatter.SelectedOffsets[block] = numberOfSelected;
+    numberOfSelected += counter.Counts[block];
+  }
+  vtkIdType numberOfRejected = 0;
+  for (vtkIdType block = 0; block < blocks.NumberOfBlocks; ++block)
+  {
+    scatter.RejectedOffsets[block] = numberOfSelected + numberOfRejected;
+    numberOfRejected += (blocks.End(block) - blocks.Begin(block)) -
+      counter.Counts[block];
+  }
+  vtkSMPTools_Impl_For(0, blocks.NumberOfBlocks, 1, scatter);
+
+  vtkSMPTools_Impl_Transform(scatter.Buffer.begin(), scatter.Buffer.end(),
+    begin, vtkSMPTools_Identity());
+  return begin + numberOfSelected;
+}
+
+}//namespace smp
+}//namespace detail
+}//namespace vtk
+
+#endif // __VTK_WRAP__
+
+#endif
+// VTK-HeaderTest-Exclude: vtkSMPToolsInternal.h
@@ -1,7 +1,7 @@
 /*=========================================================================
 
   Program:   Visualization Toolkit
-  Module:    vtkSMPTools.cxx
+  Module:    vtkSMPToolsImpl.cxx
 
   Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
   All rights reserved.
@@ -13,7 +13,8 @@
 
 =========================================================================*/
 
-#include "vtkSMPTools.h"
+#include "vtkSMPToolsImpl.h"
+#include "vtkSMPToolsOpenMPInternal.h"
 
 #include <omp.h>
 
@@ -24,40 +25,35 @@ namespace
 int vtkSMPNumberOfSpecifiedThreads = 0;
 }
 
-void vtkSMPTools::Initialize(int numThreads)
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::OpenMP::Initialize(int numThreads)
 {
 # pragma omp single
-  if (numThreads)
+  if (numThreads > 0)
   {
     vtkSMPNumberOfSpecifiedThreads = numThreads;
     omp_set_num_threads(numThreads);
   }
 }
 
-int vtkSMPTools::GetEstimatedNumberOfThreads()
-{
-  return vtk::detail::smp::GetNumberOfThreads();
-}
-
-int vtk::detail::smp::GetNumberOfThreads()
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::OpenMP::GetNumberOfThreads()
 {
   return vtkSMPNumberOfSpecifiedThreads ? vtkSMPNumberOfSpecifiedThreads :
          omp_get_max_threads();
 }
 
-void vtk::detail::smp::vtkSMPTools_Impl_For_OpenMP(vtkIdType first,
-  vtkIdType last, vtkIdType grain, ExecuteFunctorPtrType functorExecuter,
-  void *functor)
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::OpenMP::For(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void* functor,
+  int maxThreads)
 {
-  if (grain <= 0)
+  int numThreads = GetNumberOfThreads();
+  if (maxThreads > 0)
   {
-    vtkIdType estimateGrain = (last - first)/(omp_get_max_threads() * 4);
-    grain = (estimateGrain > 0) ? estimateGrain : 1;
+    numThreads = std::min(numThreads, maxThreads);
   }
 
-# pragma omp parallel for schedule(runtime)
-  for (vtkIdType from = first; from < last; from += grain)
-  {
-    functorExecuter(functor, from, grain, last);
-  }
+  vtkSMPTools_Impl_For_OpenMP(first, last, grain, functorExecuter, functor,
+    numThreads);
 }
@@ -0,0 +1,425 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkSMPToolsImpl.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+
+#include "vtkSMPToolsImpl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Dependency free implementation on top of std::thread. A persistent pool of
+// worker threads is created the first time a parallel section is executed.
+// Each thread owns a deque of tasks: the owner pushes and pops at the back
+// while idle threads steal from the front, so large chunks of work migrate
+// to idle threads and badly balanced loops still keep every core busy.
+//
+// A task is a [from, to) range of a parallel for. A thread executing a task
+// splits it in halves until it is no larger than the grain, pushing the
+// upper halves to its deque where other threads can steal them. The thread
+// that called For() participates in the work and only runs tasks of the
+// loop it waits for, which makes nested For() calls safe: they are executed
+// in parallel by the same pool without risking a deadlock or re-entering a
+// thread local object of the enclosing loop.
+//
+// Each loop has a thread budget: a worker only picks a task of a loop if
+// fewer than MaxThreads threads are executing that loop, so that loops
+// started concurrently with different limits share the pool accordingly.
+//
+// Threads never spin: a worker sleeps until a task it may pick is queued,
+// that is one of a loop below its budget, and the thread that called For()
+// sleeps until a task of its loop is queued or the loop is done.
+
+namespace
+{
+
+//--------------------------------------------------------------------------------
+struct vtkSMPJob
+{
+  vtk::detail::smp::ExecuteFunctorPtrType FunctorExecuter;
+  void* Functor;
+  vtkIdType Grain;
+  int MaxThreads;
+  std::atomic<int> ActiveThreads;
+  std::atomic<vtkIdType> Remaining;
+
+  bool TryEnter()
+  {
+    if (++this->ActiveThreads > this->MaxThreads)
+    {
+      --this->ActiveThreads;
+      return false;
+    }
+    return true;
+  }
+
+  bool CanEnter() const
+  {
+    return this->ActiveThreads.load() < this->MaxThreads;
+  }
+};
+
+struct vtkSMPTask
+{
+  vtkSMPJob* Job;
+  vtkIdType From;
+  vtkIdType To;
+};
+
+//--------------------------------------------------------------------------------
+// A mutex protected double ended queue. Contention on these locks is low:
+// the owner is normally the only user and thieves only show up once they
+// ran out of work.
+class vtkSMPTaskQueue
+{
+public:
+  void Push(const vtkSMPTask& task)
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    this->Tasks.push_back(task);
+  }
+
+  // When job is not null, only tasks of that job are considered and the
+  // caller is already accounted for in the job's thread budget. Otherwise
+  // the first task whose job accepts one more thread is returned.
+  // The owner takes the most recently pushed task, thieves the oldest (and
+  // thus largest) one.
+  bool Take(vtkSMPJob* job, bool owner, vtkSMPTask& task)
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    if (owner)
+    {
+      for (auto it = this->Tasks.rbegin(); it != this->Tasks.rend(); ++it)
+      {
+        if (job ? it->Job == job : it->Job->TryEnter())
+        {
+          task = *it;
+          this->Tasks.erase(std::next(it).base());
+          return true;
+        }
+      }
+    }
+    else
+    {
+      for (auto it = this->Tasks.begin(); it != this->Tasks.end(); ++it)
+      {
+        if (job ? it->Job == job : it->Job->TryEnter())
+        {
+          task = *it;
+          this->Tasks.erase(it);
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  // Whether Take() would return a task, without taking it.
+  bool Contains(vtkSMPJob* job)
+  {
+    std::lock_guard<std::mutex> lock(this->Lock);
+    for (const vtkSMPTask& task : this->Tasks)
+    {
+      if (job ? task.Job == job : task.Job->CanEnter())
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+private:
+  std::mutex Lock;
+  std::deque<vtkSMPTask> Tasks;
+};
+
+// Index of the queue owned by the current thread. Threads that are not part
+// of the pool (the application threads) share queue 0.
+thread_local int vtkSMPThreadIndex = 0;
+
+//--------------------------------------------------------------------------------
+class vtkSMPThreadPool
+{
+public:
+  explicit vtkSMPThreadPool(int numThreads)
+    : Queues(numThreads)
+    , NumberOfQueuedTasks(0)
+    , NumberOfWaitingCallers(0)
+    , Stop(false)
+  {
+    for (int i = 0; i < numThreads; ++i)
+    {
+      this->Queues[i].reset(new vtkSMPTaskQueue);
+    }
+    for (int i = 1; i < numThreads; ++i)
+    {
+      this->Threads.emplace_back(&vtkSMPThreadPool::WorkerLoop, this, i);
+    }
+  }
+
+  ~vtkSMPThreadPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(this->SleepLock);
+      this->Stop = true;
+    }
+    this->WakeUp.notify_all();
+    for (auto& thread : this->Threads)
+    {
+      thread.join();
+    }
+  }
+
+  int GetNumberOfThreads() const
+  {
+    return static_cast<int>(this->Queues.size());
+  }
+
+  void Run(vtkIdType first, vtkIdType last, vtkIdType grain, int maxThreads,
+    vtk::detail::smp::ExecuteFunctorPtrType functorExecuter, void* functor)
+  {
+    vtkSMPJob job;
+    job.FunctorExecuter = functorExecuter;
+    job.Functor = functor;
+    job.Grain = grain;
+    job.MaxThreads = maxThreads;
+    job.ActiveThreads = 1; // the calling thread
+    job.Remaining = last - first;
+
+    vtkSMPTask task = { &job, first, last };
+    job.Remaining -= this->Execute(task);
+
+    // Help with the remaining work of this job until it is done, sleeping
+    // while the other threads execute its last tasks.
+    while (job.Remaining.load() > 0)
+    {
+      if (this->FindTask(&job, task))
+      {
+        job.Remaining -= this->Execute(task);
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(this->SleepLock);
+      ++this->NumberOfWaitingCallers;
+      this->JobProgress.wait(lock, [this, &job]() {
+        return job.Remaining.load() == 0 || this->HasTask(&job); });
+      --this->NumberOfWaitingCallers;
+    }
+  }
+
+private:
+  // Execute a task, the calling thread must be accounted for in the job's
+  // thread budget. The upper halves of the range are left to the other
+  // threads: only the size of the range executed here is returned, which
+  // the caller must subtract from the remaining work of the job.
+  vtkIdType Execute(vtkSMPTask task)
+  {
+    vtkSMPJob* job = task.Job;
+    vtkSMPTaskQueue& queue = *this->Queues[vtkSMPThreadIndex];
+    while (task.To - task.From > job->Grain)
+    {
+      vtkIdType mid = task.From + (task.To - task.From) / 2;
+      vtkSMPTask upper = { job, mid, task.To };
+      queue.Push(upper);
+      this->Notify();
+      task.To = mid;
+    }
+
+    job->FunctorExecuter(job->Functor, task.From, task.To - task.From, task.To);
+    return task.To - task.From;
+  }
+
+  bool FindTask(vtkSMPJob* job, vtkSMPTask& task)
+  {
+    const int index = vtkSMPThreadIndex;
+    if (this->Queues[index]->Take(job, true, task))
+    {
+      --this->NumberOfQueuedTasks;
+      return true;
+    }
+    const int numQueues = this->GetNumberOfThreads();
+    for (int i = 1; i < numQueues; ++i)
+    {
+      if (this->Queues[(index + i) % numQueues]->Take(job, false, task))
+      {
+        --this->NumberOfQueuedTasks;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Whether FindTask() may succeed. Called with SleepLock held by the
+  // threads about to sleep.
+  bool HasTask(vtkSMPJob* job)
+  {
+    if (this->NumberOfQueuedTasks.load() == 0)
+    {
+      return false;
+    }
+    for (auto& queue : this->Queues)
+    {
+      if (queue->Contains(job))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Wake up a worker, and the threads waiting for their loop since the task
+  // may belong to it. Taking the lock serializes with a thread about to
+  // sleep so the wake up is not lost.
+  void Notify()
+  {
+    ++this->NumberOfQueuedTasks;
+    bool callers;
+    {
+      std::lock_guard<std::mutex> lock(this->SleepLock);
+      callers = this->NumberOfWaitingCallers > 0;
+    }
+    this->WakeUp.notify_one();
+    if (callers)
+    {
+      this->JobProgress.notify_all();
+    }
+  }
+
+  void WorkerLoop(int index)
+  {
+    vtkSMPThreadIndex = index;
+    vtkSMPTask task;
+    for (;;)
+    {
+      if (this->FindTask(nullptr, task))
+      {
+        vtkSMPJob* job = task.Job;
+        vtkIdType size = this->Execute(task);
+        // Last accesses to the job: once Remaining reaches 0 the thread that
+        // started it may return and destroy it.
+        --job->ActiveThreads;
+        bool done = (job->Remaining -= size) == 0;
+        // Leaving the job may let a sleeping worker enter it.
+        bool wakeUp = this->NumberOfQueuedTasks.load() > 0;
+        if (wakeUp || done)
+        {
+          std::lock_guard<std::mutex> lock(this->SleepLock);
+        }
+        if (wakeUp)
+        {
+          this->WakeUp.notify_one();
+        }
+        if (done)
+        {
+          this->JobProgress.notify_all();
+        }
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(this->SleepLock);
+      this->WakeUp.wait(lock, [this]() {
+        return this->Stop || this->HasTask(nullptr); });
+      if (this->Stop)
+      {
+        return;
+      }
+    }
+  }
+
+  std::vector<std::unique_ptr<vtkSMPTaskQueue> > Queues;
+  std::vector<std::thread> Threads;
+  std::atomic<int> NumberOfQueuedTasks;
+  std::mutex SleepLock;
+  // Workers wait on WakeUp for a task they may pick, the threads that called
+  // Run() on JobProgress for a task of their job or its end.
+  std::condition_variable WakeUp;
+  std::condition_variable JobProgress;
+  int NumberOfWaitingCallers;
+  bool Stop;
+};
+
+// Written under vtkSMPThreadPoolLock, read by GetNumberOfThreads() without it.
+std::atomic<int> vtkSMPNumberOfSpecifiedThreads(0);
+std::mutex vtkSMPThreadPoolLock;
+std::unique_ptr<vtkSMPThreadPool> vtkSMPThreadPoolInstance;
+
+vtkSMPThreadPool& vtkSMPGetThreadPool()
+{
+  std::lock_guard<std::mutex> lock(vtkSMPThreadPoolLock);
+  if (!vtkSMPThreadPoolInstance)
+  {
+    vtkSMPThreadPoolInstance.reset(new vtkSMPThreadPool(
+      vtk::detail::smp::STDThread::GetNumberOfThreads()));
+  }
+  return *vtkSMPThreadPoolInstance;
+}
+
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::STDThread::Initialize(int numThreads)
+{
+  std::lock_guard<std::mutex> lock(vtkSMPThreadPoolLock);
+  if (numThreads > 0 && numThreads != vtkSMPNumberOfSpecifiedThreads)
+  {
+    vtkSMPNumberOfSpecifiedThreads = numThreads;
+    // The pool is recreated lazily with the new size. This is only safe
+    // outside of parallel sections, as documented in vtkSMPTools.h.
+    vtkSMPThreadPoolInstance.reset();
+  }
+}
+
+//--------------------------------------------------------------------------------
+int vtk::detail::smp::STDThread::GetNumberOfThreads()
+{
+  int specified = vtkSMPNumberOfSpecifiedThreads.load();
+  if (specified)
+  {
+    return specified;
+  }
+  int numThreads = static_cast<int>(std::thread::hardware_concurrency());
+  return numThreads > 0 ? numThreads : 1;
+}
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::STDThread::For(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void* functor,
+  int maxThreads)
+{
+  int numThreads = GetNumberOfThreads();
+  if (maxThreads > 0 && maxThreads < numThreads)
+  {
+    numThreads = maxThreads;
+  }
+  if (grain <= 0)
+  {
+    vtkIdType estimateGrain = (last - first) / (numThreads * 4);
+    grain = (estimateGrain > 0) ? estimateGrain : 1;
+  }
+
+  if (numThreads == 1)
+  {
+    for (vtkIdType from = first; from < last; from += grain)
+    {
+      functorExecuter(functor, from, grain, last);
+    }
+    return;
+  }
+
+  vtkSMPGetThreadPool().Run(
+    first, last, grain, numThreads, functorExecuter, functor);
+}
@@ -1,7 +1,7 @@
 /*=========================================================================
 
   Program:   Visualization Toolkit
-  Module:    vtkSMPTools.cxx
+  Module:    vtkSMPToolsImpl.cxx
 
   Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
   All rights reserved.
@@ -13,21 +13,26 @@
 
 =========================================================================*/
 
-#include "vtkSMPTools.h"
+#include "vtkSMPToolsImpl.h"
+#include "vtkSMPToolsTBBInternal.h"
 
-#include "vtkCriticalSection.h"
+#include <mutex>
 
 #ifdef _MSC_VER
 #  pragma push_macro("__TBB_NO_IMPLICIT_LINKAGE")
 #  define __TBB_NO_IMPLICIT_LINKAGE 1
 #endif
 
+#include <tbb/task_arena.h>
 #include <tbb/task_scheduler_init.h>
 
 #ifdef _MSC_VER
 #  pragma pop_macro("__TBB_NO_IMPLICIT_LINKAGE")
 #endif
 
+namespace
+{
+
 struct vtkSMPToolsInit
 {
   tbb::task_scheduler_init Init;
@@ -37,14 +42,16 @@ struct vtkSMPToolsInit
   }
 };
 
-static bool vtkSMPToolsInitialized = 0;
-static int vtkTBBNumSpecifiedThreads = 0;
-static vtkSimpleCriticalSection vtkSMPToolsCS;
+bool vtkSMPToolsInitialized = false;
+int vtkTBBNumSpecifiedThreads = 0;
+std::mutex vtkSMPToolsCS;
+
+}
 
 //--------------------------------------------------------------------------------
-void vtkSMPTools::Initialize(int numThreads)
+void vtk::detail::smp::TBB::Initialize(int numThreads)
 {
-  vtkSMPToolsCS.Lock();
+  std::lock_guard<std::mutex> lock(vtkSMPToolsCS);
   if (!vtkSMPToolsInitialized)
   {
     // If numThreads <= 0, don't create a task_scheduler_init
@@ -56,12 +63,30 @@ void vtkSMPTools::Initialize(int numThreads)
     }
     vtkSMPToolsInitialized = true;
   }
-  vtkSMPToolsCS.Unlock();
 }
 
 //--------------------------------------------------------------------------------
-int vtkSMPTools::GetEstimatedNumberOfThreads()
+int vtk::detail::smp::TBB::GetNumberOfThreads()
 {
   return vtkTBBNumSpecifiedThreads ? vtkTBBNumSpecifiedThreads
     : tbb::task_scheduler_init::default_num_threads();
 }
+
+//--------------------------------------------------------------------------------
+void vtk::detail::smp::TBB::For(vtkIdType first, vtkIdType last,
+  vtkIdType grain, ExecuteFunctorPtrType functorExecuter, void* functor,
+  int maxThreads)
+{
+  if (maxThreads > 0 && maxThreads < GetNumberOfThreads())
+  {
+    // Restrict the loop to a dedicated arena of the requested size.
+    tbb::task_arena arena(maxThreads);
+    arena.execute([&]() {
+      vtkSMPTools_Impl_For_TBB(first, last, grain, functorExecuter, functor);
+    });
+  }
+  else
+  {
+    vtkSMPTools_Impl_For_TBB(first, last, grain, functorExecuter, functor);
+  }
+}
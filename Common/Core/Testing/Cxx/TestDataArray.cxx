@@ -1,6 +1,10 @@
 #include "vtkIntArray.h"
 #include "vtkDoubleArray.h"
+#include "vtkInformation.h"
+#include "vtkInformationVector.h"
 #include "vtkMathUtilities.h"
+#include "vtkNew.h"
+#include "vtkVariantArray.h"
 
 // Define this to run benchmarking tests on some vtkDataArray methods:
 #undef BENCHMARK
@@ -9,7 +13,6 @@
 #ifdef BENCHMARK
 #include "vtkTimerLog.h"
 #include "vtkIdList.h"
-#include "vtkNew.h"
 
 #include <iostream>
 #include <map>
@@ -219,6 +222,51 @@ int TestDataArray(int,char *[])
     cout << " " << fa[0] << "," << fa[1] << "," << fa[2];
   }
   cout << endl;
+
+  // The per-component information created for the prominent values must not
+  // be mistaken for cached ranges, nor be dropped when the ranges are cached.
+  vtkNew<vtkVariantArray> prominent;
+  farray->GetProminentComponentValues(1, prominent);
+  farray->GetRange( range, 1 );
+  if ( range[0] != 1.25 || range[1] != 8.25 )
+  {
+    cerr
+      << "Getting range (" << range[0] << "-" << range[1]
+      << ") of component 1 failed" << std::endl;
+    farray->Delete();
+    return 1;
+  }
+  vtkInformationVector* perComp =
+    farray->GetInformation()->Get(vtkAbstractArray::PER_COMPONENT());
+  if ( !perComp->GetInformationObject(1)->Has(
+      vtkAbstractArray::DISCRETE_VALUES()) )
+  {
+    cerr << "Caching the range dropped the prominent values" << std::endl;
+    farray->Delete();
+    return 1;
+  }
+
+  // A finite range is also cached as the finite range.
+  farray->SetComponent(0, 1, vtkMath::Inf());
+  farray->GetFiniteRange( range, 1 );
+  if ( range[0] != 1.25 || range[1] != 8.25 )
+  {
+    cerr
+      << "Getting finite range (" << range[0] << "-" << range[1]
+      << ") of array not marked as modified caused recomputation of range!";
+    farray->Delete();
+    return 1;
+  }
+  farray->SetComponent(0, 1, 1.25);
+
+  double tuple[3] = { 8.125, 8.25, 8.375 };
+  if ( !vtkMathUtilities::FuzzyCompare( farray->GetMaxNorm(),
+                                        vtkMath::Norm(tuple) ) )
+  {
+    cerr << "Wrong max norm " << farray->GetMaxNorm() << std::endl;
+    farray->Delete();
+    return 1;
+  }
   farray->Delete();
   return 0;
 }
@@ -0,0 +1,273 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestImplicitArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkAffineArray.h"
+#include "vtkArrayDispatch.h"
+#include "vtkCompositeArray.h"
+#include "vtkConstantArray.h"
+#include "vtkDataArrayAccessor.h"
+#include "vtkDataArrayRange.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIndexedArray.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredPointArray.h"
+#include "vtkTestSMP.h"
+
+#include <vector>
+
+namespace
+{
+
+// Sum of all the values of an array.
+struct SumWorker
+{
+  double Sum;
+
+  SumWorker() : Sum(0.0) {}
+
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    vtkDataArrayAccessor<ArrayT> access(array);
+    for (vtkIdType t = 0; t < array->GetNumberOfTuples(); ++t)
+    {
+      for (int c = 0; c < array->GetNumberOfComponents(); ++c)
+      {
+        this->Sum += static_cast<double>(access.Get(t, c));
+      }
+    }
+  }
+};
+
+bool CheckValues(vtkDataArray *array, vtkDataArray *expected,
+                 const char *name)
+{
+  if (array->GetNumberOfTuples() != expected->GetNumberOfTuples() ||
+      array->GetNumberOfComponents() != expected->GetNumberOfComponents())
+  {
+    cerr << name << ": wrong size" << endl;
+    return false;
+  }
+  for (vtkIdType t = 0; t < array->GetNumberOfTuples(); ++t)
+  {
+    for (int c = 0; c < array->GetNumberOfComponents(); ++c)
+    {
+      if (array->GetComponent(t, c) != expected->GetComponent(t, c))
+      {
+        cerr << name << ": wrong value for tuple " << t << " component "
+             << c << ": " << array->GetComponent(t, c) << " instead of "
+             << expected->GetComponent(t, c) << endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+int TestImplicitArray(int, char *[])
+{
+  const vtkIdType n = 1000;
+
+  // Affine and constant arrays.
+  vtkNew<vtkAffineArray<vtkIdType> > ids;
+  ids->SetNumberOfTuples(n);
+  ids->SetBackend(vtkAffineImplicitBackend<vtkIdType>(0, 1));
+  vtkNew<vtkIdTypeArray> expectedIds;
+  expectedIds->SetNumberOfTuples(n);
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    expectedIds->SetValue(i, i);
+  }
+  if (!CheckValues(ids, expectedIds, "vtkAffineArray"))
+  {
+    return EXIT_FAILURE;
+  }
+  double range[2];
+  ids->GetRange(range);
+  if (range[0] != 0 || range[1] != n - 1 || ids->GetValue(n - 1) != n - 1)
+  {
+    cerr << "Wrong range: " << range[0] << " " << range[1] << endl;
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkConstantArray<float> > constant;
+  constant->SetNumberOfComponents(3);
+  constant->SetNumberOfTuples(n);
+  constant->SetBackend(vtkConstantImplicitBackend<float>(2.5f));
+  float tuple[3];
+  constant->GetTypedTuple(n / 2, tuple);
+  if (tuple[0] != 2.5f || tuple[2] != 2.5f ||
+      constant->GetValue(3 * n - 1) != 2.5f)
+  {
+    cerr << "Wrong constant values" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Down casts, dispatch and ranges.
+  if (vtkArrayDownCast<vtkAffineArray<vtkIdType> >(ids.GetPointer()) !=
+        ids.GetPointer() ||
+      vtkArrayDownCast<vtkConstantArray<vtkIdType> >(ids.GetPointer()) ||
+      vtkArrayDownCast<vtkIdTypeArray>(ids.GetPointer()) ||
+      vtkArrayDownCast<vtkDataArray>(ids.GetPointer()) != ids.GetPointer())
+  {
+    cerr << "Wrong down cast" << endl;
+    return EXIT_FAILURE;
+  }
+  typedef vtkTypeList_Create_2(vtkAffineArray<vtkIdType>,
+                               vtkConstantArray<float>) ImplicitArrays;
+  SumWorker worker;
+  if (!vtkArrayDispatch::DispatchByArray<ImplicitArrays>::Execute(ids, worker) ||
+      !vtkArrayDispatch::DispatchByArray<ImplicitArrays>::Execute(constant,
+                                                                 worker) ||
+      worker.Sum != n * (n - 1) / 2 + 3 * n * 2.5)
+  {
+    cerr << "Dispatch failed: " << worker.Sum << endl;
+    return EXIT_FAILURE;
+  }
+  vtkIdType sum = 0;
+  for (vtkIdType id : vtk::DataArrayValueRange<1>(ids))
+  {
+    sum += id;
+  }
+  if (sum != n * (n - 1) / 2)
+  {
+    cerr << "Wrong value range sum: " << sum << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Copies are regular arrays.
+  vtkSmartPointer<vtkDataArray> copy;
+  copy.TakeReference(ids->NewInstance());
+  copy->DeepCopy(ids);
+  if (!vtkArrayDownCast<vtkIdTypeArray>(copy) ||
+      !CheckValues(copy, expectedIds, "DeepCopy"))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkNew<vtkAffineArray<vtkIdType> > implicitCopy;
+  implicitCopy->DeepCopy(ids);
+  if (!CheckValues(implicitCopy, expectedIds, "Implicit DeepCopy"))
+  {
+    return EXIT_FAILURE;
+  }
+  vtkIdType *values = static_cast<vtkIdType*>(ids->GetVoidPointer(0));
+  if (!values || values[n - 1] != n - 1)
+  {
+    cerr << "Wrong void pointer" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The copy is refreshed in place when the values change.
+  ids->SetBackend(vtkAffineImplicitBackend<vtkIdType>(n, -1));
+  if (values[0] != n || values[n - 1] != 1)
+  {
+    cerr << "Void pointer not refreshed" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // After a change of size, it is computed only once when several threads
+  // ask for it at the same time.
+  ids->SetNumberOfTuples(n + 1);
+  ids->SetNumberOfTuples(n);
+  std::vector<vtkIdType*> pointers(n, nullptr);
+  vtkTest::RunThreaded(4, [&]() {
+    vtkSMPTools::For(0, n, 1, [&](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        pointers[i] = static_cast<vtkIdType*>(ids->GetVoidPointer(i));
+      }
+    });
+  });
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    if (pointers[i] != pointers[0] + i || *pointers[i] != n - i)
+    {
+      cerr << "Wrong concurrent void pointer " << i << endl;
+      return EXIT_FAILURE;
+    }
+  }
+  ids->SetBackend(vtkAffineImplicitBackend<vtkIdType>(0, 1));
+
+  // Structured points, compared to the points of a rectilinear grid whose
+  // first axis is irregular.
+  const int dims[3] = { 7, 5, 3 };
+  vtkNew<vtkFloatArray> xCoords;
+  for (int i = 0; i < dims[0]; ++i)
+  {
+    xCoords->InsertNextValue(0.5f * i * i);
+  }
+  vtkStructuredPointBackend<double> grid;
+  grid.SetAxis(0, xCoords);
+  grid.SetUniformAxis(1, 2, 2 + dims[1] - 1, 1.0, 0.25);
+  grid.SetUniformAxis(2, 0, dims[2] - 1, -1.0, 2.0);
+  vtkNew<vtkStructuredPointArray<double> > points;
+  points->SetNumberOfComponents(3);
+  points->SetNumberOfTuples(grid.GetNumberOfPoints());
+  points->SetBackend(grid);
+  vtkNew<vtkDoubleArray> expectedPoints;
+  expectedPoints->SetNumberOfComponents(3);
+  for (int k = 0; k < dims[2]; ++k)
+  {
+    for (int j = 0; j < dims[1]; ++j)
+    {
+      for (int i = 0; i < dims[0]; ++i)
+      {
+        expectedPoints->InsertNextTuple3(
+          0.5 * i * i, 1.0 + 0.25 * (j + 2), -1.0 + 2.0 * k);
+      }
+    }
+  }
+  if (!CheckValues(points, expectedPoints, "vtkStructuredPointArray"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Indexed and composite arrays.
+  vtkNew<vtkIdList> indices;
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    indices->InsertNextId(n - 1 - i);
+  }
+  vtkNew<vtkIndexedArray<double> > reversed;
+  reversed->SetNumberOfTuples(n);
+  reversed->SetBackend(vtkIndexedImplicitBackend<double>(indices, ids));
+  vtkCompositeImplicitBackend<double> concatenation;
+  concatenation.AddArray(ids);
+  concatenation.AddArray(reversed);
+  vtkNew<vtkCompositeArray<double> > composite;
+  composite->SetNumberOfTuples(concatenation.GetNumberOfTuples());
+  composite->SetBackend(concatenation);
+  vtkNew<vtkDoubleArray> expectedComposite;
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    expectedComposite->InsertNextValue(i);
+  }
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    expectedComposite->InsertNextValue(n - 1 - i);
+  }
+  if (!CheckValues(composite, expectedComposite, "vtkCompositeArray"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
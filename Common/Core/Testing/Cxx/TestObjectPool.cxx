@@ -0,0 +1,109 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestObjectPool.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkObjectPool.h"
+#include "vtkPoints.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <atomic>
+
+namespace
+{
+
+// Each item uses two scratch id lists and one scratch vtkPoints, as a cell
+// processing loop would.
+struct ScratchFunctor
+{
+  vtkSMPThreadLocalObject<vtkObjectPool<vtkIdList> > IdLists;
+  vtkSMPThreadLocalObject<vtkObjectPool<vtkPoints> > Points;
+  std::atomic<int> Errors;
+
+  ScratchFunctor() : Errors(0) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkObjectPool<vtkIdList> *idLists = this->IdLists.Local();
+    vtkObjectPool<vtkPoints> *points = this->Points.Local();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      vtkIdList *a = idLists->Acquire();
+      vtkIdList *b = idLists->Acquire();
+      vtkPoints *pts = points->Acquire();
+      a->SetNumberOfIds(1 + i % 8);
+      b->SetNumberOfIds(1 + i % 5);
+      pts->SetNumberOfPoints(1 + i % 3);
+      if (a == b || idLists->GetNumberOfObjectsInUse() != 2)
+      {
+        ++this->Errors;
+      }
+      idLists->ReleaseAll();
+      points->ReleaseAll();
+    }
+  }
+};
+
+}
+
+int TestObjectPool(int, char *[])
+{
+  vtkNew<vtkObjectPool<vtkIdList> > pool;
+  vtkIdList *first = pool->Acquire();
+  vtkIdList *second = pool->Acquire();
+  pool->ReleaseAll();
+  if (first == second || pool->Acquire() != first ||
+      pool->Acquire() != second || pool->GetNumberOfAllocations() != 2 ||
+      pool->GetNumberOfAcquisitions() != 4 || pool->GetNumberOfHits() != 2)
+  {
+    cerr << "Objects are not reused" << endl;
+    return EXIT_FAILURE;
+  }
+  pool->Initialize();
+  pool->ResetCounters();
+  if (pool->GetNumberOfObjects() != 0 || pool->GetNumberOfAllocations() != 0)
+  {
+    cerr << "Initialize failed" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // The number of allocations depends on the number of threads only.
+  const vtkIdType numItems = 100000;
+  ScratchFunctor functor;
+  vtkSMPTools::For(0, numItems, functor);
+  vtkIdType numThreads = 0;
+  vtkIdType allocations = 0;
+  vtkIdType acquisitions = 0;
+  for (auto idLists : functor.IdLists)
+  {
+    ++numThreads;
+    allocations += idLists->GetNumberOfAllocations();
+    acquisitions += idLists->GetNumberOfAcquisitions();
+  }
+  for (auto points : functor.Points)
+  {
+    allocations += points->GetNumberOfAllocations();
+  }
+  if (functor.Errors != 0 || acquisitions != 2 * numItems ||
+      allocations != 3 * numThreads)
+  {
+    cerr << "Wrong pool usage: " << allocations << " allocations and "
+         << acquisitions << " acquisitions for " << numThreads
+         << " threads" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
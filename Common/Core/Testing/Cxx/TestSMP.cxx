@@ -13,11 +13,16 @@
 
 =========================================================================*/
 #include "vtkSMPThreadLocal.h"
+#include "vtkDataArrayRange.h"
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
 #include "vtkNew.h"
 #include "vtkObject.h"
 #include "vtkObjectFactory.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocalObject.h"
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <vector>
 
@@ -91,13 +96,121 @@ public:
 
 };
 
+// Runs an inner parallel loop for each iteration of the outer one.
+class NestedFunctor
+{
+public:
+  vtkSMPThreadLocal<int> Counter;
+
+  NestedFunctor(): Counter(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i=begin; i<end; i++)
+    {
+      ARangeFunctor inner;
+      vtkSMPTools::For(0, 100, 1, inner);
+      for (auto itr = inner.Counter.begin(); itr != inner.Counter.end(); ++itr)
+      {
+        this->Counter.Local() += *itr;
+      }
+    }
+  }
+};
+
 // For sorting comparison
 bool myComp (double a, double b) { return (a<b); }
 
-int TestSMP(int, char*[])
+// Parallel algorithms on vtkDataArray ranges.
+static int TestAlgorithms()
 {
-  //vtkSMPTools::Initialize(8);
+  const vtkIdType size = 100000;
+  vtkNew<vtkIntArray> ints;
+  ints->SetNumberOfValues(size);
+  auto intRange = vtk::DataArrayValueRange(ints);
+
+  vtkSMPTools::Fill(intRange.begin(), intRange.end(), 1);
+  if (vtkSMPTools::Reduce(intRange.begin(), intRange.end(), 0) != size)
+  {
+    cerr << "Error: Bad fill or reduce!" << endl;
+    return 1;
+  }
+
+  // Offsets of the values when each value is its own count.
+  std::vector<int> offsets(size);
+  vtkSMPTools::ExclusiveScan(
+    intRange.begin(), intRange.end(), offsets.begin(), 10);
+  vtkSMPTools::InclusiveScan(intRange.begin(), intRange.end(), intRange.begin());
+  for (vtkIdType i = 0; i < size; ++i)
+  {
+    if (offsets[i] != 10 + i || ints->GetValue(i) != i + 1)
+    {
+      cerr << "Error: Bad scan at " << i << endl;
+      return 1;
+    }
+  }
+
+  // Unary transform in place and binary transform.
+  vtkSMPTools::Transform(intRange.begin(), intRange.end(), offsets.begin(),
+    offsets.begin(), [](int value, int offset) { return offset - value; });
+  vtkSMPTools::Transform(offsets.begin(), offsets.end(), offsets.begin(),
+    [](int value) { return 2 * value; });
+  if (vtkSMPTools::Reduce(offsets.begin(), offsets.end(), 0,
+        [](int a, int b) { return std::max(a, b); }) != 18 ||
+      vtkSMPTools::Reduce(offsets.begin(), offsets.end(), 100,
+        [](int a, int b) { return std::min(a, b); }) != 18)
+  {
+    cerr << "Error: Bad transform!" << endl;
+    return 1;
+  }
+
+  // Even values first, in their original order.
+  auto middle = vtkSMPTools::StablePartition(intRange.begin(), intRange.end(),
+    [](int value) { return value % 2 == 0; });
+  if (middle - intRange.begin() != size / 2)
+  {
+    cerr << "Error: Bad partition point!" << endl;
+    return 1;
+  }
+  for (vtkIdType i = 0; i < size / 2; ++i)
+  {
+    if (ints->GetValue(i) != 2 * (i + 1) ||
+        ints->GetValue(size / 2 + i) != 2 * i + 1)
+    {
+      cerr << "Error: Bad partition at " << i << endl;
+      return 1;
+    }
+  }
 
+  // Tuple ranges.
+  vtkNew<vtkDoubleArray> points;
+  points->SetNumberOfComponents(3);
+  points->SetNumberOfTuples(size);
+  auto pointValues = vtk::DataArrayValueRange<3>(points);
+  vtkSMPTools::Fill(pointValues.begin(), pointValues.end(), 0.5);
+  auto pointRange = vtk::DataArrayTupleRange<3>(points);
+  typedef decltype(pointRange)::const_reference TupleReference;
+  double total = vtkSMPTools::TransformReduce(pointRange.cbegin(),
+    pointRange.cend(), 0.0, std::plus<double>(),
+    [](const TupleReference& tuple) {
+      double p[3];
+      tuple.GetTuple(p);
+      return p[0] + p[1] + p[2];
+    });
+  if (total != 1.5 * size)
+  {
+    cerr << "Error: Bad tuple transform reduce!" << endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+
+static int RunSMPTests()
+{
   ARangeFunctor functor1;
 
   vtkSMPTools::For(0, Target, functor1);
@@ -140,6 +253,22 @@ int TestSMP(int, char*[])
     return 1;
   }
 
+  NestedFunctor functor3;
+
+  vtkSMPTools::For(0, 100, 1, functor3);
+
+  total = 0;
+  for (auto itr3 = functor3.Counter.begin(); itr3 != functor3.Counter.end(); ++itr3)
+  {
+    total += *itr3;
+  }
+
+  if (total != 100 * 100)
+  {
+    cerr << "Error: NestedFunctor did not generate " << 100 * 100 << endl;
+    return 1;
+  }
+
   // Test sorting
   double data0[] = {2,1,0,3,9,6,7,3,8,4,5};
   std::vector<double> myvector (data0, data0+11);
@@ -167,5 +296,87 @@ int TestSMP(int, char*[])
     }
   }
 
+  if (TestAlgorithms())
+  {
+    return 1;
+  }
+
+  // Large enough to be sorted in parallel by the threaded backends.
+  std::vector<int> largeVector(100000);
+  for (size_t i=0; i<largeVector.size(); ++i)
+  {
+    largeVector[i] = static_cast<int>((i * 7919) % largeVector.size());
+  }
+  vtkSMPTools::Sort(largeVector.begin(), largeVector.end());
+  for (size_t i=0; i<largeVector.size(); ++i)
+  {
+    if ( largeVector[i] != static_cast<int>(i) )
+    {
+      cerr << "Error: Bad large vector sort!" << endl;
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+int TestSMP(int, char*[])
+{
+  // Run the tests with every back-end that was compiled in, first with the
+  // default number of threads and then with several threads, so that the
+  // work is split and stolen even on machines with a single core.
+  const char* backends[] = { "Sequential", "STDThread", "OpenMP", "TBB" };
+  for (int numThreads : { 0, 4 })
+  {
+    vtkSMPTools::Initialize(numThreads);
+    for (const char* backend : backends)
+    {
+      if (!vtkSMPTools::SetBackend(backend))
+      {
+        continue;
+      }
+      if (strcmp(vtkSMPTools::GetBackend(), backend) != 0)
+      {
+        cerr << "Error: back-end " << backend << " was not selected" << endl;
+        return 1;
+      }
+      if (RunSMPTests())
+      {
+        cerr << "Error: tests failed with the " << backend << " back-end and "
+             << vtkSMPTools::GetEstimatedNumberOfThreads() << " threads" << endl;
+        return 1;
+      }
+    }
+  }
+
+  if (vtkSMPTools::SetBackend("NotABackend"))
+  {
+    cerr << "Error: an invalid back-end was accepted" << endl;
+    return 1;
+  }
+
+  // Settings local to a scope do not leak out of it and are seen by the
+  // threads executing the parallel sections started in that scope.
+  const bool nested = vtkSMPTools::GetNestedParallelism();
+  bool scopeOk = true;
+  vtkSMPTools::LocalScope(vtkSMPTools::Config{ 1 }, [&]() {
+    scopeOk = vtkSMPTools::GetEstimatedNumberOfThreads() == 1;
+    vtkSMPTools::LocalScope(vtkSMPTools::Config{ false }, [&]() {
+      vtkSMPTools::For(0, 10, 1, [&](vtkIdType, vtkIdType) {
+        if (!vtkSMPTools::IsParallelScope() ||
+            vtkSMPTools::GetNestedParallelism())
+        {
+          scopeOk = false;
+        }
+      });
+    });
+  });
+  if (!scopeOk || vtkSMPTools::IsParallelScope() ||
+      vtkSMPTools::GetNestedParallelism() != nested)
+  {
+    cerr << "Error: LocalScope settings were not applied" << endl;
+    return 1;
+  }
+
   return 0;
 }
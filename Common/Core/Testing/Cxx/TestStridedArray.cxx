@@ -0,0 +1,149 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStridedArray.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkArrayDispatch.h"
+#include "vtkDataArrayRange.h"
+#include "vtkFloatArray.h"
+#include "vtkNew.h"
+#include "vtkSmartPointer.h"
+#include "vtkStridedArray.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+
+#pragma pack(push, 1)
+// Packed, so that the temperatures are not aligned.
+struct Particle
+{
+  double X[3];
+  char Flag;
+  float T;
+};
+#pragma pack(pop)
+
+// Compute the centroid of 3-component arrays.
+struct CentroidWorker
+{
+  double Centroid[3];
+
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    this->Centroid[0] = this->Centroid[1] = this->Centroid[2] = 0.0;
+    const auto tuples = vtk::DataArrayTupleRange<3>(array);
+    for (const auto& tuple : tuples)
+    {
+      int c = 0;
+      for (const double x : tuple)
+      {
+        this->Centroid[c++] += x;
+      }
+    }
+    for (int c = 0; c < 3; ++c)
+    {
+      this->Centroid[c] /= array->GetNumberOfTuples();
+    }
+  }
+};
+
+}
+
+int TestStridedArray(int, char *[])
+{
+  const vtkIdType n = 100;
+  std::vector<Particle> particles(n);
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    particles[i].X[0] = i;
+    particles[i].X[1] = 2.0 * i;
+    particles[i].X[2] = -1.0;
+    particles[i].Flag = 'a';
+    particles[i].T = 0.5f * i;
+  }
+
+  vtkNew<vtkStridedArray<double> > positions;
+  positions->SetNumberOfComponents(3);
+  positions->SetNumberOfTuples(n);
+  positions->SetBackend(vtkStridedImplicitBackend<double>(
+    particles.data(), sizeof(Particle), offsetof(Particle, X)));
+  vtkNew<vtkStridedArray<float> > temperatures;
+  temperatures->SetNumberOfTuples(n);
+  temperatures->SetBackend(vtkStridedImplicitBackend<float>(
+    particles.data(), sizeof(Particle), offsetof(Particle, T)));
+
+  for (vtkIdType i = 0; i < n; ++i)
+  {
+    double x[3];
+    positions->GetTuple(i, x);
+    if (x[0] != i || x[1] != 2.0 * i || x[2] != -1.0 ||
+        temperatures->GetValue(i) != 0.5f * i)
+    {
+      cerr << "Wrong values for particle " << i << endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // The views follow the changes of the memory, and so does the copy
+  // returned by GetVoidPointer() once the array is modified, without moving.
+  float *copied = static_cast<float*>(temperatures->GetVoidPointer(0));
+  if (!copied || copied[n - 1] != 0.5f * (n - 1))
+  {
+    cerr << "Wrong void pointer" << endl;
+    return EXIT_FAILURE;
+  }
+  particles[n - 1].T = 1000.0f;
+  temperatures->Modified();
+  double range[2];
+  temperatures->GetRange(range);
+  if (range[0] != 0.0 || range[1] != 1000.0)
+  {
+    cerr << "Wrong range: " << range[0] << " " << range[1] << endl;
+    return EXIT_FAILURE;
+  }
+  if (copied[n - 1] != 1000.0f ||
+      copied != static_cast<float*>(temperatures->GetVoidPointer(0)))
+  {
+    cerr << "Stale void pointer" << endl;
+    return EXIT_FAILURE;
+  }
+
+  typedef vtkTypeList_Create_1(vtkStridedArray<double>) StridedArrays;
+  CentroidWorker worker;
+  if (!vtkArrayDispatch::DispatchByArray<StridedArrays>::Execute(positions,
+                                                                 worker) ||
+      worker.Centroid[0] != (n - 1) / 2.0 ||
+      worker.Centroid[1] != static_cast<double>(n - 1) ||
+      worker.Centroid[2] != -1.0)
+  {
+    cerr << "Dispatch failed" << endl;
+    return EXIT_FAILURE;
+  }
+
+  // Copies are contiguous.
+  vtkSmartPointer<vtkDataArray> copy;
+  copy.TakeReference(temperatures->NewInstance());
+  copy->DeepCopy(temperatures);
+  vtkFloatArray *floats = vtkArrayDownCast<vtkFloatArray>(copy);
+  if (!floats || floats->GetValue(n - 1) != 1000.0f ||
+      floats->GetValue(1) != 0.5f)
+  {
+    cerr << "Wrong copy" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkAffineArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkAffineImplicitBackend
+ * @brief   implicit array backend returning Start + Step * tupleIdx
+ *
+ * All the components of a tuple have the same value. vtkAffineArray<T> is the
+ * vtkImplicitArray using this backend. For instance, the ids of n points:
+ * \code
+ * vtkNew<vtkAffineArray<vtkIdType> > ids;
+ * ids->SetNumberOfTuples(n);
+ * ids->SetBackend(vtkAffineImplicitBackend<vtkIdType>(0, 1));
+ * \endcode
+ *
+ * @sa
+ * vtkImplicitArray
+*/
+
+#ifndef vtkAffineArray_h
+#define vtkAffineArray_h
+
+#include "vtkImplicitArray.h"
+
+template <typename ValueT>
+struct vtkAffineImplicitBackend
+{
+  typedef ValueT ValueType;
+
+  vtkAffineImplicitBackend(ValueType start = ValueType(),
+                           ValueType step = ValueType())
+    : Start(start), Step(step)
+  {
+  }
+
+  ValueType operator()(vtkIdType tupleIdx, int) const
+  {
+    return static_cast<ValueType>(this->Start + this->Step * tupleIdx);
+  }
+
+  ValueType Start;
+  ValueType Step;
+};
+
+template <typename ValueT>
+using vtkAffineArray = vtkImplicitArray<vtkAffineImplicitBackend<ValueT> >;
+
+#endif
+// VTK-HeaderTest-Exclude: vtkAffineArray.h
@@ -0,0 +1,77 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkCompositeArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkCompositeImplicitBackend
+ * @brief   implicit array backend concatenating several arrays
+ *
+ * The tuples of the arrays are returned one array after the other, e.g. to
+ * append the data of several datasets without copying it. The arrays are
+ * referenced, not copied, and must have the same number of components.
+ * vtkCompositeArray<T> is the vtkImplicitArray using this backend.
+ *
+ * @sa
+ * vtkImplicitArray vtkIndexedArray
+*/
+
+#ifndef vtkCompositeArray_h
+#define vtkCompositeArray_h
+
+#include "vtkDataArray.h"
+#include "vtkImplicitArray.h"
+#include "vtkSmartPointer.h"
+
+#include <algorithm> // For std::upper_bound
+#include <vector> // For the arrays
+
+template <typename ValueT>
+struct vtkCompositeImplicitBackend
+{
+  typedef ValueT ValueType;
+
+  vtkCompositeImplicitBackend() : Offsets(1, 0) {}
+
+  /**
+   * Append an array to the concatenation.
+   */
+  void AddArray(vtkDataArray *array)
+  {
+    this->Arrays.push_back(array);
+    this->Offsets.push_back(this->Offsets.back() + array->GetNumberOfTuples());
+  }
+
+  /**
+   * Return the total number of tuples of the arrays.
+   */
+  vtkIdType GetNumberOfTuples() const { return this->Offsets.back(); }
+
+  ValueType operator()(vtkIdType tupleIdx, int compIdx) const
+  {
+    size_t idx = std::upper_bound(this->Offsets.begin(), this->Offsets.end(),
+                                  tupleIdx) - this->Offsets.begin() - 1;
+    return static_cast<ValueType>(this->Arrays[idx]->GetComponent(
+      tupleIdx - this->Offsets[idx], compIdx));
+  }
+
+  std::vector<vtkSmartPointer<vtkDataArray> > Arrays;
+  // First tuple of each array, followed by the total number of tuples.
+  std::vector<vtkIdType> Offsets;
+};
+
+template <typename ValueT>
+using vtkCompositeArray =
+  vtkImplicitArray<vtkCompositeImplicitBackend<ValueT> >;
+
+#endif
+// VTK-HeaderTest-Exclude: vtkCompositeArray.h
@@ -0,0 +1,51 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkConstantArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkConstantImplicitBackend
+ * @brief   implicit array backend returning the same value everywhere
+ *
+ * vtkConstantArray<T> is the vtkImplicitArray using this backend:
+ * \code
+ * vtkNew<vtkConstantArray<double> > ones;
+ * ones->SetNumberOfTuples(numPts);
+ * ones->SetBackend(vtkConstantImplicitBackend<double>(1.0));
+ * \endcode
+ *
+ * @sa
+ * vtkImplicitArray
+*/
+
+#ifndef vtkConstantArray_h
+#define vtkConstantArray_h
+
+#include "vtkImplicitArray.h"
+
+template <typename ValueT>
+struct vtkConstantImplicitBackend
+{
+  typedef ValueT ValueType;
+
+  vtkConstantImplicitBackend(ValueType value = ValueType()) : Value(value) {}
+
+  ValueType operator()(vtkIdType, int) const { return this->Value; }
+
+  ValueType Value;
+};
+
+template <typename ValueT>
+using vtkConstantArray = vtkImplicitArray<vtkConstantImplicitBackend<ValueT> >;
+
+#endif
+// VTK-HeaderTest-Exclude: vtkConstantArray.h
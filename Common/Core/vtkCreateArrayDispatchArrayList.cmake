@@ -15,6 +15,10 @@
 #   Include vtkTypedDataArray<ValueType> for the basic types supported
 #   by VTK. This enables the old-style in-situ vtkMappedDataArray subclasses
 #   to be used.
+# - VTK_DISPATCH_IMPLICIT_ARRAYS (default: OFF)
+#   Include the vtkImplicitArray aliases provided by VTK (vtkConstantArray,
+#   vtkAffineArray, vtkIndexedArray, vtkCompositeArray and vtkStridedArray for
+#   the basic types, vtkStructuredPointArray for float and double).
 #
 # At a lower level, specific arrays can be added to the list individually in
 # two ways:
@@ -139,6 +143,24 @@ if (VTK_DISPATCH_TYPED_ARRAYS)
   )
 endif()
 
+if (VTK_DISPATCH_IMPLICIT_ARRAYS)
+  foreach(container vtkConstantArray vtkAffineArray vtkIndexedArray
+                    vtkCompositeArray vtkStridedArray)
+    list(APPEND vtkArrayDispatch_containers ${container})
+    set(vtkArrayDispatch_${container}_header ${container}.h)
+    set(vtkArrayDispatch_${container}_types
+      ${vtkArrayDispatch_all_types}
+    )
+  endforeach()
+  list(APPEND vtkArrayDispatch_containers vtkStructuredPointArray)
+  set(vtkArrayDispatch_vtkStructuredPointArray_header
+    vtkStructuredPointArray.h)
+  set(vtkArrayDispatch_vtkStructuredPointArray_types
+    "float"
+    "double"
+  )
+endif()
+
 endmacro()
 
 # Concatenates a list of strings into a single string, since string(CONCAT ...)
@@ -379,17 +379,56 @@ bool hasValidKey(InfoType info, KeyType key, double range[2])
   return false;
 }
 
+// The per-component information vector may also exist for other keys (see
+// vtkAbstractArray::GetProminentComponentValues()), check the range itself.
 template<typename InfoType, typename KeyType, typename ComponentKeyType>
 bool hasValidKey(InfoType info, KeyType key, ComponentKeyType ckey, double range[2], int comp)
 {
-  if (info->Has(key))
+  vtkInformationVector* infoVec = info->Get(key);
+  if (infoVec && comp < infoVec->GetNumberOfInformationObjects() &&
+      infoVec->GetInformationObject(comp)->Has(ckey))
   {
-    info->Get(key)->GetInformationObject(comp)->Get(ckey, range);
+    infoVec->GetInformationObject(comp)->Get(ckey, range);
     return true;
   }
   return false;
 }
 
+// Cache the ranges of all the components, keeping the other per-component
+// keys when the information vector already exists.
+void setComponentRanges(vtkInformation* info,
+                        vtkInformationInformationVectorKey* key,
+                        vtkInformationDoubleVectorKey* ckey,
+                        int numComps, const double* ranges)
+{
+  vtkInformationVector* infoVec = info->Get(key);
+  if (!infoVec || infoVec->GetNumberOfInformationObjects() < numComps)
+  {
+    infoVec = vtkInformationVector::New();
+    infoVec->SetNumberOfInformationObjects(numComps);
+    info->Set(key, infoVec);
+    infoVec->FastDelete();
+  }
+  for (int i = 0; i < numComps; ++i)
+  {
+    infoVec->GetInformationObject(i)->Set(ckey, ranges + (i * 2), 2);
+  }
+}
+
+// A range computed on all the values that has finite bounds is also the
+// range of the finite values, so it can be cached as such too.
+bool isFiniteRange(const double* ranges, int numComps)
+{
+  for (int i = 0; i < 2 * numComps; ++i)
+  {
+    if (vtkMath::IsInf(ranges[i]) || vtkMath::IsNan(ranges[i]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
 } // end anon namespace
 
 vtkInformationKeyRestrictedMacro(vtkDataArray, COMPONENT_RANGE, DoubleVector, 2);
@@ -1464,21 +1503,14 @@ void vtkDataArray::CopyComponent(int dstComponent, vtkDataArray *src,
 //----------------------------------------------------------------------------
 double vtkDataArray::GetMaxNorm()
 {
-  vtkIdType i;
-  double norm, maxNorm;
-  int nComponents = this->GetNumberOfComponents();
-
-  maxNorm = 0.0;
-  for (i=0; i<this->GetNumberOfTuples(); i++)
+  // The magnitude range is computed in parallel, for any number of
+  // components.
+  double range[2];
+  if (!this->ComputeVectorRange(range) || !(range[1] > 0.0))
   {
-    norm = vtkMath::Norm(this->GetTuple(i), nComponents);
-    if ( norm > maxNorm )
-    {
-      maxNorm = norm;
-    }
+    return 0.0;
   }
-
-  return maxNorm;
+  return range[1];
 }
 
 //----------------------------------------------------------------------------
@@ -1542,18 +1574,8 @@ void vtkDataArray::ComputeFiniteRange(double range[2], int comp)
       const bool computed = this->ComputeFiniteScalarRange(allCompRanges);
       if(computed)
       {
-        //construct the keys and add them to the info object
-        vtkInformationVector* infoVec = vtkInformationVector::New();
-        info->Set(PER_FINITE_COMPONENT(), infoVec);
-
-        infoVec->SetNumberOfInformationObjects( this->NumberOfComponents );
-        for ( int i = 0; i < this->NumberOfComponents; ++i )
-        {
-          infoVec->GetInformationObject( i )->Set( rkey,
-                                                   allCompRanges+(i*2),
-                                                   2 );
-        }
-        infoVec->FastDelete();
+        setComponentRanges(info, PER_FINITE_COMPONENT(), rkey,
+                           this->NumberOfComponents, allCompRanges);
 
         //update the range passed in since we have a valid range.
         range[0] = allCompRanges[comp*2];
@@ -1592,6 +1614,10 @@ void vtkDataArray::ComputeRange(double range[2], int comp)
     {
       this->ComputeVectorRange(range);
       info->Set(rkey, range, 2);
+      if (isFiniteRange(range, 1))
+      {
+        info->Set(L2_NORM_FINITE_RANGE(), range, 2);
+      }
     }
     return;
   }
@@ -1606,18 +1632,13 @@ void vtkDataArray::ComputeRange(double range[2], int comp)
       const bool computed = this->ComputeScalarRange(allCompRanges);
       if (computed)
       {
-        // construct the keys and add them to the info object
-        vtkInformationVector* infoVec = vtkInformationVector::New();
-        info->Set(PER_COMPONENT(), infoVec);
-
-        infoVec->SetNumberOfInformationObjects(this->NumberOfComponents);
-        for (int i = 0; i < this->NumberOfComponents; ++i)
+        setComponentRanges(info, PER_COMPONENT(), rkey,
+                           this->NumberOfComponents, allCompRanges);
+        if (isFiniteRange(allCompRanges, this->NumberOfComponents))
         {
-          infoVec->GetInformationObject(i)->Set( rkey,
-                                                 allCompRanges+(i*2),
-                                                 2 );
+          setComponentRanges(info, PER_FINITE_COMPONENT(), rkey,
+                             this->NumberOfComponents, allCompRanges);
         }
-        infoVec->FastDelete();
 
         // update the range passed in since we have a valid range.
         range[0] = allCompRanges[comp*2];
@@ -628,6 +628,7 @@ inline vtkDataArray* vtkDataArray::FastDownCast(vtkAbstractArray *source)
       case TypedDataArray:
       case DataArray:
       case MappedDataArray:
+      case ImplicitArray:
         return static_cast<vtkDataArray*>(source);
       default:
         break;
@@ -93,6 +93,10 @@ bool isinf(T x)
 }
 }
 
+// The functors below accumulate each chunk of tuples in local variables and
+// merge them into the thread local range at the end of the chunk: as the
+// range and the array may have the same type, updating the thread local range
+// in the loop would force a store per value and prevent vectorization.
 template<typename APIType, int NumComps>
 class MinAndMax
 {
@@ -100,6 +104,14 @@ protected:
   APIType ReducedRange[2 * NumComps];
   vtkSMPThreadLocal<std::array<APIType, 2 * NumComps>> TLRange;
 public:
+  MinAndMax()
+  {
+    for(int i = 0, j = 0; i < NumComps; ++i, j+=2)
+    {
+      this->ReducedRange[j] = vtkTypeTraits<APIType>::Max();
+      this->ReducedRange[j+1] = vtkTypeTraits<APIType>::Min();
+    }
+  }
   void Initialize()
   {
     auto &range = this->TLRange.Local();
@@ -107,8 +119,6 @@ public:
     {
       range[j] = vtkTypeTraits<APIType>::Max();
       range[j+1] = vtkTypeTraits<APIType>::Min();
-      this->ReducedRange[j] = vtkTypeTraits<APIType>::Max();
-      this->ReducedRange[j+1] = vtkTypeTraits<APIType>::Min();
     }
   }
   void Reduce()
@@ -154,7 +164,8 @@ public:
   {
     VTK_ASSUME(this->Array->GetNumberOfComponents() == NumComps);
     vtkDataArrayAccessor<ArrayT> access(this->Array);
-    auto &range = MinAndMaxT::TLRange.Local();
+    auto &tlRange = MinAndMaxT::TLRange.Local();
+    std::array<APIType, 2 * NumComps> range = tlRange;
     for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
     {
       for(int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j+=2)
@@ -164,6 +175,7 @@ public:
         range[j+1] = detail::max(range[j+1], value);
       }
     }
+    tlRange = range;
   }
 };
 
@@ -188,7 +200,8 @@ public:
   {
     VTK_ASSUME(this->Array->GetNumberOfComponents() == NumComps);
     vtkDataArrayAccessor<ArrayT> access(this->Array);
-    auto &range = MinAndMaxT::TLRange.Local();
+    auto &tlRange = MinAndMaxT::TLRange.Local();
+    std::array<APIType, 2 * NumComps> range = tlRange;
     for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
     {
       for(int compIdx = 0, j = 0; compIdx < NumComps; ++compIdx, j+=2)
@@ -201,6 +214,7 @@ public:
         }
       }
     }
+    tlRange = range;
   }
 };
 
@@ -234,6 +248,8 @@ public:
     const int NumComps = this->Array->GetNumberOfComponents();
     vtkDataArrayAccessor<ArrayT> access(this->Array);
     auto &range = MinAndMaxT::TLRange.Local();
+    APIType minSquaredSum = range[0];
+    APIType maxSquaredSum = range[1];
     for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
     {
       APIType squaredSum = 0.0;
@@ -242,9 +258,11 @@ public:
         const APIType t = static_cast<APIType>(access.Get(tupleIdx, compIdx));
         squaredSum += t * t;
       }
-      range[0] = detail::min(range[0], squaredSum);
-      range[1] = detail::max(range[1], squaredSum);
+      minSquaredSum = detail::min(minSquaredSum, squaredSum);
+      maxSquaredSum = detail::max(maxSquaredSum, squaredSum);
     }
+    range[0] = minSquaredSum;
+    range[1] = maxSquaredSum;
   }
 };
 
@@ -279,6 +297,8 @@ public:
     const int NumComps = this->Array->GetNumberOfComponents();
     vtkDataArrayAccessor<ArrayT> access(this->Array);
     auto &range = MinAndMaxT::TLRange.Local();
+    APIType minSquaredSum = range[0];
+    APIType maxSquaredSum = range[1];
     for(vtkIdType tupleIdx = begin; tupleIdx < end; ++tupleIdx)
     {
       APIType squaredSum = 0.0;
@@ -289,10 +309,12 @@ public:
       }
       if (!detail::isinf(squaredSum))
       {
-        range[0] = detail::min(range[0], squaredSum);
-        range[1] = detail::max(range[1], squaredSum);
+        minSquaredSum = detail::min(minSquaredSum, squaredSum);
+        maxSquaredSum = detail::max(maxSquaredSum, squaredSum);
       }
     }
+    range[0] = minSquaredSum;
+    range[1] = maxSquaredSum;
   }
 };
 
@@ -330,7 +352,14 @@ protected:
   vtkSMPThreadLocal<std::vector<APIType>> TLRange;
   std::vector<APIType> ReducedRange;
 public:
-  GenericMinAndMax(ArrayT * array) : Array(array), NumComps(Array->GetNumberOfComponents()), ReducedRange(2 * NumComps) {}
+  GenericMinAndMax(ArrayT * array) : Array(array), NumComps(Array->GetNumberOfComponents()), ReducedRange(2 * NumComps)
+  {
+    for(int i = 0, j = 0; i < this->NumComps; ++i, j+=2)
+    {
+      this->ReducedRange[j] = vtkTypeTraits<APIType>::Max();
+      this->ReducedRange[j+1] = vtkTypeTraits<APIType>::Min();
+    }
+  }
   void Initialize()
   {
     auto &range = this->TLRange.Local();
@@ -339,8 +368,6 @@ public:
     {
       range[j] = vtkTypeTraits<APIType>::Max();
       range[j+1] = vtkTypeTraits<APIType>::Min();
-      this->ReducedRange[j] = vtkTypeTraits<APIType>::Max();
-      this->ReducedRange[j+1] = vtkTypeTraits<APIType>::Min();
     }
   }
   void Reduce()
@@ -0,0 +1,351 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkImplicitArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkImplicitArray
+ * @brief   read-only vtkGenericDataArray whose values are computed on the fly
+ *
+ * vtkImplicitArray stores no values. Each component is returned by a
+ * backend, a small copyable functor providing:
+ *
+ * \code
+ * struct MyBackend
+ * {
+ *   typedef double ValueType;
+ *   ValueType operator()(vtkIdType tupleIdx, int compIdx) const;
+ * };
+ * \endcode
+ *
+ * The value type of the array is the one of the backend. Since the backend is
+ * a template argument, the calls are inlined when the array is accessed
+ * through vtkArrayDispatch, vtkDataArrayAccessor or vtkDataArrayRange, which
+ * makes it suitable for arrays that are trivially computable but would
+ * otherwise take a lot of memory (point ids, coordinates of structured
+ * points...). The following backends are provided, together with an alias
+ * for the corresponding array:
+ *
+ * - vtkConstantArray: the same value everywhere.
+ * - vtkAffineArray: Start + Step * tupleIdx.
+ * - vtkStructuredPointArray: the points of a structured grid whose
+ *   coordinates are given per axis (vtkImageData, vtkRectilinearGrid).
+ * - vtkIndexedArray: the tuples of another array, picked through a list of
+ *   indices.
+ * - vtkCompositeArray: the concatenation of several arrays.
+ * - vtkStridedArray: a field of interleaved records owned by somebody else,
+ *   e.g. the memory of a simulation code.
+ *
+ * The number of components and tuples must be set as for any other array,
+ * but no memory is allocated. The Set/Insert methods are errors.
+ *
+ * NewInstance() returns a vtkAOSDataArrayTemplate of the same value type, so
+ * that the algorithms copying data to a new array (e.g. vtkDataSetAttributes
+ * ::CopyAllocate()) get a regular, writable array. DeepCopy() of an
+ * implicit array into a regular array materializes the values.
+ *
+ * These arrays are included in the default vtkArrayDispatch array list when
+ * the VTK_DISPATCH_IMPLICIT_ARRAYS option is enabled. Otherwise, they can be
+ * dispatched explicitly, e.g. with vtkArrayDispatch::DispatchByArray.
+ *
+ * @warning
+ * GetVoidPointer() computes and caches a copy of all the values, which
+ * defeats the purpose of these arrays. The copy is read-only: writing to it
+ * does not change the array. It is kept until the array is destroyed and
+ * refreshed in place by Modified() and DataChanged(), so that the pointers
+ * already returned remain valid and follow the changes of the values. Only
+ * a change of the number of values moves it, at the next GetVoidPointer().
+ *
+ * @sa
+ * vtkGenericDataArray vtkConstantArray vtkAffineArray
+ * vtkStructuredPointArray vtkIndexedArray vtkCompositeArray vtkStridedArray
+*/
+
+#ifndef vtkImplicitArray_h
+#define vtkImplicitArray_h
+
+#include "vtkBuffer.h" // For the materialized values
+#include "vtkGenericDataArray.h"
+#include "vtkObjectFactory.h" // For VTK_STANDARD_NEW_BODY
+
+#include <atomic> // For the materialized values
+#include <mutex> // For thread safe materialization
+
+template <class BackendT>
+class vtkImplicitArray : public vtkGenericDataArray<vtkImplicitArray<BackendT>,
+                                                    typename BackendT::ValueType>
+{
+public:
+  typedef BackendT BackendType;
+  typedef typename BackendType::ValueType ValueType;
+  typedef vtkImplicitArray<BackendT> SelfType;
+  typedef vtkGenericDataArray<SelfType, ValueType> GenericDataArrayType;
+  friend class vtkGenericDataArray<SelfType, ValueType>;
+
+  vtkAbstractTypeMacroWithNewInstanceType(SelfType, GenericDataArrayType,
+                                          vtkDataArray,
+                                          typeid(SelfType).name())
+  vtkAOSArrayNewInstanceMacro(SelfType)
+
+  static vtkImplicitArray<BackendT>* New()
+  { VTK_STANDARD_NEW_BODY(vtkImplicitArray<BackendT>); }
+
+  void PrintSelf(ostream &os, vtkIndent indent) override
+  {
+    this->GenericDataArrayType::PrintSelf(os, indent);
+    os << indent << "Materialized: "
+       << (this->Materialized.load() ? "Yes\n" : "No\n");
+  }
+
+  //@{
+  /**
+   * Set/Get the backend computing the values.
+   */
+  void SetBackend(const BackendType &backend)
+  {
+    this->Backend = backend;
+    this->GenericDataArrayType::DataChanged();
+    this->Modified();
+  }
+  const BackendType& GetBackend() const { return this->Backend; }
+  //@}
+
+  /**
+   * Perform a fast, safe cast from a vtkAbstractArray to a vtkImplicitArray.
+   * The array type and data type are checked before the backend is.
+   */
+  static vtkImplicitArray<BackendT>* FastDownCast(vtkAbstractArray *source)
+  {
+    if (source &&
+        source->GetArrayType() == vtkAbstractArray::ImplicitArray &&
+        vtkDataTypesCompare(source->GetDataType(),
+                            vtkTypeTraits<ValueType>::VTK_TYPE_ID))
+    {
+      return dynamic_cast<vtkImplicitArray<BackendT>*>(source);
+    }
+    return nullptr;
+  }
+
+  int GetArrayType() override { return vtkAbstractArray::ImplicitArray; }
+
+  //@{
+  /**
+   * Concept methods of vtkGenericDataArray. The setters report an error: the
+   * array is read-only.
+   */
+  ValueType GetValue(vtkIdType valueIdx) const
+  {
+    vtkIdType tupleIdx = valueIdx / this->NumberOfComponents;
+    return this->Backend(tupleIdx, static_cast<int>(
+      valueIdx - tupleIdx * this->NumberOfComponents));
+  }
+  void SetValue(vtkIdType, ValueType)
+  { vtkErrorMacro("Implicit arrays are read-only."); }
+
+  void GetTypedTuple(vtkIdType tupleIdx, ValueType* tuple) const
+  {
+    for (int c = 0; c < this->NumberOfComponents; ++c)
+    {
+      tuple[c] = this->Backend(tupleIdx, c);
+    }
+  }
+  void SetTypedTuple(vtkIdType, const ValueType*)
+  { vtkErrorMacro("Implicit arrays are read-only."); }
+
+  ValueType GetTypedComponent(vtkIdType tupleIdx, int compIdx) const
+  { return this->Backend(tupleIdx, compIdx); }
+  void SetTypedComponent(vtkIdType, int, ValueType)
+  { vtkErrorMacro("Implicit arrays are read-only."); }
+  //@}
+
+  /**
+   * Return a pointer to a cached copy of the values. See the class
+   * documentation. The copy is computed once even if several threads ask
+   * for it at the same time.
+   */
+  void *GetVoidPointer(vtkIdType valueIdx) override
+  {
+    vtkBuffer<ValueType> *materialized =
+      this->Materialized.load(std::memory_order_acquire);
+    if (!materialized || this->Resized.load(std::memory_order_acquire))
+    {
+      std::lock_guard<std::mutex> lock(this->MaterializedLock);
+      materialized = this->Materialize();
+      if (!materialized)
+      {
+        return nullptr;
+      }
+    }
+    return materialized->GetBuffer() + valueIdx;
+  }
+
+  //@{
+  /**
+   * Refresh the copy of the values returned by GetVoidPointer(), if any, in
+   * place.
+   */
+  void DataChanged() override
+  {
+    this->RefreshMaterialized();
+    this->GenericDataArrayType::DataChanged();
+  }
+  void Modified() override
+  {
+    this->RefreshMaterialized();
+    this->GenericDataArrayType::Modified();
+  }
+  //@}
+
+  void SetNumberOfComponents(int numComps) override
+  {
+    this->GenericDataArrayType::SetNumberOfComponents(numComps);
+    this->Resized.store(true, std::memory_order_release);
+  }
+
+  /**
+   * Copy the backend and the size of another implicit array of the same
+   * type. Other arrays cannot be copied into an implicit array.
+   */
+  void DeepCopy(vtkDataArray *other) override
+  {
+    if (other == this)
+    {
+      return;
+    }
+    SelfType *source = SelfType::FastDownCast(other);
+    if (!source)
+    {
+      vtkErrorMacro(<< "Cannot copy a " << (other ? other->GetClassName() :
+                    "(null)") << " into an implicit array.");
+      return;
+    }
+    this->SetNumberOfComponents(source->GetNumberOfComponents());
+    this->SetNumberOfTuples(source->GetNumberOfTuples());
+    this->SetBackend(source->Backend);
+    this->SetName(source->GetName());
+  }
+  void DeepCopy(vtkAbstractArray *other) override
+  {
+    this->DeepCopy(vtkArrayDownCast<vtkDataArray>(other));
+  }
+  void ShallowCopy(vtkDataArray *other) override
+  {
+    this->DeepCopy(other);
+  }
+
+protected:
+  vtkImplicitArray() : Materialized(nullptr), Resized(false) {}
+  ~vtkImplicitArray() override
+  {
+    vtkBuffer<ValueType> *materialized = this->Materialized.load();
+    if (materialized)
+    {
+      materialized->Delete();
+    }
+  }
+
+  // Only the size is recorded: there is nothing to allocate. The copy of the
+  // values is resized by the next GetVoidPointer().
+  bool AllocateTuples(vtkIdType)
+  {
+    this->Resized.store(true, std::memory_order_release);
+    return true;
+  }
+  bool ReallocateTuples(vtkIdType)
+  {
+    this->Resized.store(true, std::memory_order_release);
+    return true;
+  }
+
+  // Compute the copy of the values, or resize and refresh it if the number
+  // of values changed. Called with MaterializedLock held.
+  vtkBuffer<ValueType>* Materialize()
+  {
+    vtkBuffer<ValueType> *materialized =
+      this->Materialized.load(std::memory_order_relaxed);
+    if (materialized && !this->Resized.load(std::memory_order_relaxed))
+    {
+      return materialized;
+    }
+    vtkIdType numValues = this->GetNumberOfValues();
+    bool allocated = true;
+    if (!materialized)
+    {
+      materialized = vtkBuffer<ValueType>::New();
+      allocated = materialized->Allocate(numValues);
+      if (!allocated)
+      {
+        materialized->Delete();
+      }
+    }
+    else if (materialized->GetSize() != numValues)
+    {
+      allocated = materialized->Reallocate(numValues);
+    }
+    if (!allocated)
+    {
+      vtkErrorMacro(<< "Error allocating a buffer of " << numValues
+                    << " '" << this->GetDataTypeAsString() << "' elements.");
+      return nullptr;
+    }
+    this->FillMaterialized(materialized);
+    this->Materialized.store(materialized, std::memory_order_release);
+    this->Resized.store(false, std::memory_order_release);
+    return materialized;
+  }
+
+  void FillMaterialized(vtkBuffer<ValueType> *materialized)
+  {
+    ValueType *values = materialized->GetBuffer();
+    vtkIdType numValues = materialized->GetSize();
+    for (vtkIdType i = 0; i < numValues; ++i)
+    {
+      values[i] = this->GetValue(i);
+    }
+  }
+
+  // Recompute the values of the copy without moving it. A copy whose size
+  // is out of date is left to the next GetVoidPointer().
+  void RefreshMaterialized()
+  {
+    if (!this->Materialized.load(std::memory_order_acquire))
+    {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(this->MaterializedLock);
+    vtkBuffer<ValueType> *materialized =
+      this->Materialized.load(std::memory_order_relaxed);
+    if (materialized && materialized->GetSize() == this->GetNumberOfValues())
+    {
+      this->FillMaterialized(materialized);
+    }
+    else
+    {
+      this->Resized.store(true, std::memory_order_release);
+    }
+  }
+
+  BackendType Backend;
+  std::atomic<vtkBuffer<ValueType>*> Materialized;
+  std::atomic<bool> Resized;
+  std::mutex MaterializedLock;
+
+private:
+  vtkImplicitArray(const vtkImplicitArray &) = delete;
+  void operator=(const vtkImplicitArray &) = delete;
+};
+
+// Declare vtkArrayDownCast implementations for implicit arrays:
+vtkArrayDownCast_TemplateFastCastMacro(vtkImplicitArray)
+
+#endif
+// VTK-HeaderTest-Exclude: vtkImplicitArray.h
@@ -0,0 +1,61 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkIndexedArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkIndexedImplicitBackend
+ * @brief   implicit array backend picking the tuples of another array
+ *
+ * Tuple i of the implicit array is tuple Indices[i] of Array, e.g. the data
+ * of a subset of points without copying it. Both are referenced, not copied,
+ * and must not change while the implicit array is used. vtkIndexedArray<T>
+ * is the vtkImplicitArray using this backend.
+ *
+ * @sa
+ * vtkImplicitArray vtkCompositeArray
+*/
+
+#ifndef vtkIndexedArray_h
+#define vtkIndexedArray_h
+
+#include "vtkDataArray.h"
+#include "vtkIdList.h"
+#include "vtkImplicitArray.h"
+#include "vtkSmartPointer.h"
+
+template <typename ValueT>
+struct vtkIndexedImplicitBackend
+{
+  typedef ValueT ValueType;
+
+  vtkIndexedImplicitBackend() {}
+  vtkIndexedImplicitBackend(vtkIdList *indices, vtkDataArray *array)
+    : Indices(indices), Array(array)
+  {
+  }
+
+  ValueType operator()(vtkIdType tupleIdx, int compIdx) const
+  {
+    return static_cast<ValueType>(
+      this->Array->GetComponent(this->Indices->GetId(tupleIdx), compIdx));
+  }
+
+  vtkSmartPointer<vtkIdList> Indices;
+  vtkSmartPointer<vtkDataArray> Array;
+};
+
+template <typename ValueT>
+using vtkIndexedArray = vtkImplicitArray<vtkIndexedImplicitBackend<ValueT> >;
+
+#endif
+// VTK-HeaderTest-Exclude: vtkIndexedArray.h
@@ -0,0 +1,187 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkObjectPool.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkObjectPool
+ * @brief   reusable scratch objects, typically one pool per thread
+ *
+ * vtkObjectPool hands out objects of the template argument type (e.g.
+ * vtkIdList, vtkPoints or vtkGenericCell) that are created on first use and
+ * made available again, all at once, by ReleaseAll(). The objects keep their
+ * memory between uses, so an algorithm that acquires the same number of
+ * scratch objects for each cell it processes stops allocating after the
+ * first few cells.
+ *
+ * The pool is not thread safe. It is meant to be used through
+ * vtkSMPThreadLocalObject so that each thread draws from its own pool:
+ * \code
+ * vtkSMPThreadLocalObject<vtkObjectPool<vtkIdList> > Pools;
+ * void operator()(vtkIdType begin, vtkIdType end)
+ * {
+ *   vtkObjectPool<vtkIdList> *pool = this->Pools.Local();
+ *   for (vtkIdType cellId = begin; cellId < end; ++cellId)
+ *   {
+ *     vtkIdList *ids = pool->Acquire();
+ *     ...
+ *     pool->ReleaseAll();
+ *   }
+ * }
+ * \endcode
+ *
+ * GetNumberOfAllocations() counts the objects created by the pool (the
+ * misses) and GetNumberOfHits() the acquisitions served by an object
+ * created earlier, which allows checking that a steady state without
+ * allocation is reached.
+ *
+ * @warning
+ * The acquired objects are owned by the pool. They keep the state left by
+ * their previous user: reset them (e.g. vtkIdList::Reset()) as needed.
+ *
+ * @sa
+ * vtkSMPThreadLocalObject
+*/
+
+#ifndef vtkObjectPool_h
+#define vtkObjectPool_h
+
+#include "vtkObject.h"
+#include "vtkObjectFactory.h" // New() implementation
+
+#include <vector> // For the objects
+
+template <class T>
+class vtkObjectPool : public vtkObject
+{
+public:
+  vtkTemplateTypeMacro(vtkObjectPool<T>, vtkObject)
+
+  static vtkObjectPool<T>* New();
+
+  /**
+   * Return an object that is not in use, creating it if none is available.
+   * The object remains valid until ReleaseAll() or Initialize() is called.
+   */
+  T* Acquire()
+  {
+    if (this->NumberOfObjectsInUse ==
+        static_cast<vtkIdType>(this->Objects.size()))
+    {
+      this->Objects.push_back(T::New());
+      ++this->NumberOfAllocations;
+    }
+    ++this->NumberOfAcquisitions;
+    return this->Objects[this->NumberOfObjectsInUse++];
+  }
+
+  /**
+   * Make all the objects of the pool available again. Their memory is kept.
+   */
+  void ReleaseAll() { this->NumberOfObjectsInUse = 0; }
+
+  /**
+   * Delete all the objects of the pool. The counters are not reset.
+   */
+  void Initialize()
+  {
+    for (size_t i = 0; i < this->Objects.size(); ++i)
+    {
+      this->Objects[i]->Delete();
+    }
+    this->Objects.clear();
+    this->NumberOfObjectsInUse = 0;
+  }
+
+  /**
+   * Return the number of objects owned by the pool.
+   */
+  vtkIdType GetNumberOfObjects()
+  {
+    return static_cast<vtkIdType>(this->Objects.size());
+  }
+
+  /**
+   * Return the number of objects acquired and not released yet.
+   */
+  vtkIdType GetNumberOfObjectsInUse() { return this->NumberOfObjectsInUse; }
+
+  //@{
+  /**
+   * Return the number of objects created, respectively handed out, by the
+   * pool since it was constructed or ResetCounters() was called.
+   */
+  vtkIdType GetNumberOfAllocations() { return this->NumberOfAllocations; }
+  vtkIdType GetNumberOfAcquisitions() { return this->NumberOfAcquisitions; }
+  //@}
+
+  /**
+   * Return the number of acquisitions that reused an object, that is
+   * GetNumberOfAcquisitions() - GetNumberOfAllocations().
+   */
+  vtkIdType GetNumberOfHits()
+  {
+    return this->NumberOfAcquisitions - this->NumberOfAllocations;
+  }
+
+  /**
+   * Reset the allocation and acquisition counters.
+   */
+  void ResetCounters()
+  {
+    this->NumberOfAllocations = 0;
+    this->NumberOfAcquisitions = 0;
+  }
+
+  void PrintSelf(ostream& os, vtkIndent indent) override
+  {
+    this->Superclass::PrintSelf(os, indent);
+    os << indent << "Number Of Objects: " << this->GetNumberOfObjects() << "\n";
+    os << indent << "Number Of Objects In Use: "
+       << this->NumberOfObjectsInUse << "\n";
+    os << indent << "Number Of Allocations: "
+       << this->NumberOfAllocations << "\n";
+    os << indent << "Number Of Acquisitions: "
+       << this->NumberOfAcquisitions << "\n";
+  }
+
+protected:
+  vtkObjectPool()
+    : NumberOfObjectsInUse(0),
+      NumberOfAllocations(0),
+      NumberOfAcquisitions(0)
+  {
+  }
+
+  ~vtkObjectPool() override
+  {
+    this->Initialize();
+  }
+
+  std::vector<T*> Objects;
+  vtkIdType NumberOfObjectsInUse;
+  vtkIdType NumberOfAllocations;
+  vtkIdType NumberOfAcquisitions;
+
+private:
+  vtkObjectPool(const vtkObjectPool&) = delete;
+  void operator=(const vtkObjectPool&) = delete;
+};
+
+template <class T>
+inline vtkObjectPool<T> *vtkObjectPool<T>::New()
+{
+  VTK_STANDARD_NEW_BODY(vtkObjectPool<T>)
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkObjectPool.h
@@ -1,55 +1,112 @@
 set(VTK_SMP_IMPLEMENTATION_TYPE "Sequential"
-  CACHE STRING "Which multi-threaded parallelism implementation to use. Options are Sequential, OpenMP or TBB")
+  CACHE STRING "Which multi-threaded parallelism implementation to use by default. Options are Sequential, STDThread, OpenMP or TBB")
 set_property(CACHE VTK_SMP_IMPLEMENTATION_TYPE
   PROPERTY
-    STRINGS Sequential OpenMP TBB)
+    STRINGS Sequential STDThread OpenMP TBB)
 
 if (NOT (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP" OR
-         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB"))
+         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB" OR
+         VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "STDThread"))
   set_property(CACHE VTK_SMP_IMPLEMENTATION_TYPE
     PROPERTY
       VALUE "Sequential")
 endif ()
 
-set(vtk_smp_headers_to_configure)
-set(vtk_smp_defines)
-set(vtk_smp_use_default_atomics ON)
+# Every enabled back-end is compiled in; the one in use can be changed at run
+# time with vtkSMPTools::SetBackend() or the VTK_SMP_BACKEND_IN_USE
+# environment variable. The default back-end is always enabled.
+option(VTK_SMP_ENABLE_STDTHREAD "Enable the STDThread SMP back-end." ON)
+option(VTK_SMP_ENABLE_OPENMP "Enable the OpenMP SMP back-end." OFF)
+option(VTK_SMP_ENABLE_TBB "Enable the TBB SMP back-end." OFF)
+mark_as_advanced(
+  VTK_SMP_ENABLE_STDTHREAD
+  VTK_SMP_ENABLE_OPENMP
+  VTK_SMP_ENABLE_TBB)
+
+set(VTK_SMP_ENABLE_SEQUENTIAL ON)
+if (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "STDThread")
+  set(VTK_SMP_ENABLE_STDTHREAD ON)
+elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
+  set(VTK_SMP_ENABLE_OPENMP ON)
+elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB")
+  set(VTK_SMP_ENABLE_TBB ON)
+endif ()
 
-if (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB")
+set(vtk_smp_common_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Common")
+list(APPEND vtk_smp_sources
+  "${vtk_smp_common_dir}/vtkSMPTools.cxx"
+  "${vtk_smp_common_dir}/vtkSMPThreadLocalImpl.cxx")
+foreach (vtk_smp_header IN ITEMS vtkSMPThreadLocal.h vtkSMPThreadLocalImpl.h vtkSMPToolsInternal.h)
+  configure_file(
+    "${vtk_smp_common_dir}/${vtk_smp_header}"
+    "${CMAKE_CURRENT_BINARY_DIR}/${vtk_smp_header}"
+    COPYONLY)
+  list(APPEND vtk_smp_headers
+    "${CMAKE_CURRENT_BINARY_DIR}/${vtk_smp_header}")
+endforeach ()
+# For the private vtkSMPToolsImpl.h shared by the back-ends.
+list(APPEND vtk_include_dirs
+  "${vtk_smp_common_dir}")
+
+if (VTK_SMP_ENABLE_TBB)
   vtk_module_find_package(PACKAGE TBB)
   list(APPEND vtk_smp_libraries
     TBB::tbb)
 
-  set(vtk_smp_use_default_atomics OFF)
-  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/TBB")
   list(APPEND vtk_smp_sources
-    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx")
-  list(APPEND vtk_smp_headers_to_configure
-    vtkAtomic.h
-    vtkSMPToolsInternal.h
-    vtkSMPThreadLocal.h)
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/TBB/vtkSMPToolsImpl.cxx")
+  # Private to the library, not installed.
+  configure_file(
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/TBB/vtkSMPToolsInternal.h.in"
+    "${CMAKE_CURRENT_BINARY_DIR}/vtkSMPToolsTBBInternal.h"
+    COPYONLY)
+endif ()
 
-elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
+if (VTK_SMP_ENABLE_OPENMP)
   vtk_module_find_package(PACKAGE OpenMP)
 
   list(APPEND vtk_smp_libraries
     OpenMP::OpenMP_CXX)
 
-  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP")
   list(APPEND vtk_smp_sources
-    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx"
-    "${vtk_smp_implementation_dir}/vtkSMPThreadLocalImpl.cxx")
-  list(APPEND vtk_smp_headers_to_configure
-    vtkSMPThreadLocal.h
-    vtkSMPThreadLocalImpl.h
-    vtkSMPToolsInternal.h)
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP/vtkSMPToolsImpl.cxx")
+  # Private to the library, not installed.
+  configure_file(
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP/vtkSMPToolsInternal.h.in"
+    "${CMAKE_CURRENT_BINARY_DIR}/vtkSMPToolsOpenMPInternal.h"
+    COPYONLY)
+endif ()
+
+if (VTK_SMP_ENABLE_STDTHREAD)
+  # Threads::Threads is already a dependency of the module.
+  list(APPEND vtk_smp_sources
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/STDThread/vtkSMPToolsImpl.cxx")
+endif ()
+
+# The atomics are those of the default back-end when it provides its own,
+# they are used by every back-end.
+set(vtk_smp_use_default_atomics ON)
+if (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "TBB")
+  set(vtk_smp_use_default_atomics OFF)
+  configure_file(
+    "${CMAKE_CURRENT_SOURCE_DIR}/SMP/TBB/vtkAtomic.h.in"
+    "${CMAKE_CURRENT_BINARY_DIR}/vtkAtomic.h"
+    COPYONLY)
+  list(APPEND vtk_smp_headers
+    "${CMAKE_CURRENT_BINARY_DIR}/vtkAtomic.h")
 
+elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
   if (OpenMP_CXX_SPEC_DATE AND NOT "${OpenMP_CXX_SPEC_DATE}" LESS "201107")
     set(vtk_smp_use_default_atomics OFF)
+    set(vtk_atomics_openmp_impl_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/OpenMP")
     list(APPEND vtk_smp_sources
-      "${vtk_smp_implementation_dir}/vtkAtomic.cxx")
-    list(APPEND vtk_smp_headers_to_configure
-      vtkAtomic.h)
+      "${vtk_atomics_openmp_impl_dir}/vtkAtomic.cxx")
+    configure_file(
+      "${vtk_atomics_openmp_impl_dir}/vtkAtomic.h.in"
+      "${CMAKE_CURRENT_BINARY_DIR}/vtkAtomic.h"
+      COPYONLY)
+    list(APPEND vtk_smp_headers
+      "${CMAKE_CURRENT_BINARY_DIR}/vtkAtomic.h")
 
     set_source_files_properties(vtkAtomic.cxx
       PROPERITES
@@ -59,15 +116,7 @@ elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "OpenMP")
       "Required OpenMP version (3.1) for atomics not detected. Using default "
       "atomics implementation.")
   endif()
-
-elseif (VTK_SMP_IMPLEMENTATION_TYPE STREQUAL "Sequential")
-  set(vtk_smp_implementation_dir "${CMAKE_CURRENT_SOURCE_DIR}/SMP/Sequential")
-  list(APPEND vtk_smp_sources
-    "${vtk_smp_implementation_dir}/vtkSMPTools.cxx")
-  list(APPEND vtk_smp_headers_to_configure
-    vtkSMPThreadLocal.h
-    vtkSMPToolsInternal.h)
-endif()
+endif ()
 
 if (vtk_smp_use_default_atomics)
   include(CheckSymbolExists)
@@ -99,15 +148,6 @@ if (vtk_smp_use_default_atomics)
     "${CMAKE_CURRENT_BINARY_DIR}/vtkAtomic.h")
 endif()
 
-foreach (vtk_smp_header IN LISTS vtk_smp_headers_to_configure)
-  configure_file(
-    "${vtk_smp_implementation_dir}/${vtk_smp_header}.in"
-    "${CMAKE_CURRENT_BINARY_DIR}/${vtk_smp_header}"
-    COPYONLY)
-  list(APPEND vtk_smp_headers
-    "${CMAKE_CURRENT_BINARY_DIR}/${vtk_smp_header}")
-endforeach()
-
 list(APPEND vtk_smp_headers
   vtkSMPTools.h
   vtkSMPThreadLocalObject.h)
@@ -19,8 +19,24 @@
  * vtkSMPTools provides a set of utility functions that can
  * be used to parallelize parts of VTK code using multiple threads.
  * There are several back-end implementations of parallel functionality
- * (currently Sequential, TBB and X-Kaapi) that actual execution is
- * delegated to.
+ * (currently Sequential, STDThread, OpenMP and TBB) that actual execution is
+ * delegated to. STDThread has no external dependency: it runs a persistent
+ * pool of std::thread workers with work stealing and supports nested
+ * parallel For() calls.
+ *
+ * All the back-ends enabled at configure time (VTK_SMP_ENABLE_<backend>)
+ * are compiled in. VTK_SMP_IMPLEMENTATION_TYPE selects the default one,
+ * which can be overridden with the VTK_SMP_BACKEND_IN_USE environment
+ * variable or at run time with SetBackend(). LocalScope() changes the
+ * back-end, the maximum number of threads and the nested parallelism policy
+ * for the parallel sections started by the calling thread only, so that
+ * pipelines executing concurrently can each use their own thread budget.
+ *
+ * Besides For() and Sort(), parallel versions of common standard algorithms
+ * are provided: Transform(), Fill(), Reduce(), TransformReduce(),
+ * InclusiveScan(), ExclusiveScan() and StablePartition(). They accept any
+ * random access iterators, in particular the iterators of the vtkDataArray
+ * ranges (see vtkDataArrayRange.h).
 */
 
 #ifndef vtkSMPTools_h
@@ -32,6 +48,10 @@
 #include "vtkSMPThreadLocal.h" // For Initialized
 #include "vtkSMPToolsInternal.h"
 
+#include <functional> // For std::plus
+#include <iterator> // For std::iterator_traits
+#include <string> // For std::string
+
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 #ifndef __VTK_WRAP__
@@ -209,26 +229,270 @@ public:
    * Initialize the underlying libraries for execution. This is
    * not required as it is automatically called before the first
    * execution of any parallel code. However, it can be used to
-   * control the maximum number of threads used when the back-end
-   * supports it (currently Simple and TBB only). Make sure to call
-   * it before any other parallel operation.
-   * When using Kaapi, use the KAAPI_CPUCOUNT env. variable to control
-   * the number of threads used in the thread pool.
+   * control the maximum number of threads used by the back-ends that
+   * support it (currently STDThread, OpenMP and TBB). Make sure to call
+   * it before any other parallel operation. Use LocalScope() to limit the
+   * number of threads of a given code block instead.
    */
   static void Initialize(int numThreads=0);
 
   /**
-   * Get the estimated number of threads being used by the backend.
+   * Get the estimated number of threads being used by the backend, taking
+   * into account the limit set by LocalScope().
    * This should be used as just an estimate since the number of threads may
    * vary dynamically and a particular task may not be executed on all the
    * available threads.
    */
   static int GetEstimatedNumberOfThreads();
 
+  /**
+   * Select the back-end used by parallel sections: "Sequential", "STDThread",
+   * "OpenMP" or "TBB". Returns false, and leaves the back-end unchanged, if
+   * the requested back-end was not enabled at configure time. This is a
+   * process wide setting; prefer LocalScope() to change it temporarily.
+   */
+  static bool SetBackend(const char* backend);
+
+  /**
+   * Get the name of the back-end in use by the calling thread.
+   */
+  static const char* GetBackend();
+
+  //@{
+  /**
+   * When nested parallelism is disabled, For() called from within a parallel
+   * section runs on the calling thread. It is enabled by default. Note that
+   * the OpenMP back-end additionally obeys the OpenMP nesting settings
+   * (OMP_MAX_ACTIVE_LEVELS).
+   */
+  static void SetNestedParallelism(bool isNested);
+  static bool GetNestedParallelism();
+  //@}
+
+  /**
+   * Returns true when called from within a parallel section.
+   */
+  static bool IsParallelScope();
+
+  /**
+   * Settings used by LocalScope(). A default constructed Config uses the
+   * back-end and nested parallelism policy currently in effect and does not
+   * limit the number of threads.
+   */
+  struct Config
+  {
+    int MaxNumberOfThreads;
+    std::string Backend;
+    bool NestedParallelism;
+
+    Config()
+      : MaxNumberOfThreads(0)
+      , Backend(vtkSMPTools::GetBackend())
+      , NestedParallelism(vtkSMPTools::GetNestedParallelism())
+    {
+    }
+    Config(int maxNumberOfThreads)
+      : Config()
+    {
+      this->MaxNumberOfThreads = maxNumberOfThreads;
+    }
+    Config(std::string backend)
+      : Config()
+    {
+      this->Backend = backend;
+    }
+    Config(const char* backend)
+      : Config(std::string(backend))
+    {
+    }
+    Config(bool nestedParallelism)
+      : Config()
+    {
+      this->NestedParallelism = nestedParallelism;
+    }
+  };
+
+  /**
+   * Execute lambda with the given configuration. The configuration applies
+   * to the parallel sections started by the calling thread while lambda runs,
+   * including the nested ones, and does not affect other threads. An unknown
+   * or disabled back-end in config is ignored. With the STDThread back-end,
+   * MaxNumberOfThreads cannot exceed the size of the thread pool (see
+   * Initialize()).
+   *
+   * \code
+   * vtkSMPTools::Config config(4);
+   * vtkSMPTools::LocalScope(config, [&]() { filter->Update(); });
+   * \endcode
+   */
+  template <typename T>
+  static void LocalScope(Config const& config, T&& lambda)
+  {
+    vtk::detail::smp::vtkSMPExecutionSettings settings =
+      vtk::detail::smp::GetExecutionSettings();
+    vtk::detail::smp::GetBackendType(config.Backend.c_str(), settings.Backend);
+    settings.MaxNumberOfThreads = config.MaxNumberOfThreads;
+    settings.NestedParallelism = config.NestedParallelism;
+
+    // Restore the previous settings even if lambda throws.
+    struct Guard
+    {
+      const vtk::detail::smp::vtkSMPExecutionSettings* Previous;
+      ~Guard() { vtk::detail::smp::SwapLocalExecutionSettings(this->Previous); }
+    } guard = { vtk::detail::smp::SwapLocalExecutionSettings(&settings) };
+    lambda();
+  }
+
+  /**
+   * A convenience method for transforming data. It is a drop in replacement
+   * for std::transform() with random access iterators, such as the ones of
+   * the ranges returned by vtk::DataArrayValueRange() and
+   * vtk::DataArrayTupleRange(). The output may be the input.
+   *
+   * \code
+   * auto inRange = vtk::DataArrayValueRange(inArray);
+   * auto outRange = vtk::DataArrayValueRange(outArray);
+   * vtkSMPTools::Transform(inRange.begin(), inRange.end(), outRange.begin(),
+   *   [](double v) { return v * v; });
+   * \endcode
+   */
+  template <typename InputIt, typename OutputIt, typename UnaryOperation>
+  static void Transform(InputIt inBegin, InputIt inEnd, OutputIt outBegin,
+    UnaryOperation transform)
+  {
+    vtk::detail::smp::vtkSMPTools_Impl_Transform(
+      inBegin, inEnd, outBegin, transform);
+  }
+
+  /**
+   * Binary version of Transform(), a drop in replacement for the binary
+   * std::transform().
+   */
+  template <typename InputIt1, typename InputIt2, typename OutputIt,
+    typename BinaryOperation>
+  static void Transform(InputIt1 inBegin1, InputIt1 inEnd1,
+    InputIt2 inBegin2, OutputIt outBegin, BinaryOperation transform)
+  {
+    vtk::detail::smp::vtkSMPTools_Impl_Transform(
+      inBegin1, inEnd1, inBegin2, outBegin, transform);
+  }
+
+  /**
+   * A convenience method for filling data. It is a drop in replacement for
+   * std::fill().
+   */
+  template <typename Iterator, typename T>
+  static void Fill(Iterator begin, Iterator end, const T& value)
+  {
+    vtk::detail::smp::vtkSMPTools_Impl_Fill(begin, end, value);
+  }
+
+  //@{
+  /**
+   * Reduce [begin, end) with op, starting from init. Like std::reduce(), op
+   * must be associative, the values are combined in an unspecified order
+   * that only depends on the size of the range: the result is the same for
+   * any back-end and number of threads. The default operation is the sum.
+   */
+  template <typename Iterator, typename T, typename BinaryOperation>
+  static T Reduce(Iterator begin, Iterator end, T init, BinaryOperation op)
+  {
+    return vtk::detail::smp::vtkSMPTools_Impl_TransformReduce(
+      begin, end, init, op, vtk::detail::smp::vtkSMPTools_Identity());
+  }
+  template <typename Iterator, typename T>
+  static T Reduce(Iterator begin, Iterator end, T init)
+  {
+    return vtkSMPTools::Reduce(begin, end, init, std::plus<T>());
+  }
+  //@}
+
+  /**
+   * Apply transform to each value of [begin, end) and reduce the results
+   * with reduce, starting from init. See Reduce().
+   */
+  template <typename Iterator, typename T, typename BinaryReduceOperation,
+    typename UnaryTransformOperation>
+  static T TransformReduce(Iterator begin, Iterator end, T init,
+    BinaryReduceOperation reduce, UnaryTransformOperation transform)
+  {
+    return vtk::detail::smp::vtkSMPTools_Impl_TransformReduce(
+      begin, end, init, reduce, transform);
+  }
+
+  //@{
+  /**
+   * Inclusive prefix scan of [begin, end) written to outBegin, which may be
+   * begin. op must be associative, the default is the sum. Returns the end
+   * of the output. Typical use is to turn per-item counts into offsets in a
+   * single call instead of a hand written two pass algorithm.
+   */
+  template <typename InputIt, typename OutputIt, typename BinaryOperation>
+  static OutputIt InclusiveScan(InputIt begin, InputIt end, OutputIt outBegin,
+    BinaryOperation op)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type ValueType;
+    return vtk::detail::smp::vtkSMPTools_Impl_Scan(begin, end, outBegin,
+      static_cast<const ValueType*>(nullptr), op);
+  }
+  template <typename InputIt, typename OutputIt>
+  static OutputIt InclusiveScan(InputIt begin, InputIt end, OutputIt outBegin)
+  {
+    typedef typename std::iterator_traits<InputIt>::value_type ValueType;
+    return vtkSMPTools::InclusiveScan(begin, end, outBegin,
+      std::plus<ValueType>());
+  }
+  //@}
+
+  //@{
+  /**
+   * Exclusive prefix scan of [begin, end) starting from init, written to
+   * outBegin, which may be begin. op must be associative, the default is the
+   * sum. Returns the end of the output.
+   *
+   * \code
+   * // Offsets of the points generated by each cell.
+   * std::vector<vtkIdType> offsets(numCells);
+   * vtkSMPTools::ExclusiveScan(counts.begin(), counts.end(), offsets.begin(),
+   *   vtkIdType(0));
+   * \endcode
+   */
+  template <typename InputIt, typename OutputIt, typename T,
+    typename BinaryOperation>
+  static OutputIt ExclusiveScan(InputIt begin, InputIt end, OutputIt outBegin,
+    T init, BinaryOperation op)
+  {
+    return vtk::detail::smp::vtkSMPTools_Impl_Scan(
+      begin, end, outBegin, &init, op);
+  }
+  template <typename InputIt, typename OutputIt, typename T>
+  static OutputIt ExclusiveScan(InputIt begin, InputIt end, OutputIt outBegin,
+    T init)
+  {
+    return vtkSMPTools::ExclusiveScan(begin, end, outBegin, init,
+      std::plus<T>());
+  }
+  //@}
+
+  /**
+   * Reorder [begin, end) so that the values for which pred returns true
+   * precede the others, preserving their relative order. It is a drop in
+   * replacement for std::stable_partition(), returns the first value of the
+   * second group. pred is called exactly once per value and the value type
+   * must be default constructible and copyable (a temporary copy of the
+   * range is made).
+   */
+  template <typename Iterator, typename Predicate>
+  static Iterator StablePartition(Iterator begin, Iterator end, Predicate pred)
+  {
+    return vtk::detail::smp::vtkSMPTools_Impl_StablePartition(
+      begin, end, pred);
+  }
+
   /**
    * A convenience method for sorting data. It is a drop in replacement for
-   * std::sort(). Under the hood different methods are used. For example,
-   * tbb::parallel_sort is used in TBB.
+   * std::sort(). Under the hood the data is sorted in blocks in parallel
+   * that are then merged in parallel.
    */
   template<typename RandomAccessIterator>
     static void Sort(RandomAccessIterator begin, RandomAccessIterator end)
@@ -238,8 +502,8 @@ public:
 
   /**
    * A convenience method for sorting data. It is a drop in replacement for
-   * std::sort(). Under the hood different methods are used. For example,
-   * tbb::parallel_sort is used in TBB. This version of Sort() takes a
+   * std::sort(). Under the hood the data is sorted in blocks in parallel
+   * that are then merged in parallel. This version of Sort() takes a
    * comparison class.
    */
   template<typename RandomAccessIterator, typename Compare>
@@ -0,0 +1,98 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStridedArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkStridedImplicitBackend
+ * @brief   implicit array backend reading a field of interleaved records
+ *
+ * The backend is a view of memory owned by somebody else, typically a
+ * simulation code laying out its data as an array of structures. Tuple i
+ * starts ByteOffset + i * ByteStride bytes after Base and its components
+ * are contiguous. For instance, the positions and temperatures of:
+ * \code
+ * struct Particle { double x, y, z, p; float T; };
+ * std::vector<Particle> particles;
+ * \endcode
+ * are exposed without copy by:
+ * \code
+ * vtkNew<vtkStridedArray<double> > positions;
+ * positions->SetNumberOfComponents(3);
+ * positions->SetNumberOfTuples(particles.size());
+ * positions->SetBackend(vtkStridedImplicitBackend<double>(
+ *   particles.data(), sizeof(Particle), offsetof(Particle, x)));
+ * vtkNew<vtkStridedArray<float> > temperatures;
+ * temperatures->SetNumberOfTuples(particles.size());
+ * temperatures->SetBackend(vtkStridedImplicitBackend<float>(
+ *   particles.data(), sizeof(Particle), offsetof(Particle, T)));
+ * \endcode
+ *
+ * vtkStridedArray<T> is the vtkImplicitArray using this backend. The values
+ * are read each time they are accessed, so changes made by the simulation
+ * are visible without updating the array. Call Modified() on it after such
+ * changes: the pipeline notices them, and the copy of the values returned
+ * by GetVoidPointer(), if any, is refreshed in place so that the pointers
+ * already handed out see the new values. The values need not be aligned.
+ *
+ * @warning
+ * The memory is not copied nor owned: it must remain valid as long as the
+ * array is used.
+ *
+ * @sa
+ * vtkImplicitArray
+*/
+
+#ifndef vtkStridedArray_h
+#define vtkStridedArray_h
+
+#include "vtkImplicitArray.h"
+
+#include <cstring> // For memcpy
+
+template <typename ValueT>
+struct vtkStridedImplicitBackend
+{
+  typedef ValueT ValueType;
+
+  vtkStridedImplicitBackend()
+    : Base(nullptr), ByteStride(sizeof(ValueType)), ByteOffset(0)
+  {
+  }
+  vtkStridedImplicitBackend(const void *base, vtkIdType byteStride,
+                            vtkIdType byteOffset = 0)
+    : Base(static_cast<const unsigned char*>(base)),
+      ByteStride(byteStride),
+      ByteOffset(byteOffset)
+  {
+  }
+
+  ValueType operator()(vtkIdType tupleIdx, int compIdx) const
+  {
+    // memcpy supports unaligned values and compiles to a plain load.
+    ValueType value;
+    memcpy(&value, this->Base + this->ByteOffset + tupleIdx * this->ByteStride +
+           compIdx * static_cast<vtkIdType>(sizeof(ValueType)),
+           sizeof(ValueType));
+    return value;
+  }
+
+  const unsigned char *Base;
+  vtkIdType ByteStride;
+  vtkIdType ByteOffset;
+};
+
+template <typename ValueT>
+using vtkStridedArray = vtkImplicitArray<vtkStridedImplicitBackend<ValueT> >;
+
+#endif
+// VTK-HeaderTest-Exclude: vtkStridedArray.h
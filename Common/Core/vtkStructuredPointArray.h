@@ -0,0 +1,130 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkStructuredPointArray.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+/**
+ * @class   vtkStructuredPointBackend
+ * @brief   implicit array backend returning the points of a structured grid
+ *
+ * The points are ordered as in vtkImageData and vtkRectilinearGrid: the
+ * first axis varies fastest. The coordinates along each axis are either
+ * regularly spaced (SetUniformAxis()) or copied from an array
+ * (SetAxis()), so that only the sum of the dimensions is stored.
+ * vtkStructuredPointArray<T> is the 3-component vtkImplicitArray using this
+ * backend.
+ *
+ * @sa
+ * vtkImplicitArray vtkImageDataToPointSet vtkRectilinearGridToPointSet
+*/
+
+#ifndef vtkStructuredPointArray_h
+#define vtkStructuredPointArray_h
+
+#include "vtkDataArray.h"
+#include "vtkImplicitArray.h"
+
+#include <vector> // For the coordinates
+
+template <typename ValueT>
+struct vtkStructuredPointBackend
+{
+  typedef ValueT ValueType;
+
+  vtkStructuredPointBackend()
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      this->SetUniformAxis(axis, 0, 0, 0.0, 1.0);
+    }
+  }
+
+  /**
+   * Set the coordinates along the axis to origin + spacing * i, for i in
+   * [first, last] (e.g. the extent of a vtkImageData along the axis).
+   */
+  void SetUniformAxis(int axis, int first, int last, double origin,
+                      double spacing)
+  {
+    std::vector<ValueType> &coords = this->Coordinates[axis];
+    coords.resize(last >= first ? last - first + 1 : 1);
+    for (vtkIdType i = 0; i < static_cast<vtkIdType>(coords.size()); ++i)
+    {
+      coords[i] = static_cast<ValueType>(origin + spacing * (first + i));
+    }
+    this->UpdateDimensions();
+  }
+
+  /**
+   * Copy the coordinates of the points along the axis from the first
+   * component of the array.
+   */
+  void SetAxis(int axis, vtkDataArray *values)
+  {
+    std::vector<ValueType> &coords = this->Coordinates[axis];
+    vtkIdType dim = values ? values->GetNumberOfTuples() : 0;
+    coords.assign(1, ValueType());
+    if (dim > 0)
+    {
+      coords.resize(dim);
+      for (vtkIdType i = 0; i < dim; ++i)
+      {
+        coords[i] = static_cast<ValueType>(values->GetComponent(i, 0));
+      }
+    }
+    this->UpdateDimensions();
+  }
+
+  /**
+   * Return the number of points of the grid.
+   */
+  vtkIdType GetNumberOfPoints() const
+  {
+    return this->SliceSize * this->Dimensions[2];
+  }
+
+  ValueType operator()(vtkIdType tupleIdx, int compIdx) const
+  {
+    switch (compIdx)
+    {
+      case 0:
+        return this->Coordinates[0][tupleIdx % this->Dimensions[0]];
+      case 1:
+        return this->Coordinates[1][
+          (tupleIdx / this->Dimensions[0]) % this->Dimensions[1]];
+      default:
+        return this->Coordinates[2][tupleIdx / this->SliceSize];
+    }
+  }
+
+  std::vector<ValueType> Coordinates[3];
+  vtkIdType Dimensions[3];
+  vtkIdType SliceSize;
+
+private:
+  void UpdateDimensions()
+  {
+    for (int axis = 0; axis < 3; ++axis)
+    {
+      this->Dimensions[axis] =
+        static_cast<vtkIdType>(this->Coordinates[axis].size());
+    }
+    this->SliceSize = this->Dimensions[0] * this->Dimensions[1];
+  }
+};
+
+template <typename ValueT>
+using vtkStructuredPointArray =
+  vtkImplicitArray<vtkStructuredPointBackend<ValueT> >;
+
+#endif
+// VTK-HeaderTest-Exclude: vtkStructuredPointArray.h
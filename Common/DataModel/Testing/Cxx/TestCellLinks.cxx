@@ -0,0 +1,166 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestCellLinks.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#include "vtkCellArray.h"
+#include "vtkCellLinks.h"
+#include "vtkIdList.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+// Compare the links with the ones computed by a serial traversal of the
+// cells, in which the cell ids of each point are naturally sorted. The links
+// of the dataset are checked when links is nullptr.
+bool CheckLinks(vtkDataSet *ds, vtkCellLinks *links, const char *name)
+{
+  vtkIdType numPts = ds->GetNumberOfPoints();
+  std::vector<std::vector<vtkIdType> > expected(numPts);
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType cellId = 0; cellId < ds->GetNumberOfCells(); ++cellId)
+  {
+    ds->GetCellPoints(cellId, ptIds);
+    for (vtkIdType i = 0; i < ptIds->GetNumberOfIds(); ++i)
+    {
+      expected[ptIds->GetId(i)].push_back(cellId);
+    }
+  }
+
+  vtkNew<vtkIdList> cellIds;
+  for (vtkIdType ptId = 0; ptId < numPts; ++ptId)
+  {
+    vtkIdType ncells;
+    vtkIdType *cells;
+    if (links)
+    {
+      ncells = links->GetNcells(ptId);
+      cells = links->GetCells(ptId);
+    }
+    else
+    {
+      ds->GetPointCells(ptId, cellIds);
+      ncells = cellIds->GetNumberOfIds();
+      cells = cellIds->GetPointer(0);
+    }
+    if (ncells != static_cast<vtkIdType>(expected[ptId].size()) ||
+        (ncells > 0 &&
+         !std::equal(cells, cells + ncells, expected[ptId].begin())))
+    {
+      cerr << name << ": wrong links for point " << ptId << endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+int TestCellLinks(int, char *[])
+{
+  const vtkIdType dim = 20;
+
+  // Polydata with interleaved cell types, so that the cell ids differ from
+  // the positions in the cell arrays.
+  vtkNew<vtkPoints> points;
+  for (vtkIdType j = 0; j < dim; ++j)
+  {
+    for (vtkIdType i = 0; i < dim; ++i)
+    {
+      points->InsertNextPoint(i, j, 0.0);
+    }
+  }
+  vtkNew<vtkPolyData> poly;
+  poly->SetPoints(points);
+  poly->Allocate(2 * dim * dim);
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points);
+  grid->Allocate(2 * dim * dim);
+  for (vtkIdType j = 0; j < dim - 1; ++j)
+  {
+    for (vtkIdType i = 0; i < dim - 1; ++i)
+    {
+      vtkIdType p = i + j * dim;
+      vtkIdType tri[3] = { p, p + 1, p + dim + 1 };
+      vtkIdType quad[4] = { p, p + 1, p + dim + 1, p + dim };
+      poly->InsertNextCell(VTK_TRIANGLE, 3, tri);
+      poly->InsertNextCell(VTK_VERTEX, 1, &p);
+      grid->InsertNextCell(VTK_QUAD, 4, quad);
+      grid->InsertNextCell(VTK_VERTEX, 1, &p);
+    }
+  }
+
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(dim, dim, 3);
+
+  vtkNew<vtkCellLinks> links;
+  links->BuildLinks(poly);
+  if (!CheckLinks(poly, links, "vtkPolyData") || !links->IsStatic())
+  {
+    return EXIT_FAILURE;
+  }
+  grid->BuildLinks();
+  if (!CheckLinks(grid, grid->GetCellLinks(), "vtkUnstructuredGrid"))
+  {
+    return EXIT_FAILURE;
+  }
+  links->BuildLinks(image);
+  if (!CheckLinks(image, links, "vtkImageData"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // The copy owns its lists.
+  vtkNew<vtkCellLinks> copy;
+  copy->DeepCopy(links);
+  links->Initialize();
+  if (!CheckLinks(image, copy, "DeepCopy"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Incremental editing after a parallel build, on the links owned by the
+  // dataset and on standalone links.
+  poly->BuildLinks();
+  double x[3] = { -1.0, -1.0, 0.0 };
+  vtkIdType newPt = poly->InsertNextLinkedPoint(x, 2);
+  vtkIdType tri[3] = { 0, 1, newPt };
+  poly->InsertNextLinkedCell(VTK_TRIANGLE, 3, tri);
+  vtkIdType line[2] = { newPt, dim };
+  poly->InsertNextLinkedCell(VTK_LINE, 2, line);
+  if (!CheckLinks(poly, nullptr, "InsertNextLinkedCell"))
+  {
+    return EXIT_FAILURE;
+  }
+  links->BuildLinks(grid);
+  newPt = links->InsertNextPoint(1);
+  links->InsertNextCellReference(newPt, 7);
+  links->ResizeCellList(0, 1);
+  links->AddCellReference(7, 0);
+  if (links->IsStatic() || links->GetNcells(0) != 3 ||
+      links->GetCells(0)[2] != 7 || links->GetCells(1)[0] != 0 ||
+      links->GetNcells(newPt) != 1 || links->GetCells(newPt)[0] != 7)
+  {
+    cerr << "Wrong links after incremental editing" << endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,204 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestDataSet32BitStorage.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that unstructured grids and poly data whose cells are stored as
+// 32-bit integers answer the vtkIdType API like the original ones.
+
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkStaticCellLinks.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+
+bool SameIds(vtkIdList* a, vtkIdList* b)
+{
+  if (a->GetNumberOfIds() != b->GetNumberOfIds())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfIds(); ++i)
+  {
+    if (a->GetId(i) != b->GetId(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compare the cells and the links of two datasets.
+bool SameCells(vtkDataSet* expected, vtkDataSet* actual)
+{
+  vtkNew<vtkIdList> a, b;
+  vtkNew<vtkGenericCell> cell;
+  double expectedBounds[6], actualBounds[6];
+  if (expected->GetNumberOfCells() != actual->GetNumberOfCells())
+  {
+    return false;
+  }
+  for (vtkIdType cellId = 0; cellId < expected->GetNumberOfCells(); ++cellId)
+  {
+    expected->GetCellPoints(cellId, a);
+    actual->GetCellPoints(cellId, b);
+    if (!SameIds(a, b))
+    {
+      return false;
+    }
+    actual->GetCell(cellId, cell);
+    if (cell->GetCellType() != expected->GetCellType(cellId) ||
+        !SameIds(a, cell->GetPointIds()) ||
+        !SameIds(a, actual->GetCell(cellId)->GetPointIds()))
+    {
+      return false;
+    }
+    expected->GetCellBounds(cellId, expectedBounds);
+    actual->GetCellBounds(cellId, actualBounds);
+    for (int i = 0; i < 6; ++i)
+    {
+      if (expectedBounds[i] != actualBounds[i])
+      {
+        return false;
+      }
+    }
+  }
+
+  vtkNew<vtkStaticCellLinks> expectedLinks, actualLinks;
+  expectedLinks->BuildLinks(expected);
+  actualLinks->BuildLinks(actual);
+  for (vtkIdType ptId = 0; ptId < expected->GetNumberOfPoints(); ++ptId)
+  {
+    expected->GetPointCells(ptId, a);
+    actual->GetPointCells(ptId, b);
+    if (!SameIds(a, b))
+    {
+      return false;
+    }
+    expectedLinks->GetCells(ptId, a);
+    actualLinks->GetCells(ptId, b);
+    if (!SameIds(a, b))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+int TestDataSet32BitStorage(int, char*[])
+{
+  vtkNew<vtkPoints> points;
+  for (vtkIdType i = 0; i < 27; ++i)
+  {
+    points->InsertNextPoint(i % 3, (i / 3) % 3, i / 9);
+  }
+
+  // A hexahedron, a tetrahedron, a wedge and a vertex.
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points);
+  grid->Allocate(4);
+  const vtkIdType hexahedron[8] = { 0, 1, 4, 3, 9, 10, 13, 12 };
+  const vtkIdType tetra[4] = { 13, 14, 16, 22 };
+  const vtkIdType wedge[6] = { 18, 19, 21, 24, 25, 26 };
+  const vtkIdType vertex[1] = { 8 };
+  grid->InsertNextCell(VTK_HEXAHEDRON, 8, hexahedron);
+  grid->InsertNextCell(VTK_TETRA, 4, tetra);
+  grid->InsertNextCell(VTK_WEDGE, 6, wedge);
+  grid->InsertNextCell(VTK_VERTEX, 1, vertex);
+
+  vtkNew<vtkUnstructuredGrid> grid32;
+  grid32->DeepCopy(grid);
+  if (!grid32->ConvertTo32BitStorage() ||
+      !grid32->GetCells()->IsStorage32Bit() ||
+      !SameCells(grid, grid32))
+  {
+    std::cerr << "Wrong cells for a 32-bit unstructured grid" << std::endl;
+    return EXIT_FAILURE;
+  }
+  grid32->ConvertTo64BitStorage();
+  if (grid32->GetCells()->IsStorage32Bit() || !SameCells(grid, grid32))
+  {
+    std::cerr << "Wrong cells after converting back" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // A vertex, a polyline, a triangle, a quad and a triangle strip.
+  vtkNew<vtkPolyData> polyData;
+  polyData->SetPoints(points);
+  polyData->Allocate(5);
+  const vtkIdType polyLine[3] = { 0, 1, 2 };
+  const vtkIdType triangle[3] = { 3, 4, 7 };
+  const vtkIdType quad[4] = { 9, 10, 13, 12 };
+  const vtkIdType strip[5] = { 18, 19, 21, 22, 24 };
+  polyData->InsertNextCell(VTK_VERTEX, 1, vertex);
+  polyData->InsertNextCell(VTK_POLY_LINE, 3, polyLine);
+  polyData->InsertNextCell(VTK_TRIANGLE, 3, triangle);
+  polyData->InsertNextCell(VTK_QUAD, 4, quad);
+  polyData->InsertNextCell(VTK_TRIANGLE_STRIP, 5, strip);
+
+  vtkNew<vtkPolyData> polyData32;
+  polyData32->DeepCopy(polyData);
+  if (!polyData32->ConvertTo32BitStorage() ||
+      !polyData32->GetPolys()->IsStorage32Bit() ||
+      !polyData32->GetStrips()->IsStorage32Bit() ||
+      !SameCells(polyData, polyData32))
+  {
+    std::cerr << "Wrong cells for a 32-bit poly data" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Edits reach the 32-bit cells, also after the pointer to the ids of a
+  // cell has been handed out.
+  vtkIdType npts, *pts;
+  polyData32->GetCellPoints(2, npts, pts);
+  polyData->BuildLinks();
+  polyData32->BuildLinks();
+  polyData->ReplaceCellPoint(2, 7, 5);
+  polyData32->ReplaceCellPoint(2, 7, 5);
+  polyData->ReverseCell(3);
+  polyData32->ReverseCell(3);
+  polyData->DeleteCells();
+  polyData32->DeleteCells();
+  if (!polyData32->GetPolys()->IsStorage32Bit() ||
+      !SameCells(polyData, polyData32))
+  {
+    std::cerr << "Edits of a 32-bit poly data were lost" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+#ifdef VTK_USE_64BIT_IDS
+  // Point ids beyond 32 bits keep the vtkIdType storage.
+  const vtkIdType farVertex[1] = { VTK_ID_MAX };
+  vtkNew<vtkCellArray> verts;
+  verts->InsertNextCell(1, farVertex);
+  vtkNew<vtkPolyData> farPolyData;
+  farPolyData->SetVerts(verts);
+  farPolyData->SetPolys(polyData->GetPolys());
+  if (farPolyData->ConvertTo32BitStorage() ||
+      farPolyData->GetPolys()->IsStorage32Bit())
+  {
+    std::cerr << "Converted ids that do not fit in 32 bits" << std::endl;
+    return EXIT_FAILURE;
+  }
+#endif
+
+  return EXIT_SUCCESS;
+}
@@ -15,6 +15,7 @@
 #include "vtkStaticCellLinks.h"
 #include "vtkStaticCellLinksTemplate.h"
 #include "vtkSmartPointer.h"
+#include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkPolyData.h"
@@ -70,6 +71,23 @@ int TestStaticCellLinks( int, char *[] )
     return EXIT_FAILURE;
   }
 
+  // Small datasets use 32-bit links when vtkIdType is larger
+  vtkSmartPointer<vtkIdList> cellIds =
+    vtkSmartPointer<vtkIdList>::New();
+  imlinks->GetCells(13, cellIds);
+  if ( imlinks->GetLargeIds() != (sizeof(vtkIdType) == sizeof(int)) ||
+       cellIds->GetNumberOfIds() != ncells )
+  {
+    return EXIT_FAILURE;
+  }
+  for (int i=0; i<ncells; ++i)
+  {
+    if ( cellIds->GetId(i) != imcells[i] )
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
   ncells = imlinks->GetNumberOfCells(26);
   imcells = imlinks->GetCells(26);
   cout << "   Upper Right corner (ncells, cells): " << ncells << " (";
@@ -0,0 +1,127 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestUnstructuredGridCellLocations.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkUnstructuredGrid::SetCells() honors the cell locations,
+// also when they do not follow the order of the cells.
+
+#include "vtkCellArray.h"
+#include "vtkCellType.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+
+bool CheckCell(vtkUnstructuredGrid* grid, vtkIdType cellId, int type,
+               vtkIdType npts, const vtkIdType* pts)
+{
+  vtkNew<vtkIdList> ids;
+  grid->GetCellPoints(cellId, ids);
+  if (grid->GetCellType(cellId) != type || ids->GetNumberOfIds() != npts)
+  {
+    return false;
+  }
+  // The locations match the legacy array of the cells.
+  const vtkIdType* legacy = grid->GetCells()->GetPointer() +
+    grid->GetCellLocationsArray()->GetValue(cellId);
+  if (legacy[0] != npts)
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < npts; ++i)
+  {
+    if (ids->GetId(i) != pts[i] || legacy[i + 1] != pts[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+int TestUnstructuredGridCellLocations(int, char*[])
+{
+  vtkNew<vtkPoints> points;
+  points->SetNumberOfPoints(9);
+  for (vtkIdType i = 0; i < 9; ++i)
+  {
+    points->SetPoint(i, i, i % 3, 0.0);
+  }
+
+  // A triangle, a quad and a line.
+  const vtkIdType triangle[3] = { 0, 1, 2 };
+  const vtkIdType quad[4] = { 3, 4, 5, 6 };
+  const vtkIdType line[2] = { 7, 8 };
+  vtkNew<vtkCellArray> cells;
+  cells->InsertNextCell(3, triangle);
+  cells->InsertNextCell(4, quad);
+  cells->InsertNextCell(2, line);
+
+  // Locations in order: the cell array is used as is.
+  vtkNew<vtkUnsignedCharArray> types;
+  types->InsertNextValue(VTK_TRIANGLE);
+  types->InsertNextValue(VTK_QUAD);
+  types->InsertNextValue(VTK_LINE);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->InsertNextValue(0);
+  locations->InsertNextValue(4);
+  locations->InsertNextValue(9);
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points);
+  grid->SetCells(types, locations, cells);
+  if (grid->GetCells() != cells.GetPointer() ||
+      grid->GetCellLocationsArray() != locations.GetPointer() ||
+      !CheckCell(grid, 0, VTK_TRIANGLE, 3, triangle) ||
+      !CheckCell(grid, 2, VTK_LINE, 2, line))
+  {
+    std::cerr << "Wrong cells for ordered locations" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The line, the triangle, and the quad twice.
+  vtkNew<vtkUnsignedCharArray> otherTypes;
+  otherTypes->InsertNextValue(VTK_LINE);
+  otherTypes->InsertNextValue(VTK_TRIANGLE);
+  otherTypes->InsertNextValue(VTK_QUAD);
+  otherTypes->InsertNextValue(VTK_QUAD);
+  vtkNew<vtkIdTypeArray> otherLocations;
+  otherLocations->InsertNextValue(9);
+  otherLocations->InsertNextValue(0);
+  otherLocations->InsertNextValue(4);
+  otherLocations->InsertNextValue(4);
+  vtkNew<vtkUnstructuredGrid> other;
+  other->SetPoints(points);
+  other->SetCells(otherTypes, otherLocations, cells);
+  if (other->GetNumberOfCells() != 4 ||
+      !CheckCell(other, 0, VTK_LINE, 2, line) ||
+      !CheckCell(other, 1, VTK_TRIANGLE, 3, triangle) ||
+      !CheckCell(other, 2, VTK_QUAD, 4, quad) ||
+      !CheckCell(other, 3, VTK_QUAD, 4, quad))
+  {
+    std::cerr << "Wrong cells for unordered locations" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (cells->GetNumberOfCells() != 3)
+  {
+    std::cerr << "The cells given were modified" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
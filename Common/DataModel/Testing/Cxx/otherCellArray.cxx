@@ -22,9 +22,12 @@
 #include "vtkCellArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
+#include "vtkNew.h"
 #include "vtkQuad.h"
+#include "vtkSMPTools.h"
 
 #include <sstream>
+#include <vector>
 
 int TestCellArray(ostream& strm)
 {
@@ -81,8 +84,344 @@ int TestCellArray(ostream& strm)
   return 0;
 }
 
+namespace
+{
+
+// Cell k of the test arrays is made of the points k, k+1, ... and has
+// 1 + k%4 points.
+vtkIdType TestCellSize(vtkIdType k)
+{
+  return 1 + k % 4;
+}
+
+bool CheckTestCell(vtkIdType k, vtkIdType npts, const vtkIdType* pts)
+{
+  if (npts != TestCellSize(k))
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < npts; ++i)
+  {
+    if (pts[i] != k + i)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Each call appends its range of test cells with InsertNextCells().
+struct InsertCellsFunctor
+{
+  vtkCellArray* Cells;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::vector<vtkIdType> offsets(1, 0);
+    std::vector<vtkIdType> connectivity;
+    for (vtkIdType k = begin; k < end; ++k)
+    {
+      for (vtkIdType i = 0; i < TestCellSize(k); ++i)
+      {
+        connectivity.push_back(k + i);
+      }
+      offsets.push_back(static_cast<vtkIdType>(connectivity.size()));
+    }
+    this->Cells->InsertNextCells(end - begin, offsets.data(),
+      connectivity.data());
+  }
+};
+
+}
+
+int TestCellArrayOffsets(ostream& strm)
+{
+  strm << "Test CellArray offsets Start" << endl;
+  const vtkIdType numCells = 1000;
+
+  // Random access, legacy locations and traversal.
+  vtkNew<vtkCellArray> ca;
+  for (vtkIdType k = 0; k < numCells; ++k)
+  {
+    std::vector<vtkIdType> pts;
+    for (vtkIdType i = 0; i < TestCellSize(k); ++i)
+    {
+      pts.push_back(k + i);
+    }
+    if (ca->InsertNextCell(TestCellSize(k), pts.data()) != k)
+    {
+      strm << "Wrong id returned by InsertNextCell" << endl;
+      return 1;
+    }
+  }
+  vtkIdType npts, *pts;
+  for (vtkIdType k = numCells - 1; k >= 0; --k)
+  {
+    ca->GetCellAtId(k, npts, pts);
+    if (!CheckTestCell(k, npts, pts) || ca->GetCellSize(k) != npts)
+    {
+      strm << "Wrong cell " << k << " returned by GetCellAtId" << endl;
+      return 1;
+    }
+  }
+  vtkIdType k = 0;
+  for (ca->InitTraversal(); ca->GetNextCell(npts, pts); ++k)
+  {
+    vtkIdType *locPts, locNpts;
+    ca->GetCell(ca->GetTraversalLocation(npts), locNpts, locPts);
+    if (!CheckTestCell(k, npts, pts) || locPts != pts || locNpts != npts)
+    {
+      strm << "Wrong cell " << k << " traversed" << endl;
+      return 1;
+    }
+  }
+  if (k != numCells || ca->GetMaxCellSize() != 4)
+  {
+    strm << "Wrong number of cells traversed" << endl;
+    return 1;
+  }
+
+  // The legacy array holds the cells once requested: writes through it are
+  // seen by the other methods, and reads do not invalidate it.
+  vtkIdType* legacy = ca->GetPointer();
+  if (legacy[0] != 1 || legacy[1] != 0 || legacy[2] != 2 || legacy[3] != 1)
+  {
+    strm << "Wrong legacy array" << endl;
+    return 1;
+  }
+  legacy[1] = 10;
+  ca->GetCellAtId(0, npts, pts);
+  if (npts != 1 || pts != legacy + 1 || pts[0] != 10 ||
+      ca->GetNumberOfCells() != numCells || ca->GetPointer() != legacy ||
+      ca->GetData()->GetNumberOfValues() != ca->GetNumberOfConnectivityEntries())
+  {
+    strm << "Legacy array not used" << endl;
+    return 1;
+  }
+  ca->GetCellAtId(numCells - 1, npts, pts);
+  vtkIdType *locPts, locNpts;
+  ca->GetCell(ca->GetLocationFromCellId(7), locNpts, locPts);
+  if (!CheckTestCell(numCells - 1, npts, pts) || ca->GetMaxCellSize() != 4 ||
+      !CheckTestCell(7, locNpts, locPts))
+  {
+    strm << "Wrong indexed legacy cell" << endl;
+    return 1;
+  }
+
+  // Cells inserted and modified in the legacy array.
+  const vtkIdType numEntries = ca->GetNumberOfConnectivityEntries();
+  vtkIdType extra[2] = { 5, 6 };
+  if (ca->InsertNextCell(2, extra) != numCells ||
+      ca->GetNumberOfConnectivityEntries() != numEntries + 3 ||
+      ca->GetPointer()[numEntries + 2] != 6)
+  {
+    strm << "Legacy cell not inserted" << endl;
+    return 1;
+  }
+  ca->ReverseCellAtId(numCells);
+  ca->GetCellAtId(numCells, npts, pts);
+  if (npts != 2 || pts[0] != 6 || pts[1] != 5)
+  {
+    strm << "Legacy cell not reversed" << endl;
+    return 1;
+  }
+
+  // Cells written through WritePointer() are indexed again, even when the
+  // size of the cells changes.
+  vtkIdType* written = ca->WritePointer(numCells + 1, numEntries + 2);
+  written[numEntries] = 1;
+  written[numEntries + 1] = 7;
+  if (ca->GetNumberOfCells() != numCells + 1 ||
+      ca->GetCellSize(numCells) != 1 ||
+      ca->GetNumberOfConnectivityEntries() != numEntries + 2)
+  {
+    strm << "Legacy cell not indexed" << endl;
+    return 1;
+  }
+
+  // The legacy array given back to SetCells() is indexed again.
+  ca->GetData()->SetNumberOfValues(numEntries);
+  ca->SetCells(numCells, ca->GetData());
+  if (ca->GetNumberOfCells() != numCells ||
+      ca->GetNumberOfConnectivityEntries() != numEntries)
+  {
+    strm << "Legacy cell not removed by SetCells" << endl;
+    return 1;
+  }
+
+  // Legacy writers may also announce the cells before filling GetData().
+  ca->SetNumberOfCells(numCells - 1);
+  ca->GetData()->SetNumberOfValues(numEntries - 5);
+  if (ca->GetNumberOfCells() != numCells - 1 ||
+      ca->GetNumberOfConnectivityEntries() != numEntries - 5)
+  {
+    strm << "Legacy cell not removed" << endl;
+    return 1;
+  }
+  written = ca->WritePointer(numCells, numEntries);
+  for (vtkIdType i = 0; i < 4; ++i)
+  {
+    written[numEntries - 4 + i] = numCells - 1 + i;
+  }
+  written[numEntries - 5] = 4;
+  ca->GetCellAtId(numCells - 1, npts, pts);
+  if (ca->GetNumberOfCells() != numCells ||
+      !CheckTestCell(numCells - 1, npts, pts))
+  {
+    strm << "Legacy cell not restored" << endl;
+    return 1;
+  }
+
+  // Back to offsets and connectivity.
+  if (ca->GetOffsetsArray()->GetValue(numCells) !=
+        ca->GetNumberOfConnectivityIds() ||
+      ca->GetConnectivityArray()->GetValue(0) != 10)
+  {
+    strm << "Wrong conversion of the legacy array" << endl;
+    return 1;
+  }
+  ca->ReplaceCellAtId(0, 1, &k);
+  vtkNew<vtkIdTypeArray> legacyCopy;
+  ca->ExportLegacyFormat(legacyCopy);
+  legacyCopy->SetValue(1, 0);
+  vtkNew<vtkCellArray> imported;
+  imported->SetCells(numCells, legacyCopy);
+  if (imported->GetNumberOfCells() != numCells ||
+      imported->GetNumberOfConnectivityIds() != ca->GetNumberOfConnectivityIds())
+  {
+    strm << "Wrong legacy import" << endl;
+    return 1;
+  }
+  for (k = 0; k < numCells; ++k)
+  {
+    imported->GetCellAtId(k, npts, pts);
+    if (!CheckTestCell(k, npts, pts))
+    {
+      strm << "Wrong cell " << k << " imported" << endl;
+      return 1;
+    }
+  }
+
+  // Zero-copy import of offsets and connectivity.
+  vtkIdType offsets[3] = { 0, 2, 5 };
+  vtkIdType connectivity[5] = { 0, 1, 1, 2, 3 };
+  vtkNew<vtkIdTypeArray> offsetsArray;
+  offsetsArray->SetArray(offsets, 3, 1);
+  vtkNew<vtkIdTypeArray> connectivityArray;
+  connectivityArray->SetArray(connectivity, 5, 1);
+  vtkNew<vtkCellArray> external;
+  if (!external->SetData(offsetsArray, connectivityArray) ||
+      external->GetNumberOfCells() != 2)
+  {
+    strm << "SetData failed" << endl;
+    return 1;
+  }
+  external->GetCellAtId(1, npts, pts);
+  if (npts != 3 || pts != connectivity + 2)
+  {
+    strm << "SetData copied the cells" << endl;
+    return 1;
+  }
+  connectivityArray->SetNumberOfValues(4);
+  vtkObject::GlobalWarningDisplayOff();
+  bool accepted = external->SetData(offsetsArray, connectivityArray);
+  vtkObject::GlobalWarningDisplayOn();
+  if (accepted)
+  {
+    strm << "SetData accepted inconsistent arrays" << endl;
+    return 1;
+  }
+
+  // 32-bit storage.
+  vtkNew<vtkCellArray> compact;
+  compact->DeepCopy(imported);
+  if (!compact->CanConvertTo32BitStorage() ||
+      !compact->ConvertTo32BitStorage() || !compact->IsStorage32Bit() ||
+      compact->GetNumberOfCells() != numCells ||
+      compact->GetNumberOfConnectivityIds() != ca->GetNumberOfConnectivityIds())
+  {
+    strm << "Cannot convert to 32-bit storage" << endl;
+    return 1;
+  }
+  vtkNew<vtkIdList> cellIds;
+  for (k = 0; k < numCells; ++k)
+  {
+    compact->GetCellAtId(k, cellIds);
+    if (!CheckTestCell(k, cellIds->GetNumberOfIds(), cellIds->GetPointer(0)) ||
+        compact->GetCellSize(k) != cellIds->GetNumberOfIds())
+    {
+      strm << "Wrong 32-bit cell " << k << endl;
+      return 1;
+    }
+  }
+  // The vtkIdType copy used by the pointer accessors follows the changes.
+  compact->GetCellAtId(7, npts, pts);
+  compact->ReverseCellAtId(7);
+  compact->GetCellAtId(7, cellIds);
+  if (npts != 4 || pts[0] != 10 || cellIds->GetId(0) != 10)
+  {
+    strm << "32-bit cell not reversed" << endl;
+    return 1;
+  }
+  compact->ReverseCellAtId(7);
+  vtkIdType triangle[3] = { 1, 2, 3 };
+  compact->InsertNextCell(3, triangle);
+  compact->GetCellAtId(numCells, npts, pts);
+  if (!compact->IsStorage32Bit() || npts != 3 || pts[2] != 3)
+  {
+    strm << "Wrong 32-bit cell inserted" << endl;
+    return 1;
+  }
+  vtkIdType large[2] = { 1, VTK_ID_MAX };
+  compact->InsertNextCell(2, large);
+  compact->GetCellAtId(numCells + 1, npts, pts);
+#ifdef VTK_USE_64BIT_IDS
+  if (compact->IsStorage32Bit())
+  {
+    strm << "Id larger than 32 bits stored in 32-bit storage" << endl;
+    return 1;
+  }
+#endif
+  if (npts != 2 || pts[1] != VTK_ID_MAX ||
+      compact->GetNumberOfCells() != numCells + 2)
+  {
+    strm << "Wrong cell inserted after 32-bit storage" << endl;
+    return 1;
+  }
+
+  // Concurrent appends of batches of cells.
+  vtkNew<vtkCellArray> appended;
+  appended->AllocateExact(numCells / 2, numCells);
+  InsertCellsFunctor functor;
+  functor.Cells = appended;
+  vtkSMPTools::For(0, numCells, 16, functor);
+  if (appended->GetNumberOfCells() != numCells ||
+      appended->GetNumberOfConnectivityIds() != ca->GetNumberOfConnectivityIds())
+  {
+    strm << "Wrong number of appended cells" << endl;
+    return 1;
+  }
+  std::vector<bool> found(numCells, false);
+  for (k = 0; k < numCells; ++k)
+  {
+    appended->GetCellAtId(k, npts, pts);
+    vtkIdType cellId = pts[0];
+    if (cellId < 0 || cellId >= numCells || found[cellId] ||
+        !CheckTestCell(cellId, npts, pts))
+    {
+      strm << "Wrong appended cell " << k << endl;
+      return 1;
+    }
+    found[cellId] = true;
+  }
+
+  strm << "Test CellArray offsets Complete" << endl;
+  return 0;
+}
+
 int otherCellArray(int,char *[])
 {
   std::ostringstream vtkmsg_with_warning_C4701;
-  return TestCellArray(vtkmsg_with_warning_C4701);
+  return TestCellArray(vtkmsg_with_warning_C4701) ||
+    TestCellArrayOffsets(std::cerr);
 }
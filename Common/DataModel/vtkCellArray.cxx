@@ -14,46 +14,383 @@
 =========================================================================*/
 #include "vtkCellArray.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <thread>
 
 vtkStandardNewMacro(vtkCellArray);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Write the legacy (npts, ids...) representation of the cells. The legacy
+// location of cell i is offsets[i] + i.
+template <typename T>
+struct vtkExportLegacyCells
+{
+  const T* Offsets;
+  const T* Connectivity;
+  vtkIdType* Legacy;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      const vtkIdType first = this->Offsets[cellId];
+      const vtkIdType last = this->Offsets[cellId + 1];
+      vtkIdType* legacy = this->Legacy + first + cellId;
+      *legacy++ = last - first;
+      std::copy(this->Connectivity + first, this->Connectivity + last, legacy);
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy the point ids of the indexed legacy representation to offsets and
+// connectivity arrays. The legacy cells are contiguous, so the offset of
+// cell i is its location minus i.
+template <typename T>
+struct vtkImportLegacyCells
+{
+  const vtkIdType* Locations;
+  const vtkIdType* Legacy;
+  T* Offsets;
+  T* Connectivity;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      const vtkIdType loc = this->Locations[cellId];
+      const vtkIdType npts = this->Legacy[loc];
+      this->Offsets[cellId] = static_cast<T>(loc - cellId);
+      std::transform(this->Legacy + loc + 1, this->Legacy + loc + 1 + npts,
+        this->Connectivity + loc - cellId,
+        [](vtkIdType id) { return static_cast<T>(id); });
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+// Copy values between arrays of different types, in parallel.
+template <typename TIn, typename TOut>
+struct vtkCopyValues
+{
+  const TIn* In;
+  TOut* Out;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    std::transform(this->In + begin, this->In + end, this->Out + begin,
+      [](TIn value) { return static_cast<TOut>(value); });
+  }
+};
+
+template <typename TIn, typename TOut>
+void vtkCopyAllValues(const TIn* in, TOut* out, vtkIdType numValues)
+{
+  vtkCopyValues<TIn, TOut> copier;
+  copier.In = in;
+  copier.Out = out;
+  vtkSMPTools::For(0, numValues, copier);
+}
+
+//----------------------------------------------------------------------------
+// Check that values fit in 32-bit integers.
+struct vtkCheckValuesFit
+{
+  const vtkIdType* Values;
+  vtkSMPThreadLocal<unsigned char> Overflow;
+
+  vtkCheckValuesFit()
+    : Overflow(0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    unsigned char& overflow = this->Overflow.Local();
+    for (vtkIdType i = begin; i < end && !overflow; ++i)
+    {
+      if (this->Values[i] < VTK_TYPE_INT32_MIN ||
+          this->Values[i] > VTK_TYPE_INT32_MAX)
+      {
+        overflow = 1;
+      }
+    }
+  }
+
+  bool Fits()
+  {
+    for (unsigned char overflow : this->Overflow)
+    {
+      if (overflow)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+};
+
+//----------------------------------------------------------------------------
+bool vtkFitsIn32Bit(vtkIdType value)
+{
+  return value >= VTK_TYPE_INT32_MIN && value <= VTK_TYPE_INT32_MAX;
+}
+
+//----------------------------------------------------------------------------
+// Find the cell whose legacy location, offsets[i] + i, is loc. The
+// locations increase with i.
+template <typename T>
+vtkIdType vtkFindCellFromLocation(const T* offsets, vtkIdType numCells,
+                                  vtkIdType loc)
+{
+  vtkIdType first = 0;
+  vtkIdType last = numCells;
+  while (first < last)
+  {
+    const vtkIdType middle = first + (last - first) / 2;
+    if (offsets[middle] + middle < loc)
+    {
+      first = middle + 1;
+    }
+    else
+    {
+      last = middle;
+    }
+  }
+  return first;
+}
+
+}
+
 //----------------------------------------------------------------------------
 vtkCellArray::vtkCellArray()
 {
-  this->Ia = vtkIdTypeArray::New();
+  this->Offsets = vtkIdTypeArray::New();
+  this->Offsets->InsertNextValue(0);
+  this->Connectivity = vtkIdTypeArray::New();
+  this->Offsets32 = vtkTypeInt32Array::New();
+  this->Connectivity32 = vtkTypeInt32Array::New();
+  this->LegacyData = nullptr;
+  this->LegacyLocations = vtkIdTypeArray::New();
+  this->TraversalCellId = 0;
   this->NumberOfCells = 0;
-  this->InsertLocation = 0;
-  this->TraversalLocation = 0;
+  this->Storage = Storage64Bit;
+  this->ConnectivityCopied = false;
+  this->PendingInserts = 0;
 }
 
 //----------------------------------------------------------------------------
 void vtkCellArray::DeepCopy (vtkCellArray *ca)
 {
   // Do nothing on a nullptr input.
-  if (ca == nullptr)
+  if (ca == nullptr || ca == this)
   {
     return;
   }
 
-  this->Ia->DeepCopy(ca->Ia);
-  this->NumberOfCells = ca->NumberOfCells;
-  this->InsertLocation = ca->InsertLocation;
-  this->TraversalLocation = ca->TraversalLocation;
+  const int storage = ca->PrepareForRead();
+  this->SetStorage(storage);
+  switch (storage)
+  {
+    case Storage32Bit:
+      this->Offsets32->DeepCopy(ca->Offsets32);
+      this->Connectivity32->DeepCopy(ca->Connectivity32);
+      break;
+    case StorageLegacy:
+      this->LegacyData->DeepCopy(ca->LegacyData);
+      this->LegacyLocations->DeepCopy(ca->LegacyLocations);
+      break;
+    default:
+      this->Offsets->DeepCopy(ca->Offsets);
+      this->Connectivity->DeepCopy(ca->Connectivity);
+  }
+  this->TraversalCellId = ca->TraversalCellId;
 }
 
 //----------------------------------------------------------------------------
 vtkCellArray::~vtkCellArray()
 {
-  this->Ia->Delete();
+  this->Offsets->Delete();
+  this->Connectivity->Delete();
+  this->Offsets32->Delete();
+  this->Connectivity32->Delete();
+  if (this->LegacyData)
+  {
+    this->LegacyData->Delete();
+  }
+  this->LegacyLocations->Delete();
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetStorage(int storage)
+{
+  const int current = this->Storage.load(std::memory_order_acquire);
+  if (current == Storage64Bit && storage != Storage64Bit)
+  {
+    this->Offsets->Initialize();
+    this->Connectivity->Initialize();
+  }
+  else if (current == Storage32Bit && storage != Storage32Bit)
+  {
+    this->Offsets32->Initialize();
+    this->Connectivity32->Initialize();
+    this->Connectivity->Initialize();
+  }
+  else if ((current == StorageLegacy || current == StorageLegacyUnindexed) &&
+           storage != StorageLegacy && storage != StorageLegacyUnindexed)
+  {
+    this->LegacyData->UnRegister(this);
+    this->LegacyData = nullptr;
+    this->LegacyLocations->Initialize();
+  }
+
+  switch (storage)
+  {
+    case Storage64Bit:
+      if (this->Offsets->GetNumberOfValues() == 0)
+      {
+        this->Offsets->InsertNextValue(0);
+      }
+      break;
+    case Storage32Bit:
+      if (this->Offsets32->GetNumberOfValues() == 0)
+      {
+        this->Offsets32->InsertNextValue(0);
+      }
+      break;
+    default:
+      if (!this->LegacyData)
+      {
+        this->LegacyData = vtkIdTypeArray::New();
+      }
+  }
+  this->ConnectivityCopied.store(false, std::memory_order_release);
+  this->Storage.store(storage, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------
+vtkTypeBool vtkCellArray::Allocate(vtkIdType sz, vtkIdType ext)
+{
+  this->TraversalCellId = 0;
+  if (this->Storage.load(std::memory_order_acquire) == Storage32Bit &&
+      vtkFitsIn32Bit(sz))
+  {
+    // The legacy size counts one entry per cell in addition to the point
+    // ids, assume cells made of 3 points to size the offsets.
+    this->ConnectivityCopied.store(false, std::memory_order_release);
+    this->Connectivity->Initialize();
+    vtkTypeBool ok = this->Offsets32->Allocate(sz / 4 + 1, ext) &&
+      this->Connectivity32->Allocate(sz, ext);
+    this->Offsets32->InsertNextValue(0);
+    return ok;
+  }
+  this->SetStorage(Storage64Bit);
+  vtkTypeBool ok = this->Offsets->Allocate(sz / 4 + 1, ext) &&
+    this->Connectivity->Allocate(sz, ext);
+  this->Offsets->InsertNextValue(0);
+  return ok;
+}
+
+//----------------------------------------------------------------------------
+vtkTypeBool vtkCellArray::AllocateExact(vtkIdType numCells,
+                                        vtkIdType connectivitySize)
+{
+  this->TraversalCellId = 0;
+  if (this->Storage.load(std::memory_order_acquire) == Storage32Bit &&
+      vtkFitsIn32Bit(connectivitySize))
+  {
+    this->ConnectivityCopied.store(false, std::memory_order_release);
+    this->Connectivity->Initialize();
+    vtkTypeBool ok = this->Offsets32->Allocate(numCells + 1) &&
+      this->Connectivity32->Allocate(connectivitySize);
+    this->Offsets32->InsertNextValue(0);
+    return ok;
+  }
+  this->SetStorage(Storage64Bit);
+  vtkTypeBool ok = this->Offsets->Allocate(numCells + 1) &&
+    this->Connectivity->Allocate(connectivitySize);
+  this->Offsets->InsertNextValue(0);
+  return ok;
 }
 
 //----------------------------------------------------------------------------
 void vtkCellArray::Initialize()
 {
-  this->Ia->Initialize();
-  this->NumberOfCells = 0;
-  this->InsertLocation = 0;
-  this->TraversalLocation = 0;
+  this->SetStorage(Storage64Bit);
+  this->Offsets->Initialize();
+  this->Offsets->InsertNextValue(0);
+  this->Connectivity->Initialize();
+  this->TraversalCellId = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Reset()
+{
+  if (this->Storage.load(std::memory_order_acquire) == Storage32Bit)
+  {
+    this->Offsets32->Reset();
+    this->Offsets32->InsertNextValue(0);
+    this->Connectivity32->Reset();
+    this->Connectivity->Reset();
+  }
+  else
+  {
+    this->SetStorage(Storage64Bit);
+    this->Offsets->Reset();
+    this->Offsets->InsertNextValue(0);
+    this->Connectivity->Reset();
+  }
+  this->TraversalCellId = 0;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::Squeeze()
+{
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+      this->Offsets32->Squeeze();
+      this->Connectivity32->Squeeze();
+      this->Connectivity->Squeeze();
+      break;
+    case StorageLegacy:
+      this->LegacyData->Squeeze();
+      this->LegacyLocations->Squeeze();
+      break;
+    default:
+      this->Offsets->Squeeze();
+      this->Connectivity->Squeeze();
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetNumberOfCells(vtkIdType numCells)
+{
+  // Only meaningful for the legacy representation, which the caller is
+  // about to fill.
+  this->GetData();
+  this->NumberOfCells = numCells;
+  this->Storage.store(StorageLegacyUnindexed, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetSize()
+{
+  switch (this->Storage.load(std::memory_order_acquire))
+  {
+    case Storage32Bit:
+      return this->Offsets32->GetSize() - 1 + this->Connectivity32->GetSize();
+    case StorageLegacy: case StorageLegacyUnindexed:
+      return this->LegacyData->GetSize();
+    default:
+      return this->Offsets->GetSize() - 1 + this->Connectivity->GetSize();
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -61,40 +398,634 @@ void vtkCellArray::Initialize()
 // defining the cell.
 int vtkCellArray::GetMaxCellSize()
 {
-  int npts=0, maxSize=0;
-  vtkIdType i;
+  const int storage = this->PrepareForRead();
+  const vtkIdType numCells = this->GetNumberOfCells();
+  vtkIdType maxSize = 0;
+  if (storage == Storage64Bit)
+  {
+    const vtkIdType* offsets = this->Offsets->GetPointer(0);
+    for (vtkIdType i = 0; i < numCells; ++i)
+    {
+      maxSize = std::max(maxSize, offsets[i + 1] - offsets[i]);
+    }
+  }
+  else
+  {
+    for (vtkIdType i = 0; i < numCells; ++i)
+    {
+      maxSize = std::max(maxSize, this->GetCellSize(i));
+    }
+  }
+  return static_cast<int>(maxSize);
+}
 
-  for (i=0; i<this->Ia->GetMaxId(); i+=(npts+1))
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCellSlow(vtkIdType npts,
+                                           const vtkIdType pts[])
+{
+  switch (this->PrepareForRead())
   {
-    if ( (npts=this->Ia->GetValue(i)) > maxSize )
+    case Storage32Bit:
     {
-      maxSize = npts;
+      const vtkIdType first = this->Connectivity32->GetMaxId() + 1;
+      bool fits = vtkFitsIn32Bit(first + npts);
+      for (vtkIdType i = 0; i < npts && fits; ++i)
+      {
+        fits = vtkFitsIn32Bit(pts[i]);
+      }
+      if (!fits)
+      {
+        this->ConvertTo64BitStorage();
+        return this->InsertNextCell(npts, pts);
+      }
+      vtkTypeInt32* ptr = this->Connectivity32->WritePointer(first, npts);
+      std::copy(pts, pts + npts, ptr);
+      if (this->ConnectivityCopied.load(std::memory_order_relaxed))
+      {
+        std::copy(pts, pts + npts,
+          this->Connectivity->WritePointer(first, npts));
+      }
+      return this->Offsets32->InsertNextValue(
+        static_cast<vtkTypeInt32>(first + npts)) - 1;
     }
+    case StorageLegacy:
+    {
+      const vtkIdType loc = this->LegacyData->GetMaxId() + 1;
+      vtkIdType* ptr = this->LegacyData->WritePointer(loc, npts + 1);
+      *ptr++ = npts;
+      std::copy(pts, pts + npts, ptr);
+      return this->LegacyLocations->InsertNextValue(loc);
+    }
+    default:
+      return this->InsertNextCell(npts, pts);
   }
-  return maxSize;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCellSlow(int npts)
+{
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+      // The cell is empty until points are added with InsertCellPoint().
+      return this->Offsets32->InsertNextValue(
+        this->Connectivity32->GetMaxId() + 1) - 1;
+    case StorageLegacy:
+    {
+      // npts is updated by InsertCellPoint() and UpdateCellCount().
+      const vtkIdType loc = this->LegacyData->InsertNextValue(0);
+      return this->LegacyLocations->InsertNextValue(loc);
+    }
+    default:
+      return this->InsertNextCell(npts);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::InsertCellPointSlow(vtkIdType id)
+{
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+    {
+      const vtkIdType size = this->Connectivity32->GetMaxId() + 2;
+      if (!vtkFitsIn32Bit(id) || !vtkFitsIn32Bit(size))
+      {
+        this->ConvertTo64BitStorage();
+        this->InsertCellPoint(id);
+        return;
+      }
+      this->Connectivity32->InsertNextValue(static_cast<vtkTypeInt32>(id));
+      if (this->ConnectivityCopied.load(std::memory_order_relaxed))
+      {
+        this->Connectivity->InsertNextValue(id);
+      }
+      this->Offsets32->SetValue(this->Offsets32->GetMaxId(),
+        static_cast<vtkTypeInt32>(size));
+      break;
+    }
+    case StorageLegacy:
+    {
+      const vtkIdType loc = this->LegacyLocations->GetValue(
+        this->LegacyLocations->GetMaxId());
+      this->LegacyData->InsertNextValue(id);
+      this->LegacyData->SetValue(loc, this->LegacyData->GetValue(loc) + 1);
+      break;
+    }
+    default:
+      this->InsertCellPoint(id);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::UpdateCellCountSlow(int npts)
+{
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+    {
+      const vtkIdType lastCell = this->Offsets32->GetMaxId();
+      const vtkIdType size = this->Offsets32->GetValue(lastCell - 1) + npts;
+      this->Connectivity32->SetNumberOfValues(size);
+      if (this->ConnectivityCopied.load(std::memory_order_relaxed))
+      {
+        this->Connectivity->SetNumberOfValues(size);
+      }
+      this->Offsets32->SetValue(lastCell, static_cast<vtkTypeInt32>(size));
+      break;
+    }
+    case StorageLegacy:
+    {
+      const vtkIdType loc = this->LegacyLocations->GetValue(
+        this->LegacyLocations->GetMaxId());
+      this->LegacyData->SetNumberOfValues(loc + 1 + npts);
+      this->LegacyData->SetValue(loc, npts);
+      break;
+    }
+    default:
+      this->UpdateCellCount(npts);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReplaceCellAtIdSlow(vtkIdType cellId, vtkIdType npts,
+                                       const vtkIdType pts[])
+{
+  const int storage = this->PrepareForRead();
+  if (storage == Storage32Bit)
+  {
+    bool fits = true;
+    for (vtkIdType i = 0; i < npts && fits; ++i)
+    {
+      fits = vtkFitsIn32Bit(pts[i]);
+    }
+    if (!fits)
+    {
+      this->ConvertTo64BitStorage();
+    }
+    else
+    {
+      const vtkIdType first = this->Offsets32->GetValue(cellId);
+      std::copy(pts, pts + npts, this->Connectivity32->GetPointer(first));
+      if (this->ConnectivityCopied.load(std::memory_order_relaxed))
+      {
+        std::copy(pts, pts + npts, this->Connectivity->GetPointer(first));
+      }
+      return;
+    }
+  }
+  // The point ids are written in place for the other storages.
+  vtkIdType oldNpts, *oldPts;
+  this->GetCellAtId(cellId, oldNpts, oldPts);
+  std::copy(pts, pts + npts, oldPts);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ReverseCellAtIdSlow(vtkIdType cellId)
+{
+  if (this->PrepareForRead() == Storage32Bit)
+  {
+    const vtkTypeInt32* offsets = this->Offsets32->GetPointer(cellId);
+    vtkTypeInt32* pts = this->Connectivity32->GetPointer(offsets[0]);
+    std::reverse(pts, pts + (offsets[1] - offsets[0]));
+    if (this->ConnectivityCopied.load(std::memory_order_relaxed))
+    {
+      vtkIdType* copy = this->Connectivity->GetPointer(offsets[0]);
+      std::reverse(copy, copy + (offsets[1] - offsets[0]));
+    }
+    return;
+  }
+  vtkIdType npts, *pts;
+  this->GetCellAtId(cellId, npts, pts);
+  std::reverse(pts, pts + npts);
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::InsertNextCells(vtkIdType numCells,
+  const vtkIdType* offsets, const vtkIdType* connectivity)
+{
+  if (numCells <= 0)
+  {
+    return this->GetNumberOfCells();
+  }
+  const vtkIdType connectivitySize = offsets[numCells] - offsets[0];
+  vtkIdType firstCell, firstId;
+  vtkIdType *outOffsets, *outConnectivity;
+  {
+    std::lock_guard<std::mutex> lock(this->InsertLock);
+    if (this->Storage.load(std::memory_order_acquire) != Storage64Bit)
+    {
+      this->ConvertTo64BitStorage();
+    }
+
+    firstCell = this->Offsets->GetMaxId();
+    firstId = this->Connectivity->GetMaxId() + 1;
+    if (firstCell + numCells >= this->Offsets->GetSize() ||
+        firstId + connectivitySize > this->Connectivity->GetSize())
+    {
+      // The arrays are reallocated, wait for the copies in progress.
+      while (this->PendingInserts.load() > 0)
+      {
+        std::this_thread::yield();
+      }
+    }
+    outOffsets = this->Offsets->WritePointer(firstCell + 1, numCells);
+    outConnectivity =
+      this->Connectivity->WritePointer(firstId, connectivitySize);
+    // The end of the batch is set while holding the lock so that the next
+    // batch sees it.
+    outOffsets[numCells - 1] = firstId + connectivitySize;
+    ++this->PendingInserts;
+  }
+
+  const vtkIdType shift = firstId - offsets[0];
+  for (vtkIdType i = 1; i < numCells; ++i)
+  {
+    outOffsets[i - 1] = offsets[i] + shift;
+  }
+  std::copy(connectivity + offsets[0], connectivity + offsets[numCells],
+    outConnectivity);
+
+  --this->PendingInserts;
+  return firstCell;
 }
 
 //----------------------------------------------------------------------------
 // Specify a group of cells.
 void vtkCellArray::SetCells(vtkIdType ncells, vtkIdTypeArray *cells)
 {
-  if ( cells && cells != this->Ia )
+  if (!cells)
   {
-    this->Modified();
-    this->Ia->Delete();
-    this->Ia = cells;
-    this->Ia->Register(this);
+    return;
+  }
+  this->Modified();
+  // The array becomes the legacy array. When it already is (the caller
+  // wrote in GetData()) its cells are simply indexed again.
+  if (cells != this->LegacyData)
+  {
+    this->SetStorage(StorageLegacyUnindexed);
+    cells->Register(this);
+    this->LegacyData->UnRegister(this);
+    this->LegacyData = cells;
+  }
+  this->NumberOfCells = ncells;
+  this->TraversalCellId = 0;
+  this->Storage.store(StorageLegacyUnindexed, std::memory_order_release);
+}
 
-    this->NumberOfCells = ncells;
-    this->InsertLocation = cells->GetMaxId() + 1;
-    this->TraversalLocation = 0;
+//----------------------------------------------------------------------------
+bool vtkCellArray::SetData(vtkIdTypeArray* offsets,
+                           vtkIdTypeArray* connectivity)
+{
+  if (!offsets || !connectivity || offsets->GetNumberOfComponents() != 1 ||
+      connectivity->GetNumberOfComponents() != 1 ||
+      offsets->GetNumberOfValues() < 1 || offsets->GetValue(0) != 0 ||
+      offsets->GetValue(offsets->GetMaxId()) !=
+        connectivity->GetNumberOfValues())
+  {
+    vtkErrorMacro("Inconsistent offsets and connectivity arrays.");
+    return false;
+  }
+
+  this->SetStorage(Storage64Bit);
+  if (offsets != this->Offsets)
+  {
+    offsets->Register(this);
+    this->Offsets->UnRegister(this);
+    this->Offsets = offsets;
+  }
+  if (connectivity != this->Connectivity)
+  {
+    connectivity->Register(this);
+    this->Connectivity->UnRegister(this);
+    this->Connectivity = connectivity;
   }
+  this->TraversalCellId = 0;
+  this->Modified();
+  return true;
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray* vtkCellArray::GetOffsetsArray()
+{
+  this->ConvertTo64BitStorage();
+  return this->Offsets;
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray* vtkCellArray::GetConnectivityArray()
+{
+  this->ConvertTo64BitStorage();
+  return this->Connectivity;
+}
+
+//----------------------------------------------------------------------------
+vtkIdTypeArray* vtkCellArray::GetData()
+{
+  const int storage = this->Storage.load(std::memory_order_acquire);
+  if (storage == StorageLegacy || storage == StorageLegacyUnindexed)
+  {
+    return this->LegacyData;
+  }
+
+  std::lock_guard<std::mutex> lock(this->StorageLock);
+  if (this->Storage.load(std::memory_order_acquire) == storage)
+  {
+    // Switch to the legacy array, whose cells are contiguous.
+    vtkIdTypeArray* legacy = vtkIdTypeArray::New();
+    this->ExportLegacyFormat(legacy);
+    const vtkIdType numCells = this->GetNumberOfCells();
+    this->LegacyLocations->SetNumberOfValues(numCells);
+    vtkIdType* locations = this->LegacyLocations->GetPointer(0);
+    if (storage == Storage32Bit)
+    {
+      const vtkTypeInt32* offsets = this->Offsets32->GetPointer(0);
+      vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          locations[i] = offsets[i] + i;
+        }
+      });
+    }
+    else
+    {
+      const vtkIdType* offsets = this->Offsets->GetPointer(0);
+      vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+        for (vtkIdType i = begin; i < end; ++i)
+        {
+          locations[i] = offsets[i] + i;
+        }
+      });
+    }
+    this->LegacyData = legacy;
+    this->SetStorage(StorageLegacy);
+  }
+  return this->LegacyData;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
+                                      const vtkIdType size)
+{
+  vtkIdTypeArray* data = this->GetData();
+  this->NumberOfCells = ncells;
+  this->TraversalCellId = 0;
+  // The caller writes the cells: index them on next access.
+  this->Storage.store(StorageLegacyUnindexed, std::memory_order_release);
+  return data->WritePointer(0, size);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ExportLegacyFormat(vtkIdTypeArray* data)
+{
+  const int storage = this->PrepareForRead();
+  data->SetNumberOfComponents(1);
+  if (storage == StorageLegacy)
+  {
+    data->SetNumberOfValues(this->LegacyData->GetNumberOfValues());
+    vtkCopyAllValues(this->LegacyData->GetPointer(0), data->GetPointer(0),
+      this->LegacyData->GetNumberOfValues());
+    return;
+  }
+
+  const vtkIdType numCells = this->GetNumberOfCells();
+  data->SetNumberOfValues(this->GetNumberOfConnectivityEntries());
+  if (storage == Storage32Bit)
+  {
+    vtkExportLegacyCells<vtkTypeInt32> exporter;
+    exporter.Offsets = this->Offsets32->GetPointer(0);
+    exporter.Connectivity = this->Connectivity32->GetPointer(0);
+    exporter.Legacy = data->GetPointer(0);
+    vtkSMPTools::For(0, numCells, exporter);
+  }
+  else
+  {
+    vtkExportLegacyCells<vtkIdType> exporter;
+    exporter.Offsets = this->Offsets->GetPointer(0);
+    exporter.Connectivity = this->Connectivity->GetPointer(0);
+    exporter.Legacy = data->GetPointer(0);
+    vtkSMPTools::For(0, numCells, exporter);
+  }
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ImportLegacyFormat(vtkIdTypeArray* data)
+{
+  vtkIdTypeArray* copy = vtkIdTypeArray::New();
+  copy->DeepCopy(data);
+  // Index all the cells of the copy and convert them.
+  this->SetCells(-1, copy);
+  copy->Delete();
+  this->ConvertTo64BitStorage();
+}
+
+//----------------------------------------------------------------------------
+int vtkCellArray::BuildLegacyLocations()
+{
+  std::lock_guard<std::mutex> lock(this->StorageLock);
+  const int storage = this->Storage.load(std::memory_order_acquire);
+  if (storage != StorageLegacyUnindexed)
+  {
+    // Another thread did it.
+    return storage;
+  }
+
+  // Walk the legacy array. It may be larger than needed (see WritePointer())
+  // so the walk stops after the declared number of cells, if any, and the
+  // end of the array is dropped. A truncated last cell is ignored.
+  const vtkIdType* legacy = this->LegacyData->GetPointer(0);
+  const vtkIdType legacySize = this->LegacyData->GetMaxId() + 1;
+  const vtkIdType maxNumCells =
+    this->NumberOfCells < 0 ? VTK_ID_MAX : this->NumberOfCells;
+  this->LegacyLocations->Reset();
+  this->LegacyLocations->Allocate(
+    (this->NumberOfCells < 0 ? legacySize / 4 : this->NumberOfCells) + 1);
+  vtkIdType loc = 0;
+  while (loc < legacySize && this->LegacyLocations->GetMaxId() + 1 < maxNumCells)
+  {
+    const vtkIdType npts = legacy[loc];
+    if (npts < 0 || loc + npts >= legacySize)
+    {
+      break;
+    }
+    this->LegacyLocations->InsertNextValue(loc);
+    loc += npts + 1;
+  }
+  if (loc < legacySize)
+  {
+    // Keep the memory, and the pointers given to the caller.
+    this->LegacyData->Reset();
+    this->LegacyData->WritePointer(0, loc);
+  }
+  this->NumberOfCells = this->LegacyLocations->GetMaxId() + 1;
+
+  this->Storage.store(StorageLegacy, std::memory_order_release);
+  return StorageLegacy;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::CopyConnectivity()
+{
+  std::lock_guard<std::mutex> lock(this->StorageLock);
+  if (this->ConnectivityCopied.load(std::memory_order_acquire))
+  {
+    // Another thread did it.
+    return;
+  }
+  const vtkIdType numIds = this->Connectivity32->GetNumberOfValues();
+  this->Connectivity->SetNumberOfValues(numIds);
+  vtkCopyAllValues(this->Connectivity32->GetPointer(0),
+    this->Connectivity->GetPointer(0), numIds);
+  this->ConnectivityCopied.store(true, std::memory_order_release);
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::CanConvertTo32BitStorage()
+{
+  vtkCheckValuesFit checker;
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+      return true;
+    case StorageLegacy:
+      // The cell sizes are checked as well, which cannot hurt.
+      checker.Values = this->LegacyData->GetPointer(0);
+      vtkSMPTools::For(0, this->LegacyData->GetNumberOfValues(), checker);
+      break;
+    default:
+      checker.Values = this->Connectivity->GetPointer(0);
+      vtkSMPTools::For(0, this->Connectivity->GetNumberOfValues(), checker);
+  }
+  return vtkFitsIn32Bit(this->GetNumberOfConnectivityIds()) && checker.Fits();
+}
+
+//----------------------------------------------------------------------------
+bool vtkCellArray::ConvertTo32BitStorage()
+{
+  if (this->IsStorage32Bit())
+  {
+    return true;
+  }
+  if (!this->CanConvertTo32BitStorage())
+  {
+    return false;
+  }
+  this->ConvertTo64BitStorage();
+
+  const vtkIdType numCells = this->Offsets->GetMaxId();
+  const vtkIdType numIds = this->Connectivity->GetNumberOfValues();
+  this->Offsets32->SetNumberOfValues(numCells + 1);
+  vtkCopyAllValues(this->Offsets->GetPointer(0),
+    this->Offsets32->GetPointer(0), numCells + 1);
+  this->Connectivity32->SetNumberOfValues(numIds);
+  vtkCopyAllValues(this->Connectivity->GetPointer(0),
+    this->Connectivity32->GetPointer(0), numIds);
+
+  this->Offsets->Initialize();
+  this->Connectivity->Initialize();
+  this->ConnectivityCopied.store(false, std::memory_order_release);
+  this->Storage.store(Storage32Bit, std::memory_order_release);
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::ConvertTo64BitStorage()
+{
+  const int storage = this->PrepareForRead();
+  if (storage == Storage64Bit)
+  {
+    return;
+  }
+
+  const vtkIdType numCells = this->GetNumberOfCells();
+  vtkIdTypeArray* offsets = vtkIdTypeArray::New();
+  offsets->SetNumberOfValues(numCells + 1);
+  vtkIdTypeArray* connectivity = nullptr;
+  if (storage == Storage32Bit)
+  {
+    vtkCopyAllValues(this->Offsets32->GetPointer(0), offsets->GetPointer(0),
+      numCells + 1);
+    if (this->ConnectivityCopied.load(std::memory_order_acquire))
+    {
+      // Reuse the copy.
+      connectivity = this->Connectivity;
+      this->Connectivity = vtkIdTypeArray::New();
+    }
+    else
+    {
+      connectivity = vtkIdTypeArray::New();
+      connectivity->SetNumberOfValues(
+        this->Connectivity32->GetNumberOfValues());
+      vtkCopyAllValues(this->Connectivity32->GetPointer(0),
+        connectivity->GetPointer(0), connectivity->GetNumberOfValues());
+    }
+  }
+  else
+  {
+    connectivity = vtkIdTypeArray::New();
+    connectivity->SetNumberOfValues(this->GetNumberOfConnectivityIds());
+    vtkImportLegacyCells<vtkIdType> importer;
+    importer.Locations = this->LegacyLocations->GetPointer(0);
+    importer.Legacy = this->LegacyData->GetPointer(0);
+    importer.Offsets = offsets->GetPointer(0);
+    importer.Connectivity = connectivity->GetPointer(0);
+    vtkSMPTools::For(0, numCells, importer);
+    offsets->SetValue(numCells, connectivity->GetNumberOfValues());
+  }
+
+  this->SetStorage(Storage64Bit);
+  this->Offsets->Delete();
+  this->Offsets = offsets;
+  this->Connectivity->Delete();
+  this->Connectivity = connectivity;
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetCellIdFromLocation(vtkIdType loc)
+{
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+      return vtkFindCellFromLocation(this->Offsets32->GetPointer(0),
+        this->Offsets32->GetMaxId(), loc);
+    case StorageLegacy:
+    {
+      const vtkIdType* locations = this->LegacyLocations->GetPointer(0);
+      const vtkIdType numCells = this->LegacyLocations->GetMaxId() + 1;
+      return std::lower_bound(locations, locations + numCells, loc) -
+        locations;
+    }
+    default:
+      return vtkFindCellFromLocation(this->Offsets->GetPointer(0),
+        this->Offsets->GetMaxId(), loc);
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkIdType vtkCellArray::GetTraversalLocation()
+{
+  return this->GetLocationFromCellId(this->TraversalCellId);
+}
+
+//----------------------------------------------------------------------------
+void vtkCellArray::SetTraversalLocation(vtkIdType loc)
+{
+  this->TraversalCellId = this->GetCellIdFromLocation(loc);
 }
 
 //----------------------------------------------------------------------------
 unsigned long vtkCellArray::GetActualMemorySize()
 {
-  return this->Ia->GetActualMemorySize();
+  unsigned long size = this->Offsets->GetActualMemorySize() +
+    this->Connectivity->GetActualMemorySize() +
+    this->Offsets32->GetActualMemorySize() +
+    this->Connectivity32->GetActualMemorySize() +
+    this->LegacyLocations->GetActualMemorySize();
+  if (this->LegacyData)
+  {
+    size += this->LegacyData->GetActualMemorySize();
+  }
+  return size;
 }
 
 //----------------------------------------------------------------------------
@@ -114,10 +1045,19 @@ int vtkCellArray::GetNextCell(vtkIdList *pts)
 }
 
 //----------------------------------------------------------------------------
-void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
+void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdList *pts)
 {
-  vtkIdType npts = this->Ia->GetValue(loc++);
-  vtkIdType *ppts = this->Ia->GetPointer(loc);
+  if (this->PrepareForRead() == Storage32Bit)
+  {
+    // Read the 32-bit ids directly, without the vtkIdType copy.
+    const vtkTypeInt32* offsets = this->Offsets32->GetPointer(cellId);
+    const vtkTypeInt32* ids = this->Connectivity32->GetPointer(offsets[0]);
+    pts->SetNumberOfIds(offsets[1] - offsets[0]);
+    std::copy(ids, ids + (offsets[1] - offsets[0]), pts->GetPointer(0));
+    return;
+  }
+  vtkIdType npts, *ppts;
+  this->GetCellAtId(cellId, npts, ppts);
   pts->SetNumberOfIds(npts);
   for (vtkIdType i = 0; i < npts; i++)
   {
@@ -125,12 +1065,38 @@ void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkCellArray::GetCell(vtkIdType loc, vtkIdList *pts)
+{
+  this->GetCellAtId(this->GetCellIdFromLocation(loc), pts);
+}
+
 //----------------------------------------------------------------------------
 void vtkCellArray::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
 
-  os << indent << "Number Of Cells: " << this->NumberOfCells << endl;
-  os << indent << "Insert Location: " << this->InsertLocation << endl;
-  os << indent << "Traversal Location: " << this->TraversalLocation << endl;
+  os << indent << "Number Of Cells: " << this->GetNumberOfCells() << endl;
+  os << indent << "Traversal Cell Id: " << this->TraversalCellId << endl;
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+      os << indent << "Storage: 32-bit\n";
+      os << indent << "Offsets:\n";
+      this->Offsets32->PrintSelf(os, indent.GetNextIndent());
+      os << indent << "Connectivity:\n";
+      this->Connectivity32->PrintSelf(os, indent.GetNextIndent());
+      break;
+    case StorageLegacy:
+      os << indent << "Storage: Legacy\n";
+      os << indent << "Legacy Data:\n";
+      this->LegacyData->PrintSelf(os, indent.GetNextIndent());
+      break;
+    default:
+      os << indent << "Storage: vtkIdType\n";
+      os << indent << "Offsets:\n";
+      this->Offsets->PrintSelf(os, indent.GetNextIndent());
+      os << indent << "Connectivity:\n";
+      this->Connectivity->PrintSelf(os, indent.GetNextIndent());
+  }
 }
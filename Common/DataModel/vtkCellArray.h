@@ -17,16 +17,48 @@
  * @brief   object to represent cell connectivity
  *
  * vtkCellArray is a supporting object that explicitly represents cell
- * connectivity. The cell array structure is a raw integer list
- * of the form: (n,id1,id2,...,idn, n,id1,id2,...,idn, ...)
- * where n is the number of points in the cell, and id is a zero-offset index
- * into an associated point list.
+ * connectivity. The point ids of all the cells are stored one after the
+ * other in a connectivity array, and an offsets array gives the position of
+ * the first point id of each cell in the connectivity array. The offsets
+ * array has one more entry than there are cells, the last one being the
+ * size of the connectivity array, so that cell i is made of the point ids
+ * connectivity[offsets[i]] to connectivity[offsets[i+1]-1]. Ids are
+ * zero-offset indices into an associated point list.
  *
- * Advantages of this data structure are its compactness, simplicity, and
- * easy interface to external data.  However, it is totally inadequate for
- * random access.  This functionality (when necessary) is accomplished by
- * using the vtkCellTypes and vtkCellLinks objects to extend the definition of
- * the data structure.
+ * This layout gives constant time random access to the cells through the
+ * *AtId() methods, and makes it possible to generate cells in parallel:
+ * once the number of cells and the size of the connectivity are known the
+ * arrays can be allocated with AllocateExact() and filled concurrently, or
+ * threads can append batches of cells with the thread safe
+ * InsertNextCells(). Existing offsets and connectivity arrays, including
+ * arrays wrapping externally owned buffers (see
+ * vtkIdTypeArray::SetArray()), can be used without copy with SetData().
+ *
+ * The legacy layout, a single (n,id1,id2,...,idn, n,id1,...) array, is
+ * still supported. GetData() and GetPointer() switch the storage to that
+ * array, once, and it then holds the cells: values written through the
+ * returned pointer are seen by all the other methods, cells inserted
+ * afterwards are appended to it, and SetCells() or WritePointer() install
+ * cells written in that form. The location of each cell in the legacy
+ * array is indexed, so random access remains constant time; after
+ * SetCells(), WritePointer() or SetNumberOfCells() the index is rebuilt, in
+ * a thread safe manner, the next time the cells are accessed. The number
+ * of points of a cell may only be changed through these methods.
+ * GetOffsetsArray(), GetConnectivityArray(), SetData() and
+ * InsertNextCells() switch back to offsets and connectivity.
+ * The legacy "locations" (offsets in that array) accepted by GetCell(),
+ * ReverseCell(), ReplaceCell() and SetTraversalLocation() are converted
+ * to cell ids with a binary search; prefer the *AtId() methods.
+ *
+ * The offsets and connectivity may also be stored as 32-bit integers, see
+ * ConvertTo32BitStorage(), which halves their memory when vtkIdType is
+ * 64-bit. This is opt-in because the methods returning vtkIdType pointers
+ * to the point ids then read a vtkIdType copy of the connectivity, made on
+ * first use and kept up to date by the modifications, which takes back the
+ * memory saved. Use the methods copying the point ids instead, like
+ * GetCellAtId(vtkIdType, vtkIdList*), and GetCellSize(), to keep the
+ * savings. Point ids that do not fit in 32 bits switch the storage back to
+ * vtkIdType.
  *
  * @sa
  * vtkCellTypes vtkCellLinks
@@ -40,6 +72,10 @@
 
 #include "vtkIdTypeArray.h" // Needed for inline methods
 #include "vtkCell.h" // Needed for inline methods
+#include "vtkTypeInt32Array.h" // Needed for inline methods
+
+#include <atomic> // For the storage state
+#include <mutex> // For thread safe conversions and appends
 
 class VTKCOMMONDATAMODEL_EXPORT vtkCellArray : public vtkObject
 {
@@ -53,30 +89,37 @@ public:
   static vtkCellArray *New();
 
   /**
-   * Allocate memory and set the size to extend by.
+   * Allocate memory and set the size to extend by. sz is the size of the
+   * legacy (npts, ids...) representation, see EstimateSize(). Prefer
+   * AllocateExact() when the number of cells is known.
+   */
+  vtkTypeBool Allocate(vtkIdType sz, vtkIdType ext=1000);
+
+  /**
+   * Allocate memory for numCells cells made of connectivitySize point ids
+   * in total. The cell array is emptied. A 32-bit storage is kept if
+   * connectivitySize fits.
    */
-  vtkTypeBool Allocate(vtkIdType sz, vtkIdType ext=1000)
-    {return this->Ia->Allocate(sz,ext);}
+  vtkTypeBool AllocateExact(vtkIdType numCells, vtkIdType connectivitySize);
 
   /**
-   * Free any memory and reset to an empty state.
+   * Free any memory and reset to an empty state, with vtkIdType storage.
    */
   void Initialize();
 
-  //@{
   /**
    * Get the number of cells in the array.
    */
-  vtkGetMacro(NumberOfCells, vtkIdType);
-  //@}
+  vtkIdType GetNumberOfCells();
 
-  //@{
   /**
    * Set the number of cells in the array.
-   * DO NOT do any kind of allocation, advanced use only.
+   * DO NOT do any kind of allocation, advanced use only: this announces
+   * that the caller fills the legacy array returned by GetData(), whose
+   * cells are indexed the next time they are accessed. Prefer
+   * WritePointer().
    */
-  vtkSetMacro(NumberOfCells, vtkIdType);
-  //@}
+  void SetNumberOfCells(vtkIdType numCells);
 
   /**
    * Utility routines help manage memory of cell array. EstimateSize()
@@ -93,7 +136,7 @@ public:
    * A cell traversal methods that is more efficient than vtkDataSet traversal
    * methods.  InitTraversal() initializes the traversal of the list of cells.
    */
-  void InitTraversal() {this->TraversalLocation=0;};
+  void InitTraversal() {this->TraversalCellId=0;};
 
   /**
    * A cell traversal methods that is more efficient than vtkDataSet traversal
@@ -112,30 +155,75 @@ public:
   int GetNextCell(vtkIdList *pts);
 
   /**
-   * Get the size of the allocated connectivity array.
+   * Get the allocated size of the cell array, in terms of the legacy
+   * (npts, ids...) representation.
    */
-  vtkIdType GetSize()
-    {return this->Ia->GetSize();}
+  vtkIdType GetSize();
 
   /**
-   * Get the total number of entries (i.e., data values) in the connectivity
-   * array. This may be much less than the allocated size (i.e., return value
-   * from GetSize().)
+   * Get the total number of entries of the legacy (npts, ids...)
+   * representation of the cells, that is the number of point ids plus the
+   * number of cells. This may be much less than the allocated size (i.e.,
+   * return value from GetSize().)
    */
-  vtkIdType GetNumberOfConnectivityEntries()
-    {return this->Ia->GetMaxId()+1;}
+  vtkIdType GetNumberOfConnectivityEntries();
 
   /**
-   * Internal method used to retrieve a cell given an offset into
-   * the internal array.
+   * Get the number of point ids in the connectivity array.
+   */
+  vtkIdType GetNumberOfConnectivityIds();
+
+  /**
+   * Get the number of offsets, which is the number of cells plus one.
+   */
+  vtkIdType GetNumberOfOffsets()
+    {return this->GetNumberOfCells()+1;}
+
+  /**
+   * Get the number of points of the cell cellId.
+   */
+  vtkIdType GetCellSize(vtkIdType cellId)
+    VTK_EXPECTS(0 <= cellId && cellId < GetNumberOfCells());
+
+  /**
+   * Return the point ids of the cell cellId. pts points into the
+   * connectivity array (or into the legacy array, or into the vtkIdType
+   * copy of a 32-bit connectivity) and remains valid until cells are
+   * inserted or the storage changes. This method is thread safe.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, vtkIdType* &pts)
+    VTK_EXPECTS(0 <= cellId && cellId < GetNumberOfCells())
+    VTK_SIZEHINT(pts, npts);
+
+  /**
+   * Return the point ids of the cell cellId like the method above, but read
+   * a 32-bit connectivity into ptIds instead of making its vtkIdType copy.
+   * pts then points into ptIds. This method is thread safe as long as each
+   * thread passes its own ptIds.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdType &npts, const vtkIdType* &pts,
+                   vtkIdList* ptIds)
+    VTK_EXPECTS(0 <= cellId && cellId < GetNumberOfCells())
+    VTK_SIZEHINT(pts, npts);
+
+  /**
+   * Copy the point ids of the cell cellId into pts. This method is thread
+   * safe and does not copy a 32-bit connectivity.
+   */
+  void GetCellAtId(vtkIdType cellId, vtkIdList* pts)
+    VTK_EXPECTS(0 <= cellId && cellId < GetNumberOfCells());
+
+  /**
+   * Legacy method used to retrieve a cell given an offset into the
+   * (npts, ids...) representation of the cells. Use GetCellAtId().
    */
   void GetCell(vtkIdType loc, vtkIdType &npts, vtkIdType* &pts)
     VTK_EXPECTS(0 <= loc && loc < GetSize())
     VTK_SIZEHINT(pts, npts);
 
   /**
-   * Internal method used to retrieve a cell given an offset into
-   * the internal array.
+   * Legacy method used to retrieve a cell given an offset into the
+   * (npts, ids...) representation of the cells. Use GetCellAtId().
    */
   void GetCell(vtkIdType loc, vtkIdList* pts)
     VTK_EXPECTS(0 <= loc && loc < GetSize());
@@ -179,44 +267,95 @@ public:
   void UpdateCellCount(int npts);
 
   /**
-   * Computes the current insertion location within the internal array.
-   * Used in conjunction with GetCell(int loc,...).
+   * Append numCells cells. offsets has numCells+1 entries and gives the
+   * position of the point ids of each cell in connectivity, offsets[0] is
+   * usually 0. Return the cell id of the first inserted cell.
+   *
+   * This method may be called concurrently from several threads, each one
+   * appending a batch of cells it generated. No other method may be called
+   * while cells are appended. The batches are stored one after the other in
+   * the order the calls acquire an internal lock, so use this method only
+   * when the order of the cells does not matter. Reserving the memory
+   * beforehand with AllocateExact() avoids reallocations, which have to wait
+   * for the copies in progress.
+   */
+  vtkIdType InsertNextCells(vtkIdType numCells, const vtkIdType* offsets,
+    const vtkIdType* connectivity);
+
+  /**
+   * Computes the current insertion location within the legacy
+   * (npts, ids...) representation. Used in conjunction with
+   * GetCell(int loc,...). The cell id returned by InsertNextCell() should be
+   * preferred.
    */
   vtkIdType GetInsertLocation(int npts)
-    {return (this->InsertLocation - npts - 1);};
+    {return (this->GetNumberOfConnectivityEntries() - npts - 1);};
 
   /**
-   * Get/Set the current traversal location.
+   * Return the location of the cell cellId within the legacy
+   * (npts, ids...) representation.
    */
-  vtkIdType GetTraversalLocation()
-    {return this->TraversalLocation;}
-  void SetTraversalLocation(vtkIdType loc)
-    {this->TraversalLocation = loc;}
+  vtkIdType GetLocationFromCellId(vtkIdType cellId)
+    VTK_EXPECTS(0 <= cellId && cellId <= GetNumberOfCells());
 
+  //@{
   /**
-   * Computes the current traversal location within the internal array. Used
-   * in conjunction with GetCell(int loc,...).
+   * Get/Set the current traversal location within the legacy
+   * (npts, ids...) representation. Prefer Get/SetTraversalCellId().
+   */
+  vtkIdType GetTraversalLocation();
+  void SetTraversalLocation(vtkIdType loc);
+  //@}
+
+  /**
+   * Computes the legacy location of the cell returned by the last call to
+   * GetNextCell(). Used in conjunction with GetCell(int loc,...).
    */
   vtkIdType GetTraversalLocation(vtkIdType npts)
-    {return(this->TraversalLocation-npts-1);}
+    {return(this->GetTraversalLocation()-npts-1);}
+
+  //@{
+  /**
+   * Get/Set the id of the cell returned by the next call to GetNextCell().
+   */
+  vtkIdType GetTraversalCellId()
+    {return this->TraversalCellId;}
+  void SetTraversalCellId(vtkIdType cellId)
+    {this->TraversalCellId = cellId;}
+  //@}
 
   /**
    * Special method inverts ordering of current cell. Must be called
-   * carefully or the cell topology may be corrupted.
+   * carefully or the cell topology may be corrupted. loc is a legacy
+   * location, prefer ReverseCellAtId().
    */
   void ReverseCell(vtkIdType loc)
     VTK_EXPECTS(0 <= loc && loc < GetSize());
 
+  /**
+   * Inverts the ordering of the point ids of the cell cellId.
+   */
+  void ReverseCellAtId(vtkIdType cellId)
+    VTK_EXPECTS(0 <= cellId && cellId < GetNumberOfCells());
+
   /**
    * Replace the point ids of the cell with a different list of point ids.
    * Calling this method does not mark the vtkCellArray as modified.  This is
    * the responsibility of the caller and may be done after multiple calls to
-   * ReplaceCell.
+   * ReplaceCell. loc is a legacy location, prefer ReplaceCellAtId().
    */
   void ReplaceCell(vtkIdType loc, int npts, const vtkIdType pts[])
     VTK_EXPECTS(0 <= loc && loc < GetSize())
     VTK_SIZEHINT(pts, npts);
 
+  /**
+   * Replace the point ids of the cell cellId, npts must be the size of the
+   * cell. This method does not mark the vtkCellArray as modified.
+   */
+  void ReplaceCellAtId(vtkIdType cellId, vtkIdType npts, const vtkIdType pts[])
+    VTK_EXPECTS(0 <= cellId && cellId < GetNumberOfCells())
+    VTK_SIZEHINT(pts, npts);
+
   /**
    * Returns the size of the largest cell. The size is the number of points
    * defining the cell.
@@ -224,15 +363,17 @@ public:
   int GetMaxCellSize();
 
   /**
-   * Get pointer to array of cell data.
+   * Get pointer to the legacy (npts, ids...) representation of the cells,
+   * see GetData().
    */
   vtkIdType *GetPointer()
-    {return this->Ia->GetPointer(0);}
+    {return this->GetData()->GetPointer(0);}
 
   /**
-   * Get pointer to data array for purpose of direct writes of data. Size is the
-   * total storage consumed by the cell array. ncells is the number of cells
-   * represented in the array.
+   * Get pointer to the legacy (npts, ids...) representation of the cells for
+   * the purpose of direct writes of data. Size is the total storage
+   * consumed by the cell array. ncells is the number of cells represented
+   * in the array. The cells are indexed the next time they are accessed.
    */
   vtkIdType *WritePointer(const vtkIdType ncells, const vtkIdType size);
 
@@ -242,21 +383,82 @@ public:
    * using this method because it discards the old cells, and anything
    * referring these cells becomes invalid (for example, if BuildCells() has
    * been called see vtkPolyData).  The traversal location is reset to the
-   * beginning of the list; the insertion location is set to the end of the
-   * list.
+   * beginning of the list. The list is used without copy, as the legacy
+   * array, and may be the one returned by GetData(), to announce cells
+   * written in it.
    */
   void SetCells(vtkIdType ncells, vtkIdTypeArray *cells);
 
+  /**
+   * Use the given offsets and connectivity arrays to store the cells,
+   * without copy. offsets must have one more value than there are cells,
+   * start with 0 and end with the number of values of connectivity. To
+   * use externally owned buffers, wrap them in vtkIdTypeArrays with
+   * vtkIdTypeArray::SetArray(). Returns false, and leaves the cell array
+   * unchanged, if the arrays are not consistent.
+   */
+  bool SetData(vtkIdTypeArray* offsets, vtkIdTypeArray* connectivity);
+
+  //@{
+  /**
+   * Return the offsets and connectivity arrays, switching to vtkIdType
+   * storage if needed. They may be modified directly (for instance filled in
+   * parallel after AllocateExact()) as long as they remain consistent.
+   */
+  vtkIdTypeArray* GetOffsetsArray();
+  vtkIdTypeArray* GetConnectivityArray();
+  //@}
+
   /**
    * Perform a deep copy (no reference counting) of the given cell array.
    */
   void DeepCopy(vtkCellArray *ca);
 
   /**
-   * Return the underlying data as a data array.
+   * Return the cells in the legacy (npts, ids...) form. The first call
+   * converts the storage to that array, which then holds the cells until
+   * the storage is switched back (see the class description), so it must
+   * not run while other threads read the cells. The point ids may be
+   * modified directly; announce other changes with WritePointer() or
+   * SetCells(). Use ExportLegacyFormat() to get a copy instead.
    */
-  vtkIdTypeArray* GetData()
-    {return this->Ia;}
+  vtkIdTypeArray* GetData();
+
+  /**
+   * Fill data with the legacy (npts, ids...) representation of the cells.
+   */
+  void ExportLegacyFormat(vtkIdTypeArray* data);
+
+  /**
+   * Replace the cells by the ones described by the legacy (npts, ids...)
+   * array data, which is copied.
+   */
+  void ImportLegacyFormat(vtkIdTypeArray* data);
+
+  /**
+   * Return true if the offsets and connectivity are stored as 32-bit
+   * integers.
+   */
+  bool IsStorage32Bit()
+    {return this->Storage.load(std::memory_order_acquire) == Storage32Bit;}
+
+  /**
+   * Return true if all the offsets and point ids fit in 32-bit integers.
+   */
+  bool CanConvertTo32BitStorage();
+
+  /**
+   * Store the offsets and connectivity as 32-bit integers, see the class
+   * description. Returns false, and leaves the storage unchanged, if they
+   * do not fit. The cells must not be accessed concurrently.
+   */
+  bool ConvertTo32BitStorage();
+
+  /**
+   * Store the offsets and connectivity as vtkIdType, the default. The cells
+   * must not be accessed concurrently.
+   */
+  void ConvertTo64BitStorage();
 
   /**
    * Reuse list. Reset to initial condition.
@@ -266,8 +468,7 @@ public:
   /**
    * Reclaim any extra memory.
    */
-  void Squeeze()
-    {this->Ia->Squeeze();}
+  void Squeeze();
 
   /**
    * Return the memory in kibibytes (1024 bytes) consumed by this cell array. Used to
@@ -283,10 +484,81 @@ protected:
   vtkCellArray();
   ~vtkCellArray() override;
 
+  enum StorageTypes
+  {
+    // Offsets and Connectivity hold the cells.
+    Storage64Bit = 0,
+    // Offsets32 and Connectivity32 hold the cells. Connectivity holds a
+    // vtkIdType copy of the point ids once ConnectivityCopied is set.
+    Storage32Bit = 1,
+    // LegacyData holds the cells, LegacyLocations the location of each one.
+    StorageLegacy = 2,
+    // LegacyData holds NumberOfCells cells written directly, the locations
+    // are rebuilt on next access.
+    StorageLegacyUnindexed = 3
+  };
+
+  // Make the cells readable, indexing the legacy array if needed, and return
+  // the storage. Thread safe.
+  int PrepareForRead()
+  {
+    int storage = this->Storage.load(std::memory_order_acquire);
+    if (storage == StorageLegacyUnindexed)
+    {
+      storage = this->BuildLegacyLocations();
+    }
+    return storage;
+  }
+
+  // Same as PrepareForRead(), and also make the vtkIdType copy of a 32-bit
+  // connectivity, for the methods returning pointers to the point ids.
+  int PrepareForPointerRead()
+  {
+    int storage = this->PrepareForRead();
+    if (storage == Storage32Bit &&
+        !this->ConnectivityCopied.load(std::memory_order_acquire))
+    {
+      this->CopyConnectivity();
+    }
+    return storage;
+  }
+
+  int BuildLegacyLocations();
+  void CopyConnectivity();
+
+  // Release the arrays of the other storages and switch to storage.
+  void SetStorage(int storage);
+
+  // Insertion and modification for the 32-bit and legacy storages.
+  vtkIdType InsertNextCellSlow(vtkIdType npts, const vtkIdType pts[]);
+  vtkIdType InsertNextCellSlow(int npts);
+  void InsertCellPointSlow(vtkIdType id);
+  void UpdateCellCountSlow(int npts);
+  void ReplaceCellAtIdSlow(vtkIdType cellId, vtkIdType npts,
+                           const vtkIdType pts[]);
+  void ReverseCellAtIdSlow(vtkIdType cellId);
+
+  // Convert a location in the legacy representation to a cell id.
+  vtkIdType GetCellIdFromLocation(vtkIdType loc);
+
+  vtkIdTypeArray* Offsets;
+  vtkIdTypeArray* Connectivity;
+  vtkTypeInt32Array* Offsets32;
+  vtkTypeInt32Array* Connectivity32;
+  vtkIdTypeArray* LegacyData;
+  vtkIdTypeArray* LegacyLocations;
+  vtkIdType TraversalCellId;
+
+  // Number of cells of LegacyData while it is not indexed, -1 to index the
+  // whole array.
   vtkIdType NumberOfCells;
-  vtkIdType InsertLocation;     //keep track of current insertion point
-  vtkIdType TraversalLocation;   //keep track of traversal position
-  vtkIdTypeArray *Ia;
+  std::atomic<int> Storage;
+  std::atomic<bool> ConnectivityCopied;
+  std::mutex StorageLock;
+
+  // For InsertNextCells().
+  std::mutex InsertLock;
+  std::atomic<int> PendingInserts;
 
 private:
   vtkCellArray(const vtkCellArray&) = delete;
@@ -294,43 +566,191 @@ private:
 };
 
 
+//----------------------------------------------------------------------------
+inline vtkIdType vtkCellArray::GetNumberOfCells()
+{
+  switch (this->Storage.load(std::memory_order_acquire))
+  {
+    case Storage32Bit:
+      return this->Offsets32->GetMaxId();
+    case StorageLegacy:
+      return this->LegacyLocations->GetMaxId() + 1;
+    case StorageLegacyUnindexed:
+      return this->NumberOfCells;
+    default:
+      return this->Offsets->GetMaxId();
+  }
+}
+
+//----------------------------------------------------------------------------
+inline vtkIdType vtkCellArray::GetNumberOfConnectivityIds()
+{
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+      return this->Connectivity32->GetMaxId() + 1;
+    case StorageLegacy:
+      return this->LegacyData->GetMaxId() + 1 -
+        (this->LegacyLocations->GetMaxId() + 1);
+    default:
+      return this->Connectivity->GetMaxId() + 1;
+  }
+}
+
+//----------------------------------------------------------------------------
+inline vtkIdType vtkCellArray::GetNumberOfConnectivityEntries()
+{
+  switch (this->Storage.load(std::memory_order_acquire))
+  {
+    case Storage32Bit:
+      return this->Connectivity32->GetMaxId() + 1 +
+        this->Offsets32->GetMaxId();
+    case StorageLegacy: case StorageLegacyUnindexed:
+      return this->LegacyData->GetMaxId() + 1;
+    default:
+      return this->Connectivity->GetMaxId() + 1 + this->Offsets->GetMaxId();
+  }
+}
+
+//----------------------------------------------------------------------------
+inline vtkIdType vtkCellArray::GetCellSize(vtkIdType cellId)
+{
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+    {
+      const vtkTypeInt32* offsets = this->Offsets32->GetPointer(cellId);
+      return offsets[1] - offsets[0];
+    }
+    case StorageLegacy:
+      return this->LegacyData->GetValue(
+        this->LegacyLocations->GetValue(cellId));
+    default:
+    {
+      const vtkIdType* offsets = this->Offsets->GetPointer(cellId);
+      return offsets[1] - offsets[0];
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+inline vtkIdType vtkCellArray::GetLocationFromCellId(vtkIdType cellId)
+{
+  switch (this->PrepareForRead())
+  {
+    case Storage32Bit:
+      return this->Offsets32->GetValue(cellId) + cellId;
+    case StorageLegacy:
+      return cellId <= this->LegacyLocations->GetMaxId() ?
+        this->LegacyLocations->GetValue(cellId) :
+        this->LegacyData->GetMaxId() + 1;
+    default:
+      return this->Offsets->GetValue(cellId) + cellId;
+  }
+}
+
+//----------------------------------------------------------------------------
+inline void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                                      vtkIdType* &pts)
+{
+  switch (this->PrepareForPointerRead())
+  {
+    case Storage32Bit:
+    {
+      const vtkTypeInt32* offsets = this->Offsets32->GetPointer(cellId);
+      npts = offsets[1] - offsets[0];
+      pts = this->Connectivity->GetPointer(offsets[0]);
+      break;
+    }
+    case StorageLegacy:
+    {
+      vtkIdType* cell = this->LegacyData->GetPointer(
+        this->LegacyLocations->GetValue(cellId));
+      npts = *cell;
+      pts = cell + 1;
+      break;
+    }
+    default:
+    {
+      const vtkIdType* offsets = this->Offsets->GetPointer(cellId);
+      npts = offsets[1] - offsets[0];
+      pts = this->Connectivity->GetPointer(offsets[0]);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+inline void vtkCellArray::GetCellAtId(vtkIdType cellId, vtkIdType &npts,
+                                      const vtkIdType* &pts,
+                                      vtkIdList* ptIds)
+{
+  if (this->PrepareForRead() == Storage32Bit &&
+      !this->ConnectivityCopied.load(std::memory_order_acquire))
+  {
+    this->GetCellAtId(cellId, ptIds);
+    npts = ptIds->GetNumberOfIds();
+    pts = ptIds->GetPointer(0);
+    return;
+  }
+  vtkIdType* cellPts;
+  this->GetCellAtId(cellId, npts, cellPts);
+  pts = cellPts;
+}
+
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(vtkIdType npts,
                                               const vtkIdType pts[]) VTK_SIZEHINT(pts, npts)
 {
-  vtkIdType i = this->Ia->GetMaxId() + 1;
-  vtkIdType *ptr = this->Ia->WritePointer(i, npts+1);
+  if (this->Storage.load(std::memory_order_relaxed) != Storage64Bit)
+  {
+    return this->InsertNextCellSlow(npts, pts);
+  }
+  vtkIdType i = this->Connectivity->GetMaxId() + 1;
+  vtkIdType *ptr = this->Connectivity->WritePointer(i, npts);
 
-  for ( *ptr++ = npts, i = 0; i < npts; i++)
+  for (vtkIdType j = 0; j < npts; j++)
   {
     *ptr++ = *pts++;
   }
 
-  this->NumberOfCells++;
-  this->InsertLocation += npts + 1;
-
-  return this->NumberOfCells - 1;
+  return this->Offsets->InsertNextValue(i + npts) - 1;
 }
 
 //----------------------------------------------------------------------------
 inline vtkIdType vtkCellArray::InsertNextCell(int npts)
 {
-  this->InsertLocation = this->Ia->InsertNextValue(npts) + 1;
-  this->NumberOfCells++;
-
-  return this->NumberOfCells - 1;
+  if (this->Storage.load(std::memory_order_relaxed) != Storage64Bit)
+  {
+    return this->InsertNextCellSlow(npts);
+  }
+  // The cell is empty until points are added with InsertCellPoint().
+  return this->Offsets->InsertNextValue(this->Connectivity->GetMaxId() + 1) - 1;
 }
 
 //----------------------------------------------------------------------------
 inline void vtkCellArray::InsertCellPoint(vtkIdType id)
 {
-  this->Ia->InsertValue(this->InsertLocation++, id);
+  if (this->Storage.load(std::memory_order_relaxed) != Storage64Bit)
+  {
+    this->InsertCellPointSlow(id);
+    return;
+  }
+  vtkIdType size = this->Connectivity->InsertNextValue(id) + 1;
+  this->Offsets->SetValue(this->Offsets->GetMaxId(), size);
 }
 
 //----------------------------------------------------------------------------
 inline void vtkCellArray::UpdateCellCount(int npts)
 {
-  this->Ia->SetValue(this->InsertLocation-npts-1, npts);
+  if (this->Storage.load(std::memory_order_relaxed) != Storage64Bit)
+  {
+    this->UpdateCellCountSlow(npts);
+    return;
+  }
+  vtkIdType lastCell = this->Offsets->GetMaxId();
+  vtkIdType size = this->Offsets->GetValue(lastCell - 1) + npts;
+  this->Connectivity->SetNumberOfValues(size);
+  this->Offsets->SetValue(lastCell, size);
 }
 
 //----------------------------------------------------------------------------
@@ -346,24 +766,14 @@ inline vtkIdType vtkCellArray::InsertNextCell(vtkCell *cell)
                               cell->PointIds->GetPointer(0));
 }
 
-//----------------------------------------------------------------------------
-inline void vtkCellArray::Reset()
-{
-  this->NumberOfCells = 0;
-  this->InsertLocation = 0;
-  this->TraversalLocation = 0;
-  this->Ia->Reset();
-}
-
 //----------------------------------------------------------------------------
 inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 {
-  if ( this->Ia->GetMaxId() >= 0 &&
-       this->TraversalLocation <= this->Ia->GetMaxId() )
+  this->PrepareForRead();
+  if (this->TraversalCellId >= 0 &&
+      this->TraversalCellId < this->GetNumberOfCells())
   {
-    npts = this->Ia->GetValue(this->TraversalLocation++);
-    pts = this->Ia->GetPointer(this->TraversalLocation);
-    this->TraversalLocation += npts;
+    this->GetCellAtId(this->TraversalCellId++, npts, pts);
     return 1;
   }
   npts=0;
@@ -375,44 +785,55 @@ inline int vtkCellArray::GetNextCell(vtkIdType& npts, vtkIdType* &pts)
 inline void vtkCellArray::GetCell(vtkIdType loc, vtkIdType &npts,
                                   vtkIdType* &pts)
 {
-  npts = this->Ia->GetValue(loc++);
-  pts  = this->Ia->GetPointer(loc);
+  this->GetCellAtId(this->GetCellIdFromLocation(loc), npts, pts);
 }
 
 //----------------------------------------------------------------------------
-inline void vtkCellArray::ReverseCell(vtkIdType loc)
+inline void vtkCellArray::ReverseCellAtId(vtkIdType cellId)
 {
-  int i;
-  vtkIdType tmp;
-  vtkIdType npts=this->Ia->GetValue(loc);
-  vtkIdType *pts=this->Ia->GetPointer(loc+1);
-  for (i=0; i < (npts/2); i++)
+  if (this->Storage.load(std::memory_order_relaxed) != Storage64Bit)
+  {
+    this->ReverseCellAtIdSlow(cellId);
+    return;
+  }
+  vtkIdType npts, *pts;
+  this->GetCellAtId(cellId, npts, pts);
+  for (vtkIdType i=0; i < (npts/2); i++)
   {
-    tmp = pts[i];
+    vtkIdType tmp = pts[i];
     pts[i] = pts[npts-i-1];
     pts[npts-i-1] = tmp;
   }
 }
 
 //----------------------------------------------------------------------------
-inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
-                                      const vtkIdType pts[])
+inline void vtkCellArray::ReverseCell(vtkIdType loc)
+{
+  this->ReverseCellAtId(this->GetCellIdFromLocation(loc));
+}
+
+//----------------------------------------------------------------------------
+inline void vtkCellArray::ReplaceCellAtId(vtkIdType cellId, vtkIdType npts,
+                                          const vtkIdType pts[])
 {
-  vtkIdType *oldPts=this->Ia->GetPointer(loc+1);
-  for (int i=0; i < npts; i++)
+  if (this->Storage.load(std::memory_order_relaxed) != Storage64Bit)
+  {
+    this->ReplaceCellAtIdSlow(cellId, npts, pts);
+    return;
+  }
+  vtkIdType oldNpts, *oldPts;
+  this->GetCellAtId(cellId, oldNpts, oldPts);
+  for (vtkIdType i=0; i < npts; i++)
   {
     oldPts[i] = pts[i];
   }
 }
 
 //----------------------------------------------------------------------------
-inline vtkIdType *vtkCellArray::WritePointer(const vtkIdType ncells,
-                                             const vtkIdType size)
+inline void vtkCellArray::ReplaceCell(vtkIdType loc, int npts,
+                                      const vtkIdType pts[])
 {
-  this->NumberOfCells = ncells;
-  this->InsertLocation = size;
-  this->TraversalLocation = 0;
-  return this->Ia->WritePointer(0,size);
+  this->ReplaceCellAtId(this->GetCellIdFromLocation(loc), npts, pts);
 }
 
 #endif
@@ -16,12 +16,120 @@
 
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
-#include "vtkGenericCell.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
 
 vtkStandardNewMacro(vtkCellLinks);
 
+namespace
+{
+
+// Accessors to the points of the cells, safe to call from several threads.
+// A 32-bit connectivity is read into the thread's ptIds.
+struct vtkCellArrayPoints
+{
+  vtkCellArray *Cells;
+  void operator()(vtkIdType cellId, vtkIdType &npts, const vtkIdType* &pts,
+                  vtkIdList *ptIds)
+  {
+    this->Cells->GetCellAtId(cellId, npts, pts, ptIds);
+  }
+};
+
+struct vtkPolyDataPoints
+{
+  vtkPolyData *PolyData;
+  void operator()(vtkIdType cellId, vtkIdType &npts, const vtkIdType* &pts,
+                  vtkIdList *ptIds)
+  {
+    this->PolyData->GetCellPoints(cellId, npts, pts, ptIds);
+  }
+};
+
+// Count the number of uses of each point.
+template <typename TPoints>
+struct vtkCountLinks
+{
+  TPoints Points;
+  std::atomic<vtkIdType> *Counts;
+  vtkSMPThreadLocalObject<vtkIdList> *PtIds;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PtIds->Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->Points(cellId, npts, pts, ptIds);
+      for (vtkIdType j=0; j < npts; ++j)
+      {
+        this->Counts[pts[j]].fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+  }
+};
+
+// Scatter the cell ids in the lists. The counts are consumed to find the
+// position of each id, so the lists are filled in no particular order.
+template <typename TPoints>
+struct vtkFillLinks
+{
+  TPoints Points;
+  std::atomic<vtkIdType> *Counts;
+  const vtkIdType *Offsets;
+  vtkIdType *Links;
+  vtkSMPThreadLocalObject<vtkIdList> *PtIds;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId)
+  {
+    vtkIdList *ptIds = this->PtIds->Local();
+    vtkIdType npts;
+    const vtkIdType *pts;
+    for ( ; cellId < endCellId; ++cellId )
+    {
+      this->Points(cellId, npts, pts, ptIds);
+      for (vtkIdType j=0; j < npts; ++j)
+      {
+        vtkIdType pos = this->Counts[pts[j]].fetch_sub(1,
+          std::memory_order_relaxed) - 1;
+        this->Links[this->Offsets[pts[j]] + pos] = cellId;
+      }
+    }
+  }
+};
+
+// Sort each list so that the result does not depend on the scheduling,
+// and point the links to their list.
+struct vtkSortLinks
+{
+  const vtkIdType *Offsets;
+  vtkIdType *Links;
+  vtkCellLinks::Link *Array;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    for ( ; ptId < endPtId; ++ptId )
+    {
+      vtkIdType *cells = this->Links + this->Offsets[ptId];
+      vtkIdType ncells = this->Offsets[ptId+1] - this->Offsets[ptId];
+      std::sort(cells, cells + ncells);
+      this->Array[ptId].ncells = static_cast<unsigned short>(ncells);
+      this->Array[ptId].cells = cells;
+    }
+  }
+};
+
+}
+
 //----------------------------------------------------------------------------
 vtkCellLinks::~vtkCellLinks()
 {
@@ -33,14 +141,20 @@ void vtkCellLinks::Initialize()
 {
   if ( this->Array != nullptr )
   {
-    for (vtkIdType i=0; i<=this->MaxId; i++)
+    if ( this->StaticLinks == nullptr )
     {
-      delete [] this->Array[i].cells;
+      for (vtkIdType i=0; i<=this->MaxId; i++)
+      {
+        delete [] this->Array[i].cells;
+      }
     }
 
     delete [] this->Array;
     this->Array = nullptr;
   }
+  delete [] this->StaticLinks;
+  this->StaticLinks = nullptr;
+  this->StaticLinksSize = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -48,8 +162,8 @@ void vtkCellLinks::Allocate(vtkIdType sz, vtkIdType ext)
 {
   static vtkCellLinks::Link linkInit = {0,nullptr};
 
+  this->Initialize();
   this->Size = sz;
-  delete [] this->Array;
   this->Array = new vtkCellLinks::Link[sz];
   this->Extend = ext;
   this->MaxId = -1;
@@ -70,6 +184,31 @@ void vtkCellLinks::AllocateLinks(vtkIdType n)
   }
 }
 
+//----------------------------------------------------------------------------
+// Copy the lists out of the contiguous storage built by BuildLinks(). The
+// lists past MaxId (after Reset()) are dropped.
+void vtkCellLinks::AllocateIncrementalLinks()
+{
+  for (vtkIdType i=0; i < this->Size; i++)
+  {
+    if ( i <= this->MaxId )
+    {
+      vtkIdType *cells = new vtkIdType[this->Array[i].ncells];
+      std::copy(this->Array[i].cells,
+                this->Array[i].cells + this->Array[i].ncells, cells);
+      this->Array[i].cells = cells;
+    }
+    else
+    {
+      this->Array[i].ncells = 0;
+      this->Array[i].cells = nullptr;
+    }
+  }
+  delete [] this->StaticLinks;
+  this->StaticLinks = nullptr;
+  this->StaticLinksSize = 0;
+}
+
 //----------------------------------------------------------------------------
 // Reclaim any unused memory.
 void vtkCellLinks::Squeeze()
@@ -123,126 +262,92 @@ vtkCellLinks::Link *vtkCellLinks::Resize(vtkIdType sz)
   return this->Array;
 }
 
+//----------------------------------------------------------------------------
+// The links are built in parallel in three passes: the uses of each point are
+// counted, the counts are turned into offsets into a single array, and the
+// cell ids are scattered to the lists.
+template <typename TPoints>
+void vtkCellLinks::BuildStaticLinks(vtkIdType numPts, vtkIdType numCells,
+                                    TPoints points)
+{
+  this->Allocate(std::max(this->Size, numPts), this->Extend);
+  if ( numPts < 1 )
+  {
+    return;
+  }
+
+  std::unique_ptr<std::atomic<vtkIdType>[]> counts(
+    new std::atomic<vtkIdType>[numPts]());
+  vtkSMPThreadLocalObject<vtkIdList> ptIds;
+  vtkCountLinks<TPoints> count = { points, counts.get(), &ptIds };
+  vtkSMPTools::For(0, numCells, count);
+
+  std::unique_ptr<vtkIdType[]> offsets(new vtkIdType[numPts+1]);
+  vtkSMPTools::ExclusiveScan(counts.get(), counts.get() + numPts,
+                             offsets.get(), vtkIdType(0));
+  offsets[numPts] = offsets[numPts-1] + counts[numPts-1];
+
+  this->StaticLinksSize = offsets[numPts];
+  this->StaticLinks = new vtkIdType[this->StaticLinksSize];
+  vtkFillLinks<TPoints> fill =
+    { points, counts.get(), offsets.get(), this->StaticLinks, &ptIds };
+  vtkSMPTools::For(0, numCells, fill);
+
+  vtkSortLinks sort = { offsets.get(), this->StaticLinks, this->Array };
+  vtkSMPTools::For(0, numPts, sort);
+  this->MaxId = numPts - 1;
+}
+
 //----------------------------------------------------------------------------
 // Build the link list array.
 void vtkCellLinks::BuildLinks(vtkDataSet *data)
 {
   vtkIdType numPts = data->GetNumberOfPoints();
   vtkIdType numCells = data->GetNumberOfCells();
-  int j;
-  vtkIdType cellId;
-  unsigned short *linkLoc;
-
-  // fill out lists with number of references to cells
-  linkLoc = new unsigned short[numPts];
-  memset(linkLoc, 0, numPts*sizeof(unsigned short));
 
   // Use fast path if polydata
   if ( data->GetDataObjectType() == VTK_POLY_DATA )
   {
-    vtkIdType *pts, npts;
-
     vtkPolyData *pdata = static_cast<vtkPolyData *>(data);
-    // traverse data to determine number of uses of each point
-    for (cellId=0; cellId < numCells; cellId++)
+    if ( numCells > 0 )
     {
-      pdata->GetCellPoints(cellId, npts, pts);
-      for (j=0; j < npts; j++)
-      {
-        this->IncrementLinkCount(pts[j]);
-      }
-    }
-
-    // now allocate storage for the links
-    this->AllocateLinks(numPts);
-    this->MaxId = numPts - 1;
-
-    for (cellId=0; cellId < numCells; cellId++)
-    {
-      pdata->GetCellPoints(cellId, npts, pts);
-      for (j=0; j < npts; j++)
-      {
-        this->InsertCellReference(pts[j], (linkLoc[pts[j]])++, cellId);
-      }
+      // Make sure the cells are built before the threads access them.
+      vtkNew<vtkIdList> ptIds;
+      pdata->GetCellPoints(0, ptIds);
     }
+    vtkPolyDataPoints points = { pdata };
+    this->BuildStaticLinks(numPts, numCells, points);
   }
 
   else //any other type of dataset
   {
-    vtkIdType numberOfPoints, ptId;
-    vtkGenericCell *cell=vtkGenericCell::New();
-
-    // traverse data to determine number of uses of each point
-    for (cellId=0; cellId < numCells; cellId++)
+    // Gather the cells serially since the dataset may not support concurrent
+    // access.
+    vtkNew<vtkCellArray> cells;
+    vtkNew<vtkIdList> ptIds;
+    cells->Allocate(numCells * data->GetMaxCellSize() + numCells);
+    for (vtkIdType cellId=0; cellId < numCells; cellId++)
     {
-      data->GetCell(cellId,cell);
-      numberOfPoints = cell->GetNumberOfPoints();
-      for (j=0; j < numberOfPoints; j++)
-      {
-        this->IncrementLinkCount(cell->PointIds->GetId(j));
-      }
+      data->GetCellPoints(cellId, ptIds);
+      cells->InsertNextCell(ptIds);
     }
-
-    // now allocate storage for the links
-    this->AllocateLinks(numPts);
-    this->MaxId = numPts - 1;
-
-    for (cellId=0; cellId < numCells; cellId++)
-    {
-      data->GetCell(cellId,cell);
-      numberOfPoints = cell->GetNumberOfPoints();
-      for (j=0; j < numberOfPoints; j++)
-      {
-        ptId = cell->PointIds->GetId(j);
-        this->InsertCellReference(ptId, (linkLoc[ptId])++, cellId);
-      }
-    }
-    cell->Delete();
-  }//end else
-
-  delete [] linkLoc;
+    vtkCellArrayPoints points = { cells };
+    this->BuildStaticLinks(numPts, numCells, points);
+  }
 }
 
 //----------------------------------------------------------------------------
 // Build the link list array.
 void vtkCellLinks::BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity)
 {
-  vtkIdType numPts = data->GetNumberOfPoints();
-  vtkIdType j, cellId;
-  unsigned short *linkLoc;
-  vtkIdType npts=0;
-  vtkIdType *pts=nullptr;
-  vtkIdType loc = Connectivity->GetTraversalLocation();
-
-  // traverse data to determine number of uses of each point
-  for (Connectivity->InitTraversal();
-       Connectivity->GetNextCell(npts,pts);)
+  vtkIdType numCells = Connectivity ? Connectivity->GetNumberOfCells() : 0;
+  if ( numCells > 0 )
   {
-    for (j=0; j < npts; j++)
-    {
-      this->IncrementLinkCount(pts[j]);
-    }
+    // Import modified legacy data before the threads access the cells.
+    Connectivity->GetCellSize(0);
   }
-
-  // now allocate storage for the links
-  this->AllocateLinks(numPts);
-  this->MaxId = numPts - 1;
-
-  // fill out lists with references to cells
-  linkLoc = new unsigned short[numPts];
-  memset(linkLoc, 0, numPts*sizeof(unsigned short));
-
-  cellId = 0;
-  for (Connectivity->InitTraversal();
-       Connectivity->GetNextCell(npts,pts); cellId++)
-  {
-    for (j=0; j < npts; j++)
-    {
-      this->InsertCellReference(pts[j], (linkLoc[pts[j]])++, cellId);
-    }
-  }
-  delete [] linkLoc;
-  Connectivity->SetTraversalLocation(loc);
+  vtkCellArrayPoints points = { Connectivity };
+  this->BuildStaticLinks(data->GetNumberOfPoints(), numCells, points);
 }
 
 //----------------------------------------------------------------------------
@@ -250,6 +355,7 @@ void vtkCellLinks::BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity)
 // is the initial size of the list.
 vtkIdType vtkCellLinks::InsertNextPoint(int numLinks)
 {
+  this->ReleaseStaticLinks();
   if ( ++this->MaxId >= this->Size )
   {
     this->Resize(this->MaxId + 1);
@@ -281,6 +387,36 @@ void vtkCellLinks::DeepCopy(vtkCellLinks *src)
   this->Allocate(src->Size, src->Extend);
   memcpy(this->Array, src->Array, this->Size * sizeof(vtkCellLinks::Link));
   this->MaxId = src->MaxId;
+
+  // The lists are owned by src, copy them.
+  if ( src->StaticLinks )
+  {
+    this->StaticLinksSize = src->StaticLinksSize;
+    this->StaticLinks = new vtkIdType[this->StaticLinksSize];
+    std::copy(src->StaticLinks, src->StaticLinks + src->StaticLinksSize,
+              this->StaticLinks);
+    for (vtkIdType i=0; i < this->Size; i++)
+    {
+      if ( this->Array[i].cells )
+      {
+        this->Array[i].cells = this->StaticLinks +
+          (src->Array[i].cells - src->StaticLinks);
+      }
+    }
+  }
+  else
+  {
+    for (vtkIdType i=0; i <= this->MaxId; i++)
+    {
+      if ( src->Array[i].cells )
+      {
+        this->Array[i].cells = new vtkIdType[src->Array[i].ncells];
+        std::copy(src->Array[i].cells,
+                  src->Array[i].cells + src->Array[i].ncells,
+                  this->Array[i].cells);
+      }
+    }
+  }
 }
 
 //----------------------------------------------------------------------------
@@ -291,4 +427,5 @@ void vtkCellLinks::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Size: " << this->Size << "\n";
   os << indent << "MaxId: " << this->MaxId << "\n";
   os << indent << "Extend: " << this->Extend << "\n";
+  os << indent << "Static: " << (this->StaticLinks != nullptr) << "\n";
 }
@@ -22,6 +22,14 @@
  * using the point. The information provided by this object can be used to
  * determine neighbors and construct other local topological information.
  *
+ * BuildLinks() constructs the links in parallel (see vtkSMPTools): the uses
+ * of each point are counted, a prefix sum gives the position of each list
+ * in a single contiguous array, and the lists are filled. The cell ids of
+ * each list are sorted. The lists are moved to individually allocated
+ * storage, which supports incremental editing, the first time a method
+ * changing their size is called (InsertNextPoint(), DeletePoint() or
+ * ResizeCellList()).
+ *
  * @warning
  * Note that this class is designed to support incremental link construction.
  * More efficient cell links structures can be built with vtkStaticCellLinks
@@ -71,6 +79,12 @@ public:
    */
   void BuildLinks(vtkDataSet *data, vtkCellArray *Connectivity);
 
+  /**
+   * Return true if the lists of cell ids are stored in the contiguous array
+   * built by BuildLinks(), false if they are individually allocated.
+   */
+  bool IsStatic() { return this->StaticLinks != nullptr; }
+
   /**
    * Allocate the specified number of links (i.e., number of points) that
    * will be built.
@@ -162,9 +176,30 @@ public:
   void DeepCopy(vtkCellLinks *src);
 
 protected:
-  vtkCellLinks():Array(nullptr),Size(0),MaxId(-1),Extend(1000) {}
+  vtkCellLinks():Array(nullptr),Size(0),MaxId(-1),Extend(1000),
+    StaticLinks(nullptr),StaticLinksSize(0) {}
   ~vtkCellLinks() override;
 
+  /**
+   * Move the lists of cell ids out of the contiguous array built by
+   * BuildLinks() so that they can be resized individually.
+   */
+  void ReleaseStaticLinks()
+  {
+    if ( this->StaticLinks )
+    {
+      this->AllocateIncrementalLinks();
+    }
+  }
+  void AllocateIncrementalLinks();
+
+  /**
+   * Build the links in parallel into the contiguous storage. The functor
+   * returns the points of a cell given its id.
+   */
+  template <typename TPoints>
+  void BuildStaticLinks(vtkIdType numPts, vtkIdType numCells, TPoints points);
+
   /**
    * Increment the count of the number of cells using the point.
    */
@@ -184,6 +219,10 @@ protected:
   vtkIdType Extend;     // grow array by this point
   Link *Resize(vtkIdType sz);  // function to resize data
 
+  // Contiguous storage of the lists built by BuildLinks(), or nullptr.
+  vtkIdType *StaticLinks;
+  vtkIdType StaticLinksSize;
+
 private:
   vtkCellLinks(const vtkCellLinks&) = delete;
   void operator=(const vtkCellLinks&) = delete;
@@ -200,6 +239,7 @@ inline void vtkCellLinks::InsertCellReference(vtkIdType ptId,
 //----------------------------------------------------------------------------
 inline void vtkCellLinks::DeletePoint(vtkIdType ptId)
 {
+  this->ReleaseStaticLinks();
   this->Array[ptId].ncells = 0;
   delete [] this->Array[ptId].cells;
   this->Array[ptId].cells = nullptr;
@@ -244,6 +284,7 @@ inline void vtkCellLinks::ResizeCellList(vtkIdType ptId, int size)
   int newSize;
   vtkIdType *cells;
 
+  this->ReleaseStaticLinks();
   newSize = this->Array[ptId].ncells + size;
   cells = new vtkIdType[newSize];
   memcpy(cells, this->Array[ptId].cells,
@@ -28,6 +28,7 @@
 #include "vtkLongArray.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkShortArray.h"
 #include "vtkStructuredExtent.h"
 #include "vtkUnsignedCharArray.h"
@@ -528,6 +529,101 @@ struct CopyStructuredDataWorker
   }
 };
 
+// Copy the tuples FromIds[i] of src to the tuples DstStart + i of dest.
+template <typename Array1T, typename Array2T>
+struct GatherTuplesFunctor
+{
+  Array1T *Dest;
+  Array2T *Src;
+  const vtkIdType *FromIds;
+  vtkIdType DstStart;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkDataArrayAccessor<Array1T> d(this->Dest);
+    vtkDataArrayAccessor<Array2T> s(this->Src);
+    const int numComps = this->Dest->GetNumberOfComponents();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType inTupleIdx = this->FromIds[i];
+      const vtkIdType outTupleIdx = this->DstStart + i;
+      for (int comp = 0; comp < numComps; ++comp)
+      {
+        d.Set(outTupleIdx, comp, s.Get(inTupleIdx, comp));
+      }
+    }
+  }
+};
+
+struct GatherTuplesWorker
+{
+  const vtkIdType *FromIds;
+  vtkIdType NumberOfIds;
+  vtkIdType DstStart;
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T *dest, Array2T *src)
+  {
+    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
+    GatherTuplesFunctor<Array1T, Array2T> functor =
+      { dest, src, this->FromIds, this->DstStart };
+    vtkSMPTools::For(0, this->NumberOfIds, functor);
+    dest->DataChanged();
+  }
+};
+
+// Interpolate the tuple DstStart + i of dest between the tuples Edges[2*i]
+// and Edges[2*i+1] of src, as vtkGenericDataArray::InterpolateTuple() does.
+template <typename Array1T, typename Array2T>
+struct InterpolateEdgesFunctor
+{
+  Array1T *Dest;
+  Array2T *Src;
+  const vtkIdType *Edges;
+  const double *T;
+  vtkIdType DstStart;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    typedef typename vtkDataArrayAccessor<Array1T>::APIType ValueType;
+    vtkDataArrayAccessor<Array1T> d(this->Dest);
+    vtkDataArrayAccessor<Array2T> s(this->Src);
+    const int numComps = this->Dest->GetNumberOfComponents();
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType p1 = this->Edges[2 * i];
+      const vtkIdType p2 = this->Edges[2 * i + 1];
+      const double t = this->T[i];
+      const double oneMinusT = 1. - t;
+      for (int comp = 0; comp < numComps; ++comp)
+      {
+        double val = s.Get(p1, comp) * oneMinusT + s.Get(p2, comp) * t;
+        ValueType valT;
+        vtkMath::RoundDoubleToIntegralIfNecessary(val, &valT);
+        d.Set(this->DstStart + i, comp, valT);
+      }
+    }
+  }
+};
+
+struct InterpolateEdgesWorker
+{
+  const vtkIdType *Edges;
+  const double *T;
+  vtkIdType NumberOfEdges;
+  vtkIdType DstStart;
+
+  template <typename Array1T, typename Array2T>
+  void operator()(Array1T *dest, Array2T *src)
+  {
+    VTK_ASSUME(src->GetNumberOfComponents() == dest->GetNumberOfComponents());
+    InterpolateEdgesFunctor<Array1T, Array2T> functor =
+      { dest, src, this->Edges, this->T, this->DstStart };
+    vtkSMPTools::For(0, this->NumberOfEdges, functor);
+    dest->DataChanged();
+  }
+};
+
 } // end anon namespace
 
 //----------------------------------------------------------------------------
@@ -868,6 +964,77 @@ void vtkDataSetAttributes::CopyData(vtkDataSetAttributes *fromPd,
   }
 }
 
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::ParallelCopyData(vtkDataSetAttributes *fromPd,
+                                            const vtkIdType *fromIds,
+                                            vtkIdType n, vtkIdType dstStart)
+{
+  GatherTuplesWorker worker = { fromIds, n, dstStart };
+  for (int i = this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
+       i = this->RequiredArrays.NextIndex())
+  {
+    vtkAbstractArray *fromData = fromPd->Data[i];
+    vtkAbstractArray *toData = this->Data[this->TargetIndices[i]];
+    if (toData->GetNumberOfTuples() < dstStart + n)
+    {
+      toData->SetNumberOfTuples(dstStart + n);
+    }
+    vtkDataArray *inDA = vtkArrayDownCast<vtkDataArray>(fromData);
+    vtkDataArray *outDA = vtkArrayDownCast<vtkDataArray>(toData);
+    if (!inDA || !outDA ||
+        !vtkArrayDispatch::Dispatch2SameValueType::Execute(outDA, inDA, worker))
+    {
+      for (vtkIdType j = 0; j < n; ++j)
+      {
+        toData->SetTuple(dstStart + j, fromIds[j], fromData);
+      }
+    }
+  }
+}
+
+//--------------------------------------------------------------------------
+void vtkDataSetAttributes::ParallelInterpolateEdges(
+  vtkDataSetAttributes *fromPd, const vtkIdType *edges, const double *t,
+  vtkIdType n, vtkIdType dstStart)
+{
+  InterpolateEdgesWorker worker = { edges, t, n, dstStart };
+  for (int i = this->RequiredArrays.BeginIndex(); !this->RequiredArrays.End();
+       i = this->RequiredArrays.NextIndex())
+  {
+    vtkAbstractArray *fromArray = fromPd->Data[i];
+    vtkAbstractArray *toArray = this->Data[this->TargetIndices[i]];
+    if (toArray->GetNumberOfTuples() < dstStart + n)
+    {
+      toArray->SetNumberOfTuples(dstStart + n);
+    }
+
+    // Nearest neighbor interpolation and arrays that cannot be dispatched
+    // are handled serially, as in InterpolateEdge().
+    int attributeIndex = this->IsArrayAnAttribute(this->TargetIndices[i]);
+    if (attributeIndex != -1 &&
+        this->CopyAttributeFlags[INTERPOLATE][attributeIndex] == 2)
+    {
+      for (vtkIdType j = 0; j < n; ++j)
+      {
+        toArray->SetTuple(dstStart + j,
+          t[j] < .5 ? edges[2 * j] : edges[2 * j + 1], fromArray);
+      }
+      continue;
+    }
+    vtkDataArray *fromDA = vtkArrayDownCast<vtkDataArray>(fromArray);
+    vtkDataArray *toDA = vtkArrayDownCast<vtkDataArray>(toArray);
+    if (!fromDA || !toDA ||
+        !vtkArrayDispatch::Dispatch2SameValueType::Execute(toDA, fromDA, worker))
+    {
+      for (vtkIdType j = 0; j < n; ++j)
+      {
+        toArray->InterpolateTuple(dstStart + j, edges[2 * j], fromArray,
+                                  edges[2 * j + 1], fromArray, t[j]);
+      }
+    }
+  }
+}
+
 //--------------------------------------------------------------------------
 void vtkDataSetAttributes::CopyAllocate(vtkDataSetAttributes* pd,
                                         vtkIdType sze, vtkIdType ext,
@@ -473,6 +473,33 @@ public:
   void CopyData(vtkDataSetAttributes *fromPd, vtkIdType dstStart, vtkIdType n,
                 vtkIdType srcStart);
 
+  /**
+   * Copy the tuples fromIds[0], ..., fromIds[n-1] of fromPd to the tuples
+   * dstStart, ..., dstStart+n-1 of this container, following the same rules
+   * as CopyData(). The arrays are first resized to hold at least dstStart+n
+   * tuples, then the data arrays are copied in parallel with vtkSMPTools,
+   * through vtkArrayDispatch. The other arrays (e.g. vtkStringArray or
+   * vtkBitArray) are copied serially. Make sure CopyAllocate() has been
+   * invoked before using this method.
+   */
+  void ParallelCopyData(vtkDataSetAttributes *fromPd, const vtkIdType *fromIds,
+                        vtkIdType n, vtkIdType dstStart = 0);
+
+  /**
+   * Interpolate the data of n edges of fromPd: the tuple dstStart+i of this
+   * container is interpolated between the tuples edges[2*i] and edges[2*i+1]
+   * with the factor t[i], following the same rules as InterpolateEdge(). The
+   * arrays are first resized to hold at least dstStart+n tuples, then the
+   * data arrays are interpolated in parallel with vtkSMPTools, through
+   * vtkArrayDispatch. The other arrays, and the attributes using nearest
+   * neighbor interpolation, are handled serially. Make sure
+   * InterpolateAllocate() or CopyAllocate() has been invoked before using
+   * this method.
+   */
+  void ParallelInterpolateEdges(vtkDataSetAttributes *fromPd,
+                                const vtkIdType *edges, const double *t,
+                                vtkIdType n, vtkIdType dstStart = 0);
+
   //@{
   /**
    * Copy a tuple (or set of tuples) of data from one data array to another.
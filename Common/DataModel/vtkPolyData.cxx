@@ -36,6 +36,8 @@
 
 #include "vtkSmartPointer.h"
 
+#include <algorithm>
+
 vtkStandardNewMacro(vtkPolyData);
 
 //----------------------------------------------------------------------------
@@ -223,7 +225,8 @@ int vtkPolyData::GetCellType(vtkIdType cellId)
 vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
 {
   vtkIdType i, loc;
-  vtkIdType *pts, numPts;
+  const vtkIdType *pts;
+  vtkIdType numPts;
   vtkCell *cell = nullptr;
   unsigned char type;
 
@@ -232,6 +235,9 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
     this->BuildCells();
   }
 
+  // The point ids of the cell are also the scratch list that a 32-bit
+  // connectivity is read into.
+
   type = this->Cells->GetCellType(cellId);
   loc = this->Cells->GetCellLocation(cellId);
 
@@ -243,7 +249,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Vertex = vtkVertex::New();
       }
       cell = this->Vertex;
-      this->Verts->GetCell(loc,numPts,pts);
+      this->Verts->GetCellAtId(loc,numPts,pts,cell->PointIds);
       break;
 
     case VTK_POLY_VERTEX:
@@ -252,7 +258,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->PolyVertex = vtkPolyVertex::New();
       }
       cell = this->PolyVertex;
-      this->Verts->GetCell(loc,numPts,pts);
+      this->Verts->GetCellAtId(loc,numPts,pts,cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -263,7 +269,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Line = vtkLine::New();
       }
       cell = this->Line;
-      this->Lines->GetCell(loc,numPts,pts);
+      this->Lines->GetCellAtId(loc,numPts,pts,cell->PointIds);
       break;
 
     case VTK_POLY_LINE:
@@ -272,7 +278,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->PolyLine = vtkPolyLine::New();
       }
       cell = this->PolyLine;
-      this->Lines->GetCell(loc,numPts,pts);
+      this->Lines->GetCellAtId(loc,numPts,pts,cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -283,7 +289,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Triangle = vtkTriangle::New();
       }
       cell = this->Triangle;
-      this->Polys->GetCell(loc,numPts,pts);
+      this->Polys->GetCellAtId(loc,numPts,pts,cell->PointIds);
       break;
 
     case VTK_QUAD:
@@ -292,7 +298,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Quad = vtkQuad::New();
       }
       cell = this->Quad;
-      this->Polys->GetCell(loc,numPts,pts);
+      this->Polys->GetCellAtId(loc,numPts,pts,cell->PointIds);
       break;
 
     case VTK_POLYGON:
@@ -301,7 +307,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->Polygon = vtkPolygon::New();
       }
       cell = this->Polygon;
-      this->Polys->GetCell(loc,numPts,pts);
+      this->Polys->GetCellAtId(loc,numPts,pts,cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -312,7 +318,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
         this->TriangleStrip = vtkTriangleStrip::New();
       }
       cell = this->TriangleStrip;
-      this->Strips->GetCell(loc,numPts,pts);
+      this->Strips->GetCellAtId(loc,numPts,pts,cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -339,7 +345,7 @@ vtkCell *vtkPolyData::GetCell(vtkIdType cellId)
 void vtkPolyData::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 {
   vtkIdType       i, loc;
-  vtkIdType       *pts=nullptr;
+  const vtkIdType *pts=nullptr;
   vtkIdType       numPts;
   unsigned char   type;
   double           x[3];
@@ -356,48 +362,48 @@ void vtkPolyData::GetCell(vtkIdType cellId, vtkGenericCell *cell)
   {
     case VTK_VERTEX:
       cell->SetCellTypeToVertex();
-      this->Verts->GetCell(loc,numPts,pts);
+      this->Verts->GetCellAtId(loc,numPts,pts,cell->PointIds);
       break;
 
     case VTK_POLY_VERTEX:
       cell->SetCellTypeToPolyVertex();
-      this->Verts->GetCell(loc,numPts,pts);
+      this->Verts->GetCellAtId(loc,numPts,pts,cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_LINE:
       cell->SetCellTypeToLine();
-      this->Lines->GetCell(loc,numPts,pts);
+      this->Lines->GetCellAtId(loc,numPts,pts,cell->PointIds);
       break;
 
     case VTK_POLY_LINE:
       cell->SetCellTypeToPolyLine();
-      this->Lines->GetCell(loc,numPts,pts);
+      this->Lines->GetCellAtId(loc,numPts,pts,cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_TRIANGLE:
       cell->SetCellTypeToTriangle();
-      this->Polys->GetCell(loc,numPts,pts);
+      this->Polys->GetCellAtId(loc,numPts,pts,cell->PointIds);
       break;
 
     case VTK_QUAD:
       cell->SetCellTypeToQuad();
-      this->Polys->GetCell(loc,numPts,pts);
+      this->Polys->GetCellAtId(loc,numPts,pts,cell->PointIds);
       break;
 
     case VTK_POLYGON:
       cell->SetCellTypeToPolygon();
-      this->Polys->GetCell(loc,numPts,pts);
+      this->Polys->GetCellAtId(loc,numPts,pts,cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
 
     case VTK_TRIANGLE_STRIP:
       cell->SetCellTypeToTriangleStrip();
-      this->Strips->GetCell(loc,numPts,pts);
+      this->Strips->GetCellAtId(loc,numPts,pts,cell->PointIds);
       cell->PointIds->SetNumberOfIds(numPts); //reset number of points
       cell->Points->SetNumberOfPoints(numPts);
       break;
@@ -495,7 +501,8 @@ void vtkPolyData::CopyCells(vtkPolyData *pd, vtkIdList *idList,
 void vtkPolyData::GetCellBounds(vtkIdType cellId, double bounds[6])
 {
   vtkIdType i, loc;
-  vtkIdType *pts, numPts;
+  const vtkIdType *pts;
+  vtkIdType numPts;
   unsigned char type;
   double x[3];
 
@@ -507,26 +514,27 @@ void vtkPolyData::GetCellBounds(vtkIdType cellId, double bounds[6])
   type = this->Cells->GetCellType(cellId);
   loc = this->Cells->GetCellLocation(cellId);
 
+  vtkCellArray *cells;
   switch (type)
   {
     case VTK_VERTEX:
     case VTK_POLY_VERTEX:
-      this->Verts->GetCell(loc,numPts,pts);
+      cells = this->Verts;
       break;
 
     case VTK_LINE:
     case VTK_POLY_LINE:
-      this->Lines->GetCell(loc,numPts,pts);
+      cells = this->Lines;
       break;
 
     case VTK_TRIANGLE:
     case VTK_QUAD:
     case VTK_POLYGON:
-      this->Polys->GetCell(loc,numPts,pts);
+      cells = this->Polys;
       break;
 
     case VTK_TRIANGLE_STRIP:
-      this->Strips->GetCell(loc,numPts,pts);
+      cells = this->Strips;
       break;
 
     default:
@@ -535,6 +543,14 @@ void vtkPolyData::GetCellBounds(vtkIdType cellId, double bounds[6])
       return;
   }
 
+  // A 32-bit connectivity is read into a list rather than copied.
+  vtkSmartPointer<vtkIdList> ptIds;
+  if (cells->IsStorage32Bit())
+  {
+    ptIds = vtkSmartPointer<vtkIdList>::New();
+  }
+  cells->GetCellAtId(loc, numPts, pts, ptIds);
+
   // carefully compute the bounds
   if (numPts)
   {
@@ -947,103 +963,55 @@ void vtkPolyData::BuildCells()
   vtkIdTypeArray *locs = vtkIdTypeArray::New();
   vtkIdType *pLocs = locs->WritePointer(0, nCells);
 
-  // record locations and type of each cell.
+  // record the type of each cell and its id in the cell array holding it.
   // verts
   vtkIdType numCellPts;
-  vtkIdType nextCellPts;
-  if (nVerts)
-  {
-    vtkIdType *pVerts = vertCells->GetData()->GetPointer(0);
-    numCellPts = pVerts[0];
-    nextCellPts = numCellPts + 1;
-    pLocs[0] = 0;
-    pTypes[0] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
-    for (vtkIdType i = 1; i < nVerts; ++i)
-    {
-      numCellPts = pVerts[nextCellPts];
-      pLocs[i] = nextCellPts;
-      pTypes[i] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
-      nextCellPts += numCellPts + 1;
-    }
-    pLocs += nVerts;
-    pTypes += nVerts;
+  for (vtkIdType i = 0; i < nVerts; ++i)
+  {
+    numCellPts = vertCells->GetCellSize(i);
+    pLocs[i] = i;
+    pTypes[i] = numCellPts > 1 ? VTK_POLY_VERTEX : VTK_VERTEX;
   }
+  pLocs += nVerts;
+  pTypes += nVerts;
 
   // lines
-  if (nLines)
+  for (vtkIdType i = 0; i < nLines; ++i)
   {
-    vtkIdType *pLines = lineCells->GetData()->GetPointer(0);
-    numCellPts = pLines[0];
-    pLocs[0] = 0;
-    pTypes[0] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
+    numCellPts = lineCells->GetCellSize(i);
+    pLocs[i] = i;
+    pTypes[i] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
     if (numCellPts == 1)
     {
-      vtkWarningMacro("Building VTK_LINE 0 with only one point, but VTK_LINE "
-      "needs at least two points. Check the input.");
+      vtkWarningMacro("Building VTK_LINE " << i <<" with only one point, but "
+      "VTK_LINE needs at least two points. Check the input.");
     }
-    nextCellPts = numCellPts + 1;
-    for (vtkIdType i = 1; i < nLines; ++i)
-    {
-      numCellPts = pLines[nextCellPts];
-      pLocs[i] = nextCellPts;
-      pTypes[i] = numCellPts > 2 ? VTK_POLY_LINE : VTK_LINE;
-      if (numCellPts == 1)
-      {
-        vtkWarningMacro("Building VTK_LINE " << i <<" with only one point, but "
-        "VTK_LINE needs at least two points. Check the input.");
-      }
-      nextCellPts += numCellPts + 1;
-    }
-    pLocs += nLines;
-    pTypes += nLines;
   }
+  pLocs += nLines;
+  pTypes += nLines;
 
   // polys
-  if (nPolys)
+  for (vtkIdType i = 0; i < nPolys; ++i)
   {
-    vtkIdType *pPolys = polyCells->GetData()->GetPointer(0);
-    numCellPts = pPolys[0];
-    pLocs[0] = 0;
+    numCellPts = polyCells->GetCellSize(i);
+    pLocs[i] = i;
     if (numCellPts < 3)
     {
-      vtkWarningMacro("Building VTK_TRIANGLE 0 with less than three points, but"
-      " VTK_TRIANGLE needs at least three points. Check the input.");
+      vtkWarningMacro("Building VTK_TRIANGLE "<< i << " with less than three "
+      "points, but VTK_TRIANGLE needs at least three points. "
+      "Check the input.");
     }
-    pTypes[0] = numCellPts == 3 ? VTK_TRIANGLE :
+    pTypes[i] = numCellPts == 3 ? VTK_TRIANGLE :
       numCellPts == 4 ? VTK_QUAD : VTK_POLYGON;
-    nextCellPts = numCellPts + 1;
-    for (vtkIdType i = 1; i < nPolys; ++i)
-    {
-      numCellPts = pPolys[nextCellPts];
-      pLocs[i] = nextCellPts;
-      if (numCellPts < 3)
-      {
-        vtkWarningMacro("Building VTK_TRIANGLE "<< i << " with less than three "
-        "points, but VTK_TRIANGLE needs at least three points. "
-        "Check the input.");
-      }
-      pTypes[i] = numCellPts == 3 ? VTK_TRIANGLE :
-        numCellPts == 4 ? VTK_QUAD : VTK_POLYGON;
-      nextCellPts += numCellPts + 1;
-    }
-    pLocs += nPolys;
-    pTypes += nPolys;
   }
+  pLocs += nPolys;
+  pTypes += nPolys;
 
   // strips
-  if (nStrips)
-  {
-    std::fill_n(pTypes, nStrips, VTK_TRIANGLE_STRIP);
-    vtkIdType *pStrips = stripCells->GetData()->GetPointer(0);
-    numCellPts = pStrips[0];
-    pLocs[0] = 0;
-    nextCellPts = numCellPts + 1;
-    for (vtkIdType i = 1; i < nStrips; ++i)
-    {
-      numCellPts = pStrips[nextCellPts];
-      pLocs[i] = nextCellPts;
-      nextCellPts += numCellPts + 1;
-    }
+  std::fill_n(pTypes, nStrips, VTK_TRIANGLE_STRIP);
+  for (vtkIdType i = 0; i < nStrips; ++i)
+  {
+    pLocs[i] = i;
   }
 
   // set up the cell types data structure
@@ -1099,27 +1067,24 @@ void vtkPolyData::BuildLinks(int initialSize)
 // Copy a cells point ids into list provided. (Less efficient.)
 void vtkPolyData::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 {
-  vtkIdType i;
-  vtkIdType *pts, npts;
+  const vtkIdType *pts;
+  vtkIdType npts;
 
-  ptIds->Reset();
   if ( this->Cells == nullptr )
   {
     this->BuildCells();
   }
 
-  this->vtkPolyData::GetCellPoints(cellId, npts, pts);
+  // The ids of a 32-bit connectivity are read directly into ptIds.
+  this->vtkPolyData::GetCellPoints(cellId, npts, pts, ptIds);
   if ( npts < 1 )
   {
     ptIds->Reset();
   }
-  else
+  else if ( pts != ptIds->GetPointer(0) )
   {
-    ptIds->InsertId(npts-1,pts[npts-1]);
-    for (i=0; i<npts-1; i++)
-    {
-      ptIds->SetId(i,pts[i]);
-    }
+    ptIds->SetNumberOfIds(npts);
+    std::copy(pts, pts + npts, ptIds->GetPointer(0));
   }
 }
 
@@ -1263,21 +1228,18 @@ vtkIdType vtkPolyData::InsertNextCell(int type, int npts, const vtkIdType pts[])
   switch (type)
   {
     case VTK_VERTEX: case VTK_POLY_VERTEX:
-      this->Verts->InsertNextCell(npts,pts);
-      id = this->Cells->InsertNextCell(type,
-                                       this->Verts->GetInsertLocation(npts));
+      id = this->Verts->InsertNextCell(npts,pts);
+      id = this->Cells->InsertNextCell(type, id);
       break;
 
     case VTK_LINE: case VTK_POLY_LINE:
-      this->Lines->InsertNextCell(npts,pts);
-      id = this->Cells->InsertNextCell(type,
-                                       this->Lines->GetInsertLocation(npts));
+      id = this->Lines->InsertNextCell(npts,pts);
+      id = this->Cells->InsertNextCell(type, id);
       break;
 
     case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
-      this->Polys->InsertNextCell(npts,pts);
-      id = this->Cells->InsertNextCell(type,
-                                       this->Polys->GetInsertLocation(npts));
+      id = this->Polys->InsertNextCell(npts,pts);
+      id = this->Cells->InsertNextCell(type, id);
       break;
 
     case VTK_PIXEL: //need to rearrange vertices
@@ -1287,16 +1249,14 @@ vtkIdType vtkPolyData::InsertNextCell(int type, int npts, const vtkIdType pts[])
       pixPts[1] = pts[1];
       pixPts[2] = pts[3];
       pixPts[3] = pts[2];
-      this->Polys->InsertNextCell(npts,pixPts);
-      id = this->Cells->InsertNextCell(VTK_QUAD,
-                                       this->Polys->GetInsertLocation(npts));
+      id = this->Polys->InsertNextCell(npts,pixPts);
+      id = this->Cells->InsertNextCell(VTK_QUAD, id);
       break;
     }
 
     case VTK_TRIANGLE_STRIP:
-      this->Strips->InsertNextCell(npts,pts);
-      id = this->Cells->InsertNextCell(type,
-                                       this->Strips->GetInsertLocation(npts));
+      id = this->Strips->InsertNextCell(npts,pts);
+      id = this->Cells->InsertNextCell(type, id);
       break;
 
     default:
@@ -1326,18 +1286,18 @@ vtkIdType vtkPolyData::InsertNextCell(int type, vtkIdList *pts)
   switch (type)
   {
     case VTK_VERTEX: case VTK_POLY_VERTEX:
-      this->Verts->InsertNextCell(pts);
-      id = this->Cells->InsertNextCell(type, this->Verts->GetInsertLocation(npts));
+      id = this->Verts->InsertNextCell(pts);
+      id = this->Cells->InsertNextCell(type, id);
       break;
 
     case VTK_LINE: case VTK_POLY_LINE:
-      this->Lines->InsertNextCell(pts);
-      id = this->Cells->InsertNextCell(type, this->Lines->GetInsertLocation(npts));
+      id = this->Lines->InsertNextCell(pts);
+      id = this->Cells->InsertNextCell(type, id);
       break;
 
     case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
-      this->Polys->InsertNextCell(pts);
-      id = this->Cells->InsertNextCell(type, this->Polys->GetInsertLocation(npts));
+      id = this->Polys->InsertNextCell(pts);
+      id = this->Cells->InsertNextCell(type, id);
       break;
 
     case VTK_PIXEL: //need to rearrange vertices
@@ -1347,14 +1307,14 @@ vtkIdType vtkPolyData::InsertNextCell(int type, vtkIdList *pts)
       pixPts[1] = pts->GetId(1);
       pixPts[2] = pts->GetId(3);
       pixPts[3] = pts->GetId(2);
-      this->Polys->InsertNextCell(4,pixPts);
-      id = this->Cells->InsertNextCell(VTK_QUAD, this->Polys->GetInsertLocation(npts));
+      id = this->Polys->InsertNextCell(4,pixPts);
+      id = this->Cells->InsertNextCell(VTK_QUAD, id);
       break;
     }
 
     case VTK_TRIANGLE_STRIP:
-      this->Strips->InsertNextCell(pts);
-      id = this->Cells->InsertNextCell(type, this->Strips->GetInsertLocation(npts));
+      id = this->Strips->InsertNextCell(pts);
+      id = this->Cells->InsertNextCell(type, id);
       break;
 
     case VTK_EMPTY_CELL:
@@ -1397,6 +1357,45 @@ void vtkPolyData::Squeeze()
   vtkPointSet::Squeeze();
 }
 
+//----------------------------------------------------------------------------
+bool vtkPolyData::ConvertTo32BitStorage()
+{
+  vtkCellArray *cellArrays[4] =
+    { this->Verts, this->Lines, this->Polys, this->Strips };
+
+  // Convert all the cell arrays or none of them.
+  for (int i = 0; i < 4; ++i)
+  {
+    if ( cellArrays[i] != nullptr &&
+         !cellArrays[i]->CanConvertTo32BitStorage() )
+    {
+      return false;
+    }
+  }
+  for (int i = 0; i < 4; ++i)
+  {
+    if ( cellArrays[i] != nullptr )
+    {
+      cellArrays[i]->ConvertTo32BitStorage();
+    }
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void vtkPolyData::ConvertTo64BitStorage()
+{
+  vtkCellArray *cellArrays[4] =
+    { this->Verts, this->Lines, this->Polys, this->Strips };
+  for (int i = 0; i < 4; ++i)
+  {
+    if ( cellArrays[i] != nullptr )
+    {
+      cellArrays[i]->ConvertTo64BitStorage();
+    }
+  }
+}
+
 //----------------------------------------------------------------------------
 // Begin inserting data all over again. Memory is not freed but otherwise
 // objects are returned to their initial state.
@@ -1441,19 +1440,19 @@ void vtkPolyData::ReverseCell(vtkIdType cellId)
   switch (type)
   {
     case VTK_VERTEX: case VTK_POLY_VERTEX:
-     this->Verts->ReverseCell(loc);
+     this->Verts->ReverseCellAtId(loc);
      break;
 
     case VTK_LINE: case VTK_POLY_LINE:
-      this->Lines->ReverseCell(loc);
+      this->Lines->ReverseCellAtId(loc);
       break;
 
     case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
-      this->Polys->ReverseCell(loc);
+      this->Polys->ReverseCellAtId(loc);
       break;
 
     case VTK_TRIANGLE_STRIP:
-      this->Strips->ReverseCell(loc);
+      this->Strips->ReverseCellAtId(loc);
       break;
 
     default:
@@ -1540,19 +1539,19 @@ void vtkPolyData::ReplaceCell(vtkIdType cellId, int npts, const vtkIdType pts[])
   switch (type)
   {
     case VTK_VERTEX: case VTK_POLY_VERTEX:
-     this->Verts->ReplaceCell(loc,npts,pts);
+     this->Verts->ReplaceCellAtId(loc,npts,pts);
      break;
 
     case VTK_LINE: case VTK_POLY_LINE:
-      this->Lines->ReplaceCell(loc,npts,pts);
+      this->Lines->ReplaceCellAtId(loc,npts,pts);
       break;
 
     case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
-      this->Polys->ReplaceCell(loc,npts,pts);
+      this->Polys->ReplaceCellAtId(loc,npts,pts);
       break;
 
     case VTK_TRIANGLE_STRIP:
-      this->Strips->ReplaceCell(loc,npts,pts);
+      this->Strips->ReplaceCellAtId(loc,npts,pts);
       break;
 
     default:
@@ -1575,19 +1574,19 @@ void vtkPolyData::ReplaceLinkedCell(vtkIdType cellId, int npts, const vtkIdType
   switch (type)
   {
     case VTK_VERTEX: case VTK_POLY_VERTEX:
-     this->Verts->ReplaceCell(loc,npts,pts);
+     this->Verts->ReplaceCellAtId(loc,npts,pts);
      break;
 
     case VTK_LINE: case VTK_POLY_LINE:
-      this->Lines->ReplaceCell(loc,npts,pts);
+      this->Lines->ReplaceCellAtId(loc,npts,pts);
       break;
 
     case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
-      this->Polys->ReplaceCell(loc,npts,pts);
+      this->Polys->ReplaceCellAtId(loc,npts,pts);
       break;
 
     case VTK_TRIANGLE_STRIP:
-      this->Strips->ReplaceCell(loc,npts,pts);
+      this->Strips->ReplaceCellAtId(loc,npts,pts);
       break;
 
     default:
@@ -141,6 +141,20 @@ public:
    */
   void Squeeze() override;
 
+  /**
+   * Store the verts, lines, polys and strips as 32-bit integers, which
+   * halves their memory when vtkIdType is 64-bit (see
+   * vtkCellArray::ConvertTo32BitStorage()). The vtkIdType API is unchanged.
+   * Returns false, and leaves the cells unchanged, if the point ids do not
+   * all fit.
+   */
+  bool ConvertTo32BitStorage();
+
+  /**
+   * Store the cells as vtkIdType, the default.
+   */
+  void ConvertTo64BitStorage();
+
   /**
    * Return the maximum cell size in this poly data.
    */
@@ -305,10 +319,19 @@ public:
       vtkIdType& npts, vtkIdType* &pts) VTK_SIZEHINT(pts, npts);
 
   /**
-   * Get a pointer to the cell, ie [npts pid1 .. pidn]. More efficient
-   * because pointer points directly to cell array internals and this
-   * is not a virtual call. However, this requires that cells have been
-   * built (with BuildCells()). The cell type is returned.
+   * Same as the method above, but the point ids of a cell array stored as
+   * 32-bit integers are read into ptIds, which pts then points into, rather
+   * than copied to vtkIdType (see vtkCellArray::GetCellAtId()).
+   */
+  unsigned char GetCellPoints(vtkIdType cellId, vtkIdType& npts,
+      const vtkIdType* &pts, vtkIdList* ptIds) VTK_SIZEHINT(pts, npts);
+
+  /**
+   * Get a pointer to the cell, ie [npts pid1 .. pidn]. The pointer points
+   * into the legacy representation of the cell array, which is built on
+   * demand (see vtkCellArray::GetData()): prefer GetCellPoints(). This
+   * requires that cells have been built (with BuildCells()). The cell type
+   * is returned.
    */
   unsigned char GetCell(vtkIdType cellId, vtkIdType* &pts);
 
@@ -682,7 +705,10 @@ inline void vtkPolyData::ReplaceCellPoint(vtkIdType cellId, vtkIdType oldPtId,
   {
     if ( verts[i] == oldPtId )
     {
-      verts[i] = newPtId; // this is very nasty! direct write!
+      // verts may address the vtkIdType copy of a 32-bit connectivity, so
+      // the ids are also written back to the cell array.
+      verts[i] = newPtId;
+      this->ReplaceCell(cellId, static_cast<int>(nverts), verts);
       return;
     }
   }
@@ -717,8 +743,39 @@ inline unsigned char vtkPolyData::GetCellPoints(
       pts = nullptr;
       return 0;
   }
-  int loc = this->Cells->GetCellLocation(cellId);
-  cells->GetCell(loc, npts, pts);
+  cells->GetCellAtId(this->Cells->GetCellLocation(cellId), npts, pts);
+  return type;
+}
+
+inline unsigned char vtkPolyData::GetCellPoints(vtkIdType cellId,
+    vtkIdType& npts, const vtkIdType* &pts, vtkIdList* ptIds)
+{
+  unsigned char type = this->Cells->GetCellType(cellId);
+  vtkCellArray *cells;
+  switch (type)
+  {
+    case VTK_VERTEX: case VTK_POLY_VERTEX:
+      cells = this->Verts;
+      break;
+
+    case VTK_LINE: case VTK_POLY_LINE:
+      cells = this->Lines;
+      break;
+
+    case VTK_TRIANGLE: case VTK_QUAD: case VTK_POLYGON:
+      cells = this->Polys;
+      break;
+
+    case VTK_TRIANGLE_STRIP:
+      cells = this->Strips;
+      break;
+
+    default:
+      npts = 0;
+      pts = nullptr;
+      return 0;
+  }
+  cells->GetCellAtId(this->Cells->GetCellLocation(cellId), npts, pts, ptIds);
   return type;
 }
 
@@ -750,7 +807,8 @@ inline unsigned char vtkPolyData::GetCell(
       cell = nullptr;
       return 0;
   }
-  int loc = this->Cells->GetCellLocation(cellId);
+  vtkIdType loc =
+    cells->GetLocationFromCellId(this->Cells->GetCellLocation(cellId));
   cell = cells->GetData()->GetPointer(loc);
   return type;
 }
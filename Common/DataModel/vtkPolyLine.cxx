@@ -34,12 +34,15 @@ vtkStandardNewMacro(vtkPolyLine);
 vtkPolyLine::vtkPolyLine()
 {
   this->Line = vtkLine::New();
+  this->Scalars = vtkDoubleArray::New();
+  this->Scalars->SetNumberOfTuples(2);
 }
 
 //----------------------------------------------------------------------------
 vtkPolyLine::~vtkPolyLine()
 {
   this->Line->Delete();
+  this->Scalars->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -432,8 +435,7 @@ void vtkPolyLine::Clip(double value, vtkDataArray *cellScalars,
                        int insideOut)
 {
   int i, numLines=this->Points->GetNumberOfPoints() - 1;
-  vtkDoubleArray *lineScalars=vtkDoubleArray::New();
-  lineScalars->SetNumberOfTuples(2);
+  vtkDoubleArray *lineScalars=this->Scalars;
 
   for ( i=0; i < numLines; i++)
   {
@@ -449,8 +451,6 @@ void vtkPolyLine::Clip(double value, vtkDataArray *cellScalars,
     this->Line->Clip(value, lineScalars, locator, lines, inPd, outPd,
                     inCd, cellId, outCd, insideOut);
   }
-
-  lineScalars->Delete();
 }
 
 //----------------------------------------------------------------------------
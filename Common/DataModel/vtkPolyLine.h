@@ -30,6 +30,7 @@ class vtkPoints;
 class vtkCellArray;
 class vtkLine;
 class vtkDataArray;
+class vtkDoubleArray;
 class vtkIncrementalPointLocator;
 class vtkCellData;
 
@@ -97,6 +98,7 @@ protected:
   ~vtkPolyLine() override;
 
   vtkLine *Line;
+  vtkDoubleArray *Scalars; // scratch scalars of the line segments
 
 private:
   vtkPolyLine(const vtkPolyLine&) = delete;
@@ -233,10 +233,8 @@ void vtkPolyhedron::ConstructPolyData()
     return;
   }
 
-  this->PolyConnectivity->SetNumberOfTuples(this->Faces->GetMaxId() - 1);
   this->PolyConnectivity->
-    SetArray(this->Faces->GetPointer(1), this->Faces->GetMaxId() - 1, 1);
-  this->Polys->SetNumberOfCells(*(this->Faces->GetPointer(0)));
+    SetArray(this->Faces->GetPointer(1), this->Faces->GetMaxId(), 1);
   this->Polys->
     SetCells(*(this->Faces->GetPointer(0)), this->PolyConnectivity);
 
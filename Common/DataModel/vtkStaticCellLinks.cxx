@@ -13,24 +13,136 @@
 
 =========================================================================*/
 #include "vtkStaticCellLinks.h"
+
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
 #include "vtkObjectFactory.h"
+#include "vtkPolyData.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <algorithm>
 
 vtkStandardNewMacro(vtkStaticCellLinks);
 
+namespace
+{
+
+// Return the number of links of the dataset, or an upper bound of it.
+vtkIdType vtkGetNumberOfLinks(vtkDataSet *ds)
+{
+  if ( ds->GetDataObjectType() == VTK_POLY_DATA )
+  {
+    vtkPolyData *pd = static_cast<vtkPolyData*>(ds);
+    return pd->GetVerts()->GetNumberOfConnectivityIds() +
+      pd->GetLines()->GetNumberOfConnectivityIds() +
+      pd->GetPolys()->GetNumberOfConnectivityIds() +
+      pd->GetStrips()->GetNumberOfConnectivityIds();
+  }
+  else if ( ds->GetDataObjectType() == VTK_UNSTRUCTURED_GRID )
+  {
+    vtkCellArray *cells = static_cast<vtkUnstructuredGrid*>(ds)->GetCells();
+    return cells ? cells->GetNumberOfConnectivityIds() : 0;
+  }
+  return ds->GetNumberOfCells() * ds->GetMaxCellSize();
+}
+
+}
+
 //----------------------------------------------------------------------------
 vtkStaticCellLinks::vtkStaticCellLinks()
 {
+  this->LargeIds = true;
   this->Impl = new vtkStaticCellLinksTemplate<vtkIdType>;
+  this->CompactImpl = new vtkStaticCellLinksTemplate<int>;
+  this->WideLinks = nullptr;
 }
 
 //----------------------------------------------------------------------------
 vtkStaticCellLinks::~vtkStaticCellLinks()
 {
+  this->Initialize();
   delete this->Impl;
+  delete this->CompactImpl;
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLinks::Initialize()
+{
+  this->Impl->Initialize();
+  this->CompactImpl->Initialize();
+  delete [] this->WideLinks.load();
+  this->WideLinks = nullptr;
+}
+
+//----------------------------------------------------------------------------
+// 32-bit links are used when vtkIdType is wider and all the ids (points,
+// cells and positions in the links array) fit.
+void vtkStaticCellLinks::BuildLinks(vtkDataSet *ds)
+{
+  this->Initialize();
+
+  vtkIdType max = std::max(ds->GetNumberOfPoints(), ds->GetNumberOfCells());
+  max = std::max(max, vtkGetNumberOfLinks(ds));
+  this->LargeIds = sizeof(vtkIdType) == sizeof(int) || max >= VTK_INT_MAX;
+
+  if ( this->LargeIds )
+  {
+    this->Impl->BuildLinks(ds);
+  }
+  else
+  {
+    this->CompactImpl->BuildLinks(ds);
+  }
+}
+
+//----------------------------------------------------------------------------
+const vtkIdType *vtkStaticCellLinks::GetCells(vtkIdType ptId)
+{
+  if ( this->LargeIds )
+  {
+    return this->Impl->GetCells(ptId);
+  }
+
+  vtkIdType *wideLinks = this->WideLinks.load(std::memory_order_acquire);
+  if ( !wideLinks )
+  {
+    std::lock_guard<std::mutex> lock(this->WideLinksLock);
+    wideLinks = this->WideLinks.load(std::memory_order_relaxed);
+    if ( !wideLinks )
+    {
+      const int *links = this->CompactImpl->GetCells(0);
+      vtkIdType linksSize = this->CompactImpl->GetLinksSize();
+      wideLinks = new vtkIdType[linksSize + 1];
+      std::copy(links, links + linksSize + 1, wideLinks);
+      this->WideLinks.store(wideLinks, std::memory_order_release);
+    }
+  }
+  return wideLinks + (this->CompactImpl->GetCells(ptId) -
+                      this->CompactImpl->GetCells(0));
+}
+
+//----------------------------------------------------------------------------
+void vtkStaticCellLinks::GetCells(vtkIdType ptId, vtkIdList *cellIds)
+{
+  vtkIdType numCells = this->GetNumberOfCells(ptId);
+  cellIds->SetNumberOfIds(numCells);
+  vtkIdType *ids = cellIds->GetPointer(0);
+  if ( this->LargeIds )
+  {
+    const vtkIdType *cells = this->Impl->GetCells(ptId);
+    std::copy(cells, cells + numCells, ids);
+  }
+  else
+  {
+    const int *cells = this->CompactImpl->GetCells(ptId);
+    std::copy(cells, cells + numCells, ids);
+  }
 }
 
 //----------------------------------------------------------------------------
 void vtkStaticCellLinks::PrintSelf(ostream& os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os,indent);
+
+  os << indent << "Large IDs: " << this->LargeIds << "\n";
 }
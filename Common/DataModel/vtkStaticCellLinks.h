@@ -30,11 +30,16 @@
  *
  * @warning
  * This is a drop-in replacement for vtkCellLinks using static link
- * construction. It uses the templated vtkStaticCellLinksTemplate class,
- * instantiating vtkStaticCellLinksTemplate with a vtkIdType template
- * parameter. Note that for best performance, the vtkStaticCellLinksTemplate
- * class may be used directly, instantiating it with the appropriate id
- * type. This class is also wrappable and can be used from an interpreted
+ * construction. It uses the templated vtkStaticCellLinksTemplate class.
+ * When the number of points, cells and links allows it the links are
+ * stored as 32-bit integers, which halves the memory used when vtkIdType
+ * is 64-bit; otherwise vtkIdType is used. This is transparent except for
+ * GetCells(ptId), which returns a pointer to vtkIdType ids: with 32-bit
+ * storage the first call makes a vtkIdType copy of the links, so prefer
+ * the GetCells(ptId, cellIds) variant. For best performance, the
+ * vtkStaticCellLinksTemplate class may be used directly, instantiating it
+ * with the appropriate id type (see vtkAbstractCellLinks::GetIdType()).
+ * This class is also wrappable and can be used from an interpreted
  * language such as Python.
  *
  * @sa
@@ -48,8 +53,12 @@
 #include "vtkAbstractCellLinks.h"
 #include "vtkStaticCellLinksTemplate.h" // For implementations
 
+#include <atomic> // For the vtkIdType copy of the links
+#include <mutex> // For the vtkIdType copy of the links
+
 class vtkDataSet;
 class vtkCellArray;
+class vtkIdList;
 
 
 class VTKCOMMONDATAMODEL_EXPORT vtkStaticCellLinks : public vtkAbstractCellLinks
@@ -67,14 +76,16 @@ public:
   /**
    * Build the link list array. Satisfy the superclass API.
    */
-  void BuildLinks(vtkDataSet *ds) override
-    {this->Impl->BuildLinks(ds);}
+  void BuildLinks(vtkDataSet *ds) override;
 
   /**
    * Get the number of cells using the point specified by ptId.
    */
   vtkIdType GetNumberOfCells(vtkIdType ptId)
-    {return this->Impl->GetNumberOfCells(ptId);}
+  {
+    return this->LargeIds ? this->Impl->GetNumberOfCells(ptId) :
+      this->CompactImpl->GetNumberOfCells(ptId);
+  }
 
   /**
    * Get the number of cells using the point specified by ptId. This is an
@@ -84,22 +95,39 @@ public:
     { return static_cast<unsigned short>(this->GetNumberOfCells(ptId)); }
 
   /**
-   * Return a list of cell ids using the specified point.
+   * Return a list of cell ids using the specified point. With 32-bit
+   * storage this makes a vtkIdType copy of the links on first use.
+   */
+  const vtkIdType *GetCells(vtkIdType ptId);
+
+  /**
+   * Copy the ids of the cells using the specified point into cellIds.
    */
-  const vtkIdType *GetCells(vtkIdType ptId)
-    {return this->Impl->GetCells(ptId);}
+  void GetCells(vtkIdType ptId, vtkIdList *cellIds);
+
+  /**
+   * Return true if the links are stored with vtkIdType, false if they are
+   * stored as 32-bit integers. Valid after BuildLinks().
+   */
+  bool GetLargeIds()
+    {return this->LargeIds;}
 
   /**
    * Make sure any previously created links are cleaned up.
    */
-  void Initialize()
-    {this->Impl->Initialize();}
+  void Initialize();
 
 protected:
   vtkStaticCellLinks();
   ~vtkStaticCellLinks() override;
 
+  bool LargeIds;
   vtkStaticCellLinksTemplate<vtkIdType> *Impl;
+  vtkStaticCellLinksTemplate<int> *CompactImpl;
+
+  // vtkIdType copy of the 32-bit links, see GetCells().
+  std::atomic<vtkIdType*> WideLinks;
+  std::mutex WideLinksLock;
 
 private:
   vtkStaticCellLinks(const vtkStaticCellLinks&) = delete;
@@ -105,6 +105,15 @@ public:
       return this->Links + this->Offsets[ptId];
   }
 
+  /**
+   * Return the total number of links, that is the sum over all the points
+   * of the number of cells using the point.
+   */
+  TIds GetLinksSize()
+  {
+      return this->LinksSize;
+  }
+
 protected:
   // The various templated data members
   TIds LinksSize;
@@ -19,6 +19,8 @@
 
 #include "vtkCellArray.h"
 #include "vtkDataSet.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
 #include "vtkPolyData.h"
 #include "vtkUnstructuredGrid.h"
 
@@ -65,6 +67,7 @@ BuildLinks(vtkDataSet *ds)
   // Any other type of dataset. Generally this is not called as datasets have
   // their own, more efficient ways of getting similar information.
   // Make sure that we clear out previous allocation.
+  this->Initialize();
   this->NumCells = ds->GetNumberOfCells();
   this->NumPts = ds->GetNumberOfPoints();
 
@@ -124,36 +127,35 @@ template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkUnstructuredGrid *ugrid)
 {
   // Basic information about the grid
+  this->Initialize();
   this->NumCells = ugrid->GetNumberOfCells();
   this->NumPts = ugrid->GetNumberOfPoints();
 
-  // We're going to get into the guts of the class
   vtkCellArray *cellArray = ugrid->GetCells();
-  const vtkIdType *cells = cellArray->GetPointer();
 
-  // I love this trick: the size of the Links array is equal to
-  // the size of the cell array, minus the number of cells.
-  this->LinksSize =
-    cellArray->GetNumberOfConnectivityEntries() - this->NumCells;
+  // The size of the Links array is equal to the number of point ids in the
+  // connectivity array.
+  this->LinksSize = cellArray->GetNumberOfConnectivityIds();
 
   // Extra one allocated to simplify later pointer manipulation
   this->Links = new TIds[this->LinksSize+1];
   this->Links[this->LinksSize] = this->NumPts;
   this->Offsets = new TIds[this->NumPts+1];
-  std::fill_n(this->Offsets, this->NumPts, 0);
+  std::fill_n(this->Offsets, this->NumPts+1, 0);
 
-  // Now create the links.
+  // Now create the links. A 32-bit connectivity is read into ptIds.
   vtkIdType npts, cellId, ptId;
-  const vtkIdType *cell=cells;
+  const vtkIdType *cell;
+  vtkNew<vtkIdList> ptIds;
   int i;
 
   // Count number of point uses
   for ( cellId=0; cellId < this->NumCells; ++cellId )
   {
-    npts = *cell++;
+    cellArray->GetCellAtId(cellId, npts, cell, ptIds);
     for (i=0; i<npts; ++i)
     {
-      this->Offsets[*cell++]++;
+      this->Offsets[cell[i]]++;
     }
   }
 
@@ -168,13 +170,13 @@ BuildLinks(vtkUnstructuredGrid *ugrid)
   // the cells are to be inserted. Each time a cell is inserted, the offset
   // is decremented. In the end, the offset array is also constructed as it
   // points to the beginning of each cell run.
-  for ( cell=cells, cellId=0; cellId < this->NumCells; ++cellId )
+  for ( cellId=0; cellId < this->NumCells; ++cellId )
   {
-    npts = *cell++;
+    cellArray->GetCellAtId(cellId, npts, cell, ptIds);
     for (i=0; i<npts; ++i)
     {
-      this->Offsets[*cell]--;
-      this->Links[this->Offsets[*cell++]] = cellId;
+      this->Offsets[cell[i]]--;
+      this->Links[this->Offsets[cell[i]]] = cellId;
     }
   }
   this->Offsets[this->NumPts] = this->LinksSize;
@@ -182,11 +184,12 @@ BuildLinks(vtkUnstructuredGrid *ugrid)
 
 //----------------------------------------------------------------------------
 // Build the link list array for poly data. This is more complex because there
-// are potentially fout different cell arrays to contend with.
+// are potentially four different cell arrays to contend with.
 template <typename TIds> void vtkStaticCellLinksTemplate<TIds>::
 BuildLinks(vtkPolyData *pd)
 {
   // Basic information about the grid
+  this->Initialize();
   this->NumCells = pd->GetNumberOfCells();
   this->NumPts = pd->GetNumberOfPoints();
 
@@ -205,7 +208,7 @@ BuildLinks(vtkPolyData *pd)
     if ( cellArrays[i] != nullptr )
     {
       numCells[i] = cellArrays[i]->GetNumberOfCells();
-      sizes[i] = cellArrays[i]->GetNumberOfConnectivityEntries() - numCells[i];
+      sizes[i] = cellArrays[i]->GetNumberOfConnectivityIds();
     }
     else
     {
@@ -222,24 +225,23 @@ BuildLinks(vtkPolyData *pd)
   this->Offsets[this->NumPts] = this->LinksSize;
   std::fill_n(this->Offsets, this->NumPts, 0);
 
-  // Now create the links.
+  // Now create the links. A 32-bit connectivity is read into ptIds.
   vtkIdType npts, cellId, CellId, ptId;
   const vtkIdType *cell;
+  vtkNew<vtkIdList> ptIds;
 
   // Visit the four arrays
-  for ( CellId=0, j=0; j < 4; ++j )
+  for ( j=0; j < 4; ++j )
   {
     // Count number of point uses
-    cell = cellArrays[j]->GetPointer();
     for ( cellId=0; cellId < numCells[j]; ++cellId )
     {
-      npts = *cell++;
+      cellArrays[j]->GetCellAtId(cellId, npts, cell, ptIds);
       for (i=0; i<npts; ++i)
       {
-        this->Offsets[CellId+(*cell++)]++;
+        this->Offsets[cell[i]]++;
       }
     }
-    CellId += numCells[j];
   } //for each of the four polydata cell arrays
 
   // Perform prefix sum
@@ -255,14 +257,13 @@ BuildLinks(vtkPolyData *pd)
   // points to the beginning of each cell run.
   for ( CellId=0, j=0; j < 4; ++j )
   {
-    cell = cellArrays[j]->GetPointer();
     for ( cellId=0; cellId < numCells[j]; ++cellId )
     {
-      npts = *cell++;
+      cellArrays[j]->GetCellAtId(cellId, npts, cell, ptIds);
       for (i=0; i<npts; ++i)
       {
-        this->Offsets[*cell]--;
-        this->Links[this->Offsets[*cell++]] = CellId+cellId;
+        this->Offsets[cell[i]]--;
+        this->Links[this->Offsets[cell[i]]] = CellId+cellId;
       }
     }
     CellId += numCells[j];
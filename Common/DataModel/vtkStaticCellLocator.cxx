@@ -216,9 +216,14 @@ struct CellFragments
   TId CellId; //originating cell id
   TId BinId; //i-j-k index into bin space
 
-  //Operator< used to support the subsequent sort operation.
+  //Operator< used to support the subsequent sort operation. Cells are
+  //ordered within each bin so that the locator, and hence FindCell(), does
+  //not depend on the number of threads used by the (unstable) parallel sort.
   bool operator< (const CellFragments& tuple) const
-    {return BinId < tuple.BinId;}
+  {
+    return BinId < tuple.BinId ||
+      (BinId == tuple.BinId && CellId < tuple.CellId);
+  }
 };
 
 // Perform locator operations like FindCell. Uses templated subclasses
@@ -41,6 +41,9 @@
 #include "vtkPolygon.h"
 #include "vtkPolyhedron.h"
 #include "vtkPyramid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
 #include "vtkPentagonalPrism.h"
 #include "vtkHexagonalPrism.h"
 #include "vtkQuad.h"
@@ -521,13 +524,7 @@ int vtkUnstructuredGrid::GetCellType(vtkIdType cellId)
 vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
 {
   vtkIdType i;
-  vtkIdType loc;
   vtkCell *cell = nullptr;
-  vtkIdType *pts, numPts;
-
-  loc = this->Locations->GetValue(cellId);
-  vtkDebugMacro(<< "location = " <<  loc);
-  this->Connectivity->GetCell(loc,numPts,pts);
 
   int cellType = static_cast<int>(this->Types->GetValue(cellId));
   switch (cellType)
@@ -866,12 +863,12 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
   }
 
   // Copy the points over to the cell.
-  cell->PointIds->SetNumberOfIds(numPts);
+  this->Connectivity->GetCellAtId(cellId, cell->PointIds);
+  vtkIdType numPts = cell->PointIds->GetNumberOfIds();
   cell->Points->SetNumberOfPoints(numPts);
   for (i=0; i<numPts; i++)
   {
-    cell->PointIds->SetId(i,pts[i]);
-    cell->Points->SetPoint(i,this->Points->GetPoint(pts[i]));
+    cell->Points->SetPoint(i,this->Points->GetPoint(cell->PointIds->GetId(i)));
   }
 
   // Some cells require special initialization to build data structures
@@ -887,18 +884,10 @@ vtkCell *vtkUnstructuredGrid::GetCell(vtkIdType cellId)
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 {
-  vtkIdType loc;
-  vtkIdType *pts, numPts;
-
   int cellType = static_cast<int>(this->Types->GetValue(cellId));
   cell->SetCellType(cellType);
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
-
-  cell->PointIds->SetNumberOfIds(numPts);
-
-  std::copy(pts, pts + numPts, cell->PointIds->GetPointer(0));
+  this->Connectivity->GetCellAtId(cellId, cell->PointIds);
   this->Points->GetPoints(cell->PointIds, cell->Points);
 
   // Explicit face representation
@@ -921,12 +910,17 @@ void vtkUnstructuredGrid::GetCell(vtkIdType cellId, vtkGenericCell *cell)
 void vtkUnstructuredGrid::GetCellBounds(vtkIdType cellId, double bounds[6])
 {
   vtkIdType i;
-  vtkIdType loc;
   double x[3];
-  vtkIdType *pts, numPts;
+  vtkIdType numPts;
+  const vtkIdType *pts;
 
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
+  // A 32-bit connectivity is read into a list rather than copied.
+  vtkSmartPointer<vtkIdList> ptIds;
+  if (this->Connectivity->IsStorage32Bit())
+  {
+    ptIds = vtkSmartPointer<vtkIdList>::New();
+  }
+  this->Connectivity->GetCellAtId(cellId, numPts, pts, ptIds);
 
   // carefully compute the bounds
   if (numPts)
@@ -1056,7 +1050,7 @@ vtkIdType vtkUnstructuredGrid::InternalInsertNextCell(int type, vtkIdType npts,
     }
 
     // insert cell location
-    this->Locations->InsertNextValue(this->Connectivity->GetData()->GetMaxId()+1);
+    this->Locations->InsertNextValue(this->Connectivity->GetNumberOfConnectivityEntries());
     // insert face location
     this->FaceLocations->InsertNextValue(this->Faces->GetMaxId()+1);
     // insert cell connectivity and faces stream
@@ -1236,7 +1230,7 @@ void vtkUnstructuredGrid::SetCells(int *types, vtkCellArray *cells)
   for (i=0, cells->InitTraversal(); cells->GetNextCell(npts,pts); i++)
   {
     cellTypes->InsertNextValue(static_cast<unsigned char>(types[i]));
-    cellLocations->InsertNextValue(newCells->GetData()->GetMaxId()+1);
+    cellLocations->InsertNextValue(newCells->GetNumberOfConnectivityEntries());
     if (types[i] != VTK_POLYHEDRON)
     {
       newCells->InsertNextCell(npts, pts);
@@ -1300,7 +1294,7 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
   vtkIdType npts, nfaces, realnpts, *pts;
   for (i=0, cells->InitTraversal(); cells->GetNextCell(npts,pts); i++)
   {
-    newCellLocations->InsertNextValue(newCells->GetData()->GetMaxId()+1);
+    newCellLocations->InsertNextValue(newCells->GetNumberOfConnectivityEntries());
     if (cellTypes->GetValue(i) != VTK_POLYHEDRON)
     {
       newCells->InsertNextCell(npts, pts);
@@ -1323,6 +1317,40 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
   faceLocations->Delete();
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Return true if the cell locations are the ones of the cells in order.
+bool vtkUnstructuredGridLocationsMatch(vtkCellArray* cells,
+                                       vtkIdTypeArray* locations)
+{
+  const vtkIdType numCells = locations->GetNumberOfValues();
+  if (numCells != cells->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkSMPThreadLocal<unsigned char> mismatch(0);
+  vtkSMPTools::For(0, numCells, [&](vtkIdType begin, vtkIdType end) {
+    unsigned char& localMismatch = mismatch.Local();
+    for (vtkIdType cellId = begin; cellId < end && !localMismatch; ++cellId)
+    {
+      if (locations->GetValue(cellId) != cells->GetLocationFromCellId(cellId))
+      {
+        localMismatch = 1;
+      }
+    }
+  });
+  for (unsigned char localMismatch : mismatch)
+  {
+    if (localMismatch)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
                                    vtkIdTypeArray *cellLocations,
@@ -1330,6 +1358,40 @@ void vtkUnstructuredGrid::SetCells(vtkUnsignedCharArray *cellTypes,
                                    vtkIdTypeArray *faceLocations,
                                    vtkIdTypeArray *faces)
 {
+  // The cells are addressed by id: cells that are not stored in the order
+  // given by their locations are copied in that order.
+  vtkSmartPointer<vtkCellArray> orderedCells = cells;
+  vtkSmartPointer<vtkIdTypeArray> orderedLocations = cellLocations;
+  if (cells && cellLocations &&
+      !vtkUnstructuredGridLocationsMatch(cells, cellLocations))
+  {
+    const vtkIdType numCells = cellLocations->GetNumberOfValues();
+    const vtkIdType* legacy = cells->GetPointer();
+    const vtkIdType legacySize = cells->GetNumberOfConnectivityEntries();
+    orderedCells = vtkSmartPointer<vtkCellArray>::New();
+    orderedCells->Allocate(legacySize);
+    orderedLocations = vtkSmartPointer<vtkIdTypeArray>::New();
+    orderedLocations->SetNumberOfValues(numCells);
+    for (vtkIdType cellId = 0; cellId < numCells; ++cellId)
+    {
+      const vtkIdType loc = cellLocations->GetValue(cellId);
+      if (loc >= 0 && loc < legacySize && legacy[loc] >= 0 &&
+          loc + legacy[loc] < legacySize)
+      {
+        orderedCells->InsertNextCell(legacy[loc], legacy + loc + 1);
+      }
+      else
+      {
+        vtkErrorMacro("Invalid location " << loc << " of cell " << cellId);
+        orderedCells->InsertNextCell(0, legacy);
+      }
+      orderedLocations->SetValue(cellId,
+        orderedCells->GetLocationFromCellId(cellId));
+    }
+  }
+  cells = orderedCells;
+  cellLocations = orderedLocations;
+
   if ( this->Connectivity )
   {
     this->Connectivity->UnRegister(this);
@@ -1400,17 +1462,7 @@ void vtkUnstructuredGrid::BuildLinks()
 //----------------------------------------------------------------------------
 void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 {
-  vtkIdType i, loc;
-  vtkIdType *pts, numPts;
-
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->GetCell(loc,numPts,pts);
-  ptIds->SetNumberOfIds(numPts);
-  for (i=0; i<numPts; i++)
-  {
-    ptIds->SetId(i,pts[i]);
-  }
-
+  this->Connectivity->GetCellAtId(cellId, ptIds);
 }
 
 //----------------------------------------------------------------------------
@@ -1419,11 +1471,7 @@ void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdList *ptIds)
 void vtkUnstructuredGrid::GetCellPoints(vtkIdType cellId, vtkIdType& npts,
                                         vtkIdType* &pts)
 {
-  vtkIdType loc;
-
-  loc = this->Locations->GetValue(cellId);
-
-  this->Connectivity->GetCell(loc,npts,pts);
+  this->Connectivity->GetCellAtId(cellId,npts,pts);
 }
 
 //----------------------------------------------------------------------------
@@ -1571,6 +1619,22 @@ void vtkUnstructuredGrid::Squeeze()
   vtkPointSet::Squeeze();
 }
 
+//----------------------------------------------------------------------------
+bool vtkUnstructuredGrid::ConvertTo32BitStorage()
+{
+  return this->Connectivity == nullptr ||
+    this->Connectivity->ConvertTo32BitStorage();
+}
+
+//----------------------------------------------------------------------------
+void vtkUnstructuredGrid::ConvertTo64BitStorage()
+{
+  if ( this->Connectivity )
+  {
+    this->Connectivity->ConvertTo64BitStorage();
+  }
+}
+
 //----------------------------------------------------------------------------
 // Remove a reference to a cell in a particular point's link list. You may
 // also consider using RemoveCellReference() to remove the references from
@@ -1608,10 +1672,7 @@ void vtkUnstructuredGrid::ResizeCellList(vtkIdType ptId, int size)
 void vtkUnstructuredGrid::InternalReplaceCell(vtkIdType cellId, int npts,
                                       const vtkIdType pts[])
 {
-  vtkIdType loc;
-
-  loc = this->Locations->GetValue(cellId);
-  this->Connectivity->ReplaceCell(loc,npts,pts);
+  this->Connectivity->ReplaceCellAtId(cellId,npts,pts);
 }
 
 //----------------------------------------------------------------------------
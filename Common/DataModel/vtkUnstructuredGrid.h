@@ -120,6 +120,20 @@ public:
   vtkUnsignedCharArray* GetCellTypesArray() { return this->Types; }
   vtkIdTypeArray* GetCellLocationsArray() { return this->Locations; }
   void Squeeze() override;
+
+  /**
+   * Store the connectivity as 32-bit integers, which halves its memory when
+   * vtkIdType is 64-bit (see vtkCellArray::ConvertTo32BitStorage()). The
+   * vtkIdType API is unchanged. Returns false, and leaves the cells
+   * unchanged, if the point ids do not fit.
+   */
+  bool ConvertTo32BitStorage();
+
+  /**
+   * Store the connectivity as vtkIdType, the default.
+   */
+  void ConvertTo64BitStorage();
+
   void Initialize() override;
   int GetMaxCellSize() override;
   void BuildLinks();
@@ -158,6 +172,11 @@ public:
    * (numCellFaces, numFace0Pts, id1, id2, id3, numFace1Pts,id1, id2, id3, ...)
    * The functions use vtkPolyhedron::DecomposeAPolyhedronCell() to convert
    * polyhedron cells into standard format.
+   * cellLocations gives the location of each cell in the legacy
+   * (npts, id1, id2, ...) array of cells (see vtkCellArray::GetData()).
+   * Cell i of the grid is the one found at cellLocations[i]: when the cells
+   * are not stored in that order, they are copied in that order in a new
+   * cell array, with matching locations.
    */
   void SetCells(int type, vtkCellArray *cells);
   void SetCells(int *types, vtkCellArray *cells);
@@ -87,6 +87,7 @@ static int TestScalarLogic();
 static int TestVectorLogic();
 static int TestMiscFunctions();
 static int TestErrors();
+static int TestEvaluateBatch();
 
 int UnitTestFunctionParser(int,char *[])
 {
@@ -121,6 +122,7 @@ int UnitTestFunctionParser(int,char *[])
 
   status += TestMiscFunctions();
   status += TestErrors();
+  status += TestEvaluateBatch();
   if (status != 0)
   {
     return EXIT_FAILURE;
@@ -1116,3 +1118,151 @@ int TestErrors()
   }
   return status;
 }
+
+int TestEvaluateBatch()
+{
+  std::cout << "Testing EvaluateBatch" << "...";
+
+  vtkSmartPointer<vtkFunctionParser> parser =
+    vtkSmartPointer<vtkFunctionParser>::New();
+  vtkSmartPointer<vtkTest::ErrorObserver> errorObserver =
+    vtkSmartPointer<vtkTest::ErrorObserver>::New();
+  parser->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+
+  // Values of s, t, v and w. Some of them make the functions invalid.
+  const vtkIdType n = 1000;
+  std::vector<double> values[8];
+  for (int i = 0; i < 8; ++i)
+  {
+    values[i].resize(n);
+    for (vtkIdType k = 0; k < n; ++k)
+    {
+      values[i][k] = k % 10 == 0 ? 0.0 : vtkMath::Random(-2.0, 2.0);
+    }
+  }
+  const char *functions[] = {
+    "s + t * 2 - s / t",
+    "-s ^ 2 + abs(t) + exp(s) + ceil(t) - floor(s)",
+    "ln(s) + log10(t) + log(s)",
+    "sqrt(s) + sin(t) * cos(s) + tan(t)",
+    "asin(s) + acos(t) + atan(s)",
+    "sinh(s) + cosh(t) + tanh(s) + sign(t)",
+    "min(s, t) + max(s, t)",
+    "if((s > t) | (s = t), s, t) + ((s < 0) & (t < 0))",
+    "v + w * s - t * iHat + jHat / s - kHat",
+    "cross(v, w) - v / t",
+    "norm(v) + if(s < t, v, -w)",
+    "mag(v) * (v . w) + mag(cross(v, w) + w)",
+    "-v"
+  };
+  const int numFunctions = sizeof(functions) / sizeof(functions[0]);
+
+  int status = 0;
+  for (int replace = 0; replace < 2; ++replace)
+  {
+    parser->SetReplaceInvalidValues(replace);
+    parser->SetReplacementValue(-123.0);
+    for (int f = 0; f < numFunctions; ++f)
+    {
+      parser->SetFunction(functions[f]);
+      parser->SetScalarVariableValue("s", 1.0);
+      parser->SetScalarVariableValue("t", 1.0);
+      parser->SetVectorVariableValue("v", 1.0, 1.0, 1.0);
+      parser->SetVectorVariableValue("w", 1.0, 1.0, 1.0);
+      bool scalar = parser->IsScalarResult() != 0;
+      int numComps = scalar ? 1 : 3;
+
+      // The variable indices follow the order of the first setting.
+      const double *scalarValues[2] = { values[0].data(), values[1].data() };
+      const double *vectorValues[6];
+      for (int i = 0; i < 6; ++i)
+      {
+        vectorValues[i] = values[i + 2].data();
+      }
+      std::vector<double> results[3];
+      double *resultPointers[3];
+      for (int c = 0; c < 3; ++c)
+      {
+        results[c].resize(n);
+        resultPointers[c] = results[c].data();
+      }
+      vtkIdType numInvalid = parser->EvaluateBatch(
+        n, scalarValues, vectorValues, resultPointers);
+
+      vtkIdType expectedInvalid = 0;
+      for (vtkIdType k = 0; k < n; ++k)
+      {
+        parser->SetScalarVariableValue("s", values[0][k]);
+        parser->SetScalarVariableValue("t", values[1][k]);
+        parser->SetVectorVariableValue(
+          "v", values[2][k], values[3][k], values[4][k]);
+        parser->SetVectorVariableValue(
+          "w", values[5][k], values[6][k], values[7][k]);
+        double *expected = scalar ? nullptr : parser->GetVectorResult();
+        double expectedScalar = scalar ? parser->GetScalarResult() : 0.0;
+        if (scalar)
+        {
+          expected = &expectedScalar;
+        }
+        if (expected[0] == VTK_PARSER_ERROR_RESULT)
+        {
+          ++expectedInvalid;
+        }
+        for (int c = 0; c < numComps; ++c)
+        {
+          if (results[c][k] != expected[c] &&
+              !(vtkMath::IsNan(results[c][k]) && vtkMath::IsNan(expected[c])))
+          {
+            std::cout << "\n" << functions[f] << ": value " << k
+                      << " component " << c << " expected " << expected[c]
+                      << " but got " << results[c][k];
+            ++status;
+            break;
+          }
+        }
+      }
+      if (numInvalid != expectedInvalid || (replace && numInvalid != 0))
+      {
+        std::cout << "\n" << functions[f] << ": expected " << expectedInvalid
+                  << " invalid values but got " << numInvalid;
+        ++status;
+      }
+    }
+  }
+
+  // Variables without values use the set value.
+  parser->SetFunction("s + t");
+  parser->SetScalarVariableValue("t", 10.0);
+  const double *scalarValues[2] = { values[0].data(), nullptr };
+  std::vector<double> sums(n);
+  double *sumPointer = sums.data();
+  parser->IsScalarResult();
+  parser->EvaluateBatch(n, scalarValues, nullptr, &sumPointer);
+  for (vtkIdType k = 0; k < n; ++k)
+  {
+    if (sums[k] != values[0][k] + 10.0)
+    {
+      std::cout << "\nWrong sum for value " << k;
+      ++status;
+      break;
+    }
+  }
+
+  // An unparsed function is an error.
+  parser->SetFunction("s +");
+  if (parser->EvaluateBatch(n, scalarValues, nullptr, &sumPointer) != -1)
+  {
+    std::cout << "\nAn invalid function was evaluated";
+    ++status;
+  }
+
+  if (status == 0)
+  {
+    std::cout << "PASSED\n";
+  }
+  else
+  {
+    std::cout << "FAILED\n";
+  }
+  return status;
+}
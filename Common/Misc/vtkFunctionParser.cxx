@@ -17,12 +17,16 @@
 
 #include <cctype>
 #include <algorithm>
+#include <vector>
 
 vtkStandardNewMacro(vtkFunctionParser);
 
 static double vtkParserVectorErrorResult[3] = { VTK_PARSER_ERROR_RESULT,
                                                 VTK_PARSER_ERROR_RESULT,
                                                 VTK_PARSER_ERROR_RESULT };
+
+// Number of values processed at once by EvaluateBatch().
+static const int vtkParserBatchSize = 256;
 //-----------------------------------------------------------------------------
 vtkFunctionParser::vtkFunctionParser()
 {
@@ -866,6 +870,517 @@ bool vtkFunctionParser::Evaluate()
   return true;
 }
 
+//-----------------------------------------------------------------------------
+// The stack holds blocks of vtkParserBatchSize values: stack position p
+// covers stack[p * vtkParserBatchSize, (p + 1) * vtkParserBatchSize).
+// Each case performs the operation of Evaluate(), in the same order, on the
+// n values of the block.
+vtkIdType vtkFunctionParser::EvaluateBatch(vtkIdType numValues,
+                                           const double* const* scalarValues,
+                                           const double* const* vectorValues,
+                                           double* const* results)
+{
+  if (this->FunctionMTime.GetMTime() > this->ParseMTime.GetMTime() ||
+      this->StackSize == 0)
+  {
+    return -1;
+  }
+
+  const int B = vtkParserBatchSize;
+  const int numScalars = this->GetNumberOfScalarVariables();
+  const double replacement = this->ReplacementValue;
+  const bool replace = this->ReplaceInvalidValues != 0;
+  std::vector<double> stackBuffer(static_cast<size_t>(this->StackSize) * B);
+  std::vector<unsigned char> invalidBuffer(B);
+  double *stack = stackBuffer.data();
+  unsigned char *invalid = invalidBuffer.data();
+  vtkIdType numInvalid = 0;
+
+  for (vtkIdType begin = 0; begin < numValues; begin += B)
+  {
+    const int n = static_cast<int>(std::min<vtkIdType>(B, numValues - begin));
+    int stackPosition = -1;
+    int numImmediatesProcessed = 0;
+    std::fill(invalid, invalid + n, 0);
+
+    for (int byte = 0; byte < this->ByteCodeSize; byte++)
+    {
+      // Top of the stack and the positions below it.
+      double *s0 = stack + stackPosition * B;
+      double *s1 = s0 - B;
+      double *s2 = s1 - B;
+      double *s3 = s2 - B;
+      switch (this->ByteCode[byte])
+      {
+        case VTK_PARSER_IMMEDIATE:
+          std::fill(s0 + B, s0 + B + n,
+                    this->Immediates[numImmediatesProcessed++]);
+          stackPosition++;
+          break;
+        case VTK_PARSER_UNARY_MINUS:
+        case VTK_PARSER_VECTOR_UNARY_MINUS:
+        {
+          int numComps =
+            this->ByteCode[byte] == VTK_PARSER_UNARY_MINUS ? 1 : 3;
+          for (int c = 0; c < numComps; c++)
+          {
+            double *x = s0 - c * B;
+            for (int k = 0; k < n; k++)
+            {
+              x[k] = -x[k];
+            }
+          }
+          break;
+        }
+        case VTK_PARSER_UNARY_PLUS:
+        case VTK_PARSER_VECTOR_UNARY_PLUS:
+          break;
+        case VTK_PARSER_ADD:
+          for (int k = 0; k < n; k++)
+          {
+            s1[k] += s0[k];
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_SUBTRACT:
+          for (int k = 0; k < n; k++)
+          {
+            s1[k] -= s0[k];
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_MULTIPLY:
+          for (int k = 0; k < n; k++)
+          {
+            s1[k] *= s0[k];
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_DIVIDE:
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] == 0)
+            {
+              s1[k] = replacement;
+              invalid[k] |= !replace;
+            }
+            else
+            {
+              s1[k] /= s0[k];
+            }
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_POWER:
+          for (int k = 0; k < n; k++)
+          {
+            s1[k] = pow(s1[k], s0[k]);
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_ABSOLUTE_VALUE:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = fabs(s0[k]);
+          }
+          break;
+        case VTK_PARSER_EXPONENT:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = exp(s0[k]);
+          }
+          break;
+        case VTK_PARSER_CEILING:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = ceil(s0[k]);
+          }
+          break;
+        case VTK_PARSER_FLOOR:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = floor(s0[k]);
+          }
+          break;
+        case VTK_PARSER_LOGARITHM:
+        case VTK_PARSER_LOGARITHME:
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] <= 0)
+            {
+              s0[k] = replacement;
+              invalid[k] |= !replace;
+            }
+            else
+            {
+              s0[k] = log(s0[k]);
+            }
+          }
+          break;
+        case VTK_PARSER_LOGARITHM10:
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] <= 0)
+            {
+              s0[k] = replacement;
+              invalid[k] |= !replace;
+            }
+            else
+            {
+              s0[k] = log10(s0[k]);
+            }
+          }
+          break;
+        case VTK_PARSER_SQUARE_ROOT:
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] < 0)
+            {
+              s0[k] = replacement;
+              invalid[k] |= !replace;
+            }
+            else
+            {
+              s0[k] = sqrt(s0[k]);
+            }
+          }
+          break;
+        case VTK_PARSER_SINE:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = sin(s0[k]);
+          }
+          break;
+        case VTK_PARSER_COSINE:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = cos(s0[k]);
+          }
+          break;
+        case VTK_PARSER_TANGENT:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = tan(s0[k]);
+          }
+          break;
+        case VTK_PARSER_ARCSINE:
+        case VTK_PARSER_ARCCOSINE:
+        {
+          bool sine = this->ByteCode[byte] == VTK_PARSER_ARCSINE;
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] < -1 || s0[k] > 1)
+            {
+              s0[k] = replacement;
+              invalid[k] |= !replace;
+            }
+            else
+            {
+              s0[k] = sine ? asin(s0[k]) : acos(s0[k]);
+            }
+          }
+          break;
+        }
+        case VTK_PARSER_ARCTANGENT:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = atan(s0[k]);
+          }
+          break;
+        case VTK_PARSER_HYPERBOLIC_SINE:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = sinh(s0[k]);
+          }
+          break;
+        case VTK_PARSER_HYPERBOLIC_COSINE:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = cosh(s0[k]);
+          }
+          break;
+        case VTK_PARSER_HYPERBOLIC_TANGENT:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = tanh(s0[k]);
+          }
+          break;
+        case VTK_PARSER_MIN:
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] < s1[k])
+            {
+              s1[k] = s0[k];
+            }
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_MAX:
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] > s1[k])
+            {
+              s1[k] = s0[k];
+            }
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_CROSS:
+        {
+          // U = (s5, s4, s3), V = (s2, s1, s0)
+          double *s4 = s3 - B;
+          double *s5 = s4 - B;
+          for (int k = 0; k < n; k++)
+          {
+            double x = s4[k]*s0[k] - s3[k]*s1[k];
+            double y = s3[k]*s2[k] - s5[k]*s0[k];
+            double z = s5[k]*s1[k] - s4[k]*s2[k];
+            s5[k] = x;
+            s4[k] = y;
+            s3[k] = z;
+          }
+          stackPosition -= 3;
+          break;
+        }
+        case VTK_PARSER_SIGN:
+          for (int k = 0; k < n; k++)
+          {
+            s0[k] = s0[k] < 0 ? -1 : (s0[k] == 0 ? 0 : 1);
+          }
+          break;
+        case VTK_PARSER_DOT_PRODUCT:
+        {
+          double *s4 = s3 - B;
+          double *s5 = s4 - B;
+          for (int k = 0; k < n; k++)
+          {
+            s3[k] *= s0[k];
+            s4[k] *= s1[k];
+            s5[k] *= s2[k];
+            s5[k] = s5[k] + s4[k] + s3[k];
+          }
+          stackPosition -= 5;
+          break;
+        }
+        case VTK_PARSER_VECTOR_ADD:
+        {
+          double *s4 = s3 - B;
+          double *s5 = s4 - B;
+          for (int k = 0; k < n; k++)
+          {
+            s3[k] += s0[k];
+            s4[k] += s1[k];
+            s5[k] += s2[k];
+          }
+          stackPosition -= 3;
+          break;
+        }
+        case VTK_PARSER_VECTOR_SUBTRACT:
+        {
+          double *s4 = s3 - B;
+          double *s5 = s4 - B;
+          for (int k = 0; k < n; k++)
+          {
+            s3[k] -= s0[k];
+            s4[k] -= s1[k];
+            s5[k] -= s2[k];
+          }
+          stackPosition -= 3;
+          break;
+        }
+        case VTK_PARSER_SCALAR_TIMES_VECTOR:
+          for (int k = 0; k < n; k++)
+          {
+            double scalar = s3[k];
+            s3[k] = s2[k] * scalar;
+            s2[k] = s1[k] * scalar;
+            s1[k] = s0[k] * scalar;
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_VECTOR_TIMES_SCALAR:
+          for (int k = 0; k < n; k++)
+          {
+            s3[k] *= s0[k];
+            s2[k] *= s0[k];
+            s1[k] *= s0[k];
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_VECTOR_OVER_SCALAR:
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] != 0.0)
+            {
+              s3[k] /= s0[k];
+              s2[k] /= s0[k];
+              s1[k] /= s0[k];
+            }
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_MAGNITUDE:
+          for (int k = 0; k < n; k++)
+          {
+            s2[k] = sqrt(pow(s0[k], 2) + pow(s1[k], 2) + pow(s2[k], 2));
+          }
+          stackPosition -= 2;
+          break;
+        case VTK_PARSER_NORMALIZE:
+          for (int k = 0; k < n; k++)
+          {
+            double magnitude =
+              sqrt(pow(s0[k], 2) + pow(s1[k], 2) + pow(s2[k], 2));
+            if (magnitude != 0)
+            {
+              s0[k] /= magnitude;
+              s1[k] /= magnitude;
+              s2[k] /= magnitude;
+            }
+          }
+          break;
+        case VTK_PARSER_IHAT:
+        case VTK_PARSER_JHAT:
+        case VTK_PARSER_KHAT:
+        {
+          int one = this->ByteCode[byte] - VTK_PARSER_IHAT;
+          for (int c = 0; c < 3; c++)
+          {
+            double *x = s0 + (c + 1) * B;
+            std::fill(x, x + n, c == one ? 1.0 : 0.0);
+          }
+          stackPosition += 3;
+          break;
+        }
+        case VTK_PARSER_LESS_THAN:
+          for (int k = 0; k < n; k++)
+          {
+            s1[k] = (s1[k] < s0[k]);
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_GREATER_THAN:
+          for (int k = 0; k < n; k++)
+          {
+            s1[k] = (s1[k] > s0[k]);
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_EQUAL_TO:
+          for (int k = 0; k < n; k++)
+          {
+            s1[k] = (s1[k] == s0[k]);
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_AND:
+          for (int k = 0; k < n; k++)
+          {
+            s1[k] = (s1[k] && s0[k]);
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_OR:
+          for (int k = 0; k < n; k++)
+          {
+            s1[k] = (s1[k] || s0[k]);
+          }
+          stackPosition--;
+          break;
+        case VTK_PARSER_IF:
+          // if(bool, valTrue, valFalse): s0 is the bool, s1 valTrue, s2
+          // valFalse and the result.
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] != 0.0)
+            {
+              s2[k] = s1[k];
+            }
+          }
+          stackPosition -= 2;
+          break;
+        case VTK_PARSER_VECTOR_IF:
+        {
+          // s0 is the bool, (s3, s2, s1) valTrue and (s6, s5, s4) valFalse
+          // and the result.
+          double *s4 = s3 - B;
+          double *s5 = s4 - B;
+          double *s6 = s5 - B;
+          for (int k = 0; k < n; k++)
+          {
+            if (s0[k] != 0.0)
+            {
+              s6[k] = s3[k];
+              s5[k] = s2[k];
+              s4[k] = s1[k];
+            }
+          }
+          stackPosition -= 4;
+          break;
+        }
+        default:
+        {
+          int variable = this->ByteCode[byte] - VTK_PARSER_BEGIN_VARIABLES;
+          if (variable < numScalars)
+          {
+            const double *values =
+              scalarValues ? scalarValues[variable] : nullptr;
+            double *x = s0 + B;
+            if (values)
+            {
+              std::copy(values + begin, values + begin + n, x);
+            }
+            else
+            {
+              std::fill(x, x + n, this->ScalarVariableValues[variable]);
+            }
+            stackPosition++;
+          }
+          else
+          {
+            int vectorNum = variable - numScalars;
+            for (int c = 0; c < 3; c++)
+            {
+              const double *values =
+                vectorValues ? vectorValues[3 * vectorNum + c] : nullptr;
+              double *x = s0 + (c + 1) * B;
+              if (values)
+              {
+                std::copy(values + begin, values + begin + n, x);
+              }
+              else
+              {
+                std::fill(x, x + n, this->VectorVariableValues[vectorNum][c]);
+              }
+            }
+            stackPosition += 3;
+          }
+        }
+      }
+    }
+
+    if (stackPosition != 0 && stackPosition != 2)
+    {
+      return -1;
+    }
+    for (int c = 0; c <= stackPosition; c++)
+    {
+      const double *x = stack + c * B;
+      double *result = results[c] + begin;
+      for (int k = 0; k < n; k++)
+      {
+        result[k] = invalid[k] ? VTK_PARSER_ERROR_RESULT : x[k];
+      }
+    }
+    for (int k = 0; k < n; k++)
+    {
+      numInvalid += invalid[k];
+    }
+  }
+
+  return numInvalid;
+}
+
 //-----------------------------------------------------------------------------
 int vtkFunctionParser::IsScalarResult()
 {
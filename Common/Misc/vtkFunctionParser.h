@@ -177,6 +177,33 @@ public:
     result[0] = r[0]; result[1] = r[1]; result[2] = r[2]; };
   //@}
 
+  /**
+   * Evaluate the function for numValues sets of variable values at once.
+   * The byte code is interpreted once per block of values instead of once
+   * per set, and each operation is applied to the whole block in a loop that
+   * the compiler can vectorize. The results are the same as the ones
+   * obtained by setting the variables and calling GetScalarResult() or
+   * GetVectorResult() for each set.
+   *
+   * scalarValues[i] points to the numValues values of scalar variable i,
+   * and vectorValues[3*i+c] to the numValues values of component c of
+   * vector variable i. A null pointer (or a null array of pointers) selects
+   * the value set with SetScalarVariableValue() or SetVectorVariableValue().
+   * The result is written to results[0] (scalar result) or to results[0],
+   * results[1] and results[2] (vector result), numValues values each.
+   *
+   * The function must have been parsed, e.g. by IsScalarResult(). This
+   * method does not modify the parser: it may be called by several threads
+   * at once. The values that cannot be computed (e.g. a division by zero
+   * when ReplaceInvalidValues is off) are set to VTK_PARSER_ERROR_RESULT,
+   * without reporting an error. Return the number of such values, or -1 if
+   * the function has not been parsed successfully.
+   */
+  vtkIdType EvaluateBatch(vtkIdType numValues,
+                          const double* const* scalarValues,
+                          const double* const* vectorValues,
+                          double* const* results);
+
   //@{
   /**
    * Set the value of a scalar variable.  If a variable with this name
@@ -22,7 +22,22 @@
 #include "vtkDataSetTriangleFilter.h"
 #include "vtkPointDataToCellData.h"
 #include "vtkImageDataToPointSet.h"
+#include "vtkCell.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
+#include "vtkObjectFactory.h"
+#include "vtkPointData.h"
+#include "vtkSphere.h"
+#include "vtkTestSMP.h"
+#include "vtkTriangle.h"
+#include "vtkUnstructuredGrid.h"
 #include <cassert>
+#include <cmath>
 
 bool TestStructured(int type)
 {
@@ -103,6 +118,218 @@ bool TestUnstructured()
   return true;
 }
 
+// Counts the evaluations of the cut function at the points of a dataset.
+class vtkCountingSphere : public vtkSphere
+{
+public:
+  static vtkCountingSphere *New();
+  vtkTypeMacro(vtkCountingSphere, vtkSphere);
+  void FunctionValue(vtkDataArray *input, vtkDataArray *output) override
+  {
+    this->NumberOfEvaluations++;
+    this->Superclass::FunctionValue(input, output);
+  }
+  int NumberOfEvaluations = 0;
+};
+vtkStandardNewMacro(vtkCountingSphere);
+
+double GetArea(vtkPolyData *output)
+{
+  double area = 0.0;
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType i = 0; i < output->GetNumberOfCells(); ++i)
+  {
+    output->GetCellPoints(i, ptIds);
+    double p0[3], p1[3], p2[3];
+    output->GetPoint(ptIds->GetId(0), p0);
+    output->GetPoint(ptIds->GetId(1), p1);
+    output->GetPoint(ptIds->GetId(2), p2);
+    area += vtkTriangle::TriangleArea(p0, p1, p2);
+  }
+  return area;
+}
+
+// Cut a grid of tetrahedra and hexahedra with a sphere, in parallel and with
+// the scalar tree, and compare with the serial output.
+bool TestUnstructuredLinear()
+{
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(21, 21, 21);
+  image->SetOrigin(-1.0, -1.0, -1.0);
+  image->SetSpacing(0.1, 0.1, 0.1);
+  vtkNew<vtkDoubleArray> pointScalars;
+  pointScalars->SetName("pointScalars");
+  pointScalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double p[3];
+    image->GetPoint(i, p);
+    pointScalars->SetValue(i, p[0] + 2.0 * p[1] - p[2]);
+  }
+  image->GetPointData()->AddArray(pointScalars);
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("cellIds");
+  cellIds->SetNumberOfTuples(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, i);
+  }
+  image->GetCellData()->AddArray(cellIds);
+
+  vtkNew<vtkDataSetTriangleFilter> tetraFilter;
+  tetraFilter->SetInputData(image);
+  tetraFilter->Update();
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->DeepCopy(tetraFilter->GetOutput());
+  vtkIdTypeArray *gridCellIds = vtkArrayDownCast<vtkIdTypeArray>(
+    grid->GetCellData()->GetArray("cellIds"));
+  vtkNew<vtkIdList> ptIds;
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); i += 3)
+  {
+    image->GetCellPoints(i, ptIds);
+    gridCellIds->InsertNextValue(i);
+    grid->InsertNextCell(VTK_VOXEL, ptIds);
+  }
+
+  vtkNew<vtkCountingSphere> sphere;
+  sphere->SetCenter(0.1, -0.2, 0.05);
+  sphere->SetRadius(0.5);
+
+  vtkNew<vtkCutter> serialCutter;
+  serialCutter->SetCutFunction(sphere);
+  serialCutter->SetInputData(grid);
+  serialCutter->GenerateCutScalarsOn();
+
+  vtkNew<vtkCutter> cutter;
+  cutter->SetCutFunction(sphere);
+  cutter->SetInputData(grid);
+  cutter->GenerateCutScalarsOn();
+  cutter->UseScalarTreeOn();
+
+  const double values[3] = { 0.0, 0.1, -0.15 };
+  for (int i = 0; i < 4; ++i)
+  {
+    if (i == 3)
+    {
+      sphere->SetRadius(0.3);
+    }
+    serialCutter->SetValue(0, values[i % 3]);
+    vtkTest::RunThreaded(1, [&]() { serialCutter->Update(); });
+    int evaluations = sphere->NumberOfEvaluations;
+    cutter->SetValue(0, values[i % 3]);
+    vtkTest::RunThreaded(4, [&]() { cutter->Update(); });
+
+    // The values of the function are only computed again when it changes.
+    if (sphere->NumberOfEvaluations != evaluations + (i == 0 || i == 3))
+    {
+      cerr << "Unexpected evaluations of the cut function" << endl;
+      return false;
+    }
+
+    vtkPolyData *expected = serialCutter->GetOutput();
+    vtkPolyData *output = cutter->GetOutput();
+    double area = GetArea(output);
+    double expectedArea = GetArea(expected);
+    double bounds[6], expectedBounds[6];
+    output->GetBounds(bounds);
+    expected->GetBounds(expectedBounds);
+    if (output->GetNumberOfPolys() < expected->GetNumberOfPolys() ||
+        std::abs(area - expectedArea) > 1e-6 * expectedArea)
+    {
+      cerr << "Unexpected cut surface: " << output->GetNumberOfPolys()
+           << " triangles of area " << area << " instead of "
+           << expected->GetNumberOfPolys() << " of area " << expectedArea
+           << endl;
+      return false;
+    }
+    for (int j = 0; j < 6; ++j)
+    {
+      if (std::abs(bounds[j] - expectedBounds[j]) > 1e-6)
+      {
+        cerr << "Unexpected bounds of the cut surface" << endl;
+        return false;
+      }
+    }
+
+    vtkDataArray *cutScalars = output->GetPointData()->GetScalars();
+    vtkDataArray *outCellIds = output->GetCellData()->GetArray("cellIds");
+    if (!cutScalars || !outCellIds ||
+        !output->GetPointData()->GetArray("pointScalars") ||
+        outCellIds->GetNumberOfTuples() != output->GetNumberOfCells())
+    {
+      cerr << "Missing attributes on the cut surface" << endl;
+      return false;
+    }
+    for (vtkIdType j = 0; j < output->GetNumberOfPoints(); ++j)
+    {
+      if (std::abs(cutScalars->GetTuple1(j) - values[i % 3]) > 1e-6)
+      {
+        cerr << "Unexpected cut scalars" << endl;
+        return false;
+      }
+    }
+    // Each triangle lies in the voxel it has been cut from.
+    for (vtkIdType j = 0; j < output->GetNumberOfCells(); ++j)
+    {
+      double p[3], cellBounds[6];
+      output->GetPoint(output->GetCell(j)->GetPointId(0), p);
+      image->GetCellBounds(static_cast<vtkIdType>(outCellIds->GetTuple1(j)),
+                           cellBounds);
+      for (int k = 0; k < 3; ++k)
+      {
+        if (p[k] < cellBounds[2 * k] - 1e-6 || p[k] > cellBounds[2 * k + 1] + 1e-6)
+        {
+          cerr << "Unexpected cell data on the cut surface" << endl;
+          return false;
+        }
+      }
+    }
+  }
+
+  // Without the scalar tree, the grid is cut in parallel on several threads
+  // only.
+  vtkNew<vtkCutter> threadedCutter;
+  threadedCutter->SetCutFunction(sphere);
+  threadedCutter->SetInputData(grid);
+  threadedCutter->SetValue(0, values[0]);
+  vtkTest::RunThreaded(4, [&]() { threadedCutter->Update(); });
+  double area = GetArea(threadedCutter->GetOutput());
+  double expectedArea = GetArea(serialCutter->GetOutput());
+  if (threadedCutter->GetOutput()->GetNumberOfPolys() <
+        serialCutter->GetOutput()->GetNumberOfPolys() ||
+      std::abs(area - expectedArea) > 1e-6 * expectedArea)
+  {
+    cerr << "Unexpected cut surface on several threads" << endl;
+    return false;
+  }
+
+  // Sorting by cell with several values, or a locator, is only honored by
+  // the serial cutter, which evaluates the function at each execution.
+  cutter->SetSortByToSortByCell();
+  cutter->Update();
+  int evaluations = sphere->NumberOfEvaluations;
+  cutter->SetValue(1, values[1]);
+  cutter->Update();
+  if (sphere->NumberOfEvaluations != evaluations + 1)
+  {
+    cerr << "Triangles sorted by cell by the parallel cutter" << endl;
+    return false;
+  }
+  vtkNew<vtkMergePoints> locator;
+  cutter->SetSortByToSortByValue();
+  cutter->SetLocator(locator);
+  cutter->Update();
+  evaluations = sphere->NumberOfEvaluations;
+  cutter->SetValue(1, values[2]);
+  cutter->Update();
+  if (sphere->NumberOfEvaluations != evaluations + 1)
+  {
+    cerr << "Locator ignored by the parallel cutter" << endl;
+    return false;
+  }
+  return true;
+}
+
 int TestCutter(int, char *[])
 {
   for(int type=0; type<2; type++)
@@ -120,5 +347,11 @@ int TestCutter(int, char *[])
     return EXIT_FAILURE;
   }
 
+  if(!TestUnstructuredLinear())
+  {
+    cerr<<"Cutting Unstructured in parallel failed"<<endl;
+    return EXIT_FAILURE;
+  }
+
   return EXIT_SUCCESS;
 }
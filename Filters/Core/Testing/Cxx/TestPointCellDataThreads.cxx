@@ -0,0 +1,249 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPointCellDataThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkCellDataToPointData and vtkPointDataToCellData produce the
+// same arrays with one and with several threads, on structured and
+// unstructured datasets.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellDataToPointData.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPointDataToCellData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTestArrays.h"
+#include "vtkTestSMP.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+
+// Add floating point and integer arrays to the point and cell data.
+void AddFields(vtkDataSet *data)
+{
+  vtkIdType numPts = data->GetNumberOfPoints();
+  vtkNew<vtkDoubleArray> distance;
+  distance->SetName("distance");
+  distance->SetNumberOfTuples(numPts);
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  vtkNew<vtkIntArray> labels;
+  labels->SetName("labels");
+  labels->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3];
+    data->GetPoint(i, x);
+    distance->SetValue(i, 0.1 * i + x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+    vectors->SetTuple3(i, x[1] - 0.3 * i, x[2] * x[0], 1.0 / (i + 3.0));
+    labels->SetValue(i, static_cast<int>((i * 37) % 101));
+  }
+  data->GetPointData()->SetScalars(distance);
+  data->GetPointData()->SetVectors(vectors);
+  data->GetPointData()->AddArray(labels);
+
+  vtkIdType numCells = data->GetNumberOfCells();
+  vtkNew<vtkDoubleArray> pressure;
+  pressure->SetName("pressure");
+  pressure->SetNumberOfTuples(numCells);
+  vtkNew<vtkIntArray> pairs;
+  pairs->SetName("pairs");
+  pairs->SetNumberOfComponents(2);
+  pairs->SetNumberOfTuples(numCells);
+  vtkNew<vtkUnsignedCharArray> materials;
+  materials->SetName("materials");
+  materials->SetNumberOfTuples(numCells);
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    pressure->SetValue(i, 1.0 / (i + 1.0) + 0.01 * (i % 13));
+    pairs->SetTuple2(i, (i * 7) % 19, -(i * 5) % 23);
+    materials->SetValue(i, static_cast<unsigned char>((i * 11) % 250));
+  }
+  data->GetCellData()->AddArray(pressure);
+  data->GetCellData()->AddArray(pairs);
+  data->GetCellData()->AddArray(materials);
+}
+
+int Compare(vtkDataSet *input, const char *name)
+{
+  for (int option = 0; option < 4; ++option)
+  {
+    vtkSmartPointer<vtkDataSet> outputs[2];
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+      if (option < 3)
+      {
+        vtkNew<vtkCellDataToPointData> c2p;
+        c2p->SetInputData(input);
+        c2p->SetContributingCellOption(option);
+        vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { c2p->Update(); });
+        outputs[parallel] = c2p->GetOutput();
+      }
+      else
+      {
+        vtkNew<vtkPointDataToCellData> p2c;
+        p2c->SetInputData(input);
+        p2c->PassPointDataOn();
+        vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { p2c->Update(); });
+        outputs[parallel] = p2c->GetOutput();
+      }
+    }
+
+    if (!vtkTest::SameArrays(outputs[0]->GetPointData(),
+                             outputs[1]->GetPointData()) ||
+        !vtkTest::SameArrays(outputs[0]->GetCellData(),
+                             outputs[1]->GetCellData()))
+    {
+      std::cerr << "The parallel output differs for the " << name;
+      if (option < 3)
+      {
+        std::cerr << " (cell to point data, option " << option << ")";
+      }
+      else
+      {
+        std::cerr << " (point to cell data)";
+      }
+      std::cerr << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+// A structured grid, possibly flat, with slightly warped points.
+void MakeStructuredGrid(vtkStructuredGrid *grid, int nx, int ny, int nz)
+{
+  vtkNew<vtkPoints> points;
+  for (int k = 0; k < nz; ++k)
+  {
+    for (int j = 0; j < ny; ++j)
+    {
+      for (int i = 0; i < nx; ++i)
+      {
+        points->InsertNextPoint(i + 0.1 * j, j + 0.05 * k * k, k + 0.2 * i);
+      }
+    }
+  }
+  grid->SetDimensions(nx, ny, nz);
+  grid->SetPoints(points);
+}
+
+}
+
+int TestPointCellDataThreads(int, char *[])
+{
+  vtkNew<vtkImageData> image;
+  image->SetExtent(-3, 4, 0, 6, 1, 5);
+  image->SetSpacing(0.5, 0.25, 1.0);
+  AddFields(image);
+  if (Compare(image, "image") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkImageData> slice;
+  slice->SetDimensions(9, 1, 7);
+  AddFields(slice);
+  if (Compare(slice, "image slice") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkRectilinearGrid> rectilinear;
+  rectilinear->SetDimensions(6, 5, 4);
+  vtkNew<vtkDoubleArray> coordinates[3];
+  for (int axis = 0; axis < 3; ++axis)
+  {
+    for (int i = 0; i < rectilinear->GetDimensions()[axis]; ++i)
+    {
+      coordinates[axis]->InsertNextValue(i * i * 0.1 + i);
+    }
+  }
+  rectilinear->SetXCoordinates(coordinates[0]);
+  rectilinear->SetYCoordinates(coordinates[1]);
+  rectilinear->SetZCoordinates(coordinates[2]);
+  AddFields(rectilinear);
+  if (Compare(rectilinear, "rectilinear grid") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkStructuredGrid> structured;
+  MakeStructuredGrid(structured, 7, 6, 5);
+  AddFields(structured);
+  if (Compare(structured, "structured grid") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkStructuredGrid> surface;
+  MakeStructuredGrid(surface, 1, 8, 6);
+  AddFields(surface);
+  if (Compare(surface, "structured surface") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Tetrahedra, plus triangles and vertices sharing some of their points to
+  // exercise the contributing cell options.
+  vtkNew<vtkImageData> block;
+  block->SetDimensions(7, 6, 5);
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputData(block);
+  tetrahedralize->Update();
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->DeepCopy(tetrahedralize->GetOutput());
+  for (vtkIdType i = 0; i + 8 < grid->GetNumberOfPoints(); i += 11)
+  {
+    vtkIdType pts[3] = { i, i + 1, i + 8 };
+    grid->InsertNextCell(VTK_TRIANGLE, 3, pts);
+    grid->InsertNextCell(VTK_VERTEX, 1, pts + 2);
+  }
+  AddFields(grid);
+  if (Compare(grid, "unstructured grid") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(24);
+  sphere->SetPhiResolution(16);
+  sphere->Update();
+  vtkNew<vtkPolyData> polyData;
+  polyData->DeepCopy(sphere->GetOutput());
+  vtkNew<vtkCellArray> lines;
+  for (vtkIdType i = 0; i + 5 < polyData->GetNumberOfPoints(); i += 9)
+  {
+    vtkIdType pts[2] = { i, i + 5 };
+    lines->InsertNextCell(2, pts);
+  }
+  polyData->SetLines(lines);
+  polyData->GetPointData()->Initialize();
+  AddFields(polyData);
+  return Compare(polyData, "polydata");
+}
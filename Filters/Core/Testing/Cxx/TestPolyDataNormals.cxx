@@ -0,0 +1,198 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPolyDataNormals.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkPolyDataNormals produces the same output with one and with
+// several threads, with and without splitting and consistent ordering.
+
+#include "vtkAppendPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCubeSource.h"
+#include "vtkCylinderSource.h"
+#include "vtkFloatArray.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkPolyDataNormals.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestArrays.h"
+#include "vtkTestSMP.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// The last cells of the surface are the faces of a cube centered at
+// center: their normal must be along the direction of the center of the
+// face, whatever the orientation of the face.
+bool CheckCubeNormals(vtkPolyData *surface, const double center[3])
+{
+  vtkDataArray *cellNormals = surface->GetCellData()->GetNormals();
+  if (!cellNormals || surface->GetNumberOfPolys() < 6)
+  {
+    return false;
+  }
+  vtkIdType npts;
+  vtkIdType *pts;
+  for (vtkIdType c = surface->GetNumberOfPolys() - 6;
+       c < surface->GetNumberOfPolys(); ++c)
+  {
+    double faceCenter[3] = { 0.0, 0.0, 0.0 };
+    surface->GetPolys()->GetCellAtId(c, npts, pts);
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      double p[3];
+      surface->GetPoint(pts[i], p);
+      for (int j = 0; j < 3; ++j)
+      {
+        faceCenter[j] += p[j] / npts;
+      }
+    }
+    double direction[3];
+    vtkMath::Subtract(faceCenter, center, direction);
+    vtkMath::Normalize(direction);
+    double normal[3];
+    cellNormals->GetTuple(c, normal);
+    if (std::abs(std::abs(vtkMath::Dot(normal, direction)) - 1.0) > 1e-6)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool SameSurfaces(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfPolys() != b->GetNumberOfPolys())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+    {
+      return false;
+    }
+  }
+  vtkIdType aNpts, bNpts;
+  vtkIdType *aPts, *bPts;
+  for (vtkIdType c = 0; c < a->GetNumberOfPolys(); ++c)
+  {
+    a->GetPolys()->GetCellAtId(c, aNpts, aPts);
+    b->GetPolys()->GetCellAtId(c, bNpts, bPts);
+    if (aNpts != bNpts)
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < aNpts; ++i)
+    {
+      if (aPts[i] != bPts[i])
+      {
+        return false;
+      }
+    }
+  }
+  return vtkTest::SameArrays(a->GetPointData(), b->GetPointData()) &&
+    vtkTest::SameArrays(a->GetCellData(), b->GetCellData());
+}
+
+}
+
+int TestPolyDataNormals(int, char *[])
+{
+  // A smooth surface, a prism whose side edges are sharp enough to be
+  // split and a cube. Some polygons are reversed, so that the points have
+  // several regions around them without consistent ordering.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(60);
+  sphere->SetPhiResolution(40);
+  vtkNew<vtkCylinderSource> cylinder;
+  cylinder->SetResolution(6);
+  cylinder->SetCenter(3.0, 0.0, 0.0);
+  vtkNew<vtkCubeSource> cube;
+  double cubeCenter[3] = { -3.0, 0.0, 0.0 };
+  cube->SetCenter(cubeCenter);
+  vtkNew<vtkAppendPolyData> append;
+  append->AddInputConnection(sphere->GetOutputPort());
+  append->AddInputConnection(cylinder->GetOutputPort());
+  append->AddInputConnection(cube->GetOutputPort());
+  append->Update();
+
+  vtkNew<vtkPolyData> surface;
+  surface->DeepCopy(append->GetOutput());
+  surface->GetPointData()->SetNormals(nullptr);
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(surface->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < surface->GetNumberOfPoints(); ++i)
+  {
+    scalars->SetValue(i, static_cast<float>(i % 17));
+  }
+  surface->GetPointData()->SetScalars(scalars);
+  vtkIdType npts;
+  vtkIdType *pts;
+  for (vtkIdType c = 0; c < surface->GetNumberOfPolys(); c += 7)
+  {
+    surface->GetPolys()->GetCellAtId(c, npts, pts);
+    std::reverse(pts, pts + npts);
+  }
+
+  for (int splitting = 0; splitting < 2; ++splitting)
+  {
+    for (int consistency = 0; consistency < 2; ++consistency)
+    {
+      vtkSmartPointer<vtkPolyData> outputs[2];
+      for (int parallel = 0; parallel < 2; ++parallel)
+      {
+        vtkNew<vtkPolyDataNormals> normals;
+        normals->SetInputData(surface);
+        normals->SetSplitting(splitting);
+        normals->SetConsistency(consistency);
+        normals->SetFeatureAngle(45.0);
+        normals->ComputeCellNormalsOn();
+        vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { normals->Update(); });
+        outputs[parallel] = normals->GetOutput();
+      }
+      if (splitting &&
+          outputs[0]->GetNumberOfPoints() <= surface->GetNumberOfPoints())
+      {
+        std::cerr << "No point was split" << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (!CheckCubeNormals(outputs[1], cubeCenter))
+      {
+        std::cerr << "Wrong normals of the cube faces (splitting: "
+                  << splitting << ", consistency: " << consistency << ")"
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (!SameSurfaces(outputs[0], outputs[1]))
+      {
+        std::cerr << "The parallel output differs (splitting: " << splitting
+                  << ", consistency: " << consistency << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
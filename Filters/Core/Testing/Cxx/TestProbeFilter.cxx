@@ -18,8 +18,13 @@
 #include "vtkArrayCalculator.h"
 #include "vtkNew.h"
 #include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
 #include "vtkPointData.h"
 #include "vtkDataArray.h"
+#include "vtkTestSMP.h"
+
+#include <cmath>
 
 // Gets the number of points the probe filter counted as valid.
 // The parameter should be the output of the probe filter
@@ -85,9 +90,61 @@ int TestProbeFilterThreshold()
   return (validIgnore == 2) ? 0 : 1;
 }
 
-// Currently only tests the ComputeThreshold and Threshold.  Other tests
-// should be added
+// Probes an image with a finer image, which goes through the threaded path
+// for image inputs, and checks that the scratch cells of the threads are
+// reused from one source cell to the next.
+int TestProbeFilterImageData()
+{
+  vtkNew<vtkImageData> source;
+  source->SetDimensions(11, 11, 11);
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  for (vtkIdType i = 0; i < source->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    source->GetPoint(i, x);
+    scalars->InsertNextValue(x[0] + 2 * x[1] + 3 * x[2]);
+  }
+  source->GetPointData()->SetScalars(scalars);
+
+  vtkNew<vtkImageData> input;
+  input->SetDimensions(21, 21, 21);
+  input->SetSpacing(0.5, 0.5, 0.5);
+
+  vtkNew<vtkProbeFilter> probe;
+  probe->SetInputData(input);
+  probe->SetSourceData(source);
+  vtkTest::RunThreaded(4, [&]() { probe->Update(); });
+
+  vtkDataSet* output = probe->GetOutput();
+  vtkDataArray* probed = output->GetPointData()->GetArray("scalars");
+  if (!probed || GetNumberOfValidPoints(output) != 21 * 21 * 21)
+  {
+    return 1;
+  }
+  for (vtkIdType i = 0; i < output->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    output->GetPoint(i, x);
+    if (std::abs(probed->GetTuple1(i) - (x[0] + 2 * x[1] + 3 * x[2])) > 1e-9)
+    {
+      return 1;
+    }
+  }
+
+  vtkIdType allocations = probe->GetNumberOfScratchCellAllocations();
+  if (allocations < 1 || allocations > 4 ||
+      allocations + probe->GetNumberOfScratchCellReuses() !=
+        source->GetNumberOfCells())
+  {
+    return 1;
+  }
+  return 0;
+}
+
+// Currently only tests the ComputeThreshold and Threshold, and the probing
+// of image data.  Other tests should be added
 int TestProbeFilter(int, char*[])
 {
-  return TestProbeFilterThreshold();
+  return TestProbeFilterThreshold() || TestProbeFilterImageData();
 }
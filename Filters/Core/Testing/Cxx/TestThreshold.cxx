@@ -14,6 +14,7 @@
 =========================================================================*/
 #include "vtkSmartPointer.h"
 #include "vtkNew.h"
+#include "vtkObjectFactory.h"
 #include "vtkThreshold.h"
 #include "vtkRTAnalyticSource.h"
 #include "vtkDataObject.h"
@@ -21,9 +22,264 @@
 #include "vtkImageData.h"
 #include "vtkPointData.h"
 #include "vtkFloatArray.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkPoints.h"
+#include "vtkTestSMP.h"
+
+#include <vector>
+
+namespace
+{
+
+// Threshold an unstructured grid of interleaved hexahedra and vertices whose
+// point ids are shuffled, and compare the output to the one of a serial
+// traversal of the cells, in which the points are numbered by first use.
+bool CheckOrdering()
+{
+  const int dim = 12;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("scalars");
+  vtkNew<vtkIdTypeArray> pointIds;
+  pointIds->SetName("pointIds");
+  const vtkIdType numPts = dim * dim * dim;
+  // Point (i, j, k) is stored at index perm(i + dim * (j + dim * k)).
+  std::vector<vtkIdType> perm(numPts);
+  for (vtkIdType p = 0; p < numPts; ++p)
+  {
+    perm[p] = (p * 7919) % numPts;
+  }
+  points->SetNumberOfPoints(numPts);
+  scalars->SetNumberOfTuples(numPts);
+  pointIds->SetNumberOfTuples(numPts);
+  for (int k = 0; k < dim; ++k)
+  {
+    for (int j = 0; j < dim; ++j)
+    {
+      for (int i = 0; i < dim; ++i)
+      {
+        vtkIdType p = perm[i + dim * (j + dim * k)];
+        points->SetPoint(p, i, j, k);
+        scalars->SetValue(p, static_cast<float>((i * j + k) % 11));
+        pointIds->SetValue(p, p);
+      }
+    }
+  }
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+  grid->GetPointData()->AddArray(pointIds);
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("cellIds");
+  for (int k = 0; k < dim - 1; ++k)
+  {
+    for (int j = 0; j < dim - 1; ++j)
+    {
+      for (int i = 0; i < dim - 1; ++i)
+      {
+        vtkIdType hex[8];
+        for (int c = 0; c < 8; ++c)
+        {
+          int ci = i + ((c & 1) ^ ((c >> 1) & 1));
+          int cj = j + ((c >> 1) & 1);
+          int ck = k + ((c >> 2) & 1);
+          hex[c] = perm[ci + dim * (cj + dim * ck)];
+        }
+        cellIds->InsertNextValue(grid->InsertNextCell(VTK_HEXAHEDRON, 8, hex));
+        cellIds->InsertNextValue(grid->InsertNextCell(VTK_VERTEX, 1, hex + 6));
+      }
+    }
+  }
+  grid->GetCellData()->AddArray(cellIds);
+
+  vtkNew<vtkThreshold> filter;
+  filter->SetInputData(grid);
+  filter->ThresholdBetween(2.0, 6.0);
+  for (int allScalars = 0; allScalars < 2; ++allScalars)
+  {
+    filter->SetAllScalars(allScalars);
+    vtkTest::RunThreaded(4, [&]() { filter->Update(); });
+    vtkUnstructuredGrid *output = filter->GetOutput();
+
+    // Serial reference.
+    std::vector<vtkIdType> pointMap(numPts, -1);
+    vtkIdType numNewPts = 0;
+    vtkIdType newCellId = 0;
+    vtkNew<vtkIdList> cellPts;
+    vtkNew<vtkIdList> outCellPts;
+    vtkIdTypeArray *outCellIds = vtkArrayDownCast<vtkIdTypeArray>(
+      output->GetCellData()->GetArray("cellIds"));
+    vtkIdTypeArray *outPointIds = vtkArrayDownCast<vtkIdTypeArray>(
+      output->GetPointData()->GetArray("pointIds"));
+    if (!outCellIds || !outPointIds)
+    {
+      std::cerr << "Missing attributes" << std::endl;
+      return false;
+    }
+    for (vtkIdType cellId = 0; cellId < grid->GetNumberOfCells(); ++cellId)
+    {
+      grid->GetCellPoints(cellId, cellPts);
+      int keep = allScalars;
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+      {
+        float s = scalars->GetValue(cellPts->GetId(i));
+        bool in = s >= 2.0 && s <= 6.0;
+        keep = allScalars ? (keep && in) : (keep || in);
+      }
+      if (!keep)
+      {
+        continue;
+      }
+      if (newCellId >= output->GetNumberOfCells() ||
+          outCellIds->GetValue(newCellId) != cellId ||
+          output->GetCellType(newCellId) != grid->GetCellType(cellId))
+      {
+        std::cerr << "Wrong output cell " << newCellId << std::endl;
+        return false;
+      }
+      output->GetCellPoints(newCellId, outCellPts);
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+      {
+        vtkIdType ptId = cellPts->GetId(i);
+        if (pointMap[ptId] < 0)
+        {
+          pointMap[ptId] = numNewPts++;
+        }
+        double x[3], y[3];
+        grid->GetPoint(ptId, x);
+        output->GetPoint(pointMap[ptId], y);
+        if (outCellPts->GetId(i) != pointMap[ptId] ||
+            outPointIds->GetValue(pointMap[ptId]) != ptId ||
+            x[0] != y[0] || x[1] != y[1] || x[2] != y[2])
+        {
+          std::cerr << "Wrong point " << i << " of output cell " << newCellId
+                    << std::endl;
+          return false;
+        }
+      }
+      ++newCellId;
+    }
+    if (newCellId != output->GetNumberOfCells() ||
+        numNewPts != output->GetNumberOfPoints())
+    {
+      std::cerr << "Wrong output size" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Expose the evaluation of the threshold criterion to subclasses, and
+// install a criterion of its own.
+class vtkTestThreshold : public vtkThreshold
+{
+public:
+  static vtkTestThreshold *New();
+  vtkTypeMacro(vtkTestThreshold, vtkThreshold);
+  using vtkThreshold::EvaluateComponents;
+  using vtkThreshold::EvaluateCell;
+
+  void ThresholdOutside(double lower, double upper)
+  {
+    this->LowerThreshold = lower;
+    this->UpperThreshold = upper;
+    this->ThresholdFunction =
+      static_cast<int (vtkThreshold::*)(double)>(&vtkTestThreshold::Outside);
+    this->Modified();
+  }
+
+protected:
+  int Outside(double s)
+  {
+    return (s < this->LowerThreshold || s > this->UpperThreshold) ? 1 : 0;
+  }
+};
+vtkStandardNewMacro(vtkTestThreshold);
+
+bool CheckEvaluation()
+{
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetNumberOfComponents(2);
+  const float values[6] = { 1.0f, 5.0f, 3.0f, 4.0f, 7.0f, 0.0f };
+  for (int i = 0; i < 3; ++i)
+  {
+    scalars->InsertNextTuple2(values[2 * i], values[2 * i + 1]);
+  }
+  vtkNew<vtkIdList> cellPts;
+  cellPts->InsertNextId(0);
+  cellPts->InsertNextId(2);
+
+  vtkNew<vtkTestThreshold> filter;
+  filter->ThresholdBetween(2.0, 4.5);
+  filter->SetComponentModeToUseSelected();
+  filter->SetSelectedComponent(1);
+  if (filter->EvaluateComponents(scalars, 0) ||
+      !filter->EvaluateComponents(scalars, 1) ||
+      !filter->EvaluateCell(scalars, cellPts, 2) ||
+      filter->EvaluateCell(scalars, 0, cellPts, 1))
+  {
+    std::cerr << "Wrong evaluation of the selected component" << std::endl;
+    return false;
+  }
+  filter->SetComponentModeToUseAll();
+  if (filter->EvaluateComponents(scalars, 0) ||
+      !filter->EvaluateComponents(scalars, 1) ||
+      !filter->EvaluateCell(scalars, cellPts, 2))
+  {
+    std::cerr << "Wrong evaluation of all the components" << std::endl;
+    return false;
+  }
+  filter->SetComponentModeToUseAny();
+  filter->ThresholdByUpper(6.0);
+  if (filter->EvaluateComponents(scalars, 1) ||
+      !filter->EvaluateComponents(scalars, 2))
+  {
+    std::cerr << "Wrong evaluation of any component" << std::endl;
+    return false;
+  }
+
+  // The criterion of the subclass is used, by the filter too.
+  filter->ThresholdOutside(2.0, 4.5);
+  filter->SetComponentModeToUseSelected();
+  if (!filter->EvaluateComponents(scalars, 0) ||
+      filter->EvaluateComponents(scalars, 1) ||
+      !filter->EvaluateComponents(scalars, 2))
+  {
+    std::cerr << "Wrong evaluation of the subclass criterion" << std::endl;
+    return false;
+  }
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->SetPoints(points);
+  for (vtkIdType i = 0; i < 3; ++i)
+  {
+    points->InsertNextPoint(i, 0.0, 0.0);
+    grid->InsertNextCell(VTK_VERTEX, 1, &i);
+  }
+  grid->GetPointData()->SetScalars(scalars);
+  filter->SetInputData(grid);
+  vtkTest::RunThreaded(4, [&]() { filter->Update(); });
+  if (filter->GetOutput()->GetNumberOfCells() != 2 ||
+      filter->GetOutput()->GetPoint(1)[0] != 2.0)
+  {
+    std::cerr << "Wrong output with the subclass criterion" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}
 
 int TestThreshold(int, char *[])
 {
+  if (!CheckOrdering() || !CheckEvaluation())
+  {
+    return EXIT_FAILURE;
+  }
+
   //---------------------------------------------------
   // Test using different thresholding methods
   //---------------------------------------------------
@@ -0,0 +1,314 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    UnitTestGlyph3D.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkGlyph3D produces the same output with one and with several
+// threads, and that the instances describe the same glyphs as the geometry.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkConeSource.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkGlyph3D.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkMath.h"
+#include "vtkMinimalStandardRandomSequence.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestArrays.h"
+#include "vtkTestSMP.h"
+#include "vtkTransform.h"
+
+#include <cmath>
+
+namespace
+{
+
+bool SameCells(vtkCellArray *a, vtkCellArray *b)
+{
+  if (a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkIdType aNpts, bNpts;
+  vtkIdType *aPts, *bPts;
+  for (vtkIdType c = 0; c < a->GetNumberOfCells(); ++c)
+  {
+    a->GetCellAtId(c, aNpts, aPts);
+    b->GetCellAtId(c, bNpts, bPts);
+    if (aNpts != bNpts)
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < aNpts; ++i)
+    {
+      if (aPts[i] != bPts[i])
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool SameGlyphs(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetPoints()->GetDataType() != b->GetPoints()->GetDataType())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+    {
+      return false;
+    }
+  }
+  return SameCells(a->GetVerts(), b->GetVerts()) &&
+    SameCells(a->GetLines(), b->GetLines()) &&
+    SameCells(a->GetPolys(), b->GetPolys()) &&
+    SameCells(a->GetStrips(), b->GetStrips()) &&
+    vtkTest::SameArrays(a->GetPointData(), b->GetPointData()) &&
+    vtkTest::SameArrays(a->GetCellData(), b->GetCellData());
+}
+
+vtkSmartPointer<vtkPolyData> CreateInput()
+{
+  vtkNew<vtkMinimalStandardRandomSequence> random;
+  random->SetSeed(1);
+  const vtkIdType numPts = 2000;
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("scalars");
+  vtkNew<vtkDoubleArray> vectors;
+  vectors->SetName("vectors");
+  vectors->SetNumberOfComponents(3);
+  vtkNew<vtkFloatArray> normals;
+  normals->SetName("normals");
+  normals->SetNumberOfComponents(3);
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("ids");
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3], v[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      random->Next();
+      x[c] = random->GetRangeValue(-10.0, 10.0);
+      random->Next();
+      v[c] = random->GetRangeValue(-1.0, 1.0);
+    }
+    // A few vectors along the x axis and null vectors.
+    if (i % 50 == 0)
+    {
+      v[1] = v[2] = 0.0;
+    }
+    if (i % 77 == 0)
+    {
+      v[0] = v[1] = v[2] = 0.0;
+    }
+    points->InsertNextPoint(x);
+    random->Next();
+    scalars->InsertNextValue(static_cast<float>(random->GetValue()));
+    vectors->InsertNextTuple(v);
+    normals->InsertNextTuple3(v[2], v[0], v[1]);
+    ids->InsertNextValue(i);
+  }
+  vtkSmartPointer<vtkPolyData> input = vtkSmartPointer<vtkPolyData>::New();
+  input->SetPoints(points);
+  input->GetPointData()->SetScalars(scalars);
+  input->GetPointData()->SetVectors(vectors);
+  input->GetPointData()->SetNormals(normals);
+  input->GetPointData()->AddArray(ids);
+  return input;
+}
+
+// Glyph the input with one and with four threads, and compare the outputs.
+bool CheckParallel(vtkGlyph3D *glyph, const char *name)
+{
+  vtkSmartPointer<vtkPolyData> outputs[2];
+  for (int parallel = 0; parallel < 2; ++parallel)
+  {
+    glyph->Modified();
+    vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { glyph->Update(); });
+    outputs[parallel] = vtkSmartPointer<vtkPolyData>::New();
+    outputs[parallel]->DeepCopy(glyph->GetOutput());
+  }
+  if (outputs[0]->GetNumberOfPoints() == 0)
+  {
+    std::cerr << name << ": no glyph was generated" << std::endl;
+    return false;
+  }
+  if (!SameGlyphs(outputs[0], outputs[1]))
+  {
+    std::cerr << name << ": the parallel output differs" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Apply the transformation of each instance to the points of its source
+// and compare them to the geometry of the glyph.
+bool CheckInstances(vtkGlyph3D *glyph, vtkTransform *sourceTransform)
+{
+  glyph->SetOutputModeToGeometry();
+  glyph->Update();
+  vtkNew<vtkPolyData> geometry;
+  geometry->DeepCopy(glyph->GetOutput());
+  glyph->SetOutputModeToInstances();
+  glyph->Update();
+  vtkPolyData *instances = glyph->GetOutput();
+
+  vtkIntArray *sourceIds = vtkArrayDownCast<vtkIntArray>(
+    instances->GetPointData()->GetArray("GlyphSourceIndex"));
+  vtkFloatArray *orientations = vtkArrayDownCast<vtkFloatArray>(
+    instances->GetPointData()->GetArray("GlyphOrientation"));
+  vtkFloatArray *scales = vtkArrayDownCast<vtkFloatArray>(
+    instances->GetPointData()->GetArray("GlyphScaleFactors"));
+  if (!sourceIds || !orientations || !scales ||
+      instances->GetNumberOfVerts() != instances->GetNumberOfPoints() ||
+      !instances->GetPointData()->GetArray("ids"))
+  {
+    std::cerr << "Missing instance arrays" << std::endl;
+    return false;
+  }
+
+  vtkIdType ptId = 0;
+  for (vtkIdType i = 0; i < instances->GetNumberOfPoints(); ++i)
+  {
+    vtkPolyData *source = glyph->GetSource(sourceIds->GetValue(i));
+    double x[3], q[4], s[3];
+    instances->GetPoint(i, x);
+    orientations->GetTuple(i, q);
+    scales->GetTuple(i, s);
+    double angle = 2.0 * std::acos(q[0]);
+    vtkNew<vtkTransform> transform;
+    transform->Translate(x);
+    if (angle != 0.0)
+    {
+      transform->RotateWXYZ(vtkMath::DegreesFromRadians(angle),
+                            q[1], q[2], q[3]);
+    }
+    transform->Scale(s);
+    if (sourceTransform)
+    {
+      transform->Concatenate(sourceTransform);
+    }
+    for (vtkIdType j = 0; j < source->GetNumberOfPoints(); ++j, ++ptId)
+    {
+      double p[3], expected[3];
+      transform->TransformPoint(source->GetPoint(j), p);
+      geometry->GetPoint(ptId, expected);
+      if (std::sqrt(vtkMath::Distance2BetweenPoints(p, expected)) > 1.0e-4)
+      {
+        std::cerr << "Instance " << i << " differs from its glyph"
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  if (ptId != geometry->GetNumberOfPoints())
+  {
+    std::cerr << "The instances do not match the glyphs" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}
+
+int UnitTestGlyph3D(int, char *[])
+{
+  vtkSmartPointer<vtkPolyData> input = CreateInput();
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(12);
+  sphere->SetPhiResolution(8);
+  vtkNew<vtkConeSource> cone;
+  cone->SetResolution(10);
+
+  // Orient and scale by the vectors, color by scale.
+  vtkNew<vtkGlyph3D> glyph;
+  glyph->SetInputData(input);
+  glyph->SetSourceConnection(sphere->GetOutputPort());
+  glyph->SetScaleModeToScaleByVector();
+  glyph->SetScaleFactor(0.5);
+  if (!CheckParallel(glyph, "scale by vector") ||
+      !CheckInstances(glyph, nullptr))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Clamped scalars, colors copied from the input, point ids, cell data, a
+  // source transform and double precision points.
+  vtkNew<vtkTransform> sourceTransform;
+  sourceTransform->RotateZ(30.0);
+  sourceTransform->Translate(0.5, 0.0, 0.0);
+  glyph->SetOutputModeToGeometry();
+  glyph->SetScaleModeToScaleByScalar();
+  glyph->ClampingOn();
+  glyph->SetRange(0.2, 0.8);
+  glyph->SetColorModeToColorByScalar();
+  glyph->GeneratePointIdsOn();
+  glyph->FillCellDataOn();
+  glyph->SetSourceTransform(sourceTransform);
+  glyph->SetOutputPointsPrecision(vtkAlgorithm::DOUBLE_PRECISION);
+  if (!CheckParallel(glyph, "clamped scalars") ||
+      !CheckInstances(glyph, sourceTransform))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // Orient along the normals, scale by the vector components, color by the
+  // vector magnitude, and index a table of two sources by scalar.
+  glyph->SetOutputModeToGeometry();
+  glyph->SetSourceTransform(nullptr);
+  glyph->ClampingOff();
+  glyph->SetVectorModeToUseNormal();
+  glyph->SetScaleModeToScaleByVectorComponents();
+  glyph->SetColorModeToColorByVector();
+  glyph->SetSourceConnection(1, cone->GetOutputPort());
+  glyph->SetIndexModeToScalar();
+  glyph->SetRange(0.0, 1.0);
+  if (!CheckParallel(glyph, "indexing") || !CheckInstances(glyph, nullptr))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // A source with vertices and polygons is glyphed serially.
+  cone->Update();
+  vtkNew<vtkPolyData> mixed;
+  mixed->DeepCopy(cone->GetOutput());
+  vtkNew<vtkCellArray> verts;
+  vtkIdType tip = 0;
+  verts->InsertNextCell(1, &tip);
+  mixed->SetVerts(verts);
+  glyph->SetOutputModeToGeometry();
+  glyph->SetIndexModeToOff();
+  glyph->SetSourceData(0, mixed);
+  if (!CheckParallel(glyph, "mixed cells"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
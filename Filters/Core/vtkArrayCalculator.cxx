@@ -14,7 +14,9 @@
 =========================================================================*/
 #include "vtkArrayCalculator.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
 #include "vtkDoubleArray.h"
 #include "vtkFieldData.h"
@@ -27,11 +29,183 @@
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTable.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <atomic>
+
 vtkStandardNewMacro(vtkArrayCalculator);
 
+namespace
+{
+
+// Number of tuples gathered and evaluated at once by a thread.
+const vtkIdType VTK_CALCULATOR_TILE_SIZE = 1024;
+
+// Copy component Component of tuples [Begin, End) to Values.
+struct GatherComponentWorker
+{
+  vtkIdType Begin;
+  vtkIdType End;
+  int Component;
+  double *Values;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    vtkDataArrayAccessor<ArrayT> access(array);
+    double *values = this->Values;
+    for (vtkIdType t = this->Begin; t < this->End; ++t)
+    {
+      *values++ = static_cast<double>(access.Get(t, this->Component));
+    }
+  }
+};
+
+// Copy the NumberOfComponents buffers of Values to tuples [Begin, End).
+struct ScatterResultWorker
+{
+  vtkIdType Begin;
+  vtkIdType End;
+  int NumberOfComponents;
+  const double *const *Values;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    typedef typename vtkDataArrayAccessor<ArrayT>::APIType APIType;
+    vtkDataArrayAccessor<ArrayT> access(array);
+    for (int c = 0; c < this->NumberOfComponents; ++c)
+    {
+      const double *values = this->Values[c];
+      for (vtkIdType t = this->Begin; t < this->End; ++t)
+      {
+        access.Set(t, c, static_cast<APIType>(*values++));
+      }
+    }
+  }
+};
+
+// Where the values of a variable of the function parser come from: a
+// component of an array or a coordinate of the points.
+struct VariableSource
+{
+  vtkDataArray *Array;
+  int Component;
+};
+
+// Evaluate the function of the parser for a range of tuples, tile by tile:
+// the values of the variables are gathered into contiguous buffers that are
+// passed to vtkFunctionParser::EvaluateBatch().
+class vtkArrayCalculatorFunctor
+{
+public:
+  vtkFunctionParser *Parser;
+  // One entry per scalar variable, then three per vector variable. A null
+  // array with a component of -1 means that the set value of the variable
+  // is used.
+  std::vector<VariableSource> Sources;
+  vtkDataSet *DataSet;
+  vtkGraph *Graph;
+  vtkDataArray *Result;
+  int NumberOfResultComponents;
+  std::atomic<vtkIdType> NumberOfInvalidValues;
+  // Set when the parser cannot evaluate the function at all.
+  std::atomic<bool> Failed;
+  vtkSMPThreadLocal<std::vector<double> > Buffers;
+
+  vtkArrayCalculatorFunctor() : NumberOfInvalidValues(0), Failed(false) {}
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    const size_t numSources = this->Sources.size();
+    const vtkIdType T = VTK_CALCULATOR_TILE_SIZE;
+    // The variable buffers, then the result and the coordinate buffers.
+    std::vector<double> &buffer = this->Buffers.Local();
+    buffer.resize((numSources + 6) * T);
+    std::vector<double*> columns(numSources, nullptr);
+    double *results[3];
+    double *coords[3];
+    for (int c = 0; c < 3; ++c)
+    {
+      results[c] = &buffer[(numSources + c) * T];
+      coords[c] = &buffer[(numSources + 3 + c) * T];
+    }
+    const int numScalars = this->Parser->GetNumberOfScalarVariables();
+
+    for (vtkIdType tileBegin = begin; tileBegin < end && !this->Failed;
+         tileBegin += T)
+    {
+      vtkIdType tileEnd = std::min(tileBegin + T, end);
+      vtkIdType n = tileEnd - tileBegin;
+      bool pointsGathered = false;
+      for (size_t v = 0; v < numSources; ++v)
+      {
+        const VariableSource &source = this->Sources[v];
+        if (source.Component < 0)
+        {
+          continue;
+        }
+        if (source.Array)
+        {
+          columns[v] = &buffer[v * T];
+          GatherComponentWorker worker =
+            { tileBegin, tileEnd, source.Component, columns[v] };
+          if (!vtkArrayDispatch::Dispatch::Execute(source.Array, worker))
+          {
+            worker(source.Array);
+          }
+          continue;
+        }
+        // Coordinates: the points of the tile are gathered once.
+        if (!pointsGathered)
+        {
+          for (vtkIdType t = 0; t < n; ++t)
+          {
+            double pt[3];
+            if (this->DataSet)
+            {
+              this->DataSet->GetPoint(tileBegin + t, pt);
+            }
+            else
+            {
+              this->Graph->GetPoint(tileBegin + t, pt);
+            }
+            coords[0][t] = pt[0];
+            coords[1][t] = pt[1];
+            coords[2][t] = pt[2];
+          }
+          pointsGathered = true;
+        }
+        columns[v] = coords[source.Component];
+      }
+
+      vtkIdType numInvalid = this->Parser->EvaluateBatch(
+        n, columns.data(), columns.data() + numScalars, results);
+      if (numInvalid < 0)
+      {
+        this->Failed = true;
+        return;
+      }
+      if (numInvalid > 0)
+      {
+        this->NumberOfInvalidValues += numInvalid;
+      }
+
+      ScatterResultWorker worker =
+        { tileBegin, tileEnd, this->NumberOfResultComponents, results };
+      if (!vtkArrayDispatch::Dispatch::Execute(this->Result, worker))
+      {
+        worker(this->Result);
+      }
+    }
+  }
+};
+
+}
+
 vtkArrayCalculator::vtkArrayCalculator()
 {
   this->FunctionParser = vtkFunctionParser::New();
@@ -220,7 +394,6 @@ int vtkArrayCalculator::RequestData(
   vtkDataSetAttributes* outFD = nullptr;
   vtkDataArray* currentArray;
   vtkIdType numTuples = 0;
-  double scalarResult[1];
   vtkDataArray* resultArray = nullptr;
   vtkPoints* resultPoints = nullptr;
 
@@ -429,109 +602,125 @@ int vtkArrayCalculator::RequestData(
   {
     resultArray->SetNumberOfComponents(1);
     resultArray->SetNumberOfTuples(numTuples);
-    scalarResult[0] = this->FunctionParser->GetScalarResult();
-    resultArray->SetTuple(0, scalarResult);
   }
   else
   {
     resultArray->Allocate(numTuples * 3);
     resultArray->SetNumberOfComponents(3);
     resultArray->SetNumberOfTuples(numTuples);
-    resultArray->SetTuple(0, this->FunctionParser->GetVectorResult());
   }
 
-  // Save array pointers to avoid looking them up for each tuple.
-  std::vector<vtkDataArray*> scalarArrays(this->NumberOfScalarArrays);
-  std::vector<vtkDataArray*> vectorArrays(this->NumberOfVectorArrays);
-  std::vector<int> scalarArrayIndicies(this->NumberOfScalarArrays);
-  std::vector<int> vectorArrayIndicies(this->NumberOfVectorArrays);
+  // Record where the values of the variables needed by the function come
+  // from. The other variables keep the value set above.
+  vtkArrayCalculatorFunctor functor;
+  functor.Parser = this->FunctionParser;
+  functor.DataSet = dsInput;
+  functor.Graph = graphInput;
+  functor.Result = resultArray;
+  functor.NumberOfResultComponents = resultType == SCALAR_RESULT ? 1 : 3;
+  const int numScalarVariables =
+    this->FunctionParser->GetNumberOfScalarVariables();
+  VariableSource unused = { nullptr, -1 };
+  functor.Sources.resize(
+    numScalarVariables + 3 * this->FunctionParser->GetNumberOfVectorVariables(),
+    unused);
 
-  for (int cc=0; cc < this->NumberOfScalarArrays; cc++)
+  for (i = 0; i < this->NumberOfScalarArrays; i++)
   {
     int idx = this->FunctionParser->GetScalarVariableIndex(
-      this->ScalarVariableNames[cc]);
-    if (idx >= 0)
+      this->ScalarVariableNames[i]);
+    if (idx >= 0 && this->FunctionParser->GetScalarVariableNeeded(idx) &&
+        (currentArray = inFD->GetArray(this->ScalarArrayNames[i])))
     {
-      if (this->FunctionParser->GetScalarVariableNeeded(idx))
-      {
-        scalarArrays[cc] = inFD->GetArray(this->ScalarArrayNames[cc]);
-        scalarArrayIndicies[cc] = idx;
-      }
+      VariableSource source = { currentArray,
+                                this->SelectedScalarComponents[i] };
+      functor.Sources[idx] = source;
     }
   }
-
-  for (int cc=0; cc < this->NumberOfVectorArrays; cc++)
+  for (i = 0; i < this->NumberOfVectorArrays; i++)
   {
     int idx = this->FunctionParser->GetVectorVariableIndex(
-      this->VectorVariableNames[cc]);
-    if (idx >= 0)
+      this->VectorVariableNames[i]);
+    if (idx >= 0 && this->FunctionParser->GetVectorVariableNeeded(idx))
     {
-      if (this->FunctionParser->GetVectorVariableNeeded(idx))
+      currentArray = inFD->GetArray(this->VectorArrayNames[i]);
+      for (j = 0; j < 3; j++)
       {
-        vectorArrays[cc] = inFD->GetArray(this->VectorArrayNames[cc]);
-        vectorArrayIndicies[cc] = idx;
+        VariableSource source = { currentArray,
+                                  this->SelectedVectorComponents[i][j] };
+        functor.Sources[numScalarVariables + 3 * idx + j] = source;
       }
     }
   }
-
-  for (i = 1; i < numTuples; i++)
+  if(attribute == vtkDataObject::POINT || attribute == vtkDataObject::VERTEX)
   {
-    for (j = 0; j < this->NumberOfScalarArrays; j++)
+    for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
     {
-      if ((currentArray = scalarArrays[j]))
+      int idx = j + this->NumberOfScalarArrays;
+      if (this->FunctionParser->GetScalarVariableNeeded(idx))
       {
-        this->FunctionParser->
-          SetScalarVariableValue(scalarArrayIndicies[j],
-            currentArray->GetComponent(i, this->SelectedScalarComponents[j]));
+        VariableSource source = {
+          nullptr, this->SelectedCoordinateScalarComponents[j] };
+        functor.Sources[idx] = source;
       }
     }
-    for (j = 0; j < this->NumberOfVectorArrays; j++)
+    for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
     {
-      if ((currentArray = vectorArrays[j]))
+      int idx = j + this->NumberOfVectorArrays;
+      if (this->FunctionParser->GetVectorVariableNeeded(idx))
       {
-        this->FunctionParser->SetVectorVariableValue(vectorArrayIndicies[j],
-            currentArray->GetComponent(i, this->SelectedVectorComponents[j][0]),
-            currentArray->GetComponent(
-              i, this->SelectedVectorComponents[j][1]),
-            currentArray->GetComponent(i, this->SelectedVectorComponents[j][2]));
+        for (int c = 0; c < 3; c++)
+        {
+          VariableSource source = {
+            nullptr, this->SelectedCoordinateVectorComponents[j][c] };
+          functor.Sources[numScalarVariables + 3 * idx + c] = source;
+        }
       }
     }
-    if(attribute == vtkDataObject::POINT || attribute == vtkDataObject::VERTEX)
+    // GetPoint() is thread safe once it has been called from a single
+    // thread.
+    double pt[3];
+    if (dsInput)
     {
-      double* pt = nullptr;
-      if (dsInput)
-      {
-        pt = dsInput->GetPoint(i);
-      }
-      else
-      {
-        pt = graphInput->GetPoint(i);
-      }
-      for (j = 0; j < this->NumberOfCoordinateScalarArrays; j++)
-      {
-        this->FunctionParser->
-          SetScalarVariableValue(
-            j+this->NumberOfScalarArrays, pt[this->SelectedCoordinateScalarComponents[j]]);
-      }
-      for (j = 0; j < this->NumberOfCoordinateVectorArrays; j++)
-      {
-        this->FunctionParser->
-          SetVectorVariableValue(
-            j+this->NumberOfVectorArrays,
-            pt[this->SelectedCoordinateVectorComponents[j][0]],
-            pt[this->SelectedCoordinateVectorComponents[j][1]],
-            pt[this->SelectedCoordinateVectorComponents[j][2]]);
-      }
+      dsInput->GetPoint(0, pt);
     }
-    if (resultType == SCALAR_RESULT)
+    else
     {
-      scalarResult[0] = this->FunctionParser->GetScalarResult();
-      resultArray->SetTuple(i, scalarResult);
+      graphInput->GetPoint(0, pt);
+    }
+  }
+
+  // Arrays that are not vtkAOSDataArrayTemplate (e.g. vtkBitArray) cannot
+  // be written concurrently.
+  if (resultArray->GetArrayType() == vtkAbstractArray::AoSDataArrayTemplate)
+  {
+    vtkSMPTools::For(0, numTuples, VTK_CALCULATOR_TILE_SIZE, functor);
+  }
+  else
+  {
+    functor(0, numTuples);
+  }
+  if (functor.Failed)
+  {
+    vtkErrorMacro("The function \"" << this->Function
+                  << "\" could not be evaluated.");
+    if (resultPoints)
+    {
+      resultPoints->Delete();
     }
     else
     {
-      resultArray->SetTuple(i, this->FunctionParser->GetVectorResult());
+      resultArray->Delete();
     }
+    return 0;
+  }
+  if (functor.NumberOfInvalidValues > 0)
+  {
+    vtkErrorMacro(<< functor.NumberOfInvalidValues
+                  << " values could not be computed (division by zero, "
+                  "logarithm of a non-positive value...), they are set to "
+                  << VTK_PARSER_ERROR_RESULT
+                  << ". Turn ReplaceInvalidValues on to replace them.");
   }
 
   output->ShallowCopy(input);
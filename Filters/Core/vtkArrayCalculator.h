@@ -54,6 +54,13 @@
  * tuple-wise (i.e., tuple-by-tuple). The user must specify which arrays to use as
  * vectors and/or scalars, and the name of the output data array.
  *
+ * The tuples are processed in blocks, in parallel with vtkSMPTools: the
+ * values of the variables of a block are copied into contiguous buffers and
+ * evaluated at once by vtkFunctionParser::EvaluateBatch(). The tuples for
+ * which the function cannot be evaluated (e.g. a division by zero while
+ * ReplaceInvalidValues is off) are set to VTK_PARSER_ERROR_RESULT and a
+ * single error is reported.
+ *
  * @sa
  * vtkFunctionParser
 */
@@ -14,16 +14,27 @@
   =========================================================================*/
 #include "vtkCellDataToPointData.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedIntArray.h"
@@ -31,6 +42,8 @@
 #include <algorithm>
 #include <functional>
 #include <set>
+#include <utility>
+#include <vector>
 
 #define VTK_MAX_CELLS_PER_POINT 4096
 
@@ -121,6 +134,358 @@ namespace
       }
     }
   }
+
+//----------------------------------------------------------------------------
+// The threaded paths are used when more than one thread is available. They
+// produce the same values as the serial code, bit for bit.
+  bool UseThreadedPath(vtkDataSet* ds)
+  {
+    if (vtkSMPTools::GetEstimatedNumberOfThreads() < 2)
+    {
+      return false;
+    }
+    // vtkPolyData builds its cells on demand, which is not thread safe.
+    if (vtkPolyData* pd = vtkPolyData::SafeDownCast(ds))
+    {
+      if (pd->NeedToBuildCells())
+      {
+        pd->BuildCells();
+      }
+    }
+    return true;
+  }
+
+//----------------------------------------------------------------------------
+// Dimension of every cell, computed once for all the arrays.
+  struct CellDimensions
+  {
+    vtkDataSet* Source;
+    unsigned char* Dimensions;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+    CellDimensions(vtkDataSet* src, unsigned char* dimensions) :
+      Source(src), Dimensions(dimensions)
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkGenericCell* cell = this->Cell.Local();
+      for (vtkIdType cid = begin; cid < end; ++cid)
+      {
+        this->Source->GetCell(cid, cell);
+        this->Dimensions[cid] =
+          static_cast<unsigned char>(cell->GetCellDimension());
+      }
+    }
+  };
+
+//----------------------------------------------------------------------------
+// Number of cells of at least the given dimension using each point.
+  struct CountPointCells
+  {
+    vtkStaticCellLinksTemplate<vtkIdType>* Links;
+    const unsigned char* Dimensions;
+    int HighestCellDimension;
+    unsigned int* Num;
+
+    CountPointCells(vtkStaticCellLinksTemplate<vtkIdType>* links,
+                    const unsigned char* dimensions,
+                    int highestCellDimension, unsigned int* num) :
+      Links(links), Dimensions(dimensions),
+      HighestCellDimension(highestCellDimension), Num(num)
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      for (vtkIdType pid = begin; pid < end; ++pid)
+      {
+        vtkIdType const ncells = this->Links->GetNumberOfCells(pid);
+        const vtkIdType* cells = this->Links->GetCells(pid);
+        unsigned int count = 0;
+        for (vtkIdType i = 0; i < ncells; ++i)
+        {
+          if (this->Dimensions[cells[i]] >= this->HighestCellDimension)
+          {
+            ++count;
+          }
+        }
+        this->Num[pid] = count;
+      }
+    }
+  };
+
+//----------------------------------------------------------------------------
+// Threaded version of __spread(). Instead of scattering every cell value to
+// its points, each point gathers the values of the cells using it. The
+// static links list these cells by decreasing id, so they are traversed
+// backwards to add the values in the same order as the serial code.
+  template <typename SrcArrayT, typename DstArrayT>
+  struct SpreadCellData
+  {
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType T;
+
+    SrcArrayT* Source;
+    DstArrayT* Destination;
+    vtkStaticCellLinksTemplate<vtkIdType>* Links;
+    const unsigned char* Dimensions;
+    const unsigned int* Num;
+    int HighestCellDimension;
+    int ContributingCellOption;
+    vtkSMPThreadLocal<std::vector<T> > Data;
+
+    SpreadCellData(SrcArrayT* src, DstArrayT* dst,
+                   vtkStaticCellLinksTemplate<vtkIdType>* links,
+                   const unsigned char* dimensions, const unsigned int* num,
+                   int highestCellDimension, int contributingCellOption) :
+      Source(src), Destination(dst), Links(links), Dimensions(dimensions),
+      Num(num), HighestCellDimension(highestCellDimension),
+      ContributingCellOption(contributingCellOption)
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkDataArrayAccessor<SrcArrayT> src(this->Source);
+      vtkDataArrayAccessor<DstArrayT> dst(this->Destination);
+      int const ncomps = this->Destination->GetNumberOfComponents();
+      std::vector<T>& data = this->Data.Local();
+      data.resize(4*ncomps);
+
+      for (vtkIdType pid = begin; pid < end; ++pid)
+      {
+        vtkIdType const ncells = this->Links->GetNumberOfCells(pid);
+        const vtkIdType* cells = this->Links->GetCells(pid);
+        std::fill(data.begin(), data.end(), T(0));
+
+        if (this->ContributingCellOption != vtkCellDataToPointData::Patch)
+        {
+          for (vtkIdType i = ncells; i--;)
+          {
+            vtkIdType const cid = cells[i];
+            if (this->Dimensions[cid] >= this->HighestCellDimension)
+            {
+              for (int comp = 0; comp < ncomps; ++comp)
+              {
+                data[comp] += src.Get(cid, comp);
+              }
+            }
+          }
+          // guard against divide by zero
+          if (unsigned int const denom = this->Num[pid])
+          {
+            for (int comp = 0; comp < ncomps; ++comp)
+            {
+              data[comp] = data[comp] / static_cast<T>(denom);
+            }
+          }
+          for (int comp = 0; comp < ncomps; ++comp)
+          {
+            dst.Set(pid, comp, data[comp]);
+          }
+        }
+        else
+        { // compute over cell patches
+          T numPointCells[4] = {0, 0, 0, 0};
+          for (vtkIdType i = ncells; i--;)
+          {
+            vtkIdType const cid = cells[i];
+            int const cellDimension = this->Dimensions[cid];
+            numPointCells[cellDimension] += 1;
+            for (int comp = 0; comp < ncomps; ++comp)
+            {
+              data[comp+ncomps*cellDimension] += src.Get(cid, comp);
+            }
+          }
+          int dimension = 3;
+          while (dimension >= 0 && !numPointCells[dimension])
+          {
+            --dimension;
+          }
+          for (int comp = 0; comp < ncomps; ++comp)
+          {
+            dst.Set(pid, comp, dimension < 0 ? T(0) : static_cast<T>(
+              data[comp+dimension*ncomps] / numPointCells[dimension]));
+          }
+        }
+      }
+    }
+  };
+
+  struct SpreadCellDataWorker
+  {
+    vtkStaticCellLinksTemplate<vtkIdType>* Links;
+    const unsigned char* Dimensions;
+    const unsigned int* Num;
+    int HighestCellDimension;
+    int ContributingCellOption;
+
+    template <typename SrcArrayT, typename DstArrayT>
+    void operator()(SrcArrayT* src, DstArrayT* dst)
+    {
+      SpreadCellData<SrcArrayT, DstArrayT> spread(src, dst, this->Links,
+        this->Dimensions, this->Num, this->HighestCellDimension,
+        this->ContributingCellOption);
+      vtkSMPTools::For(0, dst->GetNumberOfTuples(), spread);
+    }
+  };
+
+//----------------------------------------------------------------------------
+// Dimensions of the structured datasets whose point cells can be computed
+// from the structured coordinates of the points.
+  bool GetStructuredDimensions(vtkDataSet* ds, int dims[3])
+  {
+    if (vtkImageData* image = vtkImageData::SafeDownCast(ds))
+    {
+      image->GetDimensions(dims);
+    }
+    else if (vtkRectilinearGrid* rgrid = vtkRectilinearGrid::SafeDownCast(ds))
+    {
+      rgrid->GetDimensions(dims);
+    }
+    else if (vtkStructuredGrid* sgrid = vtkStructuredGrid::SafeDownCast(ds))
+    {
+      sgrid->GetDimensions(dims);
+    }
+    else
+    {
+      return false;
+    }
+    return ds->GetNumberOfCells() > 0 && ds->GetNumberOfPoints() ==
+      static_cast<vtkIdType>(dims[0])*dims[1]*dims[2];
+  }
+
+//----------------------------------------------------------------------------
+// Same as vtkStructuredData::GetPointCells(), without the vtkIdList.
+  int GetStructuredPointCells(vtkIdType ptId, const int dim[3],
+                              vtkIdType cellIds[8])
+  {
+    static const int offset[8][3] = {{-1,0,0}, {-1,-1,0}, {-1,-1,-1}, {-1,0,-1},
+                                     {0,0,0},  {0,-1,0},  {0,-1,-1},  {0,0,-1}};
+    vtkIdType cellDim[3];
+    for (int i = 0; i < 3; ++i)
+    {
+      cellDim[i] = dim[i] > 1 ? dim[i] - 1 : 1;
+    }
+    int const ptLoc[3] = {
+      static_cast<int>(ptId % dim[0]),
+      static_cast<int>((ptId / dim[0]) % dim[1]),
+      static_cast<int>(ptId / (static_cast<vtkIdType>(dim[0])*dim[1])) };
+
+    int numCells = 0;
+    for (int j = 0; j < 8; ++j)
+    {
+      int cellLoc[3];
+      int i;
+      for (i = 0; i < 3; ++i)
+      {
+        cellLoc[i] = ptLoc[i] + offset[j][i];
+        if (cellLoc[i] < 0 || cellLoc[i] >= cellDim[i])
+        {
+          break;
+        }
+      }
+      if (i >= 3)
+      {
+        cellIds[numCells++] = cellLoc[0] + cellLoc[1]*cellDim[0] +
+          cellLoc[2]*cellDim[0]*cellDim[1];
+      }
+    }
+    return numCells;
+  }
+
+//----------------------------------------------------------------------------
+// Threaded version of InterpolatePointData() for structured datasets. The
+// cells around each point are computed from its structured coordinates, and
+// their values are averaged the way vtkDataArray::InterpolateTuple() does.
+  template <typename SrcArrayT, typename DstArrayT>
+  struct AverageStructuredCells
+  {
+    SrcArrayT* Source;
+    DstArrayT* Destination;
+    const int* Dimensions;
+
+    AverageStructuredCells(SrcArrayT* src, DstArrayT* dst,
+                           const int* dimensions) :
+      Source(src), Destination(dst), Dimensions(dimensions)
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      typedef typename vtkDataArrayAccessor<DstArrayT>::APIType T;
+      vtkDataArrayAccessor<SrcArrayT> src(this->Source);
+      vtkDataArrayAccessor<DstArrayT> dst(this->Destination);
+      int const ncomps = this->Destination->GetNumberOfComponents();
+      vtkIdType cellIds[8];
+
+      for (vtkIdType ptId = begin; ptId < end; ++ptId)
+      {
+        int const numCells =
+          GetStructuredPointCells(ptId, this->Dimensions, cellIds);
+        double const weight = 1.0 / numCells;
+        for (int comp = 0; comp < ncomps; ++comp)
+        {
+          double val = 0.;
+          for (int i = 0; i < numCells; ++i)
+          {
+            val += weight * static_cast<double>(src.Get(cellIds[i], comp));
+          }
+          T valT;
+          vtkMath::RoundDoubleToIntegralIfNecessary(val, &valT);
+          dst.Set(ptId, comp, valT);
+        }
+      }
+    }
+  };
+
+  struct AverageStructuredCellsWorker
+  {
+    const int* Dimensions;
+
+    template <typename SrcArrayT, typename DstArrayT>
+    void operator()(SrcArrayT* src, DstArrayT* dst)
+    {
+      AverageStructuredCells<SrcArrayT, DstArrayT> average(
+        src, dst, this->Dimensions);
+      vtkSMPTools::For(0, dst->GetNumberOfTuples(), average);
+    }
+  };
+
+//----------------------------------------------------------------------------
+// Pair the arrays allocated by InterpolateAllocate() with the arrays they
+// interpolate, matching them by name like vtkArrayListTemplate does. Returns
+// false if an array needs the generic interpolation (e.g., nearest neighbor
+// attributes or non-numeric arrays).
+  bool PairInterpolatedArrays(vtkDataSetAttributes* in, vtkDataSetAttributes* out,
+    std::vector<std::pair<vtkDataArray*, vtkDataArray*> >& pairs)
+  {
+    for (int i = 0; i < out->GetNumberOfArrays(); ++i)
+    {
+      vtkAbstractArray* outArray = out->GetAbstractArray(i);
+      // Arrays passed from the input already have their tuples.
+      if (outArray->GetNumberOfTuples() != 0)
+      {
+        continue;
+      }
+      const char* name = outArray->GetName();
+      vtkDataArray* srcarray = name ?
+        vtkDataArray::FastDownCast(in->GetAbstractArray(name)) : nullptr;
+      vtkDataArray* dstarray = vtkDataArray::FastDownCast(outArray);
+      int const attribute = out->IsArrayAnAttribute(i);
+      if (!srcarray || !dstarray ||
+          srcarray->GetDataType() != dstarray->GetDataType() ||
+          srcarray->GetNumberOfComponents() != dstarray->GetNumberOfComponents() ||
+          (attribute != -1 &&
+           out->GetCopyAttribute(attribute, vtkDataSetAttributes::INTERPOLATE) == 2))
+      {
+        return false;
+      }
+      pairs.push_back(std::make_pair(srcarray, dstarray));
+    }
+    return true;
+  }
 } // end anonymous namespace
 
 class vtkCellDataToPointData::Internals
@@ -367,6 +732,19 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     return 1;
   }
 
+  // The threaded path builds static links once for all the arrays, and asks
+  // every cell for its dimension only once.
+  bool const threaded = UseThreadedPath(src);
+  vtkStaticCellLinksTemplate<vtkIdType> links;
+  std::vector<unsigned char> dimensions;
+  if (threaded)
+  {
+    links.BuildLinks(src);
+    dimensions.resize(ncells);
+    CellDimensions cellDimensions(src, &dimensions[0]);
+    vtkSMPTools::For(0, ncells, cellDimensions);
+  }
+
   // count the number of cells associated with each point. if we are doing patches
   // though we will do that later on.
   vtkSmartPointer<vtkUnsignedIntArray> num;
@@ -376,33 +754,50 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     num = vtkSmartPointer<vtkUnsignedIntArray>::New();
     num->SetNumberOfComponents(1);
     num->SetNumberOfTuples(npoints);
-    std::fill_n(num->GetPointer(0), npoints, 0u);
     if (this->ContributingCellOption == vtkCellDataToPointData::DataSetMax)
     {
-      int maxDimension = src->IsA("vtkPolyData") == 1 ? 2 : 3;
-      for (vtkIdType i=0;i<src->GetNumberOfCells();i++)
+      if (threaded)
       {
-        int dim = src->GetCell(i)->GetCellDimension();
-        if (dim > highestCellDimension)
+        highestCellDimension =
+          *std::max_element(dimensions.begin(), dimensions.end());
+      }
+      else
+      {
+        int maxDimension = src->IsA("vtkPolyData") == 1 ? 2 : 3;
+        for (vtkIdType i=0;i<src->GetNumberOfCells();i++)
         {
-          highestCellDimension = dim;
-          if (highestCellDimension == maxDimension)
+          int dim = src->GetCell(i)->GetCellDimension();
+          if (dim > highestCellDimension)
           {
-            break;
+            highestCellDimension = dim;
+            if (highestCellDimension == maxDimension)
+            {
+              break;
+            }
           }
         }
       }
     }
-    vtkNew<vtkIdList> pids;
-    for (vtkIdType cid = 0; cid < ncells; ++cid)
+    if (threaded)
+    {
+      CountPointCells count(&links, &dimensions[0], highestCellDimension,
+                            num->GetPointer(0));
+      vtkSMPTools::For(0, npoints, count);
+    }
+    else
     {
-      if (src->GetCell(cid)->GetCellDimension() >= highestCellDimension)
+      std::fill_n(num->GetPointer(0), npoints, 0u);
+      vtkNew<vtkIdList> pids;
+      for (vtkIdType cid = 0; cid < ncells; ++cid)
       {
-        src->GetCellPoints(cid, pids);
-        for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
+        if (src->GetCell(cid)->GetCellDimension() >= highestCellDimension)
         {
-          vtkIdType const pid = pids->GetId(i);
-          num->SetValue(pid, num->GetValue(pid)+1);
+          src->GetCellPoints(cid, pids);
+          for (vtkIdType i = 0, I = pids->GetNumberOfIds(); i < I; ++i)
+          {
+            vtkIdType const pid = pids->GetId(i);
+            num->SetValue(pid, num->GetValue(pid)+1);
+          }
         }
       }
     }
@@ -459,7 +854,14 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
 
   const auto nfields = processedCellData->GetNumberOfArrays();
   int fid = 0;
-  auto f = [this, &fid, nfields, npoints, src, num, ncells, highestCellDimension](
+  SpreadCellDataWorker worker;
+  worker.Links = &links;
+  worker.Dimensions = threaded ? &dimensions[0] : nullptr;
+  worker.Num = num ? num->GetPointer(0) : nullptr;
+  worker.HighestCellDimension = highestCellDimension;
+  worker.ContributingCellOption = this->ContributingCellOption;
+  auto f = [this, &fid, nfields, npoints, src, num, ncells, highestCellDimension,
+            threaded, &worker](
              vtkAbstractArray* aa_srcarray, vtkAbstractArray* aa_dstarray) {
     // update progress and check for an abort request.
     this->UpdateProgress((fid + 1.0) / nfields);
@@ -475,6 +877,11 @@ int vtkCellDataToPointData::RequestDataForUnstructuredData
     if (srcarray && dstarray)
     {
       dstarray->SetNumberOfTuples(npoints);
+      if (threaded && vtkArrayDispatch::Dispatch2SameValueType::Execute(
+            srcarray, dstarray, worker))
+      {
+        return;
+      }
       vtkIdType const ncomps = srcarray->GetNumberOfComponents();
       switch (srcarray->GetDataType())
       {
@@ -532,6 +939,42 @@ int vtkCellDataToPointData::InterpolatePointData(vtkDataSet *input, vtkDataSet *
 
   outPD->InterpolateAllocate(inCD,numPts);
 
+  // Structured datasets have at most eight cells around a point, which are
+  // found from the structured coordinates of the point.
+  int dims[3];
+  std::vector<std::pair<vtkDataArray*, vtkDataArray*> > pairs;
+  if (vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+      GetStructuredDimensions(input, dims) &&
+      PairInterpolatedArrays(inCD, outPD, pairs))
+  {
+    AverageStructuredCellsWorker worker;
+    worker.Dimensions = dims;
+    for (size_t i = 0; i < pairs.size() && !this->GetAbortExecute(); ++i)
+    {
+      this->UpdateProgress(static_cast<double>(i)/pairs.size());
+      vtkDataArray* srcarray = pairs[i].first;
+      vtkDataArray* dstarray = pairs[i].second;
+      dstarray->SetNumberOfTuples(numPts);
+      if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(
+            srcarray, dstarray, worker))
+      {
+        double weights[8];
+        for (vtkIdType ptId = 0; ptId < numPts; ptId++)
+        {
+          input->GetPointCells(ptId, cellIds);
+          vtkIdType numCells = cellIds->GetNumberOfIds();
+          std::fill_n(weights, numCells, 1.0 / numCells);
+          dstarray->InterpolateTuple(ptId, cellIds, srcarray, weights);
+        }
+      }
+    }
+    if (!this->ProcessAllArrays)
+    {
+      inCD->Delete();
+    }
+    return 1;
+  }
+
   double weights[VTK_MAX_CELLS_PER_POINT];
 
   int abort = 0;
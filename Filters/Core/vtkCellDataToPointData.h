@@ -30,6 +30,12 @@
  * cells attached to a point. DataSetMax uses the highest cell dimension in
  * the entire data set.
  *
+ * When vtkSMPTools provides several threads, unstructured grids and polydata
+ * are processed in parallel with static cell links, and image data,
+ * rectilinear grids and structured grids without blanking compute the cells
+ * around every point from its structured coordinates. The result is the same
+ * as with a single thread.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
@@ -40,7 +40,9 @@
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocalObject.h"
 
+#include <algorithm>
 #include <set>
+#include <vector>
 
 vtkStandardNewMacro(vtkContour3DLinearGrid);
 vtkCxxSetObjectMacro(vtkContour3DLinearGrid,ScalarTree,vtkScalarTree);
@@ -916,6 +918,7 @@ struct ExtractEdgesBase
   struct LocalDataType
   {
     EdgeVectorType LocalEdges;
+    std::vector<vtkIdType> LocalCellIds;
     CellIter LocalCellIter;
 
     LocalDataType()
@@ -928,20 +931,33 @@ struct ExtractEdgesBase
   const TS *Scalars;
   double  Value;
   MergeTuple<IDType,float> *Edges;
+  vtkIdType *CellIds; //originating cell of each triangle, if TrackCells
   vtkCellArray *Tris;
   vtkIdType NumTris;
   int NumThreadsUsed;
   vtkIdType TotalTris; //the total triangles thus far (support multiple contours)
+  bool TrackCells;
 
   // Keep track of generated points and triangles on a per thread basis
   vtkSMPThreadLocal<LocalDataType> LocalData;
 
   ExtractEdgesBase(CellIter *c, TS *s, double value, vtkCellArray *tris,
-                   vtkIdType totalTris) :
-    Iter(c), Scalars(s), Value(value), Edges(nullptr), Tris(tris),
-    NumTris(0), NumThreadsUsed(0), TotalTris(totalTris)
+                   vtkIdType totalTris, bool trackCells) :
+    Iter(c), Scalars(s), Value(value), Edges(nullptr), CellIds(nullptr),
+    Tris(tris), NumTris(0), NumThreadsUsed(0), TotalTris(totalTris),
+    TrackCells(trackCells)
   {}
 
+  // Record the cell producing the triangles of the current case
+  void AddCellIds(std::vector<vtkIdType> &lCellIds, vtkIdType cellId,
+                  unsigned short numEdges)
+  {
+    if ( this->TrackCells )
+    {
+      lCellIds.insert(lCellIds.end(), numEdges/3, cellId);
+    }
+  }
+
   // Set up the iteration process
   void Initialize()
   {
@@ -988,6 +1004,20 @@ struct ExtractEdgesBase
       }
       (*ldItr).LocalEdges.swap(emptyVector); //frees memory
     }//For all threads
+
+    // The cell ids are gathered in the same thread order as the edges.
+    if ( this->TrackCells )
+    {
+      std::vector<vtkIdType> emptyIds;
+      this->CellIds = new vtkIdType[this->NumTris];
+      vtkIdType *cellIds = this->CellIds;
+      for ( auto ldItr=this->LocalData.begin(); ldItr != ldEnd; ++ldItr )
+      {
+        cellIds = std::copy((*ldItr).LocalCellIds.begin(),
+                            (*ldItr).LocalCellIds.end(), cellIds);
+        (*ldItr).LocalCellIds.swap(emptyIds);
+      }
+    }
   }//Reduce
 };//ExtractEdgesBase
 
@@ -996,8 +1026,8 @@ template <typename IDType, typename TS>
 struct ExtractEdges : public ExtractEdgesBase<IDType,TS>
 {
   ExtractEdges(CellIter *c, TS *s, double value, vtkCellArray *tris,
-               vtkIdType totalTris) :
-    ExtractEdgesBase<IDType,TS>(c, s, value, tris, totalTris)
+               vtkIdType totalTris, bool trackCells) :
+    ExtractEdgesBase<IDType,TS>(c, s, value, tris, totalTris, trackCells)
   {}
 
   // Set up the iteration process
@@ -1012,6 +1042,7 @@ struct ExtractEdges : public ExtractEdgesBase<IDType,TS>
   {
     auto & localData = this->LocalData.Local();
     auto & lEdges = localData.LocalEdges;
+    auto & lCellIds = localData.LocalCellIds;
     CellIter *cellIter = &localData.LocalCellIter;
     const vtkIdType *c = cellIter->Initialize(cellId); //connectivity array
     unsigned short isoCase, numEdges, i;
@@ -1042,6 +1073,7 @@ struct ExtractEdges : public ExtractEdgesBase<IDType,TS>
           t = ( c[v0] < c[v1] ? t : (1.0-t) ); //edges (v0,v1) must have v0<v1
           lEdges.emplace_back(c[v0],c[v1],t); //edge constructor may swap v0<->v1
         }//for all edges in this case
+        this->AddCellIds(lCellIds, cellId, numEdges);
       }//if contour passes through this cell
       c += cellIter->Next(cellId); //move to the next cell
     }//for all cells in this batch
@@ -1063,8 +1095,9 @@ struct ExtractEdgesST : public ExtractEdgesBase<IDType,TS>
   vtkIdType NumBatches;
 
   ExtractEdgesST(CellIter *c, TS *s, double value, vtkScalarTree *st,
-                 vtkCellArray *tris, vtkIdType totalTris) :
-    ExtractEdgesBase<IDType,TS>(c, s, value,  tris, totalTris), ScalarTree(st)
+                 vtkCellArray *tris, vtkIdType totalTris, bool trackCells) :
+    ExtractEdgesBase<IDType,TS>(c, s, value, tris, totalTris, trackCells),
+    ScalarTree(st)
   {
     this->ScalarTree->InitTraversal(this->Value);
     this->NumBatches = this->ScalarTree->GetNumberOfCellBatches();
@@ -1082,6 +1115,7 @@ struct ExtractEdgesST : public ExtractEdgesBase<IDType,TS>
   {
     auto & localData = this->LocalData.Local();
     auto & lEdges = localData.LocalEdges;
+    auto & lCellIds = localData.LocalCellIds;
     CellIter *cellIter = &localData.LocalCellIter;
     const vtkIdType *c;
     unsigned short isoCase, numEdges, i;
@@ -1118,6 +1152,7 @@ struct ExtractEdgesST : public ExtractEdgesBase<IDType,TS>
             t = ( c[v0] < c[v1] ? t : (1.0-t) ); //edges (v0,v1) must have v0<v1
             lEdges.emplace_back(c[v0],c[v1],t); //edge constructor may swap v0<->v1
           }//for all edges in this case
+          this->AddCellIds(lCellIds, cellIds[idx], numEdges);
         }//if contour passes through this cell
       }//for all cells in this batch
     }//for all batches
@@ -1272,19 +1307,21 @@ struct ProduceAttributes
   { \
     if ( st == nullptr ) \
     { \
-      ExtractEdges<TIds,_type> extractEdges(cellIter,(_type*)s,isoValue,newPolys,totalTris); \
+      ExtractEdges<TIds,_type> extractEdges(cellIter,(_type*)s,isoValue,newPolys,totalTris,intAttr!=0); \
       EXECUTE_REDUCED_SMPFOR(seqProcessing,numCells,extractEdges,numThreads); \
       numTris = extractEdges.NumTris;  \
       tris = newPolys->GetPointer();   \
       mergeEdges = extractEdges.Edges; \
+      cellIds = extractEdges.CellIds; \
     } \
     else                                       \
     { \
-      ExtractEdgesST<TIds,_type> extractEdges(cellIter,(_type*)s,isoValue,st,newPolys,totalTris); \
+      ExtractEdgesST<TIds,_type> extractEdges(cellIter,(_type*)s,isoValue,st,newPolys,totalTris,intAttr!=0); \
       EXECUTE_REDUCED_SMPFOR(seqProcessing,extractEdges.NumBatches,extractEdges,numThreads); \
       numTris = extractEdges.NumTris;  \
       tris = newPolys->GetPointer();   \
       mergeEdges = extractEdges.Edges; \
+      cellIds = extractEdges.CellIds; \
     } \
   } \
   break;
@@ -1294,12 +1331,13 @@ template <typename TIds>
 int ProcessMerged(vtkIdType numCells, vtkPoints *inPts, CellIter *cellIter,
                   int sType, void *s, double isoValue, vtkPoints *outPts,
                   vtkCellArray *newPolys, vtkTypeBool intAttr, vtkDataArray *inScalars,
-                  vtkPointData *inPD, vtkPointData *outPD, vtkScalarTree *st, vtkTypeBool seqProcessing,
+                  vtkPointData *inPD, vtkPointData *outPD, vtkCellData *inCD,
+                  vtkCellData *outCD, vtkScalarTree *st, vtkTypeBool seqProcessing,
                   int &numThreads, vtkIdType totalPts, vtkIdType totalTris)
 {
   // Extract edges that the contour intersects. Templated on type of scalars.
   // List below the explicit choice of scalars that can be processed.
-  vtkIdType numTris=0, *tris=nullptr;
+  vtkIdType numTris=0, *tris=nullptr, *cellIds=nullptr;
   MergeTuple<TIds,float> *mergeEdges=nullptr; //may need reference counting
   switch ( sType ) //process these scalar types, others could easily be added
   {
@@ -1318,6 +1356,7 @@ int ProcessMerged(vtkIdType numCells, vtkPoints *inPts, CellIter *cellIter,
   {
     outPts->SetNumberOfPoints(0);
     delete [] mergeEdges;
+    delete [] cellIds;
     return 1;
   }
 
@@ -1383,10 +1422,18 @@ int ProcessMerged(vtkIdType numCells, vtkPoints *inPts, CellIter *cellIter,
     }
     ProduceAttributes<TIds> interpolate(mergeEdges,offsets,&arrays,totalPts);
     EXECUTE_SMPFOR(seqProcessing,numPts,interpolate);
+
+    // Each triangle receives the cell data of the cell it comes from.
+    if ( totalTris <= 0 )
+    {
+      outCD->CopyAllocate(inCD,numTris);
+    }
+    outCD->ParallelCopyData(inCD,cellIds,numTris,totalTris);
   }
 
   // Clean up
   delete [] mergeEdges;
+  delete [] cellIds;
   return 1;
 };
 #undef EXTRACT_MERGED
@@ -1704,6 +1751,8 @@ RequestData(vtkInformation*, vtkInformationVector** inputVector,
   {
     vtkPointData *inPD = input->GetPointData();
     vtkPointData *outPD = output->GetPointData();
+    vtkCellData *inCD = input->GetCellData();
+    vtkCellData *outCD = output->GetCellData();
 
     // Determine the size/type of point and cell ids needed to index points
     // and cells. Using smaller ids results in a greatly reduced memory footprint
@@ -1719,7 +1768,8 @@ RequestData(vtkInformation*, vtkInformationVector** inputVector,
       {
         if ( ! ProcessMerged<int>(numCells, inPts, cellIter, sType, sPtr, value,
                                   outPts, newPolys, this->InterpolateAttributes,
-                                  inScalars, inPD, outPD, stree, this->SequentialProcessing,
+                                  inScalars, inPD, outPD, inCD, outCD, stree,
+                                  this->SequentialProcessing,
                                   this->NumberOfThreadsUsed, totalPts, totalTris) )
         {
           return 0;
@@ -1729,7 +1779,8 @@ RequestData(vtkInformation*, vtkInformationVector** inputVector,
       {
         if ( ! ProcessMerged<vtkIdType>(numCells, inPts, cellIter, sType, sPtr, value,
                                         outPts, newPolys, this->InterpolateAttributes,
-                                        inScalars, inPD, outPD, stree, this->SequentialProcessing,
+                                        inScalars, inPD, outPD, inCD, outCD, stree,
+                                        this->SequentialProcessing,
                                         this->NumberOfThreadsUsed, totalPts, totalTris) )
         {
           return 0;
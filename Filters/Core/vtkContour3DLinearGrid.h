@@ -140,7 +140,8 @@ public:
   //@{
   /**
    * Indicate whether to interpolate input attributes onto the isosurface. By
-   * default this option is off.
+   * default this option is off. When enabled, the cell data of each input
+   * cell is also copied to the triangles generated from it.
    */
   vtkSetMacro(InterpolateAttributes,vtkTypeBool);
   vtkGetMacro(InterpolateAttributes,vtkTypeBool);
@@ -19,6 +19,7 @@
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkContour3DLinearGrid.h"
 #include "vtkContourValues.h"
 #include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
@@ -38,11 +39,14 @@
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearSynchronizedTemplates.h"
+#include "vtkSMPTools.h"
+#include "vtkScalarTree.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkSynchronizedTemplates3D.h"
 #include "vtkSynchronizedTemplatesCutter3D.h"
+#include "vtkUnstructuredGrid.h"
 #include "vtkUnstructuredGridBase.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkIncrementalPointLocator.h"
@@ -56,6 +60,7 @@
 vtkStandardNewMacro(vtkCutter);
 vtkCxxSetObjectMacro(vtkCutter,CutFunction,vtkImplicitFunction);
 vtkCxxSetObjectMacro(vtkCutter,Locator,vtkIncrementalPointLocator)
+vtkCxxSetObjectMacro(vtkCutter,ScalarTree,vtkScalarTree);
 
 //----------------------------------------------------------------------------
 // Construct with user-specified implicit function; initial value of 0.0; and
@@ -69,11 +74,16 @@ vtkCutter::vtkCutter(vtkImplicitFunction *cf)
   this->Locator = nullptr;
   this->GenerateTriangles = 1;
   this->OutputPointsPrecision = DEFAULT_PRECISION;
+  this->UseScalarTree = 0;
+  this->ScalarTree = nullptr;
+  this->CutGrid = vtkUnstructuredGrid::New();
+  this->CutGridInput = nullptr;
 
   this->SynchronizedTemplates3D = vtkSynchronizedTemplates3D::New();
   this->SynchronizedTemplatesCutter3D = vtkSynchronizedTemplatesCutter3D::New();
   this->GridSynchronizedTemplates = vtkGridSynchronizedTemplates3D::New();
   this->RectilinearSynchronizedTemplates = vtkRectilinearSynchronizedTemplates::New();
+  this->Contour3DLinearGrid = vtkContour3DLinearGrid::New();
 }
 
 //----------------------------------------------------------------------------
@@ -82,11 +92,14 @@ vtkCutter::~vtkCutter()
   this->ContourValues->Delete();
   this->SetCutFunction(nullptr);
   this->SetLocator(nullptr);
+  this->SetScalarTree(nullptr);
+  this->CutGrid->Delete();
 
   this->SynchronizedTemplates3D->Delete();
   this->SynchronizedTemplatesCutter3D->Delete();
   this->GridSynchronizedTemplates->Delete();
   this->RectilinearSynchronizedTemplates->Delete();
+  this->Contour3DLinearGrid->Delete();
 }
 
 //----------------------------------------------------------------------------
@@ -340,6 +353,37 @@ vtkIdType GetFirstVisibleCell(vtkDataSet *DataSetInput)
   }
   return 0;
 }
+
+//----------------------------------------------------------------------------
+// Check that vtkContour3DLinearGrid can process all the cells of a grid: real
+// points, linear 3D cells only.
+//
+bool IsLinear3DGrid(vtkUnstructuredGrid *input)
+{
+  vtkIdType numCells = input->GetNumberOfCells();
+  if (numCells < 1 || !input->GetPoints() ||
+      (input->GetPoints()->GetDataType() != VTK_FLOAT &&
+       input->GetPoints()->GetDataType() != VTK_DOUBLE))
+  {
+    return false;
+  }
+  const unsigned char *types = input->GetCellTypesArray()->GetPointer(0);
+  for (vtkIdType i = 0; i < numCells; ++i)
+  {
+    switch (types[i])
+    {
+      case VTK_TETRA:
+      case VTK_HEXAHEDRON:
+      case VTK_VOXEL:
+      case VTK_WEDGE:
+      case VTK_PYRAMID:
+        break;
+      default:
+        return false;
+    }
+  }
+  return true;
+}
 }
 
 //----------------------------------------------------------------------------
@@ -403,8 +447,24 @@ int vtkCutter::RequestData(
   else if (input->GetDataObjectType() == VTK_UNSTRUCTURED_GRID_BASE ||
            input->GetDataObjectType() == VTK_UNSTRUCTURED_GRID)
   {
-    vtkDebugMacro(<< "Executing Unstructured Grid Cutter");
-    this->UnstructuredGridCutter(input, output);
+    vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+    // vtkContour3DLinearGrid merges the points itself and outputs the
+    // triangles sorted by value: it cannot honor a user locator nor
+    // VTK_SORT_BY_CELL with several contour values.
+    if (grid && this->GenerateTriangles && this->Locator == nullptr &&
+        (this->SortBy == VTK_SORT_BY_VALUE ||
+         this->ContourValues->GetNumberOfContours() == 1) &&
+        (this->UseScalarTree || vtkSMPTools::GetEstimatedNumberOfThreads() > 1) &&
+        IsLinear3DGrid(grid))
+    {
+      vtkDebugMacro(<< "Executing Linear Unstructured Grid Cutter");
+      this->UnstructuredGridLinearCutter(grid, output);
+    }
+    else
+    {
+      vtkDebugMacro(<< "Executing Unstructured Grid Cutter");
+      this->UnstructuredGridCutter(input, output);
+    }
   }
   else
   {
@@ -706,6 +766,72 @@ void vtkCutter::DataSetCutter(vtkDataSet *input, vtkPolyData *output)
   output->Squeeze();
 }
 
+//----------------------------------------------------------------------------
+// Cut an unstructured grid of linear 3D cells in parallel. The values of the
+// cut function are added to a shallow copy of the input, which is contoured
+// by vtkContour3DLinearGrid. The copy is only rebuilt when the input, the cut
+// function or this filter (but not the contour values) is modified, so that
+// the scalar tree built over it can be reused.
+void vtkCutter::UnstructuredGridLinearCutter(vtkUnstructuredGrid *input,
+                                             vtkPolyData *output)
+{
+  if ( this->CutGridInput != input ||
+       this->CutGridTime < input->GetMTime() ||
+       this->CutGridTime < this->CutFunction->GetMTime() ||
+       this->CutGridTime < this->Superclass::GetMTime() )
+  {
+    vtkNew<vtkDoubleArray> cutScalars;
+    cutScalars->SetName("vtkCutScalars");
+    cutScalars->SetNumberOfTuples(input->GetNumberOfPoints());
+    this->CutFunction->FunctionValue(input->GetPoints()->GetData(), cutScalars);
+
+    this->CutGrid->ShallowCopy(input);
+    this->CutGrid->GetPointData()->AddArray(cutScalars);
+    if ( this->GenerateCutScalars )
+    {
+      // The contoured array is not interpolated: pass a second array
+      // sharing its values.
+      vtkNew<vtkDoubleArray> outScalars;
+      outScalars->SetName("cutScalars");
+      outScalars->SetArray(cutScalars->GetPointer(0),
+                           cutScalars->GetNumberOfTuples(), 1);
+      this->CutGrid->GetPointData()->SetScalars(outScalars);
+    }
+    this->CutGridInput = input;
+    this->CutGridTime.Modified();
+  }
+
+  vtkContour3DLinearGrid *contour = this->Contour3DLinearGrid;
+  contour->SetInputData(this->CutGrid);
+  contour->SetInputArrayToProcess(0, 0, 0,
+    vtkDataObject::FIELD_ASSOCIATION_POINTS, "vtkCutScalars");
+  contour->SetMergePoints(1);
+  contour->SetInterpolateAttributes(1);
+  contour->SetComputeNormals(0);
+  contour->SetOutputPointsPrecision(this->OutputPointsPrecision);
+  contour->SetUseScalarTree(this->UseScalarTree);
+  if ( this->ScalarTree )
+  {
+    contour->SetScalarTree(this->ScalarTree);
+  }
+  int numContours = this->ContourValues->GetNumberOfContours();
+  contour->SetNumberOfContours(numContours);
+  for (int i = 0; i < numContours; ++i)
+  {
+    contour->SetValue(i, this->ContourValues->GetValue(i));
+  }
+  contour->Update();
+  output->ShallowCopy(contour->GetOutput());
+
+  // Without a scalar tree, nothing is worth keeping for the next execution.
+  if ( !this->UseScalarTree )
+  {
+    contour->SetInputData(nullptr);
+    this->CutGrid->Initialize();
+    this->CutGridInput = nullptr;
+  }
+}
+
 //----------------------------------------------------------------------------
 void vtkCutter::UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output)
 {
@@ -1072,4 +1198,15 @@ void vtkCutter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Precision of the output points: "
      << this->OutputPointsPrecision << "\n";
+
+  os << indent << "Use Scalar Tree: "
+     << (this->UseScalarTree ? "On\n" : "Off\n");
+  if ( this->ScalarTree )
+  {
+    os << indent << "Scalar Tree: " << this->ScalarTree << "\n";
+  }
+  else
+  {
+    os << indent << "Scalar Tree: (none)\n";
+  }
 }
@@ -38,8 +38,20 @@
  * By default, if an implicit function is set it is used to clip the data
  * set, otherwise the dataset scalars are used to perform the clipping.
  *
+ * Unstructured grids made of linear 3D cells (tetrahedra, hexahedra, voxels,
+ * wedges and pyramids) are cut in parallel with vtkSMPTools when more than
+ * one thread is available, GenerateTriangles is on, no locator is set and
+ * the output is sorted by value (or there is a single contour value): the
+ * cut function is evaluated at the points, then the grid is contoured by
+ * vtkContour3DLinearGrid. The output is the same surface, but the order of
+ * the points and triangles differs from the serial one and small degenerate
+ * triangles are kept. With UseScalarTree on, the
+ * values of the cut function and a scalar tree built over them are kept
+ * between executions, so that cutting the same grid again with other values
+ * of the same function only visits the cells that may be cut.
+ *
  * @sa
- * vtkImplicitFunction vtkClipPolyData
+ * vtkImplicitFunction vtkClipPolyData vtkContour3DLinearGrid vtkSpanSpace
 */
 
 #ifndef vtkCutter_h
@@ -53,8 +65,11 @@
 #define VTK_SORT_BY_VALUE 0
 #define VTK_SORT_BY_CELL 1
 
+class vtkContour3DLinearGrid;
 class vtkImplicitFunction;
 class vtkIncrementalPointLocator;
+class vtkScalarTree;
+class vtkUnstructuredGrid;
 class vtkSynchronizedTemplates3D;
 class vtkSynchronizedTemplatesCutter3D;
 class vtkGridSynchronizedTemplates3D;
@@ -223,6 +238,29 @@ public:
   vtkGetMacro(OutputPointsPrecision, int);
   //@}
 
+  //@{
+  /**
+   * Enable the use of a scalar tree to accelerate the cutting of unstructured
+   * grids made of linear 3D cells. The values of the cut function and the
+   * scalar tree are then kept until the input or the cut function is
+   * modified, which pays off when the same function is cut at several values
+   * (e.g. a plane moved along its normal). This also enables the
+   * vtkContour3DLinearGrid path with a single thread. By default this is off.
+   */
+  vtkSetMacro(UseScalarTree,vtkTypeBool);
+  vtkGetMacro(UseScalarTree,vtkTypeBool);
+  vtkBooleanMacro(UseScalarTree,vtkTypeBool);
+  //@}
+
+  //@{
+  /**
+   * Specify the scalar tree to use. By default a vtkSpanSpace scalar tree is
+   * used.
+   */
+  virtual void SetScalarTree(vtkScalarTree*);
+  vtkGetObjectMacro(ScalarTree,vtkScalarTree);
+  //@}
+
 protected:
   vtkCutter(vtkImplicitFunction *cf=nullptr);
   ~vtkCutter() override;
@@ -231,6 +269,7 @@ protected:
   int RequestUpdateExtent(vtkInformation *, vtkInformationVector **, vtkInformationVector *) override;
   int FillInputPortInformation(int port, vtkInformation *info) override;
   void UnstructuredGridCutter(vtkDataSet *input, vtkPolyData *output);
+  void UnstructuredGridLinearCutter(vtkUnstructuredGrid *input, vtkPolyData *output);
   void DataSetCutter(vtkDataSet *input, vtkPolyData *output);
   void StructuredPointsCutter(vtkDataSet *, vtkPolyData *,
                               vtkInformation *, vtkInformationVector **,
@@ -244,12 +283,21 @@ protected:
   vtkSynchronizedTemplatesCutter3D *SynchronizedTemplatesCutter3D;
   vtkGridSynchronizedTemplates3D *GridSynchronizedTemplates;
   vtkRectilinearSynchronizedTemplates *RectilinearSynchronizedTemplates;
+  vtkContour3DLinearGrid *Contour3DLinearGrid;
 
   vtkIncrementalPointLocator *Locator;
   int SortBy;
   vtkContourValues *ContourValues;
   vtkTypeBool GenerateCutScalars;
   int OutputPointsPrecision;
+  vtkTypeBool UseScalarTree;
+  vtkScalarTree *ScalarTree;
+
+  // The input of Contour3DLinearGrid: a shallow copy of CutGridInput (only
+  // compared, never dereferenced) with the values of the cut function.
+  vtkUnstructuredGrid *CutGrid;
+  vtkUnstructuredGrid *CutGridInput;
+  vtkTimeStamp CutGridTime;
 private:
   vtkCutter(const vtkCutter&) = delete;
   void operator=(const vtkCutter&) = delete;
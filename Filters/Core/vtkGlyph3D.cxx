@@ -14,18 +14,24 @@
 =========================================================================*/
 #include "vtkGlyph3D.h"
 
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCell.h"
+#include "vtkDoubleArray.h"
 #include "vtkFloatArray.h"
 #include "vtkIdList.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkIntArray.h"
 #include "vtkMath.h"
+#include "vtkMatrix4x4.h"
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkTransform.h"
@@ -33,9 +39,424 @@
 #include "vtkUniformGrid.h"
 #include "vtkUnsignedCharArray.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkGlyph3D);
 vtkCxxSetObjectMacro(vtkGlyph3D, SourceTransform, vtkTransform);
 
+//----------------------------------------------------------------------------
+// Parallel execution. The glyph of each input point is computed twice: once
+// to count the output points and cells of each glyph (which gives the offset
+// of each glyph in the output), and once to write the glyph. Both use the
+// same arithmetic as the serial loop of vtkGlyph3D::Execute(), so the output
+// is the same.
+namespace
+{
+
+// The settings of the filter and the input arrays that define the glyph of
+// an input point.
+struct GlyphSettings
+{
+  vtkDataSet *Input;
+  const unsigned char *GhostLevels;
+  vtkDataArray *SScalars;
+  vtkDataArray *Vectors; // vectors or normals, nullptr if not used
+  int ScaleMode;
+  bool Scaling;
+  double ScaleFactor;
+  double Range[2];
+  double Den;
+  bool Clamping;
+  bool Orient;
+  int IndexMode;
+  std::vector<vtkPolyData*> Sources;
+};
+
+// The glyph of an input point.
+struct GlyphParameters
+{
+  double X[3];
+  double V[3];
+  double VMag;
+  double ColorScale; // clamped scale, before the scale factor is applied
+  double Scale[3];
+  bool Rotate; // rotation of 180 degrees around Axis
+  double Axis[3];
+};
+
+// Compute the glyph of an input point. Return the index of its source, or
+// -1 if the point is not glyphed (no source, or duplicated ghost point).
+int ComputeGlyph(const GlyphSettings &settings, vtkIdType inPtId,
+                 GlyphParameters &glyph)
+{
+  double s = 0.0;
+  double scalex = 1.0, scaley = 1.0, scalez = 1.0;
+  if ( settings.SScalars )
+  {
+    s = settings.SScalars->GetComponent(inPtId, 0);
+    if ( settings.ScaleMode == VTK_SCALE_BY_SCALAR ||
+         settings.ScaleMode == VTK_DATA_SCALING_OFF )
+    {
+      scalex = scaley = scalez = s;
+    }
+  }
+
+  double *v = glyph.V;
+  v[0] = v[1] = v[2] = 0.0;
+  glyph.VMag = 0.0;
+  if ( settings.Vectors )
+  {
+    settings.Vectors->GetTuple(inPtId, v);
+    glyph.VMag = vtkMath::Norm(v);
+    if ( settings.ScaleMode == VTK_SCALE_BY_VECTORCOMPONENTS )
+    {
+      scalex = v[0];
+      scaley = v[1];
+      scalez = v[2];
+    }
+    else if ( settings.ScaleMode == VTK_SCALE_BY_VECTOR )
+    {
+      scalex = scaley = scalez = glyph.VMag;
+    }
+  }
+
+  if ( settings.Clamping )
+  {
+    const double *range = settings.Range;
+    scalex = (scalex < range[0] ? range[0] :
+              (scalex > range[1] ? range[1] : scalex));
+    scalex = (scalex - range[0]) / settings.Den;
+    scaley = (scaley < range[0] ? range[0] :
+              (scaley > range[1] ? range[1] : scaley));
+    scaley = (scaley - range[0]) / settings.Den;
+    scalez = (scalez < range[0] ? range[0] :
+              (scalez > range[1] ? range[1] : scalez));
+    scalez = (scalez - range[0]) / settings.Den;
+  }
+
+  int numberOfSources = static_cast<int>(settings.Sources.size());
+  int index = 0;
+  if ( settings.IndexMode != VTK_INDEXING_OFF )
+  {
+    double value =
+      (settings.IndexMode == VTK_INDEXING_BY_SCALAR ? s : glyph.VMag);
+    index = static_cast<int>(
+      (value - settings.Range[0])*numberOfSources / settings.Den);
+    index = (index < 0 ? 0 :
+             (index >= numberOfSources ? (numberOfSources-1) : index));
+  }
+  if ( index < 0 || index >= numberOfSources || !settings.Sources[index] )
+  {
+    return -1;
+  }
+  if ( settings.GhostLevels &&
+       settings.GhostLevels[inPtId] & vtkDataSetAttributes::DUPLICATEPOINT )
+  {
+    return -1;
+  }
+
+  settings.Input->GetPoint(inPtId, glyph.X);
+
+  glyph.Rotate = false;
+  if ( settings.Vectors && settings.Orient && glyph.VMag > 0.0 )
+  {
+    if ( v[1] == 0.0 && v[2] == 0.0 )
+    {
+      if ( v[0] < 0 )
+      {
+        glyph.Rotate = true;
+        glyph.Axis[0] = 0.0;
+        glyph.Axis[1] = 1.0;
+        glyph.Axis[2] = 0.0;
+      }
+    }
+    else
+    {
+      glyph.Rotate = true;
+      glyph.Axis[0] = (v[0] + glyph.VMag) / 2.0;
+      glyph.Axis[1] = v[1] / 2.0;
+      glyph.Axis[2] = v[2] / 2.0;
+    }
+  }
+
+  glyph.ColorScale = scalex;
+  if ( settings.Scaling )
+  {
+    if ( settings.ScaleMode == VTK_DATA_SCALING_OFF )
+    {
+      scalex = scaley = scalez = settings.ScaleFactor;
+    }
+    else
+    {
+      scalex *= settings.ScaleFactor;
+      scaley *= settings.ScaleFactor;
+      scalez *= settings.ScaleFactor;
+    }
+    scalex = (scalex == 0.0 ? 1.0e-10 : scalex);
+    scaley = (scaley == 0.0 ? 1.0e-10 : scaley);
+    scalez = (scalez == 0.0 ? 1.0e-10 : scalez);
+  }
+  else
+  {
+    scalex = scaley = scalez = 1.0;
+  }
+  glyph.Scale[0] = scalex;
+  glyph.Scale[1] = scaley;
+  glyph.Scale[2] = scalez;
+
+  return index;
+}
+
+// Find the source of each input point.
+struct ClassifyGlyphs
+{
+  const GlyphSettings *Settings;
+  int *SourceIds;
+
+  void operator()(vtkIdType inPtId, vtkIdType endPtId) const
+  {
+    GlyphParameters glyph;
+    for (; inPtId < endPtId; ++inPtId)
+    {
+      this->SourceIds[inPtId] = ComputeGlyph(*this->Settings, inPtId, glyph);
+    }
+  }
+};
+
+// A source prepared for the copy of its geometry.
+struct GlyphSource
+{
+  vtkSmartPointer<vtkPoints> Points; // after the source transform
+  vtkDataArray *Normals;
+  vtkDataArray *TCoords;
+  vtkCellArray *Cells; // the only non empty cell array of the source
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfCells;
+  vtkIdType ConnectivitySize;
+};
+
+// The attributes written for each output point (or instance), in addition
+// to its coordinates.
+struct GlyphAttributes
+{
+  int ColorMode;
+  vtkDataArray *ColorScalars; // input scalars copied by ColorByScalar
+  vtkDataArray *NewScalars;
+  float *Scalars; // NewScalars, unless ColorByScalar
+  float *Vectors;
+  vtkIdType *PointIds;
+  vtkIdType *PointMap; // input point of each output point
+
+  void Set(vtkIdType inPtId, vtkIdType ptId, const GlyphParameters &glyph)
+  {
+    if ( this->NewScalars )
+    {
+      if ( this->ColorMode == VTK_COLOR_BY_SCALAR )
+      {
+        this->NewScalars->SetTuple(ptId, inPtId, this->ColorScalars);
+      }
+      else
+      {
+        this->Scalars[ptId] = static_cast<float>(
+          this->ColorMode == VTK_COLOR_BY_SCALE ? glyph.ColorScale :
+                                                  glyph.VMag);
+      }
+    }
+    if ( this->Vectors )
+    {
+      float *vector = this->Vectors + 3 * ptId;
+      vector[0] = static_cast<float>(glyph.V[0]);
+      vector[1] = static_cast<float>(glyph.V[1]);
+      vector[2] = static_cast<float>(glyph.V[2]);
+    }
+    if ( this->PointIds )
+    {
+      this->PointIds[ptId] = inPtId;
+    }
+    this->PointMap[ptId] = inPtId;
+  }
+};
+
+// Copy the transformed geometry of the source of each glyphed input point.
+struct GenerateGlyphs
+{
+  const GlyphSettings *Settings;
+  const GlyphSource *Sources;
+  const int *SourceIds;
+  const vtkIdType *PointOffsets;
+  const vtkIdType *CellOffsets;
+  const vtkIdType *ConnectivityOffsets;
+  GlyphAttributes Attributes;
+  float *FloatPoints; // the output points, in single
+  double *DoublePoints; // or in double precision
+  float *Normals;
+  float *TCoords;
+  int NumberOfTCoordComponents;
+  vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  vtkIdType *CellMap; // input point of each output cell, if needed
+  vtkSMPThreadLocalObject<vtkTransform> Transform;
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType inPtId, vtkIdType endPtId)
+  {
+    vtkTransform *trans = this->Transform.Local();
+    GlyphParameters glyph;
+    double normalMatrix[4][4];
+    double x[3], n[3];
+    float normal[3];
+    vtkIdType npts, *pts;
+    for (; inPtId < endPtId; ++inPtId)
+    {
+      const int sourceId = this->SourceIds[inPtId];
+      if ( sourceId < 0 )
+      {
+        continue;
+      }
+      const GlyphSource &source = this->Sources[sourceId];
+      ComputeGlyph(*this->Settings, inPtId, glyph);
+
+      // Same transformation as in the serial loop.
+      trans->Identity();
+      trans->Translate(glyph.X[0], glyph.X[1], glyph.X[2]);
+      if ( glyph.Rotate )
+      {
+        trans->RotateWXYZ(180.0, glyph.Axis[0], glyph.Axis[1], glyph.Axis[2]);
+      }
+      if ( this->Settings->Scaling )
+      {
+        trans->Scale(glyph.Scale[0], glyph.Scale[1], glyph.Scale[2]);
+      }
+      double (*matrix)[4] = trans->GetMatrix()->Element;
+
+      const vtkIdType ptOffset = this->PointOffsets[inPtId];
+      vtkIdType cellId = this->CellOffsets[inPtId];
+      vtkIdType connId = this->ConnectivityOffsets[inPtId];
+      for (vtkIdType i = 0; i < source.NumberOfCells; ++i, ++cellId)
+      {
+        source.Cells->GetCellAtId(i, npts, pts);
+        this->Offsets[cellId] = connId;
+        for (vtkIdType j = 0; j < npts; ++j)
+        {
+          this->Connectivity[connId++] = pts[j] + ptOffset;
+        }
+        if ( this->CellMap )
+        {
+          this->CellMap[cellId] = inPtId;
+        }
+      }
+
+      if ( this->Normals )
+      {
+        vtkMatrix4x4::DeepCopy(*normalMatrix, trans->GetMatrix());
+        vtkMatrix4x4::Invert(*normalMatrix, *normalMatrix);
+        vtkMatrix4x4::Transpose(*normalMatrix, *normalMatrix);
+      }
+      for (vtkIdType i = 0; i < source.NumberOfPoints; ++i)
+      {
+        const vtkIdType ptId = ptOffset + i;
+        source.Points->GetPoint(i, x);
+        for (int c = 0; c < 3; ++c)
+        {
+          double p = matrix[c][0]*x[0] + matrix[c][1]*x[1] +
+            matrix[c][2]*x[2] + matrix[c][3];
+          if ( this->DoublePoints )
+          {
+            this->DoublePoints[3 * ptId + c] = p;
+          }
+          else
+          {
+            this->FloatPoints[3 * ptId + c] = static_cast<float>(p);
+          }
+        }
+        if ( this->Normals )
+        {
+          source.Normals->GetTuple(i, n);
+          for (int c = 0; c < 3; ++c)
+          {
+            normal[c] = static_cast<float>(normalMatrix[c][0]*n[0] +
+              normalMatrix[c][1]*n[1] + normalMatrix[c][2]*n[2]);
+          }
+          vtkMath::Normalize(normal);
+          std::copy(normal, normal + 3, this->Normals + 3 * ptId);
+        }
+        if ( this->TCoords )
+        {
+          float *tc = this->TCoords + this->NumberOfTCoordComponents * ptId;
+          for (int c = 0; c < this->NumberOfTCoordComponents; ++c)
+          {
+            tc[c] = static_cast<float>(source.TCoords->GetComponent(i, c));
+          }
+        }
+        this->Attributes.Set(inPtId, ptId, glyph);
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Write the instance of each glyphed input point: a vertex located at the
+// input point, with the index of its source, its orientation (a unit
+// quaternion) and its scale factors.
+struct GenerateInstances
+{
+  const GlyphSettings *Settings;
+  const int *SourceIds;
+  const vtkIdType *InstanceIds;
+  GlyphAttributes Attributes;
+  vtkPoints *Points;
+  vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  int *SourceIndices;
+  float *Orientations;
+  float *Scales;
+
+  void operator()(vtkIdType inPtId, vtkIdType endPtId)
+  {
+    GlyphParameters glyph;
+    for (; inPtId < endPtId; ++inPtId)
+    {
+      const int sourceId = this->SourceIds[inPtId];
+      if ( sourceId < 0 )
+      {
+        continue;
+      }
+      ComputeGlyph(*this->Settings, inPtId, glyph);
+      const vtkIdType id = this->InstanceIds[inPtId];
+      this->Points->SetPoint(id, glyph.X);
+      this->Offsets[id] = id;
+      this->Connectivity[id] = id;
+      this->SourceIndices[id] = sourceId;
+
+      float *q = this->Orientations + 4 * id;
+      q[0] = 1.0f;
+      q[1] = q[2] = q[3] = 0.0f;
+      if ( glyph.Rotate )
+      {
+        vtkMath::Normalize(glyph.Axis);
+        q[0] = 0.0f;
+        q[1] = static_cast<float>(glyph.Axis[0]);
+        q[2] = static_cast<float>(glyph.Axis[1]);
+        q[3] = static_cast<float>(glyph.Axis[2]);
+      }
+      float *scale = this->Scales + 3 * id;
+      scale[0] = static_cast<float>(glyph.Scale[0]);
+      scale[1] = static_cast<float>(glyph.Scale[1]);
+      scale[2] = static_cast<float>(glyph.Scale[2]);
+      this->Attributes.Set(inPtId, id, glyph);
+    }
+  }
+};
+
+}
+
 //----------------------------------------------------------------------------
 // Construct object with scaling on, scaling mode is by scalar value,
 // scale factor = 1.0, the range is (0,1), orient geometry is on, and
@@ -60,6 +481,7 @@ vtkGlyph3D::vtkGlyph3D()
   this->FillCellData = 0;
   this->SourceTransform = nullptr;
   this->OutputPointsPrecision = vtkAlgorithm::DEFAULT_PRECISION;
+  this->OutputMode = VTK_GLYPH_OUTPUT_GEOMETRY;
 
   // by default process active point scalars
   this->SetInputArrayToProcess(0,0,0,vtkDataObject::FIELD_ASSOCIATION_POINTS,
@@ -265,6 +687,22 @@ bool vtkGlyph3D::Execute(
     source = defaultSource;
   }
 
+  // Instances are always generated in parallel, and so are the glyphs
+  // when more than one thread is available.
+  if ( this->OutputMode == VTK_GLYPH_OUTPUT_INSTANCES ||
+       vtkSMPTools::GetEstimatedNumberOfThreads() > 1 )
+  {
+    int result = this->ExecuteInParallel(input, sourceVector, source, output,
+                                         inSScalars, inVectors, inNormals,
+                                         inCScalars, inGhostLevels);
+    if ( result >= 0 )
+    {
+      pts->Delete();
+      trans->Delete();
+      return result != 0;
+    }
+  }
+
   if ( this->IndexMode != VTK_INDEXING_OFF )
   {
     pd = nullptr;
@@ -741,6 +1179,383 @@ bool vtkGlyph3D::Execute(
   return true;
 }
 
+//----------------------------------------------------------------------------
+int vtkGlyph3D::ExecuteInParallel(
+  vtkDataSet* input,
+  vtkInformationVector* sourceVector,
+  vtkPolyData* source,
+  vtkPolyData* output,
+  vtkDataArray *inSScalars,
+  vtkDataArray *inVectors,
+  vtkDataArray *inNormals,
+  vtkDataArray *inCScalars,
+  const unsigned char *inGhostLevels)
+{
+  const bool instances = (this->OutputMode == VTK_GLYPH_OUTPUT_INSTANCES);
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  vtkPointData *pd = input->GetPointData();
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+
+  GlyphSettings settings;
+  settings.Input = input;
+  settings.GhostLevels = inGhostLevels;
+  settings.SScalars = inSScalars;
+  settings.Vectors = nullptr;
+  if ( this->VectorMode == VTK_USE_VECTOR )
+  {
+    settings.Vectors = inVectors;
+  }
+  else if ( this->VectorMode == VTK_USE_NORMAL )
+  {
+    settings.Vectors = inNormals;
+  }
+  if ( settings.Vectors && settings.Vectors->GetNumberOfComponents() > 3 )
+  {
+    vtkErrorMacro(<<"vtkDataArray "<<settings.Vectors->GetName()
+                  <<" has more than 3 components.\n");
+    return 0;
+  }
+  settings.ScaleMode = this->ScaleMode;
+  settings.Scaling = (this->Scaling != 0);
+  settings.ScaleFactor = this->ScaleFactor;
+  settings.Range[0] = this->Range[0];
+  settings.Range[1] = this->Range[1];
+  settings.Den = this->Range[1] - this->Range[0];
+  if ( settings.Den == 0.0 )
+  {
+    settings.Den = 1.0;
+  }
+  settings.Clamping = (this->Clamping != 0);
+  settings.Orient = (this->Orient != 0);
+  settings.IndexMode = this->IndexMode;
+  if ( this->IndexMode != VTK_INDEXING_OFF )
+  {
+    int numberOfSources = this->GetNumberOfInputConnections(1);
+    for (int i = 0; i < numberOfSources; ++i)
+    {
+      settings.Sources.push_back(this->GetSource(i, sourceVector));
+    }
+  }
+  else
+  {
+    settings.Sources.push_back(source);
+  }
+
+  // The geometry of the glyphs goes to a single cell array of the output:
+  // sources mixing vertices, lines, polygons and strips are glyphed
+  // serially, as cells are ordered by insertion there.
+  std::vector<GlyphSource> glyphSources(settings.Sources.size());
+  int cellArrayIndex = -1;
+  bool haveNormals = true;
+  for (size_t i = 0; i < settings.Sources.size() && !instances; ++i)
+  {
+    vtkPolyData *glyphSource = settings.Sources[i];
+    if ( !glyphSource )
+    {
+      continue;
+    }
+    vtkCellArray *cellArrays[4] = { glyphSource->GetVerts(),
+      glyphSource->GetLines(), glyphSource->GetPolys(),
+      glyphSource->GetStrips() };
+    GlyphSource &prepared = glyphSources[i];
+    prepared.Cells = nullptr;
+    for (int j = 0; j < 4; ++j)
+    {
+      if ( cellArrays[j]->GetNumberOfCells() > 0 )
+      {
+        if ( prepared.Cells || (cellArrayIndex >= 0 && cellArrayIndex != j) )
+        {
+          return -1;
+        }
+        prepared.Cells = cellArrays[j];
+        cellArrayIndex = j;
+      }
+    }
+    prepared.NumberOfCells =
+      (prepared.Cells ? prepared.Cells->GetNumberOfCells() : 0);
+    prepared.ConnectivitySize =
+      (prepared.Cells ? prepared.Cells->GetNumberOfConnectivityIds() : 0);
+    prepared.Points = glyphSource->GetPoints();
+    prepared.NumberOfPoints = glyphSource->GetNumberOfPoints();
+    if ( this->SourceTransform && prepared.Points )
+    {
+      prepared.Points = vtkSmartPointer<vtkPoints>::New();
+      prepared.Points->SetDataTypeToDouble();
+      this->SourceTransform->TransformPoints(glyphSource->GetPoints(),
+                                             prepared.Points);
+    }
+    prepared.Normals = glyphSource->GetPointData()->GetNormals();
+    prepared.TCoords = glyphSource->GetPointData()->GetTCoords();
+    haveNormals = haveNormals && prepared.Normals;
+  }
+  const bool haveTCoords = !instances &&
+    this->IndexMode == VTK_INDEXING_OFF && glyphSources[0].TCoords;
+  haveNormals = haveNormals && !instances;
+
+  // Find the glyph of each input point, then the location of the glyphs in
+  // the output. Visibility is checked serially, as IsPointVisible() may be
+  // overridden.
+  std::vector<int> sourceIds(numPts);
+  ClassifyGlyphs classify = { &settings, sourceIds.data() };
+  vtkSMPTools::For(0, numPts, classify);
+  this->UpdateProgress(0.2);
+
+  vtkUniformGrid *inputUG = vtkUniformGrid::SafeDownCast(input);
+  std::vector<vtkIdType> pointOffsets(numPts);
+  std::vector<vtkIdType> cellOffsets(instances ? 0 : numPts);
+  std::vector<vtkIdType> connectivityOffsets(instances ? 0 : numPts);
+  vtkIdType numNewPts = 0, numNewCells = 0, connectivitySize = 0;
+  for (vtkIdType inPtId = 0; inPtId < numPts; ++inPtId)
+  {
+    int &sourceId = sourceIds[inPtId];
+    if ( sourceId >= 0 &&
+         ((inputUG && !inputUG->IsPointVisible(inPtId)) ||
+          !this->IsPointVisible(input, inPtId)) )
+    {
+      sourceId = -1;
+    }
+    if ( sourceId < 0 )
+    {
+      continue;
+    }
+    pointOffsets[inPtId] = numNewPts;
+    if ( instances )
+    {
+      ++numNewPts;
+    }
+    else
+    {
+      const GlyphSource &glyphSource = glyphSources[sourceId];
+      cellOffsets[inPtId] = numNewCells;
+      connectivityOffsets[inPtId] = connectivitySize;
+      numNewPts += glyphSource.NumberOfPoints;
+      numNewCells += glyphSource.NumberOfCells;
+      connectivitySize += glyphSource.ConnectivitySize;
+    }
+  }
+  if ( instances )
+  {
+    numNewCells = connectivitySize = numNewPts;
+  }
+  this->UpdateProgress(0.3);
+
+  // Allocate the output, as the serial loop does.
+  const bool copyPointData = instances || this->IndexMode == VTK_INDEXING_OFF;
+  if ( copyPointData )
+  {
+    outputPD->CopyAllocate(pd, numNewPts);
+    if ( this->FillCellData )
+    {
+      outputCD->CopyAllocate(pd, numNewCells);
+    }
+  }
+
+  vtkNew<vtkPoints> newPts;
+  if ( this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION )
+  {
+    newPts->SetDataType(VTK_DOUBLE);
+  }
+  else
+  {
+    newPts->SetDataType(VTK_FLOAT);
+  }
+  newPts->SetNumberOfPoints(numNewPts);
+
+  GlyphAttributes attributes;
+  attributes.ColorMode = this->ColorMode;
+  attributes.ColorScalars = inCScalars;
+  attributes.NewScalars = nullptr;
+  attributes.Scalars = nullptr;
+  attributes.Vectors = nullptr;
+  attributes.PointIds = nullptr;
+  std::vector<vtkIdType> pointMap(numNewPts);
+  attributes.PointMap = pointMap.data();
+
+  vtkSmartPointer<vtkIdTypeArray> pointIds;
+  if ( this->GeneratePointIds )
+  {
+    pointIds = vtkSmartPointer<vtkIdTypeArray>::New();
+    pointIds->SetName(this->PointIdsName);
+    pointIds->SetNumberOfTuples(numNewPts);
+    outputPD->AddArray(pointIds);
+    attributes.PointIds = pointIds->GetPointer(0);
+  }
+  vtkSmartPointer<vtkDataArray> newScalars;
+  if ( this->ColorMode == VTK_COLOR_BY_SCALAR && inCScalars )
+  {
+    newScalars.TakeReference(inCScalars->NewInstance());
+    newScalars->SetNumberOfComponents(inCScalars->GetNumberOfComponents());
+    newScalars->SetName(inCScalars->GetName());
+  }
+  else if ( (this->ColorMode == VTK_COLOR_BY_SCALE) && inSScalars)
+  {
+    newScalars = vtkSmartPointer<vtkFloatArray>::New();
+    newScalars->SetName("GlyphScale");
+    if (this->ScaleMode == VTK_SCALE_BY_SCALAR)
+    {
+      newScalars->SetName(inSScalars->GetName());
+    }
+  }
+  else if ( (this->ColorMode == VTK_COLOR_BY_VECTOR) && settings.Vectors )
+  {
+    newScalars = vtkSmartPointer<vtkFloatArray>::New();
+    newScalars->SetName("VectorMagnitude");
+  }
+  if ( newScalars )
+  {
+    newScalars->SetNumberOfTuples(numNewPts);
+    attributes.NewScalars = newScalars;
+    int idx = outputPD->AddArray(newScalars);
+    outputPD->SetActiveAttribute(idx, vtkDataSetAttributes::SCALARS);
+    if ( this->ColorMode != VTK_COLOR_BY_SCALAR )
+    {
+      attributes.Scalars =
+        static_cast<vtkFloatArray*>(newScalars.GetPointer())->GetPointer(0);
+    }
+  }
+  vtkSmartPointer<vtkFloatArray> newVectors;
+  if ( settings.Vectors && !instances )
+  {
+    newVectors = vtkSmartPointer<vtkFloatArray>::New();
+    newVectors->SetNumberOfComponents(3);
+    newVectors->SetNumberOfTuples(numNewPts);
+    newVectors->SetName("GlyphVector");
+    attributes.Vectors = newVectors->GetPointer(0);
+  }
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfTuples(numNewCells + 1);
+  offsets->SetValue(numNewCells, connectivitySize);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfTuples(connectivitySize);
+  std::vector<vtkIdType> cellMap(this->FillCellData && copyPointData ?
+                                 numNewCells : 0);
+
+  if ( instances )
+  {
+    vtkNew<vtkIntArray> sourceIndices;
+    sourceIndices->SetName("GlyphSourceIndex");
+    sourceIndices->SetNumberOfTuples(numNewPts);
+    vtkNew<vtkFloatArray> orientations;
+    orientations->SetName("GlyphOrientation");
+    orientations->SetNumberOfComponents(4);
+    orientations->SetNumberOfTuples(numNewPts);
+    vtkNew<vtkFloatArray> scales;
+    scales->SetName("GlyphScaleFactors");
+    scales->SetNumberOfComponents(3);
+    scales->SetNumberOfTuples(numNewPts);
+
+    GenerateInstances generate = { &settings, sourceIds.data(),
+      pointOffsets.data(), attributes, newPts, offsets->GetPointer(0),
+      connectivity->GetPointer(0), sourceIndices->GetPointer(0),
+      orientations->GetPointer(0), scales->GetPointer(0) };
+    vtkSMPTools::For(0, numPts, generate);
+
+    outputPD->AddArray(sourceIndices);
+    outputPD->AddArray(orientations);
+    outputPD->AddArray(scales);
+    if ( !cellMap.empty() )
+    {
+      std::copy(pointMap.begin(), pointMap.end(), cellMap.begin());
+    }
+  }
+  else
+  {
+    vtkSmartPointer<vtkFloatArray> newNormals;
+    if ( haveNormals )
+    {
+      newNormals = vtkSmartPointer<vtkFloatArray>::New();
+      newNormals->SetNumberOfComponents(3);
+      newNormals->SetNumberOfTuples(numNewPts);
+      newNormals->SetName("Normals");
+    }
+    vtkSmartPointer<vtkFloatArray> newTCoords;
+    if ( haveTCoords )
+    {
+      newTCoords = vtkSmartPointer<vtkFloatArray>::New();
+      newTCoords->SetNumberOfComponents(
+        glyphSources[0].TCoords->GetNumberOfComponents());
+      newTCoords->SetNumberOfTuples(numNewPts);
+      newTCoords->SetName("TCoords");
+    }
+
+    GenerateGlyphs generate;
+    generate.Settings = &settings;
+    generate.Sources = glyphSources.data();
+    generate.SourceIds = sourceIds.data();
+    generate.PointOffsets = pointOffsets.data();
+    generate.CellOffsets = cellOffsets.data();
+    generate.ConnectivityOffsets = connectivityOffsets.data();
+    generate.Attributes = attributes;
+    generate.FloatPoints = nullptr;
+    generate.DoublePoints = nullptr;
+    if ( newPts->GetDataType() == VTK_DOUBLE )
+    {
+      generate.DoublePoints =
+        static_cast<vtkDoubleArray*>(newPts->GetData())->GetPointer(0);
+    }
+    else
+    {
+      generate.FloatPoints =
+        static_cast<vtkFloatArray*>(newPts->GetData())->GetPointer(0);
+    }
+    generate.Normals = (newNormals ? newNormals->GetPointer(0) : nullptr);
+    generate.TCoords = (newTCoords ? newTCoords->GetPointer(0) : nullptr);
+    generate.NumberOfTCoordComponents =
+      (newTCoords ? newTCoords->GetNumberOfComponents() : 0);
+    generate.Offsets = offsets->GetPointer(0);
+    generate.Connectivity = connectivity->GetPointer(0);
+    generate.CellMap = (cellMap.empty() ? nullptr : cellMap.data());
+    vtkSMPTools::For(0, numPts, generate);
+
+    if ( newVectors )
+    {
+      outputPD->SetVectors(newVectors);
+    }
+    if ( newNormals )
+    {
+      outputPD->SetNormals(newNormals);
+    }
+    if ( newTCoords )
+    {
+      outputPD->SetTCoords(newTCoords);
+    }
+  }
+  this->UpdateProgress(0.8);
+
+  // Copy the point data of the input points to the glyphs, then assemble the
+  // output.
+  if ( copyPointData )
+  {
+    outputPD->ParallelCopyData(pd, pointMap.data(), numNewPts);
+    if ( this->FillCellData )
+    {
+      outputCD->ParallelCopyData(pd, cellMap.data(), numNewCells);
+    }
+  }
+  output->SetPoints(newPts);
+  vtkNew<vtkCellArray> cells;
+  cells->SetData(offsets, connectivity);
+  switch ( instances ? 0 : cellArrayIndex )
+  {
+    case 0:
+      output->SetVerts(cells);
+      break;
+    case 1:
+      output->SetLines(cells);
+      break;
+    case 2:
+      output->SetPolys(cells);
+      break;
+    case 3:
+      output->SetStrips(cells);
+      break;
+  }
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 // Specify a source object at a specified table location.
 void vtkGlyph3D::SetSourceConnection(int id, vtkAlgorithmOutput* algOutput)
@@ -838,6 +1653,8 @@ void vtkGlyph3D::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "Color Mode: " << this->GetColorModeAsString() << endl;
 
+  os << indent << "Output Mode: " << this->GetOutputModeAsString() << endl;
+
   if ( this->GetNumberOfInputConnections(1) < 2 )
   {
     if ( this->GetSource(0) != nullptr )
@@ -73,6 +73,14 @@
  * vtkAlgorithm. The first array is scalars, the next vectors, the next
  * normals and finally color scalars.
  *
+ * @warning
+ * When more than one thread is available, the glyphs are generated in
+ * parallel with vtkSMPTools (unless the sources mix vertices, lines,
+ * polygons and/or strips). The output is the same as the serial one.
+ * Alternatively, the OutputMode can be set to produce one instance (a
+ * vertex with the parameters of the glyph) per glyphed point instead of
+ * the glyph geometry, for consumers that can draw instances.
+ *
  * @sa
  * vtkTensorGlyph
 */
@@ -100,6 +108,9 @@
 #define VTK_INDEXING_BY_SCALAR 1
 #define VTK_INDEXING_BY_VECTOR 2
 
+#define VTK_GLYPH_OUTPUT_GEOMETRY 0
+#define VTK_GLYPH_OUTPUT_INSTANCES 1
+
 class vtkTransform;
 
 class VTKFILTERSCORE_EXPORT vtkGlyph3D : public vtkPolyDataAlgorithm
@@ -318,6 +329,29 @@ public:
   vtkGetMacro(OutputPointsPrecision,int);
   //@}
 
+  //@{
+  /**
+   * Specify whether to generate the geometry of the glyphs (the default),
+   * or one instance of a glyph per glyphed point. An instance is a vertex
+   * located at the input point, with point data arrays giving the index of
+   * its source ("GlyphSourceIndex"), its orientation as a unit quaternion
+   * (w, x, y, z) ("GlyphOrientation") and its scale factors along x, y and
+   * z ("GlyphScaleFactors"). The glyph of an instance is its source, first
+   * transformed by the SourceTransform, then scaled, rotated and
+   * translated to the vertex. The point data of the input and the color
+   * scalars are passed to the instances. This option is not supported by
+   * vtkGlyph2D.
+   */
+  vtkSetClampMacro(OutputMode,int,
+                   VTK_GLYPH_OUTPUT_GEOMETRY,VTK_GLYPH_OUTPUT_INSTANCES);
+  vtkGetMacro(OutputMode,int);
+  void SetOutputModeToGeometry()
+    {this->SetOutputMode(VTK_GLYPH_OUTPUT_GEOMETRY);};
+  void SetOutputModeToInstances()
+    {this->SetOutputMode(VTK_GLYPH_OUTPUT_INSTANCES);};
+  const char *GetOutputModeAsString();
+  //@}
+
 protected:
   vtkGlyph3D();
   ~vtkGlyph3D() override;
@@ -344,6 +378,21 @@ protected:
                        vtkDataArray *inVectors);
   //@}
 
+  /**
+   * Generate the glyphs or their instances with vtkSMPTools. Returns 1 on
+   * success, 0 on error, and -1 when the glyphs have to be generated by the
+   * serial loop of Execute() instead.
+   */
+  int ExecuteInParallel(vtkDataSet* input,
+                        vtkInformationVector* sourceVector,
+                        vtkPolyData* source,
+                        vtkPolyData* output,
+                        vtkDataArray *inSScalars,
+                        vtkDataArray *inVectors,
+                        vtkDataArray *inNormals,
+                        vtkDataArray *inCScalars,
+                        const unsigned char *inGhostLevels);
+
   vtkPolyData **Source; // Geometry to copy to each point
   vtkTypeBool Scaling; // Determine whether scaling of geometry is performed
   int ScaleMode; // Scale by scalar value or vector magnitude
@@ -359,6 +408,7 @@ protected:
   char *PointIdsName;
   vtkTransform* SourceTransform;
   int OutputPointsPrecision;
+  int OutputMode; // generate the glyph geometry or the instances
 
 private:
   vtkGlyph3D(const vtkGlyph3D&) = delete;
@@ -449,4 +499,21 @@ inline const char *vtkGlyph3D::GetIndexModeAsString(void)
 }
 //@}
 
+//@{
+/**
+ * Return the output mode as a character string.
+ */
+inline const char *vtkGlyph3D::GetOutputModeAsString(void)
+{
+  if ( this->OutputMode == VTK_GLYPH_OUTPUT_INSTANCES )
+  {
+    return "Instances";
+  }
+  else
+  {
+    return "Geometry";
+  }
+}
+//@}
+
 #endif
@@ -14,9 +14,9 @@
 =========================================================================*/
 #include "vtkIdFilter.h"
 
+#include "vtkAffineArray.h"
 #include "vtkCellData.h"
 #include "vtkDataSet.h"
-#include "vtkDataSet.h"
 #include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -25,6 +25,31 @@
 
 vtkStandardNewMacro(vtkIdFilter);
 
+namespace
+{
+
+// Return a new array holding the ids 0 to numIds - 1, stored or implicit.
+vtkDataArray *vtkNewIdsArray(vtkIdType numIds, bool implicit)
+{
+  if ( implicit )
+  {
+    vtkAffineArray<vtkIdType> *ids = vtkAffineArray<vtkIdType>::New();
+    ids->SetNumberOfTuples(numIds);
+    ids->SetBackend(vtkAffineImplicitBackend<vtkIdType>(0, 1));
+    return ids;
+  }
+
+  vtkIdTypeArray *ids = vtkIdTypeArray::New();
+  ids->SetNumberOfValues(numIds);
+  for (vtkIdType id=0; id < numIds; id++)
+  {
+    ids->SetValue(id, id);
+  }
+  return ids;
+}
+
+}
+
 // Construct object with PointIds and CellIds on; and ids being generated
 // as scalars.
 vtkIdFilter::vtkIdFilter()
@@ -34,6 +59,7 @@ vtkIdFilter::vtkIdFilter()
   this->FieldData = 0;
   this->IdsArrayName = nullptr;
   this->SetIdsArrayName("vtkIdFilter_Ids");
+  this->ImplicitIds = 0;
 }
 
 vtkIdFilter::~vtkIdFilter()
@@ -59,9 +85,9 @@ int vtkIdFilter::RequestData(
   vtkDataSet *output = vtkDataSet::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType numPts, numCells, id;
-  vtkIdTypeArray *ptIds;
-  vtkIdTypeArray *cellIds;
+  vtkIdType numPts, numCells;
+  vtkDataArray *ptIds;
+  vtkDataArray *cellIds;
   vtkPointData *inPD=input->GetPointData(), *outPD=output->GetPointData();
   vtkCellData *inCD=input->GetCellData(), *outCD=output->GetCellData();
 
@@ -79,13 +105,7 @@ int vtkIdFilter::RequestData(
   //
   if ( this->PointIds && numPts > 0 )
   {
-    ptIds = vtkIdTypeArray::New();
-    ptIds->SetNumberOfValues(numPts);
-
-    for (id=0; id < numPts; id++)
-    {
-      ptIds->SetValue(id, id);
-    }
+    ptIds = vtkNewIdsArray(numPts, this->ImplicitIds != 0);
 
     ptIds->SetName(this->IdsArrayName);
     if ( ! this->FieldData )
@@ -106,13 +126,7 @@ int vtkIdFilter::RequestData(
   //
   if ( this->CellIds && numCells > 0 )
   {
-    cellIds = vtkIdTypeArray::New();
-    cellIds->SetNumberOfValues(numCells);
-
-    for (id=0; id < numCells; id++)
-    {
-      cellIds->SetValue(id, id);
-    }
+    cellIds = vtkNewIdsArray(numCells, this->ImplicitIds != 0);
 
     cellIds->SetName(this->IdsArrayName);
     if ( ! this->FieldData )
@@ -144,4 +158,5 @@ void vtkIdFilter::PrintSelf(ostream& os, vtkIndent indent)
   os << indent << "Field Data: "   << (this->FieldData ? "On\n" : "Off\n");
   os << indent << "IdsArrayName: " << (this->IdsArrayName ? this->IdsArrayName
        : "(none)") << "\n";
+  os << indent << "Implicit Ids: " << (this->ImplicitIds ? "On\n" : "Off\n");
 }
@@ -25,6 +25,9 @@
  * Typically this filter is used with vtkLabeledDataMapper (and possibly
  * vtkSelectVisiblePoints) to create labels for points and cells, or labels
  * for the point or cell data scalar values.
+ *
+ * When ImplicitIds is on, the ids are generated as vtkAffineArray<vtkIdType>
+ * arrays, which compute the ids on demand instead of storing them.
 */
 
 #ifndef vtkIdFilter_h
@@ -83,6 +86,17 @@ public:
   vtkGetStringMacro(IdsArrayName);
   //@}
 
+  //@{
+  /**
+   * Set/Get the flag which controls whether the ids are stored in a
+   * vtkIdTypeArray or computed on demand by a vtkAffineArray<vtkIdType>,
+   * which takes no memory. Default is off.
+   */
+  vtkSetMacro(ImplicitIds,vtkTypeBool);
+  vtkGetMacro(ImplicitIds,vtkTypeBool);
+  vtkBooleanMacro(ImplicitIds,vtkTypeBool);
+  //@}
+
 protected:
   vtkIdFilter();
   ~vtkIdFilter() override;
@@ -93,6 +107,7 @@ protected:
   vtkTypeBool CellIds;
   vtkTypeBool FieldData;
   char *IdsArrayName;
+  vtkTypeBool ImplicitIds;
 
 private:
   vtkIdFilter(const vtkIdFilter&) = delete;
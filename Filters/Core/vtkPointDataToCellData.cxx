@@ -18,16 +18,28 @@
 #include <cassert>
 #include <limits>
 #include <set>
+#include <utility>
 #include <vector>
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellData.h"
 #include "vtkDataArray.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDataSet.h"
 #include "vtkIdList.h"
+#include "vtkImageData.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkMath.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
+#include "vtkStructuredData.h"
+#include "vtkStructuredGrid.h"
+#include "vtkUnstructuredGrid.h"
 
 #define VTK_EPSILON 1.e-6
 
@@ -149,6 +161,255 @@ vtkIdType Histogram::IndexOfLargestBin()
   return std::max_element(this->Bins.begin(), it2, BinCountCmp)->Index;
 }
 
+//----------------------------------------------------------------------------
+// Points of the cells of unstructured grids and polydata, read directly from
+// their cell arrays. The cells of the polydata must have been built.
+struct UnstructuredCellPoints
+{
+  vtkUnstructuredGrid *Grid;
+  vtkPolyData *PolyData;
+
+  vtkIdType GetCellPoints(vtkIdType cellId, vtkIdType *&pts, vtkIdType*) const
+  {
+    vtkIdType npts;
+    if (this->Grid)
+    {
+      this->Grid->GetCellPoints(cellId, npts, pts);
+    }
+    else
+    {
+      this->PolyData->GetCellPoints(cellId, npts, pts);
+    }
+    return npts;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Points of the cells of structured datasets, computed from the structured
+// coordinates of the cells. They are listed in the order of
+// vtkStructuredData::GetCellPoints(), or in the order of
+// vtkStructuredGrid::GetCellPoints() which goes around the faces of quads and
+// hexahedra.
+struct StructuredCellPoints
+{
+  int Dimensions[3];
+  int DataDescription;
+  bool FaceOrder;
+
+  vtkIdType GetCellPoints(vtkIdType cellId, vtkIdType *&pts,
+                          vtkIdType buffer[8]) const
+  {
+    const int *dim = this->Dimensions;
+    vtkIdType iMin = 0, iMax = 0, jMin = 0, jMax = 0, kMin = 0, kMax = 0;
+    switch (this->DataDescription)
+    {
+      case VTK_X_LINE:
+        iMin = cellId;
+        iMax = cellId + 1;
+        break;
+
+      case VTK_Y_LINE:
+        jMin = cellId;
+        jMax = cellId + 1;
+        break;
+
+      case VTK_Z_LINE:
+        kMin = cellId;
+        kMax = cellId + 1;
+        break;
+
+      case VTK_XY_PLANE:
+        iMin = cellId % (dim[0]-1);
+        iMax = iMin + 1;
+        jMin = cellId / (dim[0]-1);
+        jMax = jMin + 1;
+        break;
+
+      case VTK_YZ_PLANE:
+        jMin = cellId % (dim[1]-1);
+        jMax = jMin + 1;
+        kMin = cellId / (dim[1]-1);
+        kMax = kMin + 1;
+        break;
+
+      case VTK_XZ_PLANE:
+        iMin = cellId % (dim[0]-1);
+        iMax = iMin + 1;
+        kMin = cellId / (dim[0]-1);
+        kMax = kMin + 1;
+        break;
+
+      case VTK_XYZ_GRID:
+        iMin = cellId % (dim[0] - 1);
+        iMax = iMin + 1;
+        jMin = (cellId / (dim[0] - 1)) % (dim[1] - 1);
+        jMax = jMin + 1;
+        kMin = cellId / (static_cast<vtkIdType>(dim[0] - 1) * (dim[1] - 1));
+        kMax = kMin + 1;
+        break;
+
+      default: // VTK_SINGLE_POINT
+        break;
+    }
+
+    vtkIdType npts = 0;
+    vtkIdType const d01 = static_cast<vtkIdType>(dim[0])*dim[1];
+    for (vtkIdType k = kMin; k <= kMax; k++)
+    {
+      for (vtkIdType j = jMin; j <= jMax; j++)
+      {
+        for (vtkIdType i = iMin; i <= iMax; i++)
+        {
+          buffer[npts++] = i + j*dim[0] + k*d01;
+        }
+      }
+    }
+    if (this->FaceOrder && npts >= 4)
+    {
+      std::swap(buffer[2], buffer[3]);
+      if (npts == 8)
+      {
+        std::swap(buffer[6], buffer[7]);
+      }
+    }
+    pts = buffer;
+    return npts;
+  }
+};
+
+//----------------------------------------------------------------------------
+// Threaded averaging of the point values of every cell. The values are
+// combined the way vtkDataArray::InterpolateTuple() does, so that the result
+// matches the serial code exactly.
+template <typename CellPointsT, typename SrcArrayT, typename DstArrayT>
+struct AverageCellPoints
+{
+  const CellPointsT *CellPoints;
+  SrcArrayT *Source;
+  DstArrayT *Destination;
+
+  AverageCellPoints(const CellPointsT *cellPoints, SrcArrayT *src,
+                    DstArrayT *dst) :
+    CellPoints(cellPoints), Source(src), Destination(dst)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    typedef typename vtkDataArrayAccessor<DstArrayT>::APIType T;
+    vtkDataArrayAccessor<SrcArrayT> src(this->Source);
+    vtkDataArrayAccessor<DstArrayT> dst(this->Destination);
+    const int numComps = this->Destination->GetNumberOfComponents();
+    vtkIdType buffer[8];
+
+    for (vtkIdType cellId = begin; cellId < end; cellId++)
+    {
+      vtkIdType *pts;
+      vtkIdType numPts =
+        this->CellPoints->GetCellPoints(cellId, pts, buffer);
+      if (numPts == 0)
+      {
+        continue;
+      }
+      double weight = 1.0 / numPts;
+      for (int comp = 0; comp < numComps; comp++)
+      {
+        double val = 0.;
+        for (vtkIdType i = 0; i < numPts; i++)
+        {
+          val += weight * static_cast<double>(src.Get(pts[i], comp));
+        }
+        T valT;
+        vtkMath::RoundDoubleToIntegralIfNecessary(val, &valT);
+        dst.Set(cellId, comp, valT);
+      }
+    }
+  }
+};
+
+template <typename CellPointsT>
+struct AverageCellPointsWorker
+{
+  const CellPointsT *CellPoints;
+
+  template <typename SrcArrayT, typename DstArrayT>
+  void operator()(SrcArrayT *src, DstArrayT *dst)
+  {
+    AverageCellPoints<CellPointsT, SrcArrayT, DstArrayT> average(
+      this->CellPoints, src, dst);
+    vtkSMPTools::For(0, dst->GetNumberOfTuples(), average);
+  }
+};
+
+//----------------------------------------------------------------------------
+// Pair the arrays allocated by InterpolateAllocate() with the arrays they
+// interpolate, matching them by name like vtkArrayListTemplate does. Returns
+// false if an array needs the generic interpolation (e.g., nearest neighbor
+// attributes or non-numeric arrays).
+bool PairInterpolatedArrays(vtkDataSetAttributes *in, vtkDataSetAttributes *out,
+  std::vector<std::pair<vtkDataArray*, vtkDataArray*> > &pairs)
+{
+  for (int i = 0; i < out->GetNumberOfArrays(); ++i)
+  {
+    vtkAbstractArray *outArray = out->GetAbstractArray(i);
+    // Arrays passed from the input already have their tuples.
+    if (outArray->GetNumberOfTuples() != 0)
+    {
+      continue;
+    }
+    const char *name = outArray->GetName();
+    vtkDataArray *inArray = name ?
+      vtkDataArray::FastDownCast(in->GetAbstractArray(name)) : nullptr;
+    vtkDataArray *outDataArray = vtkDataArray::FastDownCast(outArray);
+    int attribute = out->IsArrayAnAttribute(i);
+    if (!inArray || !outDataArray ||
+        inArray->GetDataType() != outDataArray->GetDataType() ||
+        inArray->GetNumberOfComponents() != outDataArray->GetNumberOfComponents() ||
+        (attribute != -1 &&
+         out->GetCopyAttribute(attribute, vtkDataSetAttributes::INTERPOLATE) == 2))
+    {
+      return false;
+    }
+    pairs.push_back(std::make_pair(inArray, outDataArray));
+  }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+template <typename CellPointsT>
+void AverageArrays(vtkAlgorithm *self, const CellPointsT &cellPoints,
+  const std::vector<std::pair<vtkDataArray*, vtkDataArray*> > &pairs,
+  vtkDataSet *input, vtkIdType numCells)
+{
+  AverageCellPointsWorker<CellPointsT> worker;
+  worker.CellPoints = &cellPoints;
+  vtkNew<vtkIdList> cellPts;
+  std::vector<double> weights(input->GetMaxCellSize());
+  for (size_t i = 0; i < pairs.size() && !self->GetAbortExecute(); ++i)
+  {
+    self->UpdateProgress(static_cast<double>(i)/pairs.size());
+    vtkDataArray *inArray = pairs[i].first;
+    vtkDataArray *outArray = pairs[i].second;
+    outArray->SetNumberOfTuples(numCells);
+    if (vtkArrayDispatch::Dispatch2SameValueType::Execute(
+          inArray, outArray, worker))
+    {
+      continue;
+    }
+    // Arrays outside of the dispatch list go through the generic API.
+    for (vtkIdType cellId = 0; cellId < numCells; cellId++)
+    {
+      input->GetCellPoints(cellId, cellPts);
+      vtkIdType numPts = cellPts->GetNumberOfIds();
+      if (numPts > 0)
+      {
+        std::fill_n(weights.begin(), numPts, 1.0 / numPts);
+        outArray->InterpolateTuple(cellId, cellPts, inArray, &weights[0]);
+      }
+    }
+  }
+}
+
 }
 
 class vtkPointDataToCellData::Internals
@@ -308,49 +569,101 @@ int vtkPointDataToCellData::RequestData(
   // It's weird, but it works.
   outCD->InterpolateAllocate(inPD,numCells);
 
-  int abort=0;
-  vtkIdType progressInterval=numCells/20 + 1;
-  for (cellId=0; cellId < numCells && !abort; cellId++)
+  // When several threads are available, the cells average their point
+  // values in parallel, one array after the other. The points of structured
+  // cells are computed instead of being queried from the dataset.
+  std::vector<std::pair<vtkDataArray*, vtkDataArray*> > pairs;
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(input);
+  vtkPolyData *polyData = vtkPolyData::SafeDownCast(input);
+  int dims[3];
+  bool structured = true;
+  if (vtkImageData *image = vtkImageData::SafeDownCast(input))
   {
-    if ( !(cellId % progressInterval) )
-    {
-      this->UpdateProgress((double)cellId/numCells);
-      abort = GetAbortExecute();
-    }
-
-    input->GetCellPoints(cellId, cellPts);
-    numPts = cellPts->GetNumberOfIds();
-
-    if (numPts == 0)
+    image->GetDimensions(dims);
+  }
+  else if (vtkRectilinearGrid *rgrid = vtkRectilinearGrid::SafeDownCast(input))
+  {
+    rgrid->GetDimensions(dims);
+  }
+  else if (vtkStructuredGrid *sgrid = vtkStructuredGrid::SafeDownCast(input))
+  {
+    sgrid->GetDimensions(dims);
+  }
+  else
+  {
+    structured = false;
+  }
+  if (!this->CategoricalData &&
+      vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+      (grid || polyData || structured) &&
+      PairInterpolatedArrays(inPD, outCD, pairs))
+  {
+    if (structured)
     {
-      continue;
+      StructuredCellPoints cellPoints;
+      std::copy(dims, dims + 3, cellPoints.Dimensions);
+      cellPoints.DataDescription = vtkStructuredData::GetDataDescription(dims);
+      cellPoints.FaceOrder = vtkStructuredGrid::SafeDownCast(input) != nullptr;
+      AverageArrays(this, cellPoints, pairs, input, numCells);
     }
-
-    // If we aren't dealing with categorical data...
-    if (!(this->CategoricalData))
+    else
     {
-      // ...then we simply provide each point with an equal weight value and
-      // interpolate.
-      weight = 1.0 / numPts;
-      for (ptId=0; ptId < numPts; ptId++)
+      if (polyData && polyData->NeedToBuildCells())
       {
-        weights[ptId] = weight;
+        polyData->BuildCells();
       }
-      outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
+      UnstructuredCellPoints cellPoints;
+      cellPoints.Grid = grid;
+      cellPoints.PolyData = polyData;
+      AverageArrays(this, cellPoints, pairs, input, numCells);
     }
-    else
+  }
+  else
+  {
+    int abort=0;
+    vtkIdType progressInterval=numCells/20 + 1;
+    for (cellId=0; cellId < numCells && !abort; cellId++)
     {
-      // ...otherwise, we populate a histogram from the scalar values at each
-      // point, and then select the bin with the most elements.
-      hist.Reset(numPts);
-      for (ptId=0; ptId < numPts; ptId++)
+      if ( !(cellId % progressInterval) )
       {
-        pointId = cellPts->GetId(ptId);
-        hist.Fill(pointId,
-                  input->GetPointData()->GetScalars()->GetTuple1(pointId));
+        this->UpdateProgress((double)cellId/numCells);
+        abort = GetAbortExecute();
       }
 
-      outCD->CopyData(inPD, hist.IndexOfLargestBin(), cellId);
+      input->GetCellPoints(cellId, cellPts);
+      numPts = cellPts->GetNumberOfIds();
+
+      if (numPts == 0)
+      {
+        continue;
+      }
+
+      // If we aren't dealing with categorical data...
+      if (!(this->CategoricalData))
+      {
+        // ...then we simply provide each point with an equal weight value and
+        // interpolate.
+        weight = 1.0 / numPts;
+        for (ptId=0; ptId < numPts; ptId++)
+        {
+          weights[ptId] = weight;
+        }
+        outCD->InterpolatePoint(inPD, cellId, cellPts, weights);
+      }
+      else
+      {
+        // ...otherwise, we populate a histogram from the scalar values at each
+        // point, and then select the bin with the most elements.
+        hist.Reset(numPts);
+        for (ptId=0; ptId < numPts; ptId++)
+        {
+          pointId = cellPts->GetId(ptId);
+          hist.Fill(pointId,
+                    input->GetPointData()->GetScalars()->GetTuple1(pointId));
+        }
+
+        outCD->CopyData(inPD, hist.IndexOfLargestBin(), cellId);
+      }
     }
   }
 
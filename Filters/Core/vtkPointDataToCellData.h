@@ -24,6 +24,11 @@
  * processing to speed up processing. Optionally, the input point
  * data can be passed through to the output as well.
  *
+ * When vtkSMPTools provides several threads, the cells of unstructured
+ * grids, polydata and structured datasets average their point values in
+ * parallel (except for categorical data). The result is the same as with a
+ * single thread.
+ *
  * @warning
  * This filter is an abstract filter, that is, the output is an abstract type
  * (i.e., vtkDataSet). Use the convenience methods (e.g.,
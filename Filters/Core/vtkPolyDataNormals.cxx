@@ -14,8 +14,10 @@
 =========================================================================*/
 #include "vtkPolyDataNormals.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkFloatArray.h"
 #include "vtkMath.h"
 #include "vtkInformation.h"
@@ -24,13 +26,385 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkPolygon.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkTriangleStrip.h"
 #include "vtkPriorityQueue.h"
 
 #include "vtkNew.h"
 
+#include <algorithm>
+#include <vector>
+
 vtkStandardNewMacro(vtkPolyDataNormals);
 
+//----------------------------------------------------------------------------
+// Parallel execution. When more than one thread is available, the polygon
+// normals, the splitting of the points on feature edges and the
+// accumulation of the point normals are done with vtkSMPTools. Each step
+// gives the same result as its serial counterpart: the points are split in
+// two passes (regions, then renumbering) and the normals of the cells using
+// a point are summed in increasing cell order.
+namespace
+{
+
+// Compute the normal of each polygon.
+struct ComputePolyNormals
+{
+  vtkPoints *Points;
+  vtkCellArray *Polys;
+  float *Normals;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId) const
+  {
+    vtkIdType npts;
+    vtkIdType *pts;
+    double n[3];
+    for (; cellId < endCellId; ++cellId)
+    {
+      this->Polys->GetCellAtId(cellId, npts, pts);
+      vtkPolygon::ComputeNormal(this->Points, npts, pts, n);
+      float *normal = this->Normals + 3 * cellId;
+      normal[0] = static_cast<float>(n[0]);
+      normal[1] = static_cast<float>(n[1]);
+      normal[2] = static_cast<float>(n[2]);
+    }
+  }
+};
+
+// Label the regions of the cells around each point that are separated by
+// feature edges, as vtkPolyDataNormals::MarkAndSplit() does. The label of a
+// cell is stored in the slot of the point in the (unmodified) connectivity
+// of the cell, and each point needs NumberOfNewPoints[ptId] = regions - 1
+// duplicates. Edge neighbors are found by intersecting the sorted lists of
+// cells of the two points of the edge.
+struct MarkRegions
+{
+  vtkPolyData *Mesh;
+  const vtkIdType *Connectivity;
+  const float *PolyNormals;
+  double CosAngle;
+  int *Labels;
+  vtkIdType *NumberOfNewPoints;
+  vtkSMPThreadLocal<std::vector<int> > Regions;
+
+  MarkRegions(vtkPolyData *mesh, const float *polyNormals, double cosAngle,
+              int *labels, vtkIdType *numberOfNewPoints)
+    : Mesh(mesh), PolyNormals(polyNormals), CosAngle(cosAngle),
+      Labels(labels), NumberOfNewPoints(numberOfNewPoints)
+  {
+    this->Connectivity =
+      mesh->GetPolys()->GetConnectivityArray()->GetPointer(0);
+  }
+
+  static int IndexOf(const vtkIdType *cells, int ncells, vtkIdType cellId)
+  {
+    int i = 0;
+    while (cells[i] != cellId)
+    {
+      ++i;
+    }
+    return i;
+  }
+
+  // Same as vtkPolyData::GetCellEdgeNeighbors(), but only the number of
+  // neighbors and the first one are returned.
+  int GetEdgeNeighbor(vtkIdType cellId, const vtkIdType *cells, int ncells,
+                      vtkIdType nei, vtkIdType &neiCellId) const
+  {
+    unsigned short nNeiCells;
+    vtkIdType *neiCells;
+    this->Mesh->GetPointCells(nei, nNeiCells, neiCells);
+    int numNeighbors = 0;
+    for (int i = 0; i < ncells; ++i)
+    {
+      if (cells[i] != cellId &&
+          std::find(neiCells, neiCells + nNeiCells, cells[i]) !=
+            neiCells + nNeiCells)
+      {
+        if (numNeighbors++ == 0)
+        {
+          neiCellId = cells[i];
+        }
+      }
+    }
+    return numNeighbors;
+  }
+
+  // The two neighbors of ptId in a cell, in the order used by MarkAndSplit().
+  static void GetNeighbors(vtkIdType npts, const vtkIdType *pts,
+                           vtkIdType ptId, vtkIdType neiPt[2])
+  {
+    vtkIdType spot = std::find(pts, pts + npts, ptId) - pts;
+    if (spot == 0)
+    {
+      neiPt[0] = pts[spot + 1];
+      neiPt[1] = pts[npts - 1];
+    }
+    else if (spot == npts - 1)
+    {
+      neiPt[0] = pts[spot - 1];
+      neiPt[1] = pts[0];
+    }
+    else
+    {
+      neiPt[0] = pts[spot + 1];
+      neiPt[1] = pts[spot - 1];
+    }
+  }
+
+  double Dot(vtkIdType cellId, vtkIdType neiCellId) const
+  {
+    const float *n1 = this->PolyNormals + 3 * cellId;
+    const float *n2 = this->PolyNormals + 3 * neiCellId;
+    double thisNormal[3] = { n1[0], n1[1], n1[2] };
+    double neiNormal[3] = { n2[0], n2[1], n2[2] };
+    return vtkMath::Dot(thisNormal, neiNormal);
+  }
+
+  void Initialize()
+  {
+  }
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId)
+  {
+    std::vector<int> &regions = this->Regions.Local();
+    for (; ptId < endPtId; ++ptId)
+    {
+      this->NumberOfNewPoints[ptId] = 0;
+      unsigned short ncells;
+      vtkIdType *cells;
+      this->Mesh->GetPointCells(ptId, ncells, cells);
+      if (ncells <= 1)
+      {
+        continue;
+      }
+
+      // The region of a cell is kept at its first position in cells.
+      regions.assign(ncells, -1);
+      int numRegions = 0;
+      for (int j = 0; j < ncells; ++j)
+      {
+        int &seedRegion = regions[IndexOf(cells, ncells, cells[j])];
+        if (seedRegion >= 0)
+        {
+          continue;
+        }
+        seedRegion = numRegions;
+
+        vtkIdType npts;
+        vtkIdType *pts;
+        vtkIdType neiPt[2];
+        this->Mesh->GetCellPoints(cells[j], npts, pts);
+        GetNeighbors(npts, pts, ptId, neiPt);
+
+        for (int i = 0; i < 2; ++i)
+        {
+          vtkIdType cellId = cells[j];
+          vtkIdType nei = neiPt[i];
+          while (cellId >= 0)
+          {
+            vtkIdType neiCellId = -1;
+            if (this->GetEdgeNeighbor(cellId, cells, ncells, nei, neiCellId) == 1 &&
+                regions[IndexOf(cells, ncells, neiCellId)] < 0 &&
+                this->Dot(cellId, neiCellId) > this->CosAngle)
+            {
+              regions[IndexOf(cells, ncells, neiCellId)] = numRegions;
+              cellId = neiCellId;
+              this->Mesh->GetCellPoints(cellId, npts, pts);
+              vtkIdType next[2];
+              GetNeighbors(npts, pts, ptId, next);
+              nei = (next[0] != nei ? next[0] : next[1]);
+            }
+            else
+            {
+              cellId = -1;
+            }
+          }
+        }
+        ++numRegions;
+      }
+
+      if (numRegions > 1)
+      {
+        this->NumberOfNewPoints[ptId] = numRegions - 1;
+        for (int j = 0; j < ncells; ++j)
+        {
+          vtkIdType npts;
+          vtkIdType *pts;
+          this->Mesh->GetCellPoints(cells[j], npts, pts);
+          vtkIdType spot = std::find(pts, pts + npts, ptId) - pts;
+          this->Labels[pts + spot - this->Connectivity] =
+            regions[IndexOf(cells, ncells, cells[j])];
+        }
+      }
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+// Replace the points of the cells not in the first region around a point by
+// the duplicates of the point. The old mesh gives the labels of the points
+// of each cell, whose order may have been reversed in the new mesh.
+struct SplitCells
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const vtkIdType *Connectivity;
+  const int *Labels;
+  const vtkIdType *NumberOfNewPoints;
+  const vtkIdType *FirstNewPoint;
+
+  void operator()(vtkIdType cellId, vtkIdType endCellId) const
+  {
+    vtkIdType npts, numOldPts;
+    vtkIdType *pts, *oldPts;
+    for (; cellId < endCellId; ++cellId)
+    {
+      this->NewMesh->GetCellPoints(cellId, npts, pts);
+      this->OldMesh->GetCellPoints(cellId, numOldPts, oldPts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        vtkIdType ptId = pts[i];
+        if (this->NumberOfNewPoints[ptId] > 0)
+        {
+          vtkIdType spot = std::find(oldPts, oldPts + numOldPts, ptId) - oldPts;
+          int region = this->Labels[oldPts + spot - this->Connectivity];
+          if (region > 0)
+          {
+            pts[i] = this->FirstNewPoint[ptId] + region - 1;
+          }
+        }
+      }
+    }
+  }
+};
+
+// Record the point each output point comes from.
+struct MapNewPoints
+{
+  const vtkIdType *NumberOfNewPoints;
+  const vtkIdType *FirstNewPoint;
+  vtkIdType *Map;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId) const
+  {
+    for (; ptId < endPtId; ++ptId)
+    {
+      this->Map[ptId] = ptId;
+      for (vtkIdType i = 0; i < this->NumberOfNewPoints[ptId]; ++i)
+      {
+        this->Map[this->FirstNewPoint[ptId] + i] = ptId;
+      }
+    }
+  }
+};
+
+// Copy the coordinates of the points each output point comes from.
+template <typename InArrayT, typename OutArrayT>
+struct GatherPoints
+{
+  InArrayT *InPoints;
+  OutArrayT *OutPoints;
+  const vtkIdType *Map;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId) const
+  {
+    typedef typename vtkDataArrayAccessor<OutArrayT>::APIType OutValueType;
+    vtkDataArrayAccessor<InArrayT> inPts(this->InPoints);
+    vtkDataArrayAccessor<OutArrayT> outPts(this->OutPoints);
+    for (; ptId < endPtId; ++ptId)
+    {
+      for (int c = 0; c < 3; ++c)
+      {
+        outPts.Set(ptId, c, static_cast<OutValueType>(static_cast<double>(
+          inPts.Get(this->Map[ptId], c))));
+      }
+    }
+  }
+};
+
+struct GatherPointsWorker
+{
+  const vtkIdType *Map;
+
+  template <typename InArrayT, typename OutArrayT>
+  void operator()(InArrayT *inPts, OutArrayT *outPts)
+  {
+    GatherPoints<InArrayT, OutArrayT> functor = { inPts, outPts, this->Map };
+    vtkSMPTools::For(0, outPts->GetNumberOfTuples(), functor);
+  }
+};
+
+// Sum the normals of the cells using each output point, then normalize
+// them. The points coming from the same input point are processed by the
+// same task, going through the cells of the input point in increasing
+// order.
+struct AccumulatePointNormals
+{
+  vtkPolyData *OldMesh;
+  vtkPolyData *NewMesh;
+  const vtkIdType *Map;
+  const float *PolyNormals;
+  float *Normals;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId) const
+  {
+    unsigned short ncells;
+    vtkIdType *cells, npts, *pts;
+    for (; ptId < endPtId; ++ptId)
+    {
+      this->OldMesh->GetPointCells(ptId, ncells, cells);
+      for (int j = 0; j < ncells; ++j)
+      {
+        if (j > 0 && cells[j] == cells[j - 1])
+        {
+          continue;
+        }
+        const float *polyNormal = this->PolyNormals + 3 * cells[j];
+        this->NewMesh->GetCellPoints(cells[j], npts, pts);
+        for (vtkIdType i = 0; i < npts; ++i)
+        {
+          if ((this->Map ? this->Map[pts[i]] : pts[i]) == ptId)
+          {
+            float *normal = this->Normals + 3 * pts[i];
+            normal[0] += polyNormal[0];
+            normal[1] += polyNormal[1];
+            normal[2] += polyNormal[2];
+          }
+        }
+      }
+    }
+  }
+};
+
+struct NormalizePointNormals
+{
+  float *Normals;
+  double FlipDirection;
+
+  void operator()(vtkIdType ptId, vtkIdType endPtId) const
+  {
+    for (; ptId < endPtId; ++ptId)
+    {
+      float *n = this->Normals + 3 * ptId;
+      const double length =
+        sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]) * this->FlipDirection;
+      if (length != 0.0)
+      {
+        n[0] /= length;
+        n[1] /= length;
+        n[2] /= length;
+      }
+    }
+  }
+};
+
+}
+
 // Construct with feature angle=30, splitting and consistency turned on,
 // flipNormals turned off, and non-manifold traversal turned on.
 vtkPolyDataNormals::vtkPolyDataNormals()
@@ -95,6 +469,10 @@ int vtkPolyDataNormals::RequestData(
 
   vtkDebugMacro(<<"Generating surface normals");
 
+  // The polygon normals, the splitting and the point normals are computed
+  // in parallel when worthwhile; the consistency traversal is serial.
+  const bool parallel = vtkSMPTools::GetEstimatedNumberOfThreads() > 1;
+
   numPolys=input->GetNumberOfPolys();
   numStrips=input->GetNumberOfStrips();
   if ( (numPts=input->GetNumberOfPoints()) < 1 )
@@ -346,19 +724,29 @@ int vtkPolyDataNormals::RequestData(
   this->PolyNormals->SetName("Normals");
   this->PolyNormals->SetNumberOfTuples(numPolys);
 
-  for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
-       cellId++ )
+  if ( parallel )
+  {
+    ComputePolyNormals computeNormals =
+      { inPts, newPolys, this->PolyNormals->GetPointer(0) };
+    vtkSMPTools::For(0, numPolys, computeNormals);
+    this->UpdateProgress(0.666);
+  }
+  else
   {
-    if ((cellId % 1000) == 0)
+    for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts,pts);
+         cellId++ )
     {
-      this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
-      if (this->GetAbortExecute())
+      if ((cellId % 1000) == 0)
       {
-        break;
+        this->UpdateProgress (0.333 + 0.333 * (double) cellId / (double) numPolys);
+        if (this->GetAbortExecute())
+        {
+          break;
+        }
       }
+      vtkPolygon::ComputeNormal(inPts, npts, pts, n);
+      this->PolyNormals->SetTuple(cellId,n);
     }
-    vtkPolygon::ComputeNormal(inPts, npts, pts, n);
-    this->PolyNormals->SetTuple(cellId,n);
   }
 
   // Split mesh if sharp features
@@ -373,16 +761,47 @@ int vtkPolyDataNormals::RequestData(
     // to map new points into old points.
     //
     this->Map = vtkIdList::New();
-    this->Map->SetNumberOfIds(numPts);
-    for (vtkIdType i=0; i < numPts; i++)
+    if ( parallel )
     {
-      this->Map->SetId(i,i);
+      // Count the duplicates of each point, number them in the order of the
+      // serial splitting, then renumber the points of the cells.
+      vtkIdType connSize = this->OldMesh->GetPolys()->
+        GetConnectivityArray()->GetNumberOfValues();
+      std::vector<int> labels(connSize);
+      std::vector<vtkIdType> numberOfNewPoints(numPts);
+      std::vector<vtkIdType> firstNewPoint(numPts);
+      MarkRegions markRegions(this->OldMesh, this->PolyNormals->GetPointer(0),
+                              this->CosAngle, labels.data(),
+                              numberOfNewPoints.data());
+      vtkSMPTools::For(0, numPts, markRegions);
+      vtkSMPTools::ExclusiveScan(numberOfNewPoints.begin(),
+                                 numberOfNewPoints.end(),
+                                 firstNewPoint.begin(), numPts);
+
+      numNewPts = firstNewPoint[numPts-1] + numberOfNewPoints[numPts-1];
+      this->Map->SetNumberOfIds(numNewPts);
+      MapNewPoints mapNewPoints = { numberOfNewPoints.data(),
+                                    firstNewPoint.data(),
+                                    this->Map->GetPointer(0) };
+      vtkSMPTools::For(0, numPts, mapNewPoints);
+      SplitCells splitCells = { this->OldMesh, this->NewMesh,
+        this->OldMesh->GetPolys()->GetConnectivityArray()->GetPointer(0),
+        labels.data(), numberOfNewPoints.data(), firstNewPoint.data() };
+      vtkSMPTools::For(0, numPolys, splitCells);
     }
-
-    for (ptId=0; ptId < numPts; ptId++)
+    else
     {
-      this->MarkAndSplit(ptId);
-    }//for all input points
+      this->Map->SetNumberOfIds(numPts);
+      for (vtkIdType i=0; i < numPts; i++)
+      {
+        this->Map->SetId(i,i);
+      }
+
+      for (ptId=0; ptId < numPts; ptId++)
+      {
+        this->MarkAndSplit(ptId);
+      }//for all input points
+    }
 
     numNewPts = this->Map->GetNumberOfIds();
 
@@ -418,13 +837,23 @@ int vtkPolyDataNormals::RequestData(
     }
 
     newPts->SetNumberOfPoints(numNewPts);
-    for (ptId=0; ptId < numNewPts; ptId++)
+    GatherPointsWorker gatherPoints = { this->Map->GetPointer(0) };
+    typedef vtkArrayDispatch::Dispatch2ByValueType<
+      vtkArrayDispatch::Reals, vtkArrayDispatch::Reals> Dispatcher;
+    if ( parallel &&
+         Dispatcher::Execute(inPts->GetData(), newPts->GetData(), gatherPoints) )
     {
-      oldId = this->Map->GetId(ptId);
-      newPts->SetPoint(ptId,inPts->GetPoint(oldId));
-      outPD->CopyData(pd,oldId,ptId);
+      outPD->ParallelCopyData(pd, this->Map->GetPointer(0), numNewPts);
+    }
+    else
+    {
+      for (ptId=0; ptId < numNewPts; ptId++)
+      {
+        oldId = this->Map->GetId(ptId);
+        newPts->SetPoint(ptId,inPts->GetPoint(oldId));
+        outPD->CopyData(pd,oldId,ptId);
+      }
     }
-    this->Map->Delete();
   } //splitting
 
   else //no splitting, so no new points
@@ -459,7 +888,16 @@ int vtkPolyDataNormals::RequestData(
 
   float *fPolyNormals = this->PolyNormals->WritePointer(0, 3 * numPolys);
 
-  if (this->ComputePointNormals)
+  if (this->ComputePointNormals && parallel)
+  {
+    AccumulatePointNormals accumulate = { this->OldMesh, this->NewMesh,
+      this->Splitting ? this->Map->GetPointer(0) : nullptr,
+      fPolyNormals, fNormals };
+    vtkSMPTools::For(0, numPts, accumulate);
+    NormalizePointNormals normalize = { fNormals, flipDirection };
+    vtkSMPTools::For(0, numNewPts, normalize);
+  }
+  else if (this->ComputePointNormals)
   {
     for (cellId=0, newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);
          ++cellId)
@@ -487,6 +925,12 @@ int vtkPolyDataNormals::RequestData(
     }
   }
 
+  if ( this->Splitting )
+  {
+    this->Map->Delete();
+    this->Map = nullptr;
+  }
+
   //  Update ourselves.  If no new nodes have been created (i.e., no
   //  splitting), we can simply pass data through.
   //
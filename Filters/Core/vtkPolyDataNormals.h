@@ -39,6 +39,12 @@
  * are split and new points generated to prevent blurry edges (due to
  * Gouraud shading).
  *
+ * The polygon normals, the splitting of sharp edges and the averaging of
+ * the point normals are threaded with vtkSMPTools; the output is the same
+ * as the one of a serial execution. The traversal that makes the polygon
+ * ordering consistent is serial, so turning Consistency off when the input
+ * is known to be consistently ordered gives the best performance.
+ *
  * @warning
  * Normals are computed only for polygons and triangle strips. Normals are
  * not computed for lines or vertices.
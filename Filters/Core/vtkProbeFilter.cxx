@@ -25,11 +25,13 @@
 #include "vtkInformationVector.h"
 #include "vtkMath.h"
 #include "vtkObjectFactory.h"
+#include "vtkObjectPool.h"
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkSmartPointer.h"
 #include "vtkSMPTools.h"
 #include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
 #include "vtkStaticCellLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
@@ -67,6 +69,9 @@ vtkProbeFilter::vtkProbeFilter()
   this->PassFieldArrays = 1;
   this->Tolerance = 1.0;
   this->ComputeTolerance = 1;
+
+  this->NumberOfScratchCellAllocations = 0;
+  this->NumberOfScratchCellReuses = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -276,6 +281,9 @@ void vtkProbeFilter::InitializeForProbing(vtkDataSet* input,
 
   vtkIdType numPts = input->GetNumberOfPoints();
 
+  this->NumberOfScratchCellAllocations = 0;
+  this->NumberOfScratchCellReuses = 0;
+
   // if this is repeatedly called by the pipeline for a composite mesh,
   // you need a new array for each block
   // (that is you need to reinitialize the object)
@@ -601,70 +609,6 @@ void vtkProbeFilter::ProbeImagePointsInCell(vtkCell *cell, vtkIdType cellId,
   }
 }
 
-namespace {
-
-class CellStorage
-{
-public:
-  CellStorage()
-  {
-    this->Initialize();
-  }
-
-  ~CellStorage()
-  {
-    this->Clear();
-  }
-
-  // Copying does not make sense for this class but vtkSMPThreadLocal needs
-  // these functions to compile. Just initialize the object.
-  CellStorage(const CellStorage&)
-  {
-    this->Initialize();
-  }
-
-  CellStorage& operator=(const CellStorage&)
-  {
-    this->Clear();
-    this->Initialize();
-    return *this;
-  }
-
-  vtkCell* GetCell(vtkDataSet *dataset, vtkIdType cellId)
-  {
-    int celltype = dataset->GetCellType(cellId);
-    vtkGenericCell* &gc = this->Cells[celltype];
-    if (!gc)
-    {
-      gc = vtkGenericCell::New();
-    }
-    dataset->GetCell(cellId, gc);
-    return gc->GetRepresentativeCell();
-  }
-
-private:
-  void Initialize()
-  {
-    vtkGenericCell *null = nullptr;
-    std::fill(this->Cells, this->Cells + VTK_NUMBER_OF_CELL_TYPES, null);
-  }
-
-  void Clear()
-  {
-    for (int i = 0; i < VTK_NUMBER_OF_CELL_TYPES; ++i)
-    {
-      if (this->Cells[i])
-      {
-        this->Cells[i]->Delete();
-      }
-    }
-  }
-
-  vtkGenericCell *Cells[VTK_NUMBER_OF_CELL_TYPES];
-};
-
-} // anonymous namespace
-
 class vtkProbeFilter::ProbeImageDataWorklet
 {
 public:
@@ -694,13 +638,26 @@ public:
       weights = &dynamicweights[0];
     }
 
-    CellStorage &cs = this->Cells.Local();
+    vtkObjectPool<vtkGenericCell> *cells = this->Cells.Local();
     for (vtkIdType cellId = cellBegin; cellId < cellEnd; ++cellId)
     {
-      vtkCell *cell = cs.GetCell(this->Source, cellId);
-      this->ProbeFilter->ProbeImagePointsInCell(cell, cellId, this->Source,
-        this->SrcBlockId, this->Start, this->Spacing, this->Dim,
-        this->OutPointData, this->MaskArray, weights);
+      vtkGenericCell *cell = cells->Acquire();
+      this->Source->GetCell(cellId, cell);
+      this->ProbeFilter->ProbeImagePointsInCell(cell->GetRepresentativeCell(),
+        cellId, this->Source, this->SrcBlockId, this->Start, this->Spacing,
+        this->Dim, this->OutPointData, this->MaskArray, weights);
+      cells->ReleaseAll();
+    }
+  }
+
+  // Add the counters of the pools of all the threads to the filter's.
+  void AddPoolCounters()
+  {
+    for (auto cells : this->Cells)
+    {
+      this->ProbeFilter->NumberOfScratchCellAllocations +=
+        cells->GetNumberOfAllocations();
+      this->ProbeFilter->NumberOfScratchCellReuses += cells->GetNumberOfHits();
     }
   }
 
@@ -716,7 +673,7 @@ private:
   int MaxCellSize;
 
   vtkSMPThreadLocal<std::vector<double> > WeightsBuffer;
-  vtkSMPThreadLocal<CellStorage> Cells;
+  vtkSMPThreadLocalObject<vtkObjectPool<vtkGenericCell> > Cells;
 };
 
 //----------------------------------------------------------------------------
@@ -746,6 +703,7 @@ void vtkProbeFilter::ProbePointsImageData(vtkImageData *input,
   ProbeImageDataWorklet worklet(this, source, srcIdx, start, spacing, dim,
                                 outPD, maskArray, source->GetMaxCellSize());
   vtkSMPTools::For(0, numSrcCells, worklet);
+  worklet.AddPoolCounters();
 
   this->MaskPoints->Modified();
 }
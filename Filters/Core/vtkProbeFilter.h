@@ -181,6 +181,17 @@ public:
    vtkGetObjectMacro(CellLocatorPrototype, vtkAbstractCellLocator);
   //@}
 
+  //@{
+  /**
+   * Get the number of scratch cells created, respectively reused, by the
+   * threads probing image data points during the last execution. The cells
+   * are drawn from one vtkObjectPool per thread, so the number created does
+   * not grow with the number of source cells.
+   */
+  vtkGetMacro(NumberOfScratchCellAllocations, vtkIdType);
+  vtkGetMacro(NumberOfScratchCellReuses, vtkIdType);
+  //@}
+
 protected:
   vtkProbeFilter();
   ~vtkProbeFilter() override;
@@ -242,6 +253,9 @@ protected:
 
   vtkDataSetAttributes::FieldList* CellList;
   vtkDataSetAttributes::FieldList* PointList;
+
+  vtkIdType NumberOfScratchCellAllocations;
+  vtkIdType NumberOfScratchCellReuses;
 private:
   vtkProbeFilter(const vtkProbeFilter&) = delete;
   void operator=(const vtkProbeFilter&) = delete;
@@ -14,21 +14,454 @@
 =========================================================================*/
 #include "vtkThreshold.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCell.h"
+#include "vtkCellArray.h"
 #include "vtkCellData.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
+#include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
+#include "vtkUnsignedCharArray.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkMath.h"
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
 
 vtkStandardNewMacro(vtkThreshold);
 
+namespace
+{
+
+// The threshold criterion, evaluated without a call through a member
+// function pointer so that the compiler can inline it in the loops below.
+// Other functions, installed by subclasses, are called through the pointer.
+struct ThresholdCriterion
+{
+  enum FunctionType
+  {
+    LOWER,
+    UPPER,
+    BETWEEN,
+    CUSTOM
+  };
+  FunctionType Function;
+  double Lower;
+  double Upper;
+  vtkThreshold *Self;
+  int (vtkThreshold::*Custom)(double s);
+
+  int operator()(double s) const
+  {
+    switch (this->Function)
+    {
+      case LOWER:
+        return s <= this->Lower ? 1 : 0;
+      case UPPER:
+        return s >= this->Upper ? 1 : 0;
+      case CUSTOM:
+        return (this->Self->*this->Custom)(s);
+      default:
+        return s >= this->Lower ? (s <= this->Upper ? 1 : 0) : 0;
+    }
+  }
+};
+
+// The parameters of the cell classification.
+struct ThresholdParameters
+{
+  vtkDataSet *Input;
+  ThresholdCriterion Criterion;
+  bool UsePointScalars;
+  bool AllScalars;
+  bool UseContinuousCellRange;
+  bool Invert;
+  int ComponentMode;
+  int SelectedComponent;
+  // Output: the number of points of each kept cell, 0 for the other cells.
+  vtkIdType *CellSizes;
+};
+
+// The threshold parameters of a vtkThreshold, but the input and the cell
+// sizes which are left for the caller to set. custom is the
+// ThresholdFunction of self, called when function is CUSTOM.
+ThresholdParameters GetThresholdParameters(vtkThreshold *self, int function,
+  int (vtkThreshold::*custom)(double s))
+{
+  ThresholdParameters params;
+  params.Input = nullptr;
+  params.Criterion.Function =
+    static_cast<ThresholdCriterion::FunctionType>(function);
+  params.Criterion.Lower = self->GetLowerThreshold();
+  params.Criterion.Upper = self->GetUpperThreshold();
+  params.Criterion.Self = self;
+  params.Criterion.Custom = custom;
+  params.UsePointScalars = true;
+  params.AllScalars = self->GetAllScalars() != 0;
+  params.UseContinuousCellRange = self->GetUseContinuousCellRange() != 0;
+  params.Invert = self->GetInvert();
+  params.ComponentMode = self->GetComponentMode();
+  params.SelectedComponent = self->GetSelectedComponent();
+  params.CellSizes = nullptr;
+  return params;
+}
+
+// Evaluate the threshold criterion at a point or over a cell, with typed
+// access to the scalars.
+template <typename ArrayT>
+class ThresholdEvaluator
+{
+public:
+  ThresholdEvaluator(const ThresholdParameters &params, ArrayT *scalars)
+    : Params(params), Scalars(scalars)
+  {
+  }
+
+  int EvaluateComponents(vtkIdType id) const
+  {
+    vtkDataArrayAccessor<ArrayT> access(this->Scalars);
+    const int numComp = this->Scalars->GetNumberOfComponents();
+    int keepCell = 0;
+    int c;
+    switch (this->Params.ComponentMode)
+    {
+      case VTK_COMPONENT_MODE_USE_SELECTED:
+        c = (this->Params.SelectedComponent < numComp) ?
+          this->Params.SelectedComponent : 0;
+        keepCell = this->Params.Criterion(
+          static_cast<double>(access.Get(id, c)));
+        break;
+      case VTK_COMPONENT_MODE_USE_ANY:
+        keepCell = 0;
+        for (c = 0; (!keepCell) && (c < numComp); c++)
+        {
+          keepCell = this->Params.Criterion(
+            static_cast<double>(access.Get(id, c)));
+        }
+        break;
+      case VTK_COMPONENT_MODE_USE_ALL:
+        keepCell = 1;
+        for (c = 0; keepCell && (c < numComp); c++)
+        {
+          keepCell = this->Params.Criterion(
+            static_cast<double>(access.Get(id, c)));
+        }
+        break;
+    }
+    return keepCell;
+  }
+
+  int EvaluateCell(int c, vtkIdList *cellPts, vtkIdType numCellPts) const
+  {
+    vtkDataArrayAccessor<ArrayT> access(this->Scalars);
+    double minScalar = DBL_MAX, maxScalar = DBL_MIN;
+    for (vtkIdType i = 0; i < numCellPts; i++)
+    {
+      double s = static_cast<double>(access.Get(cellPts->GetId(i), c));
+      minScalar = std::min(s, minScalar);
+      maxScalar = std::max(s, maxScalar);
+    }
+    return !(this->Params.Criterion.Lower > maxScalar ||
+             this->Params.Criterion.Upper < minScalar);
+  }
+
+  int EvaluateCell(vtkIdList *cellPts, vtkIdType numCellPts) const
+  {
+    const int numComp = this->Scalars->GetNumberOfComponents();
+    int keepCell = 0;
+    int c;
+    switch (this->Params.ComponentMode)
+    {
+      case VTK_COMPONENT_MODE_USE_SELECTED:
+        c = (this->Params.SelectedComponent < numComp) ?
+          this->Params.SelectedComponent : 0;
+        keepCell = this->EvaluateCell(c, cellPts, numCellPts);
+        break;
+      case VTK_COMPONENT_MODE_USE_ANY:
+        keepCell = 0;
+        for (c = 0; (!keepCell) && (c < numComp); c++)
+        {
+          keepCell = this->EvaluateCell(c, cellPts, numCellPts);
+        }
+        break;
+      case VTK_COMPONENT_MODE_USE_ALL:
+        keepCell = 1;
+        for (c = 0; keepCell && (c < numComp); c++)
+        {
+          keepCell = this->EvaluateCell(c, cellPts, numCellPts);
+        }
+        break;
+    }
+    return keepCell;
+  }
+
+private:
+  const ThresholdParameters &Params;
+  ArrayT *Scalars;
+};
+
+// Decide which cells are kept.
+template <typename ArrayT>
+class ThresholdClassifier
+{
+public:
+  ThresholdClassifier(const ThresholdParameters &params, ArrayT *scalars)
+    : Params(params), Evaluator(params, scalars)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    vtkDataSet *input = this->Params.Input;
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      this->Params.CellSizes[cellId] = 0;
+      if (input->GetCellType(cellId) == VTK_EMPTY_CELL)
+      {
+        continue;
+      }
+      input->GetCellPoints(cellId, cellPts);
+      const vtkIdType numCellPts = cellPts->GetNumberOfIds();
+      int keepCell;
+      if (this->Params.UsePointScalars)
+      {
+        if (this->Params.AllScalars)
+        {
+          keepCell = 1;
+          for (vtkIdType i = 0; keepCell && (i < numCellPts); i++)
+          {
+            keepCell = this->Evaluator.EvaluateComponents(cellPts->GetId(i));
+          }
+        }
+        else if (!this->Params.UseContinuousCellRange)
+        {
+          keepCell = 0;
+          for (vtkIdType i = 0; (!keepCell) && (i < numCellPts); i++)
+          {
+            keepCell = this->Evaluator.EvaluateComponents(cellPts->GetId(i));
+          }
+        }
+        else
+        {
+          keepCell = this->Evaluator.EvaluateCell(cellPts, numCellPts);
+        }
+      }
+      else
+      {
+        keepCell = this->Evaluator.EvaluateComponents(cellId);
+      }
+
+      if (this->Params.Invert ? !keepCell : keepCell)
+      {
+        this->Params.CellSizes[cellId] = numCellPts;
+      }
+    }
+  }
+
+private:
+  const ThresholdParameters &Params;
+  ThresholdEvaluator<ArrayT> Evaluator;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+};
+
+struct ThresholdClassifyWorker
+{
+  const ThresholdParameters *Params;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *scalars)
+  {
+    ThresholdClassifier<ArrayT> classifier(*this->Params, scalars);
+    vtkSMPTools::For(0, this->Params->Input->GetNumberOfCells(), classifier);
+  }
+};
+
+// Write the input point ids of the kept cells into the output connectivity
+// and record, for each point, the position of its first occurrence in it.
+// The output points are numbered in that order, which is the order in which
+// a serial traversal of the cells meets them.
+struct ThresholdGatherCells
+{
+  vtkDataSet *Input;
+  const vtkIdType *CellSizes;
+  const vtkIdType *CellOffsets;
+  const vtkIdType *NewCellIds;
+  vtkIdType *Connectivity;
+  vtkIdType *Offsets;
+  vtkIdType *Locations;
+  unsigned char *Types;
+  vtkIdType *OldCellIds;
+  std::atomic<vtkIdType> *FirstUse;
+  vtkSMPThreadLocalObject<vtkIdList> CellPts;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkIdList *cellPts = this->CellPts.Local();
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      if (this->CellSizes[cellId] == 0)
+      {
+        continue;
+      }
+      const vtkIdType newCellId = this->NewCellIds[cellId];
+      const vtkIdType offset = this->CellOffsets[cellId];
+      this->Offsets[newCellId] = offset;
+      this->Locations[newCellId] = offset + newCellId;
+      this->Types[newCellId] =
+        static_cast<unsigned char>(this->Input->GetCellType(cellId));
+      this->OldCellIds[newCellId] = cellId;
+      this->Input->GetCellPoints(cellId, cellPts);
+      for (vtkIdType i = 0; i < cellPts->GetNumberOfIds(); ++i)
+      {
+        const vtkIdType ptId = cellPts->GetId(i);
+        const vtkIdType position = offset + i;
+        this->Connectivity[position] = ptId;
+        vtkIdType first = this->FirstUse[ptId].load(std::memory_order_relaxed);
+        while (position < first &&
+               !this->FirstUse[ptId].compare_exchange_weak(
+                 first, position, std::memory_order_relaxed))
+        {
+        }
+      }
+    }
+  }
+};
+
+// 1 for the kept cells, whose size is not 0.
+struct ThresholdIsKept
+{
+  vtkIdType operator()(vtkIdType size) const { return size > 0 ? 1 : 0; }
+};
+
+// Flag the positions of the connectivity where a point is used first.
+struct ThresholdMarkFirstUses
+{
+  const vtkIdType *Connectivity;
+  const std::atomic<vtkIdType> *FirstUse;
+  vtkIdType *IsFirstUse;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType position = begin; position < end; ++position)
+    {
+      this->IsFirstUse[position] =
+        this->FirstUse[this->Connectivity[position]] == position ? 1 : 0;
+    }
+  }
+};
+
+// Build the map from input to output point ids, and its inverse.
+struct ThresholdMapPoints
+{
+  const std::atomic<vtkIdType> *FirstUse;
+  const vtkIdType *NewPointIds;
+  vtkIdType *PointMap;
+  vtkIdType *OldPointIds;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      vtkIdType first = this->FirstUse[ptId];
+      if (first == VTK_ID_MAX)
+      {
+        this->PointMap[ptId] = -1;
+      }
+      else
+      {
+        vtkIdType newId = this->NewPointIds[first];
+        this->PointMap[ptId] = newId;
+        this->OldPointIds[newId] = ptId;
+      }
+    }
+  }
+};
+
+// Replace the input point ids of the connectivity with the output ones.
+struct ThresholdRenumberPoints
+{
+  const vtkIdType *PointMap;
+  vtkIdType *Connectivity;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType position = begin; position < end; ++position)
+    {
+      this->Connectivity[position] = this->PointMap[this->Connectivity[position]];
+    }
+  }
+};
+
+// Copy the coordinates of the points OldPointIds[i] to the points i.
+template <typename InArrayT, typename OutArrayT>
+struct ThresholdGatherPoints
+{
+  InArrayT *In;
+  OutArrayT *Out;
+  const vtkIdType *OldPointIds;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkDataArrayAccessor<InArrayT> in(this->In);
+    vtkDataArrayAccessor<OutArrayT> out(this->Out);
+    typedef typename vtkDataArrayAccessor<OutArrayT>::APIType OutType;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType ptId = this->OldPointIds[i];
+      for (int c = 0; c < 3; ++c)
+      {
+        out.Set(i, c, static_cast<OutType>(in.Get(ptId, c)));
+      }
+    }
+  }
+};
+
+struct ThresholdGatherPointsWorker
+{
+  const vtkIdType *OldPointIds;
+  vtkIdType NumberOfPoints;
+
+  template <typename InArrayT, typename OutArrayT>
+  void operator()(InArrayT *in, OutArrayT *out)
+  {
+    ThresholdGatherPoints<InArrayT, OutArrayT> functor =
+      { in, out, this->OldPointIds };
+    vtkSMPTools::For(0, this->NumberOfPoints, functor);
+  }
+};
+
+// Same for datasets without explicit points. GetPoint() is thread safe once
+// it has been called from a single thread.
+struct ThresholdGatherImplicitPoints
+{
+  vtkDataSet *Input;
+  vtkPoints *Points;
+  const vtkIdType *OldPointIds;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    double x[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Input->GetPoint(this->OldPointIds[i], x);
+      this->Points->SetPoint(i, x);
+    }
+  }
+};
+
+}
+
 // Construct with lower threshold=0, upper threshold=1, and threshold
 // function=upper AllScalars=1.
 vtkThreshold::vtkThreshold()
@@ -104,17 +537,10 @@ int vtkThreshold::RequestData(
   vtkUnstructuredGrid *output = vtkUnstructuredGrid::SafeDownCast(
     outInfo->Get(vtkDataObject::DATA_OBJECT()));
 
-  vtkIdType cellId, newCellId;
-  vtkIdList *cellPts, *pointMap;
-  vtkIdList *newCellPts;
-  vtkCell *cell;
+  vtkIdType cellId, numPts, numCells;
   vtkPoints *newPoints;
-  vtkIdType i, ptId, newId, numPts;
-  int numCellPts;
-  double x[3];
   vtkPointData *pd=input->GetPointData(), *outPD=output->GetPointData();
   vtkCellData *cd=input->GetCellData(), *outCD=output->GetCellData();
-  int keepCell;
 
   vtkDebugMacro(<< "Executing threshold filter");
 
@@ -132,20 +558,15 @@ int vtkThreshold::RequestData(
     return 1;
   }
 
-  outPD->CopyGlobalIdsOn();
-  outPD->CopyAllocate(pd);
-  outCD->CopyGlobalIdsOn();
-  outCD->CopyAllocate(cd);
-
   numPts = input->GetNumberOfPoints();
-  output->Allocate(input->GetNumberOfCells());
+  numCells = input->GetNumberOfCells();
 
   newPoints = vtkPoints::New();
 
   // set precision for the points in the output
+  vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
   if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
   {
-    vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
     if(inputPointSet && inputPointSet->GetPoints())
     {
       newPoints->SetDataType(inputPointSet->GetPoints()->GetDataType());
@@ -164,102 +585,186 @@ int vtkThreshold::RequestData(
     newPoints->SetDataType(VTK_DOUBLE);
   }
 
-  newPoints->Allocate(numPts);
-
-  pointMap = vtkIdList::New(); //maps old point ids into new
-  pointMap->SetNumberOfIds(numPts);
-  for (i=0; i < numPts; i++)
+  // The cell queries of these datasets are thread safe once they have been
+  // called from a single thread. Other datasets, and the criteria installed
+  // by subclasses, are processed serially.
+  int dataType = input->GetDataObjectType();
+  bool parallel = dataType == VTK_POLY_DATA ||
+    dataType == VTK_UNSTRUCTURED_GRID || dataType == VTK_IMAGE_DATA ||
+    dataType == VTK_STRUCTURED_POINTS || dataType == VTK_UNIFORM_GRID ||
+    dataType == VTK_RECTILINEAR_GRID || dataType == VTK_STRUCTURED_GRID;
+  if (numCells > 0)
   {
-    pointMap->SetId(i,-1);
+    vtkNew<vtkIdList> cellPts;
+    double x[3];
+    input->GetCellType(0);
+    input->GetCellPoints(0, cellPts);
+    input->GetPoint(0, x);
   }
 
-  newCellPts = vtkIdList::New();
-
-  // are we using pointScalars?
-  int fieldAssociation = this->GetInputArrayAssociation(0, inputVector);
-  bool usePointScalars = fieldAssociation == vtkDataObject::FIELD_ASSOCIATION_POINTS;
+  // Check that the scalars of each cell satisfy the threshold criterion.
+  // The number of points of the kept cells is recorded.
+  std::vector<vtkIdType> cellSizes(numCells + 1, 0);
+  ThresholdParameters params =
+    GetThresholdParameters(this, this->GetCriterionFunction(),
+                           this->ThresholdFunction);
+  params.Input = input;
+  params.UsePointScalars = this->GetInputArrayAssociation(0, inputVector) ==
+    vtkDataObject::FIELD_ASSOCIATION_POINTS;
+  params.CellSizes = cellSizes.data();
+  if (parallel && params.Criterion.Function != ThresholdCriterion::CUSTOM)
+  {
+    ThresholdClassifyWorker worker = { &params };
+    if (!vtkArrayDispatch::Dispatch::Execute(inScalars, worker))
+    {
+      worker(inScalars);
+    }
+  }
+  else
+  {
+    ThresholdClassifier<vtkDataArray> classifier(params, inScalars);
+    classifier(0, numCells);
+  }
 
-  // Check that the scalars of each cell satisfy the threshold criterion
-  for (cellId=0; cellId < input->GetNumberOfCells(); cellId++)
+  // Compact the kept cells: prefix sums give the id of each kept cell in
+  // the output and the position of its points in the output connectivity.
+  std::vector<vtkIdType> newCellIds(numCells + 1);
+  vtkSMPTools::Transform(cellSizes.begin(), cellSizes.end(),
+                         newCellIds.begin(), ThresholdIsKept());
+  vtkSMPTools::ExclusiveScan(newCellIds.begin(), newCellIds.end(),
+                             newCellIds.begin(), vtkIdType(0));
+  std::vector<vtkIdType> cellOffsets(numCells + 1);
+  vtkSMPTools::ExclusiveScan(cellSizes.begin(), cellSizes.end(),
+                             cellOffsets.begin(), vtkIdType(0));
+  const vtkIdType numNewCells = newCellIds[numCells];
+  const vtkIdType connectivitySize = cellOffsets[numCells];
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numNewCells + 1);
+  offsets->SetValue(numNewCells, connectivitySize);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(connectivitySize);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->SetNumberOfValues(numNewCells);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numNewCells);
+  std::vector<vtkIdType> oldCellIds(numNewCells);
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUse(
+    new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::Fill(firstUse.get(), firstUse.get() + numPts, VTK_ID_MAX);
+
+  ThresholdGatherCells gatherCells;
+  gatherCells.Input = input;
+  gatherCells.CellSizes = cellSizes.data();
+  gatherCells.CellOffsets = cellOffsets.data();
+  gatherCells.NewCellIds = newCellIds.data();
+  gatherCells.Connectivity = connectivity->GetPointer(0);
+  gatherCells.Offsets = offsets->GetPointer(0);
+  gatherCells.Locations = locations->GetPointer(0);
+  gatherCells.Types = types->GetPointer(0);
+  gatherCells.OldCellIds = oldCellIds.data();
+  gatherCells.FirstUse = firstUse.get();
+  if (parallel)
   {
-    cell = input->GetCell(cellId);
-    cellPts = cell->GetPointIds();
-    numCellPts = cell->GetNumberOfPoints();
+    vtkSMPTools::For(0, numCells, gatherCells);
+  }
+  else
+  {
+    gatherCells(0, numCells);
+  }
 
-    if ( usePointScalars )
+  // Number the points in the order of their first use.
+  std::vector<vtkIdType> newPointIds(connectivitySize + 1);
+  ThresholdMarkFirstUses mark =
+    { connectivity->GetPointer(0), firstUse.get(), newPointIds.data() };
+  vtkSMPTools::For(0, connectivitySize, mark);
+  newPointIds[connectivitySize] = 0;
+  vtkSMPTools::ExclusiveScan(newPointIds.begin(), newPointIds.end(),
+                             newPointIds.begin(), vtkIdType(0));
+  const vtkIdType numNewPts = newPointIds[connectivitySize];
+  std::vector<vtkIdType> pointMap(numPts); //maps old point ids into new
+  std::vector<vtkIdType> oldPointIds(numNewPts);
+  ThresholdMapPoints mapPoints = { firstUse.get(), newPointIds.data(),
+                                   pointMap.data(), oldPointIds.data() };
+  vtkSMPTools::For(0, numPts, mapPoints);
+  firstUse.reset();
+  ThresholdRenumberPoints renumber =
+    { pointMap.data(), connectivity->GetPointer(0) };
+  vtkSMPTools::For(0, connectivitySize, renumber);
+
+  // Polyhedra need their face stream: build the cells serially if there is
+  // any. Otherwise the arrays are used as they are.
+  vtkUnstructuredGrid *inputGrid = vtkUnstructuredGrid::SafeDownCast(input);
+  bool hasPolyhedra = false;
+  if (inputGrid && inputGrid->GetFaces())
+  {
+    for (cellId = 0; cellId < numNewCells && !hasPolyhedra; cellId++)
+    {
+      hasPolyhedra = types->GetValue(cellId) == VTK_POLYHEDRON;
+    }
+  }
+  if (hasPolyhedra)
+  {
+    vtkNew<vtkIdList> newCellPts;
+    output->Allocate(numNewCells);
+    for (cellId = 0; cellId < numNewCells; cellId++)
     {
-      if (this->AllScalars)
+      int cellType = types->GetValue(cellId);
+      if (cellType == VTK_POLYHEDRON)
       {
-        keepCell = 1;
-        for ( i=0; keepCell && (i < numCellPts); i++)
-        {
-          ptId = cellPts->GetId(i);
-          keepCell = this->EvaluateComponents( inScalars, ptId );
-        }
+        inputGrid->GetFaceStream(oldCellIds[cellId], newCellPts);
+        vtkUnstructuredGrid::ConvertFaceStreamPointIds(
+          newCellPts, pointMap.data());
+        output->InsertNextCell(cellType, newCellPts);
       }
       else
       {
-        if(!this->UseContinuousCellRange)
-        {
-          keepCell = 0;
-          for ( i=0; (!keepCell) && (i < numCellPts); i++)
-          {
-            ptId = cellPts->GetId(i);
-            keepCell = this->EvaluateComponents( inScalars, ptId );
-          }
-        }
-        else
-        {
-          keepCell = this->EvaluateCell(inScalars, cellPts, numCellPts);
-        }
+        vtkIdType offset = offsets->GetValue(cellId);
+        output->InsertNextCell(cellType,
+          offsets->GetValue(cellId + 1) - offset,
+          connectivity->GetPointer(offset));
       }
     }
-    else //use cell scalars
+  }
+  else
+  {
+    vtkNew<vtkCellArray> cells;
+    cells->SetData(offsets, connectivity);
+    output->SetCells(types, locations, cells, nullptr, nullptr);
+  }
+
+  // Copy the points and the attributes of the kept points and cells.
+  newPoints->SetNumberOfPoints(numNewPts);
+  ThresholdGatherPointsWorker gatherPoints = { oldPointIds.data(), numNewPts };
+  typedef vtkArrayDispatch::Dispatch2ByValueType<vtkArrayDispatch::Reals,
+    vtkArrayDispatch::Reals> PointsDispatcher;
+  if (!parallel || !inputPointSet || !inputPointSet->GetPoints() ||
+      !PointsDispatcher::Execute(inputPointSet->GetPoints()->GetData(),
+                                 newPoints->GetData(), gatherPoints))
+  {
+    ThresholdGatherImplicitPoints gatherImplicit =
+      { input, newPoints, oldPointIds.data() };
+    if (parallel)
     {
-      keepCell = this->EvaluateComponents( inScalars, cellId );
+      vtkSMPTools::For(0, numNewPts, gatherImplicit);
     }
-
-    // Invert the keep flag if the Invert option is enabled.
-    keepCell = this->Invert ? (1 - keepCell) : keepCell;
-
-    if (  numCellPts > 0 && keepCell)
+    else
     {
-      // satisfied thresholding (also non-empty cell, i.e. not VTK_EMPTY_CELL)
-      for (i=0; i < numCellPts; i++)
-      {
-        ptId = cellPts->GetId(i);
-        if ( (newId = pointMap->GetId(ptId)) < 0 )
-        {
-          input->GetPoint(ptId, x);
-          newId = newPoints->InsertNextPoint(x);
-          pointMap->SetId(ptId,newId);
-          outPD->CopyData(pd,ptId,newId);
-        }
-        newCellPts->InsertId(i,newId);
-      }
-      // special handling for polyhedron cells
-      if (vtkUnstructuredGrid::SafeDownCast(input) &&
-          input->GetCellType(cellId) == VTK_POLYHEDRON)
-      {
-        newCellPts->Reset();
-        vtkUnstructuredGrid::SafeDownCast(input)->
-          GetFaceStream(cellId, newCellPts);
-        vtkUnstructuredGrid::ConvertFaceStreamPointIds(
-          newCellPts, pointMap->GetPointer(0));
-      }
-      newCellId = output->InsertNextCell(cell->GetCellType(),newCellPts);
-      outCD->CopyData(cd,cellId,newCellId);
-      newCellPts->Reset();
-    } // satisfied thresholding
-  } // for all cells
+      gatherImplicit(0, numNewPts);
+    }
+  }
+
+  outPD->CopyGlobalIdsOn();
+  outPD->CopyAllocate(pd, numNewPts);
+  outPD->ParallelCopyData(pd, oldPointIds.data(), numNewPts);
+  outCD->CopyGlobalIdsOn();
+  outCD->CopyAllocate(cd, numNewCells);
+  outCD->ParallelCopyData(cd, oldCellIds.data(), numNewCells);
 
   vtkDebugMacro(<< "Extracted " << output->GetNumberOfCells()
                 << " number of cells.");
 
   // now clean up / update ourselves
-  pointMap->Delete();
-  newCellPts->Delete();
-
   output->SetPoints(newPoints);
   newPoints->Delete();
 
@@ -268,84 +773,43 @@ int vtkThreshold::RequestData(
   return 1;
 }
 
+int vtkThreshold::GetCriterionFunction()
+{
+  return this->ThresholdFunction == &vtkThreshold::Lower ?
+      ThresholdCriterion::LOWER :
+    this->ThresholdFunction == &vtkThreshold::Upper ?
+      ThresholdCriterion::UPPER :
+    this->ThresholdFunction == &vtkThreshold::Between ?
+      ThresholdCriterion::BETWEEN : ThresholdCriterion::CUSTOM;
+}
+
 int vtkThreshold::EvaluateCell( vtkDataArray *scalars,vtkIdList* cellPts, int numCellPts )
 {
-  int c(0);
-  int numComp = scalars->GetNumberOfComponents();
-  int keepCell(0);
-  switch (this->ComponentMode)
-  {
-    case VTK_COMPONENT_MODE_USE_SELECTED:
-      c  =   (this->SelectedComponent < numComp)?(this->SelectedComponent):(0);
-      keepCell = EvaluateCell(scalars,c,cellPts,numCellPts);
-      break;
-    case VTK_COMPONENT_MODE_USE_ANY:
-      keepCell = 0;
-      for ( c = 0; (!keepCell) && (c < numComp); c++ )
-      {
-        keepCell =EvaluateCell(scalars,c,cellPts,numCellPts);
-      }
-      break;
-    case VTK_COMPONENT_MODE_USE_ALL:
-      keepCell = 1;
-      for ( c = 0; keepCell && (c < numComp); c++ )
-      {
-        keepCell =EvaluateCell(scalars,c,cellPts,numCellPts);
-      }
-      break;
-  }
-  return keepCell;
+  ThresholdParameters params =
+    GetThresholdParameters(this, this->GetCriterionFunction(),
+                           this->ThresholdFunction);
+  return ThresholdEvaluator<vtkDataArray>(params, scalars).EvaluateCell(
+    cellPts, numCellPts);
 }
 
 int vtkThreshold::EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts )
 {
-  double minScalar=DBL_MAX, maxScalar=DBL_MIN;
-  for (int i=0; i < numCellPts; i++)
-  {
-    vtkIdType ptId = cellPts->GetId(i);
-    double s = scalars->GetComponent(ptId,c);
-    minScalar = std::min(s,minScalar);
-    maxScalar = std::max(s,maxScalar);
-  }
-
-  int keepCell =  !(this->LowerThreshold > maxScalar || this->UpperThreshold < minScalar);
-  return keepCell;
+  ThresholdParameters params =
+    GetThresholdParameters(this, this->GetCriterionFunction(),
+                           this->ThresholdFunction);
+  return ThresholdEvaluator<vtkDataArray>(params, scalars).EvaluateCell(
+    c, cellPts, numCellPts);
 }
 
 int vtkThreshold::EvaluateComponents( vtkDataArray *scalars, vtkIdType id )
 {
-  int keepCell = 0;
-  int numComp = scalars->GetNumberOfComponents();
-  int c;
-
-  switch ( this->ComponentMode )
-  {
-    case VTK_COMPONENT_MODE_USE_SELECTED:
-      c = (this->SelectedComponent < numComp)?(this->SelectedComponent):(0);
-      keepCell =
-        (this->*(this->ThresholdFunction))(scalars->GetComponent(id,c));
-      break;
-    case VTK_COMPONENT_MODE_USE_ANY:
-      keepCell = 0;
-      for ( c = 0; (!keepCell) && (c < numComp); c++ )
-      {
-        keepCell =
-          (this->*(this->ThresholdFunction))(scalars->GetComponent(id,c));
-      }
-      break;
-    case VTK_COMPONENT_MODE_USE_ALL:
-      keepCell = 1;
-      for ( c = 0; keepCell && (c < numComp); c++ )
-      {
-        keepCell =
-          (this->*(this->ThresholdFunction))(scalars->GetComponent(id,c));
-      }
-      break;
-  }
-  return keepCell;
+  ThresholdParameters params =
+    GetThresholdParameters(this, this->GetCriterionFunction(),
+                           this->ThresholdFunction);
+  return ThresholdEvaluator<vtkDataArray>(params, scalars).EvaluateComponents(
+    id);
 }
 
-
 // Return the method for manipulating scalar data as a string.
 const char *vtkThreshold::GetAttributeModeAsString()
 {
@@ -30,6 +30,11 @@
  * By default only the first scalar value is used in the decision. Use the ComponentMode
  * and SelectedComponent ivars to control this behavior.
  *
+ * The cells are classified and the output is assembled in parallel with
+ * vtkSMPTools for polygonal data, unstructured grids and structured
+ * datasets. The output (order of the cells, numbering of the points) is the
+ * same as the one of a serial traversal of the input cells.
+ *
  * @sa
  * vtkThresholdPoints vtkThresholdTextureCoords
 */
@@ -225,6 +230,11 @@ protected:
   int EvaluateCell( vtkDataArray *scalars, vtkIdList* cellPts, int numCellPts );
   int EvaluateCell( vtkDataArray *scalars, int c, vtkIdList* cellPts, int numCellPts );
 private:
+  // The ThresholdFunction, as a value understood by the cell
+  // classification in vtkThreshold.cxx. Functions other than Lower, Upper
+  // and Between are called through the pointer.
+  int GetCriterionFunction();
+
   vtkThreshold(const vtkThreshold&) = delete;
   void operator=(const vtkThreshold&) = delete;
 };
@@ -0,0 +1,170 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestStreamTracerThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkStreamTracer produces the same streamlines with one and with
+// several threads, for the default interpolator and for a cell locator
+// interpolator sharing a vtkStaticCellLocator.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkCellLocatorInterpolatedVelocityField.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkRungeKutta45.h"
+#include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
+#include "vtkStreamTracer.h"
+#include "vtkTestArrays.h"
+#include "vtkTestSMP.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+
+bool SameStreamlines(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfLines() != b->GetNumberOfLines())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+    {
+      return false;
+    }
+  }
+  vtkIdType aNpts, bNpts;
+  vtkIdType *aPts, *bPts;
+  vtkCellArray *aLines = a->GetLines();
+  vtkCellArray *bLines = b->GetLines();
+  aLines->InitTraversal();
+  bLines->InitTraversal();
+  while (aLines->GetNextCell(aNpts, aPts))
+  {
+    if (!bLines->GetNextCell(bNpts, bPts) || aNpts != bNpts)
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < aNpts; ++i)
+    {
+      if (aPts[i] != bPts[i])
+      {
+        return false;
+      }
+    }
+  }
+  return vtkTest::SameArrays(a->GetPointData(), b->GetPointData()) &&
+    vtkTest::SameArrays(a->GetCellData(), b->GetCellData());
+}
+
+}
+
+int TestStreamTracerThreads(int, char *[])
+{
+  // A swirling flow on an image and on its tetrahedralization.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(16, 16, 16);
+  image->SetOrigin(-1.0, -1.0, -1.0);
+  image->SetSpacing(2.0 / 15, 2.0 / 15, 2.0 / 15);
+  vtkNew<vtkDoubleArray> velocity;
+  velocity->SetName("velocity");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(image->GetNumberOfPoints());
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    image->GetPoint(i, x);
+    velocity->SetTuple3(i, -x[1] + 0.1 * x[2], x[0], 0.2 + 0.3 * x[0] * x[1]);
+    scalars->SetValue(i, x[0] * x[0] + x[2]);
+  }
+  image->GetPointData()->SetVectors(velocity);
+  image->GetPointData()->SetScalars(scalars);
+
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputData(image);
+  tetrahedralize->Update();
+
+  // Seeds on a slanted grid, some of them outside of the domain.
+  vtkNew<vtkPoints> seedPoints;
+  for (int i = 0; i < 12; ++i)
+  {
+    for (int j = 0; j < 12; ++j)
+    {
+      seedPoints->InsertNextPoint(
+        -1.1 + 0.19 * i, -1.1 + 0.19 * j, -0.9 + 0.07 * (i + j));
+    }
+  }
+  vtkNew<vtkPolyData> seeds;
+  seeds->SetPoints(seedPoints);
+
+  for (int config = 0; config < 3; ++config)
+  {
+    vtkSmartPointer<vtkPolyData> outputs[2];
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+      vtkNew<vtkStreamTracer> tracer;
+      if (config == 0)
+      {
+        tracer->SetInputData(image);
+      }
+      else
+      {
+        tracer->SetInputConnection(tetrahedralize->GetOutputPort());
+      }
+      if (config == 2)
+      {
+        vtkNew<vtkCellLocatorInterpolatedVelocityField> interpolator;
+        vtkNew<vtkStaticCellLocator> locator;
+        interpolator->SetCellLocatorPrototype(locator);
+        tracer->SetInterpolatorPrototype(interpolator);
+      }
+      tracer->SetSourceData(seeds);
+      tracer->SetIntegrationDirectionToBoth();
+      vtkNew<vtkRungeKutta45> integrator;
+      tracer->SetIntegrator(integrator);
+      tracer->SetMaximumPropagation(8.0);
+      tracer->SetComputeVorticity(true);
+      vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { tracer->Update(); });
+      outputs[parallel] = tracer->GetOutput();
+    }
+
+    if (outputs[0]->GetNumberOfLines() < 100)
+    {
+      std::cerr << "Too few streamlines (configuration " << config << "): "
+                << outputs[0]->GetNumberOfLines() << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!SameStreamlines(outputs[0], outputs[1]))
+    {
+      std::cerr << "The parallel output differs (configuration " << config
+                << ")" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
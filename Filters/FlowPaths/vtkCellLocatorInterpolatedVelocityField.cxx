@@ -264,6 +264,46 @@ void vtkCellLocatorInterpolatedVelocityField::AddDataSet( vtkDataSet * dataset )
   }
 }
 
+//----------------------------------------------------------------------------
+void vtkCellLocatorInterpolatedVelocityField::AddDataSet
+  ( vtkDataSet * dataset, vtkAbstractCellLocator * locator )
+{
+  if ( !locator )
+  {
+    this->AddDataSet( dataset );
+    return;
+  }
+
+  if ( !dataset )
+  {
+    vtkErrorMacro( <<"Dataset nullptr!" );
+    return;
+  }
+
+  this->DataSets->push_back( dataset );
+  this->CellLocators->push_back( locator );
+
+  int  size = dataset->GetMaxCellSize();
+  if ( size > this->WeightsSize )
+  {
+    this->WeightsSize = size;
+    delete[] this->Weights;
+    this->Weights = new double[size];
+  }
+}
+
+//----------------------------------------------------------------------------
+vtkAbstractCellLocator * vtkCellLocatorInterpolatedVelocityField::GetCellLocator
+  ( int dataindex )
+{
+  if ( dataindex < 0 ||
+       dataindex >= static_cast< int >( this->CellLocators->size() ) )
+  {
+    return nullptr;
+  }
+  return ( *this->CellLocators )[dataindex];
+}
+
 //----------------------------------------------------------------------------
 void vtkCellLocatorInterpolatedVelocityField::CopyParameters
   ( vtkAbstractInterpolatedVelocityField * from )
@@ -102,6 +102,20 @@ public:
    */
   void AddDataSet( vtkDataSet * dataset ) override;
 
+  /**
+   * Add a dataset together with the cell locator to use for it. The locator
+   * is referenced rather than created from the prototype, so that several
+   * instances (e.g., one per thread) can share a locator that is built only
+   * once. A nullptr locator is equivalent to AddDataSet( dataset ).
+   */
+  void AddDataSet( vtkDataSet * dataset, vtkAbstractCellLocator * locator );
+
+  /**
+   * Get the cell locator attached to the dataset of the given index, or
+   * nullptr if there is none (e.g., for vtkImageData).
+   */
+  vtkAbstractCellLocator * GetCellLocator( int dataindex );
+
   /**
    * Evaluate the velocity field f at point (x, y, z).
    */
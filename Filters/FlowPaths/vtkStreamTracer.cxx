@@ -45,8 +45,12 @@ PURPOSE.  See the above copyright notice for more information.
 #include "vtkRungeKutta2.h"
 #include "vtkRungeKutta4.h"
 #include "vtkRungeKutta45.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLocator.h"
 
+#include <algorithm>
 #include <vector>
 
 vtkObjectFactoryNewMacro(vtkStreamTracer)
@@ -116,6 +120,7 @@ vtkStreamTracer::vtkStreamTracer()
   this->LastUsedStepSize = 0.0;
 
   this->GenerateNormalsInIntegrate = true;
+  this->IntegratingBatches = false;
 
   this->InterpolatorPrototype = nullptr;
 
@@ -512,12 +517,31 @@ int vtkStreamTracer::RequestData(
       double propagation = 0;
       vtkIdType numSteps = 0;
       double integrationTime = 0;
-      this->Integrate(input0->GetPointData(), output,
-                      seeds, seedIds,
-                      integrationDirections,
-                      lastPoint, func,
-                      maxCellSize, vecType,vecName,
-                      propagation, numSteps, integrationTime);
+      // The interpolator and the callbacks are not thread-safe; the batches
+      // use copies of the former and cannot share the latter.
+      bool parallel = vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+        seedIds->GetNumberOfIds() > 1 &&
+        this->CustomTerminationCallback.empty() &&
+        this->HasMatchingPointAttributes &&
+        vtkCompositeInterpolatedVelocityField::SafeDownCast(func) &&
+        (!this->SurfaceStreamlines ||
+         vtkInterpolatedVelocityField::SafeDownCast(func));
+      if (parallel)
+      {
+        this->IntegrateInParallel(input0->GetPointData(), output,
+                                  seeds, seedIds,
+                                  integrationDirections, func,
+                                  maxCellSize, vecType, vecName);
+      }
+      else
+      {
+        this->Integrate(input0->GetPointData(), output,
+                        seeds, seedIds,
+                        integrationDirections,
+                        lastPoint, func,
+                        maxCellSize, vecType,vecName,
+                        propagation, numSteps, integrationTime);
+      }
     }
     func->Delete();
     seeds->Delete();
@@ -792,7 +816,10 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
   {
 
     double progress = static_cast<double>(currentLine)/numLines;
-    this->UpdateProgress(progress);
+    if (!this->IntegratingBatches)
+    {
+      this->UpdateProgress(progress);
+    }
 
     switch (integrationDirections->GetValue(currentLine))
     {
@@ -938,9 +965,12 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
 
       if ( numSteps++ % 1000 == 1 )
       {
-        progress =
-          ( currentLine + propagation / this->MaximumPropagation ) / numLines;
-        this->UpdateProgress(progress);
+        if (!this->IntegratingBatches)
+        {
+          progress =
+            ( currentLine + propagation / this->MaximumPropagation ) / numLines;
+          this->UpdateProgress(progress);
+        }
 
         if (this->GetAbortExecute())
         {
@@ -973,7 +1003,10 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
         }
         maxStep = stepSize.Interval;
       }
-      this->LastUsedStepSize = stepSize.Interval;
+      if (!this->IntegratingBatches)
+      {
+        this->LastUsedStepSize = stepSize.Interval;
+      }
 
       // Calculate the next step using the integrator provided
       // Break if the next point is out of bounds.
@@ -1215,6 +1248,262 @@ void vtkStreamTracer::Integrate(vtkPointData *input0Data,
   output->Squeeze();
 }
 
+// Integrates contiguous batches of seeds, each into its own vtkPolyData.
+// Every thread uses its own copy of the interpolator, with the same datasets
+// and, when they can be shared, the same cell locators.
+struct vtkStreamTracer::IntegrateBatches
+{
+  vtkStreamTracer* Tracer;
+  vtkPointData* InputData;
+  vtkDataArray* Seeds;
+  vtkIdList* SeedIds;
+  vtkIntArray* Directions;
+  vtkAbstractInterpolatedVelocityField* Field;
+  const std::vector<vtkDataSet*>& DataSets;
+  const std::vector<vtkAbstractCellLocator*>& Locators;
+  int MaxCellSize;
+  int VecType;
+  const char* VecName;
+  vtkIdType BatchSize;
+  std::vector<vtkSmartPointer<vtkPolyData> >& Batches;
+  vtkSMPThreadLocal<vtkSmartPointer<vtkAbstractInterpolatedVelocityField> >
+    Fields;
+
+  IntegrateBatches(vtkStreamTracer* tracer, vtkPointData* inputData,
+                   vtkDataArray* seeds, vtkIdList* seedIds,
+                   vtkIntArray* directions,
+                   vtkAbstractInterpolatedVelocityField* field,
+                   const std::vector<vtkDataSet*>& dataSets,
+                   const std::vector<vtkAbstractCellLocator*>& locators,
+                   int maxCellSize, int vecType, const char* vecName,
+                   vtkIdType batchSize,
+                   std::vector<vtkSmartPointer<vtkPolyData> >& batches) :
+    Tracer(tracer), InputData(inputData), Seeds(seeds), SeedIds(seedIds),
+    Directions(directions), Field(field), DataSets(dataSets),
+    Locators(locators), MaxCellSize(maxCellSize), VecType(vecType),
+    VecName(vecName), BatchSize(batchSize), Batches(batches)
+  {
+  }
+
+  void Initialize()
+  {
+    vtkSmartPointer<vtkAbstractInterpolatedVelocityField>& field =
+      this->Fields.Local();
+    field.TakeReference(this->Field->NewInstance());
+    field->CopyParameters(this->Field);
+    vtkCompositeInterpolatedVelocityField* composite =
+      vtkCompositeInterpolatedVelocityField::SafeDownCast(field);
+    vtkCellLocatorInterpolatedVelocityField* cellLocatorField =
+      vtkCellLocatorInterpolatedVelocityField::SafeDownCast(field);
+    for (size_t i = 0; i < this->DataSets.size(); ++i)
+    {
+      if (cellLocatorField)
+      {
+        cellLocatorField->AddDataSet(this->DataSets[i], this->Locators[i]);
+      }
+      else
+      {
+        composite->AddDataSet(this->DataSets[i]);
+      }
+    }
+    field->SelectVectors(this->VecType, this->VecName);
+  }
+
+  void operator()(vtkIdType batch, vtkIdType endBatch)
+  {
+    vtkAbstractInterpolatedVelocityField* field = this->Fields.Local();
+    vtkIdType numLines = this->SeedIds->GetNumberOfIds();
+    for (; batch < endBatch; ++batch)
+    {
+      vtkIdType first = batch * this->BatchSize;
+      vtkIdType last = std::min(first + this->BatchSize, numLines);
+      vtkNew<vtkIdList> seedIds;
+      seedIds->SetNumberOfIds(last - first);
+      vtkNew<vtkIntArray> directions;
+      directions->SetNumberOfValues(last - first);
+      for (vtkIdType i = first; i < last; ++i)
+      {
+        seedIds->SetId(i - first, this->SeedIds->GetId(i));
+        directions->SetValue(i - first, this->Directions->GetValue(i));
+      }
+
+      vtkSmartPointer<vtkPolyData> output = vtkSmartPointer<vtkPolyData>::New();
+      double lastPoint[3];
+      double propagation = 0;
+      vtkIdType numSteps = 0;
+      double integrationTime = 0;
+      this->Tracer->Integrate(this->InputData, output,
+                              this->Seeds, seedIds,
+                              directions,
+                              lastPoint, field,
+                              this->MaxCellSize, this->VecType, this->VecName,
+                              propagation, numSteps, integrationTime);
+      this->Batches[batch] = output;
+    }
+  }
+
+  void Reduce()
+  {
+  }
+};
+
+void vtkStreamTracer::IntegrateInParallel(vtkPointData *input0Data,
+                                          vtkPolyData* output,
+                                          vtkDataArray* seedSource,
+                                          vtkIdList* seedIds,
+                                          vtkIntArray* integrationDirections,
+                                          vtkAbstractInterpolatedVelocityField* func,
+                                          int maxCellSize,
+                                          int vecType,
+                                          const char *vecName)
+{
+  if (this->GetIntegrator() == nullptr)
+  {
+    vtkErrorMacro("No integrator is specified.");
+    return;
+  }
+
+  // Build everything the datasets and the cell locators construct on first
+  // use (bounds, links, point locators, static cell locators), so that the
+  // threads only read them.
+  vtkCellLocatorInterpolatedVelocityField* cellLocatorField =
+    vtkCellLocatorInterpolatedVelocityField::SafeDownCast(func);
+  std::vector<vtkDataSet*> dataSets;
+  std::vector<vtkAbstractCellLocator*> locators;
+  std::vector<double> weights(maxCellSize > 0 ? maxCellSize : 1);
+  vtkNew<vtkGenericCell> cell;
+  vtkNew<vtkIdList> cellIds;
+  vtkSmartPointer<vtkCompositeDataIterator> iter;
+  iter.TakeReference(this->InputData->NewIterator());
+  for (iter->GoToFirstItem(); !iter->IsDoneWithTraversal(); iter->GoToNextItem())
+  {
+    vtkDataSet* ds = vtkDataSet::SafeDownCast(iter->GetCurrentDataObject());
+    if (!ds)
+    {
+      continue;
+    }
+    double center[3], pcoords[3];
+    int subId;
+    ds->GetCenter(center);
+    if (ds->GetNumberOfPoints() > 0)
+    {
+      ds->GetPointCells(0, cellIds);
+    }
+    if (vtkPointSet::SafeDownCast(ds))
+    {
+      ds->FindCell(center, nullptr, cell, -1, 0.0, subId, pcoords,
+                   weights.data());
+    }
+    vtkAbstractCellLocator* locator = nullptr;
+    if (cellLocatorField)
+    {
+      locator = cellLocatorField->GetCellLocator(
+        static_cast<int>(dataSets.size()));
+      if (vtkStaticCellLocator::SafeDownCast(locator))
+      {
+        locator->BuildLocator();
+      }
+      else
+      {
+        locator = nullptr;
+      }
+    }
+    dataSets.push_back(ds);
+    locators.push_back(locator);
+  }
+
+  // Several batches per thread balance streamlines of different lengths.
+  vtkIdType numLines = seedIds->GetNumberOfIds();
+  vtkIdType numBatches = std::min(numLines,
+    static_cast<vtkIdType>(16 * vtkSMPTools::GetEstimatedNumberOfThreads()));
+  vtkIdType batchSize = (numLines + numBatches - 1) / numBatches;
+  numBatches = (numLines + batchSize - 1) / batchSize;
+  std::vector<vtkSmartPointer<vtkPolyData> > batches(numBatches);
+
+  bool generateNormals = this->GenerateNormalsInIntegrate;
+  this->GenerateNormalsInIntegrate = false;
+  this->IntegratingBatches = true;
+  IntegrateBatches integrate(this, input0Data, seedSource, seedIds,
+                             integrationDirections, func, dataSets, locators,
+                             maxCellSize, vecType, vecName, batchSize,
+                             batches);
+  vtkSMPTools::For(0, numBatches, 1, integrate);
+  this->IntegratingBatches = false;
+  this->GenerateNormalsInIntegrate = generateNormals;
+
+  // An aborted batch has no points.
+  vtkIdType numPts = 0;
+  for (vtkIdType batch = 0; batch < numBatches; ++batch)
+  {
+    if (!batches[batch]->GetPoints())
+    {
+      return;
+    }
+    numPts += batches[batch]->GetNumberOfPoints();
+  }
+
+  // Concatenate the batches; their streamlines are in seed order.
+  vtkDataSetAttributes* outputPD = output->GetPointData();
+  vtkDataSetAttributes* outputCD = output->GetCellData();
+  vtkNew<vtkPoints> outputPoints;
+  outputPoints->SetNumberOfPoints(numPts);
+  outputPD->CopyAllocate(batches[0]->GetPointData(), numPts);
+  vtkNew<vtkCellArray> outputLines;
+  vtkNew<vtkIntArray> retVals;
+  retVals->SetName("ReasonForTermination");
+  vtkNew<vtkIntArray> sids;
+  sids->SetName("SeedIds");
+
+  vtkIdType offset = 0;
+  for (vtkIdType batch = 0; batch < numBatches; ++batch)
+  {
+    vtkPolyData* batchOutput = batches[batch];
+    vtkIdType n = batchOutput->GetNumberOfPoints();
+    outputPoints->GetData()->InsertTuples(offset, n, 0,
+                                          batchOutput->GetPoints()->GetData());
+    outputPD->CopyData(batchOutput->GetPointData(), offset, n, 0);
+
+    vtkCellArray* lines = batchOutput->GetLines();
+    vtkIdType npts;
+    vtkIdType* pts;
+    for (lines->InitTraversal(); lines->GetNextCell(npts, pts);)
+    {
+      outputLines->InsertNextCell(npts);
+      for (vtkIdType i = 0; i < npts; ++i)
+      {
+        outputLines->InsertCellPoint(pts[i] + offset);
+      }
+    }
+
+    vtkDataArray* batchRetVals =
+      batchOutput->GetCellData()->GetArray("ReasonForTermination");
+    vtkDataArray* batchSids = batchOutput->GetCellData()->GetArray("SeedIds");
+    if (batchRetVals && batchSids)
+    {
+      retVals->InsertTuples(retVals->GetNumberOfTuples(),
+                            batchRetVals->GetNumberOfTuples(), 0, batchRetVals);
+      sids->InsertTuples(sids->GetNumberOfTuples(),
+                         batchSids->GetNumberOfTuples(), 0, batchSids);
+    }
+    offset += n;
+  }
+
+  output->SetPoints(outputPoints);
+  if (numPts > 1)
+  {
+    output->SetLines(outputLines);
+    if (this->GenerateNormalsInIntegrate)
+    {
+      this->GenerateNormals(output, nullptr, vecName);
+    }
+
+    outputCD->AddArray(retVals);
+    outputCD->AddArray(sids);
+  }
+
+  output->Squeeze();
+}
+
 void vtkStreamTracer::GenerateNormals(vtkPolyData* output, double* firstNormal,
                                       const char *vecName)
 {
@@ -69,6 +69,17 @@
  * a source object, traces will be generated from each point in the source
  * that is inside the dataset.
  *
+ * When more than one thread is available (see vtkSMPTools), the seeds are
+ * integrated concurrently in contiguous batches. Each thread uses its own
+ * copy of the interpolator and of the integrator, and the streamlines are
+ * merged in seed order, so that the output does not depend on the number of
+ * threads. A vtkStaticCellLocator given as the cell locator prototype of a
+ * vtkCellLocatorInterpolatedVelocityField is built once and shared by all
+ * the threads; other cell locators are built by each thread. Custom
+ * termination callbacks, AMR input, point attributes that differ between
+ * the blocks of the input, and surface streamlines with an interpolator
+ * other than vtkInterpolatedVelocityField all force serial integration.
+ *
  * @sa
  * vtkRibbonFilter vtkRuledSurfaceFilter vtkInitialValueProblemSolver
  * vtkRungeKutta2 vtkRungeKutta4 vtkRungeKutta45 vtkTemporalStreamTracer
@@ -420,8 +431,28 @@ protected:
                   int* maxCellSize);
   void GenerateNormals(vtkPolyData* output, double* firstNormal, const char *vecName);
 
+  /**
+   * Integrate the seeds in batches on several threads, each with its own
+   * copy of func, and merge the streamlines into output in seed order.
+   * The result is the same as the one of Integrate() for the same seeds.
+   */
+  void IntegrateInParallel(vtkPointData *inputData,
+                           vtkPolyData* output,
+                           vtkDataArray* seedSource,
+                           vtkIdList* seedIds,
+                           vtkIntArray* integrationDirections,
+                           vtkAbstractInterpolatedVelocityField* func,
+                           int maxCellSize,
+                           int vecType,
+                           const char *vecFieldName);
+  struct IntegrateBatches;
+
   bool GenerateNormalsInIntegrate;
 
+  // Set while the batches of IntegrateInParallel() are integrated: progress
+  // is then not reported and LastUsedStepSize is not updated.
+  bool IntegratingBatches;
+
   // starting from global x-y-z position
   double StartPosition[3];
 
@@ -0,0 +1,144 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestGradientFilterThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkGradientFilter computes the same point and cell gradients,
+// vorticity, divergence and Q-criterion with one and with several threads on
+// unstructured grids and polydata.
+
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkCellTypeSource.h"
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkGradientFilter.h"
+#include "vtkIdList.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestArrays.h"
+#include "vtkTestSMP.h"
+#include "vtkUnstructuredGrid.h"
+
+namespace
+{
+
+// Add a swirling point vector field and a cell scalar field.
+void AddFields(vtkDataSet *data)
+{
+  vtkNew<vtkDoubleArray> velocity;
+  velocity->SetName("velocity");
+  velocity->SetNumberOfComponents(3);
+  velocity->SetNumberOfTuples(data->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < data->GetNumberOfPoints(); ++i)
+  {
+    double x[3];
+    data->GetPoint(i, x);
+    velocity->SetTuple3(i, -x[1] * x[2], x[0] + x[2] * x[2], x[0] * x[1]);
+  }
+  data->GetPointData()->AddArray(velocity);
+
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(data->GetNumberOfCells());
+  for (vtkIdType i = 0; i < data->GetNumberOfCells(); ++i)
+  {
+    scalars->SetValue(i, static_cast<double>((i * 7) % 11));
+  }
+  data->GetCellData()->AddArray(scalars);
+}
+
+int Compare(vtkDataSet *input, const char *name)
+{
+  for (int association = 0; association < 2; ++association)
+  {
+    for (int option = 0; option < 3; ++option)
+    {
+      for (int faster = 0; faster < 2; ++faster)
+      {
+        vtkSmartPointer<vtkDataSet> outputs[2];
+        for (int parallel = 0; parallel < 2; ++parallel)
+        {
+          vtkNew<vtkGradientFilter> gradient;
+          gradient->SetInputData(input);
+          if (association == 0)
+          {
+            gradient->SetInputScalars(
+              vtkDataObject::FIELD_ASSOCIATION_POINTS, "velocity");
+            gradient->SetComputeVorticity(true);
+            gradient->SetComputeQCriterion(true);
+            gradient->SetComputeDivergence(true);
+          }
+          else
+          {
+            gradient->SetInputScalars(
+              vtkDataObject::FIELD_ASSOCIATION_CELLS, "scalars");
+          }
+          gradient->SetContributingCellOption(option);
+          gradient->SetFasterApproximation(faster);
+          vtkTest::RunThreaded(
+            parallel ? 4 : 1, [&]() { gradient->Update(); });
+          outputs[parallel] = gradient->GetOutput();
+        }
+
+        if (!vtkTest::SameArrays(outputs[0]->GetPointData(),
+                                 outputs[1]->GetPointData()) ||
+            !vtkTest::SameArrays(outputs[0]->GetCellData(),
+                                 outputs[1]->GetCellData()))
+        {
+          std::cerr << "The parallel output differs for the " << name
+                    << " (association: " << association << ", option: "
+                    << option << ", faster approximation: " << faster << ")"
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+  return EXIT_SUCCESS;
+}
+
+}
+
+int TestGradientFilterThreads(int, char *[])
+{
+  // Quadratic tetrahedra, plus triangles sharing some of their points to
+  // exercise the contributing cell options.
+  vtkNew<vtkCellTypeSource> cells;
+  cells->SetCellType(VTK_QUADRATIC_TETRA);
+  cells->SetBlocksDimensions(5, 4, 3);
+  cells->Update();
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->DeepCopy(cells->GetOutput());
+  for (vtkIdType i = 0; i + 20 < grid->GetNumberOfPoints(); i += 13)
+  {
+    vtkIdType pts[3] = { i, i + 1, i + 20 };
+    grid->InsertNextCell(VTK_TRIANGLE, 3, pts);
+  }
+  AddFields(grid);
+  if (Compare(grid, "unstructured grid") != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(30);
+  sphere->SetPhiResolution(20);
+  sphere->Update();
+  vtkNew<vtkPolyData> surface;
+  surface->DeepCopy(sphere->GetOutput());
+  AddFields(surface);
+  return Compare(surface, "polydata");
+}
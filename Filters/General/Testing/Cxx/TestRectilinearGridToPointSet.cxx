@@ -80,41 +80,48 @@ int TestRectilinearGridToPointSet(int, char*[])
 
   vtkNew<vtkRectilinearGridToPointSet> rect2points;
   rect2points->SetInputData(inData);
-  rect2points->Update();
 
-  vtkDataSet *outData = rect2points->GetOutput();
-
-  vtkIdType numPoints = inData->GetNumberOfPoints();
-  if (numPoints != outData->GetNumberOfPoints())
+  // Stored, then implicit points.
+  for (int implicit = 0; implicit < 2; implicit++)
   {
-    std::cout << "Got wrong number of points: " << numPoints << " vs "
-         << outData->GetNumberOfPoints() << std::endl;
-    return EXIT_FAILURE;
-  }
+    rect2points->SetImplicitPoints(implicit != 0);
+    rect2points->Update();
 
-  vtkIdType numCells = inData->GetNumberOfCells();
-  if (numCells != outData->GetNumberOfCells())
-  {
-    std::cout << "Got wrong number of cells: " << numCells << " vs "
-         << outData->GetNumberOfCells() << std::endl;
-    return EXIT_FAILURE;
-  }
+    vtkDataSet *outData = rect2points->GetOutput();
 
-  for (vtkIdType pointId = 0; pointId < numPoints; pointId++)
-  {
-    double inPoint[3];
-    double outPoint[3];
+    vtkIdType numPoints = inData->GetNumberOfPoints();
+    if (numPoints != outData->GetNumberOfPoints())
+    {
+      std::cout << "Got wrong number of points: " << numPoints << " vs "
+           << outData->GetNumberOfPoints() << std::endl;
+      return EXIT_FAILURE;
+    }
 
-    inData->GetPoint(pointId, inPoint);
-    outData->GetPoint(pointId, outPoint);
+    vtkIdType numCells = inData->GetNumberOfCells();
+    if (numCells != outData->GetNumberOfCells())
+    {
+      std::cout << "Got wrong number of cells: " << numCells << " vs "
+           << outData->GetNumberOfCells() << std::endl;
+      return EXIT_FAILURE;
+    }
 
-    if (   (inPoint[0] != outPoint[0])
-        || (inPoint[1] != outPoint[1])
-        || (inPoint[2] != outPoint[2]) )
+    for (vtkIdType pointId = 0; pointId < numPoints; pointId++)
     {
-      std::cout << "Got mismatched point coordinates." << std::endl;
-      std::cout << "Input: " << inPoint[0] << " " << inPoint[1] << " " << inPoint[2] << std::endl;
-      std::cout << "Output: " << outPoint[0] << " " << outPoint[1] << " " << outPoint[2] << std::endl;
+      double inPoint[3];
+      double outPoint[3];
+
+      inData->GetPoint(pointId, inPoint);
+      outData->GetPoint(pointId, outPoint);
+
+      if (   (inPoint[0] != outPoint[0])
+          || (inPoint[1] != outPoint[1])
+          || (inPoint[2] != outPoint[2]) )
+      {
+        std::cout << "Got mismatched point coordinates." << std::endl;
+        std::cout << "Input: " << inPoint[0] << " " << inPoint[1] << " " << inPoint[2] << std::endl;
+        std::cout << "Output: " << outPoint[0] << " " << outPoint[1] << " " << outPoint[2] << std::endl;
+        return EXIT_FAILURE;
+      }
     }
   }
 
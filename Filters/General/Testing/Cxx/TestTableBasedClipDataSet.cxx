@@ -0,0 +1,205 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestTableBasedClipDataSet.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkTableBasedClipDataSet produces the same output with one and
+// with several threads, for the dataset types clipped in parallel.
+
+#include "vtkAppendFilter.h"
+#include "vtkCellData.h"
+#include "vtkCellType.h"
+#include "vtkDataSetTriangleFilter.h"
+#include "vtkFloatArray.h"
+#include "vtkIdList.h"
+#include "vtkIdTypeArray.h"
+#include "vtkImageData.h"
+#include "vtkImageDataToPointSet.h"
+#include "vtkNew.h"
+#include "vtkPlane.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkStructuredGrid.h"
+#include "vtkTableBasedClipDataSet.h"
+#include "vtkTestArrays.h"
+#include "vtkTestSMP.h"
+#include "vtkUnstructuredGrid.h"
+
+#include <cmath>
+
+namespace
+{
+
+vtkSmartPointer<vtkImageData> CreateImage(int nx, int ny, int nz)
+{
+  vtkSmartPointer<vtkImageData> image = vtkSmartPointer<vtkImageData>::New();
+  image->SetDimensions(nx, ny, nz);
+  image->SetSpacing(0.1, 0.2, 0.15);
+  image->SetOrigin(-1.0, 0.5, 2.0);
+  vtkNew<vtkFloatArray> scalars;
+  scalars->SetName("scalars");
+  scalars->SetNumberOfTuples(image->GetNumberOfPoints());
+  for (vtkIdType i = 0; i < image->GetNumberOfPoints(); ++i)
+  {
+    double p[3];
+    image->GetPoint(i, p);
+    scalars->SetValue(i, static_cast<float>(
+      std::sin(3.0 * p[0]) * std::cos(2.0 * p[1]) + 0.3 * p[2]));
+  }
+  image->GetPointData()->SetScalars(scalars);
+  vtkNew<vtkIdTypeArray> cellIds;
+  cellIds->SetName("cellIds");
+  cellIds->SetNumberOfTuples(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    cellIds->SetValue(i, i);
+  }
+  image->GetCellData()->AddArray(cellIds);
+  return image;
+}
+
+bool SameGrids(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+    {
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> aPts;
+  vtkNew<vtkIdList> bPts;
+  for (vtkIdType c = 0; c < a->GetNumberOfCells(); ++c)
+  {
+    a->GetCellPoints(c, aPts);
+    b->GetCellPoints(c, bPts);
+    if (a->GetCellType(c) != b->GetCellType(c) ||
+        aPts->GetNumberOfIds() != bPts->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType i = 0; i < aPts->GetNumberOfIds(); ++i)
+    {
+      if (aPts->GetId(i) != bPts->GetId(i))
+      {
+        return false;
+      }
+    }
+  }
+  return vtkTest::SameArrays(a->GetPointData(), b->GetPointData()) &&
+    vtkTest::SameArrays(a->GetCellData(), b->GetCellData());
+}
+
+// Clip by scalar value and by plane, inside out or not, with one and with
+// four threads.
+bool CheckClip(vtkDataSet *input, const char *name)
+{
+  vtkNew<vtkPlane> plane;
+  plane->SetOrigin(0.0, 1.5, 3.0);
+  plane->SetNormal(1.0, 2.0, 0.5);
+  for (int usePlane = 0; usePlane < 2; ++usePlane)
+  {
+    for (int insideOut = 0; insideOut < 2; ++insideOut)
+    {
+      vtkSmartPointer<vtkUnstructuredGrid> outputs[2];
+      vtkSmartPointer<vtkUnstructuredGrid> clippedOutputs[2];
+      for (int parallel = 0; parallel < 2; ++parallel)
+      {
+        vtkNew<vtkTableBasedClipDataSet> clipper;
+        clipper->SetInputData(input);
+        clipper->SetValue(0.5);
+        clipper->SetInsideOut(insideOut);
+        clipper->GenerateClippedOutputOn();
+        if (usePlane)
+        {
+          clipper->SetClipFunction(plane);
+          clipper->GenerateClipScalarsOn();
+        }
+        vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { clipper->Update(); });
+        outputs[parallel] = clipper->GetOutput();
+        clippedOutputs[parallel] = clipper->GetClippedOutput();
+      }
+      if (!SameGrids(outputs[0], outputs[1]) ||
+          !SameGrids(clippedOutputs[0], clippedOutputs[1]))
+      {
+        std::cerr << name << ": the parallel output differs (plane: "
+                  << usePlane << ", inside out: " << insideOut << ")"
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+int TestTableBasedClipDataSet(int, char *[])
+{
+  // Image data is clipped as a rectilinear grid.
+  vtkSmartPointer<vtkImageData> image = CreateImage(20, 23, 18);
+  vtkSmartPointer<vtkImageData> slice = CreateImage(20, 1, 25);
+  vtkNew<vtkImageDataToPointSet> toStructured;
+  toStructured->SetInputData(image);
+  toStructured->Update();
+
+  // Voxels, tetrahedra, pixels and a few other cells on the same points.
+  vtkNew<vtkDataSetTriangleFilter> tetrahedralize;
+  tetrahedralize->SetInputData(image);
+  vtkNew<vtkAppendFilter> append;
+  append->AddInputData(image);
+  append->AddInputConnection(tetrahedralize->GetOutputPort());
+  append->Update();
+  vtkNew<vtkUnstructuredGrid> grid;
+  grid->DeepCopy(append->GetOutput());
+  vtkIdTypeArray *cellIds = vtkArrayDownCast<vtkIdTypeArray>(
+    grid->GetCellData()->GetArray("cellIds"));
+  const int types[6] = { VTK_WEDGE, VTK_PYRAMID, VTK_TRIANGLE, VTK_QUAD,
+                         VTK_LINE, VTK_VERTEX };
+  const int sizes[6] = { 6, 5, 3, 4, 2, 1 };
+  for (vtkIdType i = 0; i + 6 < grid->GetNumberOfPoints(); i += 97)
+  {
+    vtkIdType pts[6] = { i, i + 1, i + 2, i + 3, i + 4, i + 5 };
+    for (int t = 0; t < 6; ++t)
+    {
+      cellIds->InsertNextValue(grid->InsertNextCell(types[t], sizes[t], pts));
+    }
+  }
+
+  // Cells that are not in the tables are handed to vtkClipDataSet.
+  vtkNew<vtkUnstructuredGrid> special;
+  special->DeepCopy(grid);
+  vtkIdType edge[3] = { 0, 1, 2 };
+  vtkIdTypeArray *specialCellIds = vtkArrayDownCast<vtkIdTypeArray>(
+    special->GetCellData()->GetArray("cellIds"));
+  specialCellIds->InsertNextValue(
+    special->InsertNextCell(VTK_QUADRATIC_EDGE, 3, edge));
+
+  if (!CheckClip(image, "vtkImageData") ||
+      !CheckClip(slice, "vtkImageData (XZ)") ||
+      !CheckClip(toStructured->GetOutput(), "vtkStructuredGrid") ||
+      !CheckClip(grid, "vtkUnstructuredGrid") ||
+      !CheckClip(special, "vtkUnstructuredGrid (quadratic edge)"))
+  {
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -25,6 +25,7 @@
 #include "vtkCellDataToPointData.h"
 #include "vtkDataArray.h"
 #include "vtkDataSet.h"
+#include "vtkGenericCell.h"
 #include "vtkIdList.h"
 #include "vtkImageData.h"
 #include "vtkInformation.h"
@@ -35,11 +36,16 @@
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPThreadLocalObject.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticCellLinksTemplate.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGrid.h"
 #include "vtkUnstructuredGrid.h"
 
+#include <algorithm>
 #include <limits>
 #include <vector>
 
@@ -848,6 +854,300 @@ int vtkGradientFilter::GetOutputArrayType(vtkDataArray* array)
 }
 
 namespace {
+//-----------------------------------------------------------------------------
+  // Dimension of every cell, used by the Patch option of the threaded point
+  // gradients.
+  struct CellDimensions
+  {
+    vtkDataSet *Structure;
+    unsigned char *Dimensions;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+
+    CellDimensions(vtkDataSet *structure, unsigned char *dimensions) :
+      Structure(structure), Dimensions(dimensions)
+    {
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkGenericCell *cell = this->Cell.Local();
+      for (vtkIdType cellId = begin; cellId < end; cellId++)
+      {
+        this->Structure->GetCell(cellId, cell);
+        this->Dimensions[cellId] =
+          static_cast<unsigned char>(cell->GetCellDimension());
+      }
+    }
+  };
+
+//-----------------------------------------------------------------------------
+  // Threaded version of ComputePointGradientsUG(). Each point gathers the
+  // derivatives of the cells using it, so that every output tuple is written
+  // by a single thread and no atomic update is needed.
+  template<class data_type>
+  struct PointGradients
+  {
+    vtkDataSet *Structure;
+    vtkDataArray *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    int HighestCellDimension;
+    int ContributingCellOption;
+    int MaxCellDimension;
+    vtkStaticCellLinksTemplate<vtkIdType> *Links;
+    const unsigned char *Dimensions;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocal<std::vector<data_type> > G;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+
+    PointGradients(vtkDataSet *structure, vtkDataArray *array,
+                   data_type *gradients, int numberOfInputComponents,
+                   data_type *vorticity, data_type *qCriterion,
+                   data_type *divergence, int highestCellDimension,
+                   int contributingCellOption, int maxCellDimension,
+                   vtkStaticCellLinksTemplate<vtkIdType> *links,
+                   const unsigned char *dimensions) :
+      Structure(structure), Array(array), Gradients(gradients),
+      NumberOfInputComponents(numberOfInputComponents), Vorticity(vorticity),
+      QCriterion(qCriterion), Divergence(divergence),
+      HighestCellDimension(highestCellDimension),
+      ContributingCellOption(contributingCellOption),
+      MaxCellDimension(maxCellDimension), Links(links), Dimensions(dimensions)
+    {
+    }
+
+    void Initialize()
+    {
+      this->G.Local().resize(3*this->NumberOfInputComponents);
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkGenericCell *cell = this->Cell.Local();
+      std::vector<data_type> &g = this->G.Local();
+      std::vector<double> &values = this->Values.Local();
+      int numberOfOutputComponents = 3*this->NumberOfInputComponents;
+
+      for (vtkIdType point = begin; point < end; point++)
+      {
+        double pointcoords[3];
+        this->Structure->GetPoint(point, pointcoords);
+        // The static links list the cells of a point by decreasing id. Visit
+        // them backwards to sum in the same order as the serial path.
+        vtkIdType numCellNeighbors = this->Links->GetNumberOfCells(point);
+        const vtkIdType *cellsOnPoint =
+          this->Links->GetCells(point) + numCellNeighbors - 1;
+
+        std::fill(g.begin(), g.end(), static_cast<data_type>(0));
+
+        int highestCellDimension = this->HighestCellDimension;
+        if (this->ContributingCellOption == vtkGradientFilter::Patch)
+        {
+          highestCellDimension = 0;
+          for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+          {
+            int cellDimension = this->Dimensions[*(cellsOnPoint - neighbor)];
+            if (cellDimension > highestCellDimension)
+            {
+              highestCellDimension = cellDimension;
+              if (highestCellDimension == this->MaxCellDimension)
+              {
+                break;
+              }
+            }
+          }
+        }
+        vtkIdType numValidCellNeighbors = 0;
+
+        for (vtkIdType neighbor = 0; neighbor < numCellNeighbors; neighbor++)
+        {
+          this->Structure->GetCell(*(cellsOnPoint - neighbor), cell);
+          if (cell->GetCellDimension() >= highestCellDimension)
+          {
+            int subId;
+            double parametricCoord[3];
+            if(GetCellParametricData(point, pointcoords, cell,
+                                     subId, parametricCoord))
+            {
+              numValidCellNeighbors++;
+              int numberOfCellPoints = cell->GetNumberOfPoints();
+              values.resize(numberOfCellPoints);
+              for(int inputComponent=0;
+                  inputComponent<this->NumberOfInputComponents;
+                  inputComponent++)
+              {
+                for (int i = 0; i < numberOfCellPoints; i++)
+                {
+                  values[i] = this->Array->GetComponent(cell->GetPointId(i),
+                                                        inputComponent);
+                }
+
+                double derivative[3];
+                cell->Derivatives(subId, parametricCoord, &values[0], 1,
+                                  derivative);
+
+                g[inputComponent*3] += static_cast<data_type>(derivative[0]);
+                g[inputComponent*3+1] += static_cast<data_type>(derivative[1]);
+                g[inputComponent*3+2] += static_cast<data_type>(derivative[2]);
+              }
+            }
+          }
+        }
+
+        if (numValidCellNeighbors > 0)
+        {
+          for(int i=0;i<numberOfOutputComponents;i++)
+          {
+            g[i] /= numValidCellNeighbors;
+          }
+
+          if(this->Vorticity)
+          {
+            ComputeVorticityFromGradient(&g[0], this->Vorticity+3*point);
+          }
+          if(this->QCriterion)
+          {
+            ComputeQCriterionFromGradient(&g[0], this->QCriterion+point);
+          }
+          if(this->Divergence)
+          {
+            ComputeDivergenceFromGradient(&g[0], this->Divergence+point);
+          }
+          if(this->Gradients)
+          {
+            for(int i=0;i<numberOfOutputComponents;i++)
+            {
+              this->Gradients[point*numberOfOutputComponents+i] = g[i];
+            }
+          }
+        }
+      }
+    }
+
+    void Reduce()
+    {
+    }
+  };
+
+//-----------------------------------------------------------------------------
+  // Threaded version of ComputeCellGradientsUG().
+  template<class data_type>
+  struct CellGradients
+  {
+    vtkDataSet *Structure;
+    vtkDataArray *Array;
+    data_type *Gradients;
+    int NumberOfInputComponents;
+    data_type *Vorticity;
+    data_type *QCriterion;
+    data_type *Divergence;
+    vtkSMPThreadLocalObject<vtkGenericCell> Cell;
+    vtkSMPThreadLocal<std::vector<data_type> > G;
+    vtkSMPThreadLocal<std::vector<double> > Values;
+
+    CellGradients(vtkDataSet *structure, vtkDataArray *array,
+                  data_type *gradients, int numberOfInputComponents,
+                  data_type *vorticity, data_type *qCriterion,
+                  data_type *divergence) :
+      Structure(structure), Array(array), Gradients(gradients),
+      NumberOfInputComponents(numberOfInputComponents), Vorticity(vorticity),
+      QCriterion(qCriterion), Divergence(divergence)
+    {
+    }
+
+    void Initialize()
+    {
+      this->G.Local().resize(3*this->NumberOfInputComponents);
+    }
+
+    void operator()(vtkIdType begin, vtkIdType end)
+    {
+      vtkGenericCell *cell = this->Cell.Local();
+      std::vector<data_type> &cellGradients = this->G.Local();
+      std::vector<double> &values = this->Values.Local();
+      int numberOfOutputComponents = 3*this->NumberOfInputComponents;
+
+      for (vtkIdType cellid = begin; cellid < end; cellid++)
+      {
+        this->Structure->GetCell(cellid, cell);
+        double cellCenter[3];
+        int subId = cell->GetParametricCenter(cellCenter);
+
+        int numpoints = cell->GetNumberOfPoints();
+        values.resize(numpoints);
+        double derivative[3];
+        for(int inputComponent=0;
+            inputComponent<this->NumberOfInputComponents; inputComponent++)
+        {
+          for (int i = 0; i < numpoints; i++)
+          {
+            values[i] = this->Array->GetComponent(cell->GetPointId(i),
+                                                  inputComponent);
+          }
+
+          cell->Derivatives(subId, cellCenter, &values[0], 1, derivative);
+          cellGradients[inputComponent*3] =
+            static_cast<data_type>(derivative[0]);
+          cellGradients[inputComponent*3+1] =
+            static_cast<data_type>(derivative[1]);
+          cellGradients[inputComponent*3+2] =
+            static_cast<data_type>(derivative[2]);
+        }
+        if(this->Gradients)
+        {
+          for(int i=0;i<numberOfOutputComponents;i++)
+          {
+            this->Gradients[cellid*numberOfOutputComponents+i] =
+              cellGradients[i];
+          }
+        }
+        if(this->Vorticity)
+        {
+          ComputeVorticityFromGradient(&cellGradients[0],
+                                       this->Vorticity+3*cellid);
+        }
+        if(this->QCriterion)
+        {
+          ComputeQCriterionFromGradient(&cellGradients[0],
+                                        this->QCriterion+cellid);
+        }
+        if(this->Divergence)
+        {
+          ComputeDivergenceFromGradient(&cellGradients[0],
+                                        this->Divergence+cellid);
+        }
+      }
+    }
+
+    void Reduce()
+    {
+    }
+  };
+
+//-----------------------------------------------------------------------------
+  // The threaded paths use vtkGenericCell, which requires the cells of a
+  // vtkPolyData to be built beforehand.
+  bool UseThreadedPath(vtkDataSet *structure)
+  {
+    if (vtkSMPTools::GetEstimatedNumberOfThreads() < 2 ||
+        structure->GetNumberOfCells() == 0)
+    {
+      return false;
+    }
+    if (vtkPolyData *polyData = vtkPolyData::SafeDownCast(structure))
+    {
+      if (polyData->NeedToBuildCells())
+      {
+        polyData->BuildCells();
+      }
+      return true;
+    }
+    return vtkUnstructuredGrid::SafeDownCast(structure) != nullptr;
+  }
+
 //-----------------------------------------------------------------------------
   template<class data_type>
   void ComputePointGradientsUG(
@@ -855,6 +1155,29 @@ namespace {
     int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
     data_type* divergence, int highestCellDimension, int contributingCellOption)
   {
+    if (UseThreadedPath(structure))
+    {
+      // Building static links once is faster than the incremental links that
+      // GetCellNeighbors() would build, and they are safe to read from
+      // several threads.
+      vtkStaticCellLinksTemplate<vtkIdType> links;
+      links.BuildLinks(structure);
+      std::vector<unsigned char> dimensions;
+      if (contributingCellOption == vtkGradientFilter::Patch)
+      {
+        dimensions.resize(structure->GetNumberOfCells());
+        CellDimensions cellDimensions(structure, &dimensions[0]);
+        vtkSMPTools::For(0, structure->GetNumberOfCells(), cellDimensions);
+      }
+      PointGradients<data_type> pointGradients(
+        structure, array, gradients, numberOfInputComponents, vorticity,
+        qCriterion, divergence, highestCellDimension, contributingCellOption,
+        structure->IsA("vtkPolyData") ? 2 : 3, &links,
+        dimensions.empty() ? nullptr : &dimensions[0]);
+      vtkSMPTools::For(0, structure->GetNumberOfPoints(), pointGradients);
+      return;
+    }
+
     vtkNew<vtkIdList> currentPoint;
     currentPoint->SetNumberOfIds(1);
     vtkNew<vtkIdList> cellsOnPoint;
@@ -1003,6 +1326,15 @@ namespace {
       int numberOfInputComponents, data_type* vorticity, data_type* qCriterion,
       data_type* divergence)
   {
+    if (UseThreadedPath(structure))
+    {
+      CellGradients<data_type> cellGradients(
+        structure, array, gradients, numberOfInputComponents, vorticity,
+        qCriterion, divergence);
+      vtkSMPTools::For(0, structure->GetNumberOfCells(), cellGradients);
+      return;
+    }
+
     vtkIdType numcells = structure->GetNumberOfCells();
     std::vector<double> values(8);
     std::vector<data_type> cellGradients(3*numberOfInputComponents);
@@ -39,6 +39,12 @@
  * the entire data set. For Patch or DataSetMax it is possible that some values
  * will not be computed. The ReplacementValueOption specifies what to use
  * for these values.
+ *
+ * For unstructured grids and polydata, the point and cell gradients are
+ * computed with vtkSMPTools when more than one thread is available. The
+ * point-to-cell links are then built once with vtkStaticCellLinksTemplate
+ * and each point gathers the derivatives of its cells, so the result is the
+ * same as the serial one.
 */
 
 #ifndef vtkGradientFilter_h
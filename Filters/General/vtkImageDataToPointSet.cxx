@@ -25,19 +25,24 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkStructuredGrid.h"
+#include "vtkStructuredPointArray.h"
 
 #include "vtkNew.h"
 
 vtkStandardNewMacro(vtkImageDataToPointSet);
 
 //-------------------------------------------------------------------------
-vtkImageDataToPointSet::vtkImageDataToPointSet() = default;
+vtkImageDataToPointSet::vtkImageDataToPointSet()
+  : ImplicitPoints(false)
+{
+}
 
 vtkImageDataToPointSet::~vtkImageDataToPointSet() = default;
 
 void vtkImageDataToPointSet::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ImplicitPoints: " << this->ImplicitPoints << endl;
 }
 
 //-------------------------------------------------------------------------
@@ -69,6 +74,24 @@ int vtkImageDataToPointSet::CopyStructure(vtkStructuredGrid *outData,
 
   vtkNew<vtkPoints> points;
   points->SetDataTypeToDouble();
+
+  if (this->ImplicitPoints)
+  {
+    vtkStructuredPointBackend<double> backend;
+    for (int axis = 0; axis < 3; axis++)
+    {
+      backend.SetUniformAxis(axis, extent[2*axis], extent[2*axis+1],
+                             origin[axis], spacing[axis]);
+    }
+    vtkNew<vtkStructuredPointArray<double> > coords;
+    coords->SetNumberOfComponents(3);
+    coords->SetNumberOfTuples(inData->GetNumberOfPoints());
+    coords->SetBackend(backend);
+    points->SetData(coords);
+    outData->SetPoints(points);
+    return 1;
+  }
+
   points->SetNumberOfPoints(inData->GetNumberOfPoints());
 
   vtkIdType pointId = 0;
@@ -47,6 +47,17 @@ public:
 
   static vtkImageDataToPointSet *New();
 
+  //@{
+  /**
+   * Set/Get the flag which controls whether the output points are stored
+   * or computed on demand by a vtkStructuredPointArray<double>, which only
+   * stores the coordinates along each axis. Default is off.
+   */
+  vtkSetMacro(ImplicitPoints, bool);
+  vtkGetMacro(ImplicitPoints, bool);
+  vtkBooleanMacro(ImplicitPoints, bool);
+  //@}
+
 protected:
   vtkImageDataToPointSet();
   ~vtkImageDataToPointSet() override;
@@ -57,6 +68,8 @@ protected:
 
   int FillInputPortInformation(int port, vtkInformation *info) override;
 
+  bool ImplicitPoints;
+
 private:
   vtkImageDataToPointSet(const vtkImageDataToPointSet &) = delete;
   void operator=(const vtkImageDataToPointSet &) = delete;
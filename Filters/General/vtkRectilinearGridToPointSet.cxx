@@ -25,19 +25,24 @@
 #include "vtkPointData.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkStructuredGrid.h"
+#include "vtkStructuredPointArray.h"
 
 #include "vtkNew.h"
 
 vtkStandardNewMacro(vtkRectilinearGridToPointSet);
 
 //-------------------------------------------------------------------------
-vtkRectilinearGridToPointSet::vtkRectilinearGridToPointSet() = default;
+vtkRectilinearGridToPointSet::vtkRectilinearGridToPointSet()
+  : ImplicitPoints(false)
+{
+}
 
 vtkRectilinearGridToPointSet::~vtkRectilinearGridToPointSet() = default;
 
 void vtkRectilinearGridToPointSet::PrintSelf(ostream &os, vtkIndent indent)
 {
   this->Superclass::PrintSelf(os, indent);
+  os << indent << "ImplicitPoints: " << this->ImplicitPoints << endl;
 }
 
 //-------------------------------------------------------------------------
@@ -67,6 +72,22 @@ int vtkRectilinearGridToPointSet::CopyStructure(vtkStructuredGrid *outData,
 
   vtkNew<vtkPoints> points;
   points->SetDataTypeToDouble();
+
+  if (this->ImplicitPoints)
+  {
+    vtkStructuredPointBackend<double> backend;
+    backend.SetAxis(0, xcoord);
+    backend.SetAxis(1, ycoord);
+    backend.SetAxis(2, zcoord);
+    vtkNew<vtkStructuredPointArray<double> > coords;
+    coords->SetNumberOfComponents(3);
+    coords->SetNumberOfTuples(inData->GetNumberOfPoints());
+    coords->SetBackend(backend);
+    points->SetData(coords);
+    outData->SetPoints(points);
+    return 1;
+  }
+
   points->SetNumberOfPoints(inData->GetNumberOfPoints());
 
   vtkIdType pointId = 0;
@@ -48,6 +48,17 @@ public:
 
   static vtkRectilinearGridToPointSet *New();
 
+  //@{
+  /**
+   * Set/Get the flag which controls whether the output points are stored
+   * or computed on demand by a vtkStructuredPointArray<double>, which only
+   * stores the coordinates along each axis. Default is off.
+   */
+  vtkSetMacro(ImplicitPoints, bool);
+  vtkGetMacro(ImplicitPoints, bool);
+  vtkBooleanMacro(ImplicitPoints, bool);
+  //@}
+
 protected:
   vtkRectilinearGridToPointSet();
   ~vtkRectilinearGridToPointSet() override;
@@ -58,6 +69,8 @@ protected:
 
   int FillInputPortInformation(int port, vtkInformation *info) override;
 
+  bool ImplicitPoints;
+
 private:
   vtkRectilinearGridToPointSet(const vtkRectilinearGridToPointSet &) = delete;
   void operator=(const vtkRectilinearGridToPointSet &) = delete;
@@ -57,9 +57,23 @@
 #include "vtkRectilinearGrid.h"
 #include "vtkUnstructuredGrid.h"
 #include "vtkGenericCell.h"
+#include "vtkArrayDispatch.h"
+#include "vtkDataArrayAccessor.h"
+#include "vtkIdList.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkSMPTools.h"
+#include "vtkStaticEdgeLocatorTemplate.h"
+#include "vtkUnsignedCharArray.h"
 
 #include "vtkTableBasedClipCases.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
 vtkStandardNewMacro( vtkTableBasedClipDataSet );
 vtkCxxSetObjectMacro( vtkTableBasedClipDataSet, ClipFunction, vtkImplicitFunction );
 
@@ -1183,6 +1197,24 @@ void vtkTableBasedClipperVertexList::AddVertex( int cellId, int v1 )
   currentShape ++;
 }
 
+// The data type of the output points for the given precision.
+static int GetOutputPointsDataType( int precision, vtkDataSet * input )
+{
+  if ( precision == vtkAlgorithm::DEFAULT_PRECISION )
+  {
+    vtkPointSet * inputPointSet = vtkPointSet::SafeDownCast( input );
+    if ( inputPointSet )
+    {
+      return inputPointSet->GetPoints()->GetDataType();
+    }
+  }
+  else if ( precision == vtkAlgorithm::DOUBLE_PRECISION )
+  {
+    return VTK_DOUBLE;
+  }
+  return VTK_FLOAT;
+}
+
 void vtkTableBasedClipperVolumeFromVolume::
      ConstructDataSet( vtkDataSet * input,
                        vtkUnstructuredGrid * output, double * pts_ptr )
@@ -1272,26 +1304,8 @@ void vtkTableBasedClipperVolumeFromVolume::
   vtkPoints * outPts = vtkPoints::New();
 
   // set precision for the points in the output
-  if(this->OutputPointsPrecision == vtkAlgorithm::DEFAULT_PRECISION)
-  {
-    vtkPointSet *inputPointSet = vtkPointSet::SafeDownCast(input);
-    if(inputPointSet)
-    {
-      outPts->SetDataType(inputPointSet->GetPoints()->GetDataType());
-    }
-    else
-    {
-      outPts->SetDataType(VTK_FLOAT);
-    }
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::SINGLE_PRECISION)
-  {
-    outPts->SetDataType(VTK_FLOAT);
-  }
-  else if(this->OutputPointsPrecision == vtkAlgorithm::DOUBLE_PRECISION)
-  {
-    outPts->SetDataType(VTK_DOUBLE);
-  }
+  outPts->SetDataType(
+    GetOutputPointsDataType( this->OutputPointsPrecision, input ) );
 
   int centroidStart  = numUsed + pt_list.GetTotalNumberOfPoints();
   int nOutPts        = centroidStart + centroid_list.GetTotalNumberOfPoints();
@@ -1579,6 +1593,1064 @@ inline void GetPoint( double * pt, const double * X, const double * Y,
 // =============== vtkTableBasedClipperVolumeFromVolume ( end ) ===============
 // ============================================================================
 
+// ============================================================================
+// ========================= Parallel clipping (begin) ========================
+// ============================================================================
+
+namespace
+{
+
+// The cells are processed by chunks of CLIP_CHUNK_SIZE cells. Each chunk is
+// counted, then emitted, by a single thread, so that the output can be laid
+// out in the order of the serial algorithm.
+const vtkIdType CLIP_CHUNK_SIZE = 1024;
+
+// The output shapes are grouped by type, in the order of the shape lists of
+// vtkTableBasedClipperVolumeFromVolume.
+enum ClipShapeGroup
+{
+  CLIP_TETS = 0,
+  CLIP_PYRAMIDS,
+  CLIP_WEDGES,
+  CLIP_HEXES,
+  CLIP_QUADS,
+  CLIP_TRIS,
+  CLIP_LINES,
+  CLIP_VERTICES,
+  CLIP_NUMBER_OF_GROUPS
+};
+
+const int ClipGroupSizes[CLIP_NUMBER_OF_GROUPS] = { 4, 5, 6, 8, 4, 3, 2, 1 };
+const unsigned char ClipGroupTypes[CLIP_NUMBER_OF_GROUPS] = {
+  VTK_TETRA, VTK_PYRAMID, VTK_WEDGE, VTK_HEXAHEDRON, VTK_QUAD, VTK_TRIANGLE,
+  VTK_LINE, VTK_VERTEX };
+
+typedef const int ClipEdgeVertices[2];
+
+// A reference to an edge point: the edge (V0 < V1), the position of the
+// reference in the serial order (EId) and the weight of V0.
+typedef MergeTuple<vtkIdType, double> ClipEdgeTuple;
+
+// The clip case of a cell: its points, their clip values minus the iso
+// value, and the entry of the clip tables.
+struct ClipCellCase
+{
+  vtkIdType PtIds[8];
+  double Diffs[8];
+  const unsigned char *Shapes;
+  int NumberOfShapes;
+  ClipEdgeVertices *EdgeVertices;
+};
+
+// Compute the index of the clip case, as the serial code does.
+inline int GetClipCaseIndex(const double *diffs, int npts)
+{
+  int caseIndx = 0;
+  for (int j = npts - 1; j >= 0; j--)
+  {
+    caseIndx += ((diffs[j] >= 0.0) ? 1 : 0);
+    caseIndx <<= (1 - (!j));
+  }
+  return caseIndx;
+}
+
+// The cells of an unstructured grid.
+struct ClipUnstructuredCells
+{
+  const unsigned char *Types;
+  const vtkIdType *Offsets;
+  const vtkIdType *Connectivity;
+
+  // Set up the case of a cell. Return false if the cell cannot be clipped
+  // with the tables.
+  bool GetCase(vtkIdType cellId, const double *pointDiffs,
+               ClipCellCase &cell) const
+  {
+    const vtkIdType offset = this->Offsets[cellId];
+    const vtkIdType npts = this->Offsets[cellId + 1] - offset;
+    const int cellType = this->Types[cellId];
+    vtkIdType expected = 0;
+    switch (cellType)
+    {
+      case VTK_TETRA: expected = 4; break;
+      case VTK_PYRAMID: expected = 5; break;
+      case VTK_WEDGE: expected = 6; break;
+      case VTK_HEXAHEDRON: case VTK_VOXEL: expected = 8; break;
+      case VTK_TRIANGLE: expected = 3; break;
+      case VTK_QUAD: case VTK_PIXEL: expected = 4; break;
+      case VTK_LINE: expected = 2; break;
+      case VTK_VERTEX: expected = 1; break;
+      default: return false;
+    }
+    if (npts != expected)
+    {
+      return false;
+    }
+
+    const vtkIdType *ptIds = this->Connectivity + offset;
+    for (vtkIdType j = 0; j < npts; ++j)
+    {
+      cell.PtIds[j] = ptIds[j];
+      cell.Diffs[j] = pointDiffs[ptIds[j]];
+    }
+    const int caseIndx = GetClipCaseIndex(cell.Diffs, static_cast<int>(npts));
+
+    using namespace vtkTableBasedClipperClipTables;
+    using namespace vtkTableBasedClipperTriangulationTables;
+    switch (cellType)
+    {
+      case VTK_TETRA:
+        cell.Shapes = &ClipShapesTet[StartClipShapesTet[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesTet[caseIndx];
+        cell.EdgeVertices = TetVerticesFromEdges;
+        break;
+      case VTK_PYRAMID:
+        cell.Shapes = &ClipShapesPyr[StartClipShapesPyr[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesPyr[caseIndx];
+        cell.EdgeVertices = PyramidVerticesFromEdges;
+        break;
+      case VTK_WEDGE:
+        cell.Shapes = &ClipShapesWdg[StartClipShapesWdg[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesWdg[caseIndx];
+        cell.EdgeVertices = WedgeVerticesFromEdges;
+        break;
+      case VTK_HEXAHEDRON:
+        cell.Shapes = &ClipShapesHex[StartClipShapesHex[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesHex[caseIndx];
+        cell.EdgeVertices = HexVerticesFromEdges;
+        break;
+      case VTK_VOXEL:
+        cell.Shapes = &ClipShapesVox[StartClipShapesVox[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesVox[caseIndx];
+        cell.EdgeVertices = VoxVerticesFromEdges;
+        break;
+      case VTK_TRIANGLE:
+        cell.Shapes = &ClipShapesTri[StartClipShapesTri[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesTri[caseIndx];
+        cell.EdgeVertices = TriVerticesFromEdges;
+        break;
+      case VTK_QUAD:
+        cell.Shapes = &ClipShapesQua[StartClipShapesQua[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesQua[caseIndx];
+        cell.EdgeVertices = QuadVerticesFromEdges;
+        break;
+      case VTK_PIXEL:
+        cell.Shapes = &ClipShapesPix[StartClipShapesPix[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesPix[caseIndx];
+        cell.EdgeVertices = PixelVerticesFromEdges;
+        break;
+      case VTK_LINE:
+        cell.Shapes = &ClipShapesLin[StartClipShapesLin[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesLin[caseIndx];
+        cell.EdgeVertices = LineVerticesFromEdges;
+        break;
+      case VTK_VERTEX:
+        cell.Shapes = &ClipShapesVtx[StartClipShapesVtx[caseIndx]];
+        cell.NumberOfShapes = NumClipShapesVtx[caseIndx];
+        cell.EdgeVertices = nullptr;
+        break;
+    }
+    return true;
+  }
+};
+
+// The cells of a structured or rectilinear grid, numbered as in the serial
+// code: hexahedra, or quads for 2D grids.
+struct ClipStructuredCells
+{
+  bool IsTwoDim;
+  const int *ShiftLUT[3];
+  int CellDims[3];
+  vtkIdType CyStride;
+  vtkIdType CzStride;
+  vtkIdType PyStride;
+  vtkIdType PzStride;
+
+  bool GetCase(vtkIdType cellId, const double *pointDiffs,
+               ClipCellCase &cell) const
+  {
+    const int nCellPts = this->IsTwoDim ? 4 : 8;
+    const vtkIdType theCellI =
+      (this->CellDims[0] > 0 ? cellId % this->CellDims[0] : 0);
+    const vtkIdType theCellJ =
+      (this->CellDims[1] > 0 ? (cellId / this->CyStride) % this->CellDims[1] : 0);
+    const vtkIdType theCellK =
+      (this->CellDims[2] > 0 ? (cellId / this->CzStride) : 0);
+    for (int j = 0; j < nCellPts; ++j)
+    {
+      const vtkIdType ptId = (theCellI + this->ShiftLUT[0][j]) +
+        (theCellJ + this->ShiftLUT[1][j]) * this->PyStride +
+        (theCellK + this->ShiftLUT[2][j]) * this->PzStride;
+      cell.PtIds[j] = ptId;
+      cell.Diffs[j] = pointDiffs[ptId];
+    }
+    const int caseIndx = GetClipCaseIndex(cell.Diffs, nCellPts);
+
+    using namespace vtkTableBasedClipperClipTables;
+    if (this->IsTwoDim)
+    {
+      cell.Shapes = &ClipShapesQua[StartClipShapesQua[caseIndx]];
+      cell.NumberOfShapes = NumClipShapesQua[caseIndx];
+    }
+    else
+    {
+      cell.Shapes = &ClipShapesHex[StartClipShapesHex[caseIndx]];
+      cell.NumberOfShapes = NumClipShapesHex[caseIndx];
+    }
+    cell.EdgeVertices =
+      vtkTableBasedClipperTriangulationTables::HexVerticesFromEdges;
+    return true;
+  }
+};
+
+// Walk the outputs of the case of a cell, as the serial Clip*Data() methods
+// do, and report the kept shapes, the points on edges and the centroid
+// points to the visitor.
+template <typename VisitorT>
+void ClipCell(const ClipCellCase &cell, bool insideOut, VisitorT &visitor)
+{
+  const unsigned char *thisCase = cell.Shapes;
+  vtkIdType intrpIds[4];
+  for (int j = 0; j < cell.NumberOfShapes; ++j)
+  {
+    int nCellPts = 0;
+    int theColor = -1;
+    int intrpIdx = -1;
+    int group = -1;
+    unsigned char theShape = *thisCase++;
+    switch (theShape)
+    {
+      case ST_HEX: nCellPts = 8; group = CLIP_HEXES; break;
+      case ST_WDG: nCellPts = 6; group = CLIP_WEDGES; break;
+      case ST_PYR: nCellPts = 5; group = CLIP_PYRAMIDS; break;
+      case ST_TET: nCellPts = 4; group = CLIP_TETS; break;
+      case ST_QUA: nCellPts = 4; group = CLIP_QUADS; break;
+      case ST_TRI: nCellPts = 3; group = CLIP_TRIS; break;
+      case ST_LIN: nCellPts = 2; group = CLIP_LINES; break;
+      case ST_VTX: nCellPts = 1; group = CLIP_VERTICES; break;
+      case ST_PNT:
+        intrpIdx = *thisCase++;
+        theColor = *thisCase++;
+        nCellPts = *thisCase++;
+        break;
+      default:
+        break;
+    }
+    if (group >= 0)
+    {
+      theColor = *thisCase++;
+    }
+
+    if ((!insideOut && theColor == COLOR0) ||
+        (insideOut && theColor == COLOR1))
+    {
+      // We don't want this one; it's the wrong side.
+      thisCase += nCellPts;
+      continue;
+    }
+
+    vtkIdType shapeIds[8];
+    for (int p = 0; p < nCellPts; ++p)
+    {
+      unsigned char pntIndex = *thisCase++;
+      if (pntIndex <= P7)
+      {
+        shapeIds[p] = cell.PtIds[pntIndex];
+      }
+      else if (pntIndex >= EA && pntIndex <= EL)
+      {
+        int pt1Index = cell.EdgeVertices[pntIndex - EA][0];
+        int pt2Index = cell.EdgeVertices[pntIndex - EA][1];
+        if (pt2Index < pt1Index)
+        {
+          std::swap(pt1Index, pt2Index);
+        }
+        double pt1ToPt2 = cell.Diffs[pt2Index] - cell.Diffs[pt1Index];
+        double pt1ToIso = 0.0 - cell.Diffs[pt1Index];
+        double p1Weight = 1.0 - pt1ToIso / pt1ToPt2;
+        shapeIds[p] = visitor.AddEdgePoint(
+          cell.PtIds[pt1Index], cell.PtIds[pt2Index], p1Weight);
+      }
+      else if (pntIndex >= N0 && pntIndex <= N3)
+      {
+        shapeIds[p] = intrpIds[pntIndex - N0];
+      }
+    }
+
+    if (group >= 0)
+    {
+      visitor.AddShape(group, shapeIds);
+    }
+    else if (theShape == ST_PNT)
+    {
+      intrpIds[intrpIdx] = visitor.AddCentroidPoint(nCellPts, shapeIds);
+    }
+  }
+}
+
+// The number of outputs of a chunk of cells.
+struct ClipCounts
+{
+  vtkIdType Shapes[CLIP_NUMBER_OF_GROUPS];
+  vtkIdType Edges;
+  vtkIdType Centroids;
+};
+
+struct ClipCountVisitor
+{
+  ClipCounts *Counts;
+
+  vtkIdType AddEdgePoint(vtkIdType, vtkIdType, double)
+  {
+    return this->Counts->Edges++;
+  }
+  vtkIdType AddCentroidPoint(int, const vtkIdType *)
+  {
+    return this->Counts->Centroids++;
+  }
+  void AddShape(int group, const vtkIdType *)
+  {
+    this->Counts->Shapes[group]++;
+  }
+};
+
+// Count the outputs of each chunk of cells.
+template <typename CellsT>
+struct ClipCountCells
+{
+  const CellsT *Cells;
+  const double *Diffs;
+  vtkIdType NumberOfCells;
+  bool InsideOut;
+  ClipCounts *ChunkCounts;
+  std::atomic<bool> *Unsupported;
+
+  void operator()(vtkIdType beginChunk, vtkIdType endChunk) const
+  {
+    ClipCellCase cell;
+    for (vtkIdType chunk = beginChunk; chunk < endChunk; ++chunk)
+    {
+      ClipCountVisitor visitor = { this->ChunkCounts + chunk };
+      const vtkIdType begin = chunk * CLIP_CHUNK_SIZE;
+      const vtkIdType end = std::min(begin + CLIP_CHUNK_SIZE, this->NumberOfCells);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        if (!this->Cells->GetCase(cellId, this->Diffs, cell))
+        {
+          *this->Unsupported = true;
+          return;
+        }
+        ClipCell(cell, this->InsideOut, visitor);
+      }
+    }
+  }
+};
+
+// The outputs of the cells, before the points are merged and numbered.
+// The point references are the ones of the serial algorithm: input point
+// ids, NumberOfPoints + the index of an edge reference, or -1 - the index of
+// a centroid point.
+struct ClipStreams
+{
+  vtkIdType NumberOfPoints;
+  const vtkIdType *GroupStarts;
+  const vtkIdType *ConnectivityStarts;
+  vtkIdType *CellIds;
+  vtkIdType *Connectivity;
+  ClipEdgeTuple *Edges;
+  int *CentroidSizes;
+  vtkIdType *CentroidIds;
+};
+
+struct ClipEmitVisitor
+{
+  const ClipStreams *Streams;
+  vtkIdType CellId;
+  vtkIdType NextCellIds[CLIP_NUMBER_OF_GROUPS];
+  vtkIdType NextEdge;
+  vtkIdType NextCentroid;
+
+  vtkIdType AddEdgePoint(vtkIdType p1, vtkIdType p2, double percent)
+  {
+    ClipEdgeTuple &edge = this->Streams->Edges[this->NextEdge];
+    if (p2 < p1)
+    {
+      edge.V0 = p2;
+      edge.V1 = p1;
+      edge.T = 1.0 - percent;
+    }
+    else
+    {
+      edge.V0 = p1;
+      edge.V1 = p2;
+      edge.T = percent;
+    }
+    edge.EId = this->NextEdge;
+    return this->Streams->NumberOfPoints + this->NextEdge++;
+  }
+
+  vtkIdType AddCentroidPoint(int npts, const vtkIdType *ptIds)
+  {
+    this->Streams->CentroidSizes[this->NextCentroid] = npts;
+    std::copy(ptIds, ptIds + npts,
+              this->Streams->CentroidIds + 8 * this->NextCentroid);
+    return -1 - this->NextCentroid++;
+  }
+
+  void AddShape(int group, const vtkIdType *ptIds)
+  {
+    const vtkIdType newCellId = this->NextCellIds[group]++;
+    const int size = ClipGroupSizes[group];
+    this->Streams->CellIds[newCellId] = this->CellId;
+    std::copy(ptIds, ptIds + size, this->Streams->Connectivity +
+      this->Streams->ConnectivityStarts[group] +
+      (newCellId - this->Streams->GroupStarts[group]) * size);
+  }
+};
+
+// Emit the outputs of each chunk of cells at the positions given by the
+// scan of the counts.
+template <typename CellsT>
+struct ClipEmitCells
+{
+  const CellsT *Cells;
+  const double *Diffs;
+  vtkIdType NumberOfCells;
+  bool InsideOut;
+  const ClipCounts *ChunkStarts;
+  const ClipStreams *Streams;
+
+  void operator()(vtkIdType beginChunk, vtkIdType endChunk) const
+  {
+    ClipCellCase cell;
+    for (vtkIdType chunk = beginChunk; chunk < endChunk; ++chunk)
+    {
+      const ClipCounts &start = this->ChunkStarts[chunk];
+      ClipEmitVisitor visitor;
+      visitor.Streams = this->Streams;
+      for (int g = 0; g < CLIP_NUMBER_OF_GROUPS; ++g)
+      {
+        visitor.NextCellIds[g] = this->Streams->GroupStarts[g] + start.Shapes[g];
+      }
+      visitor.NextEdge = start.Edges;
+      visitor.NextCentroid = start.Centroids;
+      const vtkIdType begin = chunk * CLIP_CHUNK_SIZE;
+      const vtkIdType end = std::min(begin + CLIP_CHUNK_SIZE, this->NumberOfCells);
+      for (vtkIdType cellId = begin; cellId < end; ++cellId)
+      {
+        this->Cells->GetCase(cellId, this->Diffs, cell);
+        visitor.CellId = cellId;
+        ClipCell(cell, this->InsideOut, visitor);
+      }
+    }
+  }
+};
+
+// Compute the clip values minus the iso value of the points.
+template <typename ArrayT>
+struct ClipComputeDiffs
+{
+  ArrayT *Array;
+  double IsoValue;
+  double *Diffs;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkDataArrayAccessor<ArrayT> values(this->Array);
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Diffs[i] = values.Get(i, 0) - this->IsoValue;
+    }
+  }
+};
+
+struct ClipComputeDiffsWorker
+{
+  double IsoValue;
+  double *Diffs;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *array)
+  {
+    ClipComputeDiffs<ArrayT> functor = { array, this->IsoValue, this->Diffs };
+    vtkSMPTools::For(0, array->GetNumberOfTuples(), functor);
+  }
+};
+
+// Among the references to each unique edge, the first one in the serial
+// order defines the edge point: flag it.
+struct ClipMarkFirstEdges
+{
+  const ClipEdgeTuple *Edges;
+  const vtkIdType *GroupOffsets;
+  vtkIdType *IsFirst;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType group = begin; group < end; ++group)
+    {
+      vtkIdType first = this->Edges[this->GroupOffsets[group]].EId;
+      for (vtkIdType i = this->GroupOffsets[group] + 1;
+           i < this->GroupOffsets[group + 1]; ++i)
+      {
+        first = std::min(first, this->Edges[i].EId);
+      }
+      this->IsFirst[first] = 1;
+    }
+  }
+};
+
+// Number the unique edges in the order of their first reference, and
+// record their end points and the weight of their first point.
+struct ClipNumberEdges
+{
+  const ClipEdgeTuple *Edges;
+  const vtkIdType *GroupOffsets;
+  const vtkIdType *IsFirst; // After the exclusive scan: the new edge ids
+  vtkIdType *RefToEdge;
+  vtkIdType *EdgeEnds;
+  double *EdgePercents;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType group = begin; group < end; ++group)
+    {
+      const ClipEdgeTuple *first = this->Edges + this->GroupOffsets[group];
+      for (vtkIdType i = this->GroupOffsets[group] + 1;
+           i < this->GroupOffsets[group + 1]; ++i)
+      {
+        if (this->Edges[i].EId < first->EId)
+        {
+          first = this->Edges + i;
+        }
+      }
+      const vtkIdType edgeId = this->IsFirst[first->EId];
+      this->EdgeEnds[2 * edgeId] = first->V0;
+      this->EdgeEnds[2 * edgeId + 1] = first->V1;
+      this->EdgePercents[edgeId] = first->T;
+      for (vtkIdType i = this->GroupOffsets[group];
+           i < this->GroupOffsets[group + 1]; ++i)
+      {
+        this->RefToEdge[this->Edges[i].EId] = edgeId;
+      }
+    }
+  }
+};
+
+// Record, for each input point, the position of its first occurrence in
+// the output connectivity. The used input points are numbered in that
+// order, which is the one of the serial algorithm.
+struct ClipFindFirstUses
+{
+  const vtkIdType *Connectivity;
+  vtkIdType NumberOfPoints;
+  std::atomic<vtkIdType> *FirstUse;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType position = begin; position < end; ++position)
+    {
+      const vtkIdType ptId = this->Connectivity[position];
+      if (ptId < 0 || ptId >= this->NumberOfPoints)
+      {
+        continue;
+      }
+      vtkIdType first = this->FirstUse[ptId].load(std::memory_order_relaxed);
+      while (position < first &&
+             !this->FirstUse[ptId].compare_exchange_weak(
+               first, position, std::memory_order_relaxed))
+      {
+      }
+    }
+  }
+};
+
+struct ClipMarkFirstUses
+{
+  const vtkIdType *Connectivity;
+  vtkIdType NumberOfPoints;
+  const std::atomic<vtkIdType> *FirstUse;
+  vtkIdType *IsFirstUse;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType position = begin; position < end; ++position)
+    {
+      const vtkIdType ptId = this->Connectivity[position];
+      this->IsFirstUse[position] = (ptId >= 0 && ptId < this->NumberOfPoints &&
+        this->FirstUse[ptId] == position) ? 1 : 0;
+    }
+  }
+};
+
+struct ClipMapPoints
+{
+  const std::atomic<vtkIdType> *FirstUse;
+  const vtkIdType *NewPointIds;
+  vtkIdType *PointMap;
+  vtkIdType *OldPointIds;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      const vtkIdType first = this->FirstUse[ptId];
+      if (first == VTK_ID_MAX)
+      {
+        this->PointMap[ptId] = -1;
+      }
+      else
+      {
+        const vtkIdType newPtId = this->NewPointIds[first];
+        this->PointMap[ptId] = newPtId;
+        this->OldPointIds[newPtId] = ptId;
+      }
+    }
+  }
+};
+
+// Replace the point references by the output point ids: the used input
+// points first, then the edge points and the centroid points.
+struct ClipRenumberPoints
+{
+  vtkIdType NumberOfPoints;
+  vtkIdType NumberOfUsedPoints;
+  vtkIdType CentroidStart;
+  const vtkIdType *PointMap;
+  const vtkIdType *RefToEdge;
+  vtkIdType *Ids;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType ref = this->Ids[i];
+      if (ref < 0)
+      {
+        this->Ids[i] = this->CentroidStart - 1 - ref;
+      }
+      else if (ref >= this->NumberOfPoints)
+      {
+        this->Ids[i] = this->NumberOfUsedPoints +
+          this->RefToEdge[ref - this->NumberOfPoints];
+      }
+      else
+      {
+        this->Ids[i] = this->PointMap[ref];
+      }
+    }
+  }
+};
+
+// Copy the used input points and compute the edge points, as
+// vtkTableBasedClipperVolumeFromVolume::ConstructDataSet() does.
+template <typename ArrayT>
+struct ClipGatherPoints
+{
+  ArrayT *Points;
+  const TableBasedClipperCommonPointsStructure *Cps;
+  const vtkIdType *OldPointIds;
+  vtkIdType NumberOfUsedPoints;
+  const vtkIdType *EdgeEnds;
+  const double *EdgePercents;
+
+  void GetInputPoint(vtkIdType ptId, double *pt) const
+  {
+    if (this->Cps->hasPtsList)
+    {
+      const double *p = this->Cps->pts_ptr + 3 * ptId;
+      pt[0] = p[0];
+      pt[1] = p[1];
+      pt[2] = p[2];
+    }
+    else
+    {
+      const int *dims = this->Cps->dims;
+      pt[0] = this->Cps->X[ptId % dims[0]];
+      pt[1] = this->Cps->Y[(ptId / dims[0]) % dims[1]];
+      pt[2] = this->Cps->Z[ptId / (static_cast<vtkIdType>(dims[0]) * dims[1])];
+    }
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    typedef typename vtkDataArrayAccessor<ArrayT>::APIType ValueType;
+    vtkDataArrayAccessor<ArrayT> points(this->Points);
+    double pt[3];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      if (i < this->NumberOfUsedPoints)
+      {
+        this->GetInputPoint(this->OldPointIds[i], pt);
+      }
+      else
+      {
+        const vtkIdType edgeId = i - this->NumberOfUsedPoints;
+        double pt1[3];
+        double pt2[3];
+        this->GetInputPoint(this->EdgeEnds[2 * edgeId], pt1);
+        this->GetInputPoint(this->EdgeEnds[2 * edgeId + 1], pt2);
+        const double p = this->EdgePercents[edgeId];
+        const double bp = 1.0 - p;
+        pt[0] = pt1[0] * p + pt2[0] * bp;
+        pt[1] = pt1[1] * p + pt2[1] * bp;
+        pt[2] = pt1[2] * p + pt2[2] * bp;
+      }
+      for (int c = 0; c < 3; ++c)
+      {
+        points.Set(i, c, static_cast<ValueType>(pt[c]));
+      }
+    }
+  }
+};
+
+struct ClipGatherPointsWorker
+{
+  const TableBasedClipperCommonPointsStructure *Cps;
+  const vtkIdType *OldPointIds;
+  vtkIdType NumberOfUsedPoints;
+  const vtkIdType *EdgeEnds;
+  const double *EdgePercents;
+  vtkIdType NumberOfPoints;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *points)
+  {
+    ClipGatherPoints<ArrayT> functor = { points, this->Cps, this->OldPointIds,
+      this->NumberOfUsedPoints, this->EdgeEnds, this->EdgePercents };
+    vtkSMPTools::For(0, this->NumberOfPoints, functor);
+  }
+};
+
+// Convert the input points to doubles.
+template <typename ArrayT>
+struct ClipConvertPoints
+{
+  ArrayT *Points;
+  double *Coordinates;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkDataArrayAccessor<ArrayT> points(this->Points);
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      for (int c = 0; c < 3; ++c)
+      {
+        this->Coordinates[3 * i + c] = points.Get(i, c);
+      }
+    }
+  }
+};
+
+struct ClipConvertPointsWorker
+{
+  double *Coordinates;
+
+  template <typename ArrayT>
+  void operator()(ArrayT *points)
+  {
+    ClipConvertPoints<ArrayT> functor = { points, this->Coordinates };
+    vtkSMPTools::For(0, points->GetNumberOfTuples(), functor);
+  }
+};
+
+// The offsets, locations and types of the output cells of a group.
+struct ClipBuildCells
+{
+  vtkIdType GroupStart;
+  vtkIdType ConnectivityStart;
+  int Size;
+  unsigned char Type;
+  vtkIdType *Offsets;
+  vtkIdType *Locations;
+  unsigned char *Types;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      const vtkIdType offset = this->ConnectivityStart +
+        (cellId - this->GroupStart) * this->Size;
+      this->Offsets[cellId] = offset;
+      this->Locations[cellId] = offset + cellId;
+      this->Types[cellId] = this->Type;
+    }
+  }
+};
+
+// Clip the cells in parallel and build the output. This produces the same
+// output as the serial Clip*Data() methods followed by ConstructDataSet().
+// Return false, without touching the output, if a cell cannot be clipped
+// with the tables: the caller then takes the serial path, which hands such
+// cells to vtkClipDataSet.
+template <typename CellsT>
+bool ClipCellsInParallel(const CellsT &cells, vtkIdType numCells,
+  vtkDataSet *input, vtkDataArray *clipArray, double isoValue, bool insideOut,
+  int pointsType, const TableBasedClipperCommonPointsStructure &cps,
+  vtkUnstructuredGrid *output)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+
+  // The clip values of the points.
+  std::vector<double> diffs(numPts);
+  ClipComputeDiffsWorker diffsWorker = { isoValue, diffs.data() };
+  if (!vtkArrayDispatch::Dispatch::Execute(clipArray, diffsWorker))
+  {
+    diffsWorker(clipArray);
+  }
+
+  // Count the outputs of each chunk of cells, then compute where each chunk
+  // writes them.
+  const vtkIdType numChunks = (numCells + CLIP_CHUNK_SIZE - 1) / CLIP_CHUNK_SIZE;
+  std::vector<ClipCounts> chunkCounts(numChunks + 1);
+  std::memset(chunkCounts.data(), 0, sizeof(ClipCounts) * (numChunks + 1));
+  std::atomic<bool> unsupported(false);
+  ClipCountCells<CellsT> count = { &cells, diffs.data(), numCells, insideOut,
+                                   chunkCounts.data(), &unsupported };
+  vtkSMPTools::For(0, numChunks, count);
+  if (unsupported)
+  {
+    return false;
+  }
+
+  ClipCounts total;
+  std::memset(&total, 0, sizeof(ClipCounts));
+  for (vtkIdType chunk = 0; chunk <= numChunks; ++chunk)
+  {
+    ClipCounts chunkCount = chunkCounts[chunk];
+    chunkCounts[chunk] = total;
+    for (int g = 0; g < CLIP_NUMBER_OF_GROUPS; ++g)
+    {
+      total.Shapes[g] += chunkCount.Shapes[g];
+    }
+    total.Edges += chunkCount.Edges;
+    total.Centroids += chunkCount.Centroids;
+  }
+  vtkIdType groupStarts[CLIP_NUMBER_OF_GROUPS + 1];
+  vtkIdType connectivityStarts[CLIP_NUMBER_OF_GROUPS + 1];
+  groupStarts[0] = 0;
+  connectivityStarts[0] = 0;
+  for (int g = 0; g < CLIP_NUMBER_OF_GROUPS; ++g)
+  {
+    groupStarts[g + 1] = groupStarts[g] + total.Shapes[g];
+    connectivityStarts[g + 1] =
+      connectivityStarts[g] + total.Shapes[g] * ClipGroupSizes[g];
+  }
+  const vtkIdType numNewCells = groupStarts[CLIP_NUMBER_OF_GROUPS];
+  const vtkIdType connectivitySize = connectivityStarts[CLIP_NUMBER_OF_GROUPS];
+  const vtkIdType numEdgeRefs = total.Edges;
+  const vtkIdType numCentroids = total.Centroids;
+
+  // Emit the cells, with the point references of the serial algorithm.
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(connectivitySize);
+  std::vector<vtkIdType> oldCellIds(numNewCells);
+  std::vector<ClipEdgeTuple> edges(numEdgeRefs);
+  std::vector<int> centroidSizes(numCentroids);
+  std::vector<vtkIdType> centroidIds(8 * numCentroids);
+  ClipStreams streams;
+  streams.NumberOfPoints = numPts;
+  streams.GroupStarts = groupStarts;
+  streams.ConnectivityStarts = connectivityStarts;
+  streams.CellIds = oldCellIds.data();
+  streams.Connectivity = connectivity->GetPointer(0);
+  streams.Edges = edges.data();
+  streams.CentroidSizes = centroidSizes.data();
+  streams.CentroidIds = centroidIds.data();
+  ClipEmitCells<CellsT> emit = { &cells, diffs.data(), numCells, insideOut,
+                                 chunkCounts.data(), &streams };
+  vtkSMPTools::For(0, numChunks, emit);
+  diffs = std::vector<double>();
+
+  // Merge the references to the same edge. The edge points are numbered in
+  // the order of their first reference.
+  std::vector<vtkIdType> refToEdge(numEdgeRefs);
+  std::vector<vtkIdType> edgeEnds;
+  std::vector<double> edgePercents;
+  vtkIdType numEdges = 0;
+  if (numEdgeRefs > 0)
+  {
+    vtkStaticEdgeLocatorTemplate<vtkIdType, double> locator;
+    vtkIdType numGroups;
+    const vtkIdType *groupOffsets =
+      locator.MergeEdges(numEdgeRefs, edges.data(), numGroups);
+    std::vector<vtkIdType> isFirst(numEdgeRefs + 1, 0);
+    ClipMarkFirstEdges markEdges = { edges.data(), groupOffsets, isFirst.data() };
+    vtkSMPTools::For(0, numGroups, markEdges);
+    vtkSMPTools::ExclusiveScan(isFirst.begin(), isFirst.end(),
+                               isFirst.begin(), vtkIdType(0));
+    numEdges = isFirst[numEdgeRefs];
+    edgeEnds.resize(2 * numEdges);
+    edgePercents.resize(numEdges);
+    ClipNumberEdges numberEdges = { edges.data(), groupOffsets, isFirst.data(),
+      refToEdge.data(), edgeEnds.data(), edgePercents.data() };
+    vtkSMPTools::For(0, numGroups, numberEdges);
+  }
+  edges = std::vector<ClipEdgeTuple>();
+
+  // Number the used input points in the order of their first use.
+  vtkIdType *conn = connectivity->GetPointer(0);
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUse(
+    new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::Fill(firstUse.get(), firstUse.get() + numPts, VTK_ID_MAX);
+  ClipFindFirstUses findFirstUses = { conn, numPts, firstUse.get() };
+  vtkSMPTools::For(0, connectivitySize, findFirstUses);
+  std::vector<vtkIdType> newPointIds(connectivitySize + 1);
+  ClipMarkFirstUses mark = { conn, numPts, firstUse.get(), newPointIds.data() };
+  vtkSMPTools::For(0, connectivitySize, mark);
+  newPointIds[connectivitySize] = 0;
+  vtkSMPTools::ExclusiveScan(newPointIds.begin(), newPointIds.end(),
+                             newPointIds.begin(), vtkIdType(0));
+  const vtkIdType numUsed = newPointIds[connectivitySize];
+  std::vector<vtkIdType> pointMap(numPts);
+  std::vector<vtkIdType> oldPointIds(numUsed);
+  ClipMapPoints mapPoints = { firstUse.get(), newPointIds.data(),
+                              pointMap.data(), oldPointIds.data() };
+  vtkSMPTools::For(0, numPts, mapPoints);
+  firstUse.reset();
+  newPointIds = std::vector<vtkIdType>();
+
+  const vtkIdType centroidStart = numUsed + numEdges;
+  const vtkIdType numOutPts = centroidStart + numCentroids;
+  ClipRenumberPoints renumber = { numPts, numUsed, centroidStart,
+    pointMap.data(), refToEdge.data(), conn };
+  vtkSMPTools::For(0, connectivitySize, renumber);
+  renumber.Ids = centroidIds.data();
+  vtkSMPTools::For(0, 8 * numCentroids, renumber);
+
+  // The points and their data. The centroid points, which are rare and may
+  // depend on each other, are computed serially.
+  vtkPointData *inPD = input->GetPointData();
+  vtkPointData *outPD = output->GetPointData();
+  vtkNew<vtkPoints> outPts;
+  outPts->SetDataType(pointsType);
+  outPts->SetNumberOfPoints(numOutPts);
+  ClipGatherPointsWorker pointsWorker = { &cps, oldPointIds.data(), numUsed,
+    edgeEnds.data(), edgePercents.data(), centroidStart };
+  if (!vtkArrayDispatch::DispatchByValueType<vtkArrayDispatch::Reals>::Execute(
+        outPts->GetData(), pointsWorker))
+  {
+    pointsWorker(outPts->GetData());
+  }
+
+  outPD->CopyAllocate(inPD, numOutPts);
+  outPD->ParallelCopyData(inPD, oldPointIds.data(), numUsed);
+  for (vtkIdType edgeId = 0; edgeId < numEdges; ++edgeId)
+  {
+    // The data is interpolated with the weight of the second point.
+    edgePercents[edgeId] = 1.0 - edgePercents[edgeId];
+  }
+  outPD->ParallelInterpolateEdges(inPD, edgeEnds.data(), edgePercents.data(),
+                                  numEdges, numUsed);
+
+  vtkIdType ptIdx = centroidStart;
+  vtkNew<vtkIdList> idList;
+  for (vtkIdType centroid = 0; centroid < numCentroids; ++centroid, ++ptIdx)
+  {
+    const int npts = centroidSizes[centroid];
+    const vtkIdType *ids = centroidIds.data() + 8 * centroid;
+    double weights[8];
+    double pt[3] = { 0.0, 0.0, 0.0 };
+    double weight_factor = 1.0 / npts;
+    idList->SetNumberOfIds(npts);
+    for (int k = 0; k < npts; ++k)
+    {
+      double p[3];
+      weights[k] = 1.0 * weight_factor;
+      idList->SetId(k, ids[k]);
+      outPts->GetPoint(ids[k], p);
+      pt[0] += p[0];
+      pt[1] += p[1];
+      pt[2] += p[2];
+    }
+    pt[0] *= weight_factor;
+    pt[1] *= weight_factor;
+    pt[2] *= weight_factor;
+    outPts->SetPoint(ptIdx, pt);
+    outPD->InterpolatePoint(outPD, ptIdx, idList, weights);
+  }
+
+  vtkIntArray *origNodes =
+    vtkArrayDownCast<vtkIntArray>(inPD->GetArray("avtOriginalNodeNumbers"));
+  if (origNodes)
+  {
+    vtkNew<vtkIntArray> newOrigNodes;
+    newOrigNodes->SetNumberOfComponents(origNodes->GetNumberOfComponents());
+    newOrigNodes->SetNumberOfTuples(numOutPts);
+    newOrigNodes->SetName(origNodes->GetName());
+    for (vtkIdType i = 0; i < numUsed; ++i)
+    {
+      newOrigNodes->SetTuple(i, origNodes->GetTuple(oldPointIds[i]));
+    }
+    for (vtkIdType edgeId = 0; edgeId < numEdges; ++edgeId)
+    {
+      vtkIdType id = edgePercents[edgeId] <= 0.5 ?
+        edgeEnds[2 * edgeId] : edgeEnds[2 * edgeId + 1];
+      newOrigNodes->SetTuple(numUsed + edgeId, origNodes->GetTuple(id));
+    }
+    for (vtkIdType i = centroidStart; i < numOutPts; ++i)
+    {
+      // these 'created' nodes have no original designation
+      for (int z = 0; z < newOrigNodes->GetNumberOfComponents(); ++z)
+      {
+        newOrigNodes->SetComponent(i, z, -1);
+      }
+    }
+    outPD->AddArray(newOrigNodes);
+  }
+  output->SetPoints(outPts);
+
+  // The cells and their data.
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numNewCells + 1);
+  offsets->SetValue(numNewCells, connectivitySize);
+  vtkNew<vtkIdTypeArray> locations;
+  locations->SetNumberOfValues(numNewCells);
+  vtkNew<vtkUnsignedCharArray> types;
+  types->SetNumberOfValues(numNewCells);
+  for (int g = 0; g < CLIP_NUMBER_OF_GROUPS; ++g)
+  {
+    ClipBuildCells buildCells = { groupStarts[g], connectivityStarts[g],
+      ClipGroupSizes[g], ClipGroupTypes[g], offsets->GetPointer(0),
+      locations->GetPointer(0), types->GetPointer(0) };
+    vtkSMPTools::For(groupStarts[g], groupStarts[g + 1], buildCells);
+  }
+  vtkNew<vtkCellArray> outCells;
+  outCells->SetData(offsets, connectivity);
+  output->SetCells(types, locations, outCells);
+
+  vtkCellData *outCD = output->GetCellData();
+  outCD->CopyAllocate(input->GetCellData(), numNewCells);
+  outCD->ParallelCopyData(input->GetCellData(), oldCellIds.data(), numNewCells);
+
+  return true;
+}
+
+// Set up the points structure of a point set, converting the points to
+// doubles if needed.
+void GetClipPointSetCoordinates(vtkPoints *points,
+  std::vector<double> &coordinates, TableBasedClipperCommonPointsStructure &cps)
+{
+  cps.hasPtsList = true;
+  if (points->GetDataType() == VTK_DOUBLE)
+  {
+    cps.pts_ptr = static_cast<double*>(points->GetVoidPointer(0));
+    return;
+  }
+  coordinates.resize(3 * points->GetNumberOfPoints());
+  ClipConvertPointsWorker worker = { coordinates.data() };
+  if (!vtkArrayDispatch::Dispatch::Execute(points->GetData(), worker))
+  {
+    worker(points->GetData());
+  }
+  cps.pts_ptr = coordinates.data();
+}
+
+} // end anonymous namespace
+// ============================================================================
+// ========================== Parallel clipping (end) =========================
+// ============================================================================
+
 
 //-----------------------------------------------------------------------------
 // Construct with user-specified implicit function; InsideOut turned off; value
@@ -2392,6 +3464,45 @@ void vtkTableBasedClipDataSet::ClipRectilinearGridData( vtkDataSet * inputGrd,
   int   pyStride    = rectDims[0];
   int   pzStride    = rectDims[0] * rectDims[1];
 
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() > 1 && numCells > 0 )
+  {
+    ClipStructuredCells cells;
+    cells.IsTwoDim = isTwoDim != 0;
+    for ( j = 0; j < 3; j ++ )
+    {
+      cells.ShiftLUT[j] = shiftLUT[j];
+      cells.CellDims[j] = cellDims[j];
+    }
+    cells.CyStride = cyStride;
+    cells.CzStride = czStride;
+    cells.PyStride = pyStride;
+    cells.PzStride = pzStride;
+    vtkDataArray * axes[3] = { rectGrid->GetXCoordinates(),
+      rectGrid->GetYCoordinates(), rectGrid->GetZCoordinates() };
+    std::vector<double> coordinates[3];
+    for ( j = 0; j < 3; j ++ )
+    {
+      coordinates[j].resize( rectDims[j] );
+      for ( i = 0; i < rectDims[j]; i ++ )
+      {
+        coordinates[j][i] = axes[j]->GetComponent( i, 0 );
+      }
+    }
+    TableBasedClipperCommonPointsStructure cps;
+    cps.hasPtsList = false;
+    cps.dims = rectDims;
+    cps.X = coordinates[0].data();
+    cps.Y = coordinates[1].data();
+    cps.Z = coordinates[2].data();
+    if ( ClipCellsInParallel( cells, numCells, rectGrid, clipAray, isoValue,
+           this->InsideOut != 0, GetOutputPointsDataType(
+             this->OutputPointsPrecision, rectGrid ), cps, outputUG ) )
+    {
+      delete visItVFV;
+      return;
+    }
+  }
+
   for ( i = 0; i < numCells; i ++ )
   {
     int    caseIndx = 0;
@@ -2738,6 +3849,31 @@ void vtkTableBasedClipDataSet::ClipStructuredGridData( vtkDataSet * inputGrd,
   int   pyStride    = gridDims[0];
   int   pzStride    = gridDims[0] * gridDims[1];
 
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() > 1 && numCells > 0 )
+  {
+    ClipStructuredCells cells;
+    cells.IsTwoDim = isTwoDim != 0;
+    for ( j = 0; j < 3; j ++ )
+    {
+      cells.ShiftLUT[j] = shiftLUT[j];
+      cells.CellDims[j] = cellDims[j];
+    }
+    cells.CyStride = cyStride;
+    cells.CzStride = czStride;
+    cells.PyStride = pyStride;
+    cells.PzStride = pzStride;
+    std::vector<double> coordinates;
+    TableBasedClipperCommonPointsStructure cps;
+    GetClipPointSetCoordinates( strcGrid->GetPoints(), coordinates, cps );
+    if ( ClipCellsInParallel( cells, numCells, strcGrid, clipAray, isoValue,
+           this->InsideOut != 0, GetOutputPointsDataType(
+             this->OutputPointsPrecision, strcGrid ), cps, outputUG ) )
+    {
+      delete visItVFV;
+      return;
+    }
+  }
+
   for ( i = 0; i < numCells; i ++ )
   {
     int    caseIndx = 0;
@@ -2996,6 +4132,25 @@ void vtkTableBasedClipDataSet::ClipUnstructuredGridData( vtkDataSet * inputGrd,
   int         numCants = 0; // number of cells not clipped by this filter
   int         numCells = unstruct->GetNumberOfCells();
 
+  // Clip in parallel unless some cells need vtkClipDataSet.
+  if ( vtkSMPTools::GetEstimatedNumberOfThreads() > 1 && numCells > 0 )
+  {
+    vtkCellArray * cellArray = unstruct->GetCells();
+    ClipUnstructuredCells cells;
+    cells.Types = unstruct->GetCellTypesArray()->GetPointer( 0 );
+    cells.Offsets = cellArray->GetOffsetsArray()->GetPointer( 0 );
+    cells.Connectivity = cellArray->GetConnectivityArray()->GetPointer( 0 );
+    std::vector<double> coordinates;
+    TableBasedClipperCommonPointsStructure cps;
+    GetClipPointSetCoordinates( unstruct->GetPoints(), coordinates, cps );
+    if ( ClipCellsInParallel( cells, numCells, unstruct, clipAray, isoValue,
+           this->InsideOut != 0, GetOutputPointsDataType(
+             this->OutputPointsPrecision, unstruct ), cps, outputUG ) )
+    {
+      return;
+    }
+  }
+
   // volume from volume
   vtkTableBasedClipperVolumeFromVolume   * visItVFV = new
   vtkTableBasedClipperVolumeFromVolume(
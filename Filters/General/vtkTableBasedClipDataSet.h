@@ -70,6 +70,14 @@
  *  advantages are gained by adopting the unique clipping and triangulation tables
  *  proposed by VisIt.
  *
+ *  When vtkSMPTools runs more than one thread, image data, rectilinear grids,
+ *  structured grids and unstructured grids are clipped in parallel: the
+ *  outputs of the cells are counted, then written, by chunks of cells, and
+ *  the points created on the same edge are merged with
+ *  vtkStaticEdgeLocatorTemplate. The output is the same as the one of the
+ *  serial algorithm. Unstructured grids containing cells that are not in the
+ *  clipping tables (e.g. polyhedra) are clipped serially.
+ *
  * @warning
  *  vtkTableBasedClipDataSet makes use of a hash table (that is provided by class
  *  maintained by internal class vtkTableBasedClipperDataSetFromVolume) to achieve
@@ -36,12 +36,15 @@
 #include "vtkTetra.h"
 #include "vtkHexahedron.h"
 #include "vtkPolyData.h"
+#include "vtkCellArray.h"
+#include "vtkIdList.h"
 #include "vtkPolyLine.h"
 #include "vtkQuadraticWedge.h"
 #include "vtkGenericCell.h"
 
 #include "vtkCommand.h"
 #include "vtkTestErrorObserver.h"
+#include "vtkTestSMP.h"
 
 #include <sstream>
 #include <map>
@@ -198,6 +201,78 @@ int UnitTestDataSetSurfaceFilter(int, char*[])
   std::cout << " PASSED." << std::endl;
   }
   {
+  std::cout << "Testing (UnstructuredGrid, Voxels, ReuseTopology)...";
+  vtkSmartPointer<vtkAppendFilter> append =
+    vtkSmartPointer<vtkAppendFilter>::New();
+  append->AddInputData(CreateUniformGrid(5, 5, 5));
+  append->Update();
+  vtkUnstructuredGrid *ugrid = append->GetOutput();
+
+  vtkSmartPointer<vtkDataSetSurfaceFilter> serial =
+    vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+  serial->SetInputData(ugrid);
+  vtkTest::RunThreaded(1, [&]() { serial->Update(); });
+
+  vtkSmartPointer<vtkDataSetSurfaceFilter> filter =
+    vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+  filter->SetInputData(ugrid);
+  filter->PassThroughCellIdsOn();
+  filter->ReuseTopologyOn();
+  vtkTest::RunThreaded(4, [&]() { filter->Update(); });
+  vtkPolyData *surface = filter->GetOutput();
+  vtkCellArray *polys = surface->GetPolys();
+
+  // Moving a point must not rebuild the faces.
+  double pt[3];
+  ugrid->GetPoint(0, pt);
+  pt[0] -= 1.0;
+  ugrid->GetPoints()->SetPoint(0, pt);
+  ugrid->GetPoints()->Modified();
+  vtkTest::RunThreaded(4, [&]() { filter->Update(); });
+
+  // Without ReuseTopology, the parallel algorithm is used on several
+  // threads only.
+  vtkSmartPointer<vtkDataSetSurfaceFilter> threaded =
+    vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
+  threaded->SetInputData(ugrid);
+  vtkTest::RunThreaded(4, [&]() { threaded->Update(); });
+
+  bool same = serial->GetOutput()->GetNumberOfPoints() == 98 &&
+    surface->GetNumberOfPoints() == 98 &&
+    serial->GetOutput()->GetNumberOfCells() == 96 &&
+    surface->GetNumberOfCells() == 96 &&
+    surface->GetPolys() == polys &&
+    surface->GetCellData()->GetArray("vtkOriginalCellIds") &&
+    threaded->GetOutput()->GetNumberOfCells() == 96;
+  vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkIdList> threadedIds = vtkSmartPointer<vtkIdList>::New();
+  vtkSmartPointer<vtkIdList> expected = vtkSmartPointer<vtkIdList>::New();
+  for (vtkIdType i = 0; same && i < surface->GetNumberOfCells(); ++i)
+  {
+    surface->GetCellPoints(i, ids);
+    threaded->GetOutput()->GetCellPoints(i, threadedIds);
+    serial->GetOutput()->GetCellPoints(i, expected);
+    same = ids->GetNumberOfIds() == expected->GetNumberOfIds() &&
+      threadedIds->GetNumberOfIds() == expected->GetNumberOfIds();
+    for (vtkIdType j = 0; same && j < ids->GetNumberOfIds(); ++j)
+    {
+      same = ids->GetId(j) == expected->GetId(j) &&
+        threadedIds->GetId(j) == expected->GetId(j);
+    }
+  }
+  // The moved point is a corner of the grid.
+  if (!same || surface->GetBounds()[0] != pt[0] ||
+      threaded->GetOutput()->GetBounds()[0] != pt[0])
+  {
+    std::cout << " FAILED." << std::endl;
+    status++;
+  }
+  else
+  {
+    std::cout << " PASSED." << std::endl;
+  }
+  }
+  {
   std::cout << "Testing (UniformGrid(5,10,1), UseStripsOn, PassThroughCellIds, PassThroughPointIds)...";
   vtkSmartPointer<vtkDataSetSurfaceFilter> filter =
     vtkSmartPointer<vtkDataSetSurfaceFilter>::New();
@@ -14,10 +14,12 @@
 =========================================================================*/
 #include "vtkDataSetSurfaceFilter.h"
 
+#include "vtkArrayDispatch.h"
 #include "vtkCell.h"
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
 #include "vtkCellIterator.h"
+#include "vtkDataArrayAccessor.h"
 #include "vtkDoubleArray.h"
 #include "vtkGenericCell.h"
 #include "vtkHexahedron.h"
@@ -32,6 +34,8 @@
 #include "vtkPyramid.h"
 #include "vtkRectilinearGrid.h"
 #include "vtkRectilinearGridGeometryFilter.h"
+#include "vtkSMPThreadLocal.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStructuredGridGeometryFilter.h"
@@ -49,8 +53,11 @@
 #include "vtkStructuredData.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <memory>
 #include <unordered_map>
+#include <vector>
 
 static inline int sizeofFastQuad(int numPts)
 {
@@ -101,6 +108,976 @@ protected:
   MapType Map;
 };
 
+//----------------------------------------------------------------------------
+// Parallel extraction of the surface of unstructured grids made of linear
+// cells. The cells are processed by chunks: accumulating the number of
+// vertices, lines and polygons generated by each chunk gives the place where
+// each chunk writes them. The faces of the 3D cells are binned by their first
+// point id, as in the face hash, and the faces found only once in their bin
+// are on the surface. The points are numbered in the order of their first
+// use, so the output is the same as the one of the serial algorithm.
+namespace
+{
+
+const vtkIdType SURFACE_CHUNK_SIZE = 4096;
+
+enum SurfaceCellCategory
+{
+  SURFACE_VERTS = 0,
+  SURFACE_LINES = 1,
+  SURFACE_POLYS = 2,
+  SURFACE_VOLUME,
+  SURFACE_EMPTY,
+  SURFACE_UNSUPPORTED
+};
+
+int GetSurfaceCellCategory(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_VERTEX:
+    case VTK_POLY_VERTEX:
+      return SURFACE_VERTS;
+    case VTK_LINE:
+    case VTK_POLY_LINE:
+      return SURFACE_LINES;
+    case VTK_TRIANGLE:
+    case VTK_QUAD:
+    case VTK_PIXEL:
+    case VTK_POLYGON:
+    case VTK_TRIANGLE_STRIP:
+      return SURFACE_POLYS;
+    case VTK_TETRA:
+    case VTK_HEXAHEDRON:
+    case VTK_VOXEL:
+    case VTK_WEDGE:
+    case VTK_PYRAMID:
+    case VTK_PENTAGONAL_PRISM:
+    case VTK_HEXAGONAL_PRISM:
+      return SURFACE_VOLUME;
+    case VTK_EMPTY_CELL:
+      return SURFACE_EMPTY;
+    default:
+      return SURFACE_UNSUPPORTED;
+  }
+}
+
+// Number of output cells and connectivity size of a 0D, 1D or 2D cell.
+// Triangle strips are split into triangles.
+inline void GetSurfaceCellSize(int cellType, vtkIdType npts,
+                               vtkIdType &numCells, vtkIdType &size)
+{
+  if (cellType == VTK_TRIANGLE_STRIP)
+  {
+    numCells = npts > 2 ? npts - 2 : 0;
+    size = 3 * numCells;
+  }
+  else
+  {
+    numCells = 1;
+    size = cellType == VTK_PIXEL ? 4 : npts;
+  }
+}
+
+// Faces of the 3D cells, in the order in which UnstructuredGridExecute()
+// inserts them in the face hash.
+struct SurfaceCellFaces
+{
+  int NumberOfPoints;
+  int NumberOfFaces;
+  int FaceSizes[8];
+  int Faces[8][6];
+};
+
+const SurfaceCellFaces SurfaceTetraFaces =
+  { 4, 4, { 3, 3, 3, 3 },
+    { { 0, 1, 3 }, { 0, 2, 1 }, { 0, 3, 2 }, { 1, 2, 3 } } };
+const SurfaceCellFaces SurfaceHexahedronFaces =
+  { 8, 6, { 4, 4, 4, 4, 4, 4 },
+    { { 0, 1, 5, 4 }, { 0, 3, 2, 1 }, { 0, 4, 7, 3 },
+      { 1, 2, 6, 5 }, { 2, 3, 7, 6 }, { 4, 5, 6, 7 } } };
+const SurfaceCellFaces SurfaceVoxelFaces =
+  { 8, 6, { 4, 4, 4, 4, 4, 4 },
+    { { 0, 1, 5, 4 }, { 0, 2, 3, 1 }, { 0, 4, 6, 2 },
+      { 1, 3, 7, 5 }, { 2, 6, 7, 3 }, { 4, 5, 7, 6 } } };
+const SurfaceCellFaces SurfaceWedgeFaces =
+  { 6, 5, { 4, 4, 4, 3, 3 },
+    { { 0, 2, 5, 3 }, { 1, 0, 3, 4 }, { 2, 1, 4, 5 },
+      { 0, 1, 2 }, { 3, 5, 4 } } };
+const SurfaceCellFaces SurfacePyramidFaces =
+  { 5, 5, { 4, 3, 3, 3, 3 },
+    { { 3, 2, 1, 0 }, { 0, 1, 4 }, { 1, 2, 4 }, { 2, 3, 4 }, { 3, 0, 4 } } };
+const SurfaceCellFaces SurfacePentagonalPrismFaces =
+  { 10, 7, { 4, 4, 4, 4, 4, 5, 5 },
+    { { 0, 1, 6, 5 }, { 1, 2, 7, 6 }, { 2, 3, 8, 7 }, { 3, 4, 9, 8 },
+      { 4, 0, 5, 9 }, { 0, 1, 2, 3, 4 }, { 5, 6, 7, 8, 9 } } };
+const SurfaceCellFaces SurfaceHexagonalPrismFaces =
+  { 12, 8, { 4, 4, 4, 4, 4, 4, 6, 6 },
+    { { 0, 1, 7, 6 }, { 1, 2, 8, 7 }, { 2, 3, 9, 8 }, { 3, 4, 10, 9 },
+      { 4, 5, 11, 10 }, { 5, 0, 6, 11 }, { 0, 1, 2, 3, 4, 5 },
+      { 6, 7, 8, 9, 10, 11 } } };
+
+const SurfaceCellFaces *GetSurfaceCellFaces(int cellType)
+{
+  switch (cellType)
+  {
+    case VTK_TETRA:
+      return &SurfaceTetraFaces;
+    case VTK_HEXAHEDRON:
+      return &SurfaceHexahedronFaces;
+    case VTK_VOXEL:
+      return &SurfaceVoxelFaces;
+    case VTK_WEDGE:
+      return &SurfaceWedgeFaces;
+    case VTK_PYRAMID:
+      return &SurfacePyramidFaces;
+    case VTK_PENTAGONAL_PRISM:
+      return &SurfacePentagonalPrismFaces;
+    case VTK_HEXAGONAL_PRISM:
+      return &SurfaceHexagonalPrismFaces;
+    default:
+      return nullptr;
+  }
+}
+
+// Get the point ids of a face in the order in which the face hash stores
+// them (see InsertQuadInHash(), InsertTriInHash() and InsertPolygonInHash()).
+// The first id, which is returned, is the bin of the face.
+vtkIdType GetSurfaceFace(const vtkIdType *cellPts, const int *face,
+                         int numPts, vtkIdType *ids)
+{
+  vtkIdType a = cellPts[face[0]];
+  vtkIdType b = cellPts[face[1]];
+  vtkIdType c = cellPts[face[2]];
+  if (numPts == 4)
+  {
+    vtkIdType d = cellPts[face[3]];
+    if (b < a && b < c && b < d)
+    {
+      ids[0] = b; ids[1] = c; ids[2] = d; ids[3] = a;
+    }
+    else if (c < a && c < b && c < d)
+    {
+      ids[0] = c; ids[1] = d; ids[2] = a; ids[3] = b;
+    }
+    else if (d < a && d < b && d < c)
+    {
+      ids[0] = d; ids[1] = a; ids[2] = b; ids[3] = c;
+    }
+    else
+    {
+      ids[0] = a; ids[1] = b; ids[2] = c; ids[3] = d;
+    }
+  }
+  else if (numPts == 3)
+  {
+    if (b < a && b < c)
+    {
+      ids[0] = b; ids[1] = c; ids[2] = a;
+    }
+    else if (c < a && c < b)
+    {
+      ids[0] = c; ids[1] = a; ids[2] = b;
+    }
+    else
+    {
+      ids[0] = a; ids[1] = b; ids[2] = c;
+    }
+  }
+  else
+  {
+    int offset = 0;
+    for (int i = 1; i < numPts; ++i)
+    {
+      if (cellPts[face[i]] < cellPts[face[offset]])
+      {
+        offset = i;
+      }
+    }
+    for (int i = 0; i < numPts; ++i)
+    {
+      ids[i] = cellPts[face[(offset + i) % numPts]];
+    }
+  }
+  return ids[0];
+}
+
+// Same matching rules as the face hash.
+bool IsSameSurfaceFace(const vtkIdType *f, const vtkIdType *g, int numPts)
+{
+  if (f[0] != g[0])
+  {
+    return false;
+  }
+  if (numPts == 4)
+  {
+    return f[2] == g[2] &&
+      ((f[1] == g[1] && f[3] == g[3]) || (f[1] == g[3] && f[3] == g[1]));
+  }
+  if (numPts == 3)
+  {
+    return (f[1] == g[1] && f[2] == g[2]) || (f[1] == g[2] && f[2] == g[1]);
+  }
+  if (f[1] == g[1])
+  {
+    for (int i = 2; i < numPts; ++i)
+    {
+      if (f[i] != g[i])
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  for (int i = 1; i < numPts; ++i)
+  {
+    if (f[numPts - i] != g[i])
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Record that a point is used at a given position of the output
+// connectivity (vertices, then lines, then polygons).
+inline void SetSurfaceFirstUse(std::atomic<vtkIdType> &firstUse,
+                               vtkIdType position)
+{
+  vtkIdType first = firstUse.load(std::memory_order_relaxed);
+  while (position < first &&
+         !firstUse.compare_exchange_weak(first, position,
+                                         std::memory_order_relaxed))
+  {
+  }
+}
+
+// A face of a 3D cell.
+struct SurfaceFace
+{
+  vtkIdType CellId;
+  int Face;
+
+  bool operator<(const SurfaceFace &other) const
+  {
+    return this->CellId < other.CellId ||
+      (this->CellId == other.CellId && this->Face < other.Face);
+  }
+};
+
+// Number of output cells and connectivity size of each category, for a
+// chunk of input cells. They are turned into offsets once counted.
+struct SurfaceChunk
+{
+  vtkIdType NumberOfCells[3];
+  vtkIdType ConnectivitySize[3];
+};
+
+// The input cells, read directly from the arrays of the grid.
+struct SurfaceInput
+{
+  const unsigned char *Types;
+  const vtkIdType *Offsets;
+  const vtkIdType *Connectivity;
+  vtkIdType NumberOfCells;
+};
+
+// Count the output of each chunk of cells and the number of faces of each
+// bin. Stop if a cell cannot be handled.
+struct SurfaceCountCells
+{
+  SurfaceInput Input;
+  SurfaceChunk *Chunks;
+  std::atomic<vtkIdType> *BinSizes;
+  std::atomic<int> *Unsupported;
+
+  void operator()(vtkIdType beginChunk, vtkIdType endChunk) const
+  {
+    vtkIdType ids[6];
+    for (vtkIdType chunk = beginChunk; chunk < endChunk; ++chunk)
+    {
+      if (this->Unsupported->load(std::memory_order_relaxed))
+      {
+        return;
+      }
+      SurfaceChunk &counts = this->Chunks[chunk];
+      for (int i = 0; i < 3; ++i)
+      {
+        counts.NumberOfCells[i] = 0;
+        counts.ConnectivitySize[i] = 0;
+      }
+      const vtkIdType endCell = std::min((chunk + 1) * SURFACE_CHUNK_SIZE,
+                                         this->Input.NumberOfCells);
+      for (vtkIdType cellId = chunk * SURFACE_CHUNK_SIZE; cellId < endCell;
+           ++cellId)
+      {
+        const int cellType = this->Input.Types[cellId];
+        const vtkIdType offset = this->Input.Offsets[cellId];
+        const vtkIdType npts = this->Input.Offsets[cellId + 1] - offset;
+        const int category = GetSurfaceCellCategory(cellType);
+        if (category <= SURFACE_POLYS)
+        {
+          vtkIdType numCells, size;
+          GetSurfaceCellSize(cellType, npts, numCells, size);
+          if (cellType == VTK_PIXEL && npts < 4)
+          {
+            this->Unsupported->store(1);
+            return;
+          }
+          counts.NumberOfCells[category] += numCells;
+          counts.ConnectivitySize[category] += size;
+        }
+        else if (category == SURFACE_VOLUME)
+        {
+          const SurfaceCellFaces *faces = GetSurfaceCellFaces(cellType);
+          if (npts < faces->NumberOfPoints)
+          {
+            this->Unsupported->store(1);
+            return;
+          }
+          const vtkIdType *pts = this->Input.Connectivity + offset;
+          for (int f = 0; f < faces->NumberOfFaces; ++f)
+          {
+            vtkIdType bin = GetSurfaceFace(pts, faces->Faces[f],
+                                           faces->FaceSizes[f], ids);
+            this->BinSizes[bin].fetch_add(1, std::memory_order_relaxed);
+          }
+        }
+        else if (category == SURFACE_UNSUPPORTED)
+        {
+          this->Unsupported->store(1);
+          return;
+        }
+      }
+    }
+  }
+};
+
+// Output arrays of one category of cells.
+struct SurfaceCells
+{
+  vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+  vtkIdType *SourceIds;
+  vtkIdType StreamStart; // position of the connectivity in the stream
+};
+
+// Put the faces of the 3D cells in their bin.
+struct SurfaceBinFaces
+{
+  SurfaceInput Input;
+  std::atomic<vtkIdType> *BinCursors;
+  SurfaceFace *BinFaces;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkIdType ids[6];
+    for (vtkIdType cellId = begin; cellId < end; ++cellId)
+    {
+      const SurfaceCellFaces *faces =
+        GetSurfaceCellFaces(this->Input.Types[cellId]);
+      if (!faces)
+      {
+        continue;
+      }
+      const vtkIdType *pts =
+        this->Input.Connectivity + this->Input.Offsets[cellId];
+      for (int f = 0; f < faces->NumberOfFaces; ++f)
+      {
+        vtkIdType bin = GetSurfaceFace(pts, faces->Faces[f],
+                                       faces->FaceSizes[f], ids);
+        SurfaceFace &face = this->BinFaces[
+          this->BinCursors[bin].fetch_add(1, std::memory_order_relaxed)];
+        face.CellId = cellId;
+        face.Face = f;
+      }
+    }
+  }
+};
+
+// Write the vertices, lines and polygons of each chunk at the place given
+// by the chunk offsets.
+struct SurfaceGatherCells
+{
+  SurfaceInput Input;
+  const SurfaceChunk *Chunks;
+  SurfaceCells Output[3];
+  std::atomic<vtkIdType> *FirstUse;
+
+  void operator()(vtkIdType beginChunk, vtkIdType endChunk) const
+  {
+    for (vtkIdType chunk = beginChunk; chunk < endChunk; ++chunk)
+    {
+      vtkIdType cellIds[3];
+      vtkIdType positions[3];
+      for (int i = 0; i < 3; ++i)
+      {
+        cellIds[i] = this->Chunks[chunk].NumberOfCells[i];
+        positions[i] = this->Chunks[chunk].ConnectivitySize[i];
+      }
+      const vtkIdType endCell = std::min((chunk + 1) * SURFACE_CHUNK_SIZE,
+                                         this->Input.NumberOfCells);
+      for (vtkIdType cellId = chunk * SURFACE_CHUNK_SIZE; cellId < endCell;
+           ++cellId)
+      {
+        const int cellType = this->Input.Types[cellId];
+        const vtkIdType offset = this->Input.Offsets[cellId];
+        const vtkIdType npts = this->Input.Offsets[cellId + 1] - offset;
+        const vtkIdType *pts = this->Input.Connectivity + offset;
+        const int category = GetSurfaceCellCategory(cellType);
+        if (category > SURFACE_POLYS)
+        {
+          continue;
+        }
+
+        const SurfaceCells &output = this->Output[category];
+        vtkIdType &newCellId = cellIds[category];
+        vtkIdType &position = positions[category];
+        if (cellType == VTK_TRIANGLE_STRIP)
+        {
+          // Change strips to triangles, as the serial algorithm does.
+          vtkIdType tri[3] = { pts[0], pts[1], 0 };
+          int toggle = 0;
+          for (vtkIdType i = 2; i < npts; ++i)
+          {
+            tri[2] = pts[i];
+            this->AddCell(output, newCellId++, position, cellId, tri, 3);
+            position += 3;
+            tri[toggle] = tri[2];
+            toggle = !toggle;
+          }
+        }
+        else if (cellType == VTK_PIXEL)
+        {
+          vtkIdType quad[4] = { pts[0], pts[1], pts[3], pts[2] };
+          this->AddCell(output, newCellId++, position, cellId, quad, 4);
+          position += 4;
+        }
+        else
+        {
+          this->AddCell(output, newCellId++, position, cellId, pts, npts);
+          position += npts;
+        }
+      }
+    }
+  }
+
+  void AddCell(const SurfaceCells &output, vtkIdType newCellId,
+               vtkIdType position, vtkIdType sourceId, const vtkIdType *pts,
+               vtkIdType npts) const
+  {
+    output.Offsets[newCellId] = position;
+    output.SourceIds[newCellId] = sourceId;
+    for (vtkIdType i = 0; i < npts; ++i)
+    {
+      output.Connectivity[position + i] = pts[i];
+      SetSurfaceFirstUse(this->FirstUse[pts[i]],
+                         output.StreamStart + position + i);
+    }
+  }
+};
+
+// Find the faces seen once in each bin, in the order of the face hash:
+// by cell id, then by face.
+struct SurfaceFindExternalFaces
+{
+  SurfaceInput Input;
+  const vtkIdType *BinOffsets;
+  SurfaceFace *BinFaces;
+  unsigned char *Visible;
+  vtkIdType *VisibleCells;
+  vtkIdType *VisibleSizes;
+  vtkSMPThreadLocal<std::vector<vtkIdType> > Ids;
+
+  void operator()(vtkIdType beginBin, vtkIdType endBin)
+  {
+    std::vector<vtkIdType> &ids = this->Ids.Local();
+    for (vtkIdType bin = beginBin; bin < endBin; ++bin)
+    {
+      const vtkIdType begin = this->BinOffsets[bin];
+      const vtkIdType end = this->BinOffsets[bin + 1];
+      this->VisibleCells[bin] = 0;
+      this->VisibleSizes[bin] = 0;
+      if (begin == end)
+      {
+        continue;
+      }
+      std::sort(this->BinFaces + begin, this->BinFaces + end);
+      ids.resize(7 * (end - begin));
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const SurfaceFace &face = this->BinFaces[i];
+        const SurfaceCellFaces *faces =
+          GetSurfaceCellFaces(this->Input.Types[face.CellId]);
+        vtkIdType *faceIds = &ids[7 * (i - begin)];
+        faceIds[0] = faces->FaceSizes[face.Face];
+        GetSurfaceFace(this->Input.Connectivity +
+                         this->Input.Offsets[face.CellId],
+                       faces->Faces[face.Face], faces->FaceSizes[face.Face],
+                       faceIds + 1);
+      }
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const vtkIdType *faceIds = &ids[7 * (i - begin)];
+        bool visible = true;
+        for (vtkIdType j = begin; j < end && visible; ++j)
+        {
+          const vtkIdType *otherIds = &ids[7 * (j - begin)];
+          visible = i == j || faceIds[0] != otherIds[0] ||
+            !IsSameSurfaceFace(faceIds + 1, otherIds + 1,
+                               static_cast<int>(faceIds[0]));
+        }
+        this->Visible[i] = visible ? 1 : 0;
+        if (visible)
+        {
+          this->VisibleCells[bin]++;
+          this->VisibleSizes[bin] += faceIds[0];
+        }
+      }
+    }
+  }
+};
+
+// Write the faces on the surface after the 2D cells. Faces whose points are
+// all duplicated or one point is hidden are flagged for removal. Their
+// points are used, as with the face hash.
+struct SurfaceGatherFaces
+{
+  SurfaceInput Input;
+  const vtkIdType *BinOffsets;
+  const SurfaceFace *BinFaces;
+  const unsigned char *Visible;
+  const vtkIdType *CellOffsets;
+  const vtkIdType *ConnectivityOffsets;
+  SurfaceCells Output;
+  vtkIdType CellStart;
+  vtkIdType ConnectivityStart;
+  std::atomic<vtkIdType> *FirstUse;
+  const unsigned char *Ghosts;
+  unsigned char *Keep;
+  std::atomic<vtkIdType> *NumberOfRemovedFaces;
+
+  void operator()(vtkIdType beginBin, vtkIdType endBin) const
+  {
+    for (vtkIdType bin = beginBin; bin < endBin; ++bin)
+    {
+      vtkIdType newCellId = this->CellStart + this->CellOffsets[bin];
+      vtkIdType position =
+        this->ConnectivityStart + this->ConnectivityOffsets[bin];
+      for (vtkIdType i = this->BinOffsets[bin]; i < this->BinOffsets[bin + 1];
+           ++i)
+      {
+        if (!this->Visible[i])
+        {
+          continue;
+        }
+        const SurfaceFace &face = this->BinFaces[i];
+        const SurfaceCellFaces *faces =
+          GetSurfaceCellFaces(this->Input.Types[face.CellId]);
+        const int numPts = faces->FaceSizes[face.Face];
+        vtkIdType *ids = this->Output.Connectivity + position;
+        GetSurfaceFace(this->Input.Connectivity +
+                         this->Input.Offsets[face.CellId],
+                       faces->Faces[face.Face], numPts, ids);
+        this->Output.Offsets[newCellId] = position;
+        this->Output.SourceIds[newCellId] = face.CellId;
+        bool allGhosts = this->Ghosts != nullptr;
+        bool oneHidden = false;
+        for (int j = 0; j < numPts; ++j)
+        {
+          SetSurfaceFirstUse(this->FirstUse[ids[j]],
+                             this->Output.StreamStart + position + j);
+          if (this->Ghosts)
+          {
+            unsigned char val = this->Ghosts[ids[j]];
+            if (!(val & vtkDataSetAttributes::DUPLICATEPOINT))
+            {
+              allGhosts = false;
+            }
+            if (val & vtkDataSetAttributes::HIDDENPOINT)
+            {
+              oneHidden = true;
+            }
+          }
+        }
+        if (this->Keep)
+        {
+          this->Keep[newCellId - this->CellStart] =
+            (allGhosts || oneHidden) ? 0 : 1;
+          if (allGhosts || oneHidden)
+          {
+            this->NumberOfRemovedFaces->fetch_add(1);
+          }
+        }
+        ++newCellId;
+        position += numPts;
+      }
+    }
+  }
+};
+
+// Flag the positions of a connectivity array where a point is used first.
+struct SurfaceMarkFirstUses
+{
+  const vtkIdType *Connectivity;
+  vtkIdType StreamStart;
+  const std::atomic<vtkIdType> *FirstUse;
+  vtkIdType *IsFirstUse;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType position = begin; position < end; ++position)
+    {
+      const vtkIdType streamPosition = this->StreamStart + position;
+      this->IsFirstUse[streamPosition] =
+        this->FirstUse[this->Connectivity[position]] == streamPosition ? 1 : 0;
+    }
+  }
+};
+
+// Build the map from input to output point ids, and its inverse.
+struct SurfaceMapPoints
+{
+  const std::atomic<vtkIdType> *FirstUse;
+  const vtkIdType *NewPointIds;
+  vtkIdType *PointMap;
+  vtkIdType *OldPointIds;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType ptId = begin; ptId < end; ++ptId)
+    {
+      vtkIdType first = this->FirstUse[ptId];
+      if (first == VTK_ID_MAX)
+      {
+        this->PointMap[ptId] = -1;
+      }
+      else
+      {
+        vtkIdType newId = this->NewPointIds[first];
+        this->PointMap[ptId] = newId;
+        this->OldPointIds[newId] = ptId;
+      }
+    }
+  }
+};
+
+// Replace the input point ids of a connectivity array with the output ones.
+struct SurfaceRenumberPoints
+{
+  const vtkIdType *PointMap;
+  vtkIdType *Connectivity;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    for (vtkIdType position = begin; position < end; ++position)
+    {
+      this->Connectivity[position] = this->PointMap[this->Connectivity[position]];
+    }
+  }
+};
+
+// Copy the coordinates of the points OldPointIds[i] to the points i.
+template <typename InArrayT, typename OutArrayT>
+struct SurfaceGatherPoints
+{
+  InArrayT *In;
+  OutArrayT *Out;
+  const vtkIdType *OldPointIds;
+
+  void operator()(vtkIdType begin, vtkIdType end) const
+  {
+    vtkDataArrayAccessor<InArrayT> in(this->In);
+    vtkDataArrayAccessor<OutArrayT> out(this->Out);
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      const vtkIdType ptId = this->OldPointIds[i];
+      for (int c = 0; c < 3; ++c)
+      {
+        out.Set(i, c, in.Get(ptId, c));
+      }
+    }
+  }
+};
+
+struct SurfaceGatherPointsWorker
+{
+  const vtkIdType *OldPointIds;
+  vtkIdType NumberOfPoints;
+
+  template <typename InArrayT, typename OutArrayT>
+  void operator()(InArrayT *in, OutArrayT *out)
+  {
+    SurfaceGatherPoints<InArrayT, OutArrayT> functor =
+      { in, out, this->OldPointIds };
+    vtkSMPTools::For(0, this->NumberOfPoints, functor);
+  }
+};
+
+// The surface of an unstructured grid, without its points and attributes:
+// the output cells and, for each output point and cell, the id of the input
+// point and cell it comes from.
+struct SurfaceTopology
+{
+  vtkSmartPointer<vtkCellArray> Verts;
+  vtkSmartPointer<vtkCellArray> Lines;
+  vtkSmartPointer<vtkCellArray> Polys;
+  std::vector<vtkIdType> PointIds;
+  std::vector<vtkIdType> CellIds;
+};
+
+vtkSmartPointer<vtkCellArray> NewSurfaceCells(vtkIdType numCells,
+                                              vtkIdType size,
+                                              SurfaceCells &cells)
+{
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numCells + 1);
+  offsets->SetValue(0, 0);
+  offsets->SetValue(numCells, size);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(size);
+  vtkSmartPointer<vtkCellArray> cellArray =
+    vtkSmartPointer<vtkCellArray>::New();
+  cellArray->SetData(offsets, connectivity);
+  cells.Offsets = offsets->GetPointer(0);
+  cells.Connectivity = connectivity->GetPointer(0);
+  return cellArray;
+}
+
+
+// Conversions between the bin sizes (or cursors) and offsets.
+struct SurfaceLoadBinSize
+{
+  vtkIdType operator()(const std::atomic<vtkIdType> &size) const
+  {
+    return size.load(std::memory_order_relaxed);
+  }
+};
+
+struct SurfaceStoreBinCursor
+{
+  vtkIdType operator()(vtkIdType offset) const { return offset; }
+};
+
+// Remove the faces flagged by SurfaceGatherFaces. Done serially and in
+// place: this only happens for ghost points, and is a simple copy.
+void RemoveSurfaceFaces(vtkCellArray *polys, vtkIdType *cellIds,
+                        vtkIdType firstFace, const unsigned char *keep)
+{
+  vtkIdTypeArray *offsetsArray = polys->GetOffsetsArray();
+  vtkIdTypeArray *connectivityArray = polys->GetConnectivityArray();
+  vtkIdType *offsets = offsetsArray->GetPointer(0);
+  vtkIdType *connectivity = connectivityArray->GetPointer(0);
+  const vtkIdType numCells = offsetsArray->GetNumberOfValues() - 1;
+  vtkIdType newCellId = firstFace;
+  vtkIdType position = offsets[firstFace];
+  for (vtkIdType cellId = firstFace; cellId < numCells; ++cellId)
+  {
+    if (!keep[cellId - firstFace])
+    {
+      continue;
+    }
+    const vtkIdType begin = offsets[cellId];
+    const vtkIdType end = offsets[cellId + 1];
+    offsets[newCellId] = position;
+    cellIds[newCellId] = cellIds[cellId];
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      connectivity[position++] = connectivity[i];
+    }
+    ++newCellId;
+  }
+  offsets[newCellId] = position;
+  offsetsArray->SetNumberOfValues(newCellId + 1);
+  connectivityArray->SetNumberOfValues(position);
+  polys->SetData(offsetsArray, connectivityArray);
+}
+
+// Extract the surface of the grid. Returns false if the grid has cells that
+// are not handled.
+bool ExtractSurfaceTopology(vtkUnstructuredGrid *input,
+                            SurfaceTopology &topology)
+{
+  const vtkIdType numPts = input->GetNumberOfPoints();
+  SurfaceInput cells;
+  cells.NumberOfCells = input->GetNumberOfCells();
+  cells.Types = input->GetCellTypesArray()->GetPointer(0);
+  cells.Offsets = input->GetCells()->GetOffsetsArray()->GetPointer(0);
+  cells.Connectivity =
+    input->GetCells()->GetConnectivityArray()->GetPointer(0);
+
+  // Count the output of each chunk of cells, and the faces of each bin.
+  const vtkIdType numChunks =
+    (cells.NumberOfCells + SURFACE_CHUNK_SIZE - 1) / SURFACE_CHUNK_SIZE;
+  std::vector<SurfaceChunk> chunks(numChunks);
+  std::unique_ptr<std::atomic<vtkIdType>[]> binCursors(
+    new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::Fill(binCursors.get(), binCursors.get() + numPts, 0);
+  std::atomic<int> unsupported(0);
+  SurfaceCountCells count =
+    { cells, chunks.data(), binCursors.get(), &unsupported };
+  vtkSMPTools::For(0, numChunks, count);
+  if (unsupported)
+  {
+    return false;
+  }
+
+  // Turn the counts into offsets. Vertices, lines and polygons are numbered
+  // in this order.
+  vtkIdType numCells[3] = { 0, 0, 0 };
+  vtkIdType sizes[3] = { 0, 0, 0 };
+  for (vtkIdType chunk = 0; chunk < numChunks; ++chunk)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      vtkIdType chunkCells = chunks[chunk].NumberOfCells[i];
+      vtkIdType chunkSize = chunks[chunk].ConnectivitySize[i];
+      chunks[chunk].NumberOfCells[i] = numCells[i];
+      chunks[chunk].ConnectivitySize[i] = sizes[i];
+      numCells[i] += chunkCells;
+      sizes[i] += chunkSize;
+    }
+  }
+  std::vector<vtkIdType> binOffsets(numPts + 1, 0);
+  vtkSMPTools::Transform(binCursors.get(), binCursors.get() + numPts,
+                         binOffsets.begin(), SurfaceLoadBinSize());
+  vtkSMPTools::ExclusiveScan(binOffsets.begin(), binOffsets.end(),
+                             binOffsets.begin(), vtkIdType(0));
+  const vtkIdType numFaces = binOffsets[numPts];
+
+  // Bin the faces and keep the ones seen once.
+  std::unique_ptr<SurfaceFace[]> binFaces(new SurfaceFace[numFaces]);
+  std::unique_ptr<unsigned char[]> visible(new unsigned char[numFaces]);
+  std::vector<vtkIdType> faceCellOffsets(numPts + 1, 0);
+  std::vector<vtkIdType> faceSizeOffsets(numPts + 1, 0);
+  if (numFaces > 0)
+  {
+    vtkSMPTools::Transform(binOffsets.begin(), binOffsets.end() - 1,
+                           binCursors.get(), SurfaceStoreBinCursor());
+    SurfaceBinFaces bin = { cells, binCursors.get(), binFaces.get() };
+    vtkSMPTools::For(0, cells.NumberOfCells, bin);
+    SurfaceFindExternalFaces find;
+    find.Input = cells;
+    find.BinOffsets = binOffsets.data();
+    find.BinFaces = binFaces.get();
+    find.Visible = visible.get();
+    find.VisibleCells = faceCellOffsets.data();
+    find.VisibleSizes = faceSizeOffsets.data();
+    vtkSMPTools::For(0, numPts, find);
+    vtkSMPTools::ExclusiveScan(faceCellOffsets.begin(), faceCellOffsets.end(),
+                               faceCellOffsets.begin(), vtkIdType(0));
+    vtkSMPTools::ExclusiveScan(faceSizeOffsets.begin(), faceSizeOffsets.end(),
+                               faceSizeOffsets.begin(), vtkIdType(0));
+  }
+  binCursors.reset();
+  const vtkIdType numFaceCells = faceCellOffsets[numPts];
+  const vtkIdType faceSize = faceSizeOffsets[numPts];
+
+  // Gather the cells. The connectivity arrays of the vertices, lines and
+  // polygons are seen as a single stream in which the first use of each
+  // point is recorded.
+  SurfaceCells output[3];
+  topology.Verts = NewSurfaceCells(numCells[0], sizes[0], output[0]);
+  topology.Lines = NewSurfaceCells(numCells[1], sizes[1], output[1]);
+  topology.Polys = NewSurfaceCells(numCells[2] + numFaceCells,
+                                   sizes[2] + faceSize, output[2]);
+  std::vector<vtkIdType> &cellIds = topology.CellIds;
+  cellIds.resize(numCells[0] + numCells[1] + numCells[2] + numFaceCells);
+  vtkIdType cellStart = 0;
+  vtkIdType streamStart = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    output[i].SourceIds = cellIds.data() + cellStart;
+    output[i].StreamStart = streamStart;
+    cellStart += numCells[i];
+    streamStart += sizes[i];
+  }
+  const vtkIdType streamSize = streamStart + faceSize;
+  std::unique_ptr<std::atomic<vtkIdType>[]> firstUse(
+    new std::atomic<vtkIdType>[numPts]);
+  vtkSMPTools::Fill(firstUse.get(), firstUse.get() + numPts, VTK_ID_MAX);
+
+  SurfaceGatherCells gatherCells;
+  gatherCells.Input = cells;
+  gatherCells.Chunks = chunks.data();
+  std::copy(output, output + 3, gatherCells.Output);
+  gatherCells.FirstUse = firstUse.get();
+  vtkSMPTools::For(0, numChunks, gatherCells);
+
+  vtkUnsignedCharArray *ghosts = input->GetPointGhostArray();
+  std::vector<unsigned char> keep;
+  std::atomic<vtkIdType> numRemovedFaces(0);
+  if (ghosts)
+  {
+    keep.resize(numFaceCells);
+  }
+  SurfaceGatherFaces gatherFaces;
+  gatherFaces.Input = cells;
+  gatherFaces.BinOffsets = binOffsets.data();
+  gatherFaces.BinFaces = binFaces.get();
+  gatherFaces.Visible = visible.get();
+  gatherFaces.CellOffsets = faceCellOffsets.data();
+  gatherFaces.ConnectivityOffsets = faceSizeOffsets.data();
+  gatherFaces.Output = output[2];
+  gatherFaces.CellStart = numCells[2];
+  gatherFaces.ConnectivityStart = sizes[2];
+  gatherFaces.FirstUse = firstUse.get();
+  gatherFaces.Ghosts = ghosts ? ghosts->GetPointer(0) : nullptr;
+  gatherFaces.Keep = ghosts ? keep.data() : nullptr;
+  gatherFaces.NumberOfRemovedFaces = &numRemovedFaces;
+  if (numFaceCells > 0)
+  {
+    vtkSMPTools::For(0, numPts, gatherFaces);
+  }
+
+  // Number the points in the order of their first use.
+  std::vector<vtkIdType> newPointIds(streamSize + 1, 0);
+  for (int i = 0; i < 3; ++i)
+  {
+    const vtkIdType size = i < 2 ? sizes[i] : sizes[2] + faceSize;
+    SurfaceMarkFirstUses mark = { output[i].Connectivity,
+      output[i].StreamStart, firstUse.get(), newPointIds.data() };
+    vtkSMPTools::For(0, size, mark);
+  }
+  vtkSMPTools::ExclusiveScan(newPointIds.begin(), newPointIds.end(),
+                             newPointIds.begin(), vtkIdType(0));
+  const vtkIdType numNewPts = newPointIds[streamSize];
+  std::vector<vtkIdType> pointMap(numPts);
+  topology.PointIds.resize(numNewPts);
+  SurfaceMapPoints mapPoints = { firstUse.get(), newPointIds.data(),
+                                 pointMap.data(), topology.PointIds.data() };
+  vtkSMPTools::For(0, numPts, mapPoints);
+  firstUse.reset();
+  for (int i = 0; i < 3; ++i)
+  {
+    const vtkIdType size = i < 2 ? sizes[i] : sizes[2] + faceSize;
+    SurfaceRenumberPoints renumber = { pointMap.data(), output[i].Connectivity };
+    vtkSMPTools::For(0, size, renumber);
+  }
+
+  if (numRemovedFaces > 0)
+  {
+    RemoveSurfaceFaces(topology.Polys, output[2].SourceIds, numCells[2],
+                       keep.data());
+    cellIds.resize(cellIds.size() - numRemovedFaces);
+  }
+  return true;
+}
+
+}
+
+// The surface of an unstructured grid kept between executions, with the
+// modification times telling whether it can be reused.
+class vtkDataSetSurfaceFilter::vtkTopologyCache : public SurfaceTopology
+{
+public:
+  vtkMTimeType CellsTime;
+  vtkMTimeType TypesTime;
+  vtkMTimeType GhostsTime;
+  vtkMTimeType FilterTime;
+  vtkIdType NumberOfPoints;
+};
+
 vtkObjectFactoryNewMacro(vtkDataSetSurfaceFilter);
 
 //----------------------------------------------------------------------------
@@ -130,6 +1107,9 @@ vtkDataSetSurfaceFilter::vtkDataSetSurfaceFilter()
   this->OriginalPointIdsName = nullptr;
 
   this->NonlinearSubdivisionLevel = 1;
+
+  this->ReuseTopology = 0;
+  this->TopologyCache = nullptr;
 }
 
 //----------------------------------------------------------------------------
@@ -137,6 +1117,7 @@ vtkDataSetSurfaceFilter::~vtkDataSetSurfaceFilter()
 {
   this->SetOriginalCellIdsName(nullptr);
   this->SetOriginalPointIdsName(nullptr);
+  delete this->TopologyCache;
 }
 
 //----------------------------------------------------------------------------
@@ -1465,6 +2446,8 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
 
   os << indent << "NonlinearSubdivisionLevel: "
      << this->GetNonlinearSubdivisionLevel() << endl;
+  os << indent << "ReuseTopology: "
+     << (this->ReuseTopology ? "On\n" : "Off\n");
 }
 
 //========================================================================
@@ -1477,6 +2460,18 @@ void vtkDataSetSurfaceFilter::PrintSelf(ostream& os, vtkIndent indent)
 int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
                                                      vtkPolyData *output)
 {
+  // On a single thread, the face hash is faster than the parallel algorithm
+  // unless the surface can be reused.
+  vtkUnstructuredGrid *grid = vtkUnstructuredGrid::SafeDownCast(dataSetInput);
+  if (grid &&
+      (this->ReuseTopology || vtkSMPTools::GetEstimatedNumberOfThreads() > 1) &&
+      this->ParallelUnstructuredGridExecute(grid, output))
+  {
+    return 1;
+  }
+  delete this->TopologyCache;
+  this->TopologyCache = nullptr;
+
   vtkUnstructuredGridBase *input =
       vtkUnstructuredGridBase::SafeDownCast(dataSetInput);
 
@@ -2240,6 +3235,115 @@ int vtkDataSetSurfaceFilter::UnstructuredGridExecute(vtkDataSet *dataSetInput,
   return 1;
 }
 
+//----------------------------------------------------------------------------
+int vtkDataSetSurfaceFilter::ParallelUnstructuredGridExecute(
+  vtkUnstructuredGrid *input, vtkPolyData *output)
+{
+  if (!input->GetPoints() || !input->GetCells() ||
+      !input->GetCellTypesArray() || input->GetFaces())
+  {
+    return 0;
+  }
+
+  // Reuse the surface of the previous execution if the cells did not change.
+  vtkUnsignedCharArray *ghosts = input->GetPointGhostArray();
+  vtkTopologyCache *topology = this->TopologyCache;
+  if (!topology ||
+      topology->CellsTime != input->GetCells()->GetMTime() ||
+      topology->TypesTime != input->GetCellTypesArray()->GetMTime() ||
+      topology->GhostsTime != (ghosts ? ghosts->GetMTime() : 0) ||
+      topology->FilterTime != this->GetMTime() ||
+      topology->NumberOfPoints != input->GetNumberOfPoints())
+  {
+    delete this->TopologyCache;
+    this->TopologyCache = nullptr;
+    topology = new vtkTopologyCache;
+    if (!ExtractSurfaceTopology(input, *topology))
+    {
+      delete topology;
+      return 0;
+    }
+    topology->CellsTime = input->GetCells()->GetMTime();
+    topology->TypesTime = input->GetCellTypesArray()->GetMTime();
+    topology->GhostsTime = ghosts ? ghosts->GetMTime() : 0;
+    topology->FilterTime = this->GetMTime();
+    topology->NumberOfPoints = input->GetNumberOfPoints();
+  }
+  this->UpdateProgress(0.8);
+
+  const vtkIdType numNewPts =
+    static_cast<vtkIdType>(topology->PointIds.size());
+  const vtkIdType numNewCells =
+    static_cast<vtkIdType>(topology->CellIds.size());
+  const vtkIdType *pointIds = topology->PointIds.data();
+  const vtkIdType *cellIds = topology->CellIds.data();
+
+  // Gather the points and the attributes.
+  vtkDataArray *inPts = input->GetPoints()->GetData();
+  vtkNew<vtkPoints> newPts;
+  newPts->SetDataType(inPts->GetDataType());
+  newPts->SetNumberOfPoints(numNewPts);
+  SurfaceGatherPointsWorker gatherPoints = { pointIds, numNewPts };
+  if (!vtkArrayDispatch::Dispatch2SameValueType::Execute(
+        inPts, newPts->GetData(), gatherPoints))
+  {
+    for (vtkIdType i = 0; i < numNewPts; ++i)
+    {
+      newPts->GetData()->SetTuple(i, pointIds[i], inPts);
+    }
+  }
+
+  vtkPointData *outputPD = output->GetPointData();
+  vtkCellData *outputCD = output->GetCellData();
+  output->GetFieldData()->ShallowCopy(input->GetFieldData());
+  outputPD->CopyGlobalIdsOn();
+  outputPD->CopyAllocate(input->GetPointData(), numNewPts);
+  outputPD->ParallelCopyData(input->GetPointData(), pointIds, numNewPts);
+  outputCD->CopyGlobalIdsOn();
+  outputCD->CopyAllocate(input->GetCellData(), numNewCells);
+  outputCD->ParallelCopyData(input->GetCellData(), cellIds, numNewCells);
+  if (this->PassThroughCellIds)
+  {
+    vtkNew<vtkIdTypeArray> originalCellIds;
+    originalCellIds->SetName(this->GetOriginalCellIdsName());
+    originalCellIds->SetNumberOfValues(numNewCells);
+    std::copy(cellIds, cellIds + numNewCells,
+              originalCellIds->GetPointer(0));
+    outputCD->AddArray(originalCellIds);
+  }
+  if (this->PassThroughPointIds)
+  {
+    vtkNew<vtkIdTypeArray> originalPointIds;
+    originalPointIds->SetName(this->GetOriginalPointIdsName());
+    originalPointIds->SetNumberOfValues(numNewPts);
+    std::copy(pointIds, pointIds + numNewPts,
+              originalPointIds->GetPointer(0));
+    outputPD->AddArray(originalPointIds);
+  }
+
+  output->SetPoints(newPts);
+  output->SetPolys(topology->Polys);
+  if (topology->Verts->GetNumberOfCells() > 0)
+  {
+    output->SetVerts(topology->Verts);
+  }
+  if (topology->Lines->GetNumberOfCells() > 0)
+  {
+    output->SetLines(topology->Lines);
+  }
+
+  if (this->ReuseTopology)
+  {
+    this->TopologyCache = topology;
+  }
+  else
+  {
+    delete topology;
+  }
+
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 void vtkDataSetSurfaceFilter::InitializeQuadHash(vtkIdType numPoints)
 {
@@ -21,6 +21,12 @@
  * vtkGeometryFilter.  It only has one option: whether to use triangle strips
  * when the input type is structured.
  *
+ * The surface of unstructured grids made of linear cells only (vertices,
+ * lines, polygons, triangle strips, tetrahedra, hexahedra, voxels, wedges,
+ * pyramids and prisms) is extracted in parallel with vtkSMPTools when more
+ * than one thread is available. The output is the same as the one of the
+ * serial algorithm, which handles the other cells.
+ *
  * @sa
  * vtkGeometryFilter vtkStructuredGridGeometryFilter.
 */
@@ -35,6 +41,7 @@ class vtkPointData;
 class vtkPoints;
 class vtkIdTypeArray;
 class vtkStructuredGrid;
+class vtkUnstructuredGrid;
 
 // Helper structure for hashing faces.
 struct vtkFastGeomQuadStruct
@@ -128,6 +135,23 @@ public:
   vtkGetMacro(NonlinearSubdivisionLevel, int);
   //@}
 
+  //@{
+  /**
+   * If on, the surface extracted from an unstructured grid is kept and
+   * reused by the next execution if the cells, the cell types and the ghost
+   * points of the input did not change (i.e. their modification times are
+   * the same). Only the points and the attributes of the output are gathered
+   * then, which is much faster for time series with a static mesh. This
+   * requires keeping the map from output to input point and cell ids.
+   * Only unstructured grids made of linear cells (see above) are handled,
+   * and they use the parallel algorithm when this is on. By default,
+   * ReuseTopology is Off.
+   */
+  vtkSetMacro(ReuseTopology, vtkTypeBool);
+  vtkGetMacro(ReuseTopology, vtkTypeBool);
+  vtkBooleanMacro(ReuseTopology, vtkTypeBool);
+  //@}
+
   //@{
   /**
    * Direct access methods that can be used to use the this class as an
@@ -239,6 +263,19 @@ protected:
 
   vtkIdType NumberOfNewCells;
 
+  /**
+   * Extract the surface of an unstructured grid in parallel. Return 0,
+   * without touching the output, if the grid has cells that are not handled
+   * (see the class documentation).
+   */
+  int ParallelUnstructuredGridExecute(vtkUnstructuredGrid *input,
+                                      vtkPolyData *output);
+
+  class vtkTopologyCache;
+
+  vtkTypeBool ReuseTopology;
+  vtkTopologyCache *TopologyCache;
+
   // Better memory allocation for faces (hash)
   void InitFastGeomQuadAllocation(vtkIdType numberOfCells);
   vtkFastGeomQuad* NewFastGeomQuad(int numPts);
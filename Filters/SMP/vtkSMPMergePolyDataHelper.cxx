@@ -261,6 +261,9 @@ void MergeCells(std::vector<vtkMergeCellsData>& data,
 
   std::vector<vtkIdList*>::const_iterator mapIter = idMaps.begin();
 
+  // The merged cells are written in the legacy format, over the whole
+  // allocated size.
+  outCells->WritePointer(numCells, outCells->GetSize());
   vtkIdTypeArray* outCellsArray = outCells->GetData();
 
   vtkIdType outCellsOffset = 0;
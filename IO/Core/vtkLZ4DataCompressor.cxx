@@ -22,6 +22,7 @@ vtkStandardNewMacro(vtkLZ4DataCompressor);
 vtkLZ4DataCompressor::vtkLZ4DataCompressor()
 {
   this->AccelerationLevel = 1;
+  this->HighCompression = 0;
 }
 
 //----------------------------------------------------------------------------
@@ -33,6 +34,7 @@ void vtkLZ4DataCompressor::PrintSelf(ostream& os, vtkIndent indent)
   this->Superclass::PrintSelf(os,indent);
 
   os << indent << "AccelerationLevel: " << this->AccelerationLevel << endl;
+  os << indent << "HighCompression: " << this->HighCompression << endl;
 }
 
 //----------------------------------------------------------------------------
@@ -44,11 +46,23 @@ vtkLZ4DataCompressor::CompressBuffer(unsigned char const* uncompressedData,
 {
   const char *ud = reinterpret_cast<const char *>(uncompressedData);
   char *cd = reinterpret_cast<char*>(compressedData);
-  // Call LZ4's compress function.
-  int cs =
-    LZ4_compress_fast(ud, cd,
+  int cs;
+  if (this->HighCompression)
+  {
+    // Map the compression level 1..9 to the LZ4HC levels 4..12.
+    int level = 10 - this->AccelerationLevel;
+    level = (level < 1 ? 1 : (level > 9 ? 9 : level));
+    cs = LZ4_compress_HC(ud, cd,
+      static_cast<int>(uncompressedSize),
+      static_cast<int>(compressionSpace), level + 3);
+  }
+  else
+  {
+    // Call LZ4's compress function.
+    cs = LZ4_compress_fast(ud, cd,
       static_cast<int>(uncompressedSize),
       static_cast<int>(compressionSpace), this->AccelerationLevel);
+  }
   if (cs == 0)
   {
     vtkErrorMacro("LZ4 error while compressing data.");
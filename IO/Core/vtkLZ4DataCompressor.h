@@ -54,11 +54,26 @@ public:
   vtkSetClampMacro(AccelerationLevel, int, 1, VTK_INT_MAX);
   vtkGetMacro(AccelerationLevel, int);
 
+  //@{
+  /**
+   * Use the high compression mode of LZ4 (LZ4HC), which compresses more,
+   * close to zlib, but more slowly than the default fast mode.  The data
+   * format and the decompression speed do not change, so data compressed in
+   * either mode are read the same way.  In this mode, compression levels 1
+   * to 9 select LZ4HC levels 4 to 12.  Default is off.  XML writers select
+   * this mode with vtkXMLWriter::SetCompressorTypeToLZ4HC().
+   */
+  vtkSetMacro(HighCompression, vtkTypeBool);
+  vtkGetMacro(HighCompression, vtkTypeBool);
+  vtkBooleanMacro(HighCompression, vtkTypeBool);
+  //@}
+
 protected:
   vtkLZ4DataCompressor();
   ~vtkLZ4DataCompressor() override;
 
   int AccelerationLevel;
+  vtkTypeBool HighCompression;
 
   // Compression method required by vtkDataCompressor.
   size_t CompressBuffer(unsigned char const* uncompressedData,
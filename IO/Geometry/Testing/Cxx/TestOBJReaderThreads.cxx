@@ -0,0 +1,137 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestOBJReaderThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkOBJReader reads the "v", "vt" and "vn" lines, which are
+// parsed in parallel, in order with one and with several threads, and that
+// it still reports the line of a vertex it cannot read.
+
+#include "vtkCommand.h"
+#include "vtkFloatArray.h"
+#include "vtkNew.h"
+#include "vtkOBJReader.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestArrays.h"
+#include "vtkTestErrorObserver.h"
+#include "vtkTestSMP.h"
+#include "vtkTestUtilities.h"
+
+#include <cstdio>
+#include <string>
+
+int TestOBJReaderThreads(int argc, char *argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv,
+                                                         "VTK_TEMP_DIR",
+                                                         "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestOBJReaderThreads.obj";
+  delete [] tempDir;
+
+  // A grid of triangles with more vertices than parsed in one block.
+  const int res = 300;
+  const vtkIdType numPts = res * res;
+  vtkNew<vtkFloatArray> points, tcoords, normals;
+  points->SetNumberOfComponents(3);
+  points->SetNumberOfTuples(numPts);
+  tcoords->SetNumberOfComponents(2);
+  tcoords->SetNumberOfTuples(numPts);
+  normals->SetNumberOfComponents(3);
+  normals->SetNumberOfTuples(numPts);
+  FILE* file = fopen(fileName.c_str(), "w");
+  if (!file)
+  {
+    std::cerr << "Cannot write " << fileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    float x[3] = { (i % res) / 7.0f, (i / res) / 3.0f, 1.0f / (i + 1) };
+    points->SetTypedTuple(i, x);
+    fprintf(file, "v %.9g %.9g %.9g\n", x[0], x[1], x[2]);
+  }
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    float uv[2] = { (i % res) / float(res), 1.0f / (i + 3) };
+    tcoords->SetTypedTuple(i, uv);
+    fprintf(file, "vt %.9g %.9g\n", uv[0], uv[1]);
+  }
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    float n[3] = { 0.0f, -1.0f / (i + 5), 1.0f };
+    normals->SetTypedTuple(i, n);
+    fprintf(file, "vn %.9g\t%.9g %.9g\n", n[0], n[1], n[2]);
+  }
+  for (int j = 0; j + 1 < res; ++j)
+  {
+    for (int i = 0; i + 1 < res; ++i)
+    {
+      // (indices are one-based)
+      long long p = j * res + i + 1;
+      long long q = p + res;
+      fprintf(file, "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+              p, p, p, p + 1, p + 1, p + 1, q, q, q);
+      fprintf(file, "f %lld/%lld/%lld %lld/%lld/%lld %lld/%lld/%lld\n",
+              p + 1, p + 1, p + 1, q + 1, q + 1, q + 1, q, q, q);
+    }
+  }
+  fclose(file);
+
+  for (int parallel = 0; parallel < 2; ++parallel)
+  {
+    vtkNew<vtkOBJReader> reader;
+    reader->SetFileName(fileName.c_str());
+    vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { reader->Update(); });
+    vtkPolyData* output = reader->GetOutput();
+    if (!vtkTest::SameValues(points, output->GetPoints()->GetData()) ||
+        !vtkTest::SameValues(tcoords, output->GetPointData()->GetTCoords()) ||
+        !vtkTest::SameValues(normals, output->GetPointData()->GetNormals()) ||
+        output->GetNumberOfPolys() != 2 * (res - 1) * (res - 1))
+    {
+      std::cerr << "The grid read with "
+                << (parallel ? "several threads" : "one thread")
+                << " differs from the grid written" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // A vertex that is not three floats is reported with its line.
+  file = fopen(fileName.c_str(), "w");
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    if (i == 70000)
+    {
+      fprintf(file, "v 1.0 oops 2.0\n");
+    }
+    else
+    {
+      fprintf(file, "v %lld 0 0\n", (long long)i);
+    }
+  }
+  fclose(file);
+
+  vtkNew<vtkTest::ErrorObserver> errorObserver;
+  vtkNew<vtkOBJReader> reader;
+  reader->AddObserver(vtkCommand::ErrorEvent, errorObserver);
+  reader->SetFileName(fileName.c_str());
+  vtkTest::RunThreaded(4, [&]() { reader->Update(); });
+  if (errorObserver->CheckErrorMessage("Error reading 'v' at line 70001") ||
+      reader->GetOutput()->GetNumberOfPoints() != 0)
+  {
+    return EXIT_FAILURE;
+  }
+
+  remove(fileName.c_str());
+  return EXIT_SUCCESS;
+}
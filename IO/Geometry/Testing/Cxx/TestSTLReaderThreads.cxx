@@ -0,0 +1,245 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestSTLReaderThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkSTLReader reads the same surfaces from ASCII and binary
+// files with one and with several threads, and that merging the points
+// without locator gives the same surfaces as merging them with a
+// vtkMergePoints.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDataArray.h"
+#include "vtkMergePoints.h"
+#include "vtkNew.h"
+#include "vtkPoints.h"
+#include "vtkPolyData.h"
+#include "vtkSTLReader.h"
+#include "vtkSTLWriter.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestSMP.h"
+#include "vtkTestUtilities.h"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+
+// Two solids, with a degenerate triangle, blank lines, a color, upper case
+// keywords, and no new line at the end of the file.
+const char* File =
+  "solid first part\r\n"
+  "  facet normal 0 0 1\r\n"
+  "    outer loop\r\n"
+  "      vertex 0 0 0\r\n"
+  "      vertex 1 0 0\r\n"
+  "      vertex 0 1 0\r\n"
+  "    endloop\r\n"
+  "  endfacet\r\n"
+  "\r\n"
+  "  facet normal 0 0 1\r\n"
+  "    outer loop\r\n"
+  "      vertex 1 0 0\r\n"
+  "      vertex 1 1 0\r\n"
+  "      vertex 0 1 0\r\n"
+  "    endloop\r\n"
+  "  endfacet\r\n"
+  "endsolid first part\r\n"
+  "SOLID second\n"
+  "color 1 0 0\n"
+  "FACET NORMAL 0 0 1\n"
+  "OUTER LOOP\n"
+  "VERTEX 1 1 0\n"
+  "VERTEX 1e0 1 0.0\n"
+  "VERTEX 2 2 0\n"
+  "ENDLOOP\n"
+  "ENDFACET\n"
+  "facet normal 0 0 1\n"
+  "\touter loop\n"
+  "\t\tvertex 1 1 0\n"
+  "\t\tvertex 2 1 0\n"
+  "\t\tvertex 2 2 -0\n"
+  "\tendloop\n"
+  "endfacet\n"
+  "endsolid second";
+
+bool SameSurfaces(vtkPolyData *a, vtkPolyData *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+    {
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> aIds, bIds;
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+  {
+    a->GetCellPoints(i, aIds);
+    b->GetCellPoints(i, bIds);
+    if (aIds->GetNumberOfIds() != bIds->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType j = 0; j < aIds->GetNumberOfIds(); ++j)
+    {
+      if (aIds->GetId(j) != bIds->GetId(j))
+      {
+        return false;
+      }
+    }
+  }
+  vtkDataArray *aTags = a->GetCellData()->GetScalars();
+  vtkDataArray *bTags = b->GetCellData()->GetScalars();
+  if (!aTags || !bTags)
+  {
+    return !aTags && !bTags;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+  {
+    if (aTags->GetTuple1(i) != bTags->GetTuple1(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+vtkSmartPointer<vtkPolyData> Read(const std::string& fileName, bool merging,
+                                  bool locator, bool tags)
+{
+  vtkNew<vtkSTLReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetMerging(merging);
+  reader->SetScalarTags(tags);
+  if (locator)
+  {
+    vtkNew<vtkMergePoints> mergePoints;
+    reader->SetLocator(mergePoints);
+  }
+  reader->Update();
+  return reader->GetOutput();
+}
+
+// Read the file in all the ways and compare the surfaces with the one read
+// by one thread with a vtkMergePoints.
+bool CheckFile(const std::string& fileName, bool tags)
+{
+  for (int merging = 0; merging < 2; ++merging)
+  {
+    vtkSmartPointer<vtkPolyData> expected;
+    vtkTest::RunThreaded(
+      1, [&]() { expected = Read(fileName, merging != 0, true, tags); });
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+      vtkSmartPointer<vtkPolyData> read;
+      vtkTest::RunThreaded(parallel ? 4 : 1, [&]() {
+        read = Read(fileName, merging != 0, false, tags);
+      });
+      if (!SameSurfaces(expected, read))
+      {
+        std::cerr << "The surface read from " << fileName << " with "
+                  << (parallel ? "several threads" : "one thread")
+                  << (merging ? " and merging" : "")
+                  << " differs from the expected one" << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+int TestSTLReaderThreads(int argc, char *argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv,
+                                                         "VTK_TEMP_DIR",
+                                                         "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestSTLReaderThreads.stl";
+  delete [] tempDir;
+
+  FILE *fp = fopen(fileName.c_str(), "wb");
+  if (!fp || fputs(File, fp) < 0)
+  {
+    std::cerr << "Cannot write " << fileName << std::endl;
+    return EXIT_FAILURE;
+  }
+  fclose(fp);
+  vtkNew<vtkSTLReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->ScalarTagsOn();
+  reader->Update();
+  vtkPolyData *output = reader->GetOutput();
+  if (output->GetNumberOfPoints() != 6 || output->GetNumberOfCells() != 3 ||
+      output->GetCellData()->GetScalars()->GetTuple1(2) != 1 ||
+      std::string(reader->GetHeader()) != "first part\nsecond")
+  {
+    std::cerr << "Wrong surface read from the ASCII file" << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (!CheckFile(fileName, true))
+  {
+    return EXIT_FAILURE;
+  }
+
+  // A sphere, large enough to be read in several blocks and pieces, with a
+  // degenerate triangle.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(300);
+  sphere->SetPhiResolution(150);
+  sphere->Update();
+  vtkNew<vtkPolyData> surface;
+  surface->DeepCopy(sphere->GetOutput());
+  vtkIdType degenerate[3] = { 0, 1, 1 };
+  surface->GetPolys()->InsertNextCell(3, degenerate);
+
+  for (int binary = 0; binary < 2; ++binary)
+  {
+    vtkNew<vtkSTLWriter> writer;
+    writer->SetInputData(surface);
+    writer->SetFileName(fileName.c_str());
+    writer->SetFileType(binary ? VTK_BINARY : VTK_ASCII);
+    if (!writer->Write())
+    {
+      std::cerr << "Cannot write " << fileName << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vtkSmartPointer<vtkPolyData> read = Read(fileName, true, false, false);
+    if (read->GetNumberOfPoints() != sphere->GetOutput()->GetNumberOfPoints() ||
+        read->GetNumberOfCells() != sphere->GetOutput()->GetNumberOfCells())
+    {
+      std::cerr << "Wrong surface read from the "
+                << (binary ? "binary" : "ASCII") << " file" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (!CheckFile(fileName, false))
+    {
+      return EXIT_FAILURE;
+    }
+  }
+
+  remove(fileName.c_str());
+  return EXIT_SUCCESS;
+}
@@ -21,14 +21,98 @@
 #include "vtkObjectFactory.h"
 #include "vtkPointData.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include <cctype>
+#include <cstdlib>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "vtkCellData.h"
 #include "vtkStringArray.h"
 
 vtkStandardNewMacro(vtkOBJReader);
 
+namespace
+{
+
+//----------------------------------------------------------------------------
+// Lines of floats ("v", "vn", "vt") collected while the file is scanned, and
+// parsed in parallel a block of lines at a time. Only the values are parsed
+// here, the order of the lines and the indices referring to them are kept
+// by the scan.
+class vtkOBJPendingLines
+{
+public:
+  explicit vtkOBJPendingLines(int numberOfValues)
+    : NumberOfValues(numberOfValues)
+  {
+  }
+
+  void Add(const char *values, int lineNr)
+  {
+    this->Starts.push_back(this->Text.size());
+    this->Text.append(values);
+    this->Text.push_back('\0');
+    this->LineNumbers.push_back(lineNr);
+  }
+
+  bool IsFull() const { return this->Starts.size() >= 65536; }
+
+  vtkIdType GetNumberOfLines() const
+  {
+    return static_cast<vtkIdType>(this->Starts.size());
+  }
+
+  // Parse NumberOfValues floats on each line as sscanf("%f") would.
+  void Parse()
+  {
+    vtkIdType numLines = this->GetNumberOfLines();
+    this->Values.resize(numLines * this->NumberOfValues);
+    this->Parsed.resize(numLines);
+    vtkSMPTools::For(0, numLines, [this](vtkIdType begin, vtkIdType end) {
+      for (vtkIdType i = begin; i < end; ++i)
+      {
+        const char *ptr = this->Text.data() + this->Starts[i];
+        float *values = this->Values.data() + i * this->NumberOfValues;
+        bool parsed = true;
+        for (int c = 0; c < this->NumberOfValues && parsed; ++c)
+        {
+          char *end = nullptr;
+          values[c] = strtof(ptr, &end);
+          parsed = end != ptr;
+          ptr = end;
+        }
+        this->Parsed[i] = parsed;
+      }
+    });
+  }
+
+  bool IsParsed(vtkIdType i) const { return this->Parsed[i] != 0; }
+  const float* GetValues(vtkIdType i) const
+  {
+    return this->Values.data() + i * this->NumberOfValues;
+  }
+  int GetLineNumber(vtkIdType i) const { return this->LineNumbers[i]; }
+
+  void Clear()
+  {
+    this->Text.clear();
+    this->Starts.clear();
+    this->LineNumbers.clear();
+  }
+
+private:
+  int NumberOfValues;
+  std::string Text;
+  std::vector<size_t> Starts;
+  std::vector<int> LineNumbers;
+  std::vector<float> Values;
+  std::vector<char> Parsed;
+};
+
+}
+
 //----------------------------------------------------------------------------
 vtkOBJReader::vtkOBJReader()
 {
@@ -179,11 +263,59 @@ int vtkOBJReader::RequestData(
   const int MAX_LINE = 1024 * 256;
   char rawLine[MAX_LINE];
   char tcoordsName[100];
-  float xyz[3];
   int numPoints = 0;
   int numTCoords = 0;
   int numNormals = 0;
 
+  // The floats of the "v", "vn" and "vt" lines are parsed in parallel, a
+  // block of lines at a time, and added in the order of the lines.
+  vtkOBJPendingLines pendingTCoords(2);
+  vtkOBJPendingLines pendingPoints(3);
+  vtkOBJPendingLines pendingNormals(3);
+  auto addTCoords = [&]() {
+    pendingTCoords.Parse();
+    for (vtkIdType i = 0; i < pendingTCoords.GetNumberOfLines(); ++i)
+    {
+      // lines without two floats are skipped
+      if (pendingTCoords.IsParsed(i))
+      {
+        const float *uv = pendingTCoords.GetValues(i);
+        verticesTextureList.emplace_back(uv[0], uv[1]);
+      }
+    }
+    pendingTCoords.Clear();
+  };
+  auto addPoints = [&]() {
+    pendingPoints.Parse();
+    for (vtkIdType i = 0; i < pendingPoints.GetNumberOfLines(); ++i)
+    {
+      if (!pendingPoints.IsParsed(i))
+      {
+        vtkErrorMacro(<<"Error reading 'v' at line "
+                      << pendingPoints.GetLineNumber(i));
+        everything_ok = false;
+        break;
+      }
+      points->InsertNextPoint(pendingPoints.GetValues(i));
+    }
+    pendingPoints.Clear();
+  };
+  auto addNormals = [&]() {
+    pendingNormals.Parse();
+    for (vtkIdType i = 0; i < pendingNormals.GetNumberOfLines(); ++i)
+    {
+      if (!pendingNormals.IsParsed(i))
+      {
+        vtkErrorMacro(<<"Error reading 'vn' at line "
+                      << pendingNormals.GetLineNumber(i));
+        everything_ok = false;
+        break;
+      }
+      normals->InsertNextTuple(pendingNormals.GetValues(i));
+    }
+    pendingNormals.Clear();
+  };
+
   // First loop to initialize the data arrays for the different set of texture coordinates
   bool readingFirstComment = true;
   std::string firstComment;
@@ -255,12 +387,14 @@ int vtkOBJReader::RequestData(
     else if (strcmp(cmd, "vt") == 0)
     {
       // this is a tcoord, expect two floats, separated by whitespace:
-      if (sscanf(pLine, "%f %f", xyz, xyz+1) == 2)
+      pendingTCoords.Add(pLine, lineNr);
+      if (pendingTCoords.IsFull())
       {
-        verticesTextureList.emplace_back(xyz[0], xyz[1]);
+        addTCoords();
       }
     }
   } // (end of first while loop)
+  addTCoords();
 
   // Comment lines include newline characters.
   // Keep newlines between lines of multi-line comment, but
@@ -331,15 +465,11 @@ int vtkOBJReader::RequestData(
     else if (strcmp(cmd, "v") == 0)
     {
       // vertex definition, expect three floats, separated by whitespace:
-      if (sscanf(pLine, "%f %f %f", xyz, xyz+1, xyz+2) == 3)
+      pendingPoints.Add(pLine, lineNr);
+      numPoints++;
+      if (pendingPoints.IsFull())
       {
-        points->InsertNextPoint(xyz);
-        numPoints++;
-      }
-      else
-      {
-        vtkErrorMacro(<<"Error reading 'v' at line " << lineNr);
-        everything_ok = false;
+        addPoints();
       }
     }
     else if (strcmp(cmd, "usemtl") == 0)
@@ -367,16 +497,12 @@ int vtkOBJReader::RequestData(
     else if (strcmp(cmd, "vn") == 0)
     {
       // vertex normal, expect three floats, separated by whitespace:
-      if (sscanf(pLine, "%f %f %f", xyz, xyz+1, xyz+2) == 3)
-      {
-        normals->InsertNextTuple(xyz);
-        hasNormals = true;
-        numNormals++;
-      }
-      else
+      pendingNormals.Add(pLine, lineNr);
+      hasNormals = true;
+      numNormals++;
+      if (pendingNormals.IsFull())
       {
-        vtkErrorMacro(<<"Error reading 'vn' at line " << lineNr);
-        everything_ok = false;
+        addNormals();
       }
     }
     else if (strcmp(cmd, "p") == 0)
@@ -722,6 +848,15 @@ int vtkOBJReader::RequestData(
 
   } // (end of while loop)
 
+  if (everything_ok)
+  {
+    addPoints();
+  }
+  if (everything_ok)
+  {
+    addNormals();
+  }
+
   } // (end of local scope section)
 
   // we have finished with the file
@@ -18,6 +18,10 @@
  *
  * vtkOBJReader is a source object that reads Wavefront .obj
  * files. The output of this source object is polygonal data.
+ *
+ * The values of the vertex ("v"), normal ("vn") and texture coordinate
+ * ("vt") lines are parsed in parallel with vtkSMPTools, a block of lines at
+ * a time; the faces and the other lines are read serially.
  * @sa
  * vtkOBJImporter
 */
@@ -19,6 +19,7 @@
 #include "vtkCellData.h"
 #include "vtkErrorCode.h"
 #include "vtkFloatArray.h"
+#include "vtkIdTypeArray.h"
 #include "vtkIncrementalPointLocator.h"
 #include "vtkInformation.h"
 #include "vtkInformationVector.h"
@@ -26,13 +27,17 @@
 #include "vtkNew.h"
 #include "vtkObjectFactory.h"
 #include "vtkPolyData.h"
+#include "vtkSMPTools.h"
 #include "vtkSmartPointer.h"
+#include "vtkStaticPointLocator.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 
 #include <algorithm>
 #include <cctype>
 #include <cstdlib>
+#include <cstring>
 #include <string>
+#include <vector>
 #include <vtksys/SystemTools.hxx>
 
 vtkStandardNewMacro(vtkSTLReader);
@@ -43,6 +48,167 @@ vtkStandardNewMacro(vtkSTLReader);
 vtkCxxSetObjectMacro(vtkSTLReader, Locator, vtkIncrementalPointLocator);
 vtkCxxSetObjectMacro(vtkSTLReader, BinaryHeader, vtkUnsignedCharArray);
 
+namespace
+{
+
+// The triangles read are made of consecutive points: triangle i is made of
+// points 3i, 3i+1 and 3i+2.
+struct stlMakeTriangles
+{
+  vtkIdType *Offsets;
+  vtkIdType *Connectivity;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->Offsets[i] = 3 * i;
+      this->Connectivity[3 * i] = 3 * i;
+      this->Connectivity[3 * i + 1] = 3 * i + 1;
+      this->Connectivity[3 * i + 2] = 3 * i + 2;
+    }
+  }
+};
+
+void stlSetTriangles(vtkCellArray *polys, vtkIdType numTris)
+{
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numTris + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(3 * numTris);
+  stlMakeTriangles make = { offsets->GetPointer(0),
+                            connectivity->GetPointer(0) };
+  vtkSMPTools::For(0, numTris, make);
+  offsets->SetValue(numTris, 3 * numTris);
+  polys->SetData(offsets, connectivity);
+}
+
+// Copy the vertices of binary facets, 50 bytes each made of the normal, the
+// three vertices and two bytes of attributes, to the points.
+struct stlDecodeFacets
+{
+  const unsigned char *Facets;
+  float *Points;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      memcpy(this->Points + 9 * i, this->Facets + 50 * i + 12,
+             9 * sizeof(float));
+    }
+    vtkByteSwap::Swap4LERange(this->Points + 9 * begin, 9 * (end - begin));
+  }
+};
+
+// Number the merged points in the order of the first point of each set of
+// coincident points, as inserting the points one after the other in a
+// vtkMergePoints does.
+struct stlRenumberPoints
+{
+  vtkIdType *PointMap;
+  const vtkIdType *NewIds;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      this->PointMap[i] = this->NewIds[this->PointMap[i]];
+    }
+  }
+};
+
+struct stlCopyMergedPoints
+{
+  const float *Points;
+  const vtkIdType *FirstIds;
+  float *MergedPoints;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      memcpy(this->MergedPoints + 3 * i, this->Points + 3 * this->FirstIds[i],
+             3 * sizeof(float));
+    }
+  }
+};
+
+// Merge the coincident points of the triangles read and drop the triangles
+// that become degenerate. The result is the same as inserting the points in
+// a vtkMergePoints, but the points are merged in parallel.
+void stlMergePoints(vtkPoints *points, vtkFloatArray *scalars,
+                    vtkPoints *mergedPts, vtkCellArray *mergedPolys,
+                    vtkFloatArray *mergedScalars)
+{
+  vtkIdType numPts = points->GetNumberOfPoints();
+  vtkIdType numTris = numPts / 3;
+  std::vector<vtkIdType> pointMap(numPts);
+  if (numPts > 0)
+  {
+    vtkNew<vtkPolyData> cloud;
+    cloud->SetPoints(points);
+    vtkNew<vtkStaticPointLocator> locator;
+    locator->SetDataSet(cloud);
+    locator->BuildLocator();
+    locator->MergePoints(0.0, pointMap.data());
+  }
+
+  std::vector<vtkIdType> newIds(numPts, -1);
+  std::vector<vtkIdType> firstIds;
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    vtkIdType& newId = newIds[pointMap[i]];
+    if (newId < 0)
+    {
+      newId = static_cast<vtkIdType>(firstIds.size());
+      firstIds.push_back(i);
+    }
+  }
+  stlRenumberPoints renumber = { pointMap.data(), newIds.data() };
+  vtkSMPTools::For(0, numPts, renumber);
+  std::vector<vtkIdType>().swap(newIds);
+
+  vtkIdType numMergedPts = static_cast<vtkIdType>(firstIds.size());
+  mergedPts->SetDataTypeToFloat();
+  mergedPts->SetNumberOfPoints(numMergedPts);
+  stlCopyMergedPoints copy = {
+    static_cast<vtkFloatArray*>(points->GetData())->GetPointer(0),
+    firstIds.data(),
+    static_cast<vtkFloatArray*>(mergedPts->GetData())->GetPointer(0) };
+  vtkSMPTools::For(0, numMergedPts, copy);
+
+  vtkNew<vtkIdTypeArray> offsets;
+  offsets->SetNumberOfValues(numTris + 1);
+  vtkNew<vtkIdTypeArray> connectivity;
+  connectivity->SetNumberOfValues(3 * numTris);
+  vtkIdType *offset = offsets->GetPointer(0);
+  vtkIdType *ids = connectivity->GetPointer(0);
+  const vtkIdType *nodes = pointMap.data();
+  vtkIdType numMergedTris = 0;
+  for (vtkIdType i = 0; i < numTris; ++i, nodes += 3)
+  {
+    if (nodes[0] != nodes[1] && nodes[0] != nodes[2] && nodes[1] != nodes[2])
+    {
+      offset[numMergedTris] = 3 * numMergedTris;
+      ids[3 * numMergedTris] = nodes[0];
+      ids[3 * numMergedTris + 1] = nodes[1];
+      ids[3 * numMergedTris + 2] = nodes[2];
+      if (scalars)
+      {
+        mergedScalars->InsertNextValue(scalars->GetValue(i));
+      }
+      ++numMergedTris;
+    }
+  }
+  offset[numMergedTris] = 3 * numMergedTris;
+  offsets->Resize(numMergedTris + 1);
+  connectivity->Resize(3 * numMergedTris);
+  mergedPolys->SetData(offsets, connectivity);
+}
+
+} // end of anonymous namespace
+
 //------------------------------------------------------------------------------
 // Construct object with merging set to true.
 vtkSTLReader::vtkSTLReader()
@@ -167,53 +333,64 @@ int vtkSTLReader::RequestData(
 
   fclose(fp);
 
-  // If merging is on, create hash table and merge points/triangles.
+  // If merging is on, merge points/triangles. Without a locator and with
+  // several threads, the points are merged in parallel once all read.
   vtkPoints *mergedPts = newPts.Get();
   vtkCellArray *mergedPolys = newPolys.Get();
   vtkFloatArray *mergedScalars = newScalars;
   if (this->Merging)
   {
     mergedPts = vtkPoints::New();
-    mergedPts->Allocate(newPts->GetNumberOfPoints() /2);
     mergedPolys = vtkCellArray::New();
-    mergedPolys->Allocate(newPolys->GetSize());
     if (newScalars)
     {
       mergedScalars = vtkFloatArray::New();
-      mergedScalars->Allocate(newPolys->GetSize());
+      mergedScalars->Allocate(newPolys->GetNumberOfCells());
     }
 
-    vtkSmartPointer<vtkIncrementalPointLocator> locator = this->Locator;
-    if (this->Locator == nullptr)
+    if (this->Locator == nullptr &&
+        vtkSMPTools::GetEstimatedNumberOfThreads() > 1)
     {
-      locator.TakeReference(this->NewDefaultLocator());
+      stlMergePoints(newPts, newScalars, mergedPts, mergedPolys,
+                     mergedScalars);
     }
-    locator->InitPointInsertion(mergedPts, newPts->GetBounds());
-
-    int nextCell = 0;
-    vtkIdType *pts = nullptr;
-    vtkIdType npts;
-    for (newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);)
+    else
     {
-      vtkIdType nodes[3];
-      for (int i = 0; i < 3; i++)
+      mergedPts->Allocate(newPts->GetNumberOfPoints() /2);
+      mergedPolys->Allocate(newPolys->GetSize());
+
+      vtkSmartPointer<vtkIncrementalPointLocator> locator = this->Locator;
+      if (this->Locator == nullptr)
       {
-        double x[3];
-        newPts->GetPoint(pts[i], x);
-        locator->InsertUniquePoint(x, nodes[i]);
+        locator.TakeReference(this->NewDefaultLocator());
       }
+      locator->InitPointInsertion(mergedPts, newPts->GetBounds());
 
-      if (nodes[0] != nodes[1] &&
-        nodes[0] != nodes[2] &&
-        nodes[1] != nodes[2])
+      int nextCell = 0;
+      vtkIdType *pts = nullptr;
+      vtkIdType npts;
+      for (newPolys->InitTraversal(); newPolys->GetNextCell(npts, pts);)
       {
-        mergedPolys->InsertNextCell(3, nodes);
-        if (newScalars)
+        vtkIdType nodes[3];
+        for (int i = 0; i < 3; i++)
         {
-          mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+          double x[3];
+          newPts->GetPoint(pts[i], x);
+          locator->InsertUniquePoint(x, nodes[i]);
         }
+
+        if (nodes[0] != nodes[1] &&
+          nodes[0] != nodes[2] &&
+          nodes[1] != nodes[2])
+        {
+          mergedPolys->InsertNextCell(3, nodes);
+          if (newScalars)
+          {
+            mergedScalars->InsertNextValue(newScalars->GetValue(nextCell));
+          }
+        }
+        nextCell++;
       }
-      nextCell++;
     }
 
     if (newScalars)
@@ -227,10 +404,12 @@ int vtkSTLReader::RequestData(
   }
 
   output->SetPoints(mergedPts);
-  mergedPts->Delete();
-
   output->SetPolys(mergedPolys);
-  mergedPolys->Delete();
+  if (this->Merging)
+  {
+    mergedPts->Delete();
+    mergedPolys->Delete();
+  }
 
   if (mergedScalars)
   {
@@ -253,8 +432,6 @@ int vtkSTLReader::RequestData(
 bool vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
                                  vtkCellArray *newPolys)
 {
-  typedef struct { float  n[3], v1[3], v2[3], v3[3]; } facet_t;
-
   vtkDebugMacro(<< "Reading BINARY STL file");
 
   //  File is read to obtain raw information as well as bounding box
@@ -307,50 +484,42 @@ bool vtkSTLReader::ReadBinarySTL(FILE *fp, vtkPoints *newPts,
   }
 
   // now we can allocate the memory we need for this STL file
-  newPts->Allocate(numTris * 3);
-  newPolys->Allocate(numTris);
-
-  facet_t facet;
-  for (int i = 0; fread(&facet, 48, 1, fp) > 0; i++)
+  newPts->SetDataTypeToFloat();
+  newPts->Allocate(3 * static_cast<vtkIdType>(numTris));
+
+  // Read the facets a block at a time, and copy their vertices to the
+  // points in parallel.
+  const vtkIdType blockSize = 65536;
+  std::vector<unsigned char> block(50 * blockSize);
+  vtkIdType numRead = 0;
+  for (;;)
   {
-    unsigned short ibuff2;
-    if (fread(&ibuff2, 2, 1, fp) != 1) //read extra junk
+    size_t size = fread(block.data(), 1, block.size(), fp);
+    vtkIdType numFacets = static_cast<vtkIdType>(size / 50);
+    newPts->SetNumberOfPoints(3 * (numRead + numFacets));
+    float *points =
+      static_cast<vtkFloatArray*>(newPts->GetData())->GetPointer(9 * numRead);
+    stlDecodeFacets decode = { block.data(), points };
+    vtkSMPTools::For(0, numFacets, decode);
+    numRead += numFacets;
+
+    if (size < block.size())
     {
-      vtkErrorMacro("STLReader error reading file: " << this->FileName
-        << " Premature EOF while reading extra junk.");
-      return false;
+      if (size % 50 >= 48)
+      {
+        vtkErrorMacro("STLReader error reading file: " << this->FileName
+          << " Premature EOF while reading extra junk.");
+        return false;
+      }
+      break;
     }
 
-    vtkByteSwap::Swap4LE(facet.n);
-    vtkByteSwap::Swap4LE(facet.n+1);
-    vtkByteSwap::Swap4LE(facet.n+2);
-
-    vtkByteSwap::Swap4LE(facet.v1);
-    vtkByteSwap::Swap4LE(facet.v1+1);
-    vtkByteSwap::Swap4LE(facet.v1+2);
-
-    vtkByteSwap::Swap4LE(facet.v2);
-    vtkByteSwap::Swap4LE(facet.v2+1);
-    vtkByteSwap::Swap4LE(facet.v2+2);
-
-    vtkByteSwap::Swap4LE(facet.v3);
-    vtkByteSwap::Swap4LE(facet.v3+1);
-    vtkByteSwap::Swap4LE(facet.v3+2);
-
-    vtkIdType pts[3];
-    pts[0] = newPts->InsertNextPoint(facet.v1);
-    pts[1] = newPts->InsertNextPoint(facet.v2);
-    pts[2] = newPts->InsertNextPoint(facet.v3);
-
-    newPolys->InsertNextCell(3, pts);
-
-    if ((i % 5000) == 0 && i != 0)
-    {
-      vtkDebugMacro(<< "triangle# " << i);
-      this->UpdateProgress(static_cast<double>(i) / numTris);
-    }
+    vtkDebugMacro(<< "triangle# " << numRead);
+    this->UpdateProgress(static_cast<double>(numRead) / numTris);
   }
 
+  stlSetTriangles(newPolys, numRead);
+
   return true;
 }
 
@@ -394,6 +563,87 @@ bool stlReadVertex(char* buf, float vertCoord[3])
   return true;
 }
 
+// A line of an ASCII file, split into its first token (cmd), lowercased,
+// and its arguments (arg). The coordinates of "vertex" lines are parsed
+// along with the line.
+struct stlLine
+{
+  char *Command;
+  char *Argument;
+  float Vertex[3];
+  bool ValidVertex;
+};
+
+void stlSplitLine(char *line, stlLine &split)
+{
+  // Cue to the first non-space.
+  char *cmd = line;
+  while (isspace(*cmd))
+  {
+    ++cmd;
+  }
+
+  // Ensure consistent case on the first token and separate from
+  // subsequent arguments
+  char *arg = cmd;
+  while (*arg && !isspace(*arg))
+  {
+    *arg = tolower(*arg);
+    ++arg;
+  }
+
+  // Terminate first token (cmd)
+  if (*arg)
+  {
+    *arg = '\0';
+    ++arg;
+
+    while (isspace(*arg))
+    {
+      ++arg;
+    }
+  }
+
+  split.Command = cmd;
+  split.Argument = arg;
+  split.ValidVertex =
+    !strcmp(cmd, "vertex") && stlReadVertex(arg, split.Vertex);
+}
+
+// Split the lines of pieces of a block of the file. Pieces start at the
+// beginning of a line and end after a new line, or at the end of the file.
+struct stlSplitLines
+{
+  char *Block;
+  const std::vector<size_t> &Pieces;
+  std::vector<std::vector<stlLine> > &Lines;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType piece = begin; piece < end; ++piece)
+    {
+      char *first = this->Block + this->Pieces[piece];
+      char *last = this->Block + this->Pieces[piece + 1];
+      std::vector<stlLine> &lines = this->Lines[piece];
+      lines.clear();
+      lines.reserve((last - first) / 32);
+      while (first < last)
+      {
+        char *eol = static_cast<char*>(memchr(first, '\n', last - first));
+        if (!eol)
+        {
+          eol = last;
+        }
+        *eol = '\0';
+        stlLine line;
+        stlSplitLine(first, line);
+        lines.push_back(line);
+        first = eol + 1;
+      }
+    }
+  }
+};
+
 } // end of anonymous namespace
 
 
@@ -430,9 +680,9 @@ bool vtkSTLReader::ReadASCIISTL(FILE *fp, vtkPoints *newPts,
   this->SetBinaryHeader(nullptr);
   std::string header;
 
-  char line[256];         // line buffer
-  float vertCoord[3];     // scratch space when parsing "vertex %f %f %f"
-  vtkIdType pts[3];       // point ids for building triangles
+  newPts->SetDataTypeToFloat();
+  vtkFloatArray *points = static_cast<vtkFloatArray*>(newPts->GetData());
+  vtkIdType numTris = 0;
   int vertOff = 0;
 
   int solidId = -1;
@@ -450,211 +700,249 @@ bool vtkSTLReader::ReadASCIISTL(FILE *fp, vtkPoints *newPts,
   };
 
   std::string errorMessage;
-
-  for (StlAsciiScanState state = scanSolid; errorMessage.empty() == true; /*nil*/)
+  StlAsciiScanState state = scanSolid;
+
+  // The file is read a block of lines at a time. The lines of a block are
+  // split, and their vertices parsed, in parallel, then scanned in order.
+  const size_t fileLength = vtksys::SystemTools::FileLength(this->FileName);
+  size_t blockSize = std::min<size_t>(std::max<size_t>(fileLength, 4096),
+                                      16 << 20);
+  std::vector<char> block;
+  std::vector<size_t> pieces;
+  std::vector<std::vector<stlLine> > lines;
+  size_t carry = 0;
+  size_t numScanned = 0;
+  for (bool atEnd = false; !atEnd && errorMessage.empty(); /*nil*/)
   {
-    char *cmd = fgets(line, 255, fp);
+    block.resize(blockSize + 1);
+    size_t size = carry + fread(block.data() + carry, 1, blockSize - carry, fp);
+    atEnd = size < blockSize;
 
-    if (!cmd)
+    // Scan whole lines only, unless at the end of the file.
+    size_t end = size;
+    if (!atEnd)
     {
-      // fgets() failed (eg EOF).
-      // If scanning for the next "solid" this is a valid way to exit,
-      // but is an error if scanning for the initial "solid" or any other token
-
-      switch (state)
+      while (end > 0 && block[end - 1] != '\n')
       {
-        case scanSolid:
-        {
-          // Emit error if EOF encountered without having read anything
-          if (solidId < 0) errorMessage = stlParseEof("solid");
-          break;
-        }
-        case scanFacet:    { errorMessage = stlParseEof("facet"); break; }
-        case scanLoop:     { errorMessage = stlParseEof("outer loop"); break; }
-        case scanVerts:    { errorMessage = stlParseEof("vertex"); break; }
-        case scanEndLoop:  { errorMessage = stlParseEof("endloop"); break; }
-        case scanEndFacet: { errorMessage = stlParseEof("endfacet"); break; }
-        case scanEndSolid: { errorMessage = stlParseEof("endsolid"); break; }
+        --end;
       }
-
-      // Terminate the parsing loop
-      break;
-    }
-
-    // Cue to the first non-space.
-    while (isspace(*cmd))
-    {
-      ++cmd;
-    }
-
-    // An empty line - try again
-    if (!*cmd)
-    {
-      // Increment line-number, but not while still in the header
-      if (lineNum) ++lineNum;
-      continue;
-    }
-
-    // Ensure consistent case on the first token and separate from
-    // subsequent arguments
-
-    char *arg = cmd;
-    while (*arg && !isspace(*arg))
-    {
-      *arg = tolower(*arg);
-      ++arg;
-    }
-
-    // Terminate first token (cmd)
-    if (*arg)
-    {
-      *arg = '\0';
-      ++arg;
-
-      while (isspace(*arg))
+      if (end == 0)
       {
-        ++arg;
+        // The line does not fit in the block.
+        carry = size;
+        blockSize *= 2;
+        continue;
       }
     }
 
-    ++lineNum;
-
-    // Handle all expected parsed elements
-    switch (state)
+    // Split the block at new lines, in pieces of at least 64 kB.
+    size_t numPieces = std::min<size_t>(
+      4 * vtkSMPTools::GetEstimatedNumberOfThreads(), end / 65536);
+    pieces.assign(1, 0);
+    for (size_t i = 1; i < numPieces; ++i)
     {
-      case scanSolid:
+      size_t start = std::max(pieces.back(), i * (end / numPieces));
+      const char *eol =
+        static_cast<const char*>(memchr(&block[start], '\n', end - start));
+      if (!eol || eol + 1 == block.data() + end)
       {
-        if (!strcmp(cmd, "solid"))
-        {
-          ++solidId;
-          state = scanFacet;  // Next state
-          if (!header.empty())
-          {
-            header += "\n";
-          }
-          header += arg;
-          // strip end-of-line character from the end
-          while (!header.empty() && (header.back() == '\r' || header.back() == '\n'))
-          {
-            header.pop_back();
-          }
-        }
-        else
-        {
-          errorMessage = stlParseExpected("solid", cmd);
-        }
         break;
       }
-      case scanFacet:
+      pieces.push_back(eol + 1 - block.data());
+    }
+    pieces.push_back(end);
+    lines.resize(pieces.size() - 1);
+    stlSplitLines split = { block.data(), pieces, lines };
+    vtkSMPTools::For(0, static_cast<vtkIdType>(lines.size()), split);
+
+    for (size_t piece = 0; piece < lines.size() && errorMessage.empty();
+         ++piece)
+    {
+      for (const stlLine &line : lines[piece])
       {
-        if (!strcmp(cmd, "color"))
+        const char *cmd = line.Command;
+
+        // An empty line - try again
+        if (!*cmd)
         {
-          // Optional 'color' entry (after solid) - continue looking for 'facet'
+          // Increment line-number, but not while still in the header
+          if (lineNum) ++lineNum;
           continue;
         }
 
-        if (!strcmp(cmd, "facet"))
-        {
-          state = scanLoop;  // Next state
-        }
-        else if (!strcmp(cmd, "endsolid"))
-        {
-          // Finished with 'endsolid' - find next solid
-          state = scanSolid;
-        }
-        else
-        {
-          errorMessage = stlParseExpected("facet", cmd);
-        }
-        break;
-      }
-      case scanLoop:
-      {
-        if (!strcmp(cmd, "outer"))  // More pedantic => && !strcmp(arg, "loop")
-        {
-          state = scanVerts;  // Next state
-        }
-        else
-        {
-          errorMessage = stlParseExpected("outer loop", cmd);
-        }
-        break;
-      }
-      case scanVerts:
-      {
-        if (!strcmp(cmd, "vertex"))
+        ++lineNum;
+
+        // Handle all expected parsed elements
+        switch (state)
         {
-          if (stlReadVertex(arg, vertCoord))
+          case scanSolid:
           {
-            pts[vertOff] = newPts->InsertNextPoint(vertCoord);
-            ++vertOff;  // Next vertex
-
-            if (vertOff >= 3)
+            if (!strcmp(cmd, "solid"))
             {
-              // Finished this triangle.
-              vertOff = 0;
-              state = scanEndLoop;  // Next state
-
-              // Save as cell
-              newPolys->InsertNextCell(3, pts);
-              if (scalars)
+              ++solidId;
+              state = scanFacet;  // Next state
+              if (!header.empty())
+              {
+                header += "\n";
+              }
+              header += line.Argument;
+              // strip end-of-line character from the end
+              while (!header.empty() &&
+                     (header.back() == '\r' || header.back() == '\n'))
               {
-                scalars->InsertNextValue(solidId);
+                header.pop_back();
               }
+            }
+            else
+            {
+              errorMessage = stlParseExpected("solid", cmd);
+            }
+            break;
+          }
+          case scanFacet:
+          {
+            if (!strcmp(cmd, "color"))
+            {
+              // Optional 'color' entry (after solid) - continue looking for 'facet'
+              continue;
+            }
 
-              if ((newPolys->GetNumberOfCells() % 5000) == 0)
+            if (!strcmp(cmd, "facet"))
+            {
+              state = scanLoop;  // Next state
+            }
+            else if (!strcmp(cmd, "endsolid"))
+            {
+              // Finished with 'endsolid' - find next solid
+              state = scanSolid;
+            }
+            else
+            {
+              errorMessage = stlParseExpected("facet", cmd);
+            }
+            break;
+          }
+          case scanLoop:
+          {
+            if (!strcmp(cmd, "outer"))  // More pedantic => && !strcmp(arg, "loop")
+            {
+              state = scanVerts;  // Next state
+            }
+            else
+            {
+              errorMessage = stlParseExpected("outer loop", cmd);
+            }
+            break;
+          }
+          case scanVerts:
+          {
+            if (!strcmp(cmd, "vertex"))
+            {
+              if (line.ValidVertex)
               {
-                this->UpdateProgress((newPolys->GetNumberOfCells()%50000) / 50000.0);
+                points->InsertNextTypedTuple(line.Vertex);
+                ++vertOff;  // Next vertex
+
+                if (vertOff >= 3)
+                {
+                  // Finished this triangle.
+                  vertOff = 0;
+                  state = scanEndLoop;  // Next state
+
+                  // Save as cell
+                  ++numTris;
+                  if (scalars)
+                  {
+                    scalars->InsertNextValue(solidId);
+                  }
+                }
               }
+              else
+              {
+                errorMessage = "Parse error reading STL vertex";
+              }
+            }
+            else
+            {
+              errorMessage = stlParseExpected("vertex", cmd);
             }
+            break;
           }
-          else
+          case scanEndLoop:
           {
-            errorMessage = "Parse error reading STL vertex";
+            if (!strcmp(cmd, "endloop"))
+            {
+              state = scanEndFacet;  // Next state
+            }
+            else
+            {
+              errorMessage = stlParseExpected("endloop", cmd);
+            }
+            break;
+          }
+          case scanEndFacet:
+          {
+            if (!strcmp(cmd, "endfacet"))
+            {
+              state = scanFacet;  // Next facet, or endsolid
+            }
+            else
+            {
+              errorMessage = stlParseExpected("endfacet", cmd);
+            }
+            break;
+          }
+          case scanEndSolid:
+          {
+            if (!strcmp(cmd, "endsolid"))
+            {
+              state = scanSolid;  // Start over again
+            }
+            else
+            {
+              errorMessage = stlParseExpected("endsolid", cmd);
+            }
+            break;
           }
         }
-        else
-        {
-          errorMessage = stlParseExpected("vertex", cmd);
-        }
-        break;
-      }
-      case scanEndLoop:
-      {
-        if (!strcmp(cmd, "endloop"))
-        {
-          state = scanEndFacet;  // Next state
-        }
-        else
-        {
-          errorMessage = stlParseExpected("endloop", cmd);
-        }
-        break;
-      }
-      case scanEndFacet:
-      {
-        if (!strcmp(cmd, "endfacet"))
-        {
-          state = scanFacet;  // Next facet, or endsolid
-        }
-        else
+
+        if (!errorMessage.empty())
         {
-          errorMessage = stlParseExpected("endfacet", cmd);
+          break;
         }
-        break;
       }
-      case scanEndSolid:
+    }
+
+    // Keep the incomplete last line for the next block.
+    carry = size - end;
+    memmove(block.data(), block.data() + end, carry);
+    numScanned += end;
+    if (fileLength > 0)
+    {
+      this->UpdateProgress(static_cast<double>(numScanned) / fileLength);
+    }
+  }
+
+  if (errorMessage.empty())
+  {
+    // End of file.
+    // If scanning for the next "solid" this is a valid way to exit,
+    // but is an error if scanning for the initial "solid" or any other token
+
+    switch (state)
+    {
+      case scanSolid:
       {
-        if (!strcmp(cmd, "endsolid"))
-        {
-          state = scanSolid;  // Start over again
-        }
-        else
-        {
-          errorMessage = stlParseExpected("endsolid", cmd);
-        }
+        // Emit error if EOF encountered without having read anything
+        if (solidId < 0) errorMessage = stlParseEof("solid");
         break;
       }
+      case scanFacet:    { errorMessage = stlParseEof("facet"); break; }
+      case scanLoop:     { errorMessage = stlParseEof("outer loop"); break; }
+      case scanVerts:    { errorMessage = stlParseEof("vertex"); break; }
+      case scanEndLoop:  { errorMessage = stlParseEof("endloop"); break; }
+      case scanEndFacet: { errorMessage = stlParseEof("endfacet"); break; }
+      case scanEndSolid: { errorMessage = stlParseEof("endsolid"); break; }
     }
   }
 
@@ -668,6 +956,8 @@ bool vtkSTLReader::ReadASCIISTL(FILE *fp, vtkPoints *newPts,
     return false;
   }
 
+  stlSetTriangles(newPolys, numTris);
+
   return true;
 }
 
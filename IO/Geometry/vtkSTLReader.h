@@ -25,7 +25,13 @@
  * definitions. By setting the Merging boolean you can control whether the
  * point data is merged after reading. Merging is performed by default,
  * however, merging requires a large amount of temporary storage since a
- * 3D hash table must be constructed.
+ * 3D hash table must be constructed. Unless a Locator is specified, the
+ * points are merged in parallel with a vtkStaticPointLocator once they are
+ * all read when several threads are available, which gives the same points
+ * and triangles as inserting them in a vtkMergePoints.
+ *
+ * Binary files are read in large blocks and the lines of ASCII files are
+ * parsed in parallel, see vtkSMPTools.
  *
  * @warning
  * Binary files written on one system may not be readable on other systems.
@@ -80,8 +86,10 @@ public:
 
   //@{
   /**
-   * Specify a spatial locator for merging points. By
-   * default an instance of vtkMergePoints is used.
+   * Specify a spatial locator for merging points. The points are then
+   * inserted in the locator one after the other. By default an instance
+   * of vtkMergePoints is used, or, with several threads, the points are
+   * merged in parallel with the same result.
    */
   void SetLocator(vtkIncrementalPointLocator *locator);
   vtkGetObjectMacro(Locator,vtkIncrementalPointLocator);
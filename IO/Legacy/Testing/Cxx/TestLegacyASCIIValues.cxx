@@ -0,0 +1,308 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestLegacyASCIIValues.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check the parsing of the values of ASCII legacy files: signs, exponents,
+// limits of the types, mixed whitespace and values at the end of the file,
+// and that large files read with one and with several threads, and with
+// CRLF line endings, give the same datasets as the binary files.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFieldData.h"
+#include "vtkFloatArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestArrays.h"
+#include "vtkTestSMP.h"
+#include "vtkTestUtilities.h"
+#include "vtkTypeInt64Array.h"
+#include "vtkTypeUInt64Array.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkUnstructuredGridReader.h"
+#include "vtkUnstructuredGridWriter.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+namespace
+{
+
+const char* File =
+  "# vtk DataFile Version 4.2\n"
+  "values\n"
+  "ASCII\n"
+  "DATASET UNSTRUCTURED_GRID\n"
+  "FIELD FieldData 5\n"
+  "ints 1 6 int\n"
+  "-2147483648 2147483647\t+5 -0\r\n"
+  "0012\n"
+  "   7\n"
+  "int64 1 2 vtktypeint64\n"
+  "-9223372036854775808 9223372036854775807\n"
+  "uint64 1 2 vtktypeuint64\n"
+  "18446744073709551615 0\n"
+  "chars 1 3 unsigned_char\n"
+  "255 0 65\n"
+  "doubles 1 4 double\n"
+  "1.5e300 -0.25\n"
+  "3 7.\n"
+  "POINTS 4 float\n"
+  "0 0 0 1 0 0\r\n"
+  "0 1 0\t0 0 1e0\n"
+  "CELLS 2 7\n"
+  "3 0 1 2\n"
+  "2 2\n"
+  "3\n"
+  "CELL_TYPES 2\n"
+  "5\n"
+  "3\n"
+  "POINT_DATA 4\n"
+  "SCALARS scalars float\n"
+  "LOOKUP_TABLE default\n"
+  "-1.25 .5 2.5e-1 1E1";
+
+template <class ArrayT, class ValueT>
+bool CheckValues(vtkFieldData* fd, const char* name, const ValueT* values,
+                 int numValues)
+{
+  ArrayT* array = ArrayT::SafeDownCast(fd->GetAbstractArray(name));
+  if (!array || array->GetNumberOfValues() != numValues)
+  {
+    std::cerr << "Cannot read the array " << name << std::endl;
+    return false;
+  }
+  for (int i = 0; i < numValues; ++i)
+  {
+    if (array->GetValue(i) != values[i])
+    {
+      std::cerr << "Wrong value " << i << " of " << name << ": "
+                << array->GetValue(i) << " instead of " << values[i]
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+bool CheckFile()
+{
+  vtkNew<vtkUnstructuredGridReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(File);
+  reader->Update();
+  vtkUnstructuredGrid* grid = reader->GetOutput();
+
+  const int ints[] = { VTK_INT_MIN, VTK_INT_MAX, 5, 0, 12, 7 };
+  const vtkTypeInt64 int64[] = { VTK_TYPE_INT64_MIN, VTK_TYPE_INT64_MAX };
+  const vtkTypeUInt64 uint64[] = { VTK_TYPE_UINT64_MAX, 0 };
+  const unsigned char chars[] = { 255, 0, 65 };
+  const double doubles[] = { 1.5e300, -0.25, 3, 7 };
+  const float scalars[] = { -1.25f, 0.5f, 0.25f, 10.0f };
+  vtkFieldData* fd = grid->GetFieldData();
+  if (!CheckValues<vtkIntArray>(fd, "ints", ints, 6) ||
+      !CheckValues<vtkTypeInt64Array>(fd, "int64", int64, 2) ||
+      !CheckValues<vtkTypeUInt64Array>(fd, "uint64", uint64, 2) ||
+      !CheckValues<vtkUnsignedCharArray>(fd, "chars", chars, 3) ||
+      !CheckValues<vtkDoubleArray>(fd, "doubles", doubles, 4) ||
+      !CheckValues<vtkFloatArray>(grid->GetPointData(), "scalars", scalars, 4))
+  {
+    return false;
+  }
+
+  if (grid->GetNumberOfPoints() != 4 || grid->GetPoint(3)[2] != 1.0 ||
+      grid->GetNumberOfCells() != 2 || grid->GetCellType(0) != VTK_TRIANGLE ||
+      grid->GetCellType(1) != VTK_LINE ||
+      grid->GetCell(1)->GetPointId(1) != 3)
+  {
+    std::cerr << "Wrong points or cells" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool SameGrids(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+    {
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> aIds, bIds;
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+  {
+    a->GetCellPoints(i, aIds);
+    b->GetCellPoints(i, bIds);
+    if (a->GetCellType(i) != b->GetCellType(i) ||
+        aIds->GetNumberOfIds() != bIds->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType j = 0; j < aIds->GetNumberOfIds(); ++j)
+    {
+      if (aIds->GetId(j) != bIds->GetId(j))
+      {
+        return false;
+      }
+    }
+  }
+  return vtkTest::SameArrays(a->GetPointData(), b->GetPointData()) &&
+    vtkTest::SameArrays(a->GetCellData(), b->GetCellData());
+}
+
+// Triangles over a grid of points, with values that "%g" writes exactly.
+void MakeGrid(vtkUnstructuredGrid *grid, int n)
+{
+  vtkNew<vtkPoints> points;
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  vtkNew<vtkIntArray> labels;
+  labels->SetName("labels");
+  labels->SetNumberOfComponents(2);
+  vtkNew<vtkUnsignedCharArray> flags;
+  flags->SetName("flags");
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      points->InsertNextPoint(i, j, 0.125 * ((i * j) % 17) - 1);
+      scalars->InsertNextValue(0.25 * ((i + j * n) % 4001) - 500);
+      labels->InsertNextTuple2((i * 7) % 13 - 6, j * 100003);
+      flags->InsertNextValue(static_cast<unsigned char>((i + j) % 256));
+    }
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+  grid->GetPointData()->AddArray(labels);
+  grid->GetPointData()->AddArray(flags);
+
+  grid->Allocate(2 * (n - 1) * (n - 1));
+  for (int j = 0; j + 1 < n; ++j)
+  {
+    for (int i = 0; i + 1 < n; ++i)
+    {
+      vtkIdType p = i + j * n;
+      vtkIdType lower[3] = { p, p + 1, p + n + 1 };
+      vtkIdType upper[3] = { p, p + n + 1, p + n };
+      grid->InsertNextCell(VTK_TRIANGLE, 3, lower);
+      grid->InsertNextCell(VTK_TRIANGLE, 3, upper);
+    }
+  }
+}
+
+vtkSmartPointer<vtkUnstructuredGrid> Read(const std::string& fileName)
+{
+  vtkNew<vtkUnstructuredGridReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->Update();
+  return reader->GetOutput();
+}
+
+// Copy a file replacing its line endings with CRLF.
+bool WriteCRLF(const std::string& fileName, const std::string& crlfName)
+{
+  std::ifstream in(fileName.c_str(), std::ios::binary);
+  std::ofstream out(crlfName.c_str(), std::ios::binary);
+  char c;
+  while (in.get(c))
+  {
+    if (c == '\n')
+    {
+      out.put('\r');
+    }
+    out.put(c);
+  }
+  return in.eof() && static_cast<bool>(out);
+}
+
+}
+
+int TestLegacyASCIIValues(int argc, char *argv[])
+{
+  if (!CheckFile())
+  {
+    return EXIT_FAILURE;
+  }
+
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv,
+                                                         "VTK_TEMP_DIR",
+                                                         "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestLegacyASCIIValues.vtk";
+  std::string crlfName =
+    std::string(tempDir) + "/TestLegacyASCIIValuesCRLF.vtk";
+  delete [] tempDir;
+
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid, 300);
+  for (int binary = 0; binary < 2; ++binary)
+  {
+    vtkNew<vtkUnstructuredGridWriter> writer;
+    writer->SetInputData(grid);
+    writer->SetFileName(fileName.c_str());
+    writer->SetFileType(binary ? VTK_BINARY : VTK_ASCII);
+    if (!writer->Write())
+    {
+      std::cerr << "Cannot write " << fileName << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+      vtkSmartPointer<vtkUnstructuredGrid> read;
+      vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { read = Read(fileName); });
+      if (!SameGrids(grid, read))
+      {
+        std::cerr << "The grid read from the "
+                  << (binary ? "binary" : "ASCII") << " file with "
+                  << (parallel ? "several threads" : "one thread")
+                  << " differs from the grid written" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    if (!binary)
+    {
+      if (!WriteCRLF(fileName, crlfName))
+      {
+        std::cerr << "Cannot write " << crlfName << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (!SameGrids(grid, Read(crlfName)))
+      {
+        std::cerr << "The grid read from the ASCII file with CRLF line "
+                  << "endings differs from the grid written" << std::endl;
+        return EXIT_FAILURE;
+      }
+      remove(crlfName.c_str());
+    }
+  }
+
+  remove(fileName.c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TimeLegacyReader.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Report the read throughput of the legacy reader for ASCII and binary
+// files, next to the throughput of extracting the same ASCII values with
+// operator>>, and check that the data read back are the data written.
+
+#include "vtkCellType.h"
+#include "vtkDoubleArray.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkSMPTools.h"
+#include "vtkTimerLog.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkUnstructuredGridReader.h"
+#include "vtkUnstructuredGridWriter.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+namespace
+{
+
+// Triangles over a grid of points, with values that "%g" writes exactly.
+void MakeGrid(vtkUnstructuredGrid *grid, int n)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  vtkNew<vtkIntArray> labels;
+  labels->SetName("labels");
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      points->InsertNextPoint(0.5 * i, 0.25 * j, 0.125 * ((i * j) % 17));
+      scalars->InsertNextValue(0.25 * ((i + j * n) % 4001) - 500);
+      labels->InsertNextValue((i * 7919 + j) % 100003);
+    }
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+  grid->GetPointData()->AddArray(labels);
+
+  grid->Allocate(2 * (n - 1) * (n - 1));
+  for (int j = 0; j + 1 < n; ++j)
+  {
+    for (int i = 0; i + 1 < n; ++i)
+    {
+      vtkIdType p = i + j * n;
+      vtkIdType lower[3] = { p, p + 1, p + n + 1 };
+      vtkIdType upper[3] = { p, p + n + 1, p + n };
+      grid->InsertNextCell(VTK_TRIANGLE, 3, lower);
+      grid->InsertNextCell(VTK_TRIANGLE, 3, upper);
+    }
+  }
+}
+
+bool SameGrids(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2] ||
+        a->GetPointData()->GetScalars()->GetTuple1(i) !=
+        b->GetPointData()->GetScalars()->GetTuple1(i) ||
+        a->GetPointData()->GetArray("labels")->GetTuple1(i) !=
+        b->GetPointData()->GetArray("labels")->GetTuple1(i))
+    {
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> aIds, bIds;
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+  {
+    a->GetCellPoints(i, aIds);
+    b->GetCellPoints(i, bIds);
+    if (aIds->GetNumberOfIds() != bIds->GetNumberOfIds() ||
+        aIds->GetId(2) != bIds->GetId(2))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+int TimeLegacyReader(int, char *[])
+{
+  std::cout << "Timing with " << vtkSMPTools::GetEstimatedNumberOfThreads()
+            << " threads" << std::endl;
+
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid, 400);
+
+  vtkNew<vtkTimerLog> timer;
+  std::string ascii;
+  std::cout << "file      MB    read MB/s\n";
+  for (int binary = 0; binary < 2; ++binary)
+  {
+    vtkNew<vtkUnstructuredGridWriter> writer;
+    writer->SetInputData(grid);
+    writer->SetFileType(binary ? VTK_BINARY : VTK_ASCII);
+    writer->WriteToOutputStringOn();
+    writer->Write();
+    std::string output = writer->GetOutputStdString();
+    if (!binary)
+    {
+      ascii = output;
+    }
+
+    vtkNew<vtkUnstructuredGridReader> reader;
+    reader->ReadFromInputStringOn();
+    reader->SetInputString(output);
+    timer->StartTimer();
+    reader->Update();
+    timer->StopTimer();
+
+    if (!SameGrids(grid, reader->GetOutput()))
+    {
+      std::cerr << "The grid read from the " << (binary ? "binary" : "ASCII")
+                << " file differs from the grid written" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    double megabytes = output.size() / (1024.0 * 1024.0);
+    std::cout << std::setw(6) << (binary ? "binary" : "ascii")
+              << std::fixed << std::setprecision(2)
+              << std::setw(8) << megabytes << std::setw(13)
+              << megabytes / std::max(timer->GetElapsedTime(), 1e-6) << "\n";
+  }
+
+  // Extract all the values of the ASCII file after its header, as the
+  // reader used to, for reference.
+  std::istringstream stream(ascii.substr(ascii.find("POINTS")));
+  std::string word;
+  stream >> word >> word >> word;
+  double value;
+  timer->StartTimer();
+  while (stream)
+  {
+    while (stream >> value)
+    {
+    }
+    if (!stream.eof())
+    {
+      stream.clear();
+      stream >> word;
+    }
+  }
+  timer->StopTimer();
+  double megabytes = ascii.size() / (1024.0 * 1024.0);
+  std::cout << "operator>>" << std::setw(17)
+            << megabytes / std::max(timer->GetElapsedTime(), 1e-6)
+            << std::endl;
+
+  return EXIT_SUCCESS;
+}
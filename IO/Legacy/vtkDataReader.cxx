@@ -43,6 +43,7 @@
 #include "vtkPointData.h"
 #include "vtkPointSet.h"
 #include "vtkRectilinearGrid.h"
+#include "vtkSMPTools.h"
 #include "vtkShortArray.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkStringArray.h"
@@ -58,8 +59,13 @@
 
 #include <vtksys/SystemTools.hxx>
 
-#include <sstream>
+#include <algorithm>
 #include <cctype>
+#include <clocale>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <vector>
 
 // I need a safe way to read a line of arbitrary length.  It exists on
 // some platforms but not others so I'm afraid I have to write it
@@ -1488,10 +1494,392 @@ int vtkReadBinaryData(istream *IS, T *data, vtkIdType numTuples, vtkIdType numCo
   return 1;
 }
 
+namespace
+{
+
+// The whitespace skipped by operator>> in the "C" locale.
+inline bool vtkIsASCIISpace(char c)
+{
+  return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' ||
+    c == '\f';
+}
+
+// Parse the integer starting at p.  Return the end of the integer, or
+// nullptr if there is no integer or if it does not fit in T.
+template <class T>
+const char* vtkParseASCIIInteger(const char* p, T& value)
+{
+  bool negative = (*p == '-');
+  if (*p == '-' || *p == '+')
+  {
+    ++p;
+  }
+  if (*p < '0' || *p > '9')
+  {
+    return nullptr;
+  }
+  vtkTypeUInt64 magnitude = 0;
+  do
+  {
+    vtkTypeUInt64 digit = static_cast<vtkTypeUInt64>(*p - '0');
+    if (magnitude > (VTK_TYPE_UINT64_MAX - digit) / 10)
+    {
+      return nullptr;
+    }
+    magnitude = 10 * magnitude + digit;
+    ++p;
+  } while (*p >= '0' && *p <= '9');
+
+  vtkTypeUInt64 maximum =
+    static_cast<vtkTypeUInt64>(std::numeric_limits<T>::max());
+  if (std::numeric_limits<T>::is_signed)
+  {
+    if (magnitude > maximum + (negative ? 1 : 0))
+    {
+      return nullptr;
+    }
+    value = (negative && magnitude > 0) ?
+      static_cast<T>(-static_cast<vtkTypeInt64>(magnitude - 1) - 1) :
+      static_cast<T>(magnitude);
+  }
+  else
+  {
+    // Like operator>>, negate unsigned values in their own type.
+    if (magnitude > maximum)
+    {
+      return nullptr;
+    }
+    value = static_cast<T>(negative ? 0 - magnitude : magnitude);
+  }
+  return p;
+}
+
+// Parse the value starting at p.  Return the end of the value or nullptr if
+// there is no valid value.  Characters are read as integers, as
+// vtkDataReader::Read() does, and floating point values are converted by the
+// C library, as operator>> does.
+template <class T>
+const char* vtkParseASCIIValue(const char* p, T& value)
+{
+  return vtkParseASCIIInteger(p, value);
+}
+
+template <class T>
+const char* vtkParseASCIICharacter(const char* p, T& value)
+{
+  int intValue;
+  p = vtkParseASCIIInteger(p, intValue);
+  value = static_cast<T>(intValue);
+  return p;
+}
+
+inline const char* vtkParseASCIIValue(const char* p, char& value)
+{
+  return vtkParseASCIICharacter(p, value);
+}
+
+inline const char* vtkParseASCIIValue(const char* p, signed char& value)
+{
+  return vtkParseASCIICharacter(p, value);
+}
+
+inline const char* vtkParseASCIIValue(const char* p, unsigned char& value)
+{
+  return vtkParseASCIICharacter(p, value);
+}
+
+inline const char* vtkParseASCIIValue(const char* p, float& value)
+{
+  char* end;
+  value = strtof(p, &end);
+  return end == p ? nullptr : end;
+}
+
+inline const char* vtkParseASCIIValue(const char* p, double& value)
+{
+  char* end;
+  value = strtod(p, &end);
+  return end == p ? nullptr : end;
+}
+
+// The C library reads floating point values with the decimal point of the
+// current locale, so only use it when that is the "C" decimal point.
+template <class T>
+bool vtkCanParseASCIIValues(T*)
+{
+  return true;
+}
+
+inline bool vtkCanParseASCIIDecimalPoint()
+{
+  const char* point = localeconv()->decimal_point;
+  return point && point[0] == '.' && point[1] == '\0';
+}
+
+inline bool vtkCanParseASCIIValues(float*)
+{
+  return vtkCanParseASCIIDecimalPoint();
+}
+
+inline bool vtkCanParseASCIIValues(double*)
+{
+  return vtkCanParseASCIIDecimalPoint();
+}
+
+// Parse at most maxCount values from the text between first and last, which
+// must be followed by whitespace or a null character.  Return the end of the
+// last value parsed, or last if there are less than maxCount values, and
+// nullptr if a value is not valid.
+template <class T>
+const char* vtkParseASCIIValues(const char* first, const char* last, T* data,
+  vtkIdType maxCount, vtkIdType& count)
+{
+  const char* p = first;
+  count = 0;
+  while (count < maxCount)
+  {
+    while (p != last && vtkIsASCIISpace(*p))
+    {
+      ++p;
+    }
+    if (p == last)
+    {
+      break;
+    }
+    p = vtkParseASCIIValue(p, data[count]);
+    if (!p || !(vtkIsASCIISpace(*p) || *p == '\0'))
+    {
+      return nullptr;
+    }
+    ++count;
+  }
+  return p;
+}
+
+// Count the values of each piece of a buffer.
+struct vtkCountASCIIValues
+{
+  const std::vector<const char*>& Bounds;
+  std::vector<vtkIdType>& Counts;
+
+  vtkCountASCIIValues(const std::vector<const char*>& bounds,
+    std::vector<vtkIdType>& counts)
+    : Bounds(bounds), Counts(counts)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType piece = begin; piece < end; ++piece)
+    {
+      vtkIdType count = 0;
+      bool inValue = false;
+      for (const char* p = this->Bounds[piece]; p != this->Bounds[piece + 1];
+           ++p)
+      {
+        bool space = vtkIsASCIISpace(*p);
+        if (!space && !inValue)
+        {
+          ++count;
+        }
+        inValue = !space;
+      }
+      this->Counts[piece] = count;
+    }
+  }
+};
+
+// Parse the values of each piece of a buffer where they go in the array,
+// given by the number of values in the pieces before it.
+template <class T>
+struct vtkParseASCIIPieces
+{
+  const std::vector<const char*>& Bounds;
+  const std::vector<vtkIdType>& Offsets;
+  T* Data;
+  vtkIdType MaxCount;
+  std::vector<const char*> Ends;
+  std::vector<vtkIdType> Counts;
+
+  vtkParseASCIIPieces(const std::vector<const char*>& bounds,
+    const std::vector<vtkIdType>& offsets, T* data, vtkIdType maxCount)
+    : Bounds(bounds), Offsets(offsets), Data(data), MaxCount(maxCount),
+      Ends(offsets.size() - 1, nullptr), Counts(offsets.size() - 1, 0)
+  {
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType piece = begin; piece < end; ++piece)
+    {
+      vtkIdType offset = this->Offsets[piece];
+      if (offset < this->MaxCount)
+      {
+        this->Ends[piece] = vtkParseASCIIValues(this->Bounds[piece],
+          this->Bounds[piece + 1], this->Data + offset,
+          std::min(this->Offsets[piece + 1], this->MaxCount) - offset,
+          this->Counts[piece]);
+      }
+    }
+  }
+};
+
+// Same as vtkParseASCIIValues().  Large buffers are split at whitespace in
+// pieces parsed in parallel: the values of the pieces are counted first to
+// know where each piece goes in the array.
+template <class T>
+const char* vtkParseASCIIBuffer(const char* first, const char* last, T* data,
+  vtkIdType maxCount, vtkIdType& count)
+{
+  const vtkIdType minimumPieceSize = 65536;
+  vtkIdType numPieces = std::min<vtkIdType>((last - first) / minimumPieceSize,
+    4 * vtkSMPTools::GetEstimatedNumberOfThreads());
+  if (vtkSMPTools::GetEstimatedNumberOfThreads() < 2 || numPieces < 2)
+  {
+    return vtkParseASCIIValues(first, last, data, maxCount, count);
+  }
+
+  std::vector<const char*> bounds(numPieces + 1, last);
+  bounds[0] = first;
+  for (vtkIdType piece = 1; piece < numPieces; ++piece)
+  {
+    const char* p = std::max(first + (last - first) * piece / numPieces,
+                             bounds[piece - 1]);
+    while (p != last && !vtkIsASCIISpace(*p))
+    {
+      ++p;
+    }
+    bounds[piece] = p;
+  }
+
+  std::vector<vtkIdType> offsets(numPieces + 1, 0);
+  vtkCountASCIIValues counter(bounds, offsets);
+  vtkSMPTools::For(0, numPieces, 1, counter);
+  vtkIdType total = 0;
+  for (vtkIdType piece = 0; piece <= numPieces; ++piece)
+  {
+    vtkIdType pieceCount = offsets[piece];
+    offsets[piece] = total;
+    total += pieceCount;
+  }
+
+  vtkParseASCIIPieces<T> parser(bounds, offsets, data, maxCount);
+  vtkSMPTools::For(0, numPieces, 1, parser);
+  const char* end = first;
+  count = 0;
+  for (vtkIdType piece = 0; piece < numPieces && offsets[piece] < maxCount;
+       ++piece)
+  {
+    if (!parser.Ends[piece])
+    {
+      return nullptr;
+    }
+    end = parser.Ends[piece];
+    count += parser.Counts[piece];
+  }
+  return end;
+}
+
+}
+
+// Read numValues ASCII values from the stream a buffer at a time rather than
+// with one operator>> per value, and put back what was read past the values.
+// The stream is repositioned from the position of the last read rather than
+// by seeking back the number of characters read past the values, which may
+// differ from the number of bytes in a file opened in text mode (CRLF line
+// endings on Windows). Returns zero if there was an error.
+template <class T>
+int vtkReadASCIIValues(istream *IS, T *data, vtkIdType numValues)
+{
+  if (numValues <= 0)
+  {
+    return 1;
+  }
+  const vtkIdType minimumRead = 4096;
+  const vtkIdType maximumRead = 1 << 22;
+  std::vector<char> buffer;
+  size_t size = 0;
+  size_t start = 0;
+  bool atEnd = false;
+  bool failed = false;
+  vtkIdType count = 0;
+  // Position of the last read, and number of characters kept in the buffer
+  // before it.
+  std::streampos position;
+  size_t kept = 0;
+  while (count < numValues && !atEnd)
+  {
+    // Keep the beginning of a value not parsed yet and read what follows.
+    if (start > 0)
+    {
+      std::copy(buffer.begin() + start, buffer.begin() + size, buffer.begin());
+      size -= start;
+      start = 0;
+    }
+    vtkIdType remaining = numValues - count;
+    size_t request = static_cast<size_t>(std::max(minimumRead,
+      std::min(maximumRead, 16 * remaining)));
+    buffer.resize(size + request + 1);
+    position = IS->tellg();
+    kept = size;
+    IS->read(&buffer[size], request);
+    size_t length = static_cast<size_t>(IS->gcount());
+    atEnd = length < request;
+    size += length;
+    buffer[size] = '\0';
+
+    // Unless the stream ended, the last value may continue in the next
+    // buffer.
+    size_t last = size;
+    if (!atEnd)
+    {
+      while (last > 0 && !vtkIsASCIISpace(buffer[last - 1]))
+      {
+        --last;
+      }
+    }
+
+    vtkIdType parsed;
+    const char* end = vtkParseASCIIBuffer(&buffer[0], &buffer[last],
+      data + count, remaining, parsed);
+    if (!end)
+    {
+      failed = true;
+      break;
+    }
+    count += parsed;
+    start = static_cast<size_t>(end - &buffer[0]);
+  }
+
+  IS->clear();
+  IS->seekg(position);
+  if (start > kept)
+  {
+    IS->ignore(static_cast<std::streamsize>(start - kept));
+  }
+  if (failed || count < numValues)
+  {
+    IS->setstate(std::ios_base::failbit);
+    return 0;
+  }
+  return 1;
+}
+
 // General templated function to read data of various types.
 template <class T>
 int vtkReadASCIIData(vtkDataReader *self, T *data, vtkIdType numTuples, vtkIdType numComp)
 {
+  if (vtkCanParseASCIIValues(data))
+  {
+    if (!vtkReadASCIIValues(self->GetIStream(), data, numTuples * numComp))
+    {
+      vtkGenericWarningMacro(<<"Error reading ascii data. Possible mismatch of "
+        "datasize with declaration.");
+      return 0;
+    }
+    return 1;
+  }
+
   vtkIdType i, j;
 
   for (i=0; i<numTuples; i++)
@@ -3145,12 +3533,17 @@ int vtkDataReader::ReadLutData(vtkDataSetAttributes *a)
   return 1;
 }
 
+// Internal function to read in n ASCII values.
+// Returns zero if there was an error.
+int vtkDataReader::ReadValues(vtkIdType n, int *data)
+{
+  return vtkReadASCIIValues(this->IS, data, n);
+}
 
 // Read lookup table. Return 0 if error.
 int vtkDataReader::ReadCells(vtkIdType size, int *data)
 {
   char line[256];
-  int i;
 
   if ( this->FileType == VTK_BINARY)
   {
@@ -3168,15 +3561,12 @@ int vtkDataReader::ReadCells(vtkIdType size, int *data)
   }
   else // ascii
   {
-    for (i=0; i<size; i++)
+    if (!vtkReadASCIIValues(this->IS, data, size))
     {
-      if (!this->Read(data+i))
-      {
-        const char* fname = this->CurrentFileName.c_str();
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (fname?fname:"(Null FileName)"));
-        return 0;
-      }
+      const char* fname = this->CurrentFileName.c_str();
+      vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
+                    << (fname?fname:"(Null FileName)"));
+      return 0;
     }
   }
 
@@ -3190,21 +3580,21 @@ int vtkDataReader::ReadCells(vtkIdType size, int *data,
                              int skip1, int read2, int skip3)
 {
   char line[256];
-  int i, numCellPts, junk, *tmp, *pTmp;
+  int i, *tmp, *pTmp;
 
+  // first read all the cells as one chunk (each cell has different length).
+  if (skip1 == 0 && skip3 == 0)
+  {
+    tmp = data;
+  }
+  else
+  {
+    tmp = new int[size];
+  }
   if ( this->FileType == VTK_BINARY)
   {
     // suck up newline
     this->IS->getline(line,256);
-    // first read all the cells as one chunk (each cell has different length).
-    if (skip1 == 0 && skip3 == 0)
-    {
-      tmp = data;
-    }
-    else
-    {
-      tmp = new int[size];
-    }
     this->IS->read((char *)tmp,sizeof(int)*size);
     if (this->IS->eof())
     {
@@ -3218,10 +3608,24 @@ int vtkDataReader::ReadCells(vtkIdType size, int *data,
       return 0;
     }
     vtkByteSwap::Swap4BERange(tmp,size);
-    if (tmp == data)
+  }
+  else // ascii
+  {
+    if (!vtkReadASCIIValues(this->IS, tmp, size))
     {
-      return 1;
+      const char* fname = this->CurrentFileName.c_str();
+      vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
+                    << (fname?fname:"(Null FileName)"));
+      if (tmp != data)
+      {
+        delete [] tmp;
+      }
+      return 0;
     }
+  }
+
+  if (tmp != data)
+  {
     // skip cells before the piece
     pTmp = tmp;
     while (skip1 > 0)
@@ -3246,55 +3650,6 @@ int vtkDataReader::ReadCells(vtkIdType size, int *data,
     // delete the temporary array
     delete [] tmp;
   }
-  else // ascii
-  {
-    // skip cells before the piece
-    for (i=0; i<skip1; i++)
-    {
-      if (!this->Read(&numCellPts))
-      {
-        const char* fname = this->CurrentFileName.c_str();
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (fname?fname:"(Null FileName)"));
-        return 0;
-      }
-      while (numCellPts-- > 0)
-      {
-        this->Read(&junk);
-      }
-    }
-    // read the cells in the piece
-    for (i=0; i<read2; i++)
-    {
-      if (!this->Read(data))
-      {
-        const char* fname = this->CurrentFileName.c_str();
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (fname?fname:"(Null FileName)"));
-        return 0;
-      }
-      numCellPts = *data++;
-      while (numCellPts-- > 0)
-      {
-        this->Read(data++);
-      }
-    }
-    // skip cells after the piece
-    for (i=0; i<skip3; i++)
-    {
-      if (!this->Read(&numCellPts))
-      {
-        const char* fname = this->CurrentFileName.c_str();
-        vtkErrorMacro(<<"Error reading ascii cell data!" << " for file: "
-                      << (fname?fname:"(Null FileName)"));
-        return 0;
-      }
-      while (numCellPts-- > 0)
-      {
-        this->Read(&junk);
-      }
-    }
-  }
 
   float progress = this->GetProgress();
   this->UpdateProgress(progress + 0.5*(1.0 - progress));
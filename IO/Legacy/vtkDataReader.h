@@ -411,6 +411,13 @@ public:
   int Read(double *);
   //@}
 
+  /**
+   * Internal function to read in @a n ASCII values at once.  The values are
+   * parsed a buffer at a time, and large buffers in parallel, instead of
+   * with one operator>> per value.  Returns zero if there was an error.
+   */
+  int ReadValues(vtkIdType n, int *data);
+
   /**
    * Read @a n character from the stream into @a str, then reset the stream
    * position. Returns the number of characters actually read.
@@ -235,14 +235,11 @@ int vtkUnstructuredGridReader::ReadMeshSimple(
             }
           }
           // read types for piece
-          for (i=0; i<read2; i++)
+          if (!this->ReadValues(read2, types))
           {
-            if (!this->Read(types+i))
-            {
-              vtkErrorMacro(<<"Error reading cell types!");
-              this->CloseVTKFile ();
-              return 1;
-            }
+            vtkErrorMacro(<<"Error reading cell types!");
+            this->CloseVTKFile ();
+            return 1;
           }
           // skip types after piece
           for (i=0; i<skip3; i++)
@@ -580,8 +580,7 @@ int vtkMNIObjectReader::ReadCells(vtkPolyData *data, vtkIdType numCells,
   // Create the cell array
   if (status != 0)
   {
-    cellArray->GetData()->Allocate(
-      numCells + endIndices->GetValue(numCells - 1));
+    cellArray->AllocateExact(numCells, numIndices);
 
     vtkPoints *points = data->GetPoints();
     vtkIdType numPoints = points->GetNumberOfPoints();
@@ -0,0 +1,150 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestPLYReaderThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkPLYReader reads the vertices of ASCII and of little and big
+// endian binary files, which are decoded in parallel, with one and with
+// several threads.
+
+#include "vtkCellArray.h"
+#include "vtkDataArray.h"
+#include "vtkFloatArray.h"
+#include "vtkNew.h"
+#include "vtkPLYReader.h"
+#include "vtkPLYWriter.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestArrays.h"
+#include "vtkTestSMP.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+
+bool SameSurfaces(vtkPolyData *a, vtkPolyData *b)
+{
+  if (!vtkTest::SameValues(a->GetPoints()->GetData(),
+                           b->GetPoints()->GetData()) ||
+      !vtkTest::SameValues(a->GetPointData()->GetTCoords(),
+                           b->GetPointData()->GetTCoords()) ||
+      !vtkTest::SameValues(a->GetPointData()->GetScalars(),
+                           b->GetPointData()->GetScalars()) ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  vtkNew<vtkIdList> aIds, bIds;
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+  {
+    a->GetCellPoints(i, aIds);
+    b->GetCellPoints(i, bIds);
+    if (aIds->GetNumberOfIds() != bIds->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType j = 0; j < aIds->GetNumberOfIds(); ++j)
+    {
+      if (aIds->GetId(j) != bIds->GetId(j))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+int TestPLYReaderThreads(int argc, char *argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv,
+                                                         "VTK_TEMP_DIR",
+                                                         "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestPLYReaderThreads.ply";
+  delete [] tempDir;
+
+  // A sphere with more vertices than read in one block, with texture
+  // coordinates and colors.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(400);
+  sphere->SetPhiResolution(400);
+  sphere->Update();
+  vtkNew<vtkPolyData> surface;
+  surface->DeepCopy(sphere->GetOutput());
+  surface->GetPointData()->SetNormals(nullptr);
+  vtkIdType numPts = surface->GetNumberOfPoints();
+  vtkNew<vtkFloatArray> tcoords;
+  tcoords->SetName("TCoords");
+  tcoords->SetNumberOfComponents(2);
+  tcoords->SetNumberOfTuples(numPts);
+  vtkNew<vtkUnsignedCharArray> colors;
+  colors->SetName("RGB");
+  colors->SetNumberOfComponents(3);
+  colors->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3];
+    surface->GetPoint(i, x);
+    tcoords->SetTuple2(i, 0.5 * (x[0] + 1), 1.0 / (i + 1));
+    colors->SetTuple3(i, i % 256, (i / 256) % 256, 255 - i % 199);
+  }
+  surface->GetPointData()->SetTCoords(tcoords);
+  surface->GetPointData()->SetScalars(colors);
+
+  const char* fileTypes[] = { "ASCII", "little endian", "big endian" };
+  for (int type = 0; type < 3; ++type)
+  {
+    vtkNew<vtkPLYWriter> writer;
+    writer->SetInputData(surface);
+    writer->SetFileName(fileName.c_str());
+    if (type == 0)
+    {
+      writer->SetFileTypeToASCII();
+    }
+    else
+    {
+      writer->SetFileTypeToBinary();
+      writer->SetDataByteOrder(type == 2 ? VTK_BIG_ENDIAN : VTK_LITTLE_ENDIAN);
+    }
+    writer->SetArrayName("RGB");
+    if (!writer->Write())
+    {
+      std::cerr << "Cannot write " << fileName << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+      vtkNew<vtkPLYReader> reader;
+      reader->SetFileName(fileName.c_str());
+      vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { reader->Update(); });
+      if (!SameSurfaces(surface, reader->GetOutput()))
+      {
+        std::cerr << "The surface read from the "
+                  << fileTypes[type] << " file with "
+                  << (parallel ? "several threads" : "one thread")
+                  << " differs from the surface written" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  remove(fileName.c_str());
+  return EXIT_SUCCESS;
+}
@@ -50,12 +50,15 @@ WARRANTY OF MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE.
 #include "vtkHeap.h"
 #include "vtkByteSwap.h"
 #include "vtkMath.h"
+#include "vtkSMPTools.h"
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
 #include <cstddef>
 #include <cstring>
 #include <cassert>
 #include <limits>
+#include <vector>
 
 /* memory allocation */
 #define myalloc(mem_size) vtkPLY::my_alloc((mem_size), __LINE__, __FILE__)
@@ -1015,6 +1018,188 @@ void vtkPLY::ply_get_element(PlyFile *plyfile, void *elem_ptr)
 }
 
 
+namespace
+{
+
+// Decode elements made of scalar properties only, read from a binary file.
+struct vtkPLYDecodeElements
+{
+  PlyElement *Elem;
+  int FileType;
+  const char *Records;
+  int RecordSize;
+  char *Elements;
+  int ElementSize;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    int int_val;
+    unsigned int uint_val;
+    double double_val;
+    for (vtkIdType i = begin; i < end; i++) {
+      const char *record = this->Records + i * this->RecordSize;
+      char *elem_ptr = this->Elements + i * this->ElementSize;
+      for (int j = 0; j < this->Elem->nprops; j++) {
+        PlyProperty *prop = this->Elem->props[j];
+        if (this->Elem->store_prop[j]) {
+          vtkPLY::get_buffered_item (record, this->FileType,
+                                     prop->external_type,
+                                     &int_val, &uint_val, &double_val);
+          vtkPLY::store_item (elem_ptr + prop->offset, prop->internal_type,
+                              int_val, uint_val, double_val);
+        }
+        record += ply_type_size[prop->external_type];
+      }
+    }
+  }
+};
+
+// Decode elements made of scalar properties only, one per line of an ASCII
+// file. The words of each line are split in place.
+struct vtkPLYDecodeASCIIElements
+{
+  PlyElement *Elem;
+  char *Text;
+  const size_t *Lines;
+  char *Elements;
+  int ElementSize;
+
+  static bool IsSpace(char c)
+  {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+  }
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    int int_val;
+    unsigned int uint_val;
+    double double_val;
+    for (vtkIdType i = begin; i < end; i++) {
+      char *ptr = this->Text + this->Lines[i];
+      char *elem_ptr = this->Elements + i * this->ElementSize;
+      for (int j = 0; j < this->Elem->nprops; j++) {
+        while (IsSpace(*ptr))
+          ptr++;
+        const char *word = ptr;
+        while (*ptr != '\0' && !IsSpace(*ptr))
+          ptr++;
+        if (*ptr != '\0')
+          *ptr++ = '\0';
+        if (this->Elem->store_prop[j]) {
+          PlyProperty *prop = this->Elem->props[j];
+          vtkPLY::get_ascii_item (word, prop->external_type,
+                                  &int_val, &uint_val, &double_val);
+          vtkPLY::store_item (elem_ptr + prop->offset, prop->internal_type,
+                              int_val, uint_val, double_val);
+        }
+      }
+    }
+  }
+};
+
+}
+
+
+/******************************************************************************
+Read a number of elements from the file.  This is the same as calling
+ply_get_element() num_elems times, moving elem_ptr by elem_size bytes after
+each call, but the elements that have no list property are read in large
+blocks and decoded in parallel: fixed size records for binary files, lines
+for ASCII files.
+
+Entry:
+  plyfile   - file identifier
+  elem_ptr  - pointer to location where the first element should be put
+  num_elems - number of elements to read
+  elem_size - distance between the locations of two elements (bytes)
+******************************************************************************/
+
+void vtkPLY::ply_get_elements(
+  PlyFile *plyfile,
+  void *elem_ptr,
+  int num_elems,
+  int elem_size
+)
+{
+  PlyElement *elem = plyfile->which_elem;
+  char *elem_data = (char *) elem_ptr;
+
+  /* the size of the elements in the file, if it is fixed */
+  int record_size = 0;
+  bool fixed_size = elem->other_offset == NO_OTHER_PROPS;
+  for (int j = 0; fixed_size && j < elem->nprops; j++) {
+    PlyProperty *prop = elem->props[j];
+    if (prop->is_list || prop->external_type <= PLY_START_TYPE ||
+        prop->external_type >= PLY_END_TYPE)
+      fixed_size = false;
+    else
+      record_size += ply_type_size[prop->external_type];
+  }
+
+  if (!fixed_size || record_size == 0) {
+    for (int i = 0; i < num_elems; i++)
+      ply_get_element (plyfile, elem_data + (size_t) i * elem_size);
+    return;
+  }
+
+  if (plyfile->file_type == PLY_ASCII) {
+    /* read blocks of 65536 lines, each line holds one element */
+    const int block_size = 65536;
+    std::vector<char> text;
+    std::vector<size_t> lines;
+    char line[4096];
+    for (int first = 0; first < num_elems; first += block_size) {
+      int count = std::min(block_size, num_elems - first);
+      text.clear();
+      lines.clear();
+      bool eof = false;
+      for (int i = 0; i < count && !eof; i++) {
+        size_t start = text.size();
+        eof = true;
+        while (fgets (line, sizeof(line), plyfile->fp)) {
+          size_t length = strlen (line);
+          text.insert (text.end(), line, line + length);
+          eof = false;
+          if (length > 0 && line[length - 1] == '\n')
+            break;
+        }
+        if (!eof) {
+          text.push_back ('\0');
+          lines.push_back (start);
+        }
+      }
+      vtkPLYDecodeASCIIElements decode = { elem, text.data(), lines.data(),
+        elem_data + (size_t) first * elem_size, elem_size };
+      vtkSMPTools::For(0, static_cast<vtkIdType>(lines.size()), decode);
+      if (eof) {
+        vtkGenericWarningMacro ("PLY error reading file."
+                                << " Premature EOF while reading "
+                                << elem->name << ".");
+        return;
+      }
+    }
+    return;
+  }
+
+  /* read blocks of about 4 MB */
+  int block_size = std::max(1, (1 << 22) / record_size);
+  std::vector<char> records((size_t) std::min(block_size, num_elems) * record_size);
+  for (int first = 0; first < num_elems; first += block_size) {
+    int count = std::min(block_size, num_elems - first);
+    size_t num_read = fread (records.data(), record_size, count, plyfile->fp);
+    vtkPLYDecodeElements decode = { elem, plyfile->file_type, records.data(),
+      record_size, elem_data + (size_t) first * elem_size, elem_size };
+    vtkSMPTools::For(0, static_cast<vtkIdType>(num_read), decode);
+    if (num_read < (size_t) count) {
+      vtkGenericWarningMacro ("PLY error reading file."
+                              << " Premature EOF while reading "
+                              << elem->name << ".");
+      return;
+    }
+  }
+}
+
+
 /******************************************************************************
 Extract the comments from the header information of a PLY file.
 
@@ -2305,19 +2490,58 @@ void vtkPLY::get_binary_item(
   unsigned int *uint_val,
   double *double_val
 )
+{
+  if (type <= PLY_START_TYPE || type >= PLY_END_TYPE) {
+    fprintf (stderr, "get_binary_item: bad type = %d\n", type);
+    assert (0);
+    return;
+  }
+
+  char buffer[8];
+  if (fread (buffer, ply_type_size[type], 1, plyfile->fp) != 1)
+  {
+    vtkGenericWarningMacro ("PLY error reading file."
+                            << " Premature EOF while reading "
+                            << type_names[type] << ".");
+    fclose (plyfile->fp);
+    return;
+  }
+
+  get_buffered_item (buffer, plyfile->file_type, type,
+                     int_val, uint_val, double_val);
+}
+
+
+/******************************************************************************
+Get the value of an item read from a binary file, and place the result
+into an integer, an unsigned integer and a double.
+
+Entry:
+  ptr       - the bytes of the item
+  file_type - byte order of the file
+  type      - data type supposedly in the word
+
+Exit:
+  int_val    - integer value
+  uint_val   - unsigned integer value
+  double_val - double-precision floating point value
+******************************************************************************/
+
+void vtkPLY::get_buffered_item(
+  const char *ptr,
+  int file_type,
+  int type,
+  int *int_val,
+  unsigned int *uint_val,
+  double *double_val
+)
 {
   switch (type) {
     case PLY_CHAR:
     case PLY_INT8:
       {
       vtkTypeInt8 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading char.");
-        fclose (plyfile->fp);
-        return;
-      }
+      memcpy(&value, ptr, sizeof(value));
 
       // Here value can always fit in int, unsigned int, and double.
       *int_val = static_cast<int>(value);
@@ -2329,13 +2553,7 @@ void vtkPLY::get_binary_item(
     case PLY_UINT8:
     {
       vtkTypeUInt8 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading uchar or uint8.");
-        fclose (plyfile->fp);
-        return;
-      }
+      memcpy(&value, ptr, sizeof(value));
 
       // Here value can always fit in int, unsigned int, and double.
       *int_val = static_cast<int>(value);
@@ -2347,14 +2565,8 @@ void vtkPLY::get_binary_item(
     case PLY_INT16:
     {
       vtkTypeInt16 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading short.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, ptr, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap2BE(&value) :
         vtkByteSwap::Swap2LE(&value);
 
@@ -2368,14 +2580,8 @@ void vtkPLY::get_binary_item(
     case PLY_UINT16:
     {
       vtkTypeUInt16 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading ushort.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, ptr, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap2BE(&value) :
         vtkByteSwap::Swap2LE(&value);
 
@@ -2389,14 +2595,8 @@ void vtkPLY::get_binary_item(
     case PLY_INT32:
     {
       vtkTypeInt32 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading int or int32.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, ptr, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap4BE(&value) :
         vtkByteSwap::Swap4LE(&value);
 
@@ -2410,14 +2610,8 @@ void vtkPLY::get_binary_item(
     case PLY_UINT32:
     {
       vtkTypeUInt32 value = 0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading uint");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, ptr, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap4BE(&value) :
         vtkByteSwap::Swap4LE(&value);
 
@@ -2431,14 +2625,8 @@ void vtkPLY::get_binary_item(
     case PLY_FLOAT32:
     {
       vtkTypeFloat32 value = 0.0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading float of float32.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, ptr, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap4BE(&value) :
         vtkByteSwap::Swap4LE(&value);
 
@@ -2454,14 +2642,8 @@ void vtkPLY::get_binary_item(
     case PLY_FLOAT64:
     {
       vtkTypeFloat64 value = 0.0;
-      if (fread (&value, sizeof(value), 1, plyfile->fp) != 1)
-      {
-        vtkGenericWarningMacro ("PLY error reading file."
-                                << " Premature EOF while reading double.");
-        fclose (plyfile->fp);
-        return;
-      }
-      plyfile->file_type == PLY_BINARY_BE ?
+      memcpy(&value, ptr, sizeof(value));
+      file_type == PLY_BINARY_BE ?
         vtkByteSwap::Swap8BE(&value) :
         vtkByteSwap::Swap8LE(&value);
 
@@ -2472,7 +2654,7 @@ void vtkPLY::get_binary_item(
     }
       break;
     default:
-      fprintf (stderr, "get_binary_item: bad type = %d\n", type);
+      fprintf (stderr, "get_buffered_item: bad type = %d\n", type);
       assert (0);
   }
 }
@@ -182,6 +182,7 @@ public:
   static void ply_get_property(PlyFile *, const char *, PlyProperty *);
   static PlyOtherProp *ply_get_other_properties(PlyFile *, const char *, int);
   static void ply_get_element(PlyFile *, void *);
+  static void ply_get_elements(PlyFile *, void *, int, int);
   static char **ply_get_comments(PlyFile *, int *);
   static char **ply_get_obj_info(PlyFile *, int *);
   static void ply_close(PlyFile *);
@@ -213,6 +214,7 @@ public:
   static double get_item_value(const char *, int);
   static void get_ascii_item(const char *, int, int *, unsigned int *, double *);
   static void get_binary_item(PlyFile *, int, int *, unsigned int *, double *);
+  static void get_buffered_item(const char *, int, int, int *, unsigned int *, double *);
   static void ascii_get_element(PlyFile *, char *);
   static void binary_get_element(PlyFile *, char *);
   static void *my_alloc(size_t, int, const char *);
@@ -27,8 +27,10 @@
 #include "vtkStringArray.h"
 #include <vtksys/SystemTools.hxx>
 
+#include <algorithm>
 #include <cctype>
 #include <cstddef>
+#include <vector>
 
 vtkStandardNewMacro(vtkPLYReader);
 
@@ -331,10 +333,18 @@ int vtkPLYReader::RequestData(
         RGBPoints->SetNumberOfTuples(numPts);
       }
 
-      plyVertex vertex;
+      // Read the vertices a block at a time
+      std::vector<plyVertex> vertices(std::min(numPts, 65536));
       for (int j=0; j < numPts; j++)
       {
-        vtkPLY::ply_get_element (ply, (void *) &vertex);
+        int v = j % static_cast<int>(vertices.size());
+        if (v == 0)
+        {
+          vtkPLY::ply_get_elements (ply, vertices.data(),
+            std::min(numPts - j, static_cast<int>(vertices.size())),
+            static_cast<int>(sizeof(plyVertex)));
+        }
+        const plyVertex& vertex = vertices[v];
         pts->SetPoint (j, vertex.x);
         if ( TexCoordsPointsAvailable )
         {
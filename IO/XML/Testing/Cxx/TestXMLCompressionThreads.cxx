@@ -0,0 +1,209 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLCompressionThreads.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that the XML writer produces the same compressed files with one and
+// with several threads, and that the reader uncompresses them in parallel.
+
+#include "vtkCellArray.h"
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkIdTypeArray.h"
+#include "vtkIntArray.h"
+#include "vtkLZ4DataCompressor.h"
+#include "vtkLZMADataCompressor.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPoints.h"
+#include "vtkTestArrays.h"
+#include "vtkTestSMP.h"
+#include "vtkSmartPointer.h"
+#include "vtkUnstructuredGrid.h"
+#include "vtkXMLUnstructuredGridReader.h"
+#include "vtkXMLUnstructuredGridWriter.h"
+#include "vtkZLibDataCompressor.h"
+
+#include <string>
+
+namespace
+{
+
+bool SameGrids(vtkUnstructuredGrid *a, vtkUnstructuredGrid *b)
+{
+  if (a->GetNumberOfPoints() != b->GetNumberOfPoints() ||
+      a->GetNumberOfCells() != b->GetNumberOfCells())
+  {
+    return false;
+  }
+  for (vtkIdType i = 0; i < a->GetNumberOfPoints(); ++i)
+  {
+    double p[3], q[3];
+    a->GetPoint(i, p);
+    b->GetPoint(i, q);
+    if (p[0] != q[0] || p[1] != q[1] || p[2] != q[2])
+    {
+      return false;
+    }
+  }
+  vtkNew<vtkIdList> aIds, bIds;
+  for (vtkIdType i = 0; i < a->GetNumberOfCells(); ++i)
+  {
+    a->GetCellPoints(i, aIds);
+    b->GetCellPoints(i, bIds);
+    if (a->GetCellType(i) != b->GetCellType(i) ||
+        aIds->GetNumberOfIds() != bIds->GetNumberOfIds())
+    {
+      return false;
+    }
+    for (vtkIdType j = 0; j < aIds->GetNumberOfIds(); ++j)
+    {
+      if (aIds->GetId(j) != bIds->GetId(j))
+      {
+        return false;
+      }
+    }
+  }
+  return vtkTest::SameArrays(a->GetPointData(), b->GetPointData()) &&
+    vtkTest::SameArrays(a->GetCellData(), b->GetCellData());
+}
+
+// Triangles over a grid of points, with arrays of several types.
+void MakeGrid(vtkUnstructuredGrid *grid, int n)
+{
+  vtkNew<vtkPoints> points;
+  points->SetDataTypeToDouble();
+  vtkNew<vtkDoubleArray> scalars;
+  scalars->SetName("scalars");
+  vtkNew<vtkIntArray> labels;
+  labels->SetName("labels");
+  labels->SetNumberOfComponents(2);
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < n; ++i)
+    {
+      points->InsertNextPoint(i, j, 0.01 * ((i * j) % 17));
+      scalars->InsertNextValue(1.0 / (1 + i + j * n));
+      labels->InsertNextTuple2((i * 7) % 13, j % 5);
+    }
+  }
+  grid->SetPoints(points);
+  grid->GetPointData()->SetScalars(scalars);
+  grid->GetPointData()->AddArray(labels);
+
+  grid->Allocate(2 * (n - 1) * (n - 1));
+  vtkNew<vtkIdTypeArray> ids;
+  ids->SetName("ids");
+  for (int j = 0; j + 1 < n; ++j)
+  {
+    for (int i = 0; i + 1 < n; ++i)
+    {
+      vtkIdType p = i + j * n;
+      vtkIdType lower[3] = { p, p + 1, p + n + 1 };
+      vtkIdType upper[3] = { p, p + n + 1, p + n };
+      ids->InsertNextValue(grid->InsertNextCell(VTK_TRIANGLE, 3, lower));
+      ids->InsertNextValue(grid->InsertNextCell(VTK_TRIANGLE, 3, upper));
+    }
+  }
+  grid->GetCellData()->AddArray(ids);
+}
+
+}
+
+int TestXMLCompressionThreads(int, char *[])
+{
+  vtkNew<vtkUnstructuredGrid> grid;
+  MakeGrid(grid, 120);
+
+  // Writing caches the ranges of the arrays in their information, which
+  // later writes include.  Write once so that all the files compared below
+  // have the same header.
+  vtkNew<vtkXMLUnstructuredGridWriter> firstWriter;
+  firstWriter->SetInputData(grid);
+  firstWriter->WriteToOutputStringOn();
+  firstWriter->Write();
+
+  vtkSmartPointer<vtkDataCompressor> compressors[3] = {
+    vtkSmartPointer<vtkZLibDataCompressor>::New(),
+    vtkSmartPointer<vtkLZ4DataCompressor>::New(),
+    vtkSmartPointer<vtkLZMADataCompressor>::New()
+  };
+  for (int c = 0; c < 3; ++c)
+  {
+    for (int encode = 0; encode < 2; ++encode)
+    {
+      std::string outputs[2];
+      for (int parallel = 0; parallel < 2; ++parallel)
+      {
+        vtkNew<vtkXMLUnstructuredGridWriter> writer;
+        writer->SetInputData(grid);
+        writer->SetDataModeToAppended();
+        writer->SetEncodeAppendedData(encode);
+        writer->SetCompressor(compressors[c]);
+        writer->SetBlockSize(4096);
+        writer->WriteToOutputStringOn();
+        vtkTest::RunThreaded(parallel ? 4 : 1, [&]() { writer->Write(); });
+        outputs[parallel] = writer->GetOutputString();
+      }
+
+      if (outputs[0] != outputs[1])
+      {
+        std::cerr << "The parallel output differs for the "
+                  << compressors[c]->GetClassName()
+                  << (encode ? " (encoded)" : " (raw)") << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vtkNew<vtkXMLUnstructuredGridReader> reader;
+      reader->ReadFromInputStringOn();
+      reader->SetInputString(outputs[1]);
+      vtkTest::RunThreaded(4, [&]() { reader->Update(); });
+
+      if (!SameGrids(grid, reader->GetOutput()))
+      {
+        std::cerr << "The grid read with the "
+                  << compressors[c]->GetClassName()
+                  << (encode ? " (encoded)" : " (raw)")
+                  << " differs from the grid written" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The high compression mode of LZ4 can be selected through the writer.
+  vtkNew<vtkXMLUnstructuredGridWriter> writer;
+  writer->SetCompressorTypeToLZ4HC();
+  writer->SetCompressionLevel(9);
+  vtkLZ4DataCompressor* lz4 =
+    vtkLZ4DataCompressor::SafeDownCast(writer->GetCompressor());
+  if (!lz4 || !lz4->GetHighCompression() || lz4->GetCompressionLevel() != 9)
+  {
+    std::cerr << "The writer did not select LZ4HC" << std::endl;
+    return EXIT_FAILURE;
+  }
+  writer->SetInputData(grid);
+  writer->SetDataModeToAppended();
+  writer->WriteToOutputStringOn();
+  vtkTest::RunThreaded(4, [&]() { writer->Write(); });
+  vtkNew<vtkXMLUnstructuredGridReader> reader;
+  reader->ReadFromInputStringOn();
+  reader->SetInputString(writer->GetOutputString());
+  reader->Update();
+  if (!SameGrids(grid, reader->GetOutput()))
+  {
+    std::cerr << "The grid read with LZ4HC differs from the grid written"
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
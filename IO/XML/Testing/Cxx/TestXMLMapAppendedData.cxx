@@ -0,0 +1,147 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TestXMLMapAppendedData.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Check that vtkXMLReader::MapAppendedData reads the same arrays as the
+// regular reading, for raw, encoded and compressed appended data, and that
+// the mapped arrays stay valid and private after the reader is destroyed.
+
+#include "vtkCellData.h"
+#include "vtkDoubleArray.h"
+#include "vtkFloatArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkSmartPointer.h"
+#include "vtkTestArrays.h"
+#include "vtkTestUtilities.h"
+#include "vtkUnsignedCharArray.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkZLibDataCompressor.h"
+
+#include <cstdio>
+#include <string>
+
+namespace
+{
+
+vtkSmartPointer<vtkImageData> Read(const std::string& fileName, bool map)
+{
+  vtkNew<vtkXMLImageDataReader> reader;
+  reader->SetFileName(fileName.c_str());
+  reader->SetMapAppendedData(map);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+}
+
+int TestXMLMapAppendedData(int argc, char *argv[])
+{
+  char* tempDir = vtkTestUtilities::GetArgOrEnvOrDefault("-T", argc, argv,
+                                                         "VTK_TEMP_DIR",
+                                                         "Testing/Temporary");
+  std::string fileName = std::string(tempDir) + "/TestXMLMapAppendedData.vti";
+  delete [] tempDir;
+
+  // Arrays of several word sizes, so that some of them are aligned in the
+  // file whatever the size of the XML header.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(40, 30, 20);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkNew<vtkUnsignedCharArray> labels;
+  labels->SetName("labels");
+  labels->SetNumberOfTuples(numPts);
+  vtkNew<vtkFloatArray> vectors;
+  vectors->SetName("vectors");
+  vectors->SetNumberOfComponents(3);
+  vectors->SetNumberOfTuples(numPts);
+  vtkNew<vtkDoubleArray> distance;
+  distance->SetName("distance");
+  distance->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    labels->SetValue(i, static_cast<unsigned char>((i * 7) % 251));
+    vectors->SetTuple3(i, 0.5 * i, -1.0 * (i % 13), 1.0 / (i + 1));
+    distance->SetValue(i, 0.001 * i * i);
+  }
+  image->GetPointData()->AddArray(labels);
+  image->GetPointData()->SetVectors(vectors);
+  image->GetPointData()->SetScalars(distance);
+  vtkNew<vtkIntArray> ids;
+  ids->SetName("ids");
+  ids->SetNumberOfTuples(image->GetNumberOfCells());
+  for (vtkIdType i = 0; i < image->GetNumberOfCells(); ++i)
+  {
+    ids->SetValue(i, static_cast<int>(i * 3 - 5));
+  }
+  image->GetCellData()->AddArray(ids);
+
+  for (int mode = 0; mode < 3; ++mode)
+  {
+    vtkNew<vtkXMLImageDataWriter> writer;
+    writer->SetInputData(image);
+    writer->SetFileName(fileName.c_str());
+    writer->SetDataModeToAppended();
+    writer->SetEncodeAppendedData(mode == 1);
+    if (mode == 2)
+    {
+      vtkNew<vtkZLibDataCompressor> compressor;
+      writer->SetCompressor(compressor);
+    }
+    else
+    {
+      writer->SetCompressor(nullptr);
+    }
+    if (!writer->Write())
+    {
+      std::cerr << "Cannot write " << fileName << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vtkSmartPointer<vtkImageData> read = Read(fileName, false);
+    vtkSmartPointer<vtkImageData> mapped = Read(fileName, true);
+    if (!vtkTest::SameArrays(image->GetPointData(), mapped->GetPointData()) ||
+        !vtkTest::SameArrays(image->GetCellData(), mapped->GetCellData()) ||
+        !vtkTest::SameArrays(read->GetPointData(), mapped->GetPointData()))
+    {
+      std::cerr << "The mapped arrays differ (mode " << mode << ")"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Changing the mapped values must not change the file.
+    vtkDataArray* mappedLabels = mapped->GetPointData()->GetArray("labels");
+    mappedLabels->SetComponent(0, 0, 255);
+    mappedLabels->SetComponent(numPts - 1, 0, 254);
+    read = Read(fileName, true);
+    if (!vtkTest::SameArrays(image->GetPointData(), read->GetPointData()))
+    {
+      std::cerr << "Changing a mapped array changed the file (mode " << mode
+                << ")" << std::endl;
+      return EXIT_FAILURE;
+    }
+    if (mappedLabels->GetComponent(0, 0) != 255 ||
+        mappedLabels->GetComponent(numPts - 1, 0) != 254)
+    {
+      std::cerr << "Cannot change a mapped array (mode " << mode << ")"
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  remove(fileName.c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    TimeXMLCompressors.cxx
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+// Report the compression ratio and the write and read throughput of the XML
+// writers and readers for each compressor and a few compression levels, and
+// check that the data read back are the data written.
+
+#include "vtkDataSet.h"
+#include "vtkDoubleArray.h"
+#include "vtkImageData.h"
+#include "vtkIntArray.h"
+#include "vtkLZ4DataCompressor.h"
+#include "vtkLZMADataCompressor.h"
+#include "vtkNew.h"
+#include "vtkPointData.h"
+#include "vtkPolyData.h"
+#include "vtkSMPTools.h"
+#include "vtkSmartPointer.h"
+#include "vtkSphereSource.h"
+#include "vtkTestArrays.h"
+#include "vtkTimerLog.h"
+#include "vtkXMLImageDataReader.h"
+#include "vtkXMLImageDataWriter.h"
+#include "vtkXMLPolyDataReader.h"
+#include "vtkXMLPolyDataWriter.h"
+#include "vtkZLibDataCompressor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <string>
+
+namespace
+{
+
+struct Configuration
+{
+  const char* Name;
+  int Level;
+};
+
+vtkSmartPointer<vtkDataCompressor> MakeCompressor(const Configuration& config)
+{
+  std::string name = config.Name;
+  vtkSmartPointer<vtkDataCompressor> compressor;
+  if (name == "zlib")
+  {
+    compressor = vtkSmartPointer<vtkZLibDataCompressor>::New();
+  }
+  else if (name == "lzma")
+  {
+    compressor = vtkSmartPointer<vtkLZMADataCompressor>::New();
+  }
+  else if (name == "lz4" || name == "lz4hc")
+  {
+    vtkNew<vtkLZ4DataCompressor> lz4;
+    lz4->SetHighCompression(name == "lz4hc");
+    compressor = lz4.GetPointer();
+  }
+  if (compressor)
+  {
+    compressor->SetCompressionLevel(config.Level);
+  }
+  return compressor;
+}
+
+// Write the dataset with each configuration, read it back and report the
+// ratio and throughput relative to the uncompressed size of the file.
+template <class WriterT, class ReaderT>
+int Time(vtkDataSet* data, const char* name)
+{
+  static const Configuration configurations[] = {
+    { "none", 0 },
+    { "lz4", 1 }, { "lz4", 9 },
+    { "lz4hc", 1 }, { "lz4hc", 5 },
+    { "zlib", 1 }, { "zlib", 5 },
+    { "lzma", 1 }
+  };
+
+  vtkNew<vtkTimerLog> timer;
+  double rawSize = 0;
+  std::cout << "\n" << name << "\n"
+            << "compressor level   ratio  write MB/s   read MB/s\n";
+  for (const Configuration& config : configurations)
+  {
+    vtkNew<WriterT> writer;
+    writer->SetInputData(data);
+    writer->SetDataModeToAppended();
+    writer->EncodeAppendedDataOff();
+    writer->SetCompressor(MakeCompressor(config));
+    writer->WriteToOutputStringOn();
+    timer->StartTimer();
+    writer->Write();
+    timer->StopTimer();
+    double writeTime = timer->GetElapsedTime();
+    std::string output = writer->GetOutputString();
+    if (!rawSize)
+    {
+      rawSize = static_cast<double>(output.size());
+    }
+
+    vtkNew<ReaderT> reader;
+    reader->ReadFromInputStringOn();
+    reader->SetInputString(output);
+    timer->StartTimer();
+    reader->Update();
+    timer->StopTimer();
+    double readTime = timer->GetElapsedTime();
+
+    if (!vtkTest::SameArrays(data->GetPointData(),
+                             reader->GetOutput()->GetPointData()))
+    {
+      std::cerr << "The " << name << " read with " << config.Name
+                << " at level " << config.Level
+                << " differs from the one written" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    double megabytes = rawSize / (1024.0 * 1024.0);
+    std::cout << std::setw(10) << config.Name << std::setw(6) << config.Level
+              << std::fixed << std::setprecision(2)
+              << std::setw(8) << rawSize / output.size()
+              << std::setw(12) << megabytes / std::max(writeTime, 1e-6)
+              << std::setw(12) << megabytes / std::max(readTime, 1e-6)
+              << "\n";
+  }
+  return EXIT_SUCCESS;
+}
+
+}
+
+int TimeXMLCompressors(int, char *[])
+{
+  std::cout << "Timing with " << vtkSMPTools::GetEstimatedNumberOfThreads()
+            << " threads" << std::endl;
+
+  // A smooth field and a label field on an image, as written by
+  // simulations.
+  vtkNew<vtkImageData> image;
+  image->SetDimensions(64, 64, 48);
+  vtkIdType numPts = image->GetNumberOfPoints();
+  vtkNew<vtkDoubleArray> field;
+  field->SetName("field");
+  field->SetNumberOfTuples(numPts);
+  vtkNew<vtkIntArray> labels;
+  labels->SetName("labels");
+  labels->SetNumberOfTuples(numPts);
+  for (vtkIdType i = 0; i < numPts; ++i)
+  {
+    double x[3];
+    image->GetPoint(i, x);
+    double value = std::sin(0.1 * x[0]) * std::cos(0.07 * x[1]) +
+      0.01 * x[2] * x[2];
+    field->SetValue(i, value);
+    labels->SetValue(i, static_cast<int>(4 * value + 8));
+  }
+  image->GetPointData()->SetScalars(field);
+  image->GetPointData()->AddArray(labels);
+  if (Time<vtkXMLImageDataWriter, vtkXMLImageDataReader>(image, "image") !=
+      EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+
+  // A triangulated surface with normals.
+  vtkNew<vtkSphereSource> sphere;
+  sphere->SetThetaResolution(200);
+  sphere->SetPhiResolution(200);
+  sphere->Update();
+  return Time<vtkXMLPolyDataWriter, vtkXMLPolyDataReader>(
+    sphere->GetOutput(), "surface");
+}
@@ -50,10 +50,18 @@
 #include <cassert>
 #include <functional>
 #include <locale> // C++ locale
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <vector>
 #include <cctype>
 
+#if !defined(_WIN32)
+# include <fcntl.h>    /* open */
+# include <sys/mman.h> /* mmap */
+# include <unistd.h>   /* close, sysconf */
+#endif
+
 vtkCxxSetObjectMacro(vtkXMLReader,ReaderErrorObserver,vtkCommand);
 vtkCxxSetObjectMacro(vtkXMLReader,ParserErrorObserver,vtkCommand);
 
@@ -135,6 +143,7 @@ vtkXMLReader::vtkXMLReader()
   this->StringStream = nullptr;
   this->ReadFromInputString = 0;
   this->InputString = "";
+  this->MapAppendedData = 0;
   this->XMLParser = nullptr;
   this->ReaderErrorObserver = nullptr;
   this->ParserErrorObserver = nullptr;
@@ -230,6 +239,7 @@ void vtkXMLReader::PrintSelf(ostream& os, vtkIndent indent)
   {
     os << indent << "Stream: (none)\n";
   }
+  os << indent << "MapAppendedData: " << this->MapAppendedData << "\n";
   os << indent << "TimeStep:" << this->TimeStep << "\n";
   os << indent << "NumberOfTimeSteps:" << this->NumberOfTimeSteps << "\n";
   os << indent << "TimeStepRange:(" << this->TimeStepRange[0] << ","
@@ -855,6 +865,96 @@ int vtkXMLDataReaderReadArrayValues(
   return result;
 }
 
+
+#if !defined(_WIN32)
+//----------------------------------------------------------------------------
+// The file regions mapped for arrays, by address of the array values.
+struct MappedRegions
+{
+  std::mutex Lock;
+  std::map<void*, std::pair<void*, size_t> > Regions;
+};
+
+// Never destroyed: arrays may be released during static destruction.
+MappedRegions& GetMappedRegions()
+{
+  static MappedRegions* regions = new MappedRegions;
+  return *regions;
+}
+
+// Free function of the mapped arrays.
+void UnmapArrayValues(void* values)
+{
+  MappedRegions& mapped = GetMappedRegions();
+  std::lock_guard<std::mutex> lock(mapped.Lock);
+  auto region = mapped.Regions.find(values);
+  if (region != mapped.Regions.end())
+  {
+    munmap(region->second.first, region->second.second);
+    mapped.Regions.erase(region);
+  }
+}
+#endif
+
+//----------------------------------------------------------------------------
+// Use the values of raw appended data in place, as a private mapping of the
+// file.  Returns 0 if the values must be read instead.
+int vtkXMLReaderMapArrayValues(vtkXMLDataElement* da,
+  vtkXMLDataParser* xmlparser, const char* fileName, vtkAbstractArray* array)
+{
+#if defined(_WIN32)
+  (void)da;
+  (void)xmlparser;
+  (void)fileName;
+  (void)array;
+  return 0;
+#else
+  vtkTypeInt64 offset = 0;
+  vtkDataArray* dataArray = vtkArrayDownCast<vtkDataArray>(array);
+  if (!dataArray || !dataArray->HasStandardMemoryLayout() ||
+      array->GetDataType() == VTK_BIT || array->GetNumberOfValues() == 0 ||
+      !da->GetScalarAttribute("offset", offset))
+  {
+    return 0;
+  }
+  size_t numValues = static_cast<size_t>(array->GetNumberOfValues());
+  size_t wordSize = static_cast<size_t>(array->GetDataTypeSize());
+  vtkTypeInt64 position = xmlparser->GetRawAppendedDataPosition(
+    offset, numValues, array->GetDataType());
+  if (position < 0 || position % wordSize != 0)
+  {
+    return 0;
+  }
+
+  // Mappings start on a page boundary.
+  vtkTypeInt64 pageSize = static_cast<vtkTypeInt64>(sysconf(_SC_PAGESIZE));
+  vtkTypeInt64 begin = position - position % pageSize;
+  size_t length = static_cast<size_t>(position - begin) + numValues * wordSize;
+  int fd = open(fileName, O_RDONLY);
+  if (fd < 0)
+  {
+    return 0;
+  }
+  void* region = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      fd, static_cast<off_t>(begin));
+  close(fd);
+  if (region == MAP_FAILED)
+  {
+    return 0;
+  }
+  void* values = static_cast<char*>(region) + (position - begin);
+  {
+    MappedRegions& mapped = GetMappedRegions();
+    std::lock_guard<std::mutex> lock(mapped.Lock);
+    mapped.Regions[values] = std::make_pair(region, length);
+  }
+  array->SetVoidArray(values, static_cast<vtkIdType>(numValues), 0,
+                      vtkAbstractArray::VTK_DATA_ARRAY_USER_DEFINED);
+  array->SetArrayFreeFunction(UnmapArrayValues);
+  return 1;
+#endif
+}
+
 }
 
 //----------------------------------------------------------------------------
@@ -870,18 +970,28 @@ int vtkXMLReader::ReadArrayValues(
   }
   this->InReadData = 1;
   int result;
-  vtkArrayIterator* iter = array->NewIterator();
-  switch (array->GetDataType())
+  if (this->MapAppendedData && this->FileStream &&
+      this->Stream == this->FileStream && arrayIndex == 0 &&
+      startIndex == 0 && numValues == array->GetNumberOfValues() &&
+      vtkXMLReaderMapArrayValues(da, this->XMLParser, this->FileName, array))
   {
-    vtkArrayIteratorTemplateMacro(
-      result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
-        arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
-  default:
-    result = 0;
+    result = 1;
   }
-  if (iter)
+  else
   {
-    iter->Delete();
+    vtkArrayIterator* iter = array->NewIterator();
+    switch (array->GetDataType())
+    {
+      vtkArrayIteratorTemplateMacro(
+        result = vtkXMLDataReaderReadArrayValues(da, this->XMLParser,
+          arrayIndex, static_cast<VTK_TT*>(iter), startIndex, numValues));
+    default:
+      result = 0;
+    }
+    if (iter)
+    {
+      iter->Delete();
+    }
   }
 
   this->ConvertGhostLevelsToGhostType(fieldType, array, startIndex, numValues);
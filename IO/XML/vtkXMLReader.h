@@ -72,6 +72,22 @@ public:
   void SetInputString(const std::string& s) { this->InputString = s; }
   //@}
 
+  //@{
+  /**
+   * Enable mapping the appended data of the input file into memory instead
+   * of reading it.  Arrays stored raw and uncompressed, with the byte order
+   * of this machine and aligned for their type in the file, then use the
+   * mapped file as their memory: pages are loaded when first accessed, and
+   * the mapping is released with the array.  Changes to the values are not
+   * written to the file.  Other arrays are read as usual.  Mapping is not
+   * available on Windows, nor when reading from a string or a user stream.
+   * Default is off.
+   */
+  vtkSetMacro(MapAppendedData, vtkTypeBool);
+  vtkGetMacro(MapAppendedData, vtkTypeBool);
+  vtkBooleanMacro(MapAppendedData, vtkTypeBool);
+  //@}
+
   /**
    * Test whether the file (type) with the given name can be read by this
    * reader. If the file has a newer version than the reader, we still say
@@ -322,6 +338,9 @@ protected:
   // The input string.
   std::string InputString;
 
+  // Whether to map raw appended data into memory.
+  vtkTypeBool MapAppendedData;
+
   // The array selections.
   vtkDataArraySelection* PointDataArraySelection;
   vtkDataArraySelection* CellDataArraySelection;
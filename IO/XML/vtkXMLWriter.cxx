@@ -44,6 +44,7 @@
 #include "vtkOutputStream.h"
 #include "vtkPointData.h"
 #include "vtkPoints.h"
+#include "vtkSMPTools.h"
 #include "vtkStdString.h"
 #include "vtkStreamingDemandDrivenPipeline.h"
 #include "vtkUnsignedCharArray.h"
@@ -62,9 +63,11 @@
 #include "vtkXMLReaderVersion.h"
 #include <memory>
 
+#include <algorithm>
 #include <cassert>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #if !defined(_WIN32) || defined(__CYGWIN__)
 # include <unistd.h> /* unlink */
@@ -443,6 +446,85 @@ static int vtkXMLWriterWriteBinaryDataBlocks(
 
 } // end anon namespace
 //*****************************************************************************
+// Uncompressed blocks of the array being written, waiting to be compressed
+// together in parallel.  The compressed blocks are written in their original
+// order, so the file does not depend on the number of threads.
+class vtkXMLWriterCompressionQueue
+{
+public:
+  // Number of blocks compressed together, per thread.  This bounds the
+  // memory used by the queue to a few blocks per thread.
+  static const size_t BlocksPerThread = 4;
+
+  bool Enabled = false;
+  size_t Capacity = 0;
+  size_t BlockSize = 0;
+  size_t CompressionSpace = 0;
+  size_t NumberOfBlocks = 0;
+  std::vector<unsigned char> Input;
+  std::vector<size_t> InputSizes;
+  std::vector<unsigned char> Output;
+  std::vector<size_t> OutputSizes;
+
+  // Prepare the queue for an array of numBlocks blocks.  The queue is
+  // enabled only if the blocks can be compressed concurrently.
+  void Initialize(vtkDataCompressor* compressor, size_t blockSize,
+                  size_t numBlocks)
+  {
+    this->NumberOfBlocks = 0;
+    size_t numThreads =
+      static_cast<size_t>(vtkSMPTools::GetEstimatedNumberOfThreads());
+    this->Enabled = numBlocks > 1 && numThreads > 1 &&
+      (compressor->IsA("vtkZLibDataCompressor") ||
+       compressor->IsA("vtkLZ4DataCompressor") ||
+       compressor->IsA("vtkLZMADataCompressor"));
+    if (!this->Enabled)
+    {
+      return;
+    }
+    this->Capacity = std::min(numBlocks, numThreads * BlocksPerThread);
+    this->BlockSize = blockSize;
+    this->CompressionSpace = compressor->GetMaximumCompressionSpace(blockSize);
+    this->Input.resize(this->Capacity * this->BlockSize);
+    this->InputSizes.resize(this->Capacity);
+    this->Output.resize(this->Capacity * this->CompressionSpace);
+    this->OutputSizes.resize(this->Capacity);
+  }
+
+  void Push(unsigned char const* data, size_t size)
+  {
+    memcpy(&this->Input[this->NumberOfBlocks * this->BlockSize], data, size);
+    this->InputSizes[this->NumberOfBlocks++] = size;
+  }
+
+  unsigned char* GetOutput(size_t block)
+  {
+    return &this->Output[block * this->CompressionSpace];
+  }
+};
+
+namespace
+{
+// Compress the queued blocks.  The compressors accepted by the queue keep no
+// state between calls, so one instance can be shared by the threads.
+struct CompressBlocks
+{
+  vtkDataCompressor* Compressor;
+  vtkXMLWriterCompressionQueue* Queue;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    vtkXMLWriterCompressionQueue* queue = this->Queue;
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      size_t block = static_cast<size_t>(i);
+      queue->OutputSizes[block] = this->Compressor->Compress(
+        &queue->Input[block * queue->BlockSize], queue->InputSizes[block],
+        queue->GetOutput(block), queue->CompressionSpace);
+    }
+  }
+};
+}
 
 vtkCxxSetObjectMacro(vtkXMLWriter, Compressor, vtkDataCompressor);
 //----------------------------------------------------------------------------
@@ -474,6 +556,7 @@ vtkXMLWriter::vtkXMLWriter()
   this->BlockSize = 32768; //2^15
   this->Compressor = vtkZLibDataCompressor::New();
   this->CompressionHeader = nullptr;
+  this->CompressionQueue = new vtkXMLWriterCompressionQueue;
   this->Int32IdTypeBuffer = nullptr;
   this->ByteSwapBuffer = nullptr;
 
@@ -510,6 +593,7 @@ vtkXMLWriter::~vtkXMLWriter()
   this->OutStringStream = nullptr;
   delete this->FieldDataOM;
   delete[] this->NumberOfTimeValues;
+  delete this->CompressionQueue;
 }
 
 //----------------------------------------------------------------------------
@@ -534,13 +618,15 @@ void vtkXMLWriter::SetCompressorType(int compressorType)
     this->Compressor->SetCompressionLevel(this->CompressionLevel);
     this->Modified();
   }
-  else if (compressorType == LZ4)
+  else if (compressorType == LZ4 || compressorType == LZ4HC)
   {
     if (this->Compressor &&
         !this->Compressor->IsTypeOf("vtkLZ4DataCompressor")) {
       this->Compressor->Delete();
     }
-    this->Compressor = vtkLZ4DataCompressor::New();
+    vtkLZ4DataCompressor* compressor = vtkLZ4DataCompressor::New();
+    compressor->SetHighCompression(compressorType == LZ4HC);
+    this->Compressor = compressor;
     this->Compressor->SetCompressionLevel(this->CompressionLevel);
     this->Modified();
   }
@@ -1330,6 +1416,13 @@ int vtkXMLWriter::WriteBinaryData(vtkAbstractArray* a)
       result = 0;
     }
 
+    // Compress and write the blocks still waiting in the queue.
+    if (result && !this->FlushCompressionBlocks())
+    {
+      result = 0;
+    }
+    this->CompressionQueue->Enabled = false;
+
     // Finish writing the data.
     if (result && !this->DataStream->EndWriting())
     {
@@ -1684,6 +1777,8 @@ int vtkXMLWriter::CreateCompressionHeader(size_t size)
 
   // Initialize counter for block writing.
   this->CompressionBlockNumber = 0;
+  this->CompressionQueue->Initialize(this->Compressor, this->BlockSize,
+                                     numBlocks);
 
   return result;
 }
@@ -1691,6 +1786,16 @@ int vtkXMLWriter::CreateCompressionHeader(size_t size)
 //----------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionBlock(unsigned char* data, size_t size)
 {
+  // Queue the block if the blocks are compressed in parallel.  The data
+  // may live in a buffer reused for the next block, so it is copied.
+  vtkXMLWriterCompressionQueue* queue = this->CompressionQueue;
+  if (queue->Enabled)
+  {
+    queue->Push(data, size);
+    return queue->NumberOfBlocks < queue->Capacity ?
+      1 : this->FlushCompressionBlocks();
+  }
+
   // Compress the data.
   vtkUnsignedCharArray* outputArray = this->Compressor->Compress(data, size);
 
@@ -1714,6 +1819,48 @@ int vtkXMLWriter::WriteCompressionBlock(unsigned char* data, size_t size)
   return result;
 }
 
+//----------------------------------------------------------------------------
+int vtkXMLWriter::FlushCompressionBlocks()
+{
+  vtkXMLWriterCompressionQueue* queue = this->CompressionQueue;
+  size_t numBlocks = queue->NumberOfBlocks;
+  if (!queue->Enabled || numBlocks == 0)
+  {
+    return 1;
+  }
+  queue->NumberOfBlocks = 0;
+
+  // Compress the blocks in parallel.
+  CompressBlocks compress = { this->Compressor, queue };
+  vtkSMPTools::For(0, static_cast<vtkIdType>(numBlocks), 1, compress);
+
+  // Write the compressed blocks in order.
+  for (size_t block = 0; block < numBlocks; ++block)
+  {
+    size_t outputSize = queue->OutputSizes[block];
+    if (!outputSize)
+    {
+      vtkErrorMacro("Error compressing block " << this->CompressionBlockNumber);
+      return 0;
+    }
+    if (!this->DataStream->Write(queue->GetOutput(block), outputSize))
+    {
+      return 0;
+    }
+
+    // Store the resulting compressed size in the compression header.
+    this->CompressionHeader->Set(3+this->CompressionBlockNumber++, outputSize);
+  }
+
+  this->Stream->flush();
+  if (this->Stream->fail())
+  {
+    this->SetErrorCode(vtkErrorCode::GetLastSystemError());
+    return 0;
+  }
+  return 1;
+}
+
 //----------------------------------------------------------------------------
 int vtkXMLWriter::WriteCompressionHeader()
 {
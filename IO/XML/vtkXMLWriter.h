@@ -50,6 +50,7 @@ class vtkPointData;
 class vtkPoints;
 class vtkFieldData;
 class vtkXMLDataHeader;
+class vtkXMLWriterCompressionQueue;
 
 class vtkStdString;
 class OffsetsManager;      // one per piece/per time
@@ -144,6 +145,9 @@ public:
   /**
    * Get/Set the compressor used to compress binary and appended data
    * before writing to the file.  Default is a vtkZLibDataCompressor.
+   * The blocks of an array are compressed in parallel with vtkSMPTools
+   * when the compressor is one of the compressors provided by VTK; the
+   * file written does not depend on the number of threads.
    */
   virtual void SetCompressor(vtkDataCompressor*);
   vtkGetObjectMacro(Compressor, vtkDataCompressor);
@@ -154,12 +158,15 @@ public:
     NONE,
     ZLIB,
     LZ4,
-    LZMA
+    LZMA,
+    LZ4HC
   };
 
   //@{
   /**
    * Convenience functions to set the compressor to certain known types.
+   * LZ4HC is a vtkLZ4DataCompressor in high compression mode, see
+   * vtkLZ4DataCompressor::SetHighCompression().
    */
   void SetCompressorType(int compressorType);
   void SetCompressorTypeToNone()
@@ -178,6 +185,10 @@ public:
   {
     this->SetCompressorType(LZMA);
   }
+  void SetCompressorTypeToLZ4HC()
+  {
+    this->SetCompressorType(LZ4HC);
+  }
 
   void SetCompressionLevel(int compressorLevel);
   vtkGetMacro(CompressionLevel, int);
@@ -337,6 +348,8 @@ protected:
   size_t CompressionBlockNumber;
   vtkXMLDataHeader* CompressionHeader;
   vtkTypeInt64 CompressionHeaderPosition;
+  // Blocks waiting to be compressed in parallel.
+  vtkXMLWriterCompressionQueue* CompressionQueue;
   // Compression Level for vtkDataCompressor objects
   // 1 (worst compression, fastest) ... 9 (best compression, slowest)
   int CompressionLevel = 5;
@@ -475,6 +488,7 @@ protected:
   void PerformByteSwap(void* data, size_t numWords, size_t wordSize);
   int CreateCompressionHeader(size_t size);
   int WriteCompressionBlock(unsigned char* data, size_t size);
+  int FlushCompressionBlocks();
   int WriteCompressionHeader();
   size_t GetWordTypeSize(int dataType);
   const char* GetWordTypeName(int dataType);
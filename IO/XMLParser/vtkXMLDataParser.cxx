@@ -20,12 +20,14 @@
 #include "vtkDataCompressor.h"
 #include "vtkInputStream.h"
 #include "vtkObjectFactory.h"
+#include "vtkSMPTools.h"
 #include "vtkXMLDataElement.h"
 #define vtkXMLDataHeaderPrivate_DoNotInclude
 #include "vtkXMLDataHeaderPrivate.h"
 #undef vtkXMLDataHeaderPrivate_DoNotInclude
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <memory>
 #include <sstream>
@@ -590,6 +592,85 @@ unsigned char* vtkXMLDataParser::ReadBlock(vtkTypeUInt64 block)
   return decompressBuffer;
 }
 
+//----------------------------------------------------------------------------
+namespace
+{
+// Number of full blocks uncompressed together, per thread.
+const vtkTypeUInt64 BlocksPerThread = 4;
+
+// Whether blocks can be uncompressed concurrently with one compressor.  The
+// compressors listed here keep no state between calls.
+bool CanUncompressConcurrently(vtkDataCompressor* compressor)
+{
+  return vtkSMPTools::GetEstimatedNumberOfThreads() > 1 &&
+    (compressor->IsA("vtkZLibDataCompressor") ||
+     compressor->IsA("vtkLZ4DataCompressor") ||
+     compressor->IsA("vtkLZMADataCompressor"));
+}
+
+// Uncompress consecutive full blocks read together in one buffer.
+struct UncompressBlocks
+{
+  vtkDataCompressor* Compressor;
+  const unsigned char* Input;
+  const size_t* CompressedSizes;
+  const vtkTypeInt64* StartOffsets;
+  unsigned char* Output;
+  size_t BlockSize;
+  std::atomic<bool> Failed;
+
+  void operator()(vtkIdType begin, vtkIdType end)
+  {
+    for (vtkIdType i = begin; i < end; ++i)
+    {
+      size_t offset = static_cast<size_t>(this->StartOffsets[i] -
+                                          this->StartOffsets[0]);
+      if (!this->Compressor->Uncompress(this->Input + offset,
+                                        this->CompressedSizes[i],
+                                        this->Output + i * this->BlockSize,
+                                        this->BlockSize))
+      {
+        this->Failed = true;
+      }
+    }
+  }
+};
+}
+
+//----------------------------------------------------------------------------
+int vtkXMLDataParser::ReadFullBlocks(vtkTypeUInt64 firstBlock,
+                                     vtkTypeUInt64 endBlock,
+                                     unsigned char* buffer)
+{
+  // The compressed blocks are stored one after the other, so they are read
+  // at once and then uncompressed in parallel.
+  vtkTypeInt64 begin = this->BlockStartOffsets[firstBlock];
+  size_t compressedSize =
+    static_cast<size_t>(this->BlockStartOffsets[endBlock-1] - begin) +
+    this->BlockCompressedSizes[endBlock-1];
+  if(!this->DataStream->Seek(begin))
+  {
+    return 0;
+  }
+  std::vector<unsigned char> readBuffer(compressedSize);
+  if(this->DataStream->Read(readBuffer.data(), compressedSize) < compressedSize)
+  {
+    return 0;
+  }
+
+  UncompressBlocks uncompress;
+  uncompress.Compressor = this->Compressor;
+  uncompress.Input = readBuffer.data();
+  uncompress.CompressedSizes = this->BlockCompressedSizes + firstBlock;
+  uncompress.StartOffsets = this->BlockStartOffsets + firstBlock;
+  uncompress.Output = buffer;
+  uncompress.BlockSize = this->BlockUncompressedSize;
+  uncompress.Failed = false;
+  vtkSMPTools::For(0, static_cast<vtkIdType>(endBlock - firstBlock), 1,
+                   uncompress);
+  return !uncompress.Failed;
+}
+
 //----------------------------------------------------------------------------
 size_t vtkXMLDataParser::ReadUncompressedData(unsigned char* data,
                                               vtkTypeUInt64 startWord,
@@ -765,7 +846,35 @@ size_t vtkXMLDataParser::ReadCompressedData(unsigned char* data,
     // Report progress.
     this->UpdateProgress(float(outputPointer-data)/length);
 
-    unsigned int currentBlock = firstBlock+1;
+    vtkTypeUInt64 currentBlock = firstBlock+1;
+    if(lastBlock - currentBlock > 1 &&
+       CanUncompressConcurrently(this->Compressor))
+    {
+      // Uncompress a few blocks per thread at a time, which bounds the
+      // memory used for the compressed data.
+      vtkTypeUInt64 batchSize = BlocksPerThread *
+        static_cast<vtkTypeUInt64>(vtkSMPTools::GetEstimatedNumberOfThreads());
+      while(currentBlock != lastBlock && !this->Abort)
+      {
+        vtkTypeUInt64 endBlock = std::min(lastBlock, currentBlock+batchSize);
+        if(!this->ReadFullBlocks(currentBlock, endBlock, outputPointer))
+        {
+          return 0;
+        }
+
+        // Byte swap these blocks.  Note that blockSize will always be an
+        // integer multiple of the word size.
+        size_t n = static_cast<size_t>(endBlock - currentBlock) * blockSize;
+        this->PerformByteSwap(outputPointer, n / wordSize, wordSize);
+
+        // Advance the pointer to the beginning of the next block.
+        outputPointer += n;
+        currentBlock = endBlock;
+
+        // Report progress.
+        this->UpdateProgress(float(outputPointer-data)/length);
+      }
+    }
     for(;currentBlock != lastBlock && !this->Abort; ++currentBlock)
     {
       // Read this block.
@@ -928,6 +1037,47 @@ size_t vtkXMLDataParser::ReadAppendedData(vtkTypeInt64 offset,
   return this->ReadBinaryData(buffer, startWord, numWords, wordType);
 }
 
+//----------------------------------------------------------------------------
+vtkTypeInt64 vtkXMLDataParser::GetRawAppendedDataPosition(vtkTypeInt64 offset,
+                                                          size_t numWords,
+                                                          int wordType)
+{
+  // The values must be usable without decoding, decompression or byte
+  // swapping.
+  size_t wordSize = this->GetWordTypeSize(wordType);
+#ifdef VTK_WORDS_BIGENDIAN
+  bool swap = this->ByteOrder != vtkXMLDataParser::BigEndian;
+#else
+  bool swap = this->ByteOrder != vtkXMLDataParser::LittleEndian;
+#endif
+  if(this->Compressor || (swap && wordSize > 1) ||
+     this->AppendedDataStream->IsA("vtkBase64InputStream"))
+  {
+    return -1;
+  }
+
+  // Read the length of the data, which precedes the values.
+  this->DataStream = this->AppendedDataStream;
+  this->DataStream->SetStream(this->Stream);
+  this->SeekG(this->AppendedDataPosition+offset);
+  this->DataStream->StartReading();
+  std::unique_ptr<vtkXMLDataHeader>
+    uh(vtkXMLDataHeader::New(this->HeaderType, 1));
+  size_t const headerSize = uh->DataSize();
+  size_t r = this->DataStream->Read(uh->Data(), headerSize);
+  this->DataStream->EndReading();
+  if(r < headerSize)
+  {
+    return -1;
+  }
+  this->PerformByteSwap(uh->Data(), uh->WordCount(), uh->WordSize());
+  if(uh->Get(0) < numWords*wordSize)
+  {
+    return -1;
+  }
+  return static_cast<vtkTypeInt64>(this->Stream->tellg());
+}
+
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 // Define a parsing function template.  The extra "long" argument is used
@@ -79,6 +79,16 @@ public:
   { return this->ReadAppendedData(offset, buffer, startWord, numWords,
                                     VTK_CHAR); }
 
+  /**
+   * Get the position in the input stream of the values stored in the
+   * appended data section at the given appended data offset.  Returns -1
+   * unless the values are stored raw, uncompressed and with the byte order
+   * of this machine, so that they can be used in place, and hold at least
+   * numWords words.
+   */
+  vtkTypeInt64 GetRawAppendedDataPosition(vtkTypeInt64 offset,
+                                          size_t numWords, int wordType);
+
   /**
    * Read from an ascii data section starting at the current position in
    * the stream.  Returns the number of words read.
@@ -189,6 +199,8 @@ protected:
   size_t FindBlockSize(vtkTypeUInt64 block);
   int ReadBlock(vtkTypeUInt64 block, unsigned char* buffer);
   unsigned char* ReadBlock(vtkTypeUInt64 block);
+  int ReadFullBlocks(vtkTypeUInt64 firstBlock, vtkTypeUInt64 endBlock,
+                     unsigned char* buffer);
   size_t ReadUncompressedData(unsigned char* data,
                               vtkTypeUInt64 startWord,
                               size_t numWords,
@@ -0,0 +1,73 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTestArrays.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkTestArrays_h
+#define vtkTestArrays_h
+
+#include "vtkDataArray.h"
+
+namespace vtkTest
+{
+/**
+ * Return true if both arrays exist and have the same data type, size and
+ * values.
+ */
+inline bool SameValues(vtkDataArray* a, vtkDataArray* b)
+{
+  if (!a || !b || a->GetDataType() != b->GetDataType() ||
+      a->GetNumberOfTuples() != b->GetNumberOfTuples() ||
+      a->GetNumberOfComponents() != b->GetNumberOfComponents())
+  {
+    return false;
+  }
+  for (vtkIdType t = 0; t < a->GetNumberOfTuples(); ++t)
+  {
+    for (int c = 0; c < a->GetNumberOfComponents(); ++c)
+    {
+      if (a->GetComponent(t, c) != b->GetComponent(t, c))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/**
+ * Return true if two vtkFieldData (or vtkDataSetAttributes) hold the same
+ * arrays, as compared by SameValues(). Named arrays are matched by name,
+ * the other ones by index.
+ */
+template <typename FieldDataT>
+bool SameArrays(FieldDataT* a, FieldDataT* b)
+{
+  if (a->GetNumberOfArrays() != b->GetNumberOfArrays())
+  {
+    return false;
+  }
+  for (int i = 0; i < a->GetNumberOfArrays(); ++i)
+  {
+    vtkDataArray* x = a->GetArray(i);
+    if (x && !SameValues(x, x->GetName() ? b->GetArray(x->GetName()) :
+                                           b->GetArray(i)))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkTestArrays.h
@@ -0,0 +1,66 @@
+/*=========================================================================
+
+  Program:   Visualization Toolkit
+  Module:    vtkTestSMP.h
+
+  Copyright (c) Ken Martin, Will Schroeder, Bill Lorensen
+  All rights reserved.
+  See Copyright.txt or http://www.kitware.com/Copyright.htm for details.
+
+     This software is distributed WITHOUT ANY WARRANTY; without even
+     the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+     PURPOSE.  See the above copyright notice for more information.
+
+=========================================================================*/
+#ifndef vtkTestSMP_h
+#define vtkTestSMP_h
+
+#include "vtkSMPTools.h"
+
+#include <cstring> // For strcmp
+
+namespace vtkTest
+{
+/**
+ * Execute function with a multi-threaded SMP back-end (STDThread, else
+ * OpenMP or TBB) limited to numberOfThreads threads, whatever the back-end
+ * selected at configure time and the number of cores of the machine, so
+ * that the parallel code paths are tested. The thread pool of the back-end
+ * is enlarged if needed. Returns false if no multi-threaded back-end is
+ * enabled, in which case function is executed with the default back-end.
+ *
+ * With a single thread, the parallel sections run serially on the calling
+ * thread, which gives a reference to compare the parallel results to.
+ */
+template <typename FunctionT>
+bool RunThreaded(int numberOfThreads, FunctionT&& function)
+{
+  bool threaded = false;
+  for (const char* backend : { "STDThread", "OpenMP", "TBB" })
+  {
+    vtkSMPTools::Config config(backend);
+    config.MaxNumberOfThreads = numberOfThreads;
+    vtkSMPTools::LocalScope(config, [&]() {
+      // A back-end that is not enabled is ignored by LocalScope().
+      if (strcmp(vtkSMPTools::GetBackend(), backend) == 0)
+      {
+        if (vtkSMPTools::GetEstimatedNumberOfThreads() < numberOfThreads)
+        {
+          vtkSMPTools::Initialize(numberOfThreads);
+        }
+        threaded = true;
+        function();
+      }
+    });
+    if (threaded)
+    {
+      return true;
+    }
+  }
+  function();
+  return false;
+}
+}
+
+#endif
+// VTK-HeaderTest-Exclude: vtkTestSMP.h